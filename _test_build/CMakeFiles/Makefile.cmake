@@ -0,0 +1,149 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/cmake/FindLIBEVENT.cmake"
+  "/root/repo/cmake/FindLZ4.cmake"
+  "/root/repo/cmake/FindNUMA.cmake"
+  "/root/repo/cmake/FindZSTD.cmake"
+  "/root/repo/config/CMakeLists.txt"
+  "/root/repo/external/CMakeLists.txt"
+  "/root/repo/external/MurmurHash3/CMakeLists.txt"
+  "/root/repo/external/modp_b64/CMakeLists.txt"
+  "/root/repo/kotekan/CMakeLists.txt"
+  "/root/repo/lib/CMakeLists.txt"
+  "/root/repo/lib/core/CMakeLists.txt"
+  "/root/repo/lib/cpu/CMakeLists.txt"
+  "/root/repo/lib/gpu/CMakeLists.txt"
+  "/root/repo/lib/metadata/CMakeLists.txt"
+  "/root/repo/lib/stages/CMakeLists.txt"
+  "/root/repo/lib/testing/CMakeLists.txt"
+  "/root/repo/lib/utils/CMakeLists.txt"
+  "/root/repo/lib/version/CMakeLists.txt"
+  "/root/repo/lib/version/make_version.cmake.in"
+  "/root/repo/scripts/CMakeLists.txt"
+  "/root/repo/tests/boost/CMakeLists.txt"
+  "/usr/lib/x86_64-linux-gnu/cmake/Boost-1.74.0/BoostConfig.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/Boost-1.74.0/BoostConfigVersion.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/BoostDetectToolset-1.74.0.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_headers-1.74.0/boost_headers-config-version.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_headers-1.74.0/boost_headers-config.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_unit_test_framework-1.74.0/boost_unit_test_framework-config-version.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_unit_test_framework-1.74.0/boost_unit_test_framework-config.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_unit_test_framework-1.74.0/libboost_unit_test_framework-variant-shared.cmake"
+  "/usr/lib/x86_64-linux-gnu/cmake/boost_unit_test_framework-1.74.0/libboost_unit_test_framework-variant-static.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCheckCompilerFlagCommonPatterns.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCCompilerFlag.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXCompilerFlag.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindBoost.cmake"
+  "/usr/share/cmake-3.25/Modules/FindOpenSSL.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPkgConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckCompilerFlag.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckFlagCommonConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/utils/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/stages/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/version/make_version.cmake"
+  "lib/version/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/testing/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/core/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/metadata/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/gpu/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "lib/cpu/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "kotekan/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "scripts/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "external/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "external/MurmurHash3/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "external/modp_b64/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "config/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/boost/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "lib/utils/CMakeFiles/kotekan_utils.dir/DependInfo.cmake"
+  "lib/stages/CMakeFiles/kotekan_stages.dir/DependInfo.cmake"
+  "lib/version/CMakeFiles/kotekan_version.dir/DependInfo.cmake"
+  "lib/testing/CMakeFiles/kotekan_testing.dir/DependInfo.cmake"
+  "lib/core/CMakeFiles/kotekan_core.dir/DependInfo.cmake"
+  "lib/gpu/CMakeFiles/kotekan_gpu.dir/DependInfo.cmake"
+  "lib/cpu/CMakeFiles/kotekan_cpu.dir/DependInfo.cmake"
+  "kotekan/CMakeFiles/kotekan.dir/DependInfo.cmake"
+  "external/MurmurHash3/CMakeFiles/MurmurHash3.dir/DependInfo.cmake"
+  "external/modp_b64/CMakeFiles/modp_b64.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_truncate.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_synchronized_queue.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_hash.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_updatequeue.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_dataset_manager_rest.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_dataset_manager.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_restclient.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_rest_server.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_bip_buffer.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_host_memory_pool.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_kernel_tuning.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_prometheus_metrics.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_config.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_chime_stacking.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_vis_shared_mem_reader.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_udp_transmitter.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_buffer_shm_ring.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_frame_compression.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_snapshot_pool.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_gpu_timeline.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_gpu_command_scheduler.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_cpu_device.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_cpu_correlator.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_cpu_beamform.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_cpu_tracking_beamform.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/test_cpu_rfi.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/dataset_broker_producer.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/dataset_broker_producer2.dir/DependInfo.cmake"
+  "tests/boost/CMakeFiles/dataset_broker_consumer.dir/DependInfo.cmake"
+  )
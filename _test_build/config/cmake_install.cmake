@@ -0,0 +1,90 @@
+# Install script for directory: /root/repo/config
+
+# Set the install prefix
+if(NOT DEFINED CMAKE_INSTALL_PREFIX)
+  set(CMAKE_INSTALL_PREFIX "/")
+endif()
+string(REGEX REPLACE "/$" "" CMAKE_INSTALL_PREFIX "${CMAKE_INSTALL_PREFIX}")
+
+# Set the install configuration name.
+if(NOT DEFINED CMAKE_INSTALL_CONFIG_NAME)
+  if(BUILD_TYPE)
+    string(REGEX REPLACE "^[^A-Za-z0-9_]+" ""
+           CMAKE_INSTALL_CONFIG_NAME "${BUILD_TYPE}")
+  else()
+    set(CMAKE_INSTALL_CONFIG_NAME "Debug")
+  endif()
+  message(STATUS "Install configuration: \"${CMAKE_INSTALL_CONFIG_NAME}\"")
+endif()
+
+# Set the component getting installed.
+if(NOT CMAKE_INSTALL_COMPONENT)
+  if(COMPONENT)
+    message(STATUS "Install component: \"${COMPONENT}\"")
+    set(CMAKE_INSTALL_COMPONENT "${COMPONENT}")
+  else()
+    set(CMAKE_INSTALL_COMPONENT)
+  endif()
+endif()
+
+# Install shared libraries without execute permission?
+if(NOT DEFINED CMAKE_INSTALL_SO_NO_EXE)
+  set(CMAKE_INSTALL_SO_NO_EXE "1")
+endif()
+
+# Is this installation the result of a crosscompile?
+if(NOT DEFINED CMAKE_CROSSCOMPILING)
+  set(CMAKE_CROSSCOMPILING "FALSE")
+endif()
+
+# Set default install directory permissions.
+if(NOT DEFINED CMAKE_OBJDUMP)
+  set(CMAKE_OBJDUMP "/usr/bin/objdump")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  list(APPEND CMAKE_ABSOLUTE_DESTINATION_FILES
+   "/etc/kotekan//")
+  if(CMAKE_WARN_ON_ABSOLUTE_INSTALL_DESTINATION)
+    message(WARNING "ABSOLUTE path INSTALL DESTINATION : ${CMAKE_ABSOLUTE_DESTINATION_FILES}")
+  endif()
+  if(CMAKE_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION)
+    message(FATAL_ERROR "ABSOLUTE path INSTALL DESTINATION forbidden (by caller): ${CMAKE_ABSOLUTE_DESTINATION_FILES}")
+  endif()
+  file(INSTALL DESTINATION "/etc/kotekan/" TYPE DIRECTORY FILES "")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  list(APPEND CMAKE_ABSOLUTE_DESTINATION_FILES
+   "/etc/kotekan/adc_record.yaml;/etc/kotekan/airspy_autocorr.yaml;/etc/kotekan/aro_record.yaml;/etc/kotekan/aro_replay.yaml;/etc/kotekan/beam_recv_template.yaml;/etc/kotekan/chime_fpga_patterntest_recv.yaml;/etc/kotekan/chime_keep_gpu_warm.yaml;/etc/kotekan/chime_psr_verification.yaml;/etc/kotekan/chime_ringmap.yaml;/etc/kotekan/chime_science_run_calbuffer.yaml;/etc/kotekan/chime_science_run_gpu.yaml;/etc/kotekan/chime_science_run_gpu_no_output.yaml;/etc/kotekan/chime_science_run_recv.yaml;/etc/kotekan/chime_science_run_recv_hfb.yaml;/etc/kotekan/dpdk_test_32_ports_2_numa_nodes.yaml;/etc/kotekan/frb_test.yaml;/etc/kotekan/packet_capture.yaml;/etc/kotekan/verify_cpu_frb.yaml;/etc/kotekan/verify_cpu_n2.yaml;/etc/kotekan/verify_cuda_n2.yaml;/etc/kotekan/verify_opencl.yaml")
+  if(CMAKE_WARN_ON_ABSOLUTE_INSTALL_DESTINATION)
+    message(WARNING "ABSOLUTE path INSTALL DESTINATION : ${CMAKE_ABSOLUTE_DESTINATION_FILES}")
+  endif()
+  if(CMAKE_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION)
+    message(FATAL_ERROR "ABSOLUTE path INSTALL DESTINATION forbidden (by caller): ${CMAKE_ABSOLUTE_DESTINATION_FILES}")
+  endif()
+  file(INSTALL DESTINATION "/etc/kotekan" TYPE FILE FILES
+    "/root/repo/config/adc_record.yaml"
+    "/root/repo/config/airspy_autocorr.yaml"
+    "/root/repo/config/aro_record.yaml"
+    "/root/repo/config/aro_replay.yaml"
+    "/root/repo/config/beam_recv_template.yaml"
+    "/root/repo/config/chime_fpga_patterntest_recv.yaml"
+    "/root/repo/config/chime_keep_gpu_warm.yaml"
+    "/root/repo/config/chime_psr_verification.yaml"
+    "/root/repo/config/chime_ringmap.yaml"
+    "/root/repo/config/chime_science_run_calbuffer.yaml"
+    "/root/repo/config/chime_science_run_gpu.yaml"
+    "/root/repo/config/chime_science_run_gpu_no_output.yaml"
+    "/root/repo/config/chime_science_run_recv.yaml"
+    "/root/repo/config/chime_science_run_recv_hfb.yaml"
+    "/root/repo/config/dpdk_test_32_ports_2_numa_nodes.yaml"
+    "/root/repo/config/frb_test.yaml"
+    "/root/repo/config/packet_capture.yaml"
+    "/root/repo/config/verify_cpu_frb.yaml"
+    "/root/repo/config/verify_cpu_n2.yaml"
+    "/root/repo/config/verify_cuda_n2.yaml"
+    "/root/repo/config/verify_opencl.yaml"
+    )
+endif()
+
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MurmurHash3.dir/MurmurHash3.cpp.o"
+  "CMakeFiles/MurmurHash3.dir/MurmurHash3.cpp.o.d"
+  "libMurmurHash3.a"
+  "libMurmurHash3.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MurmurHash3.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
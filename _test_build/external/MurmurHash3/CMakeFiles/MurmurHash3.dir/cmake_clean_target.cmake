@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libMurmurHash3.a"
+)
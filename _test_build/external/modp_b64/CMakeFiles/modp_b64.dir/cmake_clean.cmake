@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/modp_b64.dir/modp_b64.cpp.o"
+  "CMakeFiles/modp_b64.dir/modp_b64.cpp.o.d"
+  "libmodp_b64.a"
+  "libmodp_b64.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/modp_b64.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libmodp_b64.a"
+)
@@ -0,0 +1,28 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/kotekan/kotekan.cpp" "kotekan/CMakeFiles/kotekan.dir/kotekan.cpp.o" "gcc" "kotekan/CMakeFiles/kotekan.dir/kotekan.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/lib/utils/CMakeFiles/kotekan_utils.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/stages/CMakeFiles/kotekan_stages.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/version/CMakeFiles/kotekan_version.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/testing/CMakeFiles/kotekan_testing.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/core/CMakeFiles/kotekan_core.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/cpu/CMakeFiles/kotekan_cpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/gpu/CMakeFiles/kotekan_gpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/MurmurHash3/CMakeFiles/MurmurHash3.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/modp_b64/CMakeFiles/modp_b64.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan.dir/kotekan.cpp.o"
+  "CMakeFiles/kotekan.dir/kotekan.cpp.o.d"
+  "kotekan"
+  "kotekan.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kotekan.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,43 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/lib/core/buffer.c" "lib/core/CMakeFiles/kotekan_core.dir/buffer.c.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/buffer.c.o.d"
+  "/root/repo/lib/core/errors.c" "lib/core/CMakeFiles/kotekan_core.dir/errors.c.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/errors.c.o.d"
+  "/root/repo/lib/core/hostMemoryPool.c" "lib/core/CMakeFiles/kotekan_core.dir/hostMemoryPool.c.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/hostMemoryPool.c.o.d"
+  "/root/repo/lib/core/metadata.c" "lib/core/CMakeFiles/kotekan_core.dir/metadata.c.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/metadata.c.o.d"
+  "/root/repo/lib/core/Config.cpp" "lib/core/CMakeFiles/kotekan_core.dir/Config.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/Config.cpp.o.d"
+  "/root/repo/lib/core/Stage.cpp" "lib/core/CMakeFiles/kotekan_core.dir/Stage.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/Stage.cpp.o.d"
+  "/root/repo/lib/core/StageFactory.cpp" "lib/core/CMakeFiles/kotekan_core.dir/StageFactory.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/StageFactory.cpp.o.d"
+  "/root/repo/lib/core/basebandApiManager.cpp" "lib/core/CMakeFiles/kotekan_core.dir/basebandApiManager.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/basebandApiManager.cpp.o.d"
+  "/root/repo/lib/core/basebandReadoutManager.cpp" "lib/core/CMakeFiles/kotekan_core.dir/basebandReadoutManager.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/basebandReadoutManager.cpp.o.d"
+  "/root/repo/lib/core/bufferContainer.cpp" "lib/core/CMakeFiles/kotekan_core.dir/bufferContainer.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/bufferContainer.cpp.o.d"
+  "/root/repo/lib/core/bufferFactory.cpp" "lib/core/CMakeFiles/kotekan_core.dir/bufferFactory.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/bufferFactory.cpp.o.d"
+  "/root/repo/lib/core/configUpdater.cpp" "lib/core/CMakeFiles/kotekan_core.dir/configUpdater.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/configUpdater.cpp.o.d"
+  "/root/repo/lib/core/kotekanLogging.cpp" "lib/core/CMakeFiles/kotekan_core.dir/kotekanLogging.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/kotekanLogging.cpp.o.d"
+  "/root/repo/lib/core/kotekanMode.cpp" "lib/core/CMakeFiles/kotekan_core.dir/kotekanMode.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/kotekanMode.cpp.o.d"
+  "/root/repo/lib/core/metadataFactory.cpp" "lib/core/CMakeFiles/kotekan_core.dir/metadataFactory.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/metadataFactory.cpp.o.d"
+  "/root/repo/lib/core/prometheusMetrics.cpp" "lib/core/CMakeFiles/kotekan_core.dir/prometheusMetrics.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/prometheusMetrics.cpp.o.d"
+  "/root/repo/lib/core/restServer.cpp" "lib/core/CMakeFiles/kotekan_core.dir/restServer.cpp.o" "gcc" "lib/core/CMakeFiles/kotekan_core.dir/restServer.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/lib/utils/CMakeFiles/kotekan_utils.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/stages/CMakeFiles/kotekan_stages.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/testing/CMakeFiles/kotekan_testing.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/cpu/CMakeFiles/kotekan_cpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/gpu/CMakeFiles/kotekan_gpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/version/CMakeFiles/kotekan_version.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/MurmurHash3/CMakeFiles/MurmurHash3.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/modp_b64/CMakeFiles/modp_b64.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
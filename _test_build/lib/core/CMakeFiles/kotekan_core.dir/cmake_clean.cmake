@@ -0,0 +1,43 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan_core.dir/Config.cpp.o"
+  "CMakeFiles/kotekan_core.dir/Config.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/Stage.cpp.o"
+  "CMakeFiles/kotekan_core.dir/Stage.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/StageFactory.cpp.o"
+  "CMakeFiles/kotekan_core.dir/StageFactory.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/basebandApiManager.cpp.o"
+  "CMakeFiles/kotekan_core.dir/basebandApiManager.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/basebandReadoutManager.cpp.o"
+  "CMakeFiles/kotekan_core.dir/basebandReadoutManager.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/buffer.c.o"
+  "CMakeFiles/kotekan_core.dir/buffer.c.o.d"
+  "CMakeFiles/kotekan_core.dir/bufferContainer.cpp.o"
+  "CMakeFiles/kotekan_core.dir/bufferContainer.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/bufferFactory.cpp.o"
+  "CMakeFiles/kotekan_core.dir/bufferFactory.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/configUpdater.cpp.o"
+  "CMakeFiles/kotekan_core.dir/configUpdater.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/errors.c.o"
+  "CMakeFiles/kotekan_core.dir/errors.c.o.d"
+  "CMakeFiles/kotekan_core.dir/hostMemoryPool.c.o"
+  "CMakeFiles/kotekan_core.dir/hostMemoryPool.c.o.d"
+  "CMakeFiles/kotekan_core.dir/kotekanLogging.cpp.o"
+  "CMakeFiles/kotekan_core.dir/kotekanLogging.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/kotekanMode.cpp.o"
+  "CMakeFiles/kotekan_core.dir/kotekanMode.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/metadata.c.o"
+  "CMakeFiles/kotekan_core.dir/metadata.c.o.d"
+  "CMakeFiles/kotekan_core.dir/metadataFactory.cpp.o"
+  "CMakeFiles/kotekan_core.dir/metadataFactory.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/prometheusMetrics.cpp.o"
+  "CMakeFiles/kotekan_core.dir/prometheusMetrics.cpp.o.d"
+  "CMakeFiles/kotekan_core.dir/restServer.cpp.o"
+  "CMakeFiles/kotekan_core.dir/restServer.cpp.o.d"
+  "libkotekan_core.a"
+  "libkotekan_core.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C CXX)
+  include(CMakeFiles/kotekan_core.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
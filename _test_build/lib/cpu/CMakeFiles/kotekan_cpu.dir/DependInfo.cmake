@@ -0,0 +1,58 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/lib/cpu/cpuAsyncCopyGain.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuAsyncCopyGain.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuAsyncCopyGain.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBarrier.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBarrier.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBarrier.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformHFBOutput.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBOutput.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBOutput.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformHFBSum.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBSum.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBSum.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformKernel.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformKernel.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformKernel.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformOutput.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformOutput.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformOutput.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformReorder.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformReorder.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformReorder.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformTranspose.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformTranspose.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformTranspose.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformUpchan.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchan.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchan.cpp.o.d"
+  "/root/repo/lib/cpu/cpuBeamformUpchanHFB.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchanHFB.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchanHFB.cpp.o.d"
+  "/root/repo/lib/cpu/cpuCommand.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuCommand.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuCommand.cpp.o.d"
+  "/root/repo/lib/cpu/cpuCorrelatorKernel.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuCorrelatorKernel.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuCorrelatorKernel.cpp.o.d"
+  "/root/repo/lib/cpu/cpuDeviceInterface.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuDeviceInterface.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuDeviceInterface.cpp.o.d"
+  "/root/repo/lib/cpu/cpuEventContainer.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuEventContainer.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuEventContainer.cpp.o.d"
+  "/root/repo/lib/cpu/cpuHostToDeviceCopy.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuHostToDeviceCopy.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuHostToDeviceCopy.cpp.o.d"
+  "/root/repo/lib/cpu/cpuInputData.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuInputData.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuInputData.cpp.o.d"
+  "/root/repo/lib/cpu/cpuOutputData.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuOutputData.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuOutputData.cpp.o.d"
+  "/root/repo/lib/cpu/cpuOutputDataZero.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuOutputDataZero.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuOutputDataZero.cpp.o.d"
+  "/root/repo/lib/cpu/cpuPresumKernel.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuPresumKernel.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuPresumKernel.cpp.o.d"
+  "/root/repo/lib/cpu/cpuPresumZero.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuPresumZero.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuPresumZero.cpp.o.d"
+  "/root/repo/lib/cpu/cpuProcess.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuProcess.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuProcess.cpp.o.d"
+  "/root/repo/lib/cpu/cpuRfiBadInput.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiBadInput.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiBadInput.cpp.o.d"
+  "/root/repo/lib/cpu/cpuRfiInputSum.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiInputSum.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiInputSum.cpp.o.d"
+  "/root/repo/lib/cpu/cpuRfiOutput.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiOutput.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiOutput.cpp.o.d"
+  "/root/repo/lib/cpu/cpuRfiTimeSum.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiTimeSum.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiTimeSum.cpp.o.d"
+  "/root/repo/lib/cpu/cpuRfiUpdateBadInputs.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiUpdateBadInputs.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiUpdateBadInputs.cpp.o.d"
+  "/root/repo/lib/cpu/cpuRfiZeroData.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiZeroData.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuRfiZeroData.cpp.o.d"
+  "/root/repo/lib/cpu/cpuSpectralKurtosis.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuSpectralKurtosis.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuSpectralKurtosis.cpp.o.d"
+  "/root/repo/lib/cpu/cpuSubframeCommand.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuSubframeCommand.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuSubframeCommand.cpp.o.d"
+  "/root/repo/lib/cpu/cpuTrackingBeamform.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamform.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamform.cpp.o.d"
+  "/root/repo/lib/cpu/cpuTrackingBeamformOutput.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamformOutput.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamformOutput.cpp.o.d"
+  "/root/repo/lib/cpu/cpuTrackingUpdatePhase.cpp" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuTrackingUpdatePhase.cpp.o" "gcc" "lib/cpu/CMakeFiles/kotekan_cpu.dir/cpuTrackingUpdatePhase.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/lib/utils/CMakeFiles/kotekan_utils.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/stages/CMakeFiles/kotekan_stages.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/testing/CMakeFiles/kotekan_testing.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/core/CMakeFiles/kotekan_core.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/gpu/CMakeFiles/kotekan_gpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/version/CMakeFiles/kotekan_version.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/MurmurHash3/CMakeFiles/MurmurHash3.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/modp_b64/CMakeFiles/modp_b64.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,73 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan_cpu.dir/cpuAsyncCopyGain.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuAsyncCopyGain.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBarrier.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBarrier.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBOutput.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBOutput.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBSum.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformHFBSum.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformKernel.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformKernel.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformOutput.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformOutput.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformReorder.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformReorder.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformTranspose.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformTranspose.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchan.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchan.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchanHFB.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuBeamformUpchanHFB.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuCommand.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuCommand.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuCorrelatorKernel.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuCorrelatorKernel.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuDeviceInterface.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuDeviceInterface.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuEventContainer.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuEventContainer.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuHostToDeviceCopy.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuHostToDeviceCopy.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuInputData.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuInputData.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuOutputData.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuOutputData.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuOutputDataZero.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuOutputDataZero.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuPresumKernel.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuPresumKernel.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuPresumZero.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuPresumZero.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuProcess.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuProcess.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiBadInput.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiBadInput.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiInputSum.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiInputSum.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiOutput.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiOutput.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiTimeSum.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiTimeSum.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiUpdateBadInputs.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiUpdateBadInputs.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiZeroData.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuRfiZeroData.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuSpectralKurtosis.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuSpectralKurtosis.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuSubframeCommand.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuSubframeCommand.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamform.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamform.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamformOutput.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuTrackingBeamformOutput.cpp.o.d"
+  "CMakeFiles/kotekan_cpu.dir/cpuTrackingUpdatePhase.cpp.o"
+  "CMakeFiles/kotekan_cpu.dir/cpuTrackingUpdatePhase.cpp.o.d"
+  "libkotekan_cpu.a"
+  "libkotekan_cpu.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kotekan_cpu.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
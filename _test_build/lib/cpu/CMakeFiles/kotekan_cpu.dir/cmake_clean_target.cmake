@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libkotekan_cpu.a"
+)
@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan_gpu.dir/gpuCommand.cpp.o"
+  "CMakeFiles/kotekan_gpu.dir/gpuCommand.cpp.o.d"
+  "CMakeFiles/kotekan_gpu.dir/gpuCommandScheduler.cpp.o"
+  "CMakeFiles/kotekan_gpu.dir/gpuCommandScheduler.cpp.o.d"
+  "CMakeFiles/kotekan_gpu.dir/gpuDeviceInterface.cpp.o"
+  "CMakeFiles/kotekan_gpu.dir/gpuDeviceInterface.cpp.o.d"
+  "CMakeFiles/kotekan_gpu.dir/gpuEventContainer.cpp.o"
+  "CMakeFiles/kotekan_gpu.dir/gpuEventContainer.cpp.o.d"
+  "CMakeFiles/kotekan_gpu.dir/gpuProcess.cpp.o"
+  "CMakeFiles/kotekan_gpu.dir/gpuProcess.cpp.o.d"
+  "CMakeFiles/kotekan_gpu.dir/gpuTimeline.cpp.o"
+  "CMakeFiles/kotekan_gpu.dir/gpuTimeline.cpp.o.d"
+  "libkotekan_gpu.a"
+  "libkotekan_gpu.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kotekan_gpu.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
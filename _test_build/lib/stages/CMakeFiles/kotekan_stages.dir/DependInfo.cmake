@@ -0,0 +1,97 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/lib/stages/BadInputFlag.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/BadInputFlag.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/BadInputFlag.cpp.o.d"
+  "/root/repo/lib/stages/BaseWriter.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/BaseWriter.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/BaseWriter.cpp.o.d"
+  "/root/repo/lib/stages/BeamExtract.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/BeamExtract.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/BeamExtract.cpp.o.d"
+  "/root/repo/lib/stages/BeamInspect.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/BeamInspect.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/BeamInspect.cpp.o.d"
+  "/root/repo/lib/stages/DPDKShuffleSimulate.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/DPDKShuffleSimulate.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/DPDKShuffleSimulate.cpp.o.d"
+  "/root/repo/lib/stages/DataQuality.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/DataQuality.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/DataQuality.cpp.o.d"
+  "/root/repo/lib/stages/FreqSubset.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/FreqSubset.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/FreqSubset.cpp.o.d"
+  "/root/repo/lib/stages/HFBAccumulate.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/HFBAccumulate.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/HFBAccumulate.cpp.o.d"
+  "/root/repo/lib/stages/HFBRawReader.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/HFBRawReader.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/HFBRawReader.cpp.o.d"
+  "/root/repo/lib/stages/HFBWriter.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/HFBWriter.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/HFBWriter.cpp.o.d"
+  "/root/repo/lib/stages/InputSubset.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/InputSubset.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/InputSubset.cpp.o.d"
+  "/root/repo/lib/stages/RawReader.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/RawReader.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/RawReader.cpp.o.d"
+  "/root/repo/lib/stages/ReadGain.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/ReadGain.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/ReadGain.cpp.o.d"
+  "/root/repo/lib/stages/ReceiveFlags.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/ReceiveFlags.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/ReceiveFlags.cpp.o.d"
+  "/root/repo/lib/stages/RfiFrameDrop.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/RfiFrameDrop.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/RfiFrameDrop.cpp.o.d"
+  "/root/repo/lib/stages/UdpCapture.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/UdpCapture.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/UdpCapture.cpp.o.d"
+  "/root/repo/lib/stages/VisRawReader.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/VisRawReader.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/VisRawReader.cpp.o.d"
+  "/root/repo/lib/stages/VisSharedMemWriter.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/VisSharedMemWriter.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/VisSharedMemWriter.cpp.o.d"
+  "/root/repo/lib/stages/VisWriter.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/VisWriter.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/VisWriter.cpp.o.d"
+  "/root/repo/lib/stages/accumulate.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/accumulate.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/accumulate.cpp.o.d"
+  "/root/repo/lib/stages/beamformingPostProcess.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/beamformingPostProcess.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/beamformingPostProcess.cpp.o.d"
+  "/root/repo/lib/stages/bufferBadInputs.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferBadInputs.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferBadInputs.cpp.o.d"
+  "/root/repo/lib/stages/bufferCopy.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferCopy.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferCopy.cpp.o.d"
+  "/root/repo/lib/stages/bufferDelay.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferDelay.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferDelay.cpp.o.d"
+  "/root/repo/lib/stages/bufferMerge.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferMerge.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferMerge.cpp.o.d"
+  "/root/repo/lib/stages/bufferRecv.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferRecv.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferRecv.cpp.o.d"
+  "/root/repo/lib/stages/bufferSend.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferSend.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferSend.cpp.o.d"
+  "/root/repo/lib/stages/bufferShmRecv.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferShmRecv.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferShmRecv.cpp.o.d"
+  "/root/repo/lib/stages/bufferShmSend.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferShmSend.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferShmSend.cpp.o.d"
+  "/root/repo/lib/stages/bufferStatus.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferStatus.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferStatus.cpp.o.d"
+  "/root/repo/lib/stages/bufferSwitch.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferSwitch.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/bufferSwitch.cpp.o.d"
+  "/root/repo/lib/stages/chrxUplink.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/chrxUplink.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/chrxUplink.cpp.o.d"
+  "/root/repo/lib/stages/compressLostSamples.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/compressLostSamples.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/compressLostSamples.cpp.o.d"
+  "/root/repo/lib/stages/computeDualpolPower.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/computeDualpolPower.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/computeDualpolPower.cpp.o.d"
+  "/root/repo/lib/stages/countCheck.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/countCheck.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/countCheck.cpp.o.d"
+  "/root/repo/lib/stages/frbNetworkProcess.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/frbNetworkProcess.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/frbNetworkProcess.cpp.o.d"
+  "/root/repo/lib/stages/frbPostProcess.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/frbPostProcess.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/frbPostProcess.cpp.o.d"
+  "/root/repo/lib/stages/freqSplit.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/freqSplit.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/freqSplit.cpp.o.d"
+  "/root/repo/lib/stages/fullPacketDump.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/fullPacketDump.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/fullPacketDump.cpp.o.d"
+  "/root/repo/lib/stages/integratePowerStream.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/integratePowerStream.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/integratePowerStream.cpp.o.d"
+  "/root/repo/lib/stages/monitorBuffer.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/monitorBuffer.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/monitorBuffer.cpp.o.d"
+  "/root/repo/lib/stages/nDiskFileRead.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/nDiskFileRead.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/nDiskFileRead.cpp.o.d"
+  "/root/repo/lib/stages/nDiskFileWrite.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/nDiskFileWrite.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/nDiskFileWrite.cpp.o.d"
+  "/root/repo/lib/stages/networkInputPowerStream.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/networkInputPowerStream.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/networkInputPowerStream.cpp.o.d"
+  "/root/repo/lib/stages/networkPowerStream.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/networkPowerStream.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/networkPowerStream.cpp.o.d"
+  "/root/repo/lib/stages/prodSubset.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/prodSubset.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/prodSubset.cpp.o.d"
+  "/root/repo/lib/stages/pulsarNetworkProcess.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/pulsarNetworkProcess.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/pulsarNetworkProcess.cpp.o.d"
+  "/root/repo/lib/stages/pulsarPostProcess.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/pulsarPostProcess.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/pulsarPostProcess.cpp.o.d"
+  "/root/repo/lib/stages/pyPlotN2.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/pyPlotN2.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/pyPlotN2.cpp.o.d"
+  "/root/repo/lib/stages/rawFileRead.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rawFileRead.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rawFileRead.cpp.o.d"
+  "/root/repo/lib/stages/rawFileWrite.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rawFileWrite.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rawFileWrite.cpp.o.d"
+  "/root/repo/lib/stages/recvSingleDishVDIF.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/recvSingleDishVDIF.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/recvSingleDishVDIF.cpp.o.d"
+  "/root/repo/lib/stages/removeEv.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/removeEv.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/removeEv.cpp.o.d"
+  "/root/repo/lib/stages/restInspectFrame.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/restInspectFrame.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/restInspectFrame.cpp.o.d"
+  "/root/repo/lib/stages/rfiAVXVDIF.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiAVXVDIF.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiAVXVDIF.cpp.o.d"
+  "/root/repo/lib/stages/rfiBadInputFinder.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiBadInputFinder.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiBadInputFinder.cpp.o.d"
+  "/root/repo/lib/stages/rfiBroadcast.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiBroadcast.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiBroadcast.cpp.o.d"
+  "/root/repo/lib/stages/rfiRecord.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiRecord.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiRecord.cpp.o.d"
+  "/root/repo/lib/stages/rfiUpdateMetadata.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiUpdateMetadata.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiUpdateMetadata.cpp.o.d"
+  "/root/repo/lib/stages/rfiVDIF.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiVDIF.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/rfiVDIF.cpp.o.d"
+  "/root/repo/lib/stages/simpleAutocorr.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/simpleAutocorr.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/simpleAutocorr.cpp.o.d"
+  "/root/repo/lib/stages/streamSingleDishVDIF.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/streamSingleDishVDIF.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/streamSingleDishVDIF.cpp.o.d"
+  "/root/repo/lib/stages/testDataGen.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/testDataGen.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/testDataGen.cpp.o.d"
+  "/root/repo/lib/stages/timeDownsample.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/timeDownsample.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/timeDownsample.cpp.o.d"
+  "/root/repo/lib/stages/valve.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/valve.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/valve.cpp.o.d"
+  "/root/repo/lib/stages/vdifStream.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/vdifStream.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/vdifStream.cpp.o.d"
+  "/root/repo/lib/stages/visAccumulate.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/visAccumulate.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/visAccumulate.cpp.o.d"
+  "/root/repo/lib/stages/visCompression.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/visCompression.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/visCompression.cpp.o.d"
+  "/root/repo/lib/stages/visDebug.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/visDebug.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/visDebug.cpp.o.d"
+  "/root/repo/lib/stages/visTestPattern.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/visTestPattern.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/visTestPattern.cpp.o.d"
+  "/root/repo/lib/stages/visTransform.cpp" "lib/stages/CMakeFiles/kotekan_stages.dir/visTransform.cpp.o" "gcc" "lib/stages/CMakeFiles/kotekan_stages.dir/visTransform.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/lib/utils/CMakeFiles/kotekan_utils.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/testing/CMakeFiles/kotekan_testing.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/core/CMakeFiles/kotekan_core.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/cpu/CMakeFiles/kotekan_cpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/gpu/CMakeFiles/kotekan_gpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/version/CMakeFiles/kotekan_version.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/MurmurHash3/CMakeFiles/MurmurHash3.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/modp_b64/CMakeFiles/modp_b64.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
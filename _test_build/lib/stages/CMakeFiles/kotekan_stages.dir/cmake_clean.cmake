@@ -0,0 +1,151 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan_stages.dir/BadInputFlag.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/BadInputFlag.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/BaseWriter.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/BaseWriter.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/BeamExtract.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/BeamExtract.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/BeamInspect.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/BeamInspect.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/DPDKShuffleSimulate.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/DPDKShuffleSimulate.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/DataQuality.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/DataQuality.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/FreqSubset.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/FreqSubset.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/HFBAccumulate.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/HFBAccumulate.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/HFBRawReader.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/HFBRawReader.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/HFBWriter.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/HFBWriter.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/InputSubset.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/InputSubset.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/RawReader.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/RawReader.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/ReadGain.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/ReadGain.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/ReceiveFlags.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/ReceiveFlags.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/RfiFrameDrop.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/RfiFrameDrop.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/UdpCapture.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/UdpCapture.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/VisRawReader.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/VisRawReader.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/VisSharedMemWriter.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/VisSharedMemWriter.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/VisWriter.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/VisWriter.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/accumulate.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/accumulate.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/beamformingPostProcess.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/beamformingPostProcess.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferBadInputs.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferBadInputs.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferCopy.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferCopy.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferDelay.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferDelay.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferMerge.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferMerge.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferRecv.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferRecv.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferSend.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferSend.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferShmRecv.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferShmRecv.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferShmSend.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferShmSend.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferStatus.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferStatus.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/bufferSwitch.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/bufferSwitch.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/chrxUplink.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/chrxUplink.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/compressLostSamples.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/compressLostSamples.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/computeDualpolPower.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/computeDualpolPower.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/countCheck.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/countCheck.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/frbNetworkProcess.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/frbNetworkProcess.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/frbPostProcess.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/frbPostProcess.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/freqSplit.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/freqSplit.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/fullPacketDump.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/fullPacketDump.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/integratePowerStream.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/integratePowerStream.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/monitorBuffer.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/monitorBuffer.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/nDiskFileRead.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/nDiskFileRead.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/nDiskFileWrite.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/nDiskFileWrite.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/networkInputPowerStream.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/networkInputPowerStream.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/networkPowerStream.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/networkPowerStream.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/prodSubset.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/prodSubset.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/pulsarNetworkProcess.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/pulsarNetworkProcess.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/pulsarPostProcess.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/pulsarPostProcess.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/pyPlotN2.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/pyPlotN2.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rawFileRead.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rawFileRead.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rawFileWrite.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rawFileWrite.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/recvSingleDishVDIF.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/recvSingleDishVDIF.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/removeEv.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/removeEv.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/restInspectFrame.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/restInspectFrame.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rfiAVXVDIF.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rfiAVXVDIF.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rfiBadInputFinder.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rfiBadInputFinder.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rfiBroadcast.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rfiBroadcast.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rfiRecord.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rfiRecord.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rfiUpdateMetadata.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rfiUpdateMetadata.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/rfiVDIF.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/rfiVDIF.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/simpleAutocorr.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/simpleAutocorr.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/streamSingleDishVDIF.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/streamSingleDishVDIF.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/testDataGen.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/testDataGen.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/timeDownsample.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/timeDownsample.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/valve.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/valve.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/vdifStream.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/vdifStream.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/visAccumulate.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/visAccumulate.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/visCompression.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/visCompression.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/visDebug.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/visDebug.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/visTestPattern.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/visTestPattern.cpp.o.d"
+  "CMakeFiles/kotekan_stages.dir/visTransform.cpp.o"
+  "CMakeFiles/kotekan_stages.dir/visTransform.cpp.o.d"
+  "libkotekan_stages.a"
+  "libkotekan_stages.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kotekan_stages.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,47 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/lib/testing/FakeHFB.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/FakeHFB.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/FakeHFB.cpp.o.d"
+  "/root/repo/lib/testing/FakeVis.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/FakeVis.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/FakeVis.cpp.o.d"
+  "/root/repo/lib/testing/FakeVisPattern.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/FakeVisPattern.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/FakeVisPattern.cpp.o.d"
+  "/root/repo/lib/testing/GenHFBFrames.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/GenHFBFrames.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/GenHFBFrames.cpp.o.d"
+  "/root/repo/lib/testing/TestDropFrames.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/TestDropFrames.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/TestDropFrames.cpp.o.d"
+  "/root/repo/lib/testing/chimeMetadataDump.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/chimeMetadataDump.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/chimeMetadataDump.cpp.o.d"
+  "/root/repo/lib/testing/constDataCheck.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/constDataCheck.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/constDataCheck.cpp.o.d"
+  "/root/repo/lib/testing/fakeGpu.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/fakeGpu.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/fakeGpu.cpp.o.d"
+  "/root/repo/lib/testing/fakeGpuPattern.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/fakeGpuPattern.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/fakeGpuPattern.cpp.o.d"
+  "/root/repo/lib/testing/gpuBeamformSimulate.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/gpuBeamformSimulate.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/gpuBeamformSimulate.cpp.o.d"
+  "/root/repo/lib/testing/gpuSimulate.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/gpuSimulate.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/gpuSimulate.cpp.o.d"
+  "/root/repo/lib/testing/gpuTrackingBeamformSimulate.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/gpuTrackingBeamformSimulate.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/gpuTrackingBeamformSimulate.cpp.o.d"
+  "/root/repo/lib/testing/hexDump.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/hexDump.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/hexDump.cpp.o.d"
+  "/root/repo/lib/testing/networkOutputSim.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/networkOutputSim.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/networkOutputSim.cpp.o.d"
+  "/root/repo/lib/testing/pulsarSimProcess.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/pulsarSimProcess.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/pulsarSimProcess.cpp.o.d"
+  "/root/repo/lib/testing/simVdifData.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/simVdifData.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/simVdifData.cpp.o.d"
+  "/root/repo/lib/testing/testDataCheck.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/testDataCheck.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/testDataCheck.cpp.o.d"
+  "/root/repo/lib/testing/testDataGenFloat.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/testDataGenFloat.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/testDataGenFloat.cpp.o.d"
+  "/root/repo/lib/testing/testDataGenQuad.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/testDataGenQuad.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/testDataGenQuad.cpp.o.d"
+  "/root/repo/lib/testing/visDrop.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/visDrop.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/visDrop.cpp.o.d"
+  "/root/repo/lib/testing/visNoise.cpp" "lib/testing/CMakeFiles/kotekan_testing.dir/visNoise.cpp.o" "gcc" "lib/testing/CMakeFiles/kotekan_testing.dir/visNoise.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/lib/utils/CMakeFiles/kotekan_utils.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/stages/CMakeFiles/kotekan_stages.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/core/CMakeFiles/kotekan_core.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/cpu/CMakeFiles/kotekan_cpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/gpu/CMakeFiles/kotekan_gpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/version/CMakeFiles/kotekan_version.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/MurmurHash3/CMakeFiles/MurmurHash3.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/modp_b64/CMakeFiles/modp_b64.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,51 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan_testing.dir/FakeHFB.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/FakeHFB.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/FakeVis.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/FakeVis.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/FakeVisPattern.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/FakeVisPattern.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/GenHFBFrames.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/GenHFBFrames.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/TestDropFrames.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/TestDropFrames.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/chimeMetadataDump.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/chimeMetadataDump.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/constDataCheck.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/constDataCheck.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/fakeGpu.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/fakeGpu.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/fakeGpuPattern.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/fakeGpuPattern.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/gpuBeamformSimulate.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/gpuBeamformSimulate.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/gpuSimulate.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/gpuSimulate.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/gpuTrackingBeamformSimulate.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/gpuTrackingBeamformSimulate.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/hexDump.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/hexDump.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/networkOutputSim.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/networkOutputSim.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/pulsarSimProcess.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/pulsarSimProcess.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/simVdifData.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/simVdifData.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/testDataCheck.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/testDataCheck.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/testDataGenFloat.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/testDataGenFloat.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/testDataGenQuad.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/testDataGenQuad.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/visDrop.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/visDrop.cpp.o.d"
+  "CMakeFiles/kotekan_testing.dir/visNoise.cpp.o"
+  "CMakeFiles/kotekan_testing.dir/visNoise.cpp.o.d"
+  "libkotekan_testing.a"
+  "libkotekan_testing.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/kotekan_testing.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,59 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/lib/utils/nt_memcpy.c" "lib/utils/CMakeFiles/kotekan_utils.dir/nt_memcpy.c.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/nt_memcpy.c.o.d"
+  "/root/repo/lib/utils/nt_memset.c" "lib/utils/CMakeFiles/kotekan_utils.dir/nt_memset.c.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/nt_memset.c.o.d"
+  "/root/repo/lib/utils/output_formating.c" "lib/utils/CMakeFiles/kotekan_utils.dir/output_formating.c.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/output_formating.c.o.d"
+  "/root/repo/lib/utils/util.c" "lib/utils/CMakeFiles/kotekan_utils.dir/util.c.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/util.c.o.d"
+  "/root/repo/lib/utils/BipBuffer.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/BipBuffer.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/BipBuffer.cpp.o.d"
+  "/root/repo/lib/utils/BufferShmRing.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/BufferShmRing.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/BufferShmRing.cpp.o.d"
+  "/root/repo/lib/utils/CHIMETelescope.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/CHIMETelescope.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/CHIMETelescope.cpp.o.d"
+  "/root/repo/lib/utils/FrameCompression.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/FrameCompression.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/FrameCompression.cpp.o.d"
+  "/root/repo/lib/utils/FrameView.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/FrameView.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/FrameView.cpp.o.d"
+  "/root/repo/lib/utils/HFBFrameView.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/HFBFrameView.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/HFBFrameView.cpp.o.d"
+  "/root/repo/lib/utils/Hash.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/Hash.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/Hash.cpp.o.d"
+  "/root/repo/lib/utils/ICETelescope.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/ICETelescope.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/ICETelescope.cpp.o.d"
+  "/root/repo/lib/utils/KernelTuning.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/KernelTuning.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/KernelTuning.cpp.o.d"
+  "/root/repo/lib/utils/Stack.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/Stack.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/Stack.cpp.o.d"
+  "/root/repo/lib/utils/SystemInterface.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/SystemInterface.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/SystemInterface.cpp.o.d"
+  "/root/repo/lib/utils/Telescope.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/Telescope.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/Telescope.cpp.o.d"
+  "/root/repo/lib/utils/UdpTransmitter.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/UdpTransmitter.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/UdpTransmitter.cpp.o.d"
+  "/root/repo/lib/utils/VisSharedMemReader.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/VisSharedMemReader.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/VisSharedMemReader.cpp.o.d"
+  "/root/repo/lib/utils/dataset.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/dataset.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/dataset.cpp.o.d"
+  "/root/repo/lib/utils/datasetManager.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/datasetManager.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/datasetManager.cpp.o.d"
+  "/root/repo/lib/utils/datasetState.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/datasetState.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/datasetState.cpp.o.d"
+  "/root/repo/lib/utils/gateSpec.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/gateSpec.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/gateSpec.cpp.o.d"
+  "/root/repo/lib/utils/hfbFileRaw.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/hfbFileRaw.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/hfbFileRaw.cpp.o.d"
+  "/root/repo/lib/utils/network_functions.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/network_functions.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/network_functions.cpp.o.d"
+  "/root/repo/lib/utils/pulsarTiming.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/pulsarTiming.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/pulsarTiming.cpp.o.d"
+  "/root/repo/lib/utils/restClient.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/restClient.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/restClient.cpp.o.d"
+  "/root/repo/lib/utils/tx_utils.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/tx_utils.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/tx_utils.cpp.o.d"
+  "/root/repo/lib/utils/type.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/type.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/type.cpp.o.d"
+  "/root/repo/lib/utils/visBuffer.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/visBuffer.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/visBuffer.cpp.o.d"
+  "/root/repo/lib/utils/visFile.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/visFile.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/visFile.cpp.o.d"
+  "/root/repo/lib/utils/visFileRaw.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/visFileRaw.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/visFileRaw.cpp.o.d"
+  "/root/repo/lib/utils/visFileRing.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/visFileRing.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/visFileRing.cpp.o.d"
+  "/root/repo/lib/utils/visUtil.cpp" "lib/utils/CMakeFiles/kotekan_utils.dir/visUtil.cpp.o" "gcc" "lib/utils/CMakeFiles/kotekan_utils.dir/visUtil.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/lib/stages/CMakeFiles/kotekan_stages.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/testing/CMakeFiles/kotekan_testing.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/core/CMakeFiles/kotekan_core.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/cpu/CMakeFiles/kotekan_cpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/gpu/CMakeFiles/kotekan_gpu.dir/DependInfo.cmake"
+  "/root/repo/_test_build/lib/version/CMakeFiles/kotekan_version.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/MurmurHash3/CMakeFiles/MurmurHash3.dir/DependInfo.cmake"
+  "/root/repo/_test_build/external/modp_b64/CMakeFiles/modp_b64.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
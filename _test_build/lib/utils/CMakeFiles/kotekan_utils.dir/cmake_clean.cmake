@@ -0,0 +1,75 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan_utils.dir/BipBuffer.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/BipBuffer.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/BufferShmRing.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/BufferShmRing.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/CHIMETelescope.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/CHIMETelescope.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/FrameCompression.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/FrameCompression.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/FrameView.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/FrameView.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/HFBFrameView.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/HFBFrameView.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/Hash.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/Hash.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/ICETelescope.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/ICETelescope.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/KernelTuning.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/KernelTuning.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/Stack.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/Stack.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/SystemInterface.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/SystemInterface.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/Telescope.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/Telescope.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/UdpTransmitter.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/UdpTransmitter.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/VisSharedMemReader.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/VisSharedMemReader.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/dataset.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/dataset.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/datasetManager.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/datasetManager.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/datasetState.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/datasetState.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/gateSpec.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/gateSpec.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/hfbFileRaw.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/hfbFileRaw.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/network_functions.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/network_functions.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/nt_memcpy.c.o"
+  "CMakeFiles/kotekan_utils.dir/nt_memcpy.c.o.d"
+  "CMakeFiles/kotekan_utils.dir/nt_memset.c.o"
+  "CMakeFiles/kotekan_utils.dir/nt_memset.c.o.d"
+  "CMakeFiles/kotekan_utils.dir/output_formating.c.o"
+  "CMakeFiles/kotekan_utils.dir/output_formating.c.o.d"
+  "CMakeFiles/kotekan_utils.dir/pulsarTiming.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/pulsarTiming.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/restClient.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/restClient.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/tx_utils.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/tx_utils.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/type.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/type.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/util.c.o"
+  "CMakeFiles/kotekan_utils.dir/util.c.o.d"
+  "CMakeFiles/kotekan_utils.dir/visBuffer.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/visBuffer.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/visFile.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/visFile.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/visFileRaw.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/visFileRaw.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/visFileRing.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/visFileRing.cpp.o.d"
+  "CMakeFiles/kotekan_utils.dir/visUtil.cpp.o"
+  "CMakeFiles/kotekan_utils.dir/visUtil.cpp.o.d"
+  "libkotekan_utils.a"
+  "libkotekan_utils.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C CXX)
+  include(CMakeFiles/kotekan_utils.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
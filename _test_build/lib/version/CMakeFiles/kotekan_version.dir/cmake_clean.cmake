@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/kotekan_version.dir/version.c.o"
+  "CMakeFiles/kotekan_version.dir/version.c.o.d"
+  "libkotekan_version.a"
+  "libkotekan_version.pdb"
+  "version.c"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/kotekan_version.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,72 @@
+# Template for the script to generate the version.c
+# file from the version.c.in template
+# Yes this is generating a file to generate a file,
+# and no I'm not happy this is how it has to work -AR
+
+set(SOURCE_DIR "/root/repo")
+set(BINARY_DIR "/root/repo/_test_build")
+set(CURRENT_SOURCE_DIR "/root/repo/lib/version")
+set(CURRENT_BINARY_DIR "/root/repo/_test_build/lib/version")
+
+set(CMAKE_BUILD_TYPE "Debug")
+set(CMAKE_CXX_COMPILER "/usr/bin/c++")
+set(CMAKE_C_COMPILER "/usr/bin/cc")
+set(USE_DPDK "OFF")
+set(RTE_SDK "")
+set(RTE_TARGET "")
+set(USE_HSA "OFF")
+set(USE_CLOC "OFF")
+set(USE_OPENCL "OFF")
+set(USE_HCC "OFF")
+set(USE_CUDA "OFF")
+set(USE_HDF5 "OFF")
+set(HIGHFIVE_PATH "")
+set(USE_LAPACK "OFF")
+set(OPENBLAS_PATH "")
+set(USE_AIRSPY "OFF")
+set(USE_FFTW "OFF")
+set(USE_OMP "OFF")
+set(USE_OPENSSL "")
+
+# Get the current working branch
+execute_process(
+  COMMAND git rev-parse --abbrev-ref HEAD
+  WORKING_DIRECTORY ${SOURCE_DIR}
+  OUTPUT_VARIABLE GIT_BRANCH
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+
+# Get the latest abbreviated commit hash of the working branch
+execute_process(
+  COMMAND git log -1 --format=%H
+  WORKING_DIRECTORY ${SOURCE_DIR}
+  OUTPUT_VARIABLE GIT_COMMIT_HASH
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+
+execute_process(
+  COMMAND python -c "import kotekan; print(kotekan.__version__)"
+  WORKING_DIRECTORY ${SOURCE_DIR}/python/
+  OUTPUT_VARIABLE KOTEKAN_VERSION
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+
+execute_process(
+  COMMAND git rev-parse --abbrev-ref HEAD
+  WORKING_DIRECTORY ${SOURCE_DIR}
+  OUTPUT_VARIABLE KOTEKAN_BRANCH
+  OUTPUT_STRIP_TRAILING_WHITESPACE
+)
+
+# Remove branch name if we are on master
+if (${KOTEKAN_BRANCH} MATCHES "master")
+    set(FULL_KOTEKAN_VERSION "${KOTEKAN_VERSION}")
+else()
+    set(FULL_KOTEKAN_VERSION "${KOTEKAN_BRANCH}.${KOTEKAN_VERSION}")
+endif()
+
+configure_file(
+    ${CURRENT_SOURCE_DIR}/version.c.in
+    ${CURRENT_BINARY_DIR}/version.c
+    @ONLY
+)
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/dataset_broker_consumer.dir/dataset_broker_consumer.cpp.o"
+  "CMakeFiles/dataset_broker_consumer.dir/dataset_broker_consumer.cpp.o.d"
+  "dataset_broker_consumer"
+  "dataset_broker_consumer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/dataset_broker_consumer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
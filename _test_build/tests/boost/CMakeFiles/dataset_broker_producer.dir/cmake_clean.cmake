@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/dataset_broker_producer.dir/dataset_broker_producer.cpp.o"
+  "CMakeFiles/dataset_broker_producer.dir/dataset_broker_producer.cpp.o.d"
+  "dataset_broker_producer"
+  "dataset_broker_producer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/dataset_broker_producer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
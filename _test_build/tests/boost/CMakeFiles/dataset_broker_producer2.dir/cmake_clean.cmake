@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/dataset_broker_producer2.dir/dataset_broker_producer2.cpp.o"
+  "CMakeFiles/dataset_broker_producer2.dir/dataset_broker_producer2.cpp.o.d"
+  "dataset_broker_producer2"
+  "dataset_broker_producer2.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/dataset_broker_producer2.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_bip_buffer.dir/test_bip_buffer.cpp.o"
+  "CMakeFiles/test_bip_buffer.dir/test_bip_buffer.cpp.o.d"
+  "test_bip_buffer"
+  "test_bip_buffer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_bip_buffer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_buffer_shm_ring.dir/test_buffer_shm_ring.cpp.o"
+  "CMakeFiles/test_buffer_shm_ring.dir/test_buffer_shm_ring.cpp.o.d"
+  "test_buffer_shm_ring"
+  "test_buffer_shm_ring.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_buffer_shm_ring.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
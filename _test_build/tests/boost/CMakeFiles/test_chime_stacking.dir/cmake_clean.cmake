@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_chime_stacking.dir/test_chime_stacking.cpp.o"
+  "CMakeFiles/test_chime_stacking.dir/test_chime_stacking.cpp.o.d"
+  "test_chime_stacking"
+  "test_chime_stacking.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_chime_stacking.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_cpu_beamform.dir/test_cpu_beamform.cpp.o"
+  "CMakeFiles/test_cpu_beamform.dir/test_cpu_beamform.cpp.o.d"
+  "test_cpu_beamform"
+  "test_cpu_beamform.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_cpu_beamform.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
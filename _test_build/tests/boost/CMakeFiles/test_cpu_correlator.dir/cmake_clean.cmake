@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_cpu_correlator.dir/test_cpu_correlator.cpp.o"
+  "CMakeFiles/test_cpu_correlator.dir/test_cpu_correlator.cpp.o.d"
+  "test_cpu_correlator"
+  "test_cpu_correlator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_cpu_correlator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_cpu_device.dir/test_cpu_device.cpp.o"
+  "CMakeFiles/test_cpu_device.dir/test_cpu_device.cpp.o.d"
+  "test_cpu_device"
+  "test_cpu_device.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_cpu_device.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_cpu_rfi.dir/test_cpu_rfi.cpp.o"
+  "CMakeFiles/test_cpu_rfi.dir/test_cpu_rfi.cpp.o.d"
+  "test_cpu_rfi"
+  "test_cpu_rfi.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_cpu_rfi.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_cpu_tracking_beamform.dir/test_cpu_tracking_beamform.cpp.o"
+  "CMakeFiles/test_cpu_tracking_beamform.dir/test_cpu_tracking_beamform.cpp.o.d"
+  "test_cpu_tracking_beamform"
+  "test_cpu_tracking_beamform.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_cpu_tracking_beamform.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_dataset_manager.dir/test_dataset_manager.cpp.o"
+  "CMakeFiles/test_dataset_manager.dir/test_dataset_manager.cpp.o.d"
+  "test_dataset_manager"
+  "test_dataset_manager.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_dataset_manager.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
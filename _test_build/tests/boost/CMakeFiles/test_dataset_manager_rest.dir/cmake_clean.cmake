@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_dataset_manager_rest.dir/test_dataset_manager_rest.cpp.o"
+  "CMakeFiles/test_dataset_manager_rest.dir/test_dataset_manager_rest.cpp.o.d"
+  "test_dataset_manager_rest"
+  "test_dataset_manager_rest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_dataset_manager_rest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_frame_compression.dir/test_frame_compression.cpp.o"
+  "CMakeFiles/test_frame_compression.dir/test_frame_compression.cpp.o.d"
+  "test_frame_compression"
+  "test_frame_compression.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_frame_compression.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_gpu_command_scheduler.dir/test_gpu_command_scheduler.cpp.o"
+  "CMakeFiles/test_gpu_command_scheduler.dir/test_gpu_command_scheduler.cpp.o.d"
+  "test_gpu_command_scheduler"
+  "test_gpu_command_scheduler.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_gpu_command_scheduler.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_gpu_timeline.dir/test_gpu_timeline.cpp.o"
+  "CMakeFiles/test_gpu_timeline.dir/test_gpu_timeline.cpp.o.d"
+  "test_gpu_timeline"
+  "test_gpu_timeline.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_gpu_timeline.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
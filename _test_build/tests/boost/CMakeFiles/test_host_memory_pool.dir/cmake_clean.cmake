@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_host_memory_pool.dir/test_host_memory_pool.cpp.o"
+  "CMakeFiles/test_host_memory_pool.dir/test_host_memory_pool.cpp.o.d"
+  "test_host_memory_pool"
+  "test_host_memory_pool.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_host_memory_pool.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_kernel_tuning.dir/test_kernel_tuning.cpp.o"
+  "CMakeFiles/test_kernel_tuning.dir/test_kernel_tuning.cpp.o.d"
+  "test_kernel_tuning"
+  "test_kernel_tuning.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_kernel_tuning.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
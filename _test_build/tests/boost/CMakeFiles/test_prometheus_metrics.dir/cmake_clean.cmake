@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_prometheus_metrics.dir/test_prometheus_metrics.cpp.o"
+  "CMakeFiles/test_prometheus_metrics.dir/test_prometheus_metrics.cpp.o.d"
+  "test_prometheus_metrics"
+  "test_prometheus_metrics.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_prometheus_metrics.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_rest_server.dir/test_rest_server.cpp.o"
+  "CMakeFiles/test_rest_server.dir/test_rest_server.cpp.o.d"
+  "test_rest_server"
+  "test_rest_server.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_rest_server.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
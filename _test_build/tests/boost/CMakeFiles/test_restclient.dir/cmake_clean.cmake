@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_restclient.dir/test_restclient.cpp.o"
+  "CMakeFiles/test_restclient.dir/test_restclient.cpp.o.d"
+  "test_restclient"
+  "test_restclient.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_restclient.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
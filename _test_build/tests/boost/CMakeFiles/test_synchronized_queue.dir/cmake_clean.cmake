@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_synchronized_queue.dir/test_synchronized_queue.cpp.o"
+  "CMakeFiles/test_synchronized_queue.dir/test_synchronized_queue.cpp.o.d"
+  "test_synchronized_queue"
+  "test_synchronized_queue.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_synchronized_queue.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_truncate.dir/test_truncate.cpp.o"
+  "CMakeFiles/test_truncate.dir/test_truncate.cpp.o.d"
+  "test_truncate"
+  "test_truncate.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_truncate.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_udp_transmitter.dir/test_udp_transmitter.cpp.o"
+  "CMakeFiles/test_udp_transmitter.dir/test_udp_transmitter.cpp.o.d"
+  "test_udp_transmitter"
+  "test_udp_transmitter.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_udp_transmitter.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
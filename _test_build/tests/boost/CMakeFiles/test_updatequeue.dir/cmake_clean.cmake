@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_updatequeue.dir/test_updatequeue.cpp.o"
+  "CMakeFiles/test_updatequeue.dir/test_updatequeue.cpp.o.d"
+  "test_updatequeue"
+  "test_updatequeue.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_updatequeue.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_vis_shared_mem_reader.dir/test_vis_shared_mem_reader.cpp.o"
+  "CMakeFiles/test_vis_shared_mem_reader.dir/test_vis_shared_mem_reader.cpp.o.d"
+  "test_vis_shared_mem_reader"
+  "test_vis_shared_mem_reader.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_vis_shared_mem_reader.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
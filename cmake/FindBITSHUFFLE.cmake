@@ -0,0 +1,21 @@
+# Finds the bitshuffle library (as built for the HDF5 plugin) Sets the following if bitshuffle is
+# found: BITSHUFFLE_FOUND, BITSHUFFLE_INCLUDE_DIR, BITSHUFFLE_LIBRARY
+
+include(FindPackageHandleStandardArgs)
+
+set(BITSHUFFLE_SEARCH_PATHS /usr/include /usr/local/include /usr/local/hdf5/include)
+
+find_path(
+    BITSHUFFLE_INCLUDE_DIR
+    NAMES bitshuffle.h
+    PATHS ${BITSHUFFLE_SEARCH_PATHS}
+    PATH_SUFFIXES bitshuffle)
+
+find_library(
+    BITSHUFFLE_LIBRARY
+    NAMES bitshuffle h5bshuf
+    PATHS /usr/local/hdf5/lib/plugin /usr/local/lib/hdf5/plugin)
+
+find_package_handle_standard_args(BITSHUFFLE DEFAULT_MSG BITSHUFFLE_LIBRARY BITSHUFFLE_INCLUDE_DIR)
+
+mark_as_advanced(BITSHUFFLE_INCLUDE_DIR BITSHUFFLE_LIBRARY)
@@ -0,0 +1,17 @@
+# Finds the lz4 compression library Sets the following if lz4 is found: LZ4_FOUND,
+# LZ4_INCLUDE_DIR, LZ4_LIBRARY
+
+include(FindPackageHandleStandardArgs)
+
+set(LZ4_SEARCH_PATHS /usr/include /usr/local/include)
+
+find_path(
+    LZ4_INCLUDE_DIR
+    NAMES lz4.h
+    PATHS ${LZ4_SEARCH_PATHS})
+
+find_library(LZ4_LIBRARY NAMES lz4)
+
+find_package_handle_standard_args(LZ4 DEFAULT_MSG LZ4_LIBRARY LZ4_INCLUDE_DIR)
+
+mark_as_advanced(LZ4_INCLUDE_DIR LZ4_LIBRARY)
@@ -0,0 +1,17 @@
+# Finds the zstd compression library Sets the following if zstd is found: ZSTD_FOUND,
+# ZSTD_INCLUDE_DIR, ZSTD_LIBRARY
+
+include(FindPackageHandleStandardArgs)
+
+set(ZSTD_SEARCH_PATHS /usr/include /usr/local/include)
+
+find_path(
+    ZSTD_INCLUDE_DIR
+    NAMES zstd.h
+    PATHS ${ZSTD_SEARCH_PATHS})
+
+find_library(ZSTD_LIBRARY NAMES zstd)
+
+find_package_handle_standard_args(ZSTD DEFAULT_MSG ZSTD_LIBRARY ZSTD_INCLUDE_DIR)
+
+mark_as_advanced(ZSTD_INCLUDE_DIR ZSTD_LIBRARY)
@@ -97,6 +97,10 @@ void print_help() {
     printf("    --config (-c) [file]           The local JSON config file to use.\n");
     printf("    --bind-address (-b) [ip:port]  The IP address and port to bind"
            " (default 0.0.0.0:12048)\n");
+    printf("    --rest-threads (-t) [n]        The number of REST server event loops"
+           " (default 1).\n");
+    printf("    --rest-workers (-w) [n]        The number of REST server worker threads for"
+           " blocking endpoints (default 2).\n");
     printf("    --syslog (-s)                  Send a copy of the output to syslog.\n");
     printf("    --no-stderr (-n)               Disables output to std error if syslog (-s) is "
            "enabled.\n");
@@ -262,6 +266,8 @@ int main(int argc, char** argv) {
     bool enable_stderr = true;
     bool dump_config = false;
     std::string bind_address = "0.0.0.0:12048";
+    uint32_t rest_threads = 1;
+    uint32_t rest_workers = 2;
     // We disable syslog to start.
     // If only --config is provided, then we only send messages to stderr
     // If --syslog is added, then output is to both syslog and stderr
@@ -272,6 +278,8 @@ int main(int argc, char** argv) {
     for (;;) {
         static struct option long_options[] = {{"config", required_argument, nullptr, 'c'},
                                                {"bind-address", required_argument, nullptr, 'b'},
+                                               {"rest-threads", required_argument, nullptr, 't'},
+                                               {"rest-workers", required_argument, nullptr, 'w'},
                                                {"help", no_argument, nullptr, 'h'},
                                                {"syslog", no_argument, nullptr, 's'},
                                                {"no-stderr", no_argument, nullptr, 'n'},
@@ -282,7 +290,7 @@ int main(int argc, char** argv) {
 
         int option_index = 0;
 
-        int opt_val = getopt_long(argc, argv, "hc:b:snvp", long_options, &option_index);
+        int opt_val = getopt_long(argc, argv, "hc:b:t:w:snvp", long_options, &option_index);
 
         // End of args
         if (opt_val == -1) {
@@ -300,6 +308,12 @@ int main(int argc, char** argv) {
             case 'b':
                 bind_address = string(optarg);
                 break;
+            case 't':
+                rest_threads = std::stoul(optarg);
+                break;
+            case 'w':
+                rest_workers = std::stoul(optarg);
+                break;
             case 's':
                 __enable_syslog = 1;
                 break;
@@ -352,7 +366,8 @@ int main(int argc, char** argv) {
     restServer& rest_server = restServer::instance();
     std::vector<std::string> address_parts = regex_split(bind_address, ":");
     // TODO validate IP and port
-    rest_server.start(address_parts.at(0), std::stoi(address_parts.at(1)));
+    rest_server.start(address_parts.at(0), std::stoi(address_parts.at(1)), rest_threads,
+                      rest_workers);
 
     if (string(config_file_name) != "none") {
         // TODO should be in a try catch block, to make failures cleaner.
@@ -378,67 +393,75 @@ int main(int argc, char** argv) {
     }
 
     // Main REST callbacks.
-    rest_server.register_post_callback("/start", [&](connectionInstance& conn, json& json_config) {
-        std::lock_guard<std::mutex> lock(kotekan_state_lock);
-        if (running) {
-            WARN_NON_OO(
-                "/start was called, but the system is already running, ignoring start request.");
-            conn.send_error("Already running", HTTP_RESPONSE::REQUEST_FAILED);
-            return;
-        }
+    rest_server.register_post_callback(
+        "/start",
+        [&](connectionInstance& conn, json& json_config) {
+            std::lock_guard<std::mutex> lock(kotekan_state_lock);
+            if (running) {
+                WARN_NON_OO("/start was called, but the system is already running, ignoring start "
+                            "request.");
+                conn.send_error("Already running", HTTP_RESPONSE::REQUEST_FAILED);
+                return;
+            }
 
-        config.update_config(json_config);
+            config.update_config(json_config);
 
-        try {
-            INFO_NON_OO("Starting new kotekan mode using POSTed config.");
-            start_new_kotekan_mode(config, dump_config);
-        } catch (const std::out_of_range& ex) {
-            delete kotekan_mode;
-            kotekan_mode = nullptr;
-            conn.send_error(ex.what(), HTTP_RESPONSE::BAD_REQUEST);
-            // TODO This exit shouldn't be required, but some stages aren't able
-            // to fully clean up on system failure.  This results in the system
-            // getting into a bad state if the posted config is invalid.
-            // See ticket: #464
-            // The same applies to exit (raise) statements in other parts of
-            // this try statement.
-            FATAL_ERROR_NON_OO("Provided config had an out of range exception: {:s}", ex.what());
-            return;
-        } catch (const std::runtime_error& ex) {
-            delete kotekan_mode;
-            kotekan_mode = nullptr;
-            conn.send_error(ex.what(), HTTP_RESPONSE::BAD_REQUEST);
-            FATAL_ERROR_NON_OO("Provided config failed to start with runtime error: {:s}",
-                               ex.what());
-            return;
-        } catch (const std::exception& ex) {
+            try {
+                INFO_NON_OO("Starting new kotekan mode using POSTed config.");
+                start_new_kotekan_mode(config, dump_config);
+            } catch (const std::out_of_range& ex) {
+                delete kotekan_mode;
+                kotekan_mode = nullptr;
+                conn.send_error(ex.what(), HTTP_RESPONSE::BAD_REQUEST);
+                // TODO This exit shouldn't be required, but some stages aren't able
+                // to fully clean up on system failure.  This results in the system
+                // getting into a bad state if the posted config is invalid.
+                // See ticket: #464
+                // The same applies to exit (raise) statements in other parts of
+                // this try statement.
+                FATAL_ERROR_NON_OO("Provided config had an out of range exception: {:s}",
+                                   ex.what());
+                return;
+            } catch (const std::runtime_error& ex) {
+                delete kotekan_mode;
+                kotekan_mode = nullptr;
+                conn.send_error(ex.what(), HTTP_RESPONSE::BAD_REQUEST);
+                FATAL_ERROR_NON_OO("Provided config failed to start with runtime error: {:s}",
+                                   ex.what());
+                return;
+            } catch (const std::exception& ex) {
+                delete kotekan_mode;
+                kotekan_mode = nullptr;
+                conn.send_error(ex.what(), HTTP_RESPONSE::BAD_REQUEST);
+                FATAL_ERROR_NON_OO("Provided config failed with exception: {:s}", ex.what());
+                return;
+            }
+            conn.send_empty_reply(HTTP_RESPONSE::OK);
+        },
+        true);
+
+    rest_server.register_get_callback(
+        "/stop",
+        [&](connectionInstance& conn) {
+            std::lock_guard<std::mutex> lock(kotekan_state_lock);
+            if (!running) {
+                WARN_NON_OO(
+                    "/stop called, but the system is already stopped, ignoring stop request.");
+                conn.send_error("kotekan is already stopped", HTTP_RESPONSE::REQUEST_FAILED);
+                return;
+            }
+            INFO_NON_OO("/stop endpoint called, shutting down current config.");
+            assert(kotekan_mode != nullptr);
+            kotekan_mode->stop_stages();
+            // TODO should we have three states (running, shutting down, and stopped)?
+            // This would prevent this function from blocking on join.
+            kotekan_mode->join();
             delete kotekan_mode;
             kotekan_mode = nullptr;
-            conn.send_error(ex.what(), HTTP_RESPONSE::BAD_REQUEST);
-            FATAL_ERROR_NON_OO("Provided config failed with exception: {:s}", ex.what());
-            return;
-        }
-        conn.send_empty_reply(HTTP_RESPONSE::OK);
-    });
-
-    rest_server.register_get_callback("/stop", [&](connectionInstance& conn) {
-        std::lock_guard<std::mutex> lock(kotekan_state_lock);
-        if (!running) {
-            WARN_NON_OO("/stop called, but the system is already stopped, ignoring stop request.");
-            conn.send_error("kotekan is already stopped", HTTP_RESPONSE::REQUEST_FAILED);
-            return;
-        }
-        INFO_NON_OO("/stop endpoint called, shutting down current config.");
-        assert(kotekan_mode != nullptr);
-        kotekan_mode->stop_stages();
-        // TODO should we have three states (running, shutting down, and stopped)?
-        // This would prevent this function from blocking on join.
-        kotekan_mode->join();
-        delete kotekan_mode;
-        kotekan_mode = nullptr;
-        running = false;
-        conn.send_empty_reply(HTTP_RESPONSE::OK);
-    });
+            running = false;
+            conn.send_empty_reply(HTTP_RESPONSE::OK);
+        },
+        true);
 
     rest_server.register_get_callback("/kill", [&](connectionInstance& conn) {
         ERROR_NON_OO(
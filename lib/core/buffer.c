@@ -1,24 +1,18 @@
 #include "buffer.h"
 
-#include "errors.h"    // for CHECK_ERROR_F, ERROR_F, CHECK_MEM_F, INFO_F, DEBUG_F, WARN_F, DEB...
-#include "metadata.h"  // for metadataContainer, decrement_metadata_ref_count, increment_metada...
-#include "nt_memset.h" // for nt_memset
-#include "util.h"      // for e_time
-#ifdef WITH_HSA
-#include "hsaBase.h" // for hsa_host_free, hsa_host_malloc
-#endif
-
-#include <assert.h>   // for assert
-#include <errno.h>    // for ETIMEDOUT
-#include <sched.h>    // for cpu_set_t, CPU_SET, CPU_ZERO
-#include <stdio.h>    // for snprintf
-#include <stdlib.h>   // for free, malloc
-#include <string.h>   // for memset, memcpy, strncmp, strncpy, strdup
-#include <sys/mman.h> // IWYU pragma: keep
-#include <time.h>     // for NULL, size_t, timespec
-#ifdef WITH_NUMA
-#include <numa.h> // IWYU pragma: keep
-#endif
+#include "errors.h"         // for CHECK_ERROR_F, ERROR_F, CHECK_MEM_F, INFO_F, DEBUG_F, WARN_F...
+#include "hostMemoryPool.h" // for host_pool_free, host_pool_malloc
+#include "metadata.h"       // for metadataContainer, decrement_metadata_ref_count, increment_...
+#include "nt_memset.h"      // for nt_memset
+#include "util.h"           // for e_time
+
+#include <assert.h>  // for assert
+#include <errno.h>   // for ETIMEDOUT
+#include <sched.h>   // for cpu_set_t, CPU_SET, CPU_ZERO
+#include <stdio.h>   // for snprintf
+#include <stdlib.h>  // for free, malloc
+#include <string.h>  // for memset, memcpy, strncmp, strncpy, strdup
+#include <time.h>    // for NULL, size_t, timespec
 
 struct zero_frames_thread_args {
     struct Buffer* buf;
@@ -844,44 +838,13 @@ void swap_frames(struct Buffer* from_buf, int from_frame_id, struct Buffer* to_b
 
 uint8_t* buffer_malloc(ssize_t len, int numa_node) {
 
-    uint8_t* frame = NULL;
-    int err;
-
-#ifdef WITH_HSA
-    (void)err;
-    // Is this memory aligned?
-    frame = hsa_host_malloc(len, numa_node);
+    // Page aligned, locked and pinned with the device runtimes, so it can be copied with DMA
+    uint8_t* frame = (uint8_t*)host_pool_malloc(len, numa_node);
     if (frame == NULL) {
+        ERROR_F("Error allocating %zd bytes of host memory on NUMA node %d", len, numa_node);
         return NULL;
     }
-#else
-#ifdef WITH_NUMA
-    frame = (uint8_t*)numa_alloc_onnode(len, numa_node);
-    CHECK_MEM_F(frame);
-#else
-    (void)numa_node;
-    // Create a page aligned block of memory for the buffer
-    err = posix_memalign((void**)&(frame), PAGESIZE_MEM, len);
-    CHECK_MEM_F(frame);
-    if (err != 0) {
-        ERROR_F("Error creating aligned memory: %d", err);
-        return NULL;
-    }
-#endif
-
-#ifndef WITH_NO_MEMLOCK
-    // Ask that all pages be kept in memory
-    err = mlock((void*)frame, len);
 
-    if (err == -1) {
-        ERROR_F("Error locking memory: %d - check ulimit -a to check memlock limits", errno);
-        free(frame);
-        return NULL;
-    }
-#else
-    (void)err;
-#endif
-#endif
     // Zero the new frame
     memset(frame, 0x0, len);
 
@@ -889,17 +852,8 @@ uint8_t* buffer_malloc(ssize_t len, int numa_node) {
 }
 
 void buffer_free(uint8_t* frame_pointer, size_t size) {
-#ifdef WITH_HSA
-    (void)size;
-    hsa_host_free(frame_pointer);
-#else
-#ifdef WITH_NUMA
-    numa_free(frame_pointer, size);
-#else
     (void)size;
-    free(frame_pointer);
-#endif
-#endif
+    host_pool_free(frame_pointer);
 }
 
 // Do not call if there is no metadata
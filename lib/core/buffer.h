@@ -428,7 +428,9 @@ void allocate_new_metadata_object(struct Buffer* buf, int frame_id);
  * @warning This function should only be used by single producer stages.
  * @warning The extra frame provided to this function must be allocated with
  *          @c buffer_malloc() and the frame returned by this function must be
- *          freed with @c buffer_free()
+ *          freed with @c buffer_free(). Any other memory (e.g. a memory map) isn't
+ *          pinned for the DMA copies to the GPUs, and must be swapped back for a
+ *          frame from @c buffer_malloc() before the buffer is deleted.
  * @warning Take care when using this function!
  *
  * @param buf The buffer object to swap with
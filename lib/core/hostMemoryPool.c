@@ -0,0 +1,262 @@
+#include "hostMemoryPool.h"
+
+#include "buffer.h" // for PAGESIZE_MEM
+#include "errors.h" // for CHECK_ERROR_F, CHECK_MEM_F, ERROR_F, FATAL_ERROR_F, WARN_F, DEBUG_F
+#ifdef WITH_HSA
+#include "hsaBase.h" // for hsa_host_free, hsa_host_malloc
+#endif
+
+#include <errno.h>    // for errno
+#include <pthread.h>  // for pthread_mutex_lock, pthread_mutex_unlock, PTHREAD_MUTEX_INIT...
+#include <stdint.h>   // for uint8_t
+#include <stdlib.h>   // for free, realloc, posix_memalign
+#include <string.h>   // for strcmp, strdup
+#include <sys/mman.h> // IWYU pragma: keep
+#ifdef WITH_NUMA
+#include <numa.h> // IWYU pragma: keep
+#endif
+
+// A region of memory of the pool
+struct hostMemoryRegion {
+    void* ptr;
+    size_t len;
+    int numa_node;
+    int in_use;
+    // The number of runtimes the region is pinned with
+    int num_pinned;
+};
+
+// A device runtime pinning the memory of the pool
+struct hostMemoryRuntime {
+    char* name;
+    int ref_count;
+    host_pool_pin_fn pin;
+    host_pool_unpin_fn unpin;
+    void* ctx;
+};
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct hostMemoryRegion* regions = NULL;
+static size_t num_regions = 0;
+
+static struct hostMemoryRuntime* runtimes = NULL;
+static size_t num_runtimes = 0;
+
+static void* private_host_alloc(size_t len, int numa_node) {
+    void* ptr = NULL;
+#ifdef WITH_HSA
+    ptr = hsa_host_malloc(len, numa_node);
+#else
+#ifdef WITH_NUMA
+    ptr = numa_alloc_onnode(len, numa_node);
+#else
+    (void)numa_node;
+    if (posix_memalign(&ptr, PAGESIZE_MEM, len) != 0)
+        ptr = NULL;
+#endif
+    if (ptr == NULL)
+        return NULL;
+
+#ifndef WITH_NO_MEMLOCK
+    // Ask that all pages be kept in memory
+    if (mlock(ptr, len) == -1) {
+        ERROR_F("Error locking memory: %d - check ulimit -a to check memlock limits", errno);
+#ifdef WITH_NUMA
+        numa_free(ptr, len);
+#else
+        free(ptr);
+#endif
+        return NULL;
+    }
+#endif
+#endif
+    return ptr;
+}
+
+static void private_host_free(void* ptr, size_t len) {
+#ifdef WITH_HSA
+    (void)len;
+    hsa_host_free(ptr);
+#else
+#ifdef WITH_NUMA
+    numa_free(ptr, len);
+#else
+    (void)len;
+    free(ptr);
+#endif
+#endif
+}
+
+// Pins a region with the runtimes from first_runtime on, returns -1 if one failed.
+// A region is pinned with the first num_pinned runtimes, so it stops at the first failure.
+static int private_pin_region(struct hostMemoryRegion* region, size_t first_runtime) {
+    for (size_t r = first_runtime; r < num_runtimes; r++) {
+        if ((size_t)region->num_pinned != r)
+            return -1;
+        if (runtimes[r].pin(region->ptr, region->len, runtimes[r].ctx) != 0) {
+            WARN_F("Couldn't pin %zu bytes of host memory with %s", region->len, runtimes[r].name);
+            return -1;
+        }
+        region->num_pinned++;
+    }
+    return 0;
+}
+
+static void private_unpin_region(struct hostMemoryRegion* region, size_t runtime) {
+    runtimes[runtime].unpin(region->ptr, region->len, runtimes[runtime].ctx);
+    region->num_pinned--;
+}
+
+void* host_pool_malloc(size_t len, int numa_node) {
+    CHECK_ERROR_F(pthread_mutex_lock(&pool_lock));
+
+    // Reuse a free region, it's already pinned
+    for (size_t i = 0; i < num_regions; i++) {
+        if (!regions[i].in_use && regions[i].len == len && regions[i].numa_node == numa_node) {
+            regions[i].in_use = 1;
+            CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+            return regions[i].ptr;
+        }
+    }
+
+    void* ptr = private_host_alloc(len, numa_node);
+    if (ptr == NULL) {
+        CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+        return NULL;
+    }
+
+    regions = realloc(regions, (num_regions + 1) * sizeof(struct hostMemoryRegion));
+    CHECK_MEM_F(regions);
+    struct hostMemoryRegion* region = &regions[num_regions++];
+    region->ptr = ptr;
+    region->len = len;
+    region->numa_node = numa_node;
+    region->in_use = 1;
+    region->num_pinned = 0;
+    // The memory can still be copied if it couldn't be pinned, only more slowly
+    (void)private_pin_region(region, 0);
+    DEBUG_F("Allocated %zu bytes of host memory on NUMA node %d", len, numa_node);
+
+    CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+    return ptr;
+}
+
+void host_pool_free(void* ptr) {
+    if (ptr == NULL)
+        return;
+
+    CHECK_ERROR_F(pthread_mutex_lock(&pool_lock));
+    size_t i = 0;
+    for (; i < num_regions; i++)
+        if (regions[i].ptr == ptr)
+            break;
+    int in_pool = (i < num_regions && regions[i].in_use);
+    if (in_pool)
+        regions[i].in_use = 0;
+    CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+
+    // The pool can't tell how foreign memory was allocated, so it can't free it either
+    if (!in_pool) {
+        FATAL_ERROR_F("Freeing host memory %p which isn't in use in the pool. A frame swapped "
+                      "into a buffer must come from buffer_malloc, or be swapped back before "
+                      "the buffer is deleted.",
+                      ptr);
+    }
+}
+
+void host_pool_trim() {
+    CHECK_ERROR_F(pthread_mutex_lock(&pool_lock));
+    size_t kept = 0;
+    for (size_t i = 0; i < num_regions; i++) {
+        if (regions[i].in_use) {
+            regions[kept++] = regions[i];
+            continue;
+        }
+        while (regions[i].num_pinned > 0)
+            private_unpin_region(&regions[i], regions[i].num_pinned - 1);
+        private_host_free(regions[i].ptr, regions[i].len);
+    }
+    num_regions = kept;
+    CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+}
+
+int host_pool_register_runtime(const char* name, host_pool_pin_fn pin, host_pool_unpin_fn unpin,
+                               void* ctx) {
+    CHECK_ERROR_F(pthread_mutex_lock(&pool_lock));
+    for (size_t r = 0; r < num_runtimes; r++) {
+        if (strcmp(runtimes[r].name, name) == 0) {
+            runtimes[r].ref_count++;
+            CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+            return 0;
+        }
+    }
+
+    runtimes = realloc(runtimes, (num_runtimes + 1) * sizeof(struct hostMemoryRuntime));
+    CHECK_MEM_F(runtimes);
+    struct hostMemoryRuntime* runtime = &runtimes[num_runtimes++];
+    runtime->name = strdup(name);
+    CHECK_MEM_F(runtime->name);
+    runtime->ref_count = 1;
+    runtime->pin = pin;
+    runtime->unpin = unpin;
+    runtime->ctx = ctx;
+
+    // Pin the memory already in the pool
+    int ret = 0;
+    for (size_t i = 0; i < num_regions; i++)
+        if (private_pin_region(&regions[i], num_runtimes - 1) != 0)
+            ret = -1;
+    DEBUG_F("Registered the host memory pool with %s", name);
+
+    CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+    return ret;
+}
+
+void host_pool_unregister_runtime(const char* name) {
+    CHECK_ERROR_F(pthread_mutex_lock(&pool_lock));
+    size_t r = 0;
+    for (; r < num_runtimes; r++)
+        if (strcmp(runtimes[r].name, name) == 0)
+            break;
+    if (r == num_runtimes) {
+        ERROR_F("Runtime %s isn't registered with the host memory pool", name);
+    } else if (--runtimes[r].ref_count == 0) {
+        // The regions pinned with it are pinned with all the runtimes up to it
+        for (size_t i = 0; i < num_regions; i++)
+            if ((size_t)regions[i].num_pinned > r)
+                private_unpin_region(&regions[i], r);
+        free(runtimes[r].name);
+        for (size_t s = r + 1; s < num_runtimes; s++)
+            runtimes[s - 1] = runtimes[s];
+        num_runtimes--;
+    }
+    CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+}
+
+int host_pool_is_pinned(const void* ptr, size_t len) {
+    const uint8_t* p = (const uint8_t*)ptr;
+    int pinned = 0;
+    CHECK_ERROR_F(pthread_mutex_lock(&pool_lock));
+    for (size_t i = 0; i < num_regions; i++) {
+        const uint8_t* start = (const uint8_t*)regions[i].ptr;
+        if (p >= start && p + len <= start + regions[i].len) {
+            pinned = ((size_t)regions[i].num_pinned == num_runtimes);
+            break;
+        }
+    }
+    CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+    return pinned;
+}
+
+void host_pool_get_stats(size_t* num_regions_, size_t* num_free, size_t* total_len) {
+    CHECK_ERROR_F(pthread_mutex_lock(&pool_lock));
+    *num_regions_ = num_regions;
+    *num_free = 0;
+    *total_len = 0;
+    for (size_t i = 0; i < num_regions; i++) {
+        *num_free += !regions[i].in_use;
+        *total_len += regions[i].len;
+    }
+    CHECK_ERROR_F(pthread_mutex_unlock(&pool_lock));
+}
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @brief A pool of host memory which is pinned with the device runtimes, for the frames of
+ * the kotekan buffers and the other memory copied to and from the GPUs.
+ * - host_pool_malloc
+ * - host_pool_free
+ * - host_pool_trim
+ * - host_pool_register_runtime
+ * - host_pool_unregister_runtime
+ * - host_pool_is_pinned
+ * - host_pool_get_stats
+ */
+
+#ifndef HOST_MEMORY_POOL_H
+#define HOST_MEMORY_POOL_H
+
+#include <stddef.h> // for size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pins a region of host memory with a device runtime, e.g. with @c cudaHostRegister.
+ * @return 0 on success.
+ */
+typedef int (*host_pool_pin_fn)(void* ptr, size_t len, void* ctx);
+
+/// @brief Unpins a region of host memory which was pinned with a device runtime.
+typedef void (*host_pool_unpin_fn)(void* ptr, size_t len, void* ctx);
+
+/**
+ * @brief Allocates page aligned and locked host memory from the pool.
+ *
+ * A free region of exactly the same size and NUMA node is reused if there is one, as it is
+ * already pinned, otherwise a new region is allocated and pinned with all the registered
+ * runtimes. The regions are found with a linear scan, the pool is meant for the few hundred
+ * long lived buffer frames rather than for frequent small allocations.
+ * The memory is allocated with HSA when built with HSA, as the HSA runtime must own the
+ * memory it copies with DMA, and on the NUMA node when built with NUMA.
+ *
+ * @param len The size of the memory in bytes.
+ * @param numa_node The CPU NUMA node to allocate the memory on.
+ * @return A pointer to the memory, or @c NULL if the allocation failed.
+ */
+void* host_pool_malloc(size_t len, int numa_node);
+
+/**
+ * @brief Returns memory to the pool.
+ *
+ * The memory stays allocated and pinned for the next allocation of the same size, until
+ * @c host_pool_trim is called. Freeing memory which isn't in use in the pool, i.e. not
+ * allocated with @c host_pool_malloc or freed twice, is a fatal error.
+ *
+ * @param ptr Memory allocated with @c host_pool_malloc.
+ */
+void host_pool_free(void* ptr);
+
+/// @brief Unpins and frees the memory which has been returned to the pool.
+void host_pool_trim();
+
+/**
+ * @brief Registers a device runtime, whose functions pin and unpin all the memory of the pool.
+ *
+ * The memory already in the pool is pinned now, and the memory allocated later when it is
+ * allocated. A runtime is registered once, registering it again with the same @p name, e.g.
+ * for each GPU, only counts the references.
+ *
+ * @param name The name of the runtime.
+ * @param pin The function pinning a region of memory.
+ * @param unpin The function unpinning a region of memory.
+ * @param ctx Passed to @p pin and @p unpin.
+ * @return 0 on success, -1 if some memory couldn't be pinned.
+ */
+int host_pool_register_runtime(const char* name, host_pool_pin_fn pin, host_pool_unpin_fn unpin,
+                               void* ctx);
+
+/**
+ * @brief Removes a reference to a runtime, which unpins all the memory once there are none.
+ *
+ * @param name The name of the runtime.
+ */
+void host_pool_unregister_runtime(const char* name);
+
+/**
+ * @brief Checks whether memory is in the pool and pinned with all the runtimes.
+ *
+ * @param ptr A pointer into a region of the pool.
+ * @param len The length of the memory from @p ptr.
+ * @return 1 if @p len bytes from @p ptr are in a region pinned with all the runtimes, else 0.
+ */
+int host_pool_is_pinned(const void* ptr, size_t len);
+
+/**
+ * @brief Gets the usage of the pool.
+ *
+ * @param num_regions Set to the number of regions of memory, in use or free.
+ * @param num_free Set to the number of free regions.
+ * @param total_len Set to the total size of the regions in bytes.
+ */
+void host_pool_get_stats(size_t* num_regions, size_t* num_free, size_t* total_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_MEMORY_POOL_H
@@ -8,6 +8,7 @@
 #include "bufferFactory.hpp"     // for bufferFactory
 #include "configUpdater.hpp"     // for configUpdater
 #include "datasetManager.hpp"    // for datasetManager
+#include "hostMemoryPool.h"      // for host_pool_trim
 #include "kotekanLogging.hpp"    // for INFO_NON_OO
 #include "metadata.h"            // for delete_metadata_pool
 #include "metadataFactory.hpp"   // for metadataFactory
@@ -62,6 +63,8 @@ kotekanMode::~kotekanMode() {
             free(buf.second);
         }
     }
+    // Release the frames, which the pool keeps for reuse
+    host_pool_trim();
 
     for (auto const& metadata_pool : metadata_pools) {
         if (metadata_pool.second != nullptr) {
@@ -100,12 +103,12 @@ void kotekanMode::initalize_stages() {
     // Update REST server
     restServer::instance().set_server_affinity(config);
 
-    // Register pipeline status callbacks
+    // Register pipeline status callbacks, these walk through every buffer
     restServer::instance().register_get_callback(
-        "/buffers", std::bind(&kotekanMode::buffer_data_callback, this, _1));
+        "/buffers", std::bind(&kotekanMode::buffer_data_callback, this, _1), true);
 
     restServer::instance().register_get_callback(
-        "/pipeline_dot", std::bind(&kotekanMode::pipeline_dot_graph_callback, this, _1));
+        "/pipeline_dot", std::bind(&kotekanMode::pipeline_dot_graph_callback, this, _1), true);
 }
 
 void kotekanMode::join() {
@@ -3,12 +3,12 @@
 #include "kotekanLogging.hpp" // for ERROR_NON_OO
 #include "restServer.hpp"     // for restServer, connectionInstance
 
-#include "fmt.hpp" // for print, format, fmt
+#include "fmt.hpp" // for format, format_to, fmt
 
+#include <algorithm>  // for lower_bound, min, nth_element
 #include <cmath>      // for isinf, isnan
 #include <functional> // for _Bind_helper<>::type, _Placeholder, bind, _1, placeholders
-#include <iterator>   // for begin, end
-#include <ostream>    // for operator<<, basic_ostream
+#include <iterator>   // for begin, end, back_inserter
 #include <sys/time.h> // for gettimeofday, timeval
 #include <utility>    // for pair
 
@@ -22,113 +22,231 @@ Metric::Metric(const std::vector<string>& label_values) : label_values(label_val
 
 Counter::Counter(const std::vector<string>& label_values) : Metric(label_values) {}
 
-void Counter::inc() {
-    std::lock_guard<std::mutex> lock(metric_lock);
+uint64_t Counter::value() {
+    uint64_t total = 0;
+    for (auto& s : shards)
+        total += s.value.load(std::memory_order_relaxed);
+    return total;
+}
 
-    ++value;
+string Counter::to_string() {
+    return std::to_string(value());
+}
+
+void Counter::serialize(string& out, const string& name, const string& labels) {
+    uint64_t total = value();
+    if (cached_line.empty() || total != cached_value) {
+        cached_line = fmt::format(fmt("{:s}{{{:s}}} {:d}\n"), name, labels, total);
+        cached_value = total;
+    }
+    out += cached_line;
 }
 
-void Counter::inc(const uint64_t increment) {
-    std::lock_guard<std::mutex> lock(metric_lock);
 
-    value += increment;
+Gauge::Gauge(const std::vector<string>& label_values) :
+    Metric(label_values),
+    last_update_time_stamp(get_time_in_milliseconds()) {}
+
+void Gauge::set(const double value) {
+    this->value.store(value, std::memory_order_relaxed);
+    last_update_time_stamp.store(get_time_in_milliseconds(), std::memory_order_relaxed);
 }
 
-string Counter::to_string() {
-    return std::to_string(value);
+string Gauge::to_string() {
+    double v = value.load(std::memory_order_relaxed);
+    uint64_t time_stamp = last_update_time_stamp.load(std::memory_order_relaxed);
+    if (std::isnan(v)) {
+        return fmt::format(fmt("NaN {:d}"), time_stamp);
+    } else if (std::isinf(v)) {
+        return fmt::format(fmt("{} {:d}"), (v < 0 ? "-Inf" : "+Inf"), time_stamp);
+    }
+    return fmt::format(fmt("{:f} {:d}"), v, time_stamp);
 }
 
-std::ostringstream& Counter::to_string(std::ostringstream& out) {
-    std::lock_guard<std::mutex> lock(metric_lock);
+void Gauge::serialize(string& out, const string& name, const string& labels) {
+    double v = value.load(std::memory_order_relaxed);
+    uint64_t time_stamp = last_update_time_stamp.load(std::memory_order_relaxed);
+    // (NaN never compares equal, so is always formatted again)
+    if (cached_line.empty() || v != cached_value || time_stamp != cached_time_stamp) {
+        cached_line = fmt::format(fmt("{:s}{{{:s}}} {:s}\n"), name, labels, to_string());
+        cached_value = v;
+        cached_time_stamp = time_stamp;
+    }
+    out += cached_line;
+}
 
-    out << value;
-    return out;
+/* static */
+uint64_t Gauge::get_time_in_milliseconds() {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    return (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
 }
 
 
-Gauge::Gauge(const std::vector<string>& label_values) : Metric(label_values) {}
+Histogram::Histogram(const std::vector<string>& label_values, const std::vector<double>& buckets) :
+    Metric(label_values),
+    buckets(buckets),
+    cached_counts(buckets.size() + 1, 0) {
+    for (auto& s : shards)
+        s.bucket_counts.reset(new std::atomic<uint64_t>[buckets.size() + 1]());
+    for (double bucket : buckets)
+        bucket_labels.push_back(fmt::format(fmt("{}"), bucket));
+    bucket_labels.push_back("+Inf");
+}
 
-void Gauge::set(const double value) {
-    std::lock_guard<std::mutex> lock(metric_lock);
+void Histogram::observe(const double value) {
+    // The first bucket with an upper bound >= value, or +Inf
+    size_t i = std::lower_bound(buckets.begin(), buckets.end(), value) - buckets.begin();
 
-    this->value = value;
-    this->last_update_time_stamp = get_time_in_milliseconds();
+    shard& s = shards[thread_shard()];
+    s.bucket_counts[i].fetch_add(1, std::memory_order_relaxed);
+    // Only the few threads sharing the shard can contend here
+    double sum = s.sum.load(std::memory_order_relaxed);
+    while (!s.sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
 }
 
-string Gauge::to_string() {
-    std::ostringstream buf;
-    to_string(buf);
-    return buf.str();
+string Histogram::to_string() {
+    uint64_t count = 0;
+    for (auto& s : shards)
+        for (size_t i = 0; i <= buckets.size(); i++)
+            count += s.bucket_counts[i].load(std::memory_order_relaxed);
+    return std::to_string(count);
+}
+
+void Histogram::serialize(string& out, const string& name, const string& labels) {
+    // The shards are read one after the other, so with concurrent observations the sum may
+    // not match the counts exactly. The count is the total of the buckets, as it must be.
+    std::vector<uint64_t> counts(buckets.size() + 1, 0);
+    double sum = 0;
+    for (auto& s : shards) {
+        for (size_t i = 0; i < counts.size(); i++)
+            counts[i] += s.bucket_counts[i].load(std::memory_order_relaxed);
+        sum += s.sum.load(std::memory_order_relaxed);
+    }
+
+    if (cached_lines.empty() || counts != cached_counts || sum != cached_sum) {
+        cached_lines.clear();
+        auto it = std::back_inserter(cached_lines);
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            cumulative += counts[i];
+            fmt::format_to(it, fmt("{:s}_bucket{{{:s},le=\"{:s}\"}} {:d}\n"), name, labels,
+                           bucket_labels[i], cumulative);
+        }
+        fmt::format_to(it, fmt("{:s}_sum{{{:s}}} {:f}\n"), name, labels, sum);
+        fmt::format_to(it, fmt("{:s}_count{{{:s}}} {:d}\n"), name, labels, cumulative);
+        cached_counts = counts;
+        cached_sum = sum;
+    }
+    out += cached_lines;
 }
 
-std::ostringstream& Gauge::to_string(std::ostringstream& out) {
-    std::lock_guard<std::mutex> lock(metric_lock);
 
-    if (std::isnan(value)) {
-        fmt::print(out, fmt("NaN {:d}"), last_update_time_stamp);
-    } else if (std::isinf(value)) {
-        fmt::print(out, fmt("{} {:d}"), (value < 0 ? "-Inf" : "+Inf"), last_update_time_stamp);
+Summary::Summary(const std::vector<string>& label_values, const std::vector<double>& quantiles,
+                 size_t window) :
+    Metric(label_values),
+    quantiles(quantiles) {
+    recent.reserve(window);
+}
+
+void Summary::observe(const double value) {
+    std::lock_guard<std::mutex> lock(summary_lock);
+
+    if (recent.size() < recent.capacity()) {
+        recent.push_back(value);
     } else {
-        fmt::print(out, fmt("{:f} {:d}"), value, last_update_time_stamp);
+        recent[next] = value;
     }
+    next = (next + 1) % recent.capacity();
+    sum += value;
+    count++;
+}
 
-    return out;
+string Summary::to_string() {
+    std::lock_guard<std::mutex> lock(summary_lock);
+
+    return std::to_string(count);
 }
 
-/* static */
-uint64_t Gauge::get_time_in_milliseconds() {
-    struct timeval tv;
-    gettimeofday(&tv, nullptr);
+void Summary::serialize(string& out, const string& name, const string& labels) {
+    std::vector<double> values;
+    double total;
+    uint64_t n;
+    {
+        std::lock_guard<std::mutex> lock(summary_lock);
+        values = recent;
+        total = sum;
+        n = count;
+    }
 
-    return (uint64_t)(tv.tv_sec) * 1000 + (uint64_t)(tv.tv_usec) / 1000;
+    auto it = std::back_inserter(out);
+    for (double q : quantiles) {
+        if (values.empty()) {
+            fmt::format_to(it, fmt("{:s}{{{:s},quantile=\"{}\"}} NaN\n"), name, labels, q);
+            continue;
+        }
+        // The nearest rank
+        auto nth = values.begin() + std::min<size_t>(q * values.size(), values.size() - 1);
+        std::nth_element(values.begin(), nth, values.end());
+        fmt::format_to(it, fmt("{:s}{{{:s},quantile=\"{}\"}} {:f}\n"), name, labels, q, *nth);
+    }
+    fmt::format_to(it, fmt("{:s}_sum{{{:s}}} {:f}\n"), name, labels, total);
+    fmt::format_to(it, fmt("{:s}_count{{{:s}}} {:d}\n"), name, labels, n);
 }
 
 
 template<typename T>
 MetricFamily<T>::MetricFamily(const string& name, const string& stage_name,
                               const std::vector<string>& label_names,
-                              const MetricFamily<T>::MetricType metric_type) :
+                              const MetricFamily<T>::MetricType metric_type,
+                              const std::vector<double>& bounds) :
     name(name),
     stage_name(stage_name),
     label_names(label_names),
+    bounds(bounds),
     metric_type(metric_type) {}
 
 template<typename T>
-string MetricFamily<T>::serialize() {
-    std::lock_guard<std::mutex> lock(metrics_lock);
+string MetricFamily<T>::format_labels(const std::vector<string>& label_values) {
+    string labels = fmt::format(fmt("stage_name=\"{:s}\""), stage_name);
+    auto value = label_values.begin();
+    for (auto& label : label_names) {
+        labels += fmt::format(fmt(",{:s}=\"{:s}\""), label, *value++);
+    }
+    return labels;
+}
+
+template<typename T>
+void MetricFamily<T>::serialize(string& out) {
+    std::lock_guard<std::mutex> serialize_guard(serialize_lock);
+    std::shared_lock<std::shared_timed_mutex> lock(metrics_lock);
 
     if (metrics.empty())
-        return "";
+        return;
 
-    std::ostringstream out;
-    out << "# HELP " << name << "\n";
+    out += "# HELP " + name + "\n";
     switch (metric_type) {
         case MetricFamily<T>::MetricType::Counter:
-            out << "# TYPE " << name << " counter\n";
+            out += "# TYPE " + name + " counter\n";
             break;
         case MetricFamily<T>::MetricType::Gauge:
-            out << "# TYPE " << name << " gauge\n";
+            out += "# TYPE " + name + " gauge\n";
+            break;
+        case MetricFamily<T>::MetricType::Histogram:
+            out += "# TYPE " + name + " histogram\n";
+            break;
+        case MetricFamily<T>::MetricType::Summary:
+            out += "# TYPE " + name + " summary\n";
             break;
         default:
-            out << "# TYPE " << name << " untyped\n";
+            out += "# TYPE " + name + " untyped\n";
     }
+    auto labels = label_strings.begin();
     for (auto& m : metrics) {
-        out << name;
-        out << "{"
-            << "stage_name=\"" << stage_name << "\"";
-        if (!label_names.empty()) {
-            auto value = m.label_values.begin();
-            for (auto label : label_names) {
-                out << ",";
-                out << label << "=\"" << *value++ << "\"";
-            }
-        }
-        out << "}"
-            << " ";
-        m.to_string(out);
-        out << "\n";
+        m.serialize(out, name, *labels++);
     }
-    return out.str();
 }
 
 
@@ -140,21 +258,31 @@ Metrics& Metrics::instance() {
 }
 
 
-Metrics::~Metrics() {
-    restServer::instance().remove_get_callback("/metrics");
-}
+// The REST server makes sure the metrics are created before it and so outlive it, so the
+// /metrics endpoint can't be removed here.
+Metrics::~Metrics() {}
 
 string Metrics::serialize() {
-    std::ostringstream out;
-
-    std::lock_guard<std::mutex> lock(metrics_lock);
+    // Serialize without holding the lock, so stages can add and remove metrics meanwhile
+    std::vector<std::shared_ptr<Serializable>> to_serialize;
+    size_t size;
+    {
+        std::lock_guard<std::mutex> lock(metrics_lock);
+        for (auto& f : families) {
+            to_serialize.push_back(f.second);
+        }
+        size = last_size;
+    }
 
-    for (auto& f : families) {
-        // out << f.first << ": " << f.second.label_names.size() << "\n";
-        out << f.second->serialize();
+    string out;
+    out.reserve(size + size / 8);
+    for (auto& f : to_serialize) {
+        f->serialize(out);
     }
 
-    return out.str();
+    std::lock_guard<std::mutex> lock(metrics_lock);
+    last_size = out.size();
+    return out;
 }
 
 void Metrics::add(const string name, const string stage_name,
@@ -211,6 +339,43 @@ MetricFamily<Counter>& Metrics::add_counter(const std::string& name, const std::
     return *f;
 }
 
+Histogram& Metrics::add_histogram(const std::string& name, const std::string& stage_name,
+                                  const std::vector<double>& buckets) {
+    const std::vector<string> empty_labels;
+    auto f = std::make_shared<MetricFamily<Histogram>>(
+        name, stage_name, empty_labels, MetricFamily<Histogram>::MetricType::Histogram, buckets);
+    add(name, stage_name, f);
+    return f->labels({});
+}
+
+MetricFamily<Histogram>& Metrics::add_histogram(const std::string& name,
+                                                const std::string& stage_name,
+                                                const std::vector<std::string>& label_names,
+                                                const std::vector<double>& buckets) {
+    auto f = std::make_shared<MetricFamily<Histogram>>(
+        name, stage_name, label_names, MetricFamily<Histogram>::MetricType::Histogram, buckets);
+    add(name, stage_name, f);
+    return *f;
+}
+
+Summary& Metrics::add_summary(const std::string& name, const std::string& stage_name,
+                              const std::vector<double>& quantiles) {
+    const std::vector<string> empty_labels;
+    auto f = std::make_shared<MetricFamily<Summary>>(
+        name, stage_name, empty_labels, MetricFamily<Summary>::MetricType::Summary, quantiles);
+    add(name, stage_name, f);
+    return f->labels({});
+}
+
+MetricFamily<Summary>& Metrics::add_summary(const std::string& name, const std::string& stage_name,
+                                            const std::vector<std::string>& label_names,
+                                            const std::vector<double>& quantiles) {
+    auto f = std::make_shared<MetricFamily<Summary>>(
+        name, stage_name, label_names, MetricFamily<Summary>::MetricType::Summary, quantiles);
+    add(name, stage_name, f);
+    return *f;
+}
+
 
 void Metrics::remove_stage_metrics(const string& stage_name) {
     std::lock_guard<std::mutex> lock(metrics_lock);
@@ -235,7 +400,9 @@ void Metrics::metrics_callback(connectionInstance& conn) {
 
 void Metrics::register_with_server(restServer* rest_server) {
     using namespace std::placeholders;
-    rest_server->register_get_callback("/metrics", std::bind(&Metrics::metrics_callback, this, _1));
+    // Serializing all the metrics takes a while with many stages
+    rest_server->register_get_callback("/metrics", std::bind(&Metrics::metrics_callback, this, _1),
+                                       true);
 }
 
 } // namespace prometheus
@@ -3,24 +3,37 @@
 
 #include "restServer.hpp"
 
-#include <deque>     // for deque
-#include <iosfwd>    // for ostringstream
-#include <map>       // for map
-#include <memory>    // for shared_ptr
-#include <mutex>     // for mutex, lock_guard
-#include <stdexcept> // for runtime_error
-#include <stdint.h>  // for uint64_t
-#include <string>    // for string
-#include <tuple>     // for tuple
-#include <vector>    // for vector
+#include <atomic>       // for atomic, memory_order_relaxed
+#include <deque>        // for deque
+#include <map>          // for map
+#include <memory>       // for shared_ptr, unique_ptr
+#include <mutex>        // for mutex, lock_guard
+#include <shared_mutex> // for shared_timed_mutex, shared_lock
+#include <stddef.h>     // for size_t
+#include <stdexcept>    // for runtime_error
+#include <stdint.h>     // for uint64_t
+#include <string>       // for string
+#include <tuple>        // for tuple
+#include <type_traits>  // for is_same
+#include <vector>       // for vector
 
 
 namespace kotekan {
 namespace prometheus {
 
+/// The number of shards of the sharded metrics (@c Counter, @c Histogram)
+constexpr size_t num_metric_shards = 8;
+
 /**
  * @class Metric
  * @brief An internal base class for storing metric value for a given combination of label values
+ *
+ * Updating a metric is lock-free. Metrics which are updated per packet or per frame (counters
+ * and histograms) are split into cache-line sized shards, each updated by a subset of the
+ * threads, so that threads updating the same metric don't contend for the same cache line.
+ *
+ * Serializing a metric is done by its family, which makes sure only one thread at a time does
+ * so, and so metrics can cache their last serialized output.
  */
 class Metric {
 public:
@@ -29,13 +42,26 @@ public:
 
     /// @brief Returns the stored value as a string.
     virtual std::string to_string() = 0;
-    /// @brief Formats the stored value as a string into the given output stream.
-    virtual std::ostringstream& to_string(std::ostringstream& out) = 0;
+
+    /**
+     * @brief Appends the metric in text exposition format.
+     *
+     * @param out    The string to append to.
+     * @param name   The metric name.
+     * @param labels The formatted labels of the metric, without braces.
+     */
+    virtual void serialize(std::string& out, const std::string& name,
+                           const std::string& labels) = 0;
+
     const std::vector<std::string> label_values;
 
 protected:
-    /// Metric updating lock
-    std::mutex metric_lock;
+    /// The shard updated by the calling thread
+    static size_t thread_shard() {
+        static std::atomic<size_t> next_shard(0);
+        thread_local size_t shard = next_shard++ % num_metric_shards;
+        return shard;
+    }
 };
 
 /**
@@ -49,14 +75,29 @@ protected:
 class Counter : public Metric {
 public:
     Counter(const std::vector<std::string>&);
-    void inc();
-    void inc(const uint64_t increment);
+    void inc() {
+        inc(1);
+    }
+    void inc(const uint64_t increment) {
+        shards[thread_shard()].value.fetch_add(increment, std::memory_order_relaxed);
+    }
+    /// @brief Returns the current value
+    uint64_t value();
     std::string to_string() override;
-    std::ostringstream& to_string(std::ostringstream& out) override;
+    void serialize(std::string& out, const std::string& name, const std::string& labels) override;
 
 private:
-    /// The actual value to be returned
-    uint64_t value = 0;
+    /// A part of the value, on its own cache line
+    struct alignas(64) shard {
+        std::atomic<uint64_t> value{0};
+    };
+
+    /// The actual value to be returned is the sum of the shards
+    shard shards[num_metric_shards];
+
+    /// The value last serialized, and the line it was serialized to
+    uint64_t cached_value = 0;
+    std::string cached_line;
 };
 
 /**
@@ -72,17 +113,119 @@ public:
     Gauge(const std::vector<std::string>&);
     void set(const double);
     std::string to_string() override;
-    std::ostringstream& to_string(std::ostringstream& out) override;
+    void serialize(std::string& out, const std::string& name, const std::string& labels) override;
 
 private:
     /// Internal function to get the time in
     static uint64_t get_time_in_milliseconds();
 
     /// The actual value to be returned
-    double value = 0;
+    std::atomic<double> value{0};
 
     /// Time stamp in milliseconds.
-    uint64_t last_update_time_stamp;
+    std::atomic<uint64_t> last_update_time_stamp;
+
+    /// The value and time stamp last serialized, and the line they were serialized to
+    double cached_value = 0;
+    uint64_t cached_time_stamp = 0;
+    std::string cached_line;
+};
+
+/**
+ * @class Histogram
+ * @brief Represents a metric which counts observations (e.g. request durations) in buckets
+ *
+ * Exported as the cumulative @c _bucket counts, and the @c _sum and @c _count of all
+ * observations.
+ *
+ * @remark See [Prometheus
+ * documentation](https://prometheus.io/docs/instrumenting/exposition_formats/) for the precise
+ * format specification.
+ */
+class Histogram : public Metric {
+public:
+    /**
+     * @brief Creates a histogram
+     *
+     * @param label_values The label values of this histogram.
+     * @param buckets      The upper bounds of the buckets, in increasing order. A @c +Inf
+     *                     bucket is always added.
+     */
+    Histogram(const std::vector<std::string>& label_values, const std::vector<double>& buckets);
+    void observe(const double value);
+    /// @brief Returns the number of observations.
+    std::string to_string() override;
+    void serialize(std::string& out, const std::string& name, const std::string& labels) override;
+
+    /// The upper bounds of the buckets, excluding +Inf
+    const std::vector<double> buckets;
+
+private:
+    /// The observations made by a subset of the threads, on their own cache lines
+    struct alignas(64) shard {
+        /// The number of observations in each bucket (not cumulative), the last is +Inf
+        std::unique_ptr<std::atomic<uint64_t>[]> bucket_counts;
+        /// The sum of all observations
+        std::atomic<double> sum{0};
+    };
+    shard shards[num_metric_shards];
+
+    /// The @c le label values of the buckets
+    std::vector<std::string> bucket_labels;
+
+    /// The bucket counts and sum last serialized, and the lines they were serialized to
+    std::vector<uint64_t> cached_counts;
+    double cached_sum = 0;
+    std::string cached_lines;
+};
+
+/**
+ * @class Summary
+ * @brief Represents a metric which tracks quantiles of recent observations (e.g. latencies)
+ *
+ * Exported as the quantiles of the last @c window observations, and the @c _sum and @c _count
+ * of all observations. Unlike a @c Histogram the quantiles can't be aggregated over several
+ * instances, and observing takes a lock, so histograms are preferable for anything updated
+ * often.
+ *
+ * @remark See [Prometheus
+ * documentation](https://prometheus.io/docs/instrumenting/exposition_formats/) for the precise
+ * format specification.
+ */
+class Summary : public Metric {
+public:
+    /**
+     * @brief Creates a summary
+     *
+     * @param label_values The label values of this summary.
+     * @param quantiles    The quantiles to export, between 0 and 1.
+     * @param window       The number of recent observations the quantiles are computed from.
+     */
+    Summary(const std::vector<std::string>& label_values, const std::vector<double>& quantiles,
+            size_t window = 1024);
+    void observe(const double value);
+    /// @brief Returns the number of observations.
+    std::string to_string() override;
+    void serialize(std::string& out, const std::string& name, const std::string& labels) override;
+
+    /// The quantiles to export
+    const std::vector<double> quantiles;
+
+private:
+    /// Lock for the observations
+    std::mutex summary_lock;
+
+    /// The last observations, a ring buffer
+    std::vector<double> recent;
+
+    /// Where the next observation goes in @c recent
+    size_t next = 0;
+
+    /// The sum of all observations
+    double sum = 0;
+
+    /// The number of observations
+    uint64_t count = 0;
 };
 
 /**
@@ -99,7 +242,18 @@ struct Serializable {
      * documentation](https://prometheus.io/docs/instrumenting/exposition_formats/) for the precise
      * format specification.
      */
-    virtual std::string serialize() = 0;
+    std::string serialize() {
+        std::string out;
+        serialize(out);
+        return out;
+    }
+
+    /**
+     * @brief Appends the metrics in Prometheus text format to a string.
+     *
+     * @param out The string to append to.
+     */
+    virtual void serialize(std::string& out) = 0;
 };
 
 /**
@@ -113,18 +267,32 @@ public:
     enum class MetricType {
         Counter,
         Gauge,
+        Histogram,
+        Summary,
         Untyped,
     };
 
+    /**
+     * @brief Creates a family
+     *
+     * @param name        The metric name.
+     * @param stage       The stage name.
+     * @param label_names The label names.
+     * @param metric_type The type, for the @c TYPE line.
+     * @param bounds      The bucket upper bounds of histograms, or the quantiles of summaries.
+     */
     MetricFamily(const std::string& name, const std::string& stage,
                  const std::vector<std::string>& label_names,
-                 const MetricType metric_type = MetricType::Untyped);
+                 const MetricType metric_type = MetricType::Untyped,
+                 const std::vector<double>& bounds = {});
 
     /**
      * @brief Returns the ``Metric`` instance for the given combination of label values
      *
      * If the combination of values is seen for the first time, a new Metric
-     * instance will be created and added to the family.
+     * instance will be created and added to the family. Looking up an existing
+     * combination only takes a shared lock, but callers updating a metric often
+     * should keep the reference rather than look it up every time.
      *
      * @param label_values
      * @return reference to the Metric
@@ -136,19 +304,31 @@ public:
             throw std::runtime_error("Label values don't match the names");
         }
 
-        std::lock_guard<std::mutex> lock(metrics_lock);
-
-        for (auto& m : metrics) {
-            if (m.label_values == label_values) {
-                return m;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(metrics_lock);
+            auto m = index.find(label_values);
+            if (m != index.end()) {
+                return *m->second;
             }
         }
-        metrics.emplace_back(label_values);
+
+        std::unique_lock<std::shared_timed_mutex> lock(metrics_lock);
+        auto m = index.find(label_values);
+        if (m != index.end()) {
+            return *m->second;
+        }
+        if constexpr (std::is_same<T, Histogram>::value || std::is_same<T, Summary>::value) {
+            metrics.emplace_back(label_values, bounds);
+        } else {
+            metrics.emplace_back(label_values);
+        }
+        label_strings.push_back(format_labels(label_values));
+        index[label_values] = &metrics.back();
         return metrics.back();
     }
 
-
-    std::string serialize() override;
+    using Serializable::serialize;
+    void serialize(std::string& out) override;
 
     /// metric name
     const std::string name;
@@ -159,15 +339,30 @@ public:
     /// label names
     const std::vector<std::string> label_names;
 
+    /// bucket upper bounds for histograms, quantiles for summaries
+    const std::vector<double> bounds;
+
 private:
+    /// Formats the labels of a metric, without braces
+    std::string format_labels(const std::vector<std::string>& label_values);
+
     /// metric instances for label combinations observed so far
     std::deque<T> metrics;
 
+    /// the formatted labels of the metrics
+    std::deque<std::string> label_strings;
+
+    /// the metrics by label values
+    std::map<std::vector<std::string>, T*> index;
+
     /// metric type
     const MetricType metric_type;
 
     /// Metric list updating lock
-    std::mutex metrics_lock;
+    std::shared_timed_mutex metrics_lock;
+
+    /// Lock making sure only one thread at a time serializes (and so uses the metric caches)
+    std::mutex serialize_lock;
 };
 
 /**
@@ -277,6 +472,58 @@ public:
     MetricFamily<Counter>& add_counter(const std::string& name, const std::string& stage_name,
                                        const std::vector<std::string>& label_names);
 
+    /**
+     * @brief Adds a new metric of type histogram and no labels
+     *
+     * @param name The name of the metric.
+     * @param stage_name The unique stage name, normally @c unique_name.
+     * @param buckets The upper bounds of the buckets, in increasing order.
+     * @return a reference to the newly created @c Histogram instance
+     * @throw std::runtime_error if the metric with that name is already registered.
+     */
+    Histogram& add_histogram(const std::string& name, const std::string& stage_name,
+                             const std::vector<double>& buckets);
+
+    /**
+     * @brief Adds a new metric family of type histogram
+     *
+     * @param name The name of the metric.
+     * @param stage_name The unique stage name, normally @c unique_name.
+     * @param label_names The names of the labels used
+     * @param buckets The upper bounds of the buckets, in increasing order.
+     * @return a reference to the newly created @c MetricFamily<Histogram> instance
+     * @throw std::runtime_error if the metric with that name is already registered.
+     */
+    MetricFamily<Histogram>& add_histogram(const std::string& name, const std::string& stage_name,
+                                           const std::vector<std::string>& label_names,
+                                           const std::vector<double>& buckets);
+
+    /**
+     * @brief Adds a new metric of type summary and no labels
+     *
+     * @param name The name of the metric.
+     * @param stage_name The unique stage name, normally @c unique_name.
+     * @param quantiles The quantiles to export, between 0 and 1.
+     * @return a reference to the newly created @c Summary instance
+     * @throw std::runtime_error if the metric with that name is already registered.
+     */
+    Summary& add_summary(const std::string& name, const std::string& stage_name,
+                         const std::vector<double>& quantiles);
+
+    /**
+     * @brief Adds a new metric family of type summary
+     *
+     * @param name The name of the metric.
+     * @param stage_name The unique stage name, normally @c unique_name.
+     * @param label_names The names of the labels used
+     * @param quantiles The quantiles to export, between 0 and 1.
+     * @return a reference to the newly created @c MetricFamily<Summary> instance
+     * @throw std::runtime_error if the metric with that name is already registered.
+     */
+    MetricFamily<Summary>& add_summary(const std::string& name, const std::string& stage_name,
+                                       const std::vector<std::string>& label_names,
+                                       const std::vector<double>& quantiles);
+
     /**
      * @brief Remove all registered stage metrics
      *
@@ -326,6 +573,9 @@ private:
 
     /// Metric updating lock
     std::mutex metrics_lock;
+
+    /// The size of the last exposition, to reserve space for the next one
+    size_t last_size = 0;
 };
 
 } // namespace prometheus
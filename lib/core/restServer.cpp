@@ -1,21 +1,28 @@
 #include "restServer.hpp"
 
-#include "Config.hpp"         // for Config
-#include "kotekanLogging.hpp" // for ERROR_NON_OO, WARN_NON_OO, INFO_NON_OO, DEBUG_NON_OO
+#include "Config.hpp"            // for Config
+#include "SynchronizedQueue.hpp" // for SynchronizedQueue
+#include "kotekanLogging.hpp"    // for ERROR_NON_OO, WARN_NON_OO, INFO_NON_OO, DEBUG_NON_OO
+#include "prometheusMetrics.hpp" // for Metrics, MetricFamily, Histogram
 
 #include "fmt.hpp" // for format, fmt
 
 #include <algorithm>               // for max
 #include <assert.h>                // for assert
+#include <chrono>                  // for steady_clock, duration
 #include <cstdint>                 // for int32_t
 #include <event2/buffer.h>         // for evbuffer_add, evbuffer_peek, iovec, evbuffer_free
+#include <event2/bufferevent.h>    // for bufferevent_get_output
 #include <event2/event.h>          // for event_add, event_base_dispatch, event_base_free, even...
 #include <event2/http.h>           // for evhttp_send_reply, evhttp_add_header, evhttp_request_...
 #include <event2/keyvalq_struct.h> // for evkeyvalq, evkeyval, evkeyval::(anonymous)
 #include <event2/thread.h>         // for evthread_use_pthreads
 #include <evhttp.h>                // for evhttp_request
 #include <exception>               // for exception
-#include <mutex>                   // for unique_lock
+#include <memory>                  // for make_unique, unique_ptr, shared_ptr
+#include <mutex>                   // for unique_lock, shared_lock
+#include <optional>                // for optional
+#include <netdb.h>                 // for addrinfo, freeaddrinfo, gai_strerror, getaddrinfo
 #include <netinet/in.h>            // for sockaddr_in, ntohs
 #include <pthread.h>               // for pthread_setaffinity_np, pthread_setname_np
 #include <sched.h>                 // for cpu_set_t, CPU_SET, CPU_ZERO
@@ -24,7 +31,8 @@
 #include <string>                  // for string, basic_string, allocator, operator!=, operator+
 #include <sys/socket.h>            // for getsockname, socklen_t
 #include <sys/time.h>              // for timeval
-#include <utility>                 // for pair
+#include <unistd.h>                // for close
+#include <utility>                 // for pair, move
 #include <vector>                  // for vector
 #ifdef MAC_OSX
 #include "osxBindCPU.hpp"
@@ -42,30 +50,81 @@ restServer& restServer::instance() {
     return server_instance;
 }
 
-restServer::restServer() : port(_port), main_thread() {
+restServer::restServer() :
+    port(_port),
+    work_queue(std::make_unique<SynchronizedQueue<std::function<void()>>>()) {
     stop_thread = false;
+
+    // The request latency histograms live in the metrics, which must outlive the server threads
+    prometheus::Metrics::instance();
 }
 
 restServer::~restServer() {
+    // Stop the workers first, they hand replies to the event loops
+    work_queue->cancel();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
     stop_thread = true;
-    try {
-        main_thread.join();
-    } catch (std::exception& e) {
-        WARN_NON_OO("restServer: Failure when joining server thread: {:s}", e.what());
+    if (loops.empty()) {
         WARN_NON_OO("restServer: Was the server used but never started?");
     }
+    for (auto& loop : loops) {
+        try {
+            loop->thread.join();
+        } catch (std::exception& e) {
+            WARN_NON_OO("restServer: Failure when joining server thread: {:s}", e.what());
+        }
+    }
 }
 
-void restServer::start(const std::string& bind_address, u_short port) {
+void restServer::start(const std::string& bind_address, u_short port, uint32_t num_loops,
+                       uint32_t num_workers) {
 
     this->bind_address = bind_address;
     this->_port = port;
 
-    main_thread = std::thread(&restServer::http_server_thread, this);
+    // The event bases are used from the worker threads to hand back replies
+    if (evthread_use_pthreads()) {
+        ERROR_NON_OO("restServer: Cannot use pthreads with libevent!");
+        exit(1);
+    }
+
+    request_latency = &prometheus::Metrics::instance().add_histogram(
+        "kotekan_rest_server_request_duration_seconds", "rest_server", {"endpoint", "method"},
+        {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10});
+
+    // Bind all the sockets before starting any threads, so the port is known (if it was
+    // chosen by the OS) and all loops share it.
+    for (uint32_t i = 0; i < std::max(num_loops, 1u); i++) {
+        loops.push_back(std::make_unique<serverLoop>());
+        loops.back()->server = this;
+        create_loop(*loops.back());
+    }
+    // This INFO line is parsed by the python runner to get the RESTserver port. Don't edit.
+    INFO_NON_OO("restServer: started server on address:port {:s}:{:d}", bind_address, _port);
+    if (loops.size() > 1 || num_workers != 2) {
+        INFO_NON_OO("restServer: using {:d} event loops and {:d} workers", loops.size(),
+                    num_workers);
+    }
 
+    for (size_t i = 0; i < loops.size(); i++) {
+        loops[i]->thread = std::thread(&restServer::http_server_thread, this, std::ref(*loops[i]));
 #ifndef MAC_OSX
-    pthread_setname_np(main_thread.native_handle(), "rest_server");
+        pthread_setname_np(loops[i]->thread.native_handle(),
+                           (i == 0 ? "rest_server" : fmt::format(fmt("rest_server_{:d}"), i))
+                               .c_str());
 #endif
+    }
+
+    for (uint32_t i = 0; i < num_workers; i++) {
+        workers.emplace_back(&restServer::worker_thread, this);
+#ifndef MAC_OSX
+        pthread_setname_np(workers.back().native_handle(),
+                           fmt::format(fmt("rest_worker_{:d}"), i).c_str());
+#endif
+    }
 
     // Framework level tracking of endpoints.
     using namespace std::placeholders;
@@ -74,61 +133,131 @@ void restServer::start(const std::string& bind_address, u_short port) {
 
 void restServer::handle_request(struct evhttp_request* request, void* cb_data) {
 
-    restServer* server = (restServer*)(cb_data);
+    serverLoop* loop = (serverLoop*)(cb_data);
+    restServer* server = loop->server;
 
     string url = string(evhttp_uri_get_path(evhttp_request_get_evhttp_uri(request)));
 
     DEBUG2_NON_OO("restServer: Got request with url {:s}", url);
 
+    // Copy the callback, so it can be run without holding the lock. Callbacks (start, stop,
+    // etc) may add or remove other callbacks.
+    std::shared_ptr<getCallback> get_endpoint;
+    std::shared_ptr<postCallback> post_endpoint;
     {
-        // TODO This function should be locked against changes to the callback
-        // maps form other threads.  However there are a number of callbacks (start, stop, etc)
-        // which add or remove callbacks from the maps. So a more fine-grained
-        // locking system is needed here.
-        // std::shared_lock<std::shared_timed_mutex> lock(server->callback_map_lock);
-        map<string, string>& aliases = server->get_aliases();
-        if (aliases.find(url) != aliases.end()) {
-            url = aliases[url];
+        std::shared_lock<std::shared_timed_mutex> lock(server->callback_map_lock);
+        auto alias = server->aliases.find(url);
+        if (alias != server->aliases.end()) {
+            url = alias->second;
         }
 
-        if (request->type == EVHTTP_REQ_GET) {
-            connectionInstance conn(request);
-            if (!server->get_callbacks.count(url)) {
-                DEBUG_NON_OO("restServer: GET Endpoint {:s} called, but not found", url);
-                conn.send_error("Not Found", HTTP_RESPONSE::NOT_FOUND);
-                return;
-            }
-            server->get_callbacks[url](conn);
-            return;
+        if (request->type == EVHTTP_REQ_GET && server->get_callbacks.count(url)) {
+            get_endpoint = server->get_callbacks[url];
+        } else if (request->type == EVHTTP_REQ_POST && server->json_callbacks.count(url)) {
+            post_endpoint = server->json_callbacks[url];
         }
+    }
 
-        if (request->type == EVHTTP_REQ_POST) {
-            connectionInstance conn(request);
-            if (!server->json_callbacks.count(url)) {
-                DEBUG_NON_OO("restServer: POST Endpoint {:s} called, but not found", url);
-                conn.send_error("Not Found", HTTP_RESPONSE::NOT_FOUND);
-                return;
-            }
+    if (request->type != EVHTTP_REQ_GET && request->type != EVHTTP_REQ_POST) {
+        DEBUG_NON_OO("restServer: Call back with method != POST|GET called!");
 
-            // We currently assume that POST requests come with a JSON message
-            json json_request;
-            if (server->handle_json(request, json_request) != 0) {
-                return;
-            }
+        connectionInstance conn(request);
+        conn.send_error("Bad Request", HTTP_RESPONSE::BAD_REQUEST);
+        return;
+    }
+
+    const string method = request->type == EVHTTP_REQ_GET ? "GET" : "POST";
+    if (!get_endpoint && !post_endpoint) {
+        DEBUG_NON_OO("restServer: {:s} Endpoint {:s} called, but not found", method, url);
+        connectionInstance conn(request);
+        conn.send_error("Not Found", HTTP_RESPONSE::NOT_FOUND);
+        return;
+    }
+
+    // We currently assume that POST requests come with a JSON message
+    json json_request;
+    if (post_endpoint && server->handle_json(request, json_request) != 0) {
+        return;
+    }
+
+    auto conn = std::make_unique<connectionInstance>(request);
+    conn->latency = &server->request_latency->labels({url, method});
+
+    bool blocking = get_endpoint ? get_endpoint->blocking : post_endpoint->blocking;
+    if (!blocking || server->workers.empty()) {
+        if (get_endpoint) {
+            invoke(*get_endpoint, *conn);
+        } else {
+            invoke(*post_endpoint, *conn, json_request);
+        }
+        return;
+    }
 
-            server->json_callbacks[url](conn, json_request);
+    // Run the callback on a worker, which hands the reply back to this loop
+    conn->defer(loop->base);
+    auto work = [conn = std::shared_ptr<connectionInstance>(std::move(conn)), get_endpoint,
+                 post_endpoint, json_request, url]() mutable {
+        try {
+            if (get_endpoint) {
+                invoke(*get_endpoint, *conn);
+            } else {
+                invoke(*post_endpoint, *conn, json_request);
+            }
+        } catch (std::exception& e) {
+            ERROR_NON_OO("restServer: Callback for {:s} failed: {:s}", url, e.what());
+            if (!conn->replied) {
+                conn->send_error(e.what(), HTTP_RESPONSE::INTERNAL_ERROR);
+            }
             return;
         }
+        // Unlike on the event loop, the request would be left waiting forever
+        if (!conn->replied) {
+            WARN_NON_OO("restServer: Callback for {:s} didn't reply", url);
+            conn->send_empty_reply(HTTP_RESPONSE::INTERNAL_ERROR);
+        }
+    };
+    server->work_queue->put(std::function<void()>(work));
+}
+
+thread_local const void* restServer::current_endpoint = nullptr;
+
+template<typename T, typename... A>
+void restServer::invoke(endpointCallback<T>& endpoint, connectionInstance& conn, A&... args) {
+    std::shared_lock<std::shared_timed_mutex> lock(endpoint.running);
+    if (endpoint.removed) {
+        conn.send_error("Not Found", HTTP_RESPONSE::NOT_FOUND);
+        return;
     }
 
-    DEBUG_NON_OO("restServer: Call back with method != POST|GET called!");
+    // Restore the outer callback (if any) also when this one throws
+    struct restore {
+        const void* outer;
+        ~restore() {
+            current_endpoint = outer;
+        }
+    } guard{current_endpoint};
+    current_endpoint = &endpoint;
+
+    endpoint.callback(conn, args...);
+}
+
+template<typename T>
+void restServer::retire(endpointCallback<T>& endpoint) {
+    endpoint.removed = true;
+    if (current_endpoint != &endpoint) {
+        std::unique_lock<std::shared_timed_mutex> wait(endpoint.running);
+    }
+}
 
-    connectionInstance conn(request);
-    conn.send_error("Bad Request", HTTP_RESPONSE::BAD_REQUEST);
+void restServer::worker_thread() {
+    while (auto work = work_queue->get()) {
+        (*work)();
+    }
 }
 
 void restServer::register_get_callback(string endpoint,
-                                       std::function<void(connectionInstance&)> callback) {
+                                       std::function<void(connectionInstance&)> callback,
+                                       bool blocking) {
     if (endpoint.substr(0, 1) != "/") {
         endpoint = fmt::format(fmt("/{:s}"), endpoint);
     }
@@ -138,14 +267,16 @@ void restServer::register_get_callback(string endpoint,
         if (get_callbacks.count(endpoint)) {
             WARN_NON_OO("restServer: Call back {:s} already exists, overriding old call back!!",
                         endpoint);
+            get_callbacks[endpoint]->removed = true;
         }
-        get_callbacks[endpoint] = callback;
+        get_callbacks[endpoint] = std::make_shared<getCallback>(callback, blocking);
     }
     INFO_NON_OO("restServer: Adding GET endpoint: {:s}", endpoint);
 }
 
 void restServer::register_post_callback(string endpoint,
-                                        std::function<void(connectionInstance&, json&)> callback) {
+                                        std::function<void(connectionInstance&, json&)> callback,
+                                        bool blocking) {
     if (endpoint.substr(0, 1) != "/") {
         endpoint = fmt::format(fmt("/{:s}"), endpoint);
     }
@@ -155,8 +286,9 @@ void restServer::register_post_callback(string endpoint,
         if (json_callbacks.count(endpoint)) {
             WARN_NON_OO("restServer: Callback {:s} already exists, overriding old callback!!",
                         endpoint);
+            json_callbacks[endpoint]->removed = true;
         }
-        json_callbacks[endpoint] = callback;
+        json_callbacks[endpoint] = std::make_shared<postCallback>(callback, blocking);
     }
     INFO_NON_OO("restServer: Adding POST endpoint: {:s}", endpoint);
 }
@@ -166,10 +298,17 @@ void restServer::remove_get_callback(string endpoint) {
         endpoint = fmt::format(fmt("/{:s}"), endpoint);
     }
 
-    std::unique_lock<std::shared_timed_mutex> lock(callback_map_lock);
-    auto it = get_callbacks.find(endpoint);
-    if (it != get_callbacks.end()) {
-        get_callbacks.erase(it);
+    std::shared_ptr<getCallback> removed;
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(callback_map_lock);
+        auto it = get_callbacks.find(endpoint);
+        if (it != get_callbacks.end()) {
+            removed = it->second;
+            get_callbacks.erase(it);
+        }
+    }
+    if (removed) {
+        retire(*removed);
     }
 }
 
@@ -178,10 +317,17 @@ void restServer::remove_json_callback(string endpoint) {
         endpoint = fmt::format(fmt("/{:s}"), endpoint);
     }
 
-    std::unique_lock<std::shared_timed_mutex> lock(callback_map_lock);
-    auto it = json_callbacks.find(endpoint);
-    if (it != json_callbacks.end()) {
-        json_callbacks.erase(it);
+    std::shared_ptr<postCallback> removed;
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(callback_map_lock);
+        auto it = json_callbacks.find(endpoint);
+        if (it != json_callbacks.end()) {
+            removed = it->second;
+            json_callbacks.erase(it);
+        }
+    }
+    if (removed) {
+        retire(*removed);
     }
 }
 
@@ -312,6 +458,8 @@ int restServer::handle_json(struct evhttp_request* request, json& json_parse) {
 void restServer::endpoint_list_callback(connectionInstance& conn) {
     json reply;
 
+    std::shared_lock<std::shared_timed_mutex> lock(callback_map_lock);
+
     vector<string> get_callback_names;
     for (auto& endpoint : get_callbacks) {
         get_callback_names.push_back(endpoint.first);
@@ -330,6 +478,7 @@ void restServer::endpoint_list_callback(connectionInstance& conn) {
     reply["GET"] = get_callback_names;
     reply["POST"] = post_json_callback_names;
     reply["aliases"] = aliases_names;
+    lock.unlock();
 
     conn.send_json_reply(reply);
 }
@@ -340,23 +489,17 @@ void restServer::timer(evutil_socket_t fd, short event, void* arg) {
     (void)fd;
     (void)event;
 
-    restServer* rest_server = (restServer*)arg;
-    if (rest_server->stop_thread) {
-        event_base_loopbreak(rest_server->event_base);
+    serverLoop* loop = (serverLoop*)arg;
+    if (loop->server->stop_thread) {
+        event_base_loopbreak(loop->base);
     }
 }
 
-void restServer::http_server_thread() {
-
-    // Allow for using extra threads (not currently needed)
-    if (evthread_use_pthreads()) {
-        ERROR_NON_OO("restServer: Cannot use pthreads with libevent!");
-        return;
-    }
+void restServer::create_loop(serverLoop& loop) {
 
     // Create the base event for handling requests
-    event_base = event_base_new();
-    if (event_base == nullptr) {
+    loop.base = event_base_new();
+    if (loop.base == nullptr) {
         ERROR_NON_OO("restServer: Failed to create libevent base");
         // Use exit() not raise() since this happens early in startup before
         // the signal handlers are all in place.
@@ -364,21 +507,42 @@ void restServer::http_server_thread() {
     }
 
     // Create the server
-    ev_server = evhttp_new(event_base);
-    if (ev_server == nullptr) {
+    loop.ev_server = evhttp_new(loop.base);
+    if (loop.ev_server == nullptr) {
         ERROR_NON_OO("restServer: Failed to create libevent base");
         exit(1);
     }
 
     // Currently allow only GET and POST requests
-    evhttp_set_allowed_methods(ev_server, EVHTTP_REQ_GET | EVHTTP_REQ_POST);
+    evhttp_set_allowed_methods(loop.ev_server, EVHTTP_REQ_GET | EVHTTP_REQ_POST);
 
     // Just setup one handler and implement the URL parsing internally
-    evhttp_set_gencb(ev_server, handle_request, (void*)this);
+    evhttp_set_gencb(loop.ev_server, handle_request, (void*)&loop);
+
+    // Bind to the IP and port. Every loop gets its own socket on the same port, and the kernel
+    // balances the connections between them.
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_ADDRCONFIG;
+    struct addrinfo* addr = nullptr;
+    int err = getaddrinfo(bind_address.c_str(), std::to_string(_port).c_str(), &hints, &addr);
+    if (err != 0) {
+        ERROR_NON_OO("restServer: Failed to resolve {:s}: {:s}", bind_address, gai_strerror(err));
+        exit(1);
+    }
+    evutil_socket_t sock = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+    if (sock < 0 || evutil_make_socket_nonblocking(sock) != 0
+        || evutil_make_socket_closeonexec(sock) != 0
+        || evutil_make_listen_socket_reuseable(sock) != 0
+        || evutil_make_listen_socket_reuseable_port(sock) != 0
+        || bind(sock, addr->ai_addr, addr->ai_addrlen) != 0 || listen(sock, 128) != 0) {
+        ERROR_NON_OO("restServer: Failed to bind to {:s}:{:d}", bind_address, _port);
+        exit(1);
+    }
+    freeaddrinfo(addr);
 
-    // Bind to the IP and port
-    struct evhttp_bound_socket* ev_sock =
-        evhttp_bind_socket_with_handle(ev_server, bind_address.c_str(), _port);
+    struct evhttp_bound_socket* ev_sock = evhttp_accept_socket_with_handle(loop.ev_server, sock);
     if (ev_sock == nullptr) {
         ERROR_NON_OO("restServer: Failed to bind to {:s}:{:d}", bind_address, _port);
         exit(1);
@@ -386,7 +550,6 @@ void restServer::http_server_thread() {
 
     // if port was set to random, find port socket is listening on
     if (_port == 0) {
-        evutil_socket_t sock = evhttp_bound_socket_get_fd(ev_sock);
         struct sockaddr_in sin;
         socklen_t len = sizeof(sin);
         if (getsockname(sock, (struct sockaddr*)&sin, &len) == -1) {
@@ -395,22 +558,24 @@ void restServer::http_server_thread() {
         }
         _port = ntohs(sin.sin_port);
     }
-    // This INFO line is parsed by the python runner to get the RESTserver port. Don't edit.
-    INFO_NON_OO("restServer: started server on address:port {:s}:{:d}", bind_address, _port);
+}
+
+void restServer::http_server_thread(serverLoop& loop) {
 
     // Create a timer to check for the exit condition
     struct event* timer_event;
-    timer_event = event_new(event_base, -1, EV_PERSIST, &restServer::timer, this);
+    timer_event = event_new(loop.base, -1, EV_PERSIST, &restServer::timer, &loop);
     struct timeval interval;
     interval.tv_sec = 0;
     interval.tv_usec = 100000;
     event_add(timer_event, &interval);
 
     // run event loop
-    event_base_dispatch(event_base);
+    event_base_dispatch(loop.base);
 
-    evhttp_free(ev_server);
-    event_base_free(event_base);
+    event_free(timer_event);
+    evhttp_free(loop.ev_server);
+    event_base_free(loop.base);
 }
 
 void restServer::set_server_affinity(Config& config) {
@@ -420,7 +585,10 @@ void restServer::set_server_affinity(Config& config) {
     CPU_ZERO(&cpuset);
     for (auto core_id : cpu_affinity)
         CPU_SET(core_id, &cpuset);
-    pthread_setaffinity_np(main_thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+    for (auto& loop : loops)
+        pthread_setaffinity_np(loop->thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+    for (auto& worker : workers)
+        pthread_setaffinity_np(worker.native_handle(), sizeof(cpu_set_t), &cpuset);
 }
 
 string restServer::get_http_responce_code_text(const HTTP_RESPONSE& status) {
@@ -442,7 +610,18 @@ string restServer::get_http_responce_code_text(const HTTP_RESPONSE& status) {
 
 // *** Connection Instance functions ***
 
-connectionInstance::connectionInstance(struct evhttp_request* request) : request(request) {
+struct connectionInstance::deferredReply {
+    struct evhttp_request* request;
+    HTTP_RESPONSE status;
+    const char* content_type;
+    struct evbuffer* buffer;
+    prometheus::Histogram* latency;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+connectionInstance::connectionInstance(struct evhttp_request* request) :
+    request(request),
+    start_time(std::chrono::steady_clock::now()) {
     event_buffer = evbuffer_new();
     if (event_buffer == nullptr) {
         throw std::runtime_error("Failed to create evbuffer");
@@ -450,83 +629,133 @@ connectionInstance::connectionInstance(struct evhttp_request* request) : request
 }
 
 connectionInstance::~connectionInstance() {
-    evbuffer_free(event_buffer);
+    // The buffer belongs to the event loop once a deferred reply is sent
+    if (event_buffer != nullptr)
+        evbuffer_free(event_buffer);
+}
+
+void connectionInstance::defer(struct event_base* base) {
+    reply_base = base;
+    uri = string(evhttp_request_get_uri(request));
+    body = restServer::get_http_message(request);
+    const char* query = evhttp_uri_get_query(evhttp_request_get_evhttp_uri(request));
+    query_string = query ? query : "";
 }
 
 string connectionInstance::get_uri() {
+    if (reply_base != nullptr)
+        return uri;
     return string(evhttp_request_get_uri(request));
 }
 
 string connectionInstance::get_body() {
+    if (reply_base != nullptr)
+        return body;
     return restServer::get_http_message(request);
 }
 
-void connectionInstance::send_empty_reply(const HTTP_RESPONSE& status) {
+int connectionInstance::send(struct evhttp_request* request, const HTTP_RESPONSE& status,
+                             const char* content_type, struct evbuffer* buffer,
+                             prometheus::Histogram* latency,
+                             const std::chrono::steady_clock::time_point& start_time) {
+    if (content_type != nullptr
+        && evhttp_add_header(evhttp_request_get_output_headers(request), "Content-Type",
+                             content_type)
+               != 0) {
+        return -1;
+    }
+
     evhttp_send_reply(request, static_cast<int>(status),
-                      restServer::get_http_responce_code_text(status).c_str(), event_buffer);
+                      restServer::get_http_responce_code_text(status).c_str(), buffer);
+
+    if (latency != nullptr) {
+        latency->observe(
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+    }
+    return 0;
 }
 
-void connectionInstance::send_text_reply(const string& reply_message) {
+void connectionInstance::send_deferred(evutil_socket_t fd, short event, void* arg) {
 
-    if (evhttp_add_header(evhttp_request_get_output_headers(request), "Content-Type", "text/plain")
+    // Unused parameters, required by libevent. Suppress warning.
+    (void)fd;
+    (void)event;
+
+    deferredReply* reply = (deferredReply*)arg;
+    if (send(reply->request, reply->status, reply->content_type, reply->buffer, reply->latency,
+             reply->start_time)
         != 0) {
-        throw std::runtime_error("Failed to add header to reply");
+        ERROR_NON_OO("restServer: Failed to add header to reply");
+        evhttp_send_error(reply->request, static_cast<int>(HTTP_RESPONSE::INTERNAL_ERROR),
+                          nullptr);
+    }
+    evbuffer_free(reply->buffer);
+    delete reply;
+}
+
+void connectionInstance::send_reply(const HTTP_RESPONSE& status, const char* content_type) {
+    replied = true;
+
+    if (reply_base == nullptr) {
+        if (send(request, status, content_type, event_buffer, latency, start_time) != 0) {
+            throw std::runtime_error("Failed to add header to reply");
+        }
+        return;
     }
 
+    // libevent requests may only be used from their own event loop
+    deferredReply* reply =
+        new deferredReply{request, status, content_type, event_buffer, latency, start_time};
+    if (event_base_once(reply_base, -1, EV_TIMEOUT, &connectionInstance::send_deferred, reply,
+                        nullptr)
+        != 0) {
+        delete reply;
+        throw std::runtime_error("Failed to hand the reply to the event loop");
+    }
+    event_buffer = nullptr;
+}
+
+void connectionInstance::send_empty_reply(const HTTP_RESPONSE& status) {
+    send_reply(status, nullptr);
+}
+
+void connectionInstance::send_text_reply(const string& reply_message) {
+
     if (evbuffer_add(event_buffer, (void*)reply_message.c_str(), reply_message.size()) != 0) {
         throw std::runtime_error("Failed to add reply message");
     }
 
-    evhttp_send_reply(request, static_cast<int>(HTTP_RESPONSE::OK), "OK", event_buffer);
+    send_reply(HTTP_RESPONSE::OK, "text/plain");
 }
 
 void connectionInstance::send_binary_reply(uint8_t* data, int len) {
     assert(data != nullptr);
     assert(len > 0);
 
-    if (evhttp_add_header(evhttp_request_get_output_headers(request), "Content-Type",
-                          "Application/octet-stream")
-        != 0) {
-        throw std::runtime_error("Failed to add header to reply");
-    }
-
     if (evbuffer_add(event_buffer, (void*)data, len) != 0) {
         throw std::runtime_error("Failed to add data to reply message");
     }
 
-    evhttp_send_reply(request, static_cast<int>(HTTP_RESPONSE::OK), "OK", event_buffer);
+    send_reply(HTTP_RESPONSE::OK, "Application/octet-stream");
 }
 
 void connectionInstance::send_error(const string& message, const HTTP_RESPONSE& status) {
-    if (evhttp_add_header(evhttp_request_get_output_headers(request), "Content-Type",
-                          "Application/JSON")
-        != 0) {
-        throw std::runtime_error("Failed to add header to reply");
-    }
-
     string reply = json{{"message", message}, {"code", status}}.dump();
     if (evbuffer_add(event_buffer, (void*)reply.c_str(), reply.size()) != 0) {
         throw std::runtime_error("Failed to add reply message");
     }
 
-    evhttp_send_reply(request, static_cast<int>(status),
-                      restServer::get_http_responce_code_text(status).c_str(), event_buffer);
+    send_reply(status, "Application/JSON");
 }
 
 void connectionInstance::send_json_reply(const json& json_reply) {
     string json_string = json_reply.dump(0);
 
-    if (evhttp_add_header(evhttp_request_get_output_headers(request), "Content-Type",
-                          "Application/JSON")
-        != 0) {
-        throw std::runtime_error("Failed to add header to reply");
-    }
-
     if (evbuffer_add(event_buffer, (void*)json_string.c_str(), json_string.size()) != 0) {
         throw std::runtime_error("Failed to add JSON string to reply message");
     }
 
-    evhttp_send_reply(request, static_cast<int>(HTTP_RESPONSE::OK), "OK", event_buffer);
+    send_reply(HTTP_RESPONSE::OK, "Application/JSON");
 }
 
 std::map<std::string, std::string> connectionInstance::get_query() {
@@ -534,7 +763,9 @@ std::map<std::string, std::string> connectionInstance::get_query() {
     struct evkeyvalq queries;
     queries.tqh_first = nullptr;
     queries.tqh_last = nullptr;
-    const char* query_string = evhttp_uri_get_query(evhttp_request_get_evhttp_uri(request));
+    const char* query_string =
+        reply_base != nullptr ? this->query_string.c_str()
+                              : evhttp_uri_get_query(evhttp_request_get_evhttp_uri(request));
     if (query_string && evhttp_parse_query_str(query_string, &queries) == 0) {
         struct evkeyval* cur_query = queries.tqh_first;
         while (cur_query) {
@@ -546,4 +777,180 @@ std::map<std::string, std::string> connectionInstance::get_query() {
     return query_map;
 }
 
+// *** Streamed replies ***
+
+struct restStream::streamState {
+    /// The event loop of the request
+    struct event_base* base;
+    /// The request, only used on the event loop
+    struct evhttp_request* request;
+    /// The number of bytes which may be waiting to be sent
+    size_t max_backlog;
+
+    /// Bytes handed to the event loop, but not yet to the connection
+    std::atomic<size_t> queued{0};
+    /// Bytes in the output buffer of the connection, as of the last chunk sent
+    std::atomic<size_t> unsent{0};
+
+    /// Set once the client disconnected or the stream was closed
+    std::atomic<bool> closed{false};
+    /// Set once @c close was called
+    std::atomic<bool> ended{false};
+    std::atomic<uint64_t> dropped{0};
+
+    /// Keeps the state alive while libevent may call back with it (only used on the loop)
+    std::shared_ptr<streamState> self;
+
+    /// Details for starting the reply
+    string content_type;
+    prometheus::Histogram* latency;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+struct restStream::streamOp {
+    opType type;
+    std::shared_ptr<streamState> state;
+    struct evbuffer* buffer;
+};
+
+restStream::restStream(std::shared_ptr<streamState> state) : state(state) {}
+
+restStream::~restStream() {
+    close();
+}
+
+void restStream::post(const std::shared_ptr<streamState>& state, opType type,
+                      struct evbuffer* buffer) {
+    streamOp* op = new streamOp{type, state, buffer};
+    if (event_base_once(state->base, -1, EV_TIMEOUT, &restStream::run, op, nullptr) != 0) {
+        if (buffer != nullptr)
+            evbuffer_free(buffer);
+        delete op;
+        state->closed = true;
+        throw std::runtime_error("Failed to hand the stream to the event loop");
+    }
+}
+
+bool restStream::send_chunk(const uint8_t* data, size_t len) {
+    if (state->closed || state->ended) {
+        state->dropped++;
+        return false;
+    }
+    if (state->queued + state->unsent + len > state->max_backlog) {
+        state->dropped++;
+        return false;
+    }
+
+    struct evbuffer* buffer = evbuffer_new();
+    if (buffer == nullptr || evbuffer_add(buffer, data, len) != 0) {
+        if (buffer != nullptr)
+            evbuffer_free(buffer);
+        throw std::runtime_error("Failed to add data to stream chunk");
+    }
+    state->queued += len;
+    post(state, opType::chunk, buffer);
+    return true;
+}
+
+bool restStream::send_chunk(const string& chunk) {
+    return send_chunk((const uint8_t*)chunk.data(), chunk.size());
+}
+
+void restStream::close() {
+    if (state->ended.exchange(true))
+        return;
+    post(state, opType::end, nullptr);
+}
+
+bool restStream::is_closed() const {
+    return state->closed || state->ended;
+}
+
+uint64_t restStream::num_dropped() const {
+    return state->dropped;
+}
+
+void restStream::run(evutil_socket_t fd, short event, void* arg) {
+
+    // Unused parameters, required by libevent. Suppress warning.
+    (void)fd;
+    (void)event;
+
+    std::unique_ptr<streamOp> op((streamOp*)arg);
+    streamState* state = op->state.get();
+    // Gone once the client disconnected
+    struct evhttp_connection* conn = evhttp_request_get_connection(state->request);
+
+    switch (op->type) {
+        case opType::start:
+            if (conn == nullptr) {
+                state->closed = true;
+                break;
+            }
+            if (evhttp_add_header(evhttp_request_get_output_headers(state->request),
+                                  "Content-Type", state->content_type.c_str())
+                != 0) {
+                ERROR_NON_OO("restServer: Failed to add header to stream");
+            }
+            evhttp_send_reply_start(state->request, static_cast<int>(HTTP_RESPONSE::OK), "OK");
+            state->self = op->state;
+            evhttp_connection_set_closecb(conn, &restStream::connection_closed, state);
+            if (state->latency != nullptr) {
+                state->latency->observe(std::chrono::duration<double>(
+                                            std::chrono::steady_clock::now() - state->start_time)
+                                            .count());
+            }
+            break;
+        case opType::chunk:
+            state->queued -= evbuffer_get_length(op->buffer);
+            if (conn != nullptr && !state->closed) {
+                evhttp_send_reply_chunk_with_cb(state->request, op->buffer,
+                                                &restStream::chunk_sent, state);
+                struct bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+                state->unsent = evbuffer_get_length(bufferevent_get_output(bev));
+            }
+            evbuffer_free(op->buffer);
+            break;
+        case opType::end:
+            if (conn != nullptr)
+                evhttp_connection_set_closecb(conn, nullptr, nullptr);
+            // Also frees the request if the client disconnected
+            evhttp_send_reply_end(state->request);
+            state->closed = true;
+            state->self.reset();
+            break;
+    }
+}
+
+std::unique_ptr<restStream> connectionInstance::send_stream(const string& content_type,
+                                                           size_t max_backlog) {
+    replied = true;
+
+    auto state = std::make_shared<restStream::streamState>();
+    state->base = reply_base != nullptr
+                      ? reply_base
+                      : evhttp_connection_get_base(evhttp_request_get_connection(request));
+    state->request = request;
+    state->max_backlog = max_backlog;
+    state->content_type = content_type;
+    state->latency = latency;
+    state->start_time = start_time;
+
+    restStream::post(state, restStream::opType::start, nullptr);
+    return std::unique_ptr<restStream>(new restStream(state));
+}
+
+void restStream::chunk_sent(struct evhttp_connection* conn, void* arg) {
+    (void)conn;
+    ((streamState*)arg)->unsent = 0;
+}
+
+void restStream::connection_closed(struct evhttp_connection* conn, void* arg) {
+    (void)conn;
+    streamState* state = (streamState*)arg;
+    state->closed = true;
+    // The request stays around until the stream ends
+    state->self.reset();
+}
+
 } // namespace kotekan
@@ -6,18 +6,31 @@
 #include "json.hpp" // for json
 
 #include <atomic>        // for atomic
+#include <chrono>        // for steady_clock
 #include <event2/util.h> // for evutil_socket_t
 #include <evhttp.h>      // for evhttp  // IWYU pragma: keep
 #include <functional>    // for function
 #include <map>           // for map
+#include <memory>        // for unique_ptr, shared_ptr
 #include <shared_mutex>  // for shared_timed_mutex
-#include <stdint.h>      // for uint8_t
+#include <stddef.h>      // for size_t
+#include <stdint.h>      // for uint8_t, uint64_t
 #include <string>        // for string, allocator
 #include <sys/types.h>   // for u_short
 #include <thread>        // for thread
+#include <vector>        // for vector
+
+template<typename T>
+class SynchronizedQueue;
 
 namespace kotekan {
 
+namespace prometheus {
+class Histogram;
+template<typename T>
+class MetricFamily;
+} // namespace prometheus
+
 
 enum class HTTP_RESPONSE {
     OK = 200,
@@ -29,6 +42,78 @@ enum class HTTP_RESPONSE {
 
 #define PORT_REST_SERVER 12048
 
+/**
+ * @brief A reply sent to the client in chunks, as they become available.
+ *
+ * Returned by @c connectionInstance::send_stream. Uses HTTP chunked transfer encoding,
+ * and the reply ends when the stream is closed or destroyed.
+ *
+ * Chunks may be sent from any thread, and sending never waits for the client:
+ * the chunks are handed to the event loop of the request, and if more than
+ * @c max_backlog bytes are waiting to be sent (because the client doesn't keep
+ * up) further chunks are dropped.
+ */
+class restStream {
+public:
+    /// Ends the reply, if it hasn't ended yet
+    ~restStream();
+
+    restStream(const restStream&) = delete;
+    restStream& operator=(const restStream&) = delete;
+
+    /**
+     * @brief Queues a chunk of the reply.
+     *
+     * @param data Pointer to the data to send
+     * @param len The size of the data in bytes
+     *
+     * @return false if the chunk was dropped, because the client is too far behind or
+     *         has disconnected, or the stream was closed.
+     */
+    bool send_chunk(const uint8_t* data, size_t len);
+
+    /// Queues a chunk of the reply, see @c send_chunk.
+    bool send_chunk(const std::string& chunk);
+
+    /// Ends the reply.
+    void close();
+
+    /// Whether the client disconnected or the stream was closed.
+    bool is_closed() const;
+
+    /// The number of chunks dropped so far
+    uint64_t num_dropped() const;
+
+private:
+    /// The state shared with the event loop
+    struct streamState;
+
+    /// The steps of a reply
+    enum class opType { start, chunk, end };
+
+    /// A step of the reply, run on the event loop
+    struct streamOp;
+
+    restStream(std::shared_ptr<streamState> state);
+
+    /// Hands a step of the reply to the event loop
+    static void post(const std::shared_ptr<streamState>& state, opType type,
+                     struct evbuffer* buffer);
+
+    /// libevent callback running a @c streamOp
+    static void run(evutil_socket_t fd, short event, void* arg);
+
+    /// libevent callback for when all chunks were written to the socket
+    static void chunk_sent(struct evhttp_connection* conn, void* arg);
+
+    /// libevent callback for when the client disconnected
+    static void connection_closed(struct evhttp_connection* conn, void* arg);
+
+    std::shared_ptr<streamState> state;
+
+    friend class connectionInstance;
+};
+
 /**
  * @brief Contains details of a request (POST or GET), and provides
  *        functions for replying to the request.
@@ -38,6 +123,10 @@ enum class HTTP_RESPONSE {
  *
  * The @c send_ functions should called exactly once per connection instance.
  *
+ * For callbacks registered as @c blocking, which run on a worker thread, the
+ * request contents are copied before the callback is called, and the reply is
+ * handed back to the event loop of the request to be sent.
+ *
  * @author Andre Renard
  */
 class connectionInstance {
@@ -110,12 +199,78 @@ public:
      */
     std::map<std::string, std::string> get_query();
 
+    /**
+     * @brief Starts a reply which is streamed to the client in chunks.
+     *
+     * The stream may outlive the callback and the connection instance, and the
+     * callback may return before sending any chunks.
+     *
+     * @param content_type The content type header of the reply.
+     * @param max_backlog  The number of bytes which may be waiting to be sent
+     *                     before chunks are dropped.
+     *
+     * @return The stream to send chunks to.
+     */
+    std::unique_ptr<restStream> send_stream(const std::string& content_type,
+                                            size_t max_backlog = 16 * 1024 * 1024);
+
 private:
+    /// A reply waiting to be sent by the event loop of the request
+    struct deferredReply;
+
+    /**
+     * @brief Sets up the connection for a callback running on a worker thread.
+     *
+     * Must be called on the event loop of the request.
+     *
+     * @param base The event loop to send the reply from.
+     */
+    void defer(struct event_base* base);
+
+    /**
+     * @brief Sends @c event_buffer as the reply, or hands it to the event loop to send.
+     *
+     * @param status       The HTTP status code.
+     * @param content_type The content type header, or nullptr for none.
+     */
+    void send_reply(const HTTP_RESPONSE& status, const char* content_type);
+
+    /**
+     * @brief Sends a reply and records the request latency.
+     *
+     * @return 0 on success, -1 if the content type header couldn't be added.
+     */
+    static int send(struct evhttp_request* request, const HTTP_RESPONSE& status,
+                    const char* content_type, struct evbuffer* buffer,
+                    prometheus::Histogram* latency,
+                    const std::chrono::steady_clock::time_point& start_time);
+
+    /// libevent callback sending a @c deferredReply
+    static void send_deferred(evutil_socket_t fd, short event, void* arg);
+
     /// The request details
     struct evhttp_request* request;
 
     /// The buffer with the reply contents
     struct evbuffer* event_buffer;
+
+    /// The event loop to send the reply from, if the callback runs on a worker thread
+    struct event_base* reply_base = nullptr;
+
+    /// Copies of the request contents, for callbacks running on a worker thread
+    std::string uri, body, query_string;
+
+    /// Where to record the request latency, if anywhere
+    prometheus::Histogram* latency = nullptr;
+
+    /// When the request arrived
+    std::chrono::steady_clock::time_point start_time;
+
+    /// Whether one of the @c send_ functions was called
+    bool replied = false;
+
+    /// Allow the server to set up the connection
+    friend class restServer;
 };
 
 /**
@@ -125,6 +280,20 @@ private:
  *
  * This object uses libevent internally to handle the http requests.
  *
+ * The server can run several event loops, each with its own listening socket
+ * on the server port (using @c SO_REUSEPORT, so the kernel spreads connections
+ * over them), and so callbacks may be called concurrently from several threads.
+ * Callbacks registered as @c blocking are run on a pool of worker threads
+ * instead of an event loop, so they don't hold up other requests.
+ *
+ * The map of callbacks is only locked while looking up the callback for a
+ * request, so callbacks may register and remove endpoints. Removing an endpoint
+ * waits for running calls of its callback to finish.
+ *
+ * @metric kotekan_rest_server_request_duration_seconds
+ *         Histogram of the time from receiving a request to sending the reply,
+ *         labelled by endpoint and method.
+ *
  * See the docs for examples of using this class.
  *
  * @author Andre Renard
@@ -144,11 +313,14 @@ public:
      *
      * @param bind_address The address to bind too.  Default: 0.0.0.0
      * @param port The port to bind.  Default: PORT_REST_SERVER
+     * @param num_loops The number of event loops (threads) accepting requests.  Default: 1
+     * @param num_workers The number of worker threads running blocking callbacks.  Default: 2
      */
-    void start(const std::string& bind_address = "0.0.0.0", u_short port = PORT_REST_SERVER);
+    void start(const std::string& bind_address = "0.0.0.0", u_short port = PORT_REST_SERVER,
+               uint32_t num_loops = 1, uint32_t num_workers = 2);
 
     /**
-     * @brief Set the server thread CPU affinity
+     * @brief Set the server threads CPU affinity
      *
      * Pulls the CPU thread affinity from the config at "/rest_server"
      *
@@ -161,12 +333,15 @@ public:
      *
      * @param[in] endpoint Path section of the URL that is handled by the callback
      * @param[in] callback Callback function invoked to handle the request on the endpoint
+     * @param[in] blocking Set for callbacks which can take a long time, these are run
+     *                     on a worker thread so they don't hold up other requests.
      *
      * @note Re-registering on an endpoint will override the previous
      * callback value.
      */
     void register_get_callback(std::string endpoint,
-                               std::function<void(connectionInstance&)> callback);
+                               std::function<void(connectionInstance&)> callback,
+                               bool blocking = false);
 
     /**
      * Registers a POST callback for a specified HTTP endpoint.
@@ -176,12 +351,15 @@ public:
      *
      * @param[in] endpoint Path section of the URL that is handled by the callback
      * @param[in] callback Callback function invoked to handle the request on the endpoint
+     * @param[in] blocking Set for callbacks which can take a long time, these are run
+     *                     on a worker thread so they don't hold up other requests.
      *
      * @note Re-registering on an endpoint will override the previous
      * callback value.
      */
     void register_post_callback(std::string endpoint,
-                                std::function<void(connectionInstance&, nlohmann::json&)> callback);
+                                std::function<void(connectionInstance&, nlohmann::json&)> callback,
+                                bool blocking = false);
 
     /**
      * @brief Removes the GET endpoint referenced by @c endpoint
@@ -246,17 +424,82 @@ private:
     restServer(restServer const&);
     void operator=(restServer const&);
 
+    /// A registered callback
+    template<typename T>
+    struct endpointCallback {
+        endpointCallback(T callback, bool blocking) : callback(callback), blocking(blocking) {}
+        T callback;
+        bool blocking;
+        /// Held shared while the callback runs, so removing it can wait for running calls
+        std::shared_timed_mutex running;
+        /// Set once the endpoint is removed or replaced
+        std::atomic<bool> removed{false};
+    };
+
+    /// Callback types
+    using getCallback = endpointCallback<std::function<void(connectionInstance&)>>;
+    using postCallback =
+        endpointCallback<std::function<void(connectionInstance&, nlohmann::json&)>>;
+
     /**
-     * @brief Internal thread function which runs the server.
+     * @brief Runs a callback, unless it has been removed.
+     *
+     * @param endpoint The callback.
+     * @param conn     The connection to pass to the callback.
+     * @param args     Any further arguments of the callback.
      */
-    void http_server_thread();
+    template<typename T, typename... A>
+    static void invoke(endpointCallback<T>& endpoint, connectionInstance& conn, A&... args);
+
+    /**
+     * @brief Marks a callback which was taken out of the maps as removed, and waits for any
+     *        running calls of it to finish, so the objects it uses can be destroyed.
+     *
+     * Doesn't wait if called from the callback itself.
+     *
+     * @param endpoint The callback.
+     */
+    template<typename T>
+    static void retire(endpointCallback<T>& endpoint);
+
+    /// The callback running on this thread, if any
+    static thread_local const void* current_endpoint;
+
+    /// An event loop with its own listening socket
+    struct serverLoop {
+        restServer* server;
+        struct event_base* base = nullptr;
+        struct evhttp* ev_server = nullptr;
+        std::thread thread;
+    };
+
+    /**
+     * @brief Creates an event loop, listening on @c bind_address and @c _port.
+     *
+     * If @c _port is zero it is set to the port the socket was bound to.
+     *
+     * @param loop The loop to set up.
+     */
+    void create_loop(serverLoop& loop);
+
+    /**
+     * @brief Internal thread function which runs one of the event loops.
+     *
+     * @param loop The loop to run.
+     */
+    void http_server_thread(serverLoop& loop);
+
+    /**
+     * @brief Internal thread function which runs blocking callbacks.
+     */
+    void worker_thread();
 
     /**
      * @brief Internal timer call back to check for thread exit condition
      *
      * @param fd Not used
      * @param event Not used
-     * @param arg The bufferRecv object (just `this`, but this is a static function)
+     * @param arg The @c serverLoop the timer belongs to
      */
     static void timer(evutil_socket_t fd, short event, void* arg);
 
@@ -264,7 +507,7 @@ private:
      * @brief Internal callback function for the evhttp server.
      *
      * @param request   The request object
-     * @param cb_data   Expects a pointer to the REST server object
+     * @param cb_data   Expects a pointer to the @c serverLoop of the request
      */
     static void handle_request(struct evhttp_request* request, void* cb_data);
 
@@ -314,22 +557,28 @@ private:
     std::map<std::string, std::string>& get_aliases();
 
     /// Map of GET callbacks
-    std::map<std::string, std::function<void(connectionInstance&)>> get_callbacks;
+    std::map<std::string, std::shared_ptr<getCallback>> get_callbacks;
 
     /// Map of JSON POST callbacks
-    std::map<std::string, std::function<void(connectionInstance&, nlohmann::json&)>> json_callbacks;
+    std::map<std::string, std::shared_ptr<postCallback>> json_callbacks;
 
     /// Alias map
     std::map<std::string, std::string> aliases;
 
-    /// Mutex to lock changes to the maps while a request is in progress
+    /// Mutex to lock changes to the maps while a callback is looked up
     std::shared_timed_mutex callback_map_lock;
 
-    /// The libevent base
-    struct event_base* event_base = nullptr;
+    /// The event loops
+    std::vector<std::unique_ptr<serverLoop>> loops;
+
+    /// The worker threads running blocking callbacks
+    std::vector<std::thread> workers;
 
-    /// The libevent HTTP server object
-    struct evhttp* ev_server = nullptr;
+    /// Blocking callbacks waiting for a worker
+    std::unique_ptr<SynchronizedQueue<std::function<void()>>> work_queue;
+
+    /// Request latency metric
+    prometheus::MetricFamily<prometheus::Histogram>* request_latency = nullptr;
 
     /// Bind address
     std::string bind_address;
@@ -337,9 +586,6 @@ private:
     /// The port to use
     u_short _port;
 
-    /// Main server thread handle
-    std::thread main_thread;
-
     /// Flag set to true when exit condition is reached
     std::atomic<bool> stop_thread;
 
@@ -0,0 +1,106 @@
+#include "cpuAsyncCopyGain.hpp"
+
+#include "gpuCommand.hpp"     // for gpuCommandType, gpuCommandType::COPY_IN
+#include "kotekanLogging.hpp" // for DEBUG
+#include "visUtil.hpp"        // for double_to_ts
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuAsyncCopyGain);
+
+cpuAsyncCopyGain::cpuAsyncCopyGain(Config& config, const std::string& unique_name,
+                                   bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuAsyncCopyGain") {
+    command_type = gpuCommandType::COPY_IN;
+
+    gain_len = 2 * 2048 * sizeof(float);
+    gain_buf = host_buffers.get_buffer("gain_frb_buf");
+    register_consumer(gain_buf, unique_name.c_str());
+    gain_buf_id = 0;
+    gain_buf_finalize_id = 0;
+    gain_buf_precondition_id = 0;
+    frames_to_update = 0;
+    frame_copy_active.assign(_gpu_buffer_depth, false);
+    first_pass = true;
+}
+
+cpuAsyncCopyGain::~cpuAsyncCopyGain() {}
+
+int cpuAsyncCopyGain::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+
+    std::lock_guard<std::mutex> lock(update_mutex);
+
+    if (first_pass) {
+        uint8_t* frame =
+            wait_for_full_frame(gain_buf, unique_name.c_str(), gain_buf_precondition_id);
+        if (frame == nullptr)
+            return -1;
+        gain_buf_precondition_id = (gain_buf_precondition_id + 1) % gain_buf->num_frames;
+        first_pass = false;
+        frames_to_update = _gpu_buffer_depth;
+    } else {
+        // Check for new gains only once all the frames have the current ones
+        bool current_update_active = false;
+        for (bool in_use : frame_copy_active)
+            current_update_active |= in_use;
+        if (frames_to_update == 0 && !current_update_active) {
+            auto timeout = double_to_ts(0);
+            int status = wait_for_full_frame_timeout(gain_buf, unique_name.c_str(),
+                                                     gain_buf_precondition_id, timeout);
+            DEBUG("status of gain_buf_precondition_id[{:d}]={:d} (0=ready 1=not)",
+                  gain_buf_precondition_id, status);
+            if (status == 0) {
+                frames_to_update = _gpu_buffer_depth;
+                gain_buf_precondition_id = (gain_buf_precondition_id + 1) % gain_buf->num_frames;
+            }
+            if (status == -1)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+cpuEvent cpuAsyncCopyGain::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    std::lock_guard<std::mutex> lock(update_mutex);
+
+    if (frames_to_update == 0)
+        return pre_event;
+
+    frame_copy_active.at(gpu_frame_id) = true;
+    DEBUG("Going to async copy gain_buf_id={:d} gpu_frame_id={:d}", gain_buf_id, gpu_frame_id);
+    void* device_gain = device.get_gpu_memory_array("beamform_gain", gpu_frame_id, gain_len);
+    void* host_gain = (void*)gain_buf->frames[gain_buf_id];
+    events[gpu_frame_id] = device.async_copy_host_to_gpu(device_gain, host_gain, gain_len,
+                                                         pre_event);
+
+    frames_to_update--;
+    if (frames_to_update == 0)
+        gain_buf_id = (gain_buf_id + 1) % gain_buf->num_frames;
+
+    return events[gpu_frame_id];
+}
+
+void cpuAsyncCopyGain::finalize_frame(int frame_id) {
+    std::lock_guard<std::mutex> lock(update_mutex);
+
+    if (!frame_copy_active.at(frame_id))
+        return;
+
+    frame_copy_active.at(frame_id) = false;
+    cpuCommand::finalize_frame(frame_id);
+    DEBUG("finalize_frame for gpu_frame_id={:d} using gain_buf_finalize_id={:d}", frame_id,
+          gain_buf_finalize_id);
+
+    bool current_update_active = false;
+    for (bool in_use : frame_copy_active)
+        current_update_active |= in_use;
+    // All the frames have the new gains, so the host frame can be released
+    if (!current_update_active && frames_to_update == 0) {
+        mark_frame_empty(gain_buf, unique_name.c_str(), gain_buf_finalize_id);
+        gain_buf_finalize_id = (gain_buf_finalize_id + 1) % gain_buf->num_frames;
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @brief Copy of the FRB gains to GPU memory on the CPU
+ *  - cpuAsyncCopyGain : public cpuCommand
+ */
+
+#ifndef CPU_ASYNC_COPY_GAIN_H
+#define CPU_ASYNC_COPY_GAIN_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <mutex>    // for mutex
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @class cpuAsyncCopyGain
+ * @brief Copies new FRB gains into the @c beamform_gain of every GPU frame, like
+ *        @c hsaAsyncCopyGain.
+ *
+ * The first gains are waited for, later ones are picked up once all the frames have the
+ * current ones.
+ *
+ * @par Buffers
+ * @buffer gain_frb_buf  The gains.
+ *     @buffer_format Array of 2048 @c float (re, im) pairs
+ *     @buffer_metadata none
+ *
+ * @par GPU Memory
+ * @gpu_mem  beamform_gain  The gains
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of @c float (re, im) pairs
+ */
+class cpuAsyncCopyGain : public cpuCommand {
+public:
+    cpuAsyncCopyGain(kotekan::Config& config, const std::string& unique_name,
+                     kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuAsyncCopyGain();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    Buffer* gain_buf;
+    int32_t gain_len;
+    int32_t gain_buf_id;
+    int32_t gain_buf_finalize_id;
+    int32_t gain_buf_precondition_id;
+
+    /// How many frames still need the new gains
+    int32_t frames_to_update;
+    /// Which GPU frames have a copy in flight
+    std::vector<bool> frame_copy_active;
+    /// Guards the gains and copy state
+    std::mutex update_mutex;
+    bool first_pass;
+};
+
+#endif // CPU_ASYNC_COPY_GAIN_H
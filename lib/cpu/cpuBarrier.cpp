@@ -0,0 +1,22 @@
+#include "cpuBarrier.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::BARRIER
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuBarrier);
+
+cpuBarrier::cpuBarrier(Config& config, const std::string& unique_name,
+                       bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuBarrier") {
+    command_type = gpuCommandType::BARRIER;
+}
+
+cpuBarrier::~cpuBarrier() {}
+
+cpuEvent cpuBarrier::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    return enqueue(gpu_frame_id, pre_event, []() {});
+}
@@ -0,0 +1,33 @@
+/**
+ * @file
+ * @brief Waits for all the commands before it
+ *  - cpuBarrier : public cpuCommand
+ */
+
+#ifndef CPU_BARRIER_H
+#define CPU_BARRIER_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <string> // for string
+
+/**
+ * @class cpuBarrier
+ * @brief Like @c hsaBarrier: the commands after it start once the ones before it are done.
+ *
+ * The commands of a frame already run one after another, so this only has to wait for
+ * the command before it.
+ */
+class cpuBarrier : public cpuCommand {
+public:
+    cpuBarrier(kotekan::Config& config, const std::string& unique_name,
+               kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBarrier();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+};
+
+#endif // CPU_BARRIER_H
@@ -0,0 +1,58 @@
+/**
+ * @file
+ * @brief Copy of the hyper fine beams to the host on the CPU
+ *  - cpuBeamformHFBOutputData : public cpuCommand
+ */
+
+#ifndef CPU_BEAMFORM_HFBOUTPUT_DATA_H
+#define CPU_BEAMFORM_HFBOUTPUT_DATA_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuBeamformHFBOutputData
+ * @brief Copies @c hfb_sum_output to @c beamform_hfb_output_buf and passes on the metadata, like
+ *        @c hsaBeamformHFBOutputData.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ * @buffer beamform_hfb_output_buf  The hyper fine beams.
+ *     @buffer_format Array of @c float, [beam][freq]
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  hfb_sum_output  The hyper fine beams.
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of @c float, [beam][freq]
+ */
+class cpuBeamformHFBOutputData : public cpuCommand {
+public:
+    cpuBeamformHFBOutputData(kotekan::Config& config, const std::string& unique_name,
+                             kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformHFBOutputData();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    Buffer* network_buffer;
+    int32_t network_buffer_id;
+    int32_t network_buffer_precondition_id;
+
+    Buffer* output_buffer;
+    int32_t output_buffer_id;
+    int32_t output_buffer_precondition_id;
+    int32_t output_buffer_execute_id;
+};
+
+#endif // CPU_BEAMFORM_HFBOUTPUT_DATA_H
@@ -0,0 +1,57 @@
+#include "cpuBeamformHFBSum.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+#include <stddef.h> // for size_t
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuBeamformHFBSum);
+
+cpuBeamformHFBSum::cpuBeamformHFBSum(Config& config, const std::string& unique_name,
+                                     bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuBeamformHFBSum") {
+    command_type = gpuCommandType::KERNEL;
+
+    _num_frb_total_beams = config.get<int32_t>(unique_name, "num_frb_total_beams");
+    _factor_upchan = config.get<uint32_t>(unique_name, "factor_upchan");
+    uint32_t samples_per_data_set = config.get<uint32_t>(unique_name, "samples_per_data_set");
+    uint32_t downsample_time = config.get<uint32_t>(unique_name, "downsample_time");
+    _num_samples = samples_per_data_set / _factor_upchan / downsample_time;
+
+    input_frame_len = _num_frb_total_beams * _factor_upchan * _num_samples * sizeof(float);
+    output_frame_len = _num_frb_total_beams * _factor_upchan * sizeof(float);
+    compressed_lost_samples_frame_len = _num_samples * sizeof(uint32_t);
+}
+
+cpuBeamformHFBSum::~cpuBeamformHFBSum() {}
+
+cpuEvent cpuBeamformHFBSum::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const float* input = (float*)device.get_gpu_memory("hfb_output", input_frame_len);
+    const uint32_t* lost_samples = (uint32_t*)device.get_gpu_memory_array(
+        "hfb_compressed_lost_samples", gpu_frame_id, compressed_lost_samples_frame_len);
+    float* output =
+        (float*)device.get_gpu_memory_array("hfb_sum_output", gpu_frame_id, output_frame_len);
+    const size_t num_freq = _factor_upchan;
+    const size_t beam_len = _num_frb_total_beams * num_freq;
+    const size_t num_samples = _num_samples;
+
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        dev.parallel_for(_num_frb_total_beams, [=](size_t beam) {
+            float* sum = output + beam * num_freq;
+            for (size_t f = 0; f < num_freq; f++)
+                sum[f] = 0.f;
+            for (size_t sample = 0; sample < num_samples; sample++) {
+                if (lost_samples[sample])
+                    continue;
+                const float* in = input + sample * beam_len + beam * num_freq;
+                for (size_t f = 0; f < num_freq; f++)
+                    sum[f] += in[f];
+            }
+        });
+    });
+}
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief Sum of the hyper fine beams over the samples of a frame on the CPU
+ *  - cpuBeamformHFBSum : public cpuCommand
+ */
+
+#ifndef CPU_BEAMFORM_HFB_SUM_H
+#define CPU_BEAMFORM_HFB_SUM_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stdint.h> // for int32_t, uint32_t
+#include <string>   // for string
+
+/**
+ * @class cpuBeamformHFBSum
+ * @brief Sums the hyper fine beams of @c cpuBeamformUpchanHFB over the samples of a frame,
+ *        like @c hsaBeamformHFBSum.
+ *
+ * Samples with lost data are left out of the sum. The samples are added in order, like
+ * @c gpuBeamformSimulate.
+ *
+ * @par GPU Memory
+ * @gpu_mem  hfb_output  The hyper fine beams of each sample
+ *     @gpu_mem_type     static
+ *     @gpu_mem_format   Array of @c float, [time][beam][freq]
+ * @gpu_mem  hfb_compressed_lost_samples  Whether each sample had lost data
+ *     @gpu_mem_type     staging
+ *     @gpu_mem_format   Array of @c uint32
+ * @gpu_mem  hfb_sum_output  The sum of the hyper fine beams
+ *     @gpu_mem_type     staging
+ *     @gpu_mem_format   Array of @c float, [beam][freq]
+ *
+ * @conf   num_frb_total_beams   Int. Number of total FRB formed beams.
+ * @conf   factor_upchan         Int. Upchannelisation factor.
+ * @conf   samples_per_data_set  Int. Number of time samples in a data set.
+ * @conf   downsample_time       Int. Downsample factor in time.
+ */
+class cpuBeamformHFBSum : public cpuCommand {
+public:
+    cpuBeamformHFBSum(kotekan::Config& config, const std::string& unique_name,
+                      kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformHFBSum();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    int32_t input_frame_len;
+    int32_t output_frame_len;
+    int32_t compressed_lost_samples_frame_len;
+
+    int32_t _num_frb_total_beams;
+    uint32_t _factor_upchan;
+    /// The number of samples of the hyper fine beams
+    uint32_t _num_samples;
+};
+
+#endif // CPU_BEAMFORM_HFB_SUM_H
@@ -0,0 +1,204 @@
+#include "cpuBeamformKernel.hpp"
+
+#include "buffer.h"       // for mark_frame_empty, register_consumer, wait_for_full_frame
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+#include "restServer.hpp" // for restServer, connectionInstance, HTTP_RESPONSE, HTTP_R...
+
+#include "fmt.hpp" // for format, fmt
+
+#include <cmath>      // for sin, asin, cos, floor
+#include <exception>  // for exception
+#include <functional> // for _Bind_helper<>::type, _Placeholder, bind, _1, _2, pla...
+#include <stdexcept>  // for runtime_error
+#include <string.h>   // for memcpy
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+using kotekan::connectionInstance;
+using kotekan::HTTP_RESPONSE;
+using kotekan::restServer;
+
+REGISTER_CPU_COMMAND(cpuBeamformKernel);
+
+// The constants of gpuBeamformSimulate and hsaBeamformKernel
+static constexpr double LIGHT_SPEED = 299792458.;
+static constexpr double FEED_SEP = 0.3048;
+static constexpr double PI = 3.14159265;
+
+cpuBeamformKernel::cpuBeamformKernel(Config& config, const std::string& unique_name,
+                                     bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuBeamformKernel"),
+    host_map(256),
+    host_coeff(32) {
+    command_type = gpuCommandType::KERNEL;
+
+    _northmost_beam = config.get<float>(unique_name, "northmost_beam");
+    freq_ref = (LIGHT_SPEED * (128) / (sin(_northmost_beam * PI / 180.) * FEED_SEP * 256)) / 1.e6;
+    _ew_spacing = config.get<std::vector<float>>(unique_name, "ew_spacing");
+    if (_ew_spacing.size() != 4)
+        throw std::runtime_error("The ew_spacing needs 4 entries");
+
+    map_len = host_map.size() * sizeof(uint32_t);
+    coeff_len = host_coeff.size() * sizeof(float);
+
+    metadata_buf = host_buffers.get_buffer("network_buf");
+    register_consumer(metadata_buf, unique_name.c_str());
+    metadata_buffer_id = 0;
+    metadata_buffer_precondition_id = 0;
+    freq_idx = FREQ_ID_NOT_SET;
+    freq_MHz = -1;
+
+    update_NS_beam = true;
+    update_EW_beam = true;
+    first_pass = true;
+
+    config_base = fmt::format(fmt("/gpu/gpu_{:d}"), device.get_gpu_id());
+
+    using namespace std::placeholders;
+    restServer& rest_server = restServer::instance();
+    endpoint_NS_beam =
+        fmt::format(fmt("{:s}/frb/update_NS_beam/{:d}"), config_base, device.get_gpu_id());
+    rest_server.register_post_callback(
+        endpoint_NS_beam, std::bind(&cpuBeamformKernel::update_NS_beam_callback, this, _1, _2));
+    endpoint_EW_beam =
+        fmt::format(fmt("{:s}/frb/update_EW_beam/{:d}"), config_base, device.get_gpu_id());
+    rest_server.register_post_callback(
+        endpoint_EW_beam, std::bind(&cpuBeamformKernel::update_EW_beam_callback, this, _1, _2));
+}
+
+cpuBeamformKernel::~cpuBeamformKernel() {
+    restServer::instance().remove_json_callback(endpoint_NS_beam);
+    restServer::instance().remove_json_callback(endpoint_EW_beam);
+}
+
+void cpuBeamformKernel::update_EW_beam_callback(connectionInstance& conn,
+                                                nlohmann::json& json_request) {
+    int ew_id;
+    float ew_beam;
+    try {
+        ew_id = json_request["ew_id"];
+        ew_beam = json_request["ew_beam"];
+    } catch (...) {
+        conn.send_error("could not parse FRB E-W beam update", HTTP_RESPONSE::BAD_REQUEST);
+        return;
+    }
+    if (ew_id < 0 || ew_id >= 4) {
+        conn.send_error("ew_id must be in [0, 4)", HTTP_RESPONSE::BAD_REQUEST);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(beam_mutex);
+        _ew_spacing[ew_id] = ew_beam;
+        update_EW_beam = true;
+    }
+    config.update_value(config_base, fmt::format(fmt("ew_spacing/{:d}"), ew_id),
+                        json_request["ew_beam"]);
+    conn.send_empty_reply(HTTP_RESPONSE::OK);
+}
+
+void cpuBeamformKernel::update_NS_beam_callback(connectionInstance& conn,
+                                                nlohmann::json& json_request) {
+    float northmost_beam;
+    try {
+        northmost_beam = json_request["northmost_beam"];
+    } catch (...) {
+        conn.send_error("could not parse FRB N-S beam update", HTTP_RESPONSE::BAD_REQUEST);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(beam_mutex);
+        _northmost_beam = northmost_beam;
+        freq_ref =
+            (LIGHT_SPEED * (128) / (sin(_northmost_beam * PI / 180.) * FEED_SEP * 256)) / 1.e6;
+        update_NS_beam = true;
+    }
+    config.update_value(config_base, "northmost_beam", json_request["northmost_beam"]);
+    conn.send_empty_reply(HTTP_RESPONSE::OK);
+}
+
+int cpuBeamformKernel::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+    uint8_t* frame =
+        wait_for_full_frame(metadata_buf, unique_name.c_str(), metadata_buffer_precondition_id);
+    if (frame == nullptr)
+        return -1;
+    metadata_buffer_precondition_id =
+        (metadata_buffer_precondition_id + 1) % metadata_buf->num_frames;
+    return 0;
+}
+
+void cpuBeamformKernel::calculate_cl_index() {
+    float t, delta_t, beam_ref;
+    int cl_index;
+    float D2R = PI / 180.;
+    int pad = 2;
+
+    for (int b = 0; b < 256; ++b) {
+        beam_ref =
+            asin(LIGHT_SPEED * (b - 256 / 2.) / (freq_ref * 1.e6) / (256) / FEED_SEP) * 180. / PI;
+        t = 256 * pad * (freq_ref * 1.e6) * (FEED_SEP / LIGHT_SPEED * sin(beam_ref * D2R)) + 0.5;
+        delta_t = 256 * pad * (freq_MHz * 1e6 - freq_ref * 1e6)
+                  * (FEED_SEP / LIGHT_SPEED * sin(beam_ref * D2R));
+        cl_index = (int)floor(t + delta_t) + 256 * pad / 2.;
+
+        if (cl_index < 0)
+            cl_index = 256 * pad + cl_index;
+        else if (cl_index > 256 * pad)
+            cl_index = cl_index - 256 * pad;
+
+        cl_index = cl_index - 256;
+        if (cl_index < 0) {
+            cl_index = 256 * pad + cl_index;
+        }
+        host_map[b] = cl_index;
+    }
+}
+
+void cpuBeamformKernel::calculate_ew_phase() {
+    for (int angle_iter = 0; angle_iter < 4; angle_iter++) {
+        double anglefrac = sin(_ew_spacing[angle_iter] * PI / 180.);
+        for (int cylinder = 0; cylinder < 4; cylinder++) {
+            host_coeff[angle_iter * 4 * 2 + cylinder * 2] =
+                cos(2 * PI * anglefrac * cylinder * 22 * freq_MHz * 1.e6 / LIGHT_SPEED);
+            host_coeff[angle_iter * 4 * 2 + cylinder * 2 + 1] =
+                sin(2 * PI * anglefrac * cylinder * 22 * freq_MHz * 1.e6 / LIGHT_SPEED);
+        }
+    }
+}
+
+cpuEvent cpuBeamformKernel::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    if (first_pass) {
+        first_pass = false;
+        auto& tel = Telescope::instance();
+        freq_idx = tel.to_freq_id(metadata_buf, metadata_buffer_id);
+        freq_MHz = tel.to_freq(freq_idx);
+    }
+    mark_frame_empty(metadata_buf, unique_name.c_str(), metadata_buffer_id);
+    metadata_buffer_id = (metadata_buffer_id + 1) % metadata_buf->num_frames;
+
+    {
+        std::lock_guard<std::mutex> lock(beam_mutex);
+        if (update_NS_beam) {
+            calculate_cl_index();
+            update_NS_beam = false;
+        }
+        if (update_EW_beam) {
+            calculate_ew_phase();
+            update_EW_beam = false;
+        }
+    }
+
+    // Each frame has its own copy, so an update never changes the beams of a frame in flight
+    void* map = device.get_gpu_memory_array("beamform_map", gpu_frame_id, map_len);
+    void* coeff = device.get_gpu_memory_array("beamform_coeff_map", gpu_frame_id, coeff_len);
+    std::vector<uint32_t> frame_map = host_map;
+    std::vector<float> frame_coeff = host_coeff;
+
+    return enqueue(gpu_frame_id, pre_event, [=]() {
+        memcpy(map, frame_map.data(), frame_map.size() * sizeof(uint32_t));
+        memcpy(coeff, frame_coeff.data(), frame_coeff.size() * sizeof(float));
+    });
+}
@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @brief Beam positions of the FRB beamformer on the CPU
+ *  - cpuBeamformKernel : public cpuCommand
+ */
+
+#ifndef CPU_BEAMFORM_KERNEL_H
+#define CPU_BEAMFORM_KERNEL_H
+
+#include "Config.hpp"             // for Config
+#include "Telescope.hpp"          // for freq_id_t
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "restServer.hpp"         // for connectionInstance
+
+#include "json.hpp" // for json
+
+#include <mutex>    // for mutex
+#include <stdint.h> // for int32_t, uint32_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @class cpuBeamformKernel
+ * @brief Sets the positions of the FRB beams for @c cpuBeamformUpchan, like the host side
+ *        of @c hsaBeamformKernel.
+ *
+ * This works out the frequency from the metadata of the first frame, and writes the
+ * clamping index of each of the 256 N-S beams into the 512 beams of the padded N-S FFT,
+ * and the phases of the brute force beamforming of the 4 E-W beams, into the memory of
+ * each frame. The N-S and E-W beamforming itself is done by @c cpuBeamformUpchan together
+ * with the upchannelisation, over chunks of time which fit in the caches, so the
+ * @c beamform_output of the GPU pipeline is never stored. The E-W phases are computed in
+ * double precision like @c gpuBeamformSimulate.
+ *
+ * @par REST Endpoints
+ * @endpoint    /gpu/gpu_\<gpu id\>/frb/update_NS_beam/\<gpu id\> ``POST`` Sets the
+ *              extent of the N-S beams
+ *              requires json values      northmost_beam
+ *              update config             northmost_beam
+ * @endpoint    /gpu/gpu_\<gpu id\>/frb/update_EW_beam/\<gpu id\> ``POST`` Sets the sky
+ *              angle of one of the 4 E-W beams
+ *              requires json values      ew_id, ew_beam
+ *              update config             ew_spacing[ew_id]
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for the frequency in its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  beamform_map        The FFT beam of each N-S beam, size 256
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of @c uint32
+ * @gpu_mem  beamform_coeff_map  The phases of the E-W beams, size 4 x 4 cylinders x 2
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of @c float (re, im) pairs
+ *
+ * @conf   northmost_beam  Float. Zenith angle of the northmost beam (in deg).
+ * @conf   ew_spacing      Float array. 4 sky angles for the columns of E-W beams (in deg).
+ */
+class cpuBeamformKernel : public cpuCommand {
+public:
+    cpuBeamformKernel(kotekan::Config& config, const std::string& unique_name,
+                      kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformKernel();
+
+    /// Waits for the metadata of the frame
+    int wait_on_precondition(int gpu_frame_id) override;
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+    /// Endpoint for setting N-S beam extent
+    void update_NS_beam_callback(kotekan::connectionInstance& conn, nlohmann::json& json_request);
+    /// Endpoint for setting E-W beam sky angle
+    void update_EW_beam_callback(kotekan::connectionInstance& conn, nlohmann::json& json_request);
+
+private:
+    /// Computes @c host_map from @c freq_MHz and @c freq_ref
+    void calculate_cl_index();
+
+    /// Computes @c host_coeff from @c freq_MHz and @c _ew_spacing
+    void calculate_ew_phase();
+
+    int32_t map_len;
+    int32_t coeff_len;
+
+    Buffer* metadata_buf;
+    int32_t metadata_buffer_id;
+    int32_t metadata_buffer_precondition_id;
+
+    /// Freq bin index, where the 0th is at 800MHz
+    freq_id_t freq_idx;
+    /// Freq in MHz
+    float freq_MHz;
+
+    /// The clamping index of each N-S beam
+    std::vector<uint32_t> host_map;
+    /// The phase of each cylinder for each E-W beam
+    std::vector<float> host_coeff;
+
+    /// The desired extent (e.g. 90, 60, 45) of the Northmost beam in degree
+    float _northmost_beam;
+    /// The sky angle of the 4 EW beams in degree
+    std::vector<float> _ew_spacing;
+    /// The reference freq for calcating beam spacing, a function of the input _northmost_beam
+    double freq_ref;
+
+    bool first_pass;
+    bool update_NS_beam;
+    bool update_EW_beam;
+    /// Guards the beam positions, which the endpoints change
+    std::mutex beam_mutex;
+
+    std::string endpoint_NS_beam;
+    std::string endpoint_EW_beam;
+    std::string config_base;
+};
+
+#endif // CPU_BEAMFORM_KERNEL_H
@@ -0,0 +1,58 @@
+/**
+ * @file
+ * @brief Copy of the FRB beams to the host on the CPU
+ *  - cpuBeamformOutputData : public cpuCommand
+ */
+
+#ifndef CPU_BEAMFORM_OUTPUT_DATA_H
+#define CPU_BEAMFORM_OUTPUT_DATA_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuBeamformOutputData
+ * @brief Copies @c bf_output to @c beamform_output_buf and passes on the metadata, like
+ *        @c hsaBeamformOutputData.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ * @buffer beamform_output_buf  The FRB beams.
+ *     @buffer_format Array of @c float, [beam][time][freq]
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  bf_output  The FRB beams.
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of @c float, [beam][time][freq]
+ */
+class cpuBeamformOutputData : public cpuCommand {
+public:
+    cpuBeamformOutputData(kotekan::Config& config, const std::string& unique_name,
+                          kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformOutputData();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    Buffer* network_buffer;
+    int32_t network_buffer_id;
+    int32_t network_buffer_precondition_id;
+
+    Buffer* output_buffer;
+    int32_t output_buffer_id;
+    int32_t output_buffer_precondition_id;
+    int32_t output_buffer_execute_id;
+};
+
+#endif // CPU_BEAMFORM_OUTPUT_DATA_H
@@ -0,0 +1,68 @@
+#include "cpuBeamformReorder.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm> // for min
+#include <stddef.h>  // for size_t
+#include <stdexcept> // for runtime_error
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuBeamformReorder);
+
+// The number of samples reordered by one work item
+#define REORDER_BLOCK 256
+
+cpuBeamformReorder::cpuBeamformReorder(Config& config, const std::string& unique_name,
+                                       bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuBeamformReorder") {
+    command_type = gpuCommandType::KERNEL;
+
+    _num_elements = config.get<int32_t>(unique_name, "num_elements");
+    _num_local_freq = config.get<int32_t>(unique_name, "num_local_freq");
+    _samples_per_data_set = config.get<int32_t>(unique_name, "samples_per_data_set");
+    std::vector<int32_t> reorder_map = config.get<std::vector<int32_t>>(unique_name, "reorder_map");
+
+    const int32_t num_words = _num_elements / 4;
+    if (_num_elements % 4 != 0 || (int32_t)reorder_map.size() < num_words)
+        throw std::runtime_error(fmt::format(fmt("The reorder_map needs {:d} entries"), num_words));
+    for (int32_t i = 0; i < num_words; i++) {
+        if (reorder_map[i] < 0 || reorder_map[i] >= num_words)
+            throw std::runtime_error(
+                fmt::format(fmt("Invalid entry {:d} of the reorder_map"), reorder_map[i]));
+        _reorder_map.push_back(reorder_map[i]);
+    }
+
+    input_frame_len = _num_elements * _num_local_freq * _samples_per_data_set;
+    output_frame_len = _num_elements * _num_local_freq * _samples_per_data_set;
+}
+
+cpuBeamformReorder::~cpuBeamformReorder() {}
+
+cpuEvent cpuBeamformReorder::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const uint32_t* input =
+        (uint32_t*)device.get_gpu_memory_array("input", gpu_frame_id, input_frame_len);
+    uint32_t* output = (uint32_t*)device.get_gpu_memory("input_reordered", output_frame_len);
+    const uint32_t* map = _reorder_map.data();
+    const size_t num_words = _num_elements / 4;
+    const size_t num_samples = _samples_per_data_set * _num_local_freq;
+
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        const size_t num_blocks = (num_samples + REORDER_BLOCK - 1) / REORDER_BLOCK;
+        dev.parallel_for(num_blocks, [=](size_t block) {
+            const size_t end = std::min((block + 1) * REORDER_BLOCK, num_samples);
+            for (size_t t = block * REORDER_BLOCK; t < end; t++) {
+                const uint32_t* in = input + t * num_words;
+                uint32_t* out = output + t * num_words;
+                for (size_t i = 0; i < num_words; i++)
+                    out[i] = in[map[i]];
+            }
+        });
+    });
+}
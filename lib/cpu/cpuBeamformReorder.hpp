@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Reordering of the input for the FRB beamformer on the CPU
+ *  - cpuBeamformReorder : public cpuCommand
+ */
+
+#ifndef CPU_BEAMFORM_REORDER_H
+#define CPU_BEAMFORM_REORDER_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stdint.h> // for int32_t, uint32_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @class cpuBeamformReorder
+ * @brief Reorders the input from correlator order to the time-pol-EW-NS order of the FRB
+ *        beamformer, like @c hsaBeamformReorder.
+ *
+ * The inputs are scrambled in groups of 4, so the map moves 32 bit words: word @c i of
+ * each sample of the output is word @c reorder_map[i] of the input.
+ *
+ * @par GPU Memory
+ * @gpu_mem  input            Input data of size input_frame_len
+ *     @gpu_mem_type          staging
+ *     @gpu_mem_format        Array of 4+4 bit complex samples, [time][element]
+ * @gpu_mem  input_reordered  The reordered input data
+ *     @gpu_mem_type          static
+ *     @gpu_mem_format        Array of 4+4 bit complex samples, [time][pol][EW][NS]
+ *
+ * @conf  num_elements          Int. Number of elements.
+ * @conf  num_local_freq        Int. Number of local frequencies.
+ * @conf  samples_per_data_set  Int. Number of time samples in a data set.
+ * @conf  reorder_map           Int array of size @c num_elements/4. Reordering index.
+ */
+class cpuBeamformReorder : public cpuCommand {
+public:
+    cpuBeamformReorder(kotekan::Config& config, const std::string& unique_name,
+                       kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformReorder();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    int32_t input_frame_len;
+    int32_t output_frame_len;
+
+    std::vector<uint32_t> _reorder_map;
+
+    int32_t _num_elements;
+    int32_t _num_local_freq;
+    int32_t _samples_per_data_set;
+};
+
+#endif // CPU_BEAMFORM_REORDER_H
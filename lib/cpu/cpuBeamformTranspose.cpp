@@ -0,0 +1,23 @@
+#include "cpuBeamformTranspose.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuBeamformTranspose);
+
+cpuBeamformTranspose::cpuBeamformTranspose(Config& config, const std::string& unique_name,
+                                           bufferContainer& host_buffers,
+                                           cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuBeamformTranspose") {
+    command_type = gpuCommandType::KERNEL;
+}
+
+cpuBeamformTranspose::~cpuBeamformTranspose() {}
+
+cpuEvent cpuBeamformTranspose::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    return pre_event;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @brief The transpose of the FRB beams, which the CPU doesn't need
+ *  - cpuBeamformTranspose : public cpuCommand
+ */
+
+#ifndef CPU_BEAMFORM_TRANSPOSE_H
+#define CPU_BEAMFORM_TRANSPOSE_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <string> // for string
+
+/**
+ * @class cpuBeamformTranspose
+ * @brief Stands in for @c hsaBeamformTranspose, so the command lists of the GPU FRB
+ *        pipeline run on the CPU.
+ *
+ * @c cpuBeamformUpchan forms the beams in time-major chunks which it upchannelises
+ * directly, so there is nothing to transpose.
+ */
+class cpuBeamformTranspose : public cpuCommand {
+public:
+    cpuBeamformTranspose(kotekan::Config& config, const std::string& unique_name,
+                         kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformTranspose();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+};
+
+#endif // CPU_BEAMFORM_TRANSPOSE_H
@@ -0,0 +1,367 @@
+#include "cpuBeamformUpchan.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm> // for min
+#include <atomic>    // for atomic
+#include <cmath>     // for cos, sin
+#include <stdexcept> // for runtime_error
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuBeamformUpchan);
+
+// The N-S feeds of a cylinder, which is also the number of N-S beams
+#define FRB_NS_FEEDS 256
+// The N-S FFT is padded by 2
+#define FRB_NS_FFT 512
+#define FRB_NUM_EW 4
+#define FRB_NUM_POL 2
+// The output channels, the size of the bandpass correction
+#define FRB_NUM_FREQ_OUT 16
+
+/// FRB_LANES floats, one from each transform
+typedef float frb_fvec_t __attribute__((vector_size(FRB_LANES * sizeof(float))));
+
+// 16-bandpass correction of gpuBeamformSimulate
+static const float frb_bandpass[FRB_NUM_FREQ_OUT] = {
+    0.52225748, 0.58330915, 0.6868705,  0.80121821, 0.89386546, 0.95477358,
+    0.98662733, 0.99942558, 0.99988676, 0.98905127, 0.95874124, 0.90094667,
+    0.81113021, 0.6999944,  0.59367968, 0.52614263};
+
+cpuBeamformUpchan::cpuBeamformUpchan(Config& config, const std::string& unique_name,
+                                     bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuBeamformUpchan(config, unique_name, host_buffers, device, "cpuBeamformUpchan", false) {}
+
+cpuBeamformUpchan::cpuBeamformUpchan(Config& config, const std::string& unique_name,
+                                     bufferContainer& host_buffers, cpuDeviceInterface& device,
+                                     const std::string& name, bool hfb) :
+    cpuCommand(config, unique_name, host_buffers, device, name),
+    _hfb(hfb) {
+    command_type = gpuCommandType::KERNEL;
+
+    _num_elements = config.get<int32_t>(unique_name, "num_elements");
+    int32_t num_local_freq = config.get<int32_t>(unique_name, "num_local_freq");
+    _samples_per_data_set = config.get<int32_t>(unique_name, "samples_per_data_set");
+    _factor_upchan = config.get<int32_t>(unique_name, "factor_upchan");
+    _downsample_time = config.get<int32_t>(unique_name, "downsample_time");
+    _downsample_freq = config.get<int32_t>(unique_name, "downsample_freq");
+    _num_frb_total_beams = config.get<int32_t>(unique_name, "num_frb_total_beams");
+
+    // The geometry is that of the CHIME FRB beamformer, like the GPU kernels
+    if (_num_elements != FRB_LANES * FRB_NS_FEEDS || num_local_freq != 1
+        || _num_frb_total_beams != _num_elements / FRB_NUM_POL)
+        throw std::runtime_error(fmt::format(
+            fmt("The FRB beamformer needs {:d} elements, 1 freq and {:d} beams"),
+            FRB_LANES * FRB_NS_FEEDS, FRB_LANES * FRB_NS_FEEDS / FRB_NUM_POL));
+    if (_factor_upchan < 2 || _factor_upchan > FRB_NS_FFT
+        || (_factor_upchan & (_factor_upchan - 1)) != 0
+        || _downsample_freq * FRB_NUM_FREQ_OUT != _factor_upchan || _downsample_time < 1
+        || _samples_per_data_set % (_factor_upchan * _downsample_time) != 0)
+        throw std::runtime_error(fmt::format(
+            fmt("Unsupported FRB upchannelisation: factor_upchan {:d}, downsample_freq {:d}, "
+                "downsample_time {:d}, {:d} samples"),
+            _factor_upchan, _downsample_freq, _downsample_time, _samples_per_data_set));
+
+    num_samples_out = _samples_per_data_set / _factor_upchan / _downsample_time;
+    input_frame_len = _num_elements * _samples_per_data_set;
+    output_frame_len = _num_frb_total_beams * num_samples_out * FRB_NUM_FREQ_OUT * sizeof(float);
+    output_hfb_frame_len =
+        _num_frb_total_beams * _factor_upchan * num_samples_out * sizeof(float);
+    gain_len = 2 * _num_elements * sizeof(float);
+
+    // The twiddle factors, computed exactly like gpuBeamformSimulate::cpu_beamform_ns
+    ns_twiddle_re.resize(FRB_NS_FFT - 1);
+    ns_twiddle_im.resize(FRB_NS_FFT - 1);
+    for (uint64_t step_size = 1; step_size < FRB_NS_FFT; step_size += step_size) {
+        double theta = -3.141592654 / (step_size);
+        for (uint32_t minor_index = 0; minor_index < step_size; minor_index++) {
+            ns_twiddle_re[step_size - 1 + minor_index] = cos(minor_index * theta);
+            ns_twiddle_im[step_size - 1 + minor_index] = sin(minor_index * theta);
+        }
+    }
+    // and with the trigonometric recurrence of gpuBeamformSimulate::upchannelize
+    upchan_twiddle_re.resize(_factor_upchan - 1);
+    upchan_twiddle_im.resize(_factor_upchan - 1);
+    for (unsigned long mmax = 2; mmax < 2 * (unsigned long)_factor_upchan; mmax <<= 1) {
+        double wtemp, wr, wpr, wpi, wi, theta;
+        theta = (6.28318530717959 / mmax);
+        wtemp = sin(0.5 * theta);
+        wpr = -2.0 * wtemp * wtemp;
+        wpi = sin(theta);
+        wr = 1.0;
+        wi = 0.0;
+        for (unsigned long m = 1; m < mmax; m += 2) {
+            upchan_twiddle_re[mmax / 2 - 1 + m / 2] = wr;
+            upchan_twiddle_im[mmax / 2 - 1 + m / 2] = wi;
+            wr = (wtemp = wr) * wpr - wi * wpi + wr;
+            wi = wi * wpr + wtemp * wpi + wi;
+        }
+    }
+
+    // After the bit reversal of the N-S FFT the padding is in the odd entries, and entry
+    // 2 k is feed reverse(k) of the 256 feeds
+    for (uint32_t k = 0; k < FRB_NS_FEEDS; k++) {
+        uint32_t r = 0;
+        for (uint32_t bit = 1; bit < FRB_NS_FEEDS; bit <<= 1)
+            r = (r << 1) | ((k & bit) ? 1 : 0);
+        ns_reverse.push_back(r);
+    }
+    for (uint32_t k = 0; k < (uint32_t)_factor_upchan; k++) {
+        uint32_t r = 0;
+        for (uint32_t bit = 1; bit < (uint32_t)_factor_upchan; bit <<= 1)
+            r = (r << 1) | ((k & bit) ? 1 : 0);
+        upchan_reverse.push_back(r);
+    }
+
+    // FFT, clamped N-S beams, the beams and the power of the chunk
+    scratch_len = 2 * FRB_NS_FFT * FRB_LANES + 2 * FRB_LANES * FRB_NS_FEEDS
+                  + 2 * _num_elements * _factor_upchan
+                  + _num_elements * _downsample_time * _factor_upchan / 2;
+    num_workers = std::min<size_t>(device.get_num_threads(), num_samples_out);
+}
+
+cpuBeamformUpchan::~cpuBeamformUpchan() {}
+
+cpuBeamformUpchan::scratchData cpuBeamformUpchan::get_scratch(double* scratch,
+                                                              size_t thread) const {
+    scratchData s;
+    double* p = scratch + thread * scratch_len;
+    s.fft_re = (frb_vec_t*)p;
+    s.fft_im = s.fft_re + FRB_NS_FFT;
+    p += 2 * FRB_NS_FFT * FRB_LANES;
+    s.clamped_re = p;
+    s.clamped_im = p + FRB_LANES * FRB_NS_FEEDS;
+    p += 2 * FRB_LANES * FRB_NS_FEEDS;
+    s.beams_re = (frb_vec_t*)p;
+    s.beams_im = s.beams_re + _num_elements / FRB_LANES * _factor_upchan;
+    p += 2 * _num_elements * _factor_upchan;
+    s.power = (float*)p;
+    return s;
+}
+
+void cpuBeamformUpchan::beamform(const frameData& frame, const uint8_t* input, size_t t,
+                                 const scratchData& s) const {
+    frb_vec_t* re = s.fft_re;
+    frb_vec_t* im = s.fft_im;
+
+    // Unpack the feeds in bit reversed order and multiply by the conjugate of the gains.
+    // The first stage of the FFT adds the zero padding to them, i.e. copies them.
+    for (size_t k = 0; k < FRB_NS_FEEDS; k++) {
+        const size_t i = ns_reverse[k];
+        frb_vec_t x_re, x_im;
+        for (int l = 0; l < FRB_LANES; l++) {
+            const uint8_t x = input[l * FRB_NS_FEEDS + i];
+            x_re[l] = (x >> 4) - 8;
+            x_im[l] = (x & 0x0f) - 8;
+        }
+        const frb_vec_t g_re = frame.gain_re[i];
+        const frb_vec_t g_im = frame.gain_im[i];
+        re[2 * k] = re[2 * k + 1] = x_re * g_re + x_im * g_im;
+        im[2 * k] = im[2 * k + 1] = x_im * g_re - x_re * g_im;
+    }
+
+    // The other stages of the N-S FFT, but the last
+    for (size_t step = 2; step < FRB_NS_FFT / 2; step *= 2) {
+        for (size_t index = 0; index < FRB_NS_FFT; index += 2 * step) {
+            for (size_t m = 0; m < step; m++) {
+                const double wr = ns_twiddle_re[step - 1 + m];
+                const double wi = ns_twiddle_im[step - 1 + m];
+                const size_t a = index + m;
+                const size_t b = a + step;
+                const frb_vec_t tr = wr * re[b] - wi * im[b];
+                const frb_vec_t ti = wi * re[b] + wr * im[b];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+
+    // The last stage only for the clamped beams, flipping N-S
+    const size_t half = FRB_NS_FFT / 2;
+    for (size_t b = 0; b < FRB_NS_FEEDS; b++) {
+        const size_t k = frame.map[b] % FRB_NS_FFT;
+        const size_t a = k % half;
+        const size_t c = a + half;
+        const double wr = ns_twiddle_re[half - 1 + a];
+        const double wi = ns_twiddle_im[half - 1 + a];
+        const frb_vec_t tr = wr * re[c] - wi * im[c];
+        const frb_vec_t ti = wi * re[c] + wr * im[c];
+        const frb_vec_t x_re = k < half ? re[a] + tr : re[a] - tr;
+        const frb_vec_t x_im = k < half ? im[a] + ti : im[a] - ti;
+        for (int l = 0; l < FRB_LANES; l++) {
+            s.clamped_re[l * FRB_NS_FEEDS + FRB_NS_FEEDS - 1 - b] = x_re[l];
+            s.clamped_im[l * FRB_NS_FEEDS + FRB_NS_FEEDS - 1 - b] = x_im[l];
+        }
+    }
+
+    // Brute force E-W beams, with FRB_LANES N-S beams at a time
+    for (size_t p = 0; p < FRB_NUM_POL; p++) {
+        for (size_t ew = 0; ew < FRB_NUM_EW; ew++) {
+            for (size_t ns = 0; ns < FRB_NS_FEEDS; ns += FRB_LANES) {
+                frb_vec_t acc_re = {}, acc_im = {};
+                for (size_t e = 0; e < FRB_NUM_EW; e++) {
+                    const size_t offset = (p * FRB_NUM_EW + e) * FRB_NS_FEEDS + ns;
+                    const frb_vec_t x_re = *(frb_vec_t*)(s.clamped_re + offset);
+                    const frb_vec_t x_im = *(frb_vec_t*)(s.clamped_im + offset);
+                    const double c_re = frame.coeff[2 * (ew * FRB_NUM_EW + e)];
+                    const double c_im = frame.coeff[2 * (ew * FRB_NUM_EW + e) + 1];
+                    acc_re += x_re * c_re + x_im * c_im;
+                    acc_im += x_re * c_im - x_im * c_re;
+                }
+                const size_t beam = (p * FRB_NUM_EW + ew) * FRB_NS_FEEDS + ns;
+                s.beams_re[beam / FRB_LANES * _factor_upchan + t] = acc_re / 4.;
+                s.beams_im[beam / FRB_LANES * _factor_upchan + t] = acc_im / 4.;
+            }
+        }
+    }
+}
+
+void cpuBeamformUpchan::upchannelise(size_t tt, const scratchData& s) const {
+    const size_t num_freq = _factor_upchan;
+    frb_vec_t* re = s.fft_re;
+    frb_vec_t* im = s.fft_im;
+
+    for (size_t g = 0; g < (size_t)_num_elements / FRB_LANES; g++) {
+        const frb_vec_t* beam_re = s.beams_re + g * num_freq;
+        const frb_vec_t* beam_im = s.beams_im + g * num_freq;
+        for (size_t k = 0; k < num_freq; k++) {
+            re[k] = beam_re[upchan_reverse[k]];
+            im[k] = beam_im[upchan_reverse[k]];
+        }
+
+        for (size_t step = 1; step < num_freq; step *= 2) {
+            for (size_t index = 0; index < num_freq; index += 2 * step) {
+                for (size_t m = 0; m < step; m++) {
+                    const double wr = upchan_twiddle_re[step - 1 + m];
+                    const double wi = upchan_twiddle_im[step - 1 + m];
+                    const size_t a = index + m;
+                    const size_t b = a + step;
+                    const frb_vec_t tr = wr * re[b] - wi * im[b];
+                    const frb_vec_t ti = wr * im[b] + wi * re[b];
+                    re[b] = re[a] - tr;
+                    im[b] = im[a] - ti;
+                    re[a] += tr;
+                    im[a] += ti;
+                }
+            }
+        }
+
+        // The power in single precision, like the simulation
+        frb_fvec_t* power = (frb_fvec_t*)s.power + (g * _downsample_time + tt) * num_freq;
+        for (size_t f = 0; f < num_freq; f++) {
+            const frb_fvec_t x_re = __builtin_convertvector(re[f], frb_fvec_t);
+            const frb_fvec_t x_im = __builtin_convertvector(im[f], frb_fvec_t);
+            power[f] = x_re * x_re + x_im * x_im;
+        }
+    }
+}
+
+void cpuBeamformUpchan::downsample(const frameData& frame, size_t sample,
+                                   const scratchData& s) const {
+    const size_t num_freq = _factor_upchan;
+    const size_t num_groups = _num_frb_total_beams / FRB_LANES;
+    const frb_fvec_t* power = (const frb_fvec_t*)s.power;
+    const double norm = FRB_NUM_POL * _downsample_time * _downsample_freq;
+
+    for (size_t group = 0; group < num_groups; group++) {
+        for (size_t f = 0; f < FRB_NUM_FREQ_OUT; f++) {
+            frb_fvec_t sum = {};
+            for (size_t p = 0; p < FRB_NUM_POL; p++) {
+                const size_t g = p * num_groups + group;
+                for (int tt = 0; tt < _downsample_time; tt++) {
+                    for (int ff = 0; ff < _downsample_freq; ff++) {
+                        sum += power[(g * _downsample_time + tt) * num_freq
+                                     + f * _downsample_freq + ff];
+                    }
+                }
+            }
+            // Roll by half the channels, and normalise in double precision like the simulation
+            const size_t f_out = (f + FRB_NUM_FREQ_OUT / 2) % FRB_NUM_FREQ_OUT;
+            const frb_fvec_t out = __builtin_convertvector(
+                __builtin_convertvector(sum, frb_vec_t) / norm / (double)frb_bandpass[f_out],
+                frb_fvec_t);
+            for (int l = 0; l < FRB_LANES; l++) {
+                frame.output[((group * FRB_LANES + l) * num_samples_out + sample)
+                                 * FRB_NUM_FREQ_OUT
+                             + f_out] = out[l];
+            }
+        }
+    }
+
+    if (!_hfb)
+        return;
+
+    const float hfb_norm = FRB_NUM_POL * _downsample_time;
+    for (size_t group = 0; group < num_groups; group++) {
+        for (size_t f = 0; f < num_freq; f++) {
+            frb_fvec_t sum = {};
+            for (size_t p = 0; p < FRB_NUM_POL; p++) {
+                const size_t g = p * num_groups + group;
+                for (int tt = 0; tt < _downsample_time; tt++)
+                    sum += power[(g * _downsample_time + tt) * num_freq + f];
+            }
+            const frb_fvec_t out = sum / hfb_norm;
+            const size_t f_out = (f + num_freq / 2) % num_freq;
+            for (int l = 0; l < FRB_LANES; l++) {
+                frame.hfb_output[(sample * _num_frb_total_beams + group * FRB_LANES + l)
+                                     * num_freq
+                                 + f_out] = out[l];
+            }
+        }
+    }
+}
+
+cpuEvent cpuBeamformUpchan::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const uint8_t* input = (uint8_t*)device.get_gpu_memory("input_reordered", input_frame_len);
+    const uint32_t* map = (uint32_t*)device.get_gpu_memory_array(
+        "beamform_map", gpu_frame_id, FRB_NS_FEEDS * sizeof(uint32_t));
+    const float* coeff = (float*)device.get_gpu_memory_array(
+        "beamform_coeff_map", gpu_frame_id, 2 * FRB_NUM_EW * FRB_NUM_EW * sizeof(float));
+    const float* gain =
+        (float*)device.get_gpu_memory_array("beamform_gain", gpu_frame_id, gain_len);
+    float* output =
+        (float*)device.get_gpu_memory_array("bf_output", gpu_frame_id, output_frame_len);
+    float* hfb_output =
+        _hfb ? (float*)device.get_gpu_memory("hfb_output", output_hfb_frame_len) : nullptr;
+    // The gains in the lanes of the N-S FFT, and the scratch memory of each thread
+    const size_t gain_lanes_len = 2 * FRB_NS_FEEDS * FRB_LANES;
+    double* scratch = (double*)device.get_gpu_memory(
+        "frb_scratch", (gain_lanes_len + num_workers * scratch_len) * sizeof(double));
+
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        frb_vec_t* gain_re = (frb_vec_t*)scratch;
+        frb_vec_t* gain_im = gain_re + FRB_NS_FEEDS;
+        for (size_t i = 0; i < FRB_NS_FEEDS; i++) {
+            for (int l = 0; l < FRB_LANES; l++) {
+                gain_re[i][l] = gain[2 * (l * FRB_NS_FEEDS + i)];
+                gain_im[i][l] = gain[2 * (l * FRB_NS_FEEDS + i) + 1];
+            }
+        }
+        const frameData frame = {input, map, coeff, gain_re, gain_im, output, hfb_output};
+
+        // Each output sample is a chunk of work
+        std::atomic<size_t> next_sample(0);
+        dev.parallel_for(num_workers, [&](size_t thread) {
+            const scratchData s = get_scratch(scratch + gain_lanes_len, thread);
+            for (size_t sample = next_sample++; sample < num_samples_out;
+                 sample = next_sample++) {
+                for (int tt = 0; tt < _downsample_time; tt++) {
+                    const size_t start = (sample * _downsample_time + tt) * _factor_upchan;
+                    for (int t = 0; t < _factor_upchan; t++)
+                        beamform(frame, input + (start + t) * _num_elements, t, s);
+                    upchannelise(tt, s);
+                }
+                downsample(frame, sample, s);
+            }
+        });
+    });
+}
@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @brief FRB beamforming and upchannelisation on the CPU
+ *  - cpuBeamformUpchan : public cpuCommand
+ */
+
+#ifndef CPU_BEAMFORM_UPCHAN_H
+#define CPU_BEAMFORM_UPCHAN_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for int32_t, uint32_t, uint8_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/// The number of transforms done side by side, one in each SIMD lane
+#define FRB_LANES 8
+
+/// FRB_LANES doubles, one from each transform
+typedef double frb_vec_t __attribute__((vector_size(FRB_LANES * sizeof(double))));
+
+/**
+ * @class cpuBeamformUpchan
+ * @brief Forms the 1024 FRB beams, upchannelises and downsamples them, bit-compatible with
+ *        @c gpuBeamformSimulate.
+ *
+ * This does the work of @c hsaBeamformKernel, @c hsaBeamformTranspose and
+ * @c hsaBeamformUpchan in one pass. For each chunk of @c factor_upchan x
+ * @c downsample_time samples (one output sample) the reordered input is unpacked and
+ * multiplied by the conjugate of the gains, the N-S beams are formed with a 512 point FFT
+ * and clamped to the 256 beams of @c beamform_map (flipped N-S), the 4 E-W beams are
+ * formed with the phases of @c beamform_coeff_map, and each beam is upchannelised with a
+ * @c factor_upchan point FFT. The power of both polarizations is then summed over
+ * @c downsample_time samples and @c downsample_freq channels, divided by the bandpass and
+ * rolled by half the output channels, giving 1024 beams x samples x 16 freq.
+ *
+ * The chunks are split over the threads of the device, so only a few MB of beams per
+ * thread are stored. The FFTs work on 8 transforms at a time, one in each lane of a SIMD
+ * vector: the 2 polarizations x 4 cylinders of a sample for the N-S FFT, and 8 beams for
+ * the upchannelisation. They use the twiddle factors and butterflies of the radix-2 FFTs
+ * of @c gpuBeamformSimulate in double precision, skipping only the work which is known to
+ * give zeros or is clamped away, so the output is the same as that of the simulation.
+ *
+ * @par GPU Memory
+ * @gpu_mem  input_reordered     The reordered input data
+ *     @gpu_mem_type             static
+ *     @gpu_mem_format           Array of 4+4 bit complex samples, [time][pol][EW][NS]
+ * @gpu_mem  beamform_map        The FFT beam of each N-S beam, size 256
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of @c uint32
+ * @gpu_mem  beamform_coeff_map  The phases of the E-W beams, size 4 x 4 cylinders x 2
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of @c float (re, im) pairs
+ * @gpu_mem  beamform_gain       The gains, size 2048 x 2
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of @c float (re, im) pairs
+ * @gpu_mem  bf_output           The FRB beams
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of @c float, [beam][time][freq]
+ * @gpu_mem  frb_scratch         The beams of the chunks the threads work on
+ *     @gpu_mem_type             static
+ *     @gpu_mem_format           Array of @c double
+ *
+ * @conf   num_elements         Int. Number of elements, must be 2048.
+ * @conf   num_local_freq       Int. Number of local freq, must be 1.
+ * @conf   samples_per_data_set Int. Number of time samples in a data set, a multiple of
+ *                              @c factor_upchan x @c downsample_time.
+ * @conf   factor_upchan        Int. Upchannelisation factor, a power of 2.
+ * @conf   downsample_time      Int. Downsample factor in time.
+ * @conf   downsample_freq      Int. Downsample factor in freq, @c factor_upchan / 16.
+ * @conf   num_frb_total_beams  Int. Number of total FRB formed beams, must be 1024.
+ */
+class cpuBeamformUpchan : public cpuCommand {
+public:
+    cpuBeamformUpchan(kotekan::Config& config, const std::string& unique_name,
+                      kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformUpchan();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+protected:
+    /// Constructor for @c cpuBeamformUpchanHFB, which also outputs the hyper fine beams
+    cpuBeamformUpchan(kotekan::Config& config, const std::string& unique_name,
+                      kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device,
+                      const std::string& name, bool hfb);
+
+private:
+    /// The memory of a frame
+    struct frameData {
+        const uint8_t* input;
+        const uint32_t* map;
+        const float* coeff;
+        /// The gains of the 256 N-S feeds in each lane
+        const frb_vec_t* gain_re;
+        const frb_vec_t* gain_im;
+        float* output;
+        float* hfb_output;
+    };
+
+    /// The scratch memory of a thread
+    struct scratchData {
+        frb_vec_t* fft_re;
+        frb_vec_t* fft_im;
+        /// The clamped N-S beams, [pol x cylinder][N-S beam]
+        double* clamped_re;
+        double* clamped_im;
+        /// The beams of a chunk, [beam / FRB_LANES][time] with beam % FRB_LANES in the lanes
+        frb_vec_t* beams_re;
+        frb_vec_t* beams_im;
+        /// The power of each channel, [beam / FRB_LANES][time][freq][beam % FRB_LANES]
+        float* power;
+    };
+
+    /// Returns the scratch memory of thread @p thread in @p scratch
+    scratchData get_scratch(double* scratch, size_t thread) const;
+
+    /// Forms the N-S and E-W beams of a sample, and stores them at @p t of the beams
+    void beamform(const frameData& frame, const uint8_t* input, size_t t,
+                  const scratchData& scratch) const;
+
+    /// Upchannelises the beams and stores the power of each channel at time @p tt
+    void upchannelise(size_t tt, const scratchData& scratch) const;
+
+    /// Downsamples the power of output sample @p sample to the output
+    void downsample(const frameData& frame, size_t sample, const scratchData& scratch) const;
+
+    /// Whether to also output the hyper fine beams, see @c cpuBeamformUpchanHFB
+    const bool _hfb;
+
+    int32_t input_frame_len;
+    int32_t output_frame_len;
+    int32_t output_hfb_frame_len;
+    int32_t gain_len;
+    /// The doubles of scratch memory of a thread
+    size_t scratch_len;
+    /// The number of threads working on a frame
+    size_t num_workers;
+    /// The number of output samples
+    size_t num_samples_out;
+
+    /// The twiddle factors of the N-S FFT, at [step - 1 + index] for each step size
+    std::vector<double> ns_twiddle_re, ns_twiddle_im;
+    /// The twiddle factors of the upchannelisation FFT, at [step - 1 + index]
+    std::vector<double> upchan_twiddle_re, upchan_twiddle_im;
+    /// The bit reversal permutation of the non-zero half of the N-S FFT
+    std::vector<uint32_t> ns_reverse;
+    /// The bit reversal permutation of the upchannelisation FFT
+    std::vector<uint32_t> upchan_reverse;
+
+    int32_t _num_elements;
+    int32_t _samples_per_data_set;
+    int32_t _factor_upchan;
+    int32_t _downsample_time;
+    int32_t _downsample_freq;
+    int32_t _num_frb_total_beams;
+};
+
+#endif // CPU_BEAMFORM_UPCHAN_H
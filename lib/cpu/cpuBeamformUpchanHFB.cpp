@@ -0,0 +1,15 @@
+#include "cpuBeamformUpchanHFB.hpp"
+
+#include "cpuCommand.hpp" // for REGISTER_CPU_COMMAND
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuBeamformUpchanHFB);
+
+cpuBeamformUpchanHFB::cpuBeamformUpchanHFB(Config& config, const std::string& unique_name,
+                                           bufferContainer& host_buffers,
+                                           cpuDeviceInterface& device) :
+    cpuBeamformUpchan(config, unique_name, host_buffers, device, "cpuBeamformUpchanHFB", true) {}
+
+cpuBeamformUpchanHFB::~cpuBeamformUpchanHFB() {}
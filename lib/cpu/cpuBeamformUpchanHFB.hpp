@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @brief FRB beamforming and upchannelisation with the hyper fine beams on the CPU
+ *  - cpuBeamformUpchanHFB : public cpuBeamformUpchan
+ */
+
+#ifndef CPU_BEAMFORM_UPCHAN_HFB_H
+#define CPU_BEAMFORM_UPCHAN_HFB_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuBeamformUpchan.hpp"  // for cpuBeamformUpchan
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface
+
+#include <string> // for string
+
+/**
+ * @class cpuBeamformUpchanHFB
+ * @brief @c cpuBeamformUpchan which also outputs the hyper fine beams, like
+ *        @c hsaBeamformUpchanHFB.
+ *
+ * For each output sample the power of both polarizations of every upchannelised channel
+ * is summed over @c downsample_time samples and divided by their number, and the
+ * channels are rolled by half, for @c cpuBeamformHFBSum to add up.
+ *
+ * @par GPU Memory
+ * @gpu_mem  hfb_output  The hyper fine beams of each output sample
+ *     @gpu_mem_type     static
+ *     @gpu_mem_format   Array of @c float, [time][beam][freq]
+ */
+class cpuBeamformUpchanHFB : public cpuBeamformUpchan {
+public:
+    cpuBeamformUpchanHFB(kotekan::Config& config, const std::string& unique_name,
+                         kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuBeamformUpchanHFB();
+};
+
+#endif // CPU_BEAMFORM_UPCHAN_HFB_H
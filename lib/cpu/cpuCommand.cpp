@@ -0,0 +1,43 @@
+#include "cpuCommand.hpp"
+
+#include <utility> // for move
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+cpuCommand::cpuCommand(Config& config_, const std::string& unique_name_,
+                       bufferContainer& host_buffers_, cpuDeviceInterface& device_,
+                       const std::string& default_kernel_command,
+                       const std::string& default_kernel_file_name) :
+    gpuCommand(config_, unique_name_, host_buffers_, device_, default_kernel_command,
+               default_kernel_file_name),
+    events(_gpu_buffer_depth),
+    device(device_) {}
+
+cpuCommand::~cpuCommand() {}
+
+cpuEvent cpuCommand::enqueue(int gpu_frame_id, const cpuEvent& pre_event,
+                             std::function<void()> work) {
+    int stream_id;
+    switch (command_type) {
+        case gpuCommandType::COPY_IN:
+            stream_id = CPU_INPUT_STREAM;
+            break;
+        case gpuCommandType::COPY_OUT:
+            stream_id = CPU_OUTPUT_STREAM;
+            break;
+        default:
+            stream_id = CPU_COMPUTE_STREAM;
+            break;
+    }
+    events[gpu_frame_id] = device.enqueue(stream_id, pre_event, std::move(work));
+    return events[gpu_frame_id];
+}
+
+void cpuCommand::finalize_frame(int gpu_frame_id) {
+    if (events[gpu_frame_id]) {
+        record_execution(gpu_frame_id, events[gpu_frame_id]->start_time,
+                         events[gpu_frame_id]->end_time, false);
+        events[gpu_frame_id].reset();
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @brief Base class for commands of the CPU backend
+ *  - cpuCommand
+ */
+
+#ifndef CPU_COMMAND_H
+#define CPU_COMMAND_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuDeviceInterface.hpp" // for cpuEvent, cpuDeviceInterface
+#include "factory.hpp"            // for CREATE_FACTORY, Factory, REGISTER_NAMED_TYPE_WITH_FACTORY
+#include "gpuCommand.hpp"         // for gpuCommand
+
+#include <functional> // for function
+#include <string>     // for string
+#include <vector>     // for vector
+
+/**
+ * @class cpuCommand
+ * @brief Base class for commands of the CPU backend (@c cpuProcess).
+ *
+ * Commands queue their work on the stream matching their command type (copies in,
+ * kernels and barriers, or copies out) with @c enqueue, after the event of the command
+ * before them.  They should look up their memory in @c execute, not in the queued work.
+ */
+class cpuCommand : public gpuCommand {
+public:
+    /**
+     * @brief Base constructor
+     * @param config       The system config, passed by factory.
+     * @param unique_name  The stage + command name.
+     * @param host_buffers The list of bufferes handled by this GPU stage.
+     * @param device       The CPU device interface.
+     * @param default_kernel_command   Name of the command for profiling read out.
+     * @param default_kernel_file_name Not used by the CPU commands.
+     */
+    cpuCommand(kotekan::Config& config, const std::string& unique_name,
+               kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device,
+               const std::string& default_kernel_command = "",
+               const std::string& default_kernel_file_name = "");
+    virtual ~cpuCommand();
+
+    /**
+     * @brief Queues the work of the command for a frame.
+     * @param gpu_frame_id  The bufferID associated with the GPU commands.
+     * @param pre_event     The event of the command before, may be empty.
+     * @return The event of the completion of this command.
+     */
+    virtual cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) = 0;
+
+    /// Records the execution time and releases the event of a frame
+    virtual void finalize_frame(int gpu_frame_id) override;
+
+protected:
+    /// Queues @p work on the stream for this command type, and keeps its event
+    cpuEvent enqueue(int gpu_frame_id, const cpuEvent& pre_event, std::function<void()> work);
+
+    /// The event of each frame
+    std::vector<cpuEvent> events;
+
+    cpuDeviceInterface& device;
+};
+
+// Create a factory for cpuCommands
+CREATE_FACTORY(cpuCommand, // const std::string &, const std::string &,
+               kotekan::Config&, const std::string&, kotekan::bufferContainer&,
+               cpuDeviceInterface&);
+#define REGISTER_CPU_COMMAND(newCommand)                                                           \
+    REGISTER_NAMED_TYPE_WITH_FACTORY(cpuCommand, newCommand, #newCommand)
+
+#endif // CPU_COMMAND_H
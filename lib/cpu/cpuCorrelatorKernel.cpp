@@ -0,0 +1,311 @@
+#include "cpuCorrelatorKernel.hpp"
+
+#include "gpuCommand.hpp"     // for gpuCommandType, gpuCommandType::KERNEL
+#include "kotekanLogging.hpp" // for DEBUG2
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm> // for min
+#include <stdexcept> // for runtime_error
+
+#if defined(__AVX2__)
+#include <immintrin.h> // for __m512i, __m256i, _mm512_madd_epi16, _mm256_madd_epi16, _mm...
+#endif
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuCorrelatorKernel);
+
+// The number of samples unpacked and correlated at a time. The unpacked samples of a block
+// of elements should stay in the L2 cache.
+#define CORR_CHUNK_SAMPLES 512
+
+// The number of elements unpacked by one work item
+#define CORR_UNPACK_ELEMENTS 64
+
+// Vectors of 16 bit (real, imag) pairs, multiplied and summed pairwise into 32 bit lanes
+#if defined(__AVX512BW__)
+#define CORR_VEC_SAMPLES 16
+typedef __m512i corr_vec_t;
+
+static inline corr_vec_t corr_vec_zero() {
+    return _mm512_setzero_si512();
+}
+static inline corr_vec_t corr_vec_load(const int16_t* p) {
+    return _mm512_load_si512((const void*)p);
+}
+static inline corr_vec_t corr_vec_dot(corr_vec_t acc, corr_vec_t a, corr_vec_t b) {
+#if defined(__AVX512VNNI__)
+    return _mm512_dpwssd_epi32(acc, a, b);
+#else
+    return _mm512_add_epi32(acc, _mm512_madd_epi16(a, b));
+#endif
+}
+static inline int32_t corr_vec_sum(corr_vec_t v) {
+    // The AVX-512 reductions give (false) uninitialised warnings with GCC 12
+    alignas(64) int32_t lanes[16];
+    _mm512_store_si512((void*)lanes, v);
+    int32_t sum = 0;
+    for (int i = 0; i < 16; i++)
+        sum += lanes[i];
+    return sum;
+}
+#elif defined(__AVX2__)
+#define CORR_VEC_SAMPLES 8
+typedef __m256i corr_vec_t;
+
+static inline corr_vec_t corr_vec_zero() {
+    return _mm256_setzero_si256();
+}
+static inline corr_vec_t corr_vec_load(const int16_t* p) {
+    return _mm256_load_si256((const __m256i*)p);
+}
+static inline corr_vec_t corr_vec_dot(corr_vec_t acc, corr_vec_t a, corr_vec_t b) {
+#if defined(__AVXVNNI__)
+    return _mm256_dpwssd_avx_epi32(acc, a, b);
+#else
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+#endif
+}
+static inline int32_t corr_vec_sum(corr_vec_t v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+    return _mm_cvtsi128_si32(s);
+}
+#else
+// Plain C++ the compiler can vectorise
+#define CORR_VEC_SAMPLES 4
+struct corr_vec_t {
+    int32_t v[2 * CORR_VEC_SAMPLES];
+};
+
+static inline corr_vec_t corr_vec_zero() {
+    return corr_vec_t{};
+}
+static inline corr_vec_t corr_vec_load(const int16_t* p) {
+    corr_vec_t r;
+    for (int i = 0; i < 2 * CORR_VEC_SAMPLES; i++)
+        r.v[i] = p[i];
+    return r;
+}
+static inline corr_vec_t corr_vec_dot(corr_vec_t acc, corr_vec_t a, corr_vec_t b) {
+    for (int i = 0; i < 2 * CORR_VEC_SAMPLES; i++)
+        acc.v[i] += a.v[i] * b.v[i];
+    return acc;
+}
+static inline int32_t corr_vec_sum(corr_vec_t v) {
+    int32_t sum = 0;
+    for (int i = 0; i < 2 * CORR_VEC_SAMPLES; i++)
+        sum += v.v[i];
+    return sum;
+}
+#endif
+
+static_assert(CORR_CHUNK_SAMPLES % CORR_VEC_SAMPLES == 0,
+              "The chunks must be a whole number of vectors");
+
+#define CORR_CHUNK_VECS (CORR_CHUNK_SAMPLES / CORR_VEC_SAMPLES)
+
+cpuCorrelatorKernel::cpuCorrelatorKernel(Config& config, const std::string& unique_name,
+                                         bufferContainer& host_buffers,
+                                         cpuDeviceInterface& device) :
+    cpuSubframeCommand(config, unique_name, host_buffers, device, "cpuCorrelatorKernel") {
+    command_type = gpuCommandType::KERNEL;
+
+    _num_elements = config.get<int32_t>(unique_name, "num_elements");
+    _num_local_freq = config.get<int32_t>(unique_name, "num_local_freq");
+    _samples_per_data_set = config.get<int32_t>(unique_name, "samples_per_data_set");
+    _block_size = config.get<int32_t>(unique_name, "block_size");
+
+    if (_block_size % 2 != 0 || _num_elements % _block_size != 0) {
+        throw std::runtime_error(fmt::format(
+            fmt("The block size ({:d}) must be even and divide the number of elements ({:d})"),
+            _block_size, _num_elements));
+    }
+
+    _num_blocks = (_num_elements / _block_size) * (_num_elements / _block_size + 1) / 2;
+    input_frame_len = _num_elements * _num_local_freq * _samples_per_data_set;
+    corr_frame_len =
+        _num_local_freq * _num_blocks * _block_size * _block_size * 2 * sizeof(int32_t);
+    // (re, im) and (-im, re) of each sample
+    unpacked_len = 2 * _num_local_freq * _num_elements * CORR_CHUNK_SAMPLES * 2 * sizeof(int16_t);
+
+    // The geometries with a specialised kernel, 0 matching any value
+    const struct {
+        int32_t num_elements;
+        int32_t block_size;
+        correlate_block_fn chunk;
+        correlate_block_fn partial_chunk;
+    } plans[] = {
+#define CORR_PLAN(n, b)                                                                            \
+    {n, b, &cpuCorrelatorKernel::correlate_block<n, b, CORR_CHUNK_VECS>,                          \
+     &cpuCorrelatorKernel::correlate_block<n, b, 0>}
+        CORR_PLAN(2048, 32), // CHIME
+        CORR_PLAN(256, 32),  // Pathfinder
+        CORR_PLAN(0, 32),
+        CORR_PLAN(0, 0),
+#undef CORR_PLAN
+    };
+    const bool specialise = config.get_default<bool>(unique_name, "use_specialised_kernel", true);
+    for (auto& plan : plans) {
+        if ((plan.num_elements == 0 || plan.num_elements == _num_elements)
+            && (plan.block_size == 0 || plan.block_size == _block_size)
+            && (specialise || plan.block_size == 0)) {
+            DEBUG("Using the kernel for {:d} elements and blocks of {:d} (0 is any)",
+                  plan.num_elements, plan.block_size);
+            correlate_chunk = plan.chunk;
+            correlate_partial_chunk = plan.partial_chunk;
+            break;
+        }
+    }
+
+    block_map.resize(2 * _num_blocks);
+    int block_id = 0;
+    for (int y = 0; block_id < _num_blocks; y++) {
+        for (int x = y; x < _num_elements / _block_size; x++) {
+            block_map[2 * block_id + 0] = x;
+            block_map[2 * block_id + 1] = y;
+            block_id++;
+        }
+    }
+
+    // pre-allocate GPU memory
+    device.get_gpu_memory_array("input", 0, input_frame_len);
+    device.get_gpu_memory_array(fmt::format(fmt("corr_{:d}"), _sub_frame_index), 0,
+                                corr_frame_len);
+    // The kernels run one at a time, so all sub-frames can share this
+    device.get_gpu_memory("corr_unpacked", unpacked_len);
+}
+
+cpuCorrelatorKernel::~cpuCorrelatorKernel() {}
+
+cpuEvent cpuCorrelatorKernel::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const size_t num_inputs = _num_elements * _num_local_freq;
+    const size_t num_samples = _sub_frame_samples;
+
+    // Index into the sub frame.
+    const uint8_t* input =
+        (uint8_t*)device.get_gpu_memory_array("input", gpu_frame_id, input_frame_len)
+        + num_inputs * num_samples * _sub_frame_index;
+    int32_t* corr = (int32_t*)device.get_gpu_memory_array(
+        fmt::format(fmt("corr_{:d}"), _sub_frame_index), gpu_frame_id, corr_frame_len);
+    int16_t* unpacked = (int16_t*)device.get_gpu_memory("corr_unpacked", unpacked_len);
+
+    DEBUG2("correlatorKernel: cpu[{:d}][{:d}], input: {:p}, corr: {:p}", device.get_gpu_id(),
+           gpu_frame_id, (void*)input, (void*)corr);
+
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        const size_t num_unpack_items =
+            (_num_elements + CORR_UNPACK_ELEMENTS - 1) / CORR_UNPACK_ELEMENTS;
+        for (size_t t = 0; t < num_samples; t += CORR_CHUNK_SAMPLES) {
+            const size_t chunk_samples = std::min<size_t>(CORR_CHUNK_SAMPLES, num_samples - t);
+            const uint8_t* chunk = input + t * num_inputs;
+
+            dev.parallel_for(num_unpack_items, [=](size_t i) {
+                const size_t e_start = i * CORR_UNPACK_ELEMENTS;
+                const size_t e_end = std::min<size_t>(e_start + CORR_UNPACK_ELEMENTS,
+                                                      _num_elements);
+                unpack(chunk, chunk_samples, e_start, e_end, unpacked);
+            });
+
+            const correlate_block_fn correlate =
+                chunk_samples == CORR_CHUNK_SAMPLES ? correlate_chunk : correlate_partial_chunk;
+            dev.parallel_for(_num_local_freq * _num_blocks, [=](size_t i) {
+                (this->*correlate)(unpacked, chunk_samples, i / _num_blocks, i % _num_blocks,
+                                   corr);
+            });
+        }
+    });
+}
+
+void cpuCorrelatorKernel::unpack(const uint8_t* input, size_t num_samples, size_t e_start,
+                                 size_t e_end, int16_t* unpacked) const {
+    // The rows are padded with zeros to a whole number of vectors
+    const size_t padded_samples =
+        (num_samples + CORR_VEC_SAMPLES - 1) / CORR_VEC_SAMPLES * CORR_VEC_SAMPLES;
+    const size_t row_len = CORR_CHUNK_SAMPLES * 2;
+    int16_t* unpacked_conj = unpacked + _num_local_freq * _num_elements * row_len;
+
+    for (int32_t f = 0; f < _num_local_freq; f++) {
+        for (size_t t = 0; t < padded_samples; t++) {
+            const uint8_t* sample = input + (t * _num_local_freq + f) * _num_elements;
+            for (size_t e = e_start; e < e_end; e++) {
+                const size_t ix = ((f * _num_elements + e) * row_len) + 2 * t;
+                int16_t re = 0, im = 0;
+                if (t < num_samples) {
+                    im = (int16_t)(sample[e] & 0x0f) - 8;
+                    re = (int16_t)(sample[e] >> 4) - 8;
+                }
+                unpacked[ix + 0] = re;
+                unpacked[ix + 1] = im;
+                unpacked_conj[ix + 0] = -im;
+                unpacked_conj[ix + 1] = re;
+            }
+        }
+    }
+}
+
+template<int32_t NUM_ELEMENTS, int32_t BLOCK_SIZE, size_t NUM_VECS>
+void cpuCorrelatorKernel::correlate_block(const int16_t* unpacked, size_t num_samples, size_t f,
+                                          size_t b, int32_t* corr) const {
+    const size_t num_elements = NUM_ELEMENTS ? NUM_ELEMENTS : _num_elements;
+    const int32_t block_size = BLOCK_SIZE ? BLOCK_SIZE : _block_size;
+    const size_t row_len = CORR_CHUNK_SAMPLES * 2;
+    const size_t num_vecs =
+        NUM_VECS ? NUM_VECS : (num_samples + CORR_VEC_SAMPLES - 1) / CORR_VEC_SAMPLES;
+    const int16_t* unpacked_conj = unpacked + _num_local_freq * num_elements * row_len;
+
+    const int16_t* x_rows =
+        unpacked + (f * num_elements + block_map[2 * b + 0] * block_size) * row_len;
+    const size_t y_offset = (f * num_elements + block_map[2 * b + 1] * block_size) * row_len;
+    const int16_t* y_rows = unpacked + y_offset;
+    const int16_t* y_rows_conj = unpacked_conj + y_offset;
+    int32_t* out = corr + (f * _num_blocks + b) * block_size * block_size * 2;
+
+    // 2x2 tiles of the block, the real part is x . y and the imaginary part x . (i y)*
+    for (int32_t y = 0; y < block_size; y += 2) {
+        for (int32_t x = 0; x < block_size; x += 2) {
+            const int16_t* x0 = x_rows + x * row_len;
+            const int16_t* x1 = x0 + row_len;
+            const int16_t* y0 = y_rows + y * row_len;
+            const int16_t* y1 = y0 + row_len;
+            const int16_t* yc0 = y_rows_conj + y * row_len;
+            const int16_t* yc1 = yc0 + row_len;
+
+            corr_vec_t re00 = corr_vec_zero(), re01 = corr_vec_zero();
+            corr_vec_t re10 = corr_vec_zero(), re11 = corr_vec_zero();
+            corr_vec_t im00 = corr_vec_zero(), im01 = corr_vec_zero();
+            corr_vec_t im10 = corr_vec_zero(), im11 = corr_vec_zero();
+            for (size_t v = 0; v < num_vecs; v++) {
+                const size_t i = v * 2 * CORR_VEC_SAMPLES;
+                const corr_vec_t a0 = corr_vec_load(x0 + i), a1 = corr_vec_load(x1 + i);
+                const corr_vec_t b0 = corr_vec_load(y0 + i), b1 = corr_vec_load(y1 + i);
+                const corr_vec_t c0 = corr_vec_load(yc0 + i), c1 = corr_vec_load(yc1 + i);
+                re00 = corr_vec_dot(re00, a0, b0);
+                re10 = corr_vec_dot(re10, a1, b0);
+                re01 = corr_vec_dot(re01, a0, b1);
+                re11 = corr_vec_dot(re11, a1, b1);
+                im00 = corr_vec_dot(im00, a0, c0);
+                im10 = corr_vec_dot(im10, a1, c0);
+                im01 = corr_vec_dot(im01, a0, c1);
+                im11 = corr_vec_dot(im11, a1, c1);
+            }
+
+            int32_t* o00 = out + (y * block_size + x) * 2;
+            int32_t* o01 = o00 + block_size * 2;
+            o00[0] += corr_vec_sum(im00);
+            o00[1] += corr_vec_sum(re00);
+            o00[2] += corr_vec_sum(im10);
+            o00[3] += corr_vec_sum(re10);
+            o01[0] += corr_vec_sum(im01);
+            o01[1] += corr_vec_sum(re01);
+            o01[2] += corr_vec_sum(im11);
+            o01[3] += corr_vec_sum(re11);
+        }
+    }
+}
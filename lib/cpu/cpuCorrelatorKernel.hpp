@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief N² correlator of 4+4 bit data on the CPU
+ *  - cpuCorrelatorKernel : public cpuSubframeCommand
+ */
+
+#ifndef CPU_CORRELATOR_KERNEL_H
+#define CPU_CORRELATOR_KERNEL_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "cpuSubframeCommand.hpp" // for cpuSubframeCommand
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for int32_t, int16_t, uint32_t, uint8_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @class cpuCorrelatorKernel
+ * @brief Correlates the 4+4 bit offset encoded input of a sub-frame into blocks of the
+ *        correlation matrix, in the same layout as @c hsaCorrelatorKernel.
+ *
+ * The output of each frequency is the upper triangle of the correlation matrix in blocks of
+ * @c block_size x @c block_size, the blocks ordered by row, each as @c int32 (imag, real)
+ * pairs indexed by [y][x]. The results are added to the @c corr memory, which
+ * @c cpuOutputDataZero zeroes, and are bit-exact with the "4+4b" format of @c gpuSimulate.
+ * The offset encoding is removed while unpacking, so unlike the GPU kernel this doesn't
+ * need the @c presum memory.
+ *
+ * The samples are processed in chunks which are unpacked to 16 bit (real, imag) pairs for
+ * each element, so each block is a small integer matrix product done with AVX-512 or AVX2
+ * (using VNNI if the compiler targets it). The unpacking and the blocks of each
+ * frequency are split over the threads of the device.
+ *
+ * The blocks are correlated by a kernel compiled for the geometry when there is one, with
+ * the number of elements, the block size and the number of vectors of a chunk known at compile
+ * time so the compiler can unroll the loops and fold the indexing. These are the CHIME (2048
+ * elements) and pathfinder (256 elements) arrays with 32 x 32 blocks, and any array with 32 x 32
+ * blocks. Other geometries use the generic kernel.
+ *
+ * @par GPU Memory
+ * @gpu_mem  input  The input data
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of 4+4 bit complex samples, [time][freq][element]
+ * @gpu_mem  corr_{sub_frame_index}  The correlation matrix blocks
+ *     @gpu_mem_type         static
+ *     @gpu_mem_format       Array of @c int32 (imag, real) pairs
+ * @gpu_mem  corr_unpacked  The unpacked samples of a chunk
+ *     @gpu_mem_type         static
+ *     @gpu_mem_format       Array of @c int16 pairs
+ *
+ * @conf num_elements          Int. The number of elements.
+ * @conf num_local_freq        Int. The number of frequencies in a frame.
+ * @conf samples_per_data_set  Int. The number of time samples in a frame.
+ * @conf block_size            Int. The size of the correlation matrix blocks (even).
+ * @conf use_specialised_kernel  Bool, default true. Use the kernel compiled for the geometry,
+ *                               if there is one.
+ */
+class cpuCorrelatorKernel : public cpuSubframeCommand {
+public:
+    cpuCorrelatorKernel(kotekan::Config& config, const std::string& unique_name,
+                        kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuCorrelatorKernel();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    /// Unpacks @p num_samples samples of elements [@p e_start, @p e_end) of all frequencies
+    void unpack(const uint8_t* input, size_t num_samples, size_t e_start, size_t e_end,
+                int16_t* unpacked) const;
+
+    /**
+     * @brief Adds the products of a chunk of @p num_samples samples to block @p b of frequency
+     *        @p f. The non-zero template arguments fix the geometry at compile time.
+     * @tparam NUM_ELEMENTS  The number of elements, or 0 for @c _num_elements.
+     * @tparam BLOCK_SIZE    The block size, or 0 for @c _block_size.
+     * @tparam NUM_VECS      The number of vectors in the chunk, or 0 for any @p num_samples.
+     */
+    template<int32_t NUM_ELEMENTS, int32_t BLOCK_SIZE, size_t NUM_VECS>
+    void correlate_block(const int16_t* unpacked, size_t num_samples, size_t f, size_t b,
+                         int32_t* corr) const;
+
+    typedef void (cpuCorrelatorKernel::*correlate_block_fn)(const int16_t*, size_t, size_t,
+                                                             size_t, int32_t*) const;
+
+    /// The variants of correlate_block used for whole chunks and for a last partial chunk
+    correlate_block_fn correlate_chunk;
+    correlate_block_fn correlate_partial_chunk;
+
+    int32_t input_frame_len;
+    int32_t corr_frame_len;
+    int32_t unpacked_len;
+
+    /// The (x, y) block indices of each block
+    std::vector<uint32_t> block_map;
+
+    int32_t _num_elements;
+    int32_t _num_local_freq;
+    int32_t _samples_per_data_set;
+    int32_t _block_size;
+    int32_t _num_blocks;
+};
+
+#endif // CPU_CORRELATOR_KERNEL_H
@@ -0,0 +1,173 @@
+#include "cpuDeviceInterface.hpp"
+
+#include "kotekanLogging.hpp" // for INFO, FATAL_ERROR
+#include "util.h"             // for e_time
+
+#include <algorithm>  // for max
+#include <exception>  // for exception
+#include <functional> // for ref
+#include <stdlib.h>   // for free, posix_memalign
+#include <string.h>   // for memcpy
+#include <utility>    // for move
+
+using kotekan::Config;
+
+cpuDeviceInterface::cpuDeviceInterface(Config& config_, int32_t gpu_id_, int gpu_buffer_depth_,
+                                       uint32_t num_threads) :
+    gpuDeviceInterface(config_, gpu_id_, gpu_buffer_depth_),
+    next_item(0) {
+
+    if (num_threads == 0)
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    INFO("Running the commands of CPU \"GPU\" {:d} on {:d} threads.", gpu_id, num_threads);
+
+    for (auto& s : streams)
+        s.thread = std::thread(&cpuDeviceInterface::stream_thread, this, std::ref(s));
+    // The thread calling parallel_for also does some of the work
+    for (uint32_t i = 1; i < num_threads; i++)
+        workers.emplace_back(&cpuDeviceInterface::worker_thread, this);
+}
+
+cpuDeviceInterface::~cpuDeviceInterface() {
+    // Finish the work which is already queued
+    for (auto& s : streams) {
+        {
+            std::lock_guard<std::mutex> lock(s.mtx);
+            s.stop = true;
+        }
+        s.cond.notify_all();
+        s.thread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool_mtx);
+        stop_workers = true;
+    }
+    pool_cond.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+
+    cleanup_memory();
+}
+
+void* cpuDeviceInterface::alloc_gpu_memory(int len) {
+    void* ret;
+    if (posix_memalign(&ret, 64, len) != 0) {
+        FATAL_ERROR("Failed to allocate {:d} bytes of CPU \"GPU\" memory.", len);
+        return nullptr;
+    }
+    return ret;
+}
+
+void cpuDeviceInterface::free_gpu_memory(void* ptr) {
+    free(ptr);
+}
+
+cpuEvent cpuDeviceInterface::enqueue(int stream_id, const cpuEvent& pre_event,
+                                     std::function<void()> work) {
+    stream& s = streams[stream_id];
+
+    streamTask task;
+    task.pre_event = pre_event;
+    task.work = std::move(work);
+    task.event = std::make_shared<cpuSignal>();
+    task.event->done = task.promise.get_future().share();
+    cpuEvent event = task.event;
+
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        s.tasks.push_back(std::move(task));
+    }
+    s.cond.notify_one();
+
+    return event;
+}
+
+void cpuDeviceInterface::stream_thread(stream& s) {
+    while (true) {
+        streamTask task;
+        {
+            std::unique_lock<std::mutex> lock(s.mtx);
+            s.cond.wait(lock, [&s]() { return s.stop || !s.tasks.empty(); });
+            if (s.tasks.empty())
+                return;
+            task = std::move(s.tasks.front());
+            s.tasks.pop_front();
+        }
+
+        if (task.pre_event)
+            task.pre_event->done.wait();
+        // Don't keep the events of earlier work alive
+        task.pre_event.reset();
+
+        task.event->start_time = e_time();
+        try {
+            task.work();
+        } catch (std::exception& e) {
+            FATAL_ERROR("Failure in a CPU \"GPU\" command: {:s}", e.what());
+        }
+        task.event->end_time = e_time();
+        task.promise.set_value();
+    }
+}
+
+cpuEvent cpuDeviceInterface::async_copy_host_to_gpu(void* dst, void* src, size_t len,
+                                                    const cpuEvent& pre_event) {
+    return enqueue(CPU_INPUT_STREAM, pre_event, [=]() { memcpy(dst, src, len); });
+}
+
+cpuEvent cpuDeviceInterface::async_copy_gpu_to_host(void* dst, void* src, size_t len,
+                                                    const cpuEvent& pre_event) {
+    return enqueue(CPU_OUTPUT_STREAM, pre_event, [=]() { memcpy(dst, src, len); });
+}
+
+void cpuDeviceInterface::parallel_for(size_t n, const std::function<void(size_t)>& fn) {
+    if (workers.empty() || n <= 1) {
+        for (size_t i = 0; i < n; i++)
+            fn(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> job_lock(job_mtx);
+    {
+        std::lock_guard<std::mutex> lock(pool_mtx);
+        job = &fn;
+        job_size = n;
+        next_item = 0;
+        busy_workers = workers.size();
+        job_count++;
+    }
+    pool_cond.notify_all();
+
+    run_job(fn, n);
+
+    // All workers have to be done with this job before the next one can start
+    std::unique_lock<std::mutex> lock(pool_mtx);
+    done_cond.wait(lock, [this]() { return busy_workers == 0; });
+    job = nullptr;
+}
+
+void cpuDeviceInterface::worker_thread() {
+    uint64_t jobs_done = 0;
+    std::unique_lock<std::mutex> lock(pool_mtx);
+    while (true) {
+        pool_cond.wait(lock, [&]() { return stop_workers || job_count != jobs_done; });
+        if (stop_workers)
+            return;
+        jobs_done = job_count;
+        const std::function<void(size_t)>& fn = *job;
+        size_t n = job_size;
+
+        lock.unlock();
+        run_job(fn, n);
+        lock.lock();
+
+        if (--busy_workers == 0)
+            done_cond.notify_all();
+    }
+}
+
+void cpuDeviceInterface::run_job(const std::function<void(size_t)>& fn, size_t n) {
+    size_t i;
+    while ((i = next_item++) < n)
+        fn(i);
+}
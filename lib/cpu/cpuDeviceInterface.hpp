@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @brief Class to run GPU framework commands on the host CPU
+ *  - cpuDeviceInterface
+ */
+
+#ifndef CPU_DEVICE_INTERFACE_H
+#define CPU_DEVICE_INTERFACE_H
+
+#include "Config.hpp"             // for Config
+#include "gpuDeviceInterface.hpp" // for gpuDeviceInterface
+
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <deque>              // for deque
+#include <functional>         // for function
+#include <future>             // for promise, shared_future
+#include <memory>             // for shared_ptr
+#include <mutex>              // for mutex
+#include <stddef.h>           // for size_t
+#include <stdint.h>           // for uint32_t, int32_t, uint64_t
+#include <thread>             // for thread
+#include <vector>             // for vector
+
+// Like the CUDA backend there is one queue for copies in, one for kernels and one for
+// copies out, so the three can overlap across the GPU frames.
+#define CPU_NUM_STREAMS 3
+#define CPU_INPUT_STREAM 0
+#define CPU_COMPUTE_STREAM 1
+#define CPU_OUTPUT_STREAM 2
+
+/// The completion of some work queued on a stream, and when it ran.
+struct cpuSignal {
+    std::shared_future<void> done;
+    /// Start and end time of the work (set once @c done is ready)
+    double start_time = 0;
+    double end_time = 0;
+};
+
+/// The event type of the CPU backend, an empty pointer is an event which already happened.
+using cpuEvent = std::shared_ptr<cpuSignal>;
+
+/**
+ * @class cpuDeviceInterface
+ * @brief Runs the GPU framework on the host: "GPU memory" is host memory, and the commands
+ *        run on threads.
+ *
+ * Each stream is a thread running the work queued on it in order, after the event it
+ * depends on. As events only ever depend on work queued earlier this can't deadlock.
+ * Kernels can split their work over a pool of threads with @c parallel_for.
+ *
+ * @par GPU Memory
+ * "GPU memory" is 64 byte aligned host memory.
+ */
+class cpuDeviceInterface final : public gpuDeviceInterface {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param config            The kotekan config.
+     * @param gpu_id            The (virtual) GPU ID.
+     * @param gpu_buffer_depth  The number of frames of each GPU memory array.
+     * @param num_threads       The number of threads to run the kernels on (0 for one per core).
+     */
+    cpuDeviceInterface(kotekan::Config& config, int32_t gpu_id, int gpu_buffer_depth,
+                       uint32_t num_threads);
+    ~cpuDeviceInterface();
+
+    /**
+     * @brief Queues work on a stream.
+     *
+     * @param stream_id  The stream (CPU_INPUT_STREAM, CPU_COMPUTE_STREAM, CPU_OUTPUT_STREAM).
+     * @param pre_event  The event to wait for before starting, may be empty.
+     * @param work       The work to do.
+     *
+     * @return The event of the completion of the work.
+     */
+    cpuEvent enqueue(int stream_id, const cpuEvent& pre_event, std::function<void()> work);
+
+    /**
+     * @brief Asynchronous copies memory from the host to the device (which is also the host).
+     *
+     * @param dst        The "GPU" memory pointer
+     * @param src        The CPU memory pointer
+     * @param len        The amount of data to copy in bytes
+     * @param pre_event  The event before this one to wait on, may be empty.
+     *
+     * @return The event at the end of the copy.
+     */
+    cpuEvent async_copy_host_to_gpu(void* dst, void* src, size_t len, const cpuEvent& pre_event);
+
+    /**
+     * @brief Asynchronous copies memory from the device (which is also the host) to the host.
+     *
+     * @param dst        The CPU memory pointer
+     * @param src        The "GPU" memory pointer
+     * @param len        The amount of data to copy in bytes
+     * @param pre_event  The event before this one to wait on, may be empty.
+     *
+     * @return The event at the end of the copy.
+     */
+    cpuEvent async_copy_gpu_to_host(void* dst, void* src, size_t len, const cpuEvent& pre_event);
+
+    /**
+     * @brief Calls @p fn for each index in [0, n) on the thread pool, and waits for them.
+     *
+     * Work from different streams is run one after another, not interleaved.
+     *
+     * @param n   The number of work items.
+     * @param fn  The function doing work item @c i.
+     */
+    void parallel_for(size_t n, const std::function<void(size_t)>& fn);
+
+    /// The number of threads running the work of a @c parallel_for
+    uint32_t get_num_threads() const {
+        return workers.size() + 1;
+    }
+
+protected:
+    void* alloc_gpu_memory(int len) override;
+    void free_gpu_memory(void*) override;
+
+private:
+    /// A piece of work on a stream
+    struct streamTask {
+        cpuEvent pre_event;
+        std::function<void()> work;
+        std::promise<void> promise;
+        cpuEvent event;
+    };
+
+    /// A queue of work and the thread running it
+    struct stream {
+        std::thread thread;
+        std::deque<streamTask> tasks;
+        std::mutex mtx;
+        std::condition_variable cond;
+        bool stop = false;
+    };
+
+    /// Runs the work on a stream
+    void stream_thread(stream& s);
+
+    /// Runs the work of the pool
+    void worker_thread();
+
+    /// Runs work items of the current @c parallel_for until there are none left
+    void run_job(const std::function<void(size_t)>& fn, size_t n);
+
+    stream streams[CPU_NUM_STREAMS];
+
+    std::vector<std::thread> workers;
+
+    /// Only one @c parallel_for at a time
+    std::mutex job_mtx;
+
+    /// The current @c parallel_for, guarded by @c pool_mtx
+    std::mutex pool_mtx;
+    std::condition_variable pool_cond, done_cond;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t job_size = 0;
+    uint64_t job_count = 0;
+    size_t busy_workers = 0;
+    bool stop_workers = false;
+
+    /// The next work item of the current @c parallel_for
+    std::atomic<size_t> next_item;
+};
+
+#endif // CPU_DEVICE_INTERFACE_H
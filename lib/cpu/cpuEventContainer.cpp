@@ -0,0 +1,18 @@
+#include "cpuEventContainer.hpp"
+
+void cpuEventContainer::set(void* sig) {
+    signal = *(cpuEvent*)sig;
+}
+
+void* cpuEventContainer::get() {
+    return &signal;
+}
+
+void cpuEventContainer::unset() {
+    signal.reset();
+}
+
+void cpuEventContainer::wait() {
+    if (signal)
+        signal->done.wait();
+}
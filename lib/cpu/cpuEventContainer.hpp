@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Event container of the CPU backend
+ *  - cpuEventContainer
+ */
+
+#ifndef CPU_EVENT_CONTAINER_H
+#define CPU_EVENT_CONTAINER_H
+
+#include "cpuDeviceInterface.hpp" // for cpuEvent
+#include "gpuEventContainer.hpp"  // for gpuEventContainer
+
+/**
+ * @class cpuEventContainer
+ * @brief Holds the @c cpuEvent (a future) of the last command of a GPU frame.
+ */
+class cpuEventContainer final : public gpuEventContainer {
+
+public:
+    void set(void* sig) override;
+    void* get() override;
+    void unset() override;
+    void wait() override;
+
+private:
+    cpuEvent signal;
+};
+
+#endif // CPU_EVENT_CONTAINER_H
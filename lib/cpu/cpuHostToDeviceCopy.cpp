@@ -0,0 +1,61 @@
+#include "cpuHostToDeviceCopy.hpp"
+
+#include "gpuCommand.hpp"     // for gpuCommandType, gpuCommandType::COPY_IN
+#include "kotekanLogging.hpp" // for DEBUG2
+
+#include <stdint.h> // for uint8_t
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuHostToDeviceCopy);
+
+cpuHostToDeviceCopy::cpuHostToDeviceCopy(Config& config, const std::string& unique_name,
+                                         bufferContainer& host_buffers,
+                                         cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuHostToDeviceCopy"),
+    in_buf(host_buffers.get_buffer(config.get<std::string>(unique_name, "in_buf"))),
+    in_buf_id(in_buf),
+    in_buf_precondition_id(in_buf),
+    in_buf_finalize_id(in_buf),
+    _gpu_memory_name(config.get<std::string>(unique_name, "gpu_memory_name")) {
+    command_type = gpuCommandType::COPY_IN;
+
+    register_consumer(in_buf, unique_name.c_str());
+}
+
+cpuHostToDeviceCopy::~cpuHostToDeviceCopy() {}
+
+int cpuHostToDeviceCopy::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+
+    uint8_t* frame = wait_for_full_frame(in_buf, unique_name.c_str(), in_buf_precondition_id);
+    if (frame == nullptr)
+        return -1;
+    in_buf_precondition_id++;
+
+    return 0;
+}
+
+cpuEvent cpuHostToDeviceCopy::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    void* gpu_memory_frame =
+        device.get_gpu_memory_array(_gpu_memory_name, gpu_frame_id, in_buf->frame_size);
+    void* host_memory_frame = (void*)in_buf->frames[(int)in_buf_id];
+
+    DEBUG2("Copy data to GPU frame name: {} from buffer: {}", _gpu_memory_name,
+           in_buf->buffer_name);
+
+    events[gpu_frame_id] = device.async_copy_host_to_gpu(gpu_memory_frame, host_memory_frame,
+                                                         in_buf->frame_size, pre_event);
+    in_buf_id++;
+
+    return events[gpu_frame_id];
+}
+
+void cpuHostToDeviceCopy::finalize_frame(int frame_id) {
+    cpuCommand::finalize_frame(frame_id);
+    mark_frame_empty(in_buf, unique_name.c_str(), in_buf_finalize_id);
+    in_buf_finalize_id++;
+}
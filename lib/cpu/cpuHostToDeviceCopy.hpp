@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @brief Copy of a host buffer to GPU memory on the CPU
+ *  - cpuHostToDeviceCopy : public cpuCommand
+ */
+
+#ifndef CPU_HOST_TO_DEVICE_COPY_H
+#define CPU_HOST_TO_DEVICE_COPY_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "visUtil.hpp"            // for frameID
+
+#include <string> // for string
+
+/**
+ * @class cpuHostToDeviceCopy
+ * @brief Copies each frame of a host buffer to GPU memory, like @c hsaHostToDeviceCopy.
+ *
+ * @par Buffers
+ * @buffer in_buf  The host buffer to copy.
+ *     @buffer_format any
+ *     @buffer_metadata any
+ *
+ * @par GPU Memory
+ * @gpu_mem  Data of @c in_buf with name @c gpu_memory_name
+ *     @gpu_mem_type         staging
+ *
+ * @conf gpu_memory_name  String. The name of the GPU memory.
+ */
+class cpuHostToDeviceCopy : public cpuCommand {
+public:
+    cpuHostToDeviceCopy(kotekan::Config& config, const std::string& unique_name,
+                        kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuHostToDeviceCopy();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    Buffer* in_buf;
+
+    frameID in_buf_id;
+    frameID in_buf_precondition_id;
+    frameID in_buf_finalize_id;
+
+    std::string _gpu_memory_name;
+};
+
+#endif // CPU_HOST_TO_DEVICE_COPY_H
@@ -0,0 +1,65 @@
+#include "cpuInputData.hpp"
+
+#include "buffer.h" // for Buffer, mark_frame_empty, register_consumer, wait_for_full_frame
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuInputData);
+
+cpuInputData::cpuInputData(Config& config, const std::string& unique_name,
+                           bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuInputData") {
+    command_type = gpuCommandType::COPY_IN;
+
+    int header_size = 0;
+    int32_t num_elements = config.get<int32_t>(unique_name, "num_elements");
+    int32_t num_local_freq = config.get<int32_t>(unique_name, "num_local_freq");
+    int32_t samples_per_data_set = config.get<int32_t>(unique_name, "samples_per_data_set");
+    // Same as hsaInputData, VDIF input has a header for each time sample
+    if (num_elements <= 2)
+        header_size = 32;
+    input_frame_len = (num_elements * (num_local_freq + header_size)) * samples_per_data_set;
+
+    network_buf = host_buffers.get_buffer("network_buf");
+    register_consumer(network_buf, unique_name.c_str());
+    network_buffer_id = 0;
+    network_buffer_precondition_id = 0;
+    network_buffer_finalize_id = 0;
+}
+
+cpuInputData::~cpuInputData() {}
+
+int cpuInputData::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+
+    // Wait for there to be data in the input (network) buffer.
+    uint8_t* frame =
+        wait_for_full_frame(network_buf, unique_name.c_str(), network_buffer_precondition_id);
+    if (frame == nullptr)
+        return -1;
+
+    network_buffer_precondition_id = (network_buffer_precondition_id + 1) % network_buf->num_frames;
+    return 0;
+}
+
+cpuEvent cpuInputData::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    void* gpu_memory_frame = device.get_gpu_memory_array("input", gpu_frame_id, input_frame_len);
+    void* host_memory_frame = (void*)network_buf->frames[network_buffer_id];
+
+    events[gpu_frame_id] =
+        device.async_copy_host_to_gpu(gpu_memory_frame, host_memory_frame, input_frame_len,
+                                      pre_event);
+
+    network_buffer_id = (network_buffer_id + 1) % network_buf->num_frames;
+
+    return events[gpu_frame_id];
+}
+
+void cpuInputData::finalize_frame(int frame_id) {
+    cpuCommand::finalize_frame(frame_id);
+    mark_frame_empty(network_buf, unique_name.c_str(), network_buffer_finalize_id);
+    network_buffer_finalize_id = (network_buffer_finalize_id + 1) % network_buf->num_frames;
+}
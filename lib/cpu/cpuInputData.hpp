@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Copies the input frames to the CPU "GPU" memory
+ *  - cpuInputData : public cpuCommand
+ */
+
+#ifndef CPU_INPUT_DATA_H
+#define CPU_INPUT_DATA_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuInputData
+ * @brief Copies the frames of @c network_buf to the @c input memory, like @c hsaInputData.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  input  The input data
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of 4+4 bit complex samples
+ *
+ * @conf num_elements          Int. The number of elements.
+ * @conf num_local_freq        Int. The number of frequencies in a frame.
+ * @conf samples_per_data_set  Int. The number of time samples in a frame.
+ */
+class cpuInputData : public cpuCommand {
+public:
+    cpuInputData(kotekan::Config& config, const std::string& unique_name,
+                 kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuInputData();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    int32_t network_buffer_id;
+    int32_t network_buffer_precondition_id;
+    int32_t network_buffer_finalize_id;
+    Buffer* network_buf;
+    int32_t input_frame_len;
+};
+
+#endif // CPU_INPUT_DATA_H
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief Copies the correlator output of the CPU backend to the output buffer
+ *  - cpuOutputData : public cpuSubframeCommand
+ */
+
+#ifndef CPU_OUTPUT_DATA_H
+#define CPU_OUTPUT_DATA_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "cpuSubframeCommand.hpp" // for cpuSubframeCommand
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuOutputData
+ * @brief Copies @c corr_{sub_frame_index} to @c output_buf and sets its metadata, like
+ *        @c hsaOutputData.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ * @buffer output_buf  The correlation matrix blocks.
+ *     @buffer_format Array of @c int32 (re, im) pairs
+ *     @buffer_metadata chimeMetadata
+ * @buffer lost_samples_buf  The flags of the lost samples.
+ *     @buffer_format Array of @c uint8
+ *     @buffer_metadata none
+ *
+ * @par GPU Memory
+ * @gpu_mem  corr_{sub_frame_index}  The correlation matrix blocks
+ *     @gpu_mem_type         static
+ *     @gpu_mem_format       Array of @c int32 (re, im) pairs
+ */
+class cpuOutputData : public cpuSubframeCommand {
+public:
+    cpuOutputData(kotekan::Config& config, const std::string& unique_name,
+                  kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuOutputData();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+    std::string get_unique_name() const override;
+
+private:
+    Buffer* network_buffer;
+    int32_t network_buffer_id;
+    int32_t network_buffer_precondition_id;
+
+    Buffer* output_buffer;
+    int32_t output_buffer_id;
+    int32_t output_buffer_precondition_id;
+    int32_t output_buffer_execute_id;
+
+    Buffer* lost_samples_buf;
+    int32_t lost_samples_buf_id;
+    int32_t lost_samples_buf_precondition_id;
+
+    /// The name the subframe commands share as the producer and consumer of the buffers
+    std::string static_unique_name;
+};
+
+#endif // CPU_OUTPUT_DATA_H
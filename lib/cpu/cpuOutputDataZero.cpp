@@ -0,0 +1,36 @@
+#include "cpuOutputDataZero.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::COPY_IN
+
+#include "fmt.hpp" // for format, fmt
+
+#include <string.h> // for memset
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuOutputDataZero);
+
+cpuOutputDataZero::cpuOutputDataZero(Config& config, const std::string& unique_name,
+                                     bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuSubframeCommand(config, unique_name, host_buffers, device, "cpuOutputDataZero") {
+    command_type = gpuCommandType::COPY_IN;
+
+    int block_size = config.get<int>(unique_name, "block_size");
+    int num_elements = config.get<int>(unique_name, "num_elements");
+    int num_local_freq = config.get<int>(unique_name, "num_local_freq");
+    int32_t num_blocks = (num_elements / block_size) * (num_elements / block_size + 1) / 2;
+    output_len = num_local_freq * num_blocks * block_size * block_size * 2 * sizeof(int32_t);
+}
+
+cpuOutputDataZero::~cpuOutputDataZero() {}
+
+cpuEvent cpuOutputDataZero::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    void* gpu_output_ptr = device.get_gpu_memory_array(
+        fmt::format(fmt("corr_{:d}"), _sub_frame_index), gpu_frame_id, output_len);
+    size_t len = output_len;
+
+    return enqueue(gpu_frame_id, pre_event, [=]() { memset(gpu_output_ptr, 0, len); });
+}
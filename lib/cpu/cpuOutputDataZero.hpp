@@ -0,0 +1,43 @@
+/**
+ * @file
+ * @brief Zeros the correlator output memory of the CPU backend
+ *  - cpuOutputDataZero : public cpuSubframeCommand
+ */
+
+#ifndef CPU_OUTPUT_DATA_ZERO_H
+#define CPU_OUTPUT_DATA_ZERO_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "cpuSubframeCommand.hpp" // for cpuSubframeCommand
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuOutputDataZero
+ * @brief Zeros the @c corr_{sub_frame_index} memory, like @c hsaOutputDataZero.
+ *
+ * @par GPU Memory
+ * @gpu_mem  corr_{sub_frame_index}  The correlation matrix blocks
+ *     @gpu_mem_type         static
+ *     @gpu_mem_format       Array of @c int32 (re, im) pairs
+ *
+ * @conf num_elements    Int. The number of elements.
+ * @conf num_local_freq  Int. The number of frequencies in a frame.
+ * @conf block_size      Int. The size of the correlation matrix blocks.
+ */
+class cpuOutputDataZero : public cpuSubframeCommand {
+public:
+    cpuOutputDataZero(kotekan::Config& config, const std::string& unique_name,
+                      kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuOutputDataZero();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    int32_t output_len;
+};
+
+#endif // CPU_OUTPUT_DATA_ZERO_H
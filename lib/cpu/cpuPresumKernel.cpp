@@ -0,0 +1,70 @@
+#include "cpuPresumKernel.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm> // for min
+#include <stddef.h>  // for size_t
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuPresumKernel);
+
+// The number of inputs summed by one work item
+#define PRESUM_BLOCK 256
+
+cpuPresumKernel::cpuPresumKernel(Config& config, const std::string& unique_name,
+                                 bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuSubframeCommand(config, unique_name, host_buffers, device, "cpuPresumKernel") {
+    command_type = gpuCommandType::KERNEL;
+
+    _num_elements = config.get<int32_t>(unique_name, "num_elements");
+    _num_local_freq = config.get<int32_t>(unique_name, "num_local_freq");
+    _samples_per_data_set = config.get<int32_t>(unique_name, "samples_per_data_set");
+    input_frame_len = _num_elements * _num_local_freq * _samples_per_data_set;
+    presum_len = _num_elements * _num_local_freq * 2 * sizeof(int32_t);
+
+    // pre-allocate GPU memory
+    device.get_gpu_memory_array("input", 0, input_frame_len);
+    device.get_gpu_memory_array(fmt::format(fmt("presum_{:d}"), _sub_frame_index), 0, presum_len);
+}
+
+cpuPresumKernel::~cpuPresumKernel() {}
+
+cpuEvent cpuPresumKernel::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const size_t num_inputs = _num_elements * _num_local_freq;
+    const size_t num_samples = _sub_frame_samples;
+
+    // Index past the start of the input for the required sub frame
+    const uint8_t* input =
+        (uint8_t*)device.get_gpu_memory_array("input", gpu_frame_id, input_frame_len)
+        + num_inputs * num_samples * _sub_frame_index;
+    uint32_t* presum = (uint32_t*)device.get_gpu_memory_array(
+        fmt::format(fmt("presum_{:d}"), _sub_frame_index), gpu_frame_id, presum_len);
+
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        const size_t num_blocks = (num_inputs + PRESUM_BLOCK - 1) / PRESUM_BLOCK;
+        dev.parallel_for(num_blocks, [=](size_t block) {
+            const size_t start = block * PRESUM_BLOCK;
+            const size_t end = std::min(start + PRESUM_BLOCK, num_inputs);
+            uint32_t sum_im[PRESUM_BLOCK] = {0};
+            uint32_t sum_re[PRESUM_BLOCK] = {0};
+            for (size_t t = 0; t < num_samples; t++) {
+                const uint8_t* sample = input + t * num_inputs;
+                for (size_t i = start; i < end; i++) {
+                    sum_im[i - start] += sample[i] & 0x0f;
+                    sum_re[i - start] += sample[i] >> 4;
+                }
+            }
+            for (size_t i = start; i < end; i++) {
+                presum[2 * i + 0] += 8 * sum_im[i - start];
+                presum[2 * i + 1] += 8 * sum_re[i - start];
+            }
+        });
+    });
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Sums the inputs over time on the CPU
+ *  - cpuPresumKernel : public cpuSubframeCommand
+ */
+
+#ifndef CPU_PRESUM_KERNEL_H
+#define CPU_PRESUM_KERNEL_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "cpuSubframeCommand.hpp" // for cpuSubframeCommand
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuPresumKernel
+ * @brief Computes the same sums as the @c CHIME_presum kernel of @c hsaPresumKernel.
+ *
+ * For each input and frequency the 4 bit real and imaginary parts of the samples of the
+ * sub-frame are summed (as unsigned numbers, times 8) into the @c presum memory, the
+ * imaginary sum first.
+ *
+ * @par GPU Memory
+ * @gpu_mem  input  The input data
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of 4+4 bit complex samples
+ * @gpu_mem  presum_{sub_frame_index}  The sums of the inputs over time
+ *     @gpu_mem_type         static
+ *     @gpu_mem_format       Array of @c int32 (im, re) pairs
+ *
+ * @conf num_elements          Int. The number of elements.
+ * @conf num_local_freq        Int. The number of frequencies in a frame.
+ * @conf samples_per_data_set  Int. The number of time samples in a frame.
+ */
+class cpuPresumKernel : public cpuSubframeCommand {
+public:
+    cpuPresumKernel(kotekan::Config& config, const std::string& unique_name,
+                    kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuPresumKernel();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    int32_t input_frame_len;
+    int32_t presum_len;
+
+    int32_t _num_elements;
+    int32_t _num_local_freq;
+    int32_t _samples_per_data_set;
+};
+
+#endif // CPU_PRESUM_KERNEL_H
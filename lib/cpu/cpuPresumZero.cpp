@@ -0,0 +1,33 @@
+#include "cpuPresumZero.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::COPY_IN
+
+#include "fmt.hpp" // for format, fmt
+
+#include <string.h> // for memset
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuPresumZero);
+
+cpuPresumZero::cpuPresumZero(Config& config, const std::string& unique_name,
+                             bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuSubframeCommand(config, unique_name, host_buffers, device, "cpuPresumZero") {
+    command_type = gpuCommandType::COPY_IN;
+    int32_t num_elements = config.get<int32_t>(unique_name, "num_elements");
+    int32_t num_local_freq = config.get<int32_t>(unique_name, "num_local_freq");
+    presum_len = num_elements * num_local_freq * 2 * sizeof(int32_t);
+}
+
+cpuPresumZero::~cpuPresumZero() {}
+
+cpuEvent cpuPresumZero::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    void* gpu_memory_frame = device.get_gpu_memory_array(
+        fmt::format(fmt("presum_{:d}"), _sub_frame_index), gpu_frame_id, presum_len);
+    size_t len = presum_len;
+
+    return enqueue(gpu_frame_id, pre_event, [=]() { memset(gpu_memory_frame, 0, len); });
+}
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * @brief Zeros the presum memory of the CPU backend
+ *  - cpuPresumZero : public cpuSubframeCommand
+ */
+
+#ifndef CPU_PRESUM_ZERO_H
+#define CPU_PRESUM_ZERO_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "cpuSubframeCommand.hpp" // for cpuSubframeCommand
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuPresumZero
+ * @brief Zeros the @c presum_{sub_frame_index} memory, like @c hsaPresumZero.
+ *
+ * @par GPU Memory
+ * @gpu_mem  presum_{sub_frame_index}  The sums of the inputs over time
+ *     @gpu_mem_type         static
+ *     @gpu_mem_format       Array of @c int32 (im, re) pairs
+ *
+ * @conf num_elements    Int. The number of elements.
+ * @conf num_local_freq  Int. The number of frequencies in a frame.
+ */
+class cpuPresumZero : public cpuSubframeCommand {
+public:
+    cpuPresumZero(kotekan::Config& config, const std::string& unique_name,
+                  kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuPresumZero();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    int32_t presum_len;
+};
+
+#endif // CPU_PRESUM_ZERO_H
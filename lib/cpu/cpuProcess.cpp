@@ -0,0 +1,60 @@
+#include "cpuProcess.hpp"
+
+#include "Config.hpp"            // for Config
+#include "StageFactory.hpp"      // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
+#include "cpuCommand.hpp"        // for cpuCommand, _factory_aliascpuCommand
+#include "cpuEventContainer.hpp" // for cpuEventContainer
+#include "factory.hpp"           // for FACTORY
+#include "kotekanLogging.hpp"    // for DEBUG, INFO
+
+#include <stdint.h> // for uint32_t
+#include <vector>   // for vector
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_KOTEKAN_STAGE(cpuProcess);
+
+cpuProcess::cpuProcess(Config& config, const std::string& unique_name,
+                       bufferContainer& buffer_container) :
+    gpuProcess(config, unique_name, buffer_container) {
+    uint32_t num_threads = config.get_default<uint32_t>(unique_name, "num_threads", 0);
+    device = new cpuDeviceInterface(config, gpu_id, _gpu_buffer_depth, num_threads);
+    dev = device;
+    frame_signals.resize(_gpu_buffer_depth);
+    init();
+}
+
+cpuProcess::~cpuProcess() {}
+
+gpuEventContainer* cpuProcess::create_signal() {
+    return new cpuEventContainer();
+}
+
+gpuCommand* cpuProcess::create_command(const std::string& cmd_name,
+                                       const std::string& unique_name) {
+    // Run the commands of the other backends as the CPU command of the same name
+    std::string name = cmd_name;
+    if (!FACTORY(cpuCommand)::exists(name)) {
+        for (std::string prefix : {"hsa", "cl", "cuda"}) {
+            if (name.compare(0, prefix.size(), prefix) == 0
+                && FACTORY(cpuCommand)::exists("cpu" + name.substr(prefix.size()))) {
+                name = "cpu" + name.substr(prefix.size());
+                INFO("Running command {:s} as {:s}.", cmd_name, name);
+                break;
+            }
+        }
+    }
+    auto cmd = FACTORY(cpuCommand)::create_bare(name, config, unique_name, local_buffer_container,
+                                                *device);
+    DEBUG("Command added: {:s}", name);
+    return cmd;
+}
+
+void cpuProcess::queue_command(size_t c, int gpu_frame_id) {
+    // Feed the last signal of the frame into the next operation
+    cpuEvent& signal = frame_signals[gpu_frame_id];
+    signal = ((cpuCommand*)commands[c])->execute(gpu_frame_id, c == 0 ? cpuEvent() : signal);
+    if (c == commands.size() - 1)
+        final_signals[gpu_frame_id]->set_signal(&signal);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @brief Stage running the commands of the GPU framework on the CPU
+ *  - cpuProcess : public gpuProcess
+ */
+
+#ifndef CPU_PROCESS_H
+#define CPU_PROCESS_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "gpuCommand.hpp"         // for gpuCommand
+#include "gpuEventContainer.hpp"  // for gpuEventContainer
+#include "gpuProcess.hpp"         // for gpuProcess
+
+#include <stddef.h> // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @class cpuProcess
+ * @brief Runs the commands of the GPU framework on the CPU.
+ *
+ * The "GPU memory" is host memory, and the commands run on threads (see
+ * @c cpuDeviceInterface), with the same pipelining over @c buffer_depth frames as
+ * the GPU backends. This allows GPU pipelines to run on nodes and CI machines without
+ * GPUs, and the scheduling overhead of the framework to be profiled on its own.
+ *
+ * The commands of the other backends can be used by their names, e.g. @c hsaInputData
+ * runs @c cpuInputData, so the config of a GPU pipeline can run unchanged apart from
+ * using @c cpuProcess as the stage.
+ *
+ * @conf buffer_depth  Int. The number of GPU frames in flight.
+ * @conf gpu_id        Int. An ID for the (virtual) GPU.
+ * @conf num_threads   Int. The number of threads running the kernels. Default 0, one
+ *                     per core.
+ * @conf commands      List of the commands to run (see @c gpuProcess).
+ */
+class cpuProcess final : public gpuProcess {
+public:
+    cpuProcess(kotekan::Config& config, const std::string& unique_name,
+               kotekan::bufferContainer& buffer_container);
+    virtual ~cpuProcess();
+
+protected:
+    gpuCommand* create_command(const std::string& cmd_name,
+                               const std::string& unique_name) override;
+    gpuEventContainer* create_signal() override;
+    void queue_command(size_t c, int gpu_frame_id) override;
+
+    cpuDeviceInterface* device;
+    /// The signal of the last command queued on each frame
+    std::vector<cpuEvent> frame_signals;
+};
+
+#endif // CPU_PROCESS_H
@@ -0,0 +1,48 @@
+#include "cpuRfiBadInput.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+#include <algorithm> // for min
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint32_t
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuRfiBadInput);
+
+// The number of inputs averaged by one work item
+#define BAD_INPUT_BLOCK 256
+
+cpuRfiBadInput::cpuRfiBadInput(Config& config, const std::string& unique_name,
+                               bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuRfiBadInput"),
+    geometry(config, unique_name) {
+    command_type = gpuCommandType::KERNEL;
+
+    input_frame_len = sizeof(float) * geometry.num_elements * geometry.num_local_freq
+                      * geometry.num_sk_steps();
+    output_frame_len = sizeof(float) * geometry.num_elements * geometry.num_local_freq;
+}
+
+cpuRfiBadInput::~cpuRfiBadInput() {}
+
+cpuEvent cpuRfiBadInput::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const float* time_sum =
+        (float*)device.get_gpu_memory_array("time_sum", gpu_frame_id, input_frame_len);
+    float* bad_input =
+        (float*)device.get_gpu_memory_array("rfi_bad_input", gpu_frame_id, output_frame_len);
+
+    const skGeometry g = geometry;
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        const size_t num_blocks = (g.num_elements + BAD_INPUT_BLOCK - 1) / BAD_INPUT_BLOCK;
+        dev.parallel_for(g.num_local_freq * num_blocks, [=](size_t item) {
+            const uint32_t start = (item % num_blocks) * BAD_INPUT_BLOCK;
+            const uint32_t n = std::min<uint32_t>(BAD_INPUT_BLOCK, g.num_elements - start);
+            sk_bad_input(g, time_sum, bad_input, item / num_blocks, start, n);
+        });
+    });
+}
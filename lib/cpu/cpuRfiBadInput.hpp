@@ -0,0 +1,55 @@
+/**
+ * @file
+ * @brief Mean spectral kurtosis of each input on the CPU, to find bad inputs
+ *  - cpuRfiBadInput : public cpuCommand
+ */
+
+#ifndef CPU_RFI_BAD_INPUT_H
+#define CPU_RFI_BAD_INPUT_H
+
+#include "Config.hpp"              // for Config
+#include "bufferContainer.hpp"     // for bufferContainer
+#include "cpuCommand.hpp"          // for cpuCommand
+#include "cpuDeviceInterface.hpp"  // for cpuDeviceInterface, cpuEvent
+#include "cpuSpectralKurtosis.hpp" // for skGeometry
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuRfiBadInput
+ * @brief Computes the SK estimate of each input and frequency, averaged over the frame, like
+ *        the @c rfi_bad_input kernel of @c hsaRfiBadInput.
+ *
+ * The inputs of each frequency are split in blocks over the threads of the device (see
+ * @c sk_bad_input).
+ *
+ * @par GPU Memory
+ * @gpu_mem  time_sum       The output of @c cpuRfiTimeSum
+ *     @gpu_mem_type        staging
+ *     @gpu_mem_format      Array of @c float
+ * @gpu_mem  rfi_bad_input  The mean SK estimates, [freq][element]
+ *     @gpu_mem_type        staging
+ *     @gpu_mem_format      Array of @c float
+ *
+ * @conf   num_elements          Int. Number of elements.
+ * @conf   num_local_freq        Int. Number of local freq.
+ * @conf   samples_per_data_set  Int. Number of time samples in a data set.
+ * @conf   sk_step               Int (default 256). Length of time integration in SK estimate.
+ */
+class cpuRfiBadInput : public cpuCommand {
+public:
+    cpuRfiBadInput(kotekan::Config& config, const std::string& unique_name,
+                   kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuRfiBadInput();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    const skGeometry geometry;
+
+    int32_t input_frame_len;
+    int32_t output_frame_len;
+};
+
+#endif // CPU_RFI_BAD_INPUT_H
@@ -0,0 +1,91 @@
+#include "cpuRfiInputSum.hpp"
+
+#include "chimeMetadata.hpp"  // for get_rfi_num_bad_inputs
+#include "gpuCommand.hpp"     // for gpuCommandType, gpuCommandType::KERNEL
+#include "kotekanLogging.hpp" // for DEBUG
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint8_t
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuRfiInputSum);
+
+cpuRfiInputSum::cpuRfiInputSum(Config& config, const std::string& unique_name,
+                               bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuRfiInputSum"),
+    geometry(config, unique_name) {
+    command_type = gpuCommandType::KERNEL;
+
+    _rfi_sigma_cut = config.get_default<uint32_t>(unique_name, "rfi_sigma_cut", 5);
+    _trunc_bias_switch = config.get_default<bool>(unique_name, "trunc_bias_switch", false);
+
+    input_frame_len = sizeof(float) * geometry.num_elements * geometry.num_local_freq
+                      * geometry.num_sk_steps();
+    output_frame_len = sizeof(float) * geometry.num_local_freq * geometry.num_sk_steps();
+    input_mask_len = sizeof(uint8_t) * geometry.num_elements;
+    output_mask_len = sizeof(uint8_t) * geometry.num_local_freq * geometry.num_sk_steps();
+    lost_samples_len = sizeof(uint32_t) * geometry.num_sk_steps();
+
+    network_buffer = host_buffers.get_buffer("network_buf");
+    register_consumer(network_buffer, unique_name.c_str());
+    network_buffer_precondition_id = 0;
+    network_buffer_execute_id = 0;
+    network_buffer_finalize_id = 0;
+}
+
+cpuRfiInputSum::~cpuRfiInputSum() {}
+
+int cpuRfiInputSum::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+    uint8_t* frame =
+        wait_for_full_frame(network_buffer, unique_name.c_str(), network_buffer_precondition_id);
+    if (frame == nullptr)
+        return -1;
+    network_buffer_precondition_id =
+        (network_buffer_precondition_id + 1) % network_buffer->num_frames;
+    return 0;
+}
+
+cpuEvent cpuRfiInputSum::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    // The number of bad inputs from the metadata
+    const uint32_t num_bad_inputs =
+        get_rfi_num_bad_inputs(network_buffer, network_buffer_execute_id);
+    DEBUG("Number of bad inputs at execute in cpuRfiInputSum is: {:d}", num_bad_inputs);
+    network_buffer_execute_id = (network_buffer_execute_id + 1) % network_buffer->num_frames;
+
+    const float* time_sum =
+        (float*)device.get_gpu_memory_array("time_sum", gpu_frame_id, input_frame_len);
+    const float* time_sum_var =
+        (float*)device.get_gpu_memory_array("rfi_time_sum_var", gpu_frame_id, input_frame_len);
+    const uint8_t* input_mask =
+        (uint8_t*)device.get_gpu_memory_array("input_mask", gpu_frame_id, input_mask_len);
+    const uint32_t* lost_samples = (uint32_t*)device.get_gpu_memory_array(
+        "rfi_compressed_lost_samples", gpu_frame_id, lost_samples_len);
+    float* sk = (float*)device.get_gpu_memory_array("rfi_output", gpu_frame_id, output_frame_len);
+    float* sk_var =
+        (float*)device.get_gpu_memory_array("rfi_output_var", gpu_frame_id, output_frame_len);
+    uint8_t* sk_mask =
+        (uint8_t*)device.get_gpu_memory_array("rfi_mask_output", gpu_frame_id, output_mask_len);
+
+    const skGeometry g = geometry;
+    const uint32_t rfi_sigma_cut = _rfi_sigma_cut;
+    const bool trunc_bias_switch = _trunc_bias_switch;
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        dev.parallel_for((size_t)g.num_local_freq * g.num_sk_steps(), [=](size_t item) {
+            sk_input_sum(g, time_sum, time_sum_var, input_mask, lost_samples, num_bad_inputs,
+                         rfi_sigma_cut, trunc_bias_switch, sk, sk_var, sk_mask,
+                         item % g.num_local_freq, item / g.num_local_freq);
+        });
+    });
+}
+
+void cpuRfiInputSum::finalize_frame(int frame_id) {
+    cpuCommand::finalize_frame(frame_id);
+    mark_frame_empty(network_buffer, unique_name.c_str(), network_buffer_finalize_id);
+    network_buffer_finalize_id = (network_buffer_finalize_id + 1) % network_buffer->num_frames;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @brief RFI input sum, computes the spectral kurtosis estimates on the CPU
+ *  - cpuRfiInputSum : public cpuCommand
+ */
+
+#ifndef CPU_RFI_INPUT_SUM_H
+#define CPU_RFI_INPUT_SUM_H
+
+#include "Config.hpp"              // for Config
+#include "buffer.h"                // for Buffer
+#include "bufferContainer.hpp"     // for bufferContainer
+#include "cpuCommand.hpp"          // for cpuCommand
+#include "cpuDeviceInterface.hpp"  // for cpuDeviceInterface, cpuEvent
+#include "cpuSpectralKurtosis.hpp" // for skGeometry
+
+#include <stdint.h> // for int32_t, uint32_t
+#include <string>   // for string
+
+/**
+ * @class cpuRfiInputSum
+ * @brief Computes the spectral kurtosis estimates and the RFI mask of the incoherent beam
+ *        like the @c rfi_chime_input_sum kernel of @c hsaRfiInputSum.
+ *
+ * The time sums of @c cpuRfiTimeSum are summed over the inputs which are not masked, in the
+ * same order as in the kernel, and the SK estimate of each frequency and block of @c sk_step
+ * samples is flagged as RFI if it is more than @c rfi_sigma_cut standard deviations from 1
+ * (see @c sk_input_sum). The number of bad inputs is taken from the metadata of the frame.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  time_sum                     The output of @c cpuRfiTimeSum
+ *     @gpu_mem_type                      staging
+ *     @gpu_mem_format                    Array of @c float
+ * @gpu_mem  rfi_time_sum_var             The output of @c cpuRfiTimeSum
+ *     @gpu_mem_type                      staging
+ *     @gpu_mem_format                    Array of @c float
+ * @gpu_mem  input_mask                   The weight of each input (0 for a bad input)
+ *     @gpu_mem_type                      staging
+ *     @gpu_mem_format                    Array of @c uint8_t
+ * @gpu_mem  rfi_compressed_lost_samples  The lost samples of each block of sk_step samples
+ *     @gpu_mem_type                      staging
+ *     @gpu_mem_format                    Array of @c uint32_t
+ * @gpu_mem  rfi_output                   The SK estimates, [sk_step][freq]
+ *     @gpu_mem_type                      staging
+ *     @gpu_mem_format                    Array of @c float
+ * @gpu_mem  rfi_output_var               The mean power, [sk_step][freq]
+ *     @gpu_mem_type                      staging
+ *     @gpu_mem_format                    Array of @c float
+ * @gpu_mem  rfi_mask_output              The RFI mask (1 for RFI, 0 for clean), [sk_step][freq]
+ *     @gpu_mem_type                      staging
+ *     @gpu_mem_format                    Array of @c uint8_t
+ *
+ * @conf   num_elements          Int. Number of elements.
+ * @conf   num_local_freq        Int. Number of local freq.
+ * @conf   samples_per_data_set  Int. Number of time samples in a data set.
+ * @conf   sk_step               Int (default 256). Length of time integration in SK estimate.
+ * @conf   rfi_sigma_cut         Int (default 5). The threshold of the SK estimates, in
+ *                               standard deviations.
+ * @conf   trunc_bias_switch     Bool (default false). Whether to correct the SK estimates for
+ *                               the truncation bias.
+ */
+class cpuRfiInputSum : public cpuCommand {
+public:
+    cpuRfiInputSum(kotekan::Config& config, const std::string& unique_name,
+                   kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuRfiInputSum();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    const skGeometry geometry;
+    uint32_t _rfi_sigma_cut;
+    bool _trunc_bias_switch;
+
+    int32_t input_frame_len;
+    int32_t output_frame_len;
+    int32_t input_mask_len;
+    int32_t output_mask_len;
+    int32_t lost_samples_len;
+
+    Buffer* network_buffer;
+    int32_t network_buffer_precondition_id;
+    int32_t network_buffer_execute_id;
+    int32_t network_buffer_finalize_id;
+};
+
+#endif // CPU_RFI_INPUT_SUM_H
@@ -0,0 +1,99 @@
+#include "cpuRfiOutput.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::COPY_OUT
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuRfiOutput);
+REGISTER_CPU_COMMAND(cpuRfiVarOutput);
+REGISTER_CPU_COMMAND(cpuRfiBadInputOutput);
+REGISTER_CPU_COMMAND(cpuRfiMaskOutput);
+
+cpuRfiOutput::cpuRfiOutput(Config& config, const std::string& unique_name,
+                           bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuRfiOutput(config, unique_name, host_buffers, device, "cpuRfiOutput", "rfi_output",
+                 "rfi_output_buf") {}
+
+cpuRfiOutput::cpuRfiOutput(Config& config, const std::string& unique_name,
+                           bufferContainer& host_buffers, cpuDeviceInterface& device,
+                           const std::string& command_name, const std::string& gpu_memory_name_,
+                           const std::string& output_buffer_name) :
+    cpuCommand(config, unique_name, host_buffers, device, command_name),
+    gpu_memory_name(gpu_memory_name_) {
+    command_type = gpuCommandType::COPY_OUT;
+
+    network_buffer = host_buffers.get_buffer("network_buf");
+    register_consumer(network_buffer, unique_name.c_str());
+    output_buffer = host_buffers.get_buffer(output_buffer_name);
+    register_producer(output_buffer, unique_name.c_str());
+
+    network_buffer_id = 0;
+    network_buffer_precondition_id = 0;
+
+    output_buffer_id = 0;
+    output_buffer_execute_id = 0;
+    output_buffer_precondition_id = 0;
+}
+
+cpuRfiOutput::~cpuRfiOutput() {}
+
+int cpuRfiOutput::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+    uint8_t* frame =
+        wait_for_empty_frame(output_buffer, unique_name.c_str(), output_buffer_precondition_id);
+    if (frame == nullptr)
+        return -1;
+    output_buffer_precondition_id = (output_buffer_precondition_id + 1) % output_buffer->num_frames;
+
+    frame =
+        wait_for_full_frame(network_buffer, unique_name.c_str(), network_buffer_precondition_id);
+    if (frame == nullptr)
+        return -1;
+    network_buffer_precondition_id =
+        (network_buffer_precondition_id + 1) % network_buffer->num_frames;
+
+    return 0;
+}
+
+cpuEvent cpuRfiOutput::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    void* gpu_output_ptr =
+        device.get_gpu_memory_array(gpu_memory_name, gpu_frame_id, output_buffer->frame_size);
+    void* host_output_ptr = (void*)output_buffer->frames[output_buffer_execute_id];
+
+    events[gpu_frame_id] = device.async_copy_gpu_to_host(host_output_ptr, gpu_output_ptr,
+                                                         output_buffer->frame_size, pre_event);
+
+    output_buffer_execute_id = (output_buffer_execute_id + 1) % output_buffer->num_frames;
+
+    return events[gpu_frame_id];
+}
+
+void cpuRfiOutput::finalize_frame(int frame_id) {
+    cpuCommand::finalize_frame(frame_id);
+
+    pass_metadata(network_buffer, network_buffer_id, output_buffer, output_buffer_id);
+
+    mark_frame_empty(network_buffer, unique_name.c_str(), network_buffer_id);
+    mark_frame_full(output_buffer, unique_name.c_str(), output_buffer_id);
+    network_buffer_id = (network_buffer_id + 1) % network_buffer->num_frames;
+    output_buffer_id = (output_buffer_id + 1) % output_buffer->num_frames;
+}
+
+cpuRfiVarOutput::cpuRfiVarOutput(Config& config, const std::string& unique_name,
+                                 bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuRfiOutput(config, unique_name, host_buffers, device, "cpuRfiVarOutput", "rfi_output_var",
+                 "rfi_var_output_buf") {}
+
+cpuRfiBadInputOutput::cpuRfiBadInputOutput(Config& config, const std::string& unique_name,
+                                           bufferContainer& host_buffers,
+                                           cpuDeviceInterface& device) :
+    cpuRfiOutput(config, unique_name, host_buffers, device, "cpuRfiBadInputOutput",
+                 "rfi_bad_input", "rfi_bad_input_buf") {}
+
+cpuRfiMaskOutput::cpuRfiMaskOutput(Config& config, const std::string& unique_name,
+                                   bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuRfiOutput(config, unique_name, host_buffers, device, "cpuRfiMaskOutput",
+                 "rfi_mask_output", "rfi_mask_output_buf") {}
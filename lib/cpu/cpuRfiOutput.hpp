@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Copies of the RFI outputs to the host on the CPU
+ *  - cpuRfiOutput : public cpuCommand
+ *  - cpuRfiVarOutput : public cpuRfiOutput
+ *  - cpuRfiBadInputOutput : public cpuRfiOutput
+ *  - cpuRfiMaskOutput : public cpuRfiOutput
+ */
+
+#ifndef CPU_RFI_OUTPUT_H
+#define CPU_RFI_OUTPUT_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuRfiOutput
+ * @brief Copies the SK estimates of @c cpuRfiInputSum to @c rfi_output_buf and passes on the
+ *        metadata, like @c hsaRfiOutput.
+ *
+ * The other RFI outputs are copied the same way by the subclasses.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ * @buffer rfi_output_buf  The SK estimates.
+ *     @buffer_format Array of @c float
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  rfi_output  The SK estimates.
+ *     @gpu_mem_type     staging
+ *     @gpu_mem_format   Array of @c float
+ */
+class cpuRfiOutput : public cpuCommand {
+public:
+    cpuRfiOutput(kotekan::Config& config, const std::string& unique_name,
+                 kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuRfiOutput();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+protected:
+    /// Copies the GPU memory @p gpu_memory_name to the buffer @p output_buffer_name
+    cpuRfiOutput(kotekan::Config& config, const std::string& unique_name,
+                 kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device,
+                 const std::string& command_name, const std::string& gpu_memory_name,
+                 const std::string& output_buffer_name);
+
+private:
+    std::string gpu_memory_name;
+
+    Buffer* network_buffer;
+    int32_t network_buffer_id;
+    int32_t network_buffer_precondition_id;
+
+    Buffer* output_buffer;
+    int32_t output_buffer_id;
+    int32_t output_buffer_precondition_id;
+    int32_t output_buffer_execute_id;
+};
+
+/**
+ * @class cpuRfiVarOutput
+ * @brief Copies @c rfi_output_var to @c rfi_var_output_buf, like @c hsaRfiVarOutput.
+ */
+class cpuRfiVarOutput : public cpuRfiOutput {
+public:
+    cpuRfiVarOutput(kotekan::Config& config, const std::string& unique_name,
+                    kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+};
+
+/**
+ * @class cpuRfiBadInputOutput
+ * @brief Copies @c rfi_bad_input to @c rfi_bad_input_buf, like @c hsaRfiBadInputOutput.
+ */
+class cpuRfiBadInputOutput : public cpuRfiOutput {
+public:
+    cpuRfiBadInputOutput(kotekan::Config& config, const std::string& unique_name,
+                         kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+};
+
+/**
+ * @class cpuRfiMaskOutput
+ * @brief Copies @c rfi_mask_output to @c rfi_mask_output_buf, like @c hsaRfiMaskOutput.
+ */
+class cpuRfiMaskOutput : public cpuRfiOutput {
+public:
+    cpuRfiMaskOutput(kotekan::Config& config, const std::string& unique_name,
+                     kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+};
+
+#endif // CPU_RFI_OUTPUT_H
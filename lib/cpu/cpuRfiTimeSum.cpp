@@ -0,0 +1,45 @@
+#include "cpuRfiTimeSum.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint8_t
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuRfiTimeSum);
+
+cpuRfiTimeSum::cpuRfiTimeSum(Config& config, const std::string& unique_name,
+                             bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuRfiTimeSum"),
+    geometry(config, unique_name) {
+    command_type = gpuCommandType::KERNEL;
+
+    input_frame_len =
+        geometry.num_elements * geometry.num_local_freq * geometry.samples_per_data_set;
+    output_frame_len = sizeof(float) * geometry.num_elements * geometry.num_local_freq
+                       * geometry.num_sk_steps();
+}
+
+cpuRfiTimeSum::~cpuRfiTimeSum() {}
+
+cpuEvent cpuRfiTimeSum::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const uint8_t* input =
+        (uint8_t*)device.get_gpu_memory_array("input", gpu_frame_id, input_frame_len);
+    float* time_sum =
+        (float*)device.get_gpu_memory_array("time_sum", gpu_frame_id, output_frame_len);
+    float* time_sum_var =
+        (float*)device.get_gpu_memory_array("rfi_time_sum_var", gpu_frame_id, output_frame_len);
+
+    const skGeometry g = geometry;
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        dev.parallel_for((size_t)g.num_local_freq * g.num_sk_steps(), [=](size_t item) {
+            sk_time_sum(g, input, time_sum, time_sum_var, item % g.num_local_freq,
+                        item / g.num_local_freq);
+        });
+    });
+}
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @brief RFI time sum of the spectral kurtosis estimates on the CPU
+ *  - cpuRfiTimeSum : public cpuCommand
+ */
+
+#ifndef CPU_RFI_TIME_SUM_H
+#define CPU_RFI_TIME_SUM_H
+
+#include "Config.hpp"              // for Config
+#include "bufferContainer.hpp"     // for bufferContainer
+#include "cpuCommand.hpp"          // for cpuCommand
+#include "cpuDeviceInterface.hpp"  // for cpuDeviceInterface, cpuEvent
+#include "cpuSpectralKurtosis.hpp" // for skGeometry
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuRfiTimeSum
+ * @brief Computes the same sums as the @c rfi_chime_time_sum kernel of @c hsaRfiTimeSum.
+ *
+ * For each input, frequency and block of @c sk_step samples, the power and the squared power
+ * of the samples are summed, and the squared power sum is normalised by the squared mean
+ * power (see @c sk_time_sum). The blocks of all the frequencies are split over the threads of
+ * the device.
+ *
+ * Unlike on the GPU, the sums are kept for each GPU frame, as the commands of the next frame
+ * can run before the last ones of a frame on the CPU.
+ *
+ * @par GPU Memory
+ * @gpu_mem  input             The input data
+ *     @gpu_mem_type           staging
+ *     @gpu_mem_format         Array of 4+4 bit complex samples, [time][freq][element]
+ * @gpu_mem  time_sum          The normalised squared power sums, [sk_step][freq][element]
+ *     @gpu_mem_type           staging
+ *     @gpu_mem_format         Array of @c float
+ * @gpu_mem  rfi_time_sum_var  The power sums, [sk_step][freq][element]
+ *     @gpu_mem_type           staging
+ *     @gpu_mem_format         Array of @c float
+ *
+ * @conf   num_elements          Int. Number of elements.
+ * @conf   num_local_freq        Int. Number of local freq.
+ * @conf   samples_per_data_set  Int. Number of time samples in a data set.
+ * @conf   sk_step               Int (default 256). Length of time integration in SK estimate.
+ */
+class cpuRfiTimeSum : public cpuCommand {
+public:
+    cpuRfiTimeSum(kotekan::Config& config, const std::string& unique_name,
+                  kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuRfiTimeSum();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    const skGeometry geometry;
+
+    int32_t input_frame_len;
+    int32_t output_frame_len;
+};
+
+#endif // CPU_RFI_TIME_SUM_H
@@ -0,0 +1,112 @@
+#include "cpuRfiUpdateBadInputs.hpp"
+
+#include "chimeMetadata.hpp"  // for get_rfi_num_bad_inputs, set_rfi_num_bad_inputs
+#include "gpuCommand.hpp"     // for gpuCommandType, gpuCommandType::COPY_IN
+#include "kotekanLogging.hpp" // for DEBUG
+#include "visUtil.hpp"        // for double_to_ts
+
+#include <string.h> // for memcpy
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuRfiUpdateBadInputs);
+
+cpuRfiUpdateBadInputs::cpuRfiUpdateBadInputs(Config& config, const std::string& unique_name,
+                                             bufferContainer& host_buffers,
+                                             cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuRfiUpdateBadInputs") {
+    command_type = gpuCommandType::COPY_IN;
+
+    input_mask_len = sizeof(uint8_t) * config.get<uint32_t>(unique_name, "num_elements");
+    host_mask.resize(input_mask_len);
+    num_bad_inputs = 0;
+
+    in_buffer = host_buffers.get_buffer("bad_inputs_buf");
+    register_consumer(in_buffer, unique_name.c_str());
+    in_buffer_precondition_id = 0;
+
+    network_buffer = host_buffers.get_buffer("network_buf");
+    register_consumer(network_buffer, unique_name.c_str());
+    network_buffer_precondition_id = 0;
+    network_buffer_execute_id = 0;
+    network_buffer_finalize_id = 0;
+
+    frames_to_update = 0;
+    frame_copy_active.resize(device.get_gpu_buffer_depth(), false);
+    first_pass = true;
+}
+
+cpuRfiUpdateBadInputs::~cpuRfiUpdateBadInputs() {}
+
+void cpuRfiUpdateBadInputs::copy_frame() {
+    frames_to_update = device.get_gpu_buffer_depth();
+    memcpy(host_mask.data(), in_buffer->frames[in_buffer_precondition_id], input_mask_len);
+    num_bad_inputs = get_rfi_num_bad_inputs(in_buffer, in_buffer_precondition_id);
+    mark_frame_empty(in_buffer, unique_name.c_str(), in_buffer_precondition_id);
+    in_buffer_precondition_id = (in_buffer_precondition_id + 1) % in_buffer->num_frames;
+}
+
+int cpuRfiUpdateBadInputs::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+    uint8_t* frame =
+        wait_for_full_frame(network_buffer, unique_name.c_str(), network_buffer_precondition_id);
+    if (frame == nullptr)
+        return -1;
+    network_buffer_precondition_id =
+        (network_buffer_precondition_id + 1) % network_buffer->num_frames;
+
+    std::lock_guard<std::mutex> lock(update_mutex);
+    if (first_pass) {
+        // Wait for the first mask
+        frame = wait_for_full_frame(in_buffer, unique_name.c_str(), in_buffer_precondition_id);
+        if (frame == nullptr)
+            return -1;
+        first_pass = false;
+        copy_frame();
+        return 0;
+    }
+
+    // Only take a new mask once it was copied to all the GPU frames
+    bool copy_active = false;
+    for (bool active : frame_copy_active)
+        copy_active = copy_active || active;
+    if (frames_to_update == 0 && !copy_active) {
+        int status = wait_for_full_frame_timeout(in_buffer, unique_name.c_str(),
+                                                 in_buffer_precondition_id, double_to_ts(0));
+        if (status == 0)
+            copy_frame();
+        if (status == -1)
+            return -1;
+    }
+    return 0;
+}
+
+cpuEvent cpuRfiUpdateBadInputs::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    std::lock_guard<std::mutex> lock(update_mutex);
+    set_rfi_num_bad_inputs(network_buffer, network_buffer_execute_id, num_bad_inputs);
+    network_buffer_execute_id = (network_buffer_execute_id + 1) % network_buffer->num_frames;
+
+    if (frames_to_update == 0)
+        return pre_event;
+
+    frames_to_update--;
+    frame_copy_active.at(gpu_frame_id) = true;
+    DEBUG("Copying bad input list to GPU frame {:d}, frames to update: {:d}", gpu_frame_id,
+          frames_to_update);
+    void* gpu_mask = device.get_gpu_memory_array("input_mask", gpu_frame_id, input_mask_len);
+    events[gpu_frame_id] =
+        device.async_copy_host_to_gpu(gpu_mask, host_mask.data(), input_mask_len, pre_event);
+    return events[gpu_frame_id];
+}
+
+void cpuRfiUpdateBadInputs::finalize_frame(int frame_id) {
+    cpuCommand::finalize_frame(frame_id);
+
+    std::lock_guard<std::mutex> lock(update_mutex);
+    frame_copy_active.at(frame_id) = false;
+    mark_frame_empty(network_buffer, unique_name.c_str(), network_buffer_finalize_id);
+    network_buffer_finalize_id = (network_buffer_finalize_id + 1) % network_buffer->num_frames;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file
+ * @brief Copy-in command updating the list of bad inputs on the CPU
+ *  - cpuRfiUpdateBadInputs : public cpuCommand
+ */
+
+#ifndef CPU_RFI_UPDATE_BAD_INPUTS_H
+#define CPU_RFI_UPDATE_BAD_INPUTS_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <mutex>    // for mutex
+#include <stdint.h> // for int32_t, uint32_t, uint8_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @class cpuRfiUpdateBadInputs
+ * @brief Copies the bad input mask to the @c input_mask memory of each GPU frame when a new
+ *        one arrives, and sets the number of bad inputs in the metadata of each frame, like
+ *        @c hsaRfiUpdateBadInputs.
+ *
+ * @par Buffers
+ * @buffer bad_inputs_buf  The bad input mask, 1 for a good input and 0 for a bad one
+ *     @buffer_format Array of @c uint8_t
+ *     @buffer_metadata chimeMetadata
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  input_mask  The bad input mask
+ *     @gpu_mem_type     staging
+ *     @gpu_mem_format   Array of @c uint8_t
+ *
+ * @conf   num_elements  Int. Number of elements.
+ */
+class cpuRfiUpdateBadInputs : public cpuCommand {
+public:
+    cpuRfiUpdateBadInputs(kotekan::Config& config, const std::string& unique_name,
+                          kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuRfiUpdateBadInputs();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    /// Copies a frame of bad_inputs_buf to host_mask, and keeps its number of bad inputs
+    void copy_frame();
+
+    Buffer* in_buffer;
+    int32_t in_buffer_precondition_id;
+
+    Buffer* network_buffer;
+    int32_t network_buffer_precondition_id;
+    int32_t network_buffer_execute_id;
+    int32_t network_buffer_finalize_id;
+
+    /// The number of GPU frames still to copy the mask to
+    int frames_to_update;
+    /// Whether a copy of the mask is queued on each GPU frame
+    std::vector<bool> frame_copy_active;
+    /// Whether no mask was received yet
+    bool first_pass;
+
+    std::mutex update_mutex;
+
+    uint32_t input_mask_len;
+    std::vector<uint8_t> host_mask;
+    uint32_t num_bad_inputs;
+};
+
+#endif // CPU_RFI_UPDATE_BAD_INPUTS_H
@@ -0,0 +1,77 @@
+#include "cpuRfiZeroData.hpp"
+
+#include "chimeMetadata.hpp"  // for set_rfi_zeroed
+#include "configUpdater.hpp"  // for configUpdater
+#include "gpuCommand.hpp"     // for gpuCommandType, gpuCommandType::KERNEL
+#include "kotekanLogging.hpp" // for INFO, WARN
+
+#include <exception>  // for exception
+#include <functional> // for _Bind_helper<>::type, bind, _1, placeholders
+#include <stddef.h>   // for size_t
+#include <stdint.h>   // for uint32_t, uint8_t
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+using kotekan::configUpdater;
+
+REGISTER_CPU_COMMAND(cpuRfiZeroData);
+
+cpuRfiZeroData::cpuRfiZeroData(Config& config, const std::string& unique_name,
+                               bufferContainer& host_buffers, cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuRfiZeroData"),
+    geometry(config, unique_name) {
+    command_type = gpuCommandType::KERNEL;
+
+    input_frame_len =
+        geometry.num_elements * geometry.num_local_freq * geometry.samples_per_data_set;
+    mask_len = sizeof(uint8_t) * geometry.num_local_freq * geometry.num_sk_steps();
+
+    _rfi_zeroing = true;
+    using namespace std::placeholders;
+    configUpdater::instance().subscribe(
+        config.get<std::string>(unique_name, "updatable_config/rfi_zeroing_toggle"),
+        std::bind(&cpuRfiZeroData::update_rfi_zero_flag, this, _1));
+
+    network_buffer = host_buffers.get_buffer("network_buf");
+    network_buffer_id = 0;
+}
+
+cpuRfiZeroData::~cpuRfiZeroData() {}
+
+bool cpuRfiZeroData::update_rfi_zero_flag(nlohmann::json& json) {
+    std::lock_guard<std::mutex> lock(rest_callback_mutex);
+    try {
+        _rfi_zeroing = json["rfi_zeroing"].get<bool>();
+    } catch (std::exception& e) {
+        WARN("Failed to set RFI zeroing flag {:s}", e.what());
+        return false;
+    }
+    INFO("Changing RFI zero flag to {:d}", _rfi_zeroing);
+    return true;
+}
+
+cpuEvent cpuRfiZeroData::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    bool rfi_zeroing;
+    {
+        std::lock_guard<std::mutex> lock(rest_callback_mutex);
+        rfi_zeroing = _rfi_zeroing;
+    }
+    set_rfi_zeroed(network_buffer, network_buffer_id, (uint32_t)rfi_zeroing);
+    network_buffer_id = (network_buffer_id + 1) % network_buffer->num_frames;
+
+    uint8_t* input = (uint8_t*)device.get_gpu_memory_array("input", gpu_frame_id, input_frame_len);
+    const uint8_t* mask =
+        (uint8_t*)device.get_gpu_memory_array("rfi_mask_output", gpu_frame_id, mask_len);
+
+    const skGeometry g = geometry;
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        if (!rfi_zeroing)
+            return;
+        dev.parallel_for((size_t)g.num_local_freq * g.num_sk_steps(), [=](size_t item) {
+            sk_zero_data(g, input, mask, item % g.num_local_freq, item / g.num_local_freq);
+        });
+    });
+}
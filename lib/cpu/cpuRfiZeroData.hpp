@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief Zeroes the input data flagged as RFI on the CPU
+ *  - cpuRfiZeroData : public cpuCommand
+ */
+
+#ifndef CPU_RFI_ZERO_DATA_H
+#define CPU_RFI_ZERO_DATA_H
+
+#include "Config.hpp"              // for Config
+#include "buffer.h"                // for Buffer
+#include "bufferContainer.hpp"     // for bufferContainer
+#include "cpuCommand.hpp"          // for cpuCommand
+#include "cpuDeviceInterface.hpp"  // for cpuDeviceInterface, cpuEvent
+#include "cpuSpectralKurtosis.hpp" // for skGeometry
+
+#include "json.hpp" // for json
+
+#include <mutex>    // for mutex
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuRfiZeroData
+ * @brief Sets the input samples of the blocks flagged as RFI by @c cpuRfiInputSum to zero
+ *        (0x88), like the @c rfi_chime_zero kernel of @c hsaRfiZeroData.
+ *
+ * The zeroing can be turned on and off with the updatable config block
+ * @c rfi_zeroing_toggle, and whether a frame was zeroed is set in its metadata.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  input            The input data
+ *     @gpu_mem_type          staging
+ *     @gpu_mem_format        Array of 4+4 bit complex samples, [time][freq][element]
+ * @gpu_mem  rfi_mask_output  The output of @c cpuRfiInputSum
+ *     @gpu_mem_type          staging
+ *     @gpu_mem_format        Array of @c uint8_t
+ *
+ * @conf   num_elements          Int. Number of elements.
+ * @conf   num_local_freq        Int. Number of local freq.
+ * @conf   samples_per_data_set  Int. Number of time samples in a data set.
+ * @conf   sk_step               Int (default 256). Length of time integration in SK estimate.
+ * @conf   updatable_config/rfi_zeroing_toggle  String. The path of the updatable block with
+ *                                              the bool @c rfi_zeroing.
+ */
+class cpuRfiZeroData : public cpuCommand {
+public:
+    cpuRfiZeroData(kotekan::Config& config, const std::string& unique_name,
+                   kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuRfiZeroData();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+    /// Updates whether the data is zeroed, from the updatable config
+    bool update_rfi_zero_flag(nlohmann::json& json);
+
+private:
+    const skGeometry geometry;
+
+    int32_t input_frame_len;
+    int32_t mask_len;
+
+    bool _rfi_zeroing;
+    std::mutex rest_callback_mutex;
+
+    Buffer* network_buffer;
+    int32_t network_buffer_id;
+};
+
+#endif // CPU_RFI_ZERO_DATA_H
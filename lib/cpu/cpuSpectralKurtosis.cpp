@@ -0,0 +1,172 @@
+#include "cpuSpectralKurtosis.hpp"
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm> // for min
+#include <math.h>    // for sqrt
+#include <stdexcept> // for invalid_argument
+#include <string.h>  // for memset
+
+using kotekan::Config;
+
+// The number of elements summed at once over time
+#define SK_ELEMENT_BLOCK 256
+// The number of lanes the inputs are summed in, the work group size of rfi_chime_input_sum
+#define SK_INPUT_LANES 256
+
+#define SK_NUM_BIAS_COEFFS 10
+
+// The truncation bias of the SK estimates, as a polynomial in the rms of the samples, lowest
+// order first, as in rfi_chime_input_sum.cl
+static const float sk_bias_coeffs[SK_NUM_BIAS_COEFFS] = {
+    -2.53769469e+00, 6.37923339e+00,  -6.75761413e+00, 3.93682451e+00,  -1.38702812e+00,
+    3.07645810e-01,  -4.33959965e-02, 3.78868082e-03,  -1.87073471e-04, 4.00089169e-06};
+
+skGeometry::skGeometry(uint32_t num_elements_, uint32_t num_local_freq_,
+                       uint32_t samples_per_data_set_, uint32_t sk_step_) :
+    num_elements(num_elements_),
+    num_local_freq(num_local_freq_),
+    samples_per_data_set(samples_per_data_set_),
+    sk_step(sk_step_) {
+    if (sk_step == 0 || samples_per_data_set % sk_step != 0)
+        throw std::invalid_argument(
+            fmt::format(fmt("sk_step ({:d}) must divide samples_per_data_set ({:d})"), sk_step,
+                        samples_per_data_set));
+}
+
+skGeometry::skGeometry(Config& config, const std::string& unique_name) :
+    skGeometry(config.get<uint32_t>(unique_name, "num_elements"),
+               config.get<uint32_t>(unique_name, "num_local_freq"),
+               config.get<uint32_t>(unique_name, "samples_per_data_set"),
+               config.get_default<uint32_t>(unique_name, "sk_step", 256)) {}
+
+void sk_time_sum(const skGeometry& g, const uint8_t* input, float* time_sum, float* time_sum_var,
+                 uint32_t freq, uint32_t step) {
+    const size_t num_inputs = (size_t)g.num_elements * g.num_local_freq;
+    const size_t output_index = freq * g.num_elements + step * num_inputs;
+
+    for (uint32_t start = 0; start < g.num_elements; start += SK_ELEMENT_BLOCK) {
+        const uint32_t n = std::min<uint32_t>(SK_ELEMENT_BLOCK, g.num_elements - start);
+        uint32_t power_sum[SK_ELEMENT_BLOCK] = {0};
+        uint32_t sq_power_sum[SK_ELEMENT_BLOCK] = {0};
+
+        for (uint32_t t = step * g.sk_step; t < (step + 1) * g.sk_step; t++) {
+            const uint8_t* sample = input + t * num_inputs + freq * g.num_elements + start;
+            for (uint32_t i = 0; i < n; i++) {
+                const int32_t re = (sample[i] >> 4) - 8;
+                const int32_t im = (sample[i] & 0x0f) - 8;
+                const uint32_t power = re * re + im * im;
+                power_sum[i] += power;
+                sq_power_sum[i] += power * power;
+            }
+        }
+
+        // Normalise by the mean power
+        float* output = time_sum + output_index + start;
+        float* output_var = time_sum_var + output_index + start;
+        for (uint32_t i = 0; i < n; i++) {
+            const float mean = (float)power_sum[i] / g.sk_step + (float)0.00000001;
+            output[i] = (float)sq_power_sum[i] / (mean * mean);
+            output_var[i] = power_sum[i];
+        }
+    }
+}
+
+void sk_input_sum(const skGeometry& g, const float* time_sum, const float* time_sum_var,
+                  const uint8_t* input_mask, const uint32_t* lost_samples,
+                  uint32_t num_bad_inputs, uint32_t rfi_sigma_cut, bool trunc_bias_switch,
+                  float* sk, float* sk_var, uint8_t* sk_mask, uint32_t freq, uint32_t step) {
+    const size_t base_index = freq * g.num_elements + step * g.num_elements * g.num_local_freq;
+    const float* input = time_sum + base_index;
+    const float* input_var = time_sum_var + base_index;
+
+    // Sum the inputs in lanes, and the lanes pairwise, like the work group of the kernel
+    float sq_power_sum[SK_INPUT_LANES];
+    float var_sum[SK_INPUT_LANES];
+    const uint32_t first = std::min<uint32_t>(SK_INPUT_LANES, g.num_elements);
+    for (uint32_t l = 0; l < first; l++) {
+        sq_power_sum[l] = input_mask[l] * input[l];
+        var_sum[l] = input_mask[l] * input_var[l];
+    }
+    for (uint32_t l = first; l < SK_INPUT_LANES; l++) {
+        sq_power_sum[l] = 0;
+        var_sum[l] = 0;
+    }
+    for (uint32_t start = SK_INPUT_LANES; start < g.num_elements; start += SK_INPUT_LANES) {
+        const uint32_t n = std::min<uint32_t>(SK_INPUT_LANES, g.num_elements - start);
+        for (uint32_t l = 0; l < n; l++) {
+            sq_power_sum[l] += input_mask[start + l] * input[start + l];
+            var_sum[l] += input_mask[start + l] * input_var[start + l];
+        }
+    }
+    for (uint32_t j = SK_INPUT_LANES / 2; j > 0; j >>= 1) {
+        for (uint32_t l = 0; l < j; l++) {
+            sq_power_sum[l] += sq_power_sum[l + j];
+            var_sum[l] += var_sum[l + j];
+        }
+    }
+
+    // Compute the spectral kurtosis estimate
+    const float n = (float)g.sk_step - lost_samples[step];
+    const float cf = n / g.sk_step;
+    const float N = (float)(g.num_elements - num_bad_inputs);
+    const uint32_t address = freq + step * g.num_local_freq;
+    if (n * N == 0) {
+        sk[address] = -1.0;
+        sk_var[address] = -1.0;
+        sk_mask[address] = 1;
+        return;
+    }
+
+    const float new_sq_power_sum = sq_power_sum[0] * cf * cf;
+    float SK = ((n + 1) / (n - 1)) * ((new_sq_power_sum / (n * N)) - 1);
+    const float var = var_sum[0] / (n * N);
+
+    if (trunc_bias_switch) {
+        // Correct SK for the truncation bias
+        const float rms = sqrt((double)var);
+        float sk_correction = 0.f;
+        float rms_pow = 1.f;
+        for (int i = 0; i < SK_NUM_BIAS_COEFFS; i++) {
+            sk_correction += sk_bias_coeffs[i] * rms_pow;
+            rms_pow *= rms;
+        }
+        SK -= sk_correction;
+    }
+
+    sk[address] = SK;
+    const float sigma = sqrt((double)((4 * n * n) / (N * (n - 1) * (n + 2) * (n + 3))));
+    if (SK > 1 + rfi_sigma_cut * sigma || SK < 1 - rfi_sigma_cut * sigma)
+        sk_mask[address] = 1;
+    else
+        sk_mask[address] = 0;
+    sk_var[address] = var;
+}
+
+void sk_bad_input(const skGeometry& g, const float* time_sum, float* bad_input, uint32_t freq,
+                  uint32_t first_element, uint32_t num_elements) {
+    const size_t num_inputs = (size_t)g.num_elements * g.num_local_freq;
+    const uint32_t M = g.sk_step;
+    const uint32_t num_sk = g.num_sk_steps();
+    float* output = bad_input + freq * g.num_elements + first_element;
+
+    for (uint32_t e = 0; e < num_elements; e++)
+        output[e] = 0;
+    for (uint32_t i = 0; i < num_sk; i++) {
+        const float* input = time_sum + freq * g.num_elements + first_element + i * num_inputs;
+        for (uint32_t e = 0; e < num_elements; e++)
+            output[e] += (((float)M + 1) / ((float)M - 1)) * ((input[e] / M) - 1);
+    }
+    for (uint32_t e = 0; e < num_elements; e++)
+        output[e] = output[e] / num_sk;
+}
+
+void sk_zero_data(const skGeometry& g, uint8_t* input, const uint8_t* sk_mask, uint32_t freq,
+                  uint32_t step) {
+    if (sk_mask[freq + step * g.num_local_freq] != 1)
+        return;
+
+    const size_t num_inputs = (size_t)g.num_elements * g.num_local_freq;
+    for (uint32_t t = step * g.sk_step; t < (step + 1) * g.sk_step; t++)
+        memset(input + t * num_inputs + freq * g.num_elements, 0x88, g.num_elements);
+}
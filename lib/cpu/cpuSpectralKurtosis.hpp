@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @brief Spectral kurtosis RFI detection on the CPU, as in the CHIME GPU RFI kernels
+ *  - skGeometry
+ */
+
+#ifndef CPU_SPECTRAL_KURTOSIS_H
+#define CPU_SPECTRAL_KURTOSIS_H
+
+#include "Config.hpp" // for Config
+
+#include <stdint.h> // for uint32_t, uint8_t
+#include <string>   // for string
+
+/**
+ * @struct skGeometry
+ * @brief The shape of a frame of 4+4 bit samples, ordered [time][freq][element], and the
+ *        number of samples of each spectral kurtosis (SK) estimate.
+ *
+ * The functions below each compute one work item of the CHIME RFI kernels: a frequency and a
+ * block of @c sk_step samples, or a frequency and a range of elements. They can be run on
+ * all the work items of a frame in parallel. The inner loops run over the elements, which are
+ * contiguous in the input, and are vectorised by the compiler.
+ *
+ * The floating point operations are done in the same order as in the kernels, so the results
+ * are bit-for-bit those of a GPU computing the kernels without contracting multiplications and
+ * additions into FMAs. The source is built with @c -ffp-contract=off for this.
+ */
+struct skGeometry {
+    skGeometry(uint32_t num_elements, uint32_t num_local_freq, uint32_t samples_per_data_set,
+               uint32_t sk_step);
+    /// Reads @c num_elements, @c num_local_freq, @c samples_per_data_set and @c sk_step
+    skGeometry(kotekan::Config& config, const std::string& unique_name);
+
+    /// The number of SK estimates of each input and frequency in a frame
+    uint32_t num_sk_steps() const {
+        return samples_per_data_set / sk_step;
+    }
+
+    uint32_t num_elements;
+    uint32_t num_local_freq;
+    uint32_t samples_per_data_set;
+    uint32_t sk_step;
+};
+
+/**
+ * @brief Sums the power and the squared power of each element over a block of samples, like
+ *        the @c rfi_chime_time_sum kernel.
+ *
+ * @param geometry      The shape of the frame.
+ * @param input         The 4+4 bit samples of the frame.
+ * @param time_sum      The squared power sums, normalised by the squared mean power, as
+ *                      [sk_step][freq][element].
+ * @param time_sum_var  The power sums, in the same order.
+ * @param freq          The frequency of the work item.
+ * @param step          The block of @c sk_step samples of the work item.
+ */
+void sk_time_sum(const skGeometry& geometry, const uint8_t* input, float* time_sum,
+                 float* time_sum_var, uint32_t freq, uint32_t step);
+
+/**
+ * @brief Sums the time sums over the unmasked inputs, computes the SK estimate of the
+ *        incoherent beam and flags it as RFI, like the @c rfi_chime_input_sum kernel.
+ *
+ * The inputs are summed in 256 lanes, each lane over every 256th input, and the lanes are then
+ * summed pairwise, as in the work group of the kernel.
+ *
+ * @param geometry           The shape of the frame.
+ * @param time_sum           The output of @c sk_time_sum.
+ * @param time_sum_var       The output of @c sk_time_sum.
+ * @param input_mask         The weight of each input, 0 for a bad input and 1 otherwise.
+ * @param lost_samples       The number of lost samples in each block of @c sk_step samples.
+ * @param num_bad_inputs     The number of bad inputs.
+ * @param rfi_sigma_cut      The threshold of the SK estimates, in standard deviations.
+ * @param trunc_bias_switch  Whether to correct the estimates for the truncation bias.
+ * @param sk                 The SK estimates, as [sk_step][freq], -1 if all samples are lost.
+ * @param sk_var             The mean power, in the same order.
+ * @param sk_mask            1 for the blocks flagged as RFI and 0 otherwise.
+ * @param freq               The frequency of the work item.
+ * @param step               The block of @c sk_step samples of the work item.
+ */
+void sk_input_sum(const skGeometry& geometry, const float* time_sum, const float* time_sum_var,
+                  const uint8_t* input_mask, const uint32_t* lost_samples,
+                  uint32_t num_bad_inputs, uint32_t rfi_sigma_cut, bool trunc_bias_switch,
+                  float* sk, float* sk_var, uint8_t* sk_mask, uint32_t freq, uint32_t step);
+
+/**
+ * @brief Averages the SK estimates of each input over the frame, like the @c rfi_bad_input
+ *        kernel.
+ *
+ * @param geometry       The shape of the frame.
+ * @param time_sum       The output of @c sk_time_sum.
+ * @param bad_input      The mean SK estimates, as [freq][element].
+ * @param freq           The frequency of the work item.
+ * @param first_element  The first element of the work item.
+ * @param num_elements   The number of elements of the work item.
+ */
+void sk_bad_input(const skGeometry& geometry, const float* time_sum, float* bad_input,
+                  uint32_t freq, uint32_t first_element, uint32_t num_elements);
+
+/**
+ * @brief Sets the samples of a block flagged as RFI to zero (0x88), like the
+ *        @c rfi_chime_zero kernel.
+ *
+ * @param geometry  The shape of the frame.
+ * @param input     The 4+4 bit samples of the frame.
+ * @param sk_mask   The output of @c sk_input_sum.
+ * @param freq      The frequency of the work item.
+ * @param step      The block of @c sk_step samples of the work item.
+ */
+void sk_zero_data(const skGeometry& geometry, uint8_t* input, const uint8_t* sk_mask,
+                  uint32_t freq, uint32_t step);
+
+#endif // CPU_SPECTRAL_KURTOSIS_H
@@ -0,0 +1,30 @@
+#include "cpuSubframeCommand.hpp"
+
+#include "kotekanLogging.hpp" // for DEBUG2
+
+#include <stdexcept> // for runtime_error
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+cpuSubframeCommand::cpuSubframeCommand(Config& config, const std::string& unique_name,
+                                       bufferContainer& host_buffers, cpuDeviceInterface& device,
+                                       const std::string& default_kernel_command) :
+    cpuCommand(config, unique_name, host_buffers, device, default_kernel_command) {
+
+    _sub_frame_index = config.get_default<uint32_t>(unique_name, "sub_frame_index", 0);
+    _num_sub_frames = config.get_default<uint32_t>(unique_name, "num_sub_frames", 1);
+    uint32_t samples_per_data_set = config.get<uint32_t>(unique_name, "samples_per_data_set");
+    _sub_frame_samples = samples_per_data_set / _num_sub_frames;
+
+    if (_sub_frame_index >= _num_sub_frames) {
+        throw std::runtime_error("Index cannot be larger the number of subframes");
+    }
+
+    if (samples_per_data_set % _num_sub_frames != 0) {
+        throw std::runtime_error("The number of subframes must divide the number of samples");
+    }
+
+    DEBUG2("sub_frame_index: {:d}, num_sub_frames: {:d}, sub_frame_samples: {:d}", _sub_frame_index,
+           _num_sub_frames, _sub_frame_samples);
+}
@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @brief Base class for CPU commands working on a part of a frame
+ *  - cpuSubframeCommand : public cpuCommand
+ */
+
+#ifndef CPU_SUBFRAME_COMMAND_H
+#define CPU_SUBFRAME_COMMAND_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface
+
+#include <stdint.h> // for uint32_t
+#include <string>   // for string
+
+/**
+ * @class cpuSubframeCommand
+ * @brief A CPU command working on one of @c num_sub_frames parts of a frame, like
+ *        @c hsaSubframeCommand.
+ *
+ * @conf sub_frame_index  Int. The part of the frame. Default 0.
+ * @conf num_sub_frames   Int. The number of parts of the frame. Default 1.
+ */
+class cpuSubframeCommand : public cpuCommand {
+public:
+    cpuSubframeCommand(kotekan::Config& config, const std::string& unique_name,
+                       kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device,
+                       const std::string& default_kernel_command = "");
+    virtual ~cpuSubframeCommand() = default;
+
+protected:
+    uint32_t _sub_frame_samples;
+    uint32_t _sub_frame_index;
+    uint32_t _num_sub_frames;
+};
+
+#endif // CPU_SUBFRAME_COMMAND_H
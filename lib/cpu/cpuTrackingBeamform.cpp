@@ -0,0 +1,260 @@
+#include "cpuTrackingBeamform.hpp"
+
+#include "gpuCommand.hpp" // for gpuCommandType, gpuCommandType::KERNEL
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm> // for min
+#include <atomic>    // for atomic
+#include <stdexcept> // for runtime_error
+#include <string.h>  // for memset
+
+#if defined(__AVX2__)
+#include <immintrin.h> // for __m512, __m256, _mm512_fmadd_ps, _mm256_fmadd_ps, _mm...
+#endif
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+REGISTER_CPU_COMMAND(cpuTrackingBeamform);
+
+// The elements of a polarization
+#define TRACK_POL_ELEMENTS 1024
+// The samples which are unpacked and multiplied with the phases at a time
+#define TRACK_TILE_SAMPLES 8
+// The tiles a thread takes at a time
+#define TRACK_CHUNK_TILES 8
+
+// A vector of floats, one for each of TRACK_VEC_BEAMS beams
+#if defined(__AVX512F__)
+#define TRACK_VEC_BEAMS 16
+typedef __m512 track_vec_t;
+
+static inline track_vec_t track_vec_zero() {
+    return _mm512_setzero_ps();
+}
+static inline track_vec_t track_vec_load(const float* p) {
+    return _mm512_load_ps(p);
+}
+static inline track_vec_t track_vec_set1(float x) {
+    return _mm512_set1_ps(x);
+}
+// acc + a * b
+static inline track_vec_t track_vec_madd(track_vec_t a, track_vec_t b, track_vec_t acc) {
+    return _mm512_fmadd_ps(a, b, acc);
+}
+// acc - a * b
+static inline track_vec_t track_vec_nmadd(track_vec_t a, track_vec_t b, track_vec_t acc) {
+    return _mm512_fnmadd_ps(a, b, acc);
+}
+static inline void track_vec_store(float* p, track_vec_t v) {
+    _mm512_store_ps(p, v);
+}
+#elif defined(__AVX2__) && defined(__FMA__)
+#define TRACK_VEC_BEAMS 8
+typedef __m256 track_vec_t;
+
+static inline track_vec_t track_vec_zero() {
+    return _mm256_setzero_ps();
+}
+static inline track_vec_t track_vec_load(const float* p) {
+    return _mm256_load_ps(p);
+}
+static inline track_vec_t track_vec_set1(float x) {
+    return _mm256_set1_ps(x);
+}
+static inline track_vec_t track_vec_madd(track_vec_t a, track_vec_t b, track_vec_t acc) {
+    return _mm256_fmadd_ps(a, b, acc);
+}
+static inline track_vec_t track_vec_nmadd(track_vec_t a, track_vec_t b, track_vec_t acc) {
+    return _mm256_fnmadd_ps(a, b, acc);
+}
+static inline void track_vec_store(float* p, track_vec_t v) {
+    _mm256_store_ps(p, v);
+}
+#else
+// Plain C++ the compiler can vectorise
+#define TRACK_VEC_BEAMS 4
+struct track_vec_t {
+    float v[TRACK_VEC_BEAMS];
+};
+
+static inline track_vec_t track_vec_zero() {
+    return track_vec_t{};
+}
+static inline track_vec_t track_vec_load(const float* p) {
+    track_vec_t r;
+    for (int i = 0; i < TRACK_VEC_BEAMS; i++)
+        r.v[i] = p[i];
+    return r;
+}
+static inline track_vec_t track_vec_set1(float x) {
+    track_vec_t r;
+    for (int i = 0; i < TRACK_VEC_BEAMS; i++)
+        r.v[i] = x;
+    return r;
+}
+static inline track_vec_t track_vec_madd(track_vec_t a, track_vec_t b, track_vec_t acc) {
+    for (int i = 0; i < TRACK_VEC_BEAMS; i++)
+        acc.v[i] += a.v[i] * b.v[i];
+    return acc;
+}
+static inline track_vec_t track_vec_nmadd(track_vec_t a, track_vec_t b, track_vec_t acc) {
+    for (int i = 0; i < TRACK_VEC_BEAMS; i++)
+        acc.v[i] -= a.v[i] * b.v[i];
+    return acc;
+}
+static inline void track_vec_store(float* p, track_vec_t v) {
+    for (int i = 0; i < TRACK_VEC_BEAMS; i++)
+        p[i] = v.v[i];
+}
+#endif
+
+cpuTrackingBeamform::cpuTrackingBeamform(Config& config, const std::string& unique_name,
+                                         bufferContainer& host_buffers,
+                                         cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuTrackingBeamform") {
+    command_type = gpuCommandType::KERNEL;
+
+    _num_elements = config.get<int32_t>(unique_name, "num_elements");
+    _num_beams = config.get<int32_t>(unique_name, "num_beams");
+    _samples_per_data_set = config.get<int32_t>(unique_name, "samples_per_data_set");
+    _num_pol = config.get<int32_t>(unique_name, "num_pol");
+
+    if (_num_pol != 2 || _num_elements != _num_pol * TRACK_POL_ELEMENTS)
+        throw std::runtime_error(
+            fmt::format(fmt("The tracking beamformer needs 2 polarizations of {:d} elements"),
+                        TRACK_POL_ELEMENTS));
+    if (_num_beams < 1)
+        throw std::runtime_error("The tracking beamformer needs at least one beam");
+    if (_samples_per_data_set % TRACK_TILE_SAMPLES != 0)
+        throw std::runtime_error(
+            fmt::format(fmt("The samples_per_data_set ({:d}) must be a multiple of {:d}"),
+                        _samples_per_data_set, TRACK_TILE_SAMPLES));
+
+    input_frame_len = _num_elements * _samples_per_data_set;
+    output_frame_len = _samples_per_data_set * _num_beams * _num_pol;
+    phase_len = (_num_elements * _num_beams * 2 + _num_beams) * sizeof(float);
+
+    num_beam_blocks = (_num_beams + TRACK_VEC_BEAMS - 1) / TRACK_VEC_BEAMS;
+    packed_len = _num_pol * num_beam_blocks * TRACK_POL_ELEMENTS * 2 * TRACK_VEC_BEAMS;
+    unpacked_len = 2 * _num_elements * TRACK_TILE_SAMPLES;
+}
+
+cpuTrackingBeamform::~cpuTrackingBeamform() {}
+
+void cpuTrackingBeamform::pack_phases(const float* phase, float* packed) const {
+    // [pol][beam / TRACK_VEC_BEAMS][element][re, im][beam % TRACK_VEC_BEAMS], padded with zeros
+    memset(packed, 0, packed_len * sizeof(float));
+    for (int b = 0; b < _num_beams; b++) {
+        for (int p = 0; p < _num_pol; p++) {
+            const float* in = phase + (b * _num_pol + p) * TRACK_POL_ELEMENTS * 2;
+            float* out = packed
+                         + ((p * num_beam_blocks + b / TRACK_VEC_BEAMS) * TRACK_POL_ELEMENTS * 2)
+                               * TRACK_VEC_BEAMS
+                         + b % TRACK_VEC_BEAMS;
+            for (int n = 0; n < TRACK_POL_ELEMENTS; n++) {
+                out[(2 * n) * TRACK_VEC_BEAMS] = in[2 * n];
+                out[(2 * n + 1) * TRACK_VEC_BEAMS] = in[2 * n + 1];
+            }
+        }
+    }
+}
+
+void cpuTrackingBeamform::beamform_tile(const uint8_t* input, const float* packed,
+                                        const float* scaling, size_t t0, float* unpacked,
+                                        uint8_t* output) const {
+    // Unpack the tile with the samples of each element next to each other
+    float* x_re = unpacked;
+    float* x_im = unpacked + _num_elements * TRACK_TILE_SAMPLES;
+    for (size_t t = 0; t < TRACK_TILE_SAMPLES; t++) {
+        const uint8_t* in = input + (t0 + t) * _num_elements;
+        for (int e = 0; e < _num_elements; e++) {
+            x_re[e * TRACK_TILE_SAMPLES + t] = (float)(in[e] >> 4) - 8;
+            x_im[e * TRACK_TILE_SAMPLES + t] = (float)(in[e] & 0x0f) - 8;
+        }
+    }
+
+    alignas(64) float lane_re[TRACK_VEC_BEAMS];
+    alignas(64) float lane_im[TRACK_VEC_BEAMS];
+    for (int p = 0; p < _num_pol; p++) {
+        const float* pol_re = x_re + p * TRACK_POL_ELEMENTS * TRACK_TILE_SAMPLES;
+        const float* pol_im = x_im + p * TRACK_POL_ELEMENTS * TRACK_TILE_SAMPLES;
+        for (size_t block = 0; block < num_beam_blocks; block++) {
+            const float* phase =
+                packed + (p * num_beam_blocks + block) * TRACK_POL_ELEMENTS * 2 * TRACK_VEC_BEAMS;
+
+            // x * conj(phase) for each sample of the tile and beam of the block
+            track_vec_t acc_re[TRACK_TILE_SAMPLES], acc_im[TRACK_TILE_SAMPLES];
+            for (size_t t = 0; t < TRACK_TILE_SAMPLES; t++)
+                acc_re[t] = acc_im[t] = track_vec_zero();
+            for (int n = 0; n < TRACK_POL_ELEMENTS; n++) {
+                const track_vec_t ph_re = track_vec_load(phase + (2 * n) * TRACK_VEC_BEAMS);
+                const track_vec_t ph_im = track_vec_load(phase + (2 * n + 1) * TRACK_VEC_BEAMS);
+#pragma GCC unroll 8
+                for (size_t t = 0; t < TRACK_TILE_SAMPLES; t++) {
+                    const track_vec_t re = track_vec_set1(pol_re[n * TRACK_TILE_SAMPLES + t]);
+                    const track_vec_t im = track_vec_set1(pol_im[n * TRACK_TILE_SAMPLES + t]);
+                    acc_re[t] = track_vec_madd(re, ph_re, acc_re[t]);
+                    acc_re[t] = track_vec_madd(im, ph_im, acc_re[t]);
+                    acc_im[t] = track_vec_madd(im, ph_re, acc_im[t]);
+                    acc_im[t] = track_vec_nmadd(re, ph_im, acc_im[t]);
+                }
+            }
+
+            // Scale, offset encode, clamp and pack like the GPU kernel
+            const int num_lanes =
+                std::min<int>(TRACK_VEC_BEAMS, _num_beams - block * TRACK_VEC_BEAMS);
+            for (size_t t = 0; t < TRACK_TILE_SAMPLES; t++) {
+                track_vec_store(lane_re, acc_re[t]);
+                track_vec_store(lane_im, acc_im[t]);
+                for (int l = 0; l < num_lanes; l++) {
+                    const int b = block * TRACK_VEC_BEAMS + l;
+                    float re = lane_re[l] / scaling[b] + 8;
+                    float im = lane_im[l] / scaling[b] + 8;
+                    re = (re > 15) ? 15 : re;
+                    re = (re < 0) ? 0 : re;
+                    im = (im > 15) ? 15 : im;
+                    im = (im < 0) ? 0 : im;
+                    output[((t0 + t) * _num_beams + b) * _num_pol + p] =
+                        (((int)re << 4) & 0xF0) + ((int)im & 0x0F);
+                }
+            }
+        }
+    }
+}
+
+cpuEvent cpuTrackingBeamform::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    const uint8_t* input = (uint8_t*)device.get_gpu_memory("input_reordered", input_frame_len);
+    const float* phase =
+        (float*)device.get_gpu_memory_array("beamform_phase", gpu_frame_id, phase_len);
+    // The scaling factors are stored at the end of the phases
+    const float* scaling = phase + _num_elements * _num_beams * 2;
+    uint8_t* output =
+        (uint8_t*)device.get_gpu_memory_array("bf_tracking_output", gpu_frame_id, output_frame_len);
+    const size_t num_tiles = _samples_per_data_set / TRACK_TILE_SAMPLES;
+    const size_t num_workers = std::min<size_t>(
+        device.get_num_threads(), (num_tiles + TRACK_CHUNK_TILES - 1) / TRACK_CHUNK_TILES);
+    float* scratch = (float*)device.get_gpu_memory(
+        "tracking_scratch",
+        (packed_len + device.get_num_threads() * unpacked_len) * sizeof(float));
+
+    cpuDeviceInterface& dev = device;
+    return enqueue(gpu_frame_id, pre_event, [=, &dev]() {
+        pack_phases(phase, scratch);
+
+        std::atomic<size_t> next_tile(0);
+        dev.parallel_for(num_workers, [&](size_t thread) {
+            float* unpacked = scratch + packed_len + thread * unpacked_len;
+            for (size_t tile = next_tile.fetch_add(TRACK_CHUNK_TILES); tile < num_tiles;
+                 tile = next_tile.fetch_add(TRACK_CHUNK_TILES)) {
+                const size_t end = std::min<size_t>(tile + TRACK_CHUNK_TILES, num_tiles);
+                for (size_t t = tile; t < end; t++)
+                    beamform_tile(input, scratch, scaling, t * TRACK_TILE_SAMPLES, unpacked,
+                                  output);
+            }
+        });
+    });
+}
@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @brief Tracking beamformer as a complex matrix product on the CPU
+ *  - cpuTrackingBeamform : public cpuCommand
+ */
+
+#ifndef CPU_TRACKING_BEAMFORM_H
+#define CPU_TRACKING_BEAMFORM_H
+
+#include "Config.hpp"             // for Config
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for int32_t, uint8_t
+#include <string>   // for string
+
+/**
+ * @class cpuTrackingBeamform
+ * @brief Forms the tracking beams of the reordered input, in the output format of
+ *        @c hsaTrackingBeamform.
+ *
+ * The beams of each polarization are the product of the input (samples x 1024 elements)
+ * and the conjugate of the phases of @c cpuTrackingUpdatePhase (1024 elements x beams), so
+ * they are computed as one complex matrix product per polarization. The phases are packed
+ * with the beams in the lanes of SIMD vectors, and tiles of samples are unpacked to
+ * @c float and multiplied with them, the tiles being split over the threads of the device.
+ * Unlike the GPU kernel, the number of beams isn't limited by the kernel, it only sets the
+ * size of the matrix product.
+ *
+ * The beams are divided by their scaling factor, offset by 8, clamped to [0, 15] and
+ * packed as 4+4 bit complex numbers like the GPU kernel. The sums are done in a different
+ * order, so a few values which are close to the boundaries of the 4 bit bins can differ.
+ *
+ * @par GPU Memory
+ * @gpu_mem  input_reordered     The reordered input data
+ *     @gpu_mem_type             static
+ *     @gpu_mem_format           Array of 4+4 bit complex samples, [time][pol][element]
+ * @gpu_mem  beamform_phase      The phases, [beam][pol][element], followed by the
+ *                               scaling factor of each beam
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of @c float (re, im) pairs, then @c float
+ * @gpu_mem  bf_tracking_output  The tracking beams, [time][beam][pol]
+ *     @gpu_mem_type             staging
+ *     @gpu_mem_format           Array of 4+4 bit complex numbers
+ * @gpu_mem  tracking_scratch    The packed phases, and the unpacked input of each thread
+ *     @gpu_mem_type             static
+ *     @gpu_mem_format           Array of @c float
+ *
+ * @conf   num_elements          Int. Number of elements, must be 2048.
+ * @conf   num_beams             Int. Number of tracking beams.
+ * @conf   samples_per_data_set  Int. Number of time samples in a data set, a multiple of 8.
+ * @conf   num_pol               Int. Number of polarizations, must be 2.
+ */
+class cpuTrackingBeamform : public cpuCommand {
+public:
+    cpuTrackingBeamform(kotekan::Config& config, const std::string& unique_name,
+                        kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuTrackingBeamform();
+
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+private:
+    /// Packs the phases of @p phase with the beams in the lanes into @p packed
+    void pack_phases(const float* phase, float* packed) const;
+
+    /// Forms the beams of a tile of samples starting at @p t0
+    void beamform_tile(const uint8_t* input, const float* packed, const float* scaling,
+                       size_t t0, float* unpacked, uint8_t* output) const;
+
+    int32_t input_frame_len;
+    int32_t output_frame_len;
+    /// The phases and the scaling factors, in bytes
+    int32_t phase_len;
+    /// The floats of the packed phases
+    size_t packed_len;
+    /// The floats of unpacked input of a thread
+    size_t unpacked_len;
+    /// The number of vectors of beams
+    size_t num_beam_blocks;
+
+    int32_t _num_elements;
+    int32_t _num_beams;
+    int32_t _samples_per_data_set;
+    int32_t _num_pol;
+};
+
+#endif // CPU_TRACKING_BEAMFORM_H
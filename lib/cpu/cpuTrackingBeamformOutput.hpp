@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @brief Copy of the tracking beams to the host on the CPU
+ *  - cpuTrackingBeamformOutput : public cpuCommand
+ */
+
+#ifndef CPU_TRACKING_BEAMFORM_OUTPUT_H
+#define CPU_TRACKING_BEAMFORM_OUTPUT_H
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include <stdint.h> // for int32_t
+#include <string>   // for string
+
+/**
+ * @class cpuTrackingBeamformOutput
+ * @brief Copies @c bf_tracking_output to @c beamform_tracking_output_buf and passes on the
+ *        metadata, like @c hsaTrackingBeamformOutput.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input data, for its metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ * @buffer beamform_tracking_output_buf  The tracking beams.
+ *     @buffer_format Array of 4+4 bit complex numbers, [time][beam][pol]
+ *     @buffer_metadata chimeMetadata
+ *
+ * @par GPU Memory
+ * @gpu_mem  bf_tracking_output  The tracking beams.
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of 4+4 bit complex numbers, [time][beam][pol]
+ */
+class cpuTrackingBeamformOutput : public cpuCommand {
+public:
+    cpuTrackingBeamformOutput(kotekan::Config& config, const std::string& unique_name,
+                              kotekan::bufferContainer& host_buffers,
+                              cpuDeviceInterface& device);
+    virtual ~cpuTrackingBeamformOutput();
+
+    int wait_on_precondition(int gpu_frame_id) override;
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+    void finalize_frame(int frame_id) override;
+
+private:
+    Buffer* network_buffer;
+    int32_t network_buffer_id;
+    int32_t network_buffer_precondition_id;
+
+    Buffer* output_buffer;
+    int32_t output_buffer_id;
+    int32_t output_buffer_precondition_id;
+    int32_t output_buffer_execute_id;
+};
+
+#endif // CPU_TRACKING_BEAMFORM_OUTPUT_H
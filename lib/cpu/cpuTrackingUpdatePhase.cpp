@@ -0,0 +1,308 @@
+// curl localhost:12048/updatable_config/tracking_pointing/0 -X POST -H 'Content-Type:
+// application/json' -d '{"ra":100.3, "dec":34.23, "scaling":99}'
+
+#include "cpuTrackingUpdatePhase.hpp"
+
+#include "chimeMetadata.hpp"  // for beamCoord, MAX_NUM_BEAMS, get_fpga_seq_num, get_gps_time
+#include "configUpdater.hpp"  // for configUpdater
+#include "gpuCommand.hpp"     // for gpuCommandType, gpuCommandType::COPY_IN
+#include "kotekanLogging.hpp" // for DEBUG, INFO, WARN
+#include "visUtil.hpp"        // for double_to_ts
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm> // for clamp, min
+#include <cmath>     // for cos, sin, fmod, acos, asin, sqrt, atan2, pow
+#include <exception> // for exception
+#include <stdexcept> // for runtime_error
+#include <string.h>  // for memcpy, memcmp
+#include <time.h>    // for tm, localtime_r
+
+#define PI 3.14159265
+#define one_over_c 0.0033356
+#define D2R PI / 180.
+#define TAU 2 * PI
+#define inst_long -119.6175
+#define inst_lat 49.3203
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+using kotekan::configUpdater;
+
+REGISTER_CPU_COMMAND(cpuTrackingUpdatePhase);
+
+// The cylinders, and the feeds of a cylinder
+#define TRACK_NUM_CYL 4
+#define TRACK_CYL_FEEDS 256
+
+cpuTrackingUpdatePhase::cpuTrackingUpdatePhase(Config& config, const std::string& unique_name,
+                                               bufferContainer& host_buffers,
+                                               cpuDeviceInterface& device) :
+    cpuCommand(config, unique_name, host_buffers, device, "cpuTrackingUpdatePhase") {
+    command_type = gpuCommandType::COPY_IN;
+
+    _num_elements = config.get<int32_t>(unique_name, "num_elements");
+    _num_beams = config.get<int32_t>(unique_name, "num_beams");
+    _feed_sep_NS = config.get<float>(unique_name, "feed_sep_NS");
+    _feed_sep_EW = config.get<int32_t>(unique_name, "feed_sep_EW");
+    if (_num_elements != 2 * TRACK_NUM_CYL * TRACK_CYL_FEEDS)
+        throw std::runtime_error(fmt::format(fmt("The tracking beams need {:d} elements"),
+                                             2 * TRACK_NUM_CYL * TRACK_CYL_FEEDS));
+    if (_num_beams > MAX_NUM_BEAMS)
+        INFO("Forming {:d} tracking beams, only the pointing of the first {:d} is in the "
+             "metadata",
+             _num_beams, MAX_NUM_BEAMS);
+
+    metadata_buf = host_buffers.get_buffer("network_buf");
+    register_consumer(metadata_buf, unique_name.c_str());
+    metadata_buffer_id = 0;
+    metadata_buffer_precondition_id = 0;
+    freq_idx = FREQ_ID_NOT_SET;
+    freq_MHz = -1;
+
+    gain_len = 2 * _num_elements * _num_beams * sizeof(float);
+    host_gain.resize(2 * _num_elements * _num_beams);
+    gain_buf = host_buffers.get_buffer("gain_tracking_buf");
+    register_consumer(gain_buf, unique_name.c_str());
+    gain_buf_id = 0;
+    if (gain_len != gain_buf->frame_size)
+        throw std::runtime_error("The gain_len in does not match the buffer frame size");
+
+    phase_frame_len = _num_elements * _num_beams * 2 * sizeof(float);
+    scaling_frame_len = _num_beams * sizeof(float);
+    host_phase = std::make_shared<std::vector<float>>(
+        (phase_frame_len + scaling_frame_len) / sizeof(float), 0.f);
+    phase_version = 0;
+    frame_phase_version.assign(_gpu_buffer_depth, 0);
+
+    // The feed positions don't change
+    for (int i = 0; i < TRACK_NUM_CYL; i++) {
+        for (int j = 0; j < TRACK_CYL_FEEDS; j++) {
+            float dist_y = j * _feed_sep_NS;
+            float dist_x = i * _feed_sep_EW;
+            feed_projection_angle.push_back(90 * D2R - atan2(dist_y, dist_x));
+            feed_distance.push_back(sqrt(pow(dist_y, 2) + pow(dist_x, 2)));
+        }
+    }
+
+    pointing.assign(_num_beams, beamPointing{0, 0, 1});
+    pointing_update = pointing;
+    beam_changed.assign(_num_beams, true);
+    second_last = 0;
+    first_pass = true;
+
+    // Listen for new pointings, this also sets the initial ones
+    for (int beam_id = 0; beam_id < _num_beams; beam_id++) {
+        configUpdater::instance().subscribe(
+            config.get<std::string>(unique_name, "updatable_config/tracking_pt") + "/"
+                + std::to_string(beam_id),
+            [beam_id, this](nlohmann::json& json_msg) -> bool {
+                return tracking_grab_callback(json_msg, beam_id);
+            });
+    }
+}
+
+cpuTrackingUpdatePhase::~cpuTrackingUpdatePhase() {}
+
+int cpuTrackingUpdatePhase::wait_on_precondition(int gpu_frame_id) {
+    (void)gpu_frame_id;
+    uint8_t* frame =
+        wait_for_full_frame(metadata_buf, unique_name.c_str(), metadata_buffer_precondition_id);
+    if (frame == nullptr)
+        return -1;
+    metadata_buffer_precondition_id =
+        (metadata_buffer_precondition_id + 1) % metadata_buf->num_frames;
+
+    // Wait for the first gains, and then take new gains when there are any
+    if (first_pass) {
+        frame = wait_for_full_frame(gain_buf, unique_name.c_str(), gain_buf_id);
+        if (frame == nullptr)
+            return -1;
+    } else {
+        auto timeout = double_to_ts(0);
+        int status =
+            wait_for_full_frame_timeout(gain_buf, unique_name.c_str(), gain_buf_id, timeout);
+        if (status == -1)
+            return -1;
+        if (status != 0)
+            return 0;
+    }
+
+    const float* gains = (float*)gain_buf->frames[gain_buf_id];
+    const size_t beam_len = 2 * _num_elements;
+    int num_changed = 0;
+    {
+        std::lock_guard<std::mutex> lock(_beam_lock);
+        for (int b = 0; b < _num_beams; b++) {
+            if (first_pass
+                || memcmp(&host_gain[b * beam_len], gains + b * beam_len, beam_len * sizeof(float))
+                       != 0) {
+                memcpy(&host_gain[b * beam_len], gains + b * beam_len, beam_len * sizeof(float));
+                beam_changed[b] = true;
+                num_changed++;
+            }
+        }
+    }
+    DEBUG("New gains from {:s}[{:d}] for {:d} beams", gain_buf->buffer_name, gain_buf_id,
+          num_changed);
+    mark_frame_empty(gain_buf, unique_name.c_str(), gain_buf_id);
+    gain_buf_id = (gain_buf_id + 1) % gain_buf->num_frames;
+    return 0;
+}
+
+double cpuTrackingUpdatePhase::local_sidereal_time(timespec time_now) const {
+    struct tm timeinfo;
+    localtime_r(&time_now.tv_sec, &timeinfo);
+    uint32_t year = timeinfo.tm_year + 1900;
+    uint32_t month = timeinfo.tm_mon + 1;
+    if (month < 3) {
+        month = month + 12;
+        year = year - 1;
+    }
+    uint32_t day = timeinfo.tm_mday;
+    float JD = 2 - int(year / 100.) + int(int(year / 100.) / 4.) + int(365.25 * year)
+               + int(30.6001 * (month + 1)) + day + 1720994.5;
+    double T = (JD - 2451545.0) / 36525.0;
+    double T0 = fmod((6.697374558 + (2400.051336 * T) + (0.000025862 * T * T)), 24.);
+    double UT = (timeinfo.tm_hour) + (timeinfo.tm_min / 60.)
+                + (timeinfo.tm_sec + time_now.tv_nsec / 1.e9) / 3600.;
+    double GST = fmod((T0 + UT * 1.002737909), 24.);
+    double LST = GST + inst_long / 15.;
+    while (LST < 0) {
+        LST = LST + 24;
+    }
+    return fmod(LST, 24);
+}
+
+void cpuTrackingUpdatePhase::calculate_phase(int b, double lst, float* phase) const {
+    const float* gains = &host_gain[b * _num_elements * 2];
+    float* output = phase + b * _num_elements * 2;
+    const beamPointing& pt = pointing[b];
+
+    // A scaling of 1 means just the gains, see hsaTrackingUpdatePhase
+    if (pt.scaling == 1) {
+        memcpy(output, gains, _num_elements * 2 * sizeof(float));
+        return;
+    }
+
+    float FREQ = freq_MHz;
+    double hour_angle = lst * 15. - pt.ra;
+    double alt = sin(pt.dec * D2R) * sin(inst_lat * D2R)
+                 + cos(pt.dec * D2R) * cos(inst_lat * D2R) * cos(hour_angle * D2R);
+    alt = asin(std::clamp(alt, -1.0, 1.0));
+    double az = (sin(pt.dec * D2R) - sin(alt) * sin(inst_lat * D2R))
+                / (cos(alt) * cos(inst_lat * D2R));
+    az = acos(std::clamp(az, -1.0, 1.0));
+    if (sin(hour_angle * D2R) >= 0) {
+        az = TAU - az;
+    }
+    for (int i = 0; i < TRACK_NUM_CYL; i++) {
+        for (int j = 0; j < TRACK_CYL_FEEDS; j++) {
+            const int feed = i * TRACK_CYL_FEEDS + j;
+            double effective_angle = feed_projection_angle[feed] - az;
+            float delay_real = cos(TAU * cos(effective_angle) * cos(alt) * feed_distance[feed]
+                                   * FREQ * one_over_c);
+            float delay_imag = -sin(TAU * cos(effective_angle) * cos(-alt) * feed_distance[feed]
+                                    * FREQ * one_over_c);
+            for (int p = 0; p < 2; p++) {
+                const int e = p * TRACK_NUM_CYL * TRACK_CYL_FEEDS + feed;
+                output[e * 2] = delay_real * gains[e * 2] - delay_imag * gains[e * 2 + 1];
+                output[e * 2 + 1] = delay_real * gains[e * 2 + 1] + delay_imag * gains[e * 2];
+            }
+        }
+    }
+}
+
+cpuEvent cpuTrackingUpdatePhase::execute(int gpu_frame_id, const cpuEvent& pre_event) {
+    pre_execute(gpu_frame_id);
+
+    if (first_pass) {
+        first_pass = false;
+        auto& tel = Telescope::instance();
+        freq_idx = tel.to_freq_id(metadata_buf, metadata_buffer_id);
+        freq_MHz = tel.to_freq(freq_idx);
+    }
+
+    // The pointed beams move every second
+    const uint64_t phase_update_period = 390625;
+    uint64_t current_seq = get_fpga_seq_num(metadata_buf, metadata_buffer_id);
+    uint32_t second_now = (current_seq / phase_update_period) % 2;
+    const bool new_second = second_now != second_last;
+    second_last = second_now;
+
+    {
+        std::lock_guard<std::mutex> lock(_beam_lock);
+        std::vector<int> beams;
+        for (int b = 0; b < _num_beams; b++) {
+            if (beam_changed[b] || (new_second && pointing[b].scaling != 1)) {
+                pointing[b] = pointing_update[b];
+                beam_changed[b] = false;
+                beams.push_back(b);
+            }
+        }
+
+        if (!beams.empty()) {
+            timespec time_now_gps = get_gps_time(metadata_buf, metadata_buffer_id);
+            if (time_now_gps.tv_sec == 0)
+                WARN("GPS time appears to be zero, bad news for beam timing!");
+            const double lst = local_sidereal_time(time_now_gps);
+
+            // A new version, so the frames in flight keep theirs
+            auto phase = std::make_shared<std::vector<float>>(*host_phase);
+            float* scaling = phase->data() + _num_elements * _num_beams * 2;
+            for (int b : beams) {
+                calculate_phase(b, lst, phase->data());
+                // See hsaTrackingUpdatePhase::copy_scaling for the 0.5
+                scaling[b] = pointing[b].scaling == 1 ? 1 : pointing[b].scaling + 0.5;
+            }
+            host_phase = phase;
+            phase_version++;
+            DEBUG("Updated the phases of {:d} of {:d} beams", beams.size(), _num_beams);
+        }
+    }
+
+    beamCoord beam_coord = {};
+    for (int b = 0; b < std::min(_num_beams, MAX_NUM_BEAMS); b++) {
+        beam_coord.ra[b] = pointing[b].ra;
+        beam_coord.dec[b] = pointing[b].dec;
+        beam_coord.scaling[b] = pointing[b].scaling;
+    }
+    set_beam_coord(metadata_buf, metadata_buffer_id, beam_coord);
+    mark_frame_empty(metadata_buf, unique_name.c_str(), metadata_buffer_id);
+    metadata_buffer_id = (metadata_buffer_id + 1) % metadata_buf->num_frames;
+
+    // The frame still has the current phases
+    if (frame_phase_version[gpu_frame_id] == phase_version)
+        return pre_event;
+    frame_phase_version[gpu_frame_id] = phase_version;
+
+    void* gpu_memory_frame = device.get_gpu_memory_array("beamform_phase", gpu_frame_id,
+                                                         phase_frame_len + scaling_frame_len);
+    std::shared_ptr<const std::vector<float>> phase = host_phase;
+    return enqueue(gpu_frame_id, pre_event, [=]() {
+        memcpy(gpu_memory_frame, phase->data(), phase->size() * sizeof(float));
+    });
+}
+
+bool cpuTrackingUpdatePhase::tracking_grab_callback(nlohmann::json& json,
+                                                    const uint32_t beam_id) {
+    beamPointing pt;
+    try {
+        pt.ra = json.at("ra").get<float>();
+        pt.dec = json.at("dec").get<float>();
+        pt.scaling = json.at("scaling").get<int>();
+    } catch (std::exception const& e) {
+        WARN("[TRACKING] Pointing update failed to read the RA, Dec and scaling factor of beam "
+             "{:d}. {:s}",
+             beam_id, e.what());
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_beam_lock);
+        pointing_update[beam_id] = pt;
+        beam_changed[beam_id] = true;
+    }
+    INFO("[tracking] Updated Beam={:d} RA={:.2f} Dec={:.2f} Scl={:d}", beam_id, pt.ra, pt.dec,
+         pt.scaling);
+    return true;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file
+ * @brief Tracking beam phases for the CPU tracking beamformer
+ *  - cpuTrackingUpdatePhase : public cpuCommand
+ */
+
+#ifndef CPU_TRACKING_UPDATE_PHASE_H
+#define CPU_TRACKING_UPDATE_PHASE_H
+
+#include "Config.hpp"             // for Config
+#include "Telescope.hpp"          // for freq_id_t
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "cpuCommand.hpp"         // for cpuCommand
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+
+#include "json.hpp" // for json
+
+#include <memory>   // for shared_ptr
+#include <mutex>    // for mutex
+#include <stdint.h> // for int32_t, uint32_t, uint64_t
+#include <string>   // for string
+#include <time.h>   // for timespec
+#include <vector>   // for vector
+
+/**
+ * @class cpuTrackingUpdatePhase
+ * @brief Computes the phases of the tracking beams like @c hsaTrackingUpdatePhase, but only
+ *        recomputes and copies what changed.
+ *
+ * The phases of a beam are the geometric delays of its pointing, from the time and freq of
+ * the frame, multiplied by its gains from @c ReadGain, followed by the scaling factor of
+ * each beam (see @c hsaTrackingUpdatePhase). The result is kept on the host:
+ *  - a pointing update via the @c tracking_pt endpoints recomputes only that beam,
+ *  - new gains recompute only the beams whose gains changed,
+ *  - every second the beams with a pointing are recomputed for the new time, beams with a
+ *    scaling of 1 are just their gains and are left alone,
+ * and the feed positions are computed once. Each update makes a new version of the phases,
+ * the frames in flight keep the one they were given, and a GPU frame only gets a copy when
+ * its @c beamform_phase is older than the current version.
+ *
+ * There is no limit on the number of beams, but only the first @c MAX_NUM_BEAMS pointings
+ * are stored in the metadata.
+ *
+ * @par Buffers
+ * @buffer network_buf  The input, for the freq, time and metadata.
+ *     @buffer_format Array of 4+4 bit complex samples
+ *     @buffer_metadata chimeMetadata
+ * @buffer gain_tracking_buf  The gains of each beam.
+ *     @buffer_format Array of @c float (re, im) pairs, [beam][element]
+ *     @buffer_metadata none
+ *
+ * @par GPU Memory
+ * @gpu_mem  beamform_phase  The phases, [beam][pol][element], followed by the scaling
+ *                           factor of each beam
+ *     @gpu_mem_type         staging
+ *     @gpu_mem_format       Array of @c float (re, im) pairs, then @c float
+ *
+ * @conf   num_elements         Int. Number of elements, must be 2048.
+ * @conf   num_beams            Int. Number of tracking beams.
+ * @conf   feed_sep_NS          Float. N-S feed separation in m.
+ * @conf   feed_sep_EW          Int. E-W feed separation in m.
+ * @conf   updatable_config/tracking_pt  String. Path of the updatable block with the
+ *                              "ra", "dec" and "scaling" of each beam in @c 0, @c 1, ...
+ */
+class cpuTrackingUpdatePhase : public cpuCommand {
+public:
+    cpuTrackingUpdatePhase(kotekan::Config& config, const std::string& unique_name,
+                           kotekan::bufferContainer& host_buffers, cpuDeviceInterface& device);
+    virtual ~cpuTrackingUpdatePhase();
+
+    /// Waits for the metadata, and takes new gains if there are any
+    int wait_on_precondition(int gpu_frame_id) override;
+
+    /// Updates the phases which changed, and copies them to the frame if it is out of date
+    cpuEvent execute(int gpu_frame_id, const cpuEvent& pre_event) override;
+
+    /// Endpoint for a new tracking target (RA, Dec, scaling) of beam @p beam_id
+    bool tracking_grab_callback(nlohmann::json& json, const uint32_t beam_id);
+
+private:
+    /// The pointing of a beam
+    struct beamPointing {
+        float ra;
+        float dec;
+        uint32_t scaling;
+    };
+
+    /// Returns the local sidereal time in hours at @p time_now
+    double local_sidereal_time(timespec time_now) const;
+
+    /// Computes the phases of beam @p b at the local sidereal time @p lst into @p phase
+    void calculate_phase(int b, double lst, float* phase) const;
+
+    int32_t phase_frame_len;
+    int32_t scaling_frame_len;
+
+    Buffer* gain_buf;
+    int32_t gain_len;
+    int32_t gain_buf_id;
+    /// The gains of each beam, [beam][element]
+    std::vector<float> host_gain;
+
+    Buffer* metadata_buf;
+    int32_t metadata_buffer_id;
+    int32_t metadata_buffer_precondition_id;
+
+    /// The pointing used for the phases of each beam
+    std::vector<beamPointing> pointing;
+    /// The latest pointing of each beam from the endpoints
+    std::vector<beamPointing> pointing_update;
+    /// Which beams need new phases
+    std::vector<bool> beam_changed;
+    /// Guards pointing_update, beam_changed and host_gain
+    std::mutex _beam_lock;
+
+    /// The projection angle and the distance of each feed of a polarization
+    std::vector<double> feed_projection_angle;
+    std::vector<double> feed_distance;
+
+    /// The current phases, then the scaling factors
+    std::shared_ptr<const std::vector<float>> host_phase;
+    /// The version of host_phase, and the version in each GPU frame
+    uint64_t phase_version;
+    std::vector<uint64_t> frame_phase_version;
+
+    freq_id_t freq_idx;
+    float freq_MHz;
+
+    uint32_t _num_elements;
+    int32_t _num_beams;
+    float _feed_sep_NS;
+    int32_t _feed_sep_EW;
+
+    /// Keep track of the passing of time, in order to update the phases every second
+    uint32_t second_last;
+    bool first_pass;
+};
+
+#endif // CPU_TRACKING_UPDATE_PHASE_H
@@ -35,7 +35,9 @@ void cudaCommand::finalize_frame(int gpu_frame_id) {
             float exec_time;
             CHECK_CUDA_ERROR(cudaEventElapsedTime(&exec_time, pre_events[gpu_frame_id],
                                                   post_events[gpu_frame_id]));
-            last_gpu_execution_time = exec_time * 1e-3; // convert ms to s
+            // The duration is more precise than the difference of the times
+            double start_time = device.get_event_time(pre_events[gpu_frame_id]);
+            record_execution(gpu_frame_id, start_time, start_time + exec_time * 1e-3, true);
         }
         CHECK_CUDA_ERROR(cudaEventDestroy(pre_events[gpu_frame_id]));
         pre_events[gpu_frame_id] = nullptr;
@@ -1,11 +1,29 @@
 #include "cudaDeviceInterface.hpp"
 
+#include "hostMemoryPool.h" // for host_pool_register_runtime, host_pool_unregister_runtime
 #include "math.h"
 
 #include <errno.h>
 
 using kotekan::Config;
 
+// Pins the host memory of the pool for all the GPUs, so the copies to and from it use DMA
+static int cuda_host_pin(void* ptr, size_t len, void* ctx) {
+    (void)ctx;
+    cudaError_t err = cudaHostRegister(ptr, len, cudaHostRegisterPortable);
+    if (err != cudaSuccess) {
+        WARN_NON_OO("Error at cudaHostRegister: {:s}", cudaGetErrorString(err));
+        return -1;
+    }
+    return 0;
+}
+
+static void cuda_host_unpin(void* ptr, size_t len, void* ctx) {
+    (void)len;
+    (void)ctx;
+    CHECK_CUDA_ERROR_NON_OO(cudaHostUnregister(ptr));
+}
+
 cudaDeviceInterface::cudaDeviceInterface(Config& config_, int32_t gpu_id_, int gpu_buffer_depth_) :
     gpuDeviceInterface(config_, gpu_id_, gpu_buffer_depth_) {
 
@@ -15,13 +33,18 @@ cudaDeviceInterface::cudaDeviceInterface(Config& config_, int32_t gpu_id_, int g
     INFO("Number of CUDA GPUs: %d", max_num_gpus);
 
     cudaSetDevice(gpu_id);
+
+    host_pool_register_runtime("cuda", cuda_host_pin, cuda_host_unpin, nullptr);
 }
 
 cudaDeviceInterface::~cudaDeviceInterface() {
     for (int i = 0; i < NUM_STREAMS; ++i) {
         CHECK_CUDA_ERROR(cudaStreamDestroy(stream[i]));
     }
+    if (reference_event)
+        CHECK_CUDA_ERROR(cudaEventDestroy(reference_event));
     cleanup_memory();
+    host_pool_unregister_runtime("cuda");
 }
 
 void* cudaDeviceInterface::alloc_gpu_memory(int len) {
@@ -51,6 +74,15 @@ void cudaDeviceInterface::prepareStreams() {
     for (int i = 0; i < NUM_STREAMS; ++i) {
         CHECK_CUDA_ERROR(cudaStreamCreate(&stream[i]));
     }
+    CHECK_CUDA_ERROR(cudaEventCreate(&reference_event));
+    CHECK_CUDA_ERROR(cudaEventRecord(reference_event, getStream(CUDA_INPUT_STREAM)));
+    CHECK_CUDA_ERROR(cudaEventSynchronize(reference_event));
+}
+
+double cudaDeviceInterface::get_event_time(cudaEvent_t event) {
+    float time_ms;
+    CHECK_CUDA_ERROR(cudaEventElapsedTime(&time_ms, reference_event, event));
+    return time_ms * 1e-3;
 }
 void cudaDeviceInterface::async_copy_host_to_gpu(void* dst, void* src, size_t len,
                                                  cudaEvent_t pre_event, cudaEvent_t& copy_pre_event,
@@ -42,6 +42,13 @@ public:
     void prepareStreams();
     cudaStream_t getStream(int param_Dim);
 
+    /**
+     * @brief Returns the time of @p event on the device clock in seconds, i.e. the time since
+     *        an event recorded when the streams were made. Events only have the elapsed time
+     *        between two events in @c float ms, so the resolution drops to ~1 ms after hours.
+     */
+    double get_event_time(cudaEvent_t event);
+
     /**
      * @brief Asynchronous copies memory from the host (CPU RAM) to the device GPU (global memory)
      *
@@ -78,6 +85,8 @@ protected:
 
     // Extra data
     cudaStream_t stream[NUM_STREAMS];
+    /// The event which is time 0 of get_event_time
+    cudaEvent_t reference_event = nullptr;
 
 private:
 };
@@ -1,5 +1,7 @@
 #include "cudaInputData.hpp"
 
+#include "hostMemoryPool.h" // for host_pool_is_pinned
+
 using kotekan::bufferContainer;
 using kotekan::Config;
 
@@ -11,14 +13,7 @@ cudaInputData::cudaInputData(Config& config, const std::string& unique_name,
 
     in_buf = host_buffers.get_buffer("in_buf");
     register_consumer(in_buf, unique_name.c_str());
-
-    for (int i = 0; i < in_buf->num_frames; i++) {
-        uint flags;
-        // only register the memory if it isn't already...
-        if (cudaErrorInvalidValue == cudaHostGetFlags(&flags, in_buf->frames[i])) {
-            CHECK_CUDA_ERROR(cudaHostRegister(in_buf->frames[i], in_buf->frame_size, 0));
-        }
-    }
+    // The frames are pinned by the host memory pool, so are copied straight with DMA
 
     in_buffer_id = 0;
     in_buffer_precondition_id = 0;
@@ -27,16 +22,6 @@ cudaInputData::cudaInputData(Config& config, const std::string& unique_name,
     command_type = gpuCommandType::COPY_IN;
 }
 
-cudaInputData::~cudaInputData() {
-    for (int i = 0; i < in_buf->num_frames; i++) {
-        uint flags;
-        // only unregister if it's already been registered
-        if (cudaSuccess == cudaHostGetFlags(&flags, in_buf->frames[i])) {
-            CHECK_CUDA_ERROR(cudaHostUnregister(in_buf->frames[i]));
-        }
-    }
-}
-
 int cudaInputData::wait_on_precondition(int gpu_frame_id) {
     (void)gpu_frame_id;
 
@@ -57,6 +42,13 @@ cudaEvent_t cudaInputData::execute(int gpu_frame_id, cudaEvent_t pre_event) {
     void* gpu_memory_frame = device.get_gpu_memory_array("input", gpu_frame_id, input_frame_len);
     void* host_memory_frame = (void*)in_buf->frames[in_buffer_id];
 
+    // A frame swapped in from outside the host memory pool isn't pinned, so isn't copied with DMA
+    if (!warned_unpinned && !host_pool_is_pinned(host_memory_frame, input_frame_len)) {
+        WARN("Frame {:d} of {:s} isn't pinned, copying it without DMA.", in_buffer_id,
+             in_buf->buffer_name);
+        warned_unpinned = true;
+    }
+
     device.async_copy_host_to_gpu(gpu_memory_frame, host_memory_frame, input_frame_len, pre_event,
                                   pre_events[gpu_frame_id], post_events[gpu_frame_id]);
 
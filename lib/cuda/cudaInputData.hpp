@@ -28,7 +28,6 @@ class cudaInputData : public cudaCommand {
 public:
     cudaInputData(kotekan::Config& config, const std::string& unique_name,
                   kotekan::bufferContainer& host_buffers, cudaDeviceInterface& device);
-    ~cudaInputData();
     int wait_on_precondition(int gpu_frame_id) override;
     cudaEvent_t execute(int gpu_frame_id, cudaEvent_t pre_event) override;
     void finalize_frame(int frame_id) override;
@@ -41,6 +40,9 @@ protected:
     int32_t in_buffer_precondition_id;
     int32_t in_buffer_finalize_id;
     Buffer* in_buf;
+
+    /// Whether a frame which isn't pinned was reported already
+    bool warned_unpinned = false;
 };
 
 #endif // CUDA_INPUT_DATA_H
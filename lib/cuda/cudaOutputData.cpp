@@ -6,6 +6,8 @@
 
 #include "cudaOutputData.hpp"
 
+#include "hostMemoryPool.h" // for host_pool_is_pinned
+
 using kotekan::bufferContainer;
 using kotekan::Config;
 
@@ -20,15 +22,7 @@ cudaOutputData::cudaOutputData(Config& config, const std::string& unique_name,
 
     output_buffer = host_buffers.get_buffer("output_buf");
     register_producer(output_buffer, unique_name.c_str());
-
-    for (int i = 0; i < output_buffer->num_frames; i++) {
-        uint flags;
-        // only register the memory if it isn't already...
-        if (cudaErrorInvalidValue == cudaHostGetFlags(&flags, output_buffer->frames[i])) {
-            CHECK_CUDA_ERROR(
-                cudaHostRegister(output_buffer->frames[i], output_buffer->frame_size, 0));
-        }
-    }
+    // The frames are pinned by the host memory pool, so are copied straight with DMA
 
     output_buffer_execute_id = 0;
     output_buffer_precondition_id = 0;
@@ -39,16 +33,6 @@ cudaOutputData::cudaOutputData(Config& config, const std::string& unique_name,
     command_type = gpuCommandType::COPY_OUT;
 }
 
-cudaOutputData::~cudaOutputData() {
-    for (int i = 0; i < output_buffer->num_frames; i++) {
-        uint flags;
-        // only register the memory if it isn't already...
-        if (cudaErrorInvalidValue == cudaHostGetFlags(&flags, output_buffer->frames[i])) {
-            CHECK_CUDA_ERROR(cudaHostUnregister(output_buffer->frames[i]));
-        }
-    }
-}
-
 int cudaOutputData::wait_on_precondition(int gpu_frame_id) {
     (void)gpu_frame_id;
     // Wait for there to be data in the input (output) buffer.
@@ -70,6 +54,13 @@ cudaEvent_t cudaOutputData::execute(int gpu_frame_id, cudaEvent_t pre_event) {
     void* gpu_output_frame = device.get_gpu_memory_array("output", gpu_frame_id, output_len);
     void* host_output_frame = (void*)output_buffer->frames[output_buffer_execute_id];
 
+    // A frame swapped in from outside the host memory pool isn't pinned, so isn't copied with DMA
+    if (!warned_unpinned && !host_pool_is_pinned(host_output_frame, output_len)) {
+        WARN("Frame {:d} of {:s} isn't pinned, copying it without DMA.", output_buffer_execute_id,
+             output_buffer->buffer_name);
+        warned_unpinned = true;
+    }
+
     device.async_copy_gpu_to_host(host_output_frame, gpu_output_frame, output_len, pre_event,
                                   pre_events[gpu_frame_id], post_events[gpu_frame_id]);
 
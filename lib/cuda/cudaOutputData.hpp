@@ -25,7 +25,6 @@ class cudaOutputData : public cudaCommand {
 public:
     cudaOutputData(kotekan::Config& config, const std::string& unique_name,
                    kotekan::bufferContainer& host_buffers, cudaDeviceInterface& device);
-    ~cudaOutputData();
     int wait_on_precondition(int gpu_frame_id) override;
     virtual cudaEvent_t execute(int buf_frame_id, cudaEvent_t pre_event) override;
     void finalize_frame(int frame_id) override;
@@ -40,6 +39,9 @@ protected:
     int32_t output_buffer_id;
     int32_t in_buffer_id;
 
+    /// Whether a frame which isn't pinned was reported already
+    bool warned_unpinned = false;
+
 private:
     // Common configuration values (which do not change in a run)
 };
@@ -1,5 +1,11 @@
 #include "cudaOutputDataZero.hpp"
 
+#include "hostMemoryPool.h" // for host_pool_free, host_pool_malloc
+
+#include "fmt.hpp" // for format, fmt
+
+#include <stdexcept> // for runtime_error
+
 using kotekan::bufferContainer;
 using kotekan::Config;
 
@@ -10,15 +16,19 @@ cudaOutputDataZero::cudaOutputDataZero(Config& config, const std::string& unique
     cudaCommand(config, unique_name, host_buffers, device, "", "") {
 
     output_len = config.get<int>(unique_name, "data_length");
-    output_zeros = malloc(output_len);
+    int32_t numa_node = config.get_default<int32_t>(unique_name, "numa_node", 0);
+    // Pinned by the pool with the CUDA runtime
+    output_zeros = host_pool_malloc(output_len, numa_node);
+    if (output_zeros == nullptr)
+        throw std::runtime_error(
+            fmt::format(fmt("Couldn't allocate {:d} bytes of host memory"), output_len));
     memset(output_zeros, 0, output_len);
-    CHECK_CUDA_ERROR(cudaHostRegister(output_zeros, output_len, 0));
 
     command_type = gpuCommandType::COPY_IN;
 }
 
 cudaOutputDataZero::~cudaOutputDataZero() {
-    free(output_zeros);
+    host_pool_free(output_zeros);
 }
 
 cudaEvent_t cudaOutputDataZero::execute(int gpu_frame_id, cudaEvent_t pre_event) {
@@ -24,6 +24,7 @@
  *     @gpu_mem_format       Any
  *
  * @conf   data_length       Int, size of buffer to zero in Bytes.
+ * @conf   numa_node         Int, default 0. The CPU NUMA node of the zeros in host memory.
  *
  * @author Keith Vanderlinde
  *
@@ -22,6 +22,7 @@ cudaProcess::cudaProcess(Config& config_, const std::string& unique_name,
     dev = device;
     device->prepareStreams();
     CHECK_CUDA_ERROR(cudaProfilerStart());
+    frame_signals.resize(_gpu_buffer_depth, nullptr);
     init();
 }
 
@@ -41,12 +42,12 @@ gpuCommand* cudaProcess::create_command(const std::string& cmd_name,
     return cmd;
 }
 
-void cudaProcess::queue_commands(int gpu_frame_id) {
-    cudaEvent_t signal = nullptr;
-    for (auto& command : commands) {
-        // Feed the last signal into the next operation
-        signal = ((cudaCommand*)command)->execute(gpu_frame_id, signal);
+void cudaProcess::queue_command(size_t c, int gpu_frame_id) {
+    // Feed the last signal of the frame into the next operation
+    cudaEvent_t& signal = frame_signals[gpu_frame_id];
+    signal = ((cudaCommand*)commands[c])->execute(gpu_frame_id, c == 0 ? nullptr : signal);
+    if (c == commands.size() - 1) {
+        final_signals[gpu_frame_id]->set_signal(signal);
+        INFO("Commands executed.");
     }
-    final_signals[gpu_frame_id]->set_signal(signal);
-    INFO("Commands executed.");
 }
@@ -24,9 +24,11 @@ public:
     gpuCommand* create_command(const std::string& cmd_name,
                                const std::string& unique_name) override;
     gpuEventContainer* create_signal() override;
-    void queue_commands(int gpu_frame_id) override;
+    void queue_command(size_t c, int gpu_frame_id) override;
 
     cudaDeviceInterface* device;
+    /// The signal of the last command queued on each frame
+    std::vector<cudaEvent_t> frame_signals;
 };
 
 #endif // CUDA_PROCESS_H
@@ -1,7 +1,9 @@
 #include "gpuCommand.hpp"
 
-#include "Config.hpp" // for Config
+#include "Config.hpp"      // for Config
+#include "gpuTimeline.hpp" // for gpuTimeline
 
+#include <algorithm> // for max
 #include <assert.h>  // for assert
 #include <exception> // for exception
 #include <regex>     // for match_results<>::_Base_type
@@ -69,6 +71,55 @@ double gpuCommand::get_last_gpu_execution_time() {
     return last_gpu_execution_time;
 }
 
+double gpuCommand::get_mean_idle_time() {
+    return num_idle_gaps ? total_idle_time / num_idle_gaps : 0;
+}
+
+double gpuCommand::get_max_idle_time() {
+    return max_idle_time;
+}
+
 gpuCommandType gpuCommand::get_command_type() {
     return command_type;
 }
+
+void gpuCommand::set_timeline(gpuTimeline* timeline_, const std::string& track) {
+    std::string category;
+    switch (command_type) {
+        case gpuCommandType::COPY_IN:
+            category = "copy_in";
+            break;
+        case gpuCommandType::KERNEL:
+            category = "kernel";
+            break;
+        case gpuCommandType::BARRIER:
+            category = "barrier";
+            break;
+        case gpuCommandType::COPY_OUT:
+            category = "copy_out";
+            break;
+        default:
+            category = "command";
+            break;
+    }
+    timeline = timeline_;
+    timeline_label = timeline->add_label(get_name(), category, track);
+}
+
+void gpuCommand::record_execution(int gpu_frame_id, double start_time, double end_time,
+                                  bool device_clock) {
+    last_gpu_execution_time = end_time - start_time;
+    if (last_gpu_execution_end >= 0) {
+        double idle_time = std::max(start_time - last_gpu_execution_end, 0.0);
+        total_idle_time += idle_time;
+        max_idle_time = std::max(max_idle_time, idle_time);
+        num_idle_gaps++;
+    }
+    last_gpu_execution_end = end_time;
+    if (timeline == nullptr)
+        return;
+    if (device_clock)
+        timeline->add_device_event(timeline_label, gpu_frame_id, start_time, end_time);
+    else
+        timeline->add_event(timeline_label, gpu_frame_id, start_time, end_time);
+}
@@ -11,10 +11,11 @@
 #include "bufferContainer.hpp" // for bufferContainer
 #include "kotekanLogging.hpp"  // for kotekanLogging
 
-#include <stdint.h> // for int32_t
+#include <stdint.h> // for int32_t, uint32_t, uint64_t
 #include <string>   // for string, allocator
 
 class gpuDeviceInterface;
+class gpuTimeline;
 
 /// Enumeration of known GPU command types.
 enum class gpuCommandType { COPY_IN, BARRIER, KERNEL, COPY_OUT, NOT_SET };
@@ -81,9 +82,20 @@ public:
 
     /// Get to return the results of profiling / timing.
     double get_last_gpu_execution_time();
+    /// Returns the mean time between the end of an execution and the start of the next one
+    double get_mean_idle_time();
+    /// Returns the longest time between the end of an execution and the start of the next one
+    double get_max_idle_time();
     /// Get to distinguish the flavour of command (copy,kernel,etc)
     gpuCommandType get_command_type();
 
+    /**
+     * @brief Records the executions of this command in a timeline.
+     * @param timeline  The timeline, it must outlive the command.
+     * @param track     The name of the track of the command in the timeline.
+     */
+    void set_timeline(gpuTimeline* timeline, const std::string& track);
+
     /**
      * @brief Returns the unique name of the command object.
      * @return The command object unique name.
@@ -91,6 +103,18 @@ public:
     virtual std::string get_unique_name() const;
 
 protected:
+    /**
+     * @brief Sets the last execution time, and records the execution in the timeline if there
+     *        is one. To be called by the backends in @c finalize_frame.
+     * @param gpu_frame_id  The frame which was executed.
+     * @param start_time    The start of the execution in seconds.
+     * @param end_time      The end of the execution in seconds.
+     * @param device_clock  Whether the times are from a clock of the device, rather than
+     *                      from @c e_time() on the host.
+     */
+    void record_execution(int gpu_frame_id, double start_time, double end_time,
+                          bool device_clock);
+
     /// A unique name used for the gpu command. Used in indexing commands in a list and referencing
     /// them by this value.
     std::string kernel_command;
@@ -112,8 +136,19 @@ protected:
     /// Profiling time for the last signal
     double last_gpu_execution_time = 0;
 
+    /// The end of the last execution, and the gaps between the executions of the frames, in
+    /// which the command wasn't running (or 0 if it started before the previous one ended)
+    double last_gpu_execution_end = -1;
+    double total_idle_time = 0;
+    double max_idle_time = 0;
+    uint64_t num_idle_gaps = 0;
+
     /// Type of command
     gpuCommandType command_type = gpuCommandType::NOT_SET;
+
+    /// The timeline of the executions, if any, and the label of this command in it
+    gpuTimeline* timeline = nullptr;
+    uint32_t timeline_label = 0;
 };
 
 #endif // GPU_COMMAND_H
@@ -0,0 +1,139 @@
+#include "gpuCommandScheduler.hpp"
+
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json<>::value_type
+
+#include <algorithm> // for max
+#include <chrono>    // for milliseconds
+#include <stdexcept> // for invalid_argument
+#include <utility>   // for move
+
+using nlohmann::json;
+
+gpuCommandScheduler::gpuCommandScheduler(size_t num_commands_, uint32_t num_frames_,
+                                         std::function<int(size_t, int)> wait_on_precondition_,
+                                         std::function<void(int)> wait_for_free_slot_,
+                                         std::function<void(size_t, int)> queue_command_) :
+    num_commands(num_commands_),
+    num_frames(num_frames_),
+    wait_on_precondition(std::move(wait_on_precondition_)),
+    wait_for_free_slot(std::move(wait_for_free_slot_)),
+    queue_command(std::move(queue_command_)),
+    num_ready(num_commands_ + 1, 0),
+    num_queued(num_commands_, 0),
+    last_users(num_commands_, num_commands_ - 1),
+    stopping(false),
+    num_dispatches(0),
+    sum_lead(0),
+    max_lead(0) {
+    if (num_commands == 0 || num_frames == 0)
+        throw std::invalid_argument("The scheduler needs at least one command and one frame");
+}
+
+gpuCommandScheduler::~gpuCommandScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(scheduler_lock);
+        stopping = true;
+    }
+    queued_cond.notify_all();
+    join();
+}
+
+void gpuCommandScheduler::run(const std::atomic<bool>& stop_thread) {
+    // One thread for the preconditions of each command, and one for the free slots
+    for (size_t c = 0; c <= num_commands; c++)
+        wait_threads.emplace_back(&gpuCommandScheduler::wait_thread, this, c);
+
+    std::unique_lock<std::mutex> lock(scheduler_lock);
+    while (!stopping && !stop_thread) {
+        // The first command which can be queued on its next frame, once the commands sharing
+        // memory with it are done with the previous frame
+        size_t c = 0;
+        for (; c < num_commands; c++) {
+            uint64_t before = (c == 0) ? num_ready[num_commands] : num_queued[c - 1];
+            if (num_queued[c] < num_ready[c] && num_queued[c] < before
+                && num_queued[last_users[c]] >= num_queued[c])
+                break;
+        }
+        if (c == num_commands) {
+            // Wake up now and then to check stop_thread
+            ready_cond.wait_for(lock, std::chrono::milliseconds(100));
+            continue;
+        }
+
+        uint64_t frame = num_queued[c];
+        lock.unlock();
+        queue_command(c, frame % num_frames);
+        lock.lock();
+
+        num_queued[c]++;
+        uint64_t lead = num_queued[0] - num_queued[num_commands - 1];
+        num_dispatches++;
+        sum_lead += lead;
+        max_lead = std::max(max_lead, lead);
+        queued_cond.notify_all();
+    }
+    stopping = true;
+    lock.unlock();
+    queued_cond.notify_all();
+}
+
+void gpuCommandScheduler::join() {
+    for (auto& thread : wait_threads)
+        if (thread.joinable())
+            thread.join();
+}
+
+void gpuCommandScheduler::set_last_users(const std::vector<size_t>& last_users_) {
+    if (last_users_.size() != num_commands)
+        throw std::invalid_argument("The scheduler needs the last user of every command");
+    for (size_t c = 0; c < num_commands; c++)
+        if (last_users_[c] < c || last_users_[c] >= num_commands)
+            throw std::invalid_argument("The last user of a command can't come before it");
+    {
+        std::lock_guard<std::mutex> lock(scheduler_lock);
+        last_users = last_users_;
+    }
+    ready_cond.notify_all();
+}
+
+void gpuCommandScheduler::wait_thread(size_t c) {
+    // The free slots are waited for before the first command is queued
+    const size_t queued_command = (c == num_commands) ? 0 : c;
+
+    for (uint64_t frame = 0;; frame++) {
+        {
+            // Only wait on the precondition once the command is queued on the previous frame
+            std::unique_lock<std::mutex> lock(scheduler_lock);
+            queued_cond.wait(lock,
+                             [&] { return stopping || num_queued[queued_command] >= frame; });
+            if (stopping)
+                return;
+        }
+
+        int gpu_frame_id = frame % num_frames;
+        if (c == num_commands) {
+            wait_for_free_slot(gpu_frame_id);
+        } else if (wait_on_precondition(c, gpu_frame_id) != 0) {
+            {
+                std::lock_guard<std::mutex> lock(scheduler_lock);
+                stopping = true;
+            }
+            ready_cond.notify_all();
+            queued_cond.notify_all();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(scheduler_lock);
+            num_ready[c] = frame + 1;
+        }
+        ready_cond.notify_all();
+    }
+}
+
+json gpuCommandScheduler::get_metrics() {
+    std::lock_guard<std::mutex> lock(scheduler_lock);
+    return {{"frames_queued", num_queued[num_commands - 1]},
+            {"mean_lead", num_dispatches ? (double)sum_lead / num_dispatches : 0.0},
+            {"max_lead", max_lead}};
+}
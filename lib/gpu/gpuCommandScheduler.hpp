@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief Queues the commands of a GPU pipeline on many frames at once
+ *  - gpuCommandScheduler
+ */
+
+#ifndef GPU_COMMAND_SCHEDULER_H
+#define GPU_COMMAND_SCHEDULER_H
+
+#include "json.hpp" // for json
+
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <functional>         // for function
+#include <mutex>              // for mutex
+#include <stddef.h>           // for size_t
+#include <stdint.h>           // for uint32_t, uint64_t
+#include <thread>             // for thread
+#include <vector>             // for vector
+
+/**
+ * @class gpuCommandScheduler
+ * @brief Queues each command of a GPU pipeline on each frame as soon as its dependencies allow.
+ *
+ * The commands of the frames form a graph, where command @c c of frame @c k is queued once
+ *  - its precondition on frame @c k is met,
+ *  - command @c c-1 of frame @c k is queued, as the commands of a frame are chained, or for
+ *    the first command, the slot of the GPU frame is free,
+ *  - command @c c of frame @c k-1 is queued, so each command is queued on the frames in order,
+ *  - the last command sharing GPU memory with command @c c, see @c set_last_users, is queued on
+ *    frame @c k-1, so a buffer which isn't per GPU frame isn't overwritten by a command of frame
+ *    @c k before the commands of frame @c k-1 after it have read it. Until the commands sharing
+ *    memory are set, every command waits for the last command of the previous frame.
+ *
+ * The preconditions of each command, and the free slots, are waited for by a thread each, on
+ * the frames in order, and only once the command has been queued on the previous frame, as in
+ * the sequential loop of @c gpuProcess. All the commands are queued by the thread calling
+ * @c run, so the backends don't need to queue commands from several threads. A precondition
+ * which takes long, e.g. waiting for a free frame of an output buffer, then only holds back
+ * the commands after it, while the commands before it carry on with the next frames, up to
+ * the number of GPU frames.
+ *
+ * The frames are counted from 0, and are passed to the callbacks as GPU frame ids, modulo the
+ * number of GPU frames.
+ */
+class gpuCommandScheduler {
+public:
+    /**
+     * @brief Makes a scheduler
+     * @param num_commands          The number of commands of each frame.
+     * @param num_frames            The number of GPU frames.
+     * @param wait_on_precondition  Waits for the precondition of a command on a GPU frame,
+     *                              returning non-zero to stop.
+     * @param wait_for_free_slot    Waits for a GPU frame to be finalized.
+     * @param queue_command         Queues a command on a GPU frame.
+     */
+    gpuCommandScheduler(size_t num_commands, uint32_t num_frames,
+                        std::function<int(size_t, int)> wait_on_precondition,
+                        std::function<void(int)> wait_for_free_slot,
+                        std::function<void(size_t, int)> queue_command);
+    ~gpuCommandScheduler();
+
+    /**
+     * @brief Queues the commands until a precondition returns non-zero or @p stop_thread is
+     *        set. The threads waiting on the preconditions can still be waiting, see @c join.
+     */
+    void run(const std::atomic<bool>& stop_thread);
+
+    /// Waits for the threads waiting on the preconditions, once they have been unblocked
+    void join();
+
+    /**
+     * @brief Sets the commands sharing GPU memory.
+     * @param last_users  For each command @c c, the last command of a frame using any of the
+     *                    memory @c c uses which isn't per GPU frame, or @c c if there is none.
+     */
+    void set_last_users(const std::vector<size_t>& last_users);
+
+    /**
+     * @brief Returns the metrics of the scheduling: the number of frames queued, and the mean
+     *        and the maximum of the number of frames the first command was queued ahead of the
+     *        last one when a command was queued.
+     */
+    nlohmann::json get_metrics();
+
+private:
+    /// Waits on the preconditions of command @p c, or on the free slots if @p c is num_commands
+    void wait_thread(size_t c);
+
+    const size_t num_commands;
+    const uint32_t num_frames;
+    std::function<int(size_t, int)> wait_on_precondition;
+    std::function<void(int)> wait_for_free_slot;
+    std::function<void(size_t, int)> queue_command;
+
+    /// The number of frames whose precondition is met for each command, and for the free slot
+    std::vector<uint64_t> num_ready;
+    /// The number of frames each command has been queued on
+    std::vector<uint64_t> num_queued;
+    /// The last command sharing memory with each command, see set_last_users
+    std::vector<size_t> last_users;
+    /// Set when stopping, to stop the threads waiting on the preconditions
+    bool stopping;
+
+    uint64_t num_dispatches;
+    uint64_t sum_lead;
+    uint64_t max_lead;
+
+    std::vector<std::thread> wait_threads;
+    std::mutex scheduler_lock;
+    std::condition_variable ready_cond;
+    std::condition_variable queued_cond;
+};
+
+#endif // GPU_COMMAND_SCHEDULER_H
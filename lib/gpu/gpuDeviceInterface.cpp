@@ -34,10 +34,17 @@ void* gpuDeviceInterface::get_gpu_memory(const std::string& name, const uint32_t
     assert(len == gpu_memory[name].len);
     assert(gpu_memory[name].gpu_pointers.size() == 1);
 
+    if (memory_user >= 0)
+        memory_users[name].insert(memory_user);
+
     // Return the requested memory.
     return gpu_memory[name].gpu_pointers[0];
 }
 
+void gpuDeviceInterface::set_memory_user(int command) {
+    memory_user = command;
+}
+
 void* gpuDeviceInterface::get_gpu_memory_array(const std::string& name, const uint32_t index,
                                                const uint32_t len) {
     // Check if the memory isn't yet allocated
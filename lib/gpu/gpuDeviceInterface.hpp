@@ -5,6 +5,7 @@
 #include "kotekanLogging.hpp" // for kotekanLogging
 
 #include <map>      // for map
+#include <set>      // for set
 #include <stdint.h> // for uint32_t, int32_t
 #include <string>   // for string
 #include <vector>   // for vector
@@ -48,6 +49,18 @@ public:
      */
     void* get_gpu_memory(const std::string& name, const uint32_t len);
 
+    /**
+     * @brief Sets the command the next calls to @c get_gpu_memory are made for, or -1 for
+     * none. The commands using each buffer from @c get_gpu_memory are recorded, so that the
+     * commands sharing a buffer within a frame can be found.
+     */
+    void set_memory_user(int command);
+
+    /// Returns the commands which used each buffer from @c get_gpu_memory, by name
+    const std::map<std::string, std::set<int>>& get_memory_users() {
+        return memory_users;
+    }
+
     // Can't do this in the destructor because only the derived classes know
     // how to free their memory. To be moved into distinct objects...
     void cleanup_memory();
@@ -75,6 +88,10 @@ protected:
 
 private:
     std::map<std::string, gpuMemoryBlock> gpu_memory;
+
+    /// The command calling get_gpu_memory, and the commands which used each buffer
+    int memory_user = -1;
+    std::map<std::string, std::set<int>> memory_users;
 };
 
 #endif // GPU_DEVICE_INTERFACE_H
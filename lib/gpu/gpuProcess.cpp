@@ -1,12 +1,13 @@
 #include "gpuProcess.hpp"
 
-#include "Config.hpp"             // for Config
-#include "gpuCommand.hpp"         // for gpuCommand, gpuCommandType, gpuCommandType::COPY_IN
-#include "gpuDeviceInterface.hpp" // for gpuDeviceInterface, Config
-#include "gpuEventContainer.hpp"  // for gpuEventContainer
-#include "kotekanLogging.hpp"     // for INFO, DEBUG2, DEBUG
-#include "restServer.hpp"         // for restServer, connectionInstance
-#include "util.h"                 // for e_time
+#include "Config.hpp"              // for Config
+#include "gpuCommand.hpp"          // for gpuCommand, gpuCommandType, gpuCommandType::COPY_IN
+#include "gpuCommandScheduler.hpp" // for gpuCommandScheduler
+#include "gpuDeviceInterface.hpp"  // for gpuDeviceInterface, Config
+#include "gpuEventContainer.hpp"   // for gpuEventContainer
+#include "kotekanLogging.hpp"      // for INFO, DEBUG2, DEBUG
+#include "restServer.hpp"          // for restServer, connectionInstance
+#include "util.h"                  // for e_time
 
 #include "fmt.hpp"  // for format, fmt
 #include "json.hpp" // for json, basic_json<>::object_t, basic_json<>::value_type
@@ -19,7 +20,7 @@
 #include <pthread.h>   // for pthread_setaffinity_np
 #include <regex>       // for match_results<>::_Base_type
 #include <sched.h>     // for cpu_set_t, CPU_SET, CPU_ZERO
-#include <stdexcept>   // for runtime_error
+#include <stdexcept>   // for runtime_error, invalid_argument
 #include <sys/types.h> // for uint
 
 using kotekan::bufferContainer;
@@ -36,7 +37,8 @@ using nlohmann::json;
 // TODO Remove the GPU_ID from this constructor
 gpuProcess::gpuProcess(Config& config_, const std::string& unique_name,
                        bufferContainer& buffer_container) :
-    Stage(config_, unique_name, buffer_container, std::bind(&gpuProcess::main_thread, this)) {
+    Stage(config_, unique_name, buffer_container, std::bind(&gpuProcess::main_thread, this)),
+    timeline(config_.get_default<uint32_t>(unique_name, "timeline_size", 16384)) {
     log_profiling = config.get_default<bool>(unique_name, "log_profiling", false);
 
     _gpu_buffer_depth = config.get<int>(unique_name, "buffer_depth");
@@ -64,6 +66,7 @@ gpuProcess::gpuProcess(Config& config_, const std::string& unique_name,
 
 gpuProcess::~gpuProcess() {
     restServer::instance().remove_get_callback(fmt::format(fmt("/gpu_profile/{:d}"), gpu_id));
+    restServer::instance().remove_get_callback(fmt::format(fmt("/gpu_timeline/{:d}"), gpu_id));
     for (auto& command : commands)
         delete command;
     for (auto& event : final_signals)
@@ -90,6 +93,90 @@ void gpuProcess::init() {
         std::string command_name = cmd["name"];
         commands.push_back(create_command(command_name, unique_path));
     }
+
+    // One track for the thread queuing the frames, one for the thread finalizing them, and
+    // one for each command
+    for (size_t c = 0; c < commands.size(); c++)
+        precondition_labels.push_back(
+            timeline.add_label(commands[c]->get_name(), "precondition", "host: queue"));
+    free_slot_label = timeline.add_label("wait_for_free_slot", "wait", "host: queue");
+    queue_label = timeline.add_label("queue_commands", "queue", "host: queue");
+    finalize_label = timeline.add_label("finalize_frame", "finalize", "host: finalize");
+    for (size_t c = 0; c < commands.size(); c++)
+        commands[c]->set_timeline(&timeline,
+                                  fmt::format(fmt("{:d} {:s}"), c, commands[c]->get_name()));
+
+    std::string command_scheduling =
+        config.get_default<std::string>(unique_name, "command_scheduling", "frame");
+    if (command_scheduling == "graph") {
+        scheduler.reset(new gpuCommandScheduler(
+            commands.size(), _gpu_buffer_depth,
+            [this](size_t c, int gpu_frame_id) {
+                double start_time = e_time();
+                if (commands[c]->wait_on_precondition(gpu_frame_id) != 0) {
+                    INFO("Received exit in GPU command precondition! (Command '{:s}')",
+                         commands[c]->get_name());
+                    return 1;
+                }
+                timeline.add_event(precondition_labels[c], gpu_frame_id, start_time, e_time());
+                return 0;
+            },
+            [this](int gpu_frame_id) {
+                double start_time = e_time();
+                final_signals[gpu_frame_id]->wait_for_free_slot();
+                timeline.add_event(free_slot_label, gpu_frame_id, start_time, e_time());
+            },
+            [this](size_t c, int gpu_frame_id) {
+                double start_time = e_time();
+                // Record the memory the commands share while the first frame is queued
+                if (!last_users_set)
+                    dev->set_memory_user(c);
+                queue_command(c, gpu_frame_id);
+                timeline.add_event(queue_label, gpu_frame_id, start_time, e_time());
+                if (c == commands.size() - 1) {
+                    frame_queued();
+                    if (!last_users_set)
+                        set_last_users();
+                }
+            }));
+    } else if (command_scheduling != "frame") {
+        throw std::invalid_argument(
+            fmt::format(fmt("Unknown command_scheduling: {:s}"), command_scheduling));
+    }
+}
+
+void gpuProcess::set_last_users() {
+    dev->set_memory_user(-1);
+
+    // A command on the next frame must wait for the last command of this frame using any of
+    // the memory which isn't per GPU frame it uses
+    std::vector<size_t> last_users(commands.size());
+    for (size_t c = 0; c < commands.size(); c++)
+        last_users[c] = c;
+    for (auto& [name, users] : dev->get_memory_users()) {
+        size_t last = *users.rbegin();
+        for (int c : users)
+            last_users[c] = std::max(last_users[c], last);
+        if (users.size() > 1)
+            DEBUG("GPU memory {:s} is shared by commands {:d} to {:d}", name, *users.begin(),
+                  last);
+    }
+    scheduler->set_last_users(last_users);
+    last_users_set = true;
+}
+
+void gpuProcess::queue_commands(int gpu_frame_id) {
+    for (size_t c = 0; c < commands.size(); c++)
+        queue_command(c, gpu_frame_id);
+    frame_queued();
+}
+
+void gpuProcess::frame_queued() {
+    std::lock_guard<std::mutex> lock(pipeline_lock);
+    frames_queued++;
+    uint64_t frames_in_flight = frames_queued - frames_finalized;
+    sum_frames_in_flight += frames_in_flight;
+    max_frames_in_flight = std::max(max_frames_in_flight, frames_in_flight);
 }
 
 void gpuProcess::profile_callback(connectionInstance& conn) {
@@ -108,19 +195,21 @@ void gpuProcess::profile_callback(connectionInstance& conn) {
     for (auto& cmd : commands) {
         double time = cmd->get_last_gpu_execution_time();
         double utilization = time / frame_arrival_period;
+        json entry = {{"name", cmd->get_name()},
+                      {"time", time},
+                      {"utilization", utilization},
+                      {"mean_idle_time", cmd->get_mean_idle_time()},
+                      {"max_idle_time", cmd->get_max_idle_time()}};
         if (cmd->get_command_type() == gpuCommandType::KERNEL) {
-            reply["kernel"].push_back(
-                {{"name", cmd->get_name()}, {"time", time}, {"utilization", utilization}});
+            reply["kernel"].push_back(entry);
             total_kernel_time += cmd->get_last_gpu_execution_time();
         } else if (cmd->get_command_type() == gpuCommandType::COPY_IN) {
 
-            reply["copy_in"].push_back(
-                {{"name", cmd->get_name()}, {"time", time}, {"utilization", utilization}});
+            reply["copy_in"].push_back(entry);
             total_copy_in_time += cmd->get_last_gpu_execution_time();
         } else if (cmd->get_command_type() == gpuCommandType::COPY_OUT) {
 
-            reply["copy_out"].push_back(
-                {{"name", cmd->get_name()}, {"time", time}, {"utilization", utilization}});
+            reply["copy_out"].push_back(entry);
             total_copy_out_time += cmd->get_last_gpu_execution_time();
         } else {
             continue;
@@ -134,48 +223,75 @@ void gpuProcess::profile_callback(connectionInstance& conn) {
     reply["kernel_utilization"] = total_kernel_time / frame_arrival_period;
     reply["copy_out_utilization"] = total_copy_out_time / frame_arrival_period;
 
+    {
+        std::lock_guard<std::mutex> lock(pipeline_lock);
+        reply["pipeline"] = {{"frames_queued", frames_queued},
+                             {"frames_finalized", frames_finalized},
+                             {"mean_frames_in_flight",
+                              frames_queued ? (double)sum_frames_in_flight / frames_queued : 0.0},
+                             {"max_frames_in_flight", max_frames_in_flight}};
+    }
+    if (scheduler)
+        reply["pipeline"]["scheduler"] = scheduler->get_metrics();
+
     conn.send_json_reply(reply);
 }
 
+void gpuProcess::timeline_callback(connectionInstance& conn) {
+    json reply = timeline.to_json(fmt::format(fmt("GPU {:d}"), gpu_id));
+    auto query = conn.get_query();
+    if (query.count("clear") && query["clear"] == "true")
+        timeline.clear();
+    conn.send_json_reply(reply);
+}
 
 void gpuProcess::main_thread() {
     restServer& rest_server = restServer::instance();
     rest_server.register_get_callback(
         fmt::format(fmt("/gpu_profile/{:d}"), gpu_id),
         std::bind(&gpuProcess::profile_callback, this, std::placeholders::_1));
+    rest_server.register_get_callback(
+        fmt::format(fmt("/gpu_timeline/{:d}"), gpu_id),
+        std::bind(&gpuProcess::timeline_callback, this, std::placeholders::_1));
 
     // Start with the first GPU frame;
     int gpu_frame_id = 0;
     bool first_run = true;
 
+    if (scheduler) {
+        // The scheduler waits on the preconditions and queues the commands itself
+        start_results_thread();
+        scheduler->run(stop_thread);
+        goto exit_loop;
+    }
+
     while (!stop_thread) {
         // Wait for all the required preconditions
         // This is things like waiting for the input buffer to have data
         // and for there to be free space in the output buffers.
         // INFO("Waiting on preconditions for GPU[{:d}][{:d}]", gpu_id, gpu_frame_id);
-        for (auto& command : commands) {
-            if (command->wait_on_precondition(gpu_frame_id) != 0) {
+        for (size_t c = 0; c < commands.size(); c++) {
+            double start_time = e_time();
+            if (commands[c]->wait_on_precondition(gpu_frame_id) != 0) {
                 INFO("Received exit in GPU command precondition! (Command '{:s}')",
-                     command->get_name());
+                     commands[c]->get_name());
                 goto exit_loop;
             }
+            timeline.add_event(precondition_labels[c], gpu_frame_id, start_time, e_time());
         }
 
         DEBUG("Waiting for free slot for GPU[{:d}][{:d}]", gpu_id, gpu_frame_id);
         // We make sure we aren't using a gpu frame that's currently in-flight.
-        final_signals[gpu_frame_id]->wait_for_free_slot();
-        queue_commands(gpu_frame_id);
+        {
+            double start_time = e_time();
+            final_signals[gpu_frame_id]->wait_for_free_slot();
+            double queue_time = e_time();
+            queue_commands(gpu_frame_id);
+            timeline.add_event(free_slot_label, gpu_frame_id, start_time, queue_time);
+            timeline.add_event(queue_label, gpu_frame_id, queue_time, e_time());
+        }
         if (first_run) {
-            results_thread_handle = std::thread(&gpuProcess::results_thread, std::ref(*this));
-
-            // Requires Linux, this could possibly be made more general someday.
-            // TODO Move to config
-            cpu_set_t cpuset;
-            CPU_ZERO(&cpuset);
-            for (int j = 4; j < 12; j++)
-                CPU_SET(j, &cpuset);
-            pthread_setaffinity_np(results_thread_handle.native_handle(), sizeof(cpu_set_t),
-                                   &cpuset);
+            start_results_thread();
             first_run = false;
         }
 
@@ -186,10 +302,24 @@ exit_loop:
         sig_container->stop();
     }
     INFO("Waiting for GPU packet queues to finish up before freeing memory.");
+    if (scheduler)
+        scheduler->join();
     if (results_thread_handle.joinable())
         results_thread_handle.join();
 }
 
+void gpuProcess::start_results_thread() {
+    results_thread_handle = std::thread(&gpuProcess::results_thread, std::ref(*this));
+
+    // Requires Linux, this could possibly be made more general someday.
+    // TODO Move to config
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int j = 4; j < 12; j++)
+        CPU_SET(j, &cpuset);
+    pthread_setaffinity_np(results_thread_handle.native_handle(), sizeof(cpu_set_t), &cpuset);
+}
+
 
 void gpuProcess::results_thread() {
     // Start with the first GPU frame;
@@ -207,6 +337,7 @@ void gpuProcess::results_thread() {
         DEBUG2("Got final signal for gpu[{:d}], frame {:d}, time: {:f}", gpu_id, gpu_frame_id,
                e_time());
 
+        double finalize_time = e_time();
         for (auto& command : commands) {
             // Note the fact that we don't run `finalize_frame()` when the shutdown
             // signal is set, means that we cannot use it to free memory.
@@ -218,6 +349,7 @@ void gpuProcess::results_thread() {
             if (!stop_thread)
                 command->finalize_frame(gpu_frame_id);
         }
+        timeline.add_event(finalize_label, gpu_frame_id, finalize_time, e_time());
         DEBUG2("Finished finalizing frames for gpu[{:d}][{:d}]", gpu_id, gpu_frame_id);
 
         if (log_profiling) {
@@ -230,6 +362,10 @@ void gpuProcess::results_thread() {
             INFO("GPU[{:d}] Profiling: {:s}", gpu_id, output);
         }
 
+        {
+            std::lock_guard<std::mutex> lock(pipeline_lock);
+            frames_finalized++;
+        }
         final_signals[gpu_frame_id]->reset();
 
         gpu_frame_id = (gpu_frame_id + 1) % _gpu_buffer_depth;
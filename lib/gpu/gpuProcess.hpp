@@ -4,19 +4,61 @@
 #define HI_NIBBLE(b) (((b) >> 4) & 0x0F)
 #define LO_NIBBLE(b) ((b)&0x0F)
 
-#include "Config.hpp"             // for Config
-#include "Stage.hpp"              // for Stage
-#include "bufferContainer.hpp"    // for bufferContainer
-#include "gpuCommand.hpp"         // for gpuCommand
-#include "gpuDeviceInterface.hpp" // for gpuDeviceInterface
-#include "gpuEventContainer.hpp"  // for gpuEventContainer
-#include "restServer.hpp"         // for connectionInstance
-
-#include <stdint.h> // for uint32_t
+#include "Config.hpp"              // for Config
+#include "Stage.hpp"               // for Stage
+#include "bufferContainer.hpp"     // for bufferContainer
+#include "gpuCommand.hpp"          // for gpuCommand
+#include "gpuCommandScheduler.hpp" // for gpuCommandScheduler
+#include "gpuDeviceInterface.hpp"  // for gpuDeviceInterface
+#include "gpuEventContainer.hpp"   // for gpuEventContainer
+#include "gpuTimeline.hpp"         // for gpuTimeline
+#include "restServer.hpp"          // for connectionInstance
+
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint64_t
 #include <string>   // for string
 #include <thread>   // for thread
 #include <vector>   // for vector
 
+/**
+ * @class gpuProcess
+ * @brief Base class of the stages which run a pipeline of commands on a GPU.
+ *
+ * The stage waits for the preconditions of the commands of each GPU frame, queues them, and
+ * finalizes them when they are done. The execution times of the commands are available at
+ * @c /gpu_profile/<gpu_id>, and a timeline of the commands and of the waits on the host at
+ * @c /gpu_timeline/<gpu_id>, in the Chrome trace format, which can be opened with
+ * chrome://tracing or https://ui.perfetto.dev. With @c ?clear=true the timeline is cleared
+ * after it is sent.
+ *
+ * By default the commands of a frame are queued together, once all their preconditions are
+ * met, and the frames one after the other. With @c command_scheduling set to "graph" each
+ * command is queued on each frame as soon as its own precondition is met and the commands it
+ * depends on are queued (see @c gpuCommandScheduler), so e.g. the input of the next frames can
+ * be copied while the output of a frame waits for a free output frame. The memory from
+ * @c gpuDeviceInterface::get_gpu_memory isn't per GPU frame, so the commands using it on the
+ * first frame are recorded, and a command is only queued on the next frame once the last
+ * command sharing memory with it is queued on the previous one, e.g. a reorder writing
+ * @c input_reordered waits for the beamformer reading it. The first frame is queued one
+ * command after the other.
+ *
+ * The profile also has the mean and the longest idle time of each command between the
+ * executions of consecutive frames, and the mean and the maximum number of frames in flight,
+ * sampled when each frame is queued. With the "graph" scheduling it also has the mean and the
+ * maximum number of frames the first command was queued ahead of the last one.
+ *
+ * @conf  gpu_id                Int. The id of the GPU.
+ * @conf  buffer_depth          Int. The number of GPU frames.
+ * @conf  commands              Array of objects. The commands to run on each frame.
+ * @conf  log_profiling         Bool, default false. Log the execution times of each frame.
+ * @conf  frame_arrival_period  Double, default 0. The time between frames in seconds.
+ * @conf  timeline_size         Int, default 16384. The number of events kept in the
+ *                              timeline, 0 disables it.
+ * @conf  command_scheduling    String, default "frame". How the commands are queued, "frame"
+ *                              or "graph".
+ */
 class gpuProcess : public kotekan::Stage {
 public:
     gpuProcess(kotekan::Config& config, const std::string& unique_name,
@@ -24,6 +66,8 @@ public:
     virtual ~gpuProcess();
     void main_thread() override;
     void profile_callback(kotekan::connectionInstance& conn);
+    /// Sends the timeline in the Chrome trace format
+    void timeline_callback(kotekan::connectionInstance& conn);
 
     /// Returns the dot string formatted graph for the GPU pipeline
     virtual std::string dot_string(const std::string& prefix) const override;
@@ -32,8 +76,19 @@ protected:
     virtual gpuCommand* create_command(const std::string& cmd_name,
                                        const std::string& unique_name) = 0;
     virtual gpuEventContainer* create_signal() = 0;
-    virtual void queue_commands(int gpu_frame_id) = 0;
+    /**
+     * @brief Queues command @p c on a frame, after the commands before it on the frame, and
+     *        sets the final signal of the frame once its last command is queued.
+     */
+    virtual void queue_command(size_t c, int gpu_frame_id) = 0;
+    /// Queues all the commands on a frame
+    void queue_commands(int gpu_frame_id);
+    /// Counts a frame whose commands are all queued
+    void frame_queued();
+    /// Tells the scheduler which commands share memory, once the first frame is queued
+    void set_last_users();
     void results_thread();
+    void start_results_thread();
     void init(void);
 
     std::vector<gpuEventContainer*> final_signals;
@@ -47,6 +102,26 @@ protected:
     gpuDeviceInterface* dev;
     std::vector<gpuCommand*> commands;
 
+    /// The executions of the commands and the waits of the host
+    gpuTimeline timeline;
+    /// The labels of the waits on the preconditions of each command
+    std::vector<uint32_t> precondition_labels;
+    uint32_t free_slot_label;
+    uint32_t queue_label;
+    uint32_t finalize_label;
+
+    /// Queues the commands with the "graph" scheduling, else nullptr
+    std::unique_ptr<gpuCommandScheduler> scheduler;
+    /// Whether the scheduler knows which commands share memory
+    bool last_users_set = false;
+
+    /// The frames queued and finalized, and the frames in flight when each frame was queued
+    std::mutex pipeline_lock;
+    uint64_t frames_queued = 0;
+    uint64_t frames_finalized = 0;
+    uint64_t sum_frames_in_flight = 0;
+    uint64_t max_frames_in_flight = 0;
+
     // Config variables
     uint32_t _gpu_buffer_depth;
     uint32_t gpu_id;
@@ -0,0 +1,112 @@
+#include "gpuTimeline.hpp"
+
+#include "util.h" // for e_time
+
+#include "fmt.hpp"  // for format, fmt
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json<>::value_type
+
+#include <algorithm> // for min, find, max
+#include <iterator>  // for distance
+#include <limits>    // for numeric_limits
+#include <set>       // for set
+
+using nlohmann::json;
+
+gpuTimeline::gpuTimeline(size_t capacity) :
+    events(capacity),
+    next_event(0),
+    num_events(0),
+    device_offset(std::numeric_limits<double>::infinity()),
+    start_time(e_time()) {}
+
+uint32_t gpuTimeline::add_label(const std::string& name, const std::string& category,
+                                const std::string& track) {
+    std::lock_guard<std::mutex> lock(timeline_lock);
+    auto it = std::find(tracks.begin(), tracks.end(), track);
+    if (it == tracks.end())
+        it = tracks.insert(tracks.end(), track);
+    labels.push_back({name, category, (uint32_t)std::distance(tracks.begin(), it)});
+    return labels.size() - 1;
+}
+
+void gpuTimeline::add_event(uint32_t label, int32_t gpu_frame_id, double start_time,
+                            double end_time) {
+    if (!enabled())
+        return;
+    std::lock_guard<std::mutex> lock(timeline_lock);
+    add({start_time, end_time, label, gpu_frame_id, false});
+}
+
+void gpuTimeline::add_device_event(uint32_t label, int32_t gpu_frame_id, double start_time,
+                                   double end_time) {
+    if (!enabled())
+        return;
+    double now = e_time();
+    std::lock_guard<std::mutex> lock(timeline_lock);
+    device_offset = std::min(device_offset, now - end_time);
+    add({start_time, end_time, label, gpu_frame_id, true});
+}
+
+void gpuTimeline::add(const event& e) {
+    events[next_event] = e;
+    next_event = (next_event + 1) % events.size();
+    num_events = std::min(num_events + 1, events.size());
+}
+
+void gpuTimeline::clear() {
+    std::lock_guard<std::mutex> lock(timeline_lock);
+    next_event = 0;
+    num_events = 0;
+}
+
+json gpuTimeline::to_json(const std::string& name) {
+    std::lock_guard<std::mutex> lock(timeline_lock);
+
+    json trace_events = json::array();
+    std::set<int32_t> frames;
+    for (size_t i = 0; i < num_events; i++) {
+        // Oldest first
+        const event& e = events[(next_event + events.size() - num_events + i) % events.size()];
+        const label& l = labels[e.label];
+        double offset = (e.device_clock ? device_offset : 0) - start_time;
+        // Times in us
+        trace_events.push_back({{"name", l.name},
+                                {"cat", l.category},
+                                {"ph", "X"},
+                                {"ts", (e.start_time + offset) * 1e6},
+                                {"dur", std::max(e.end_time - e.start_time, 0.0) * 1e6},
+                                {"pid", e.gpu_frame_id},
+                                {"tid", l.track},
+                                {"args", {{"gpu_frame_id", e.gpu_frame_id}}}});
+        frames.insert(e.gpu_frame_id);
+    }
+
+    // The names of the processes and threads, in the order of the frames and tracks
+    for (int32_t frame : frames) {
+        trace_events.push_back({{"name", "process_name"},
+                                {"ph", "M"},
+                                {"pid", frame},
+                                {"args", {{"name", fmt::format(fmt("{:s} frame {:d}"), name,
+                                                               frame)}}}});
+        trace_events.push_back({{"name", "process_sort_index"},
+                                {"ph", "M"},
+                                {"pid", frame},
+                                {"args", {{"sort_index", frame}}}});
+        for (size_t track = 0; track < tracks.size(); track++) {
+            trace_events.push_back({{"name", "thread_name"},
+                                    {"ph", "M"},
+                                    {"pid", frame},
+                                    {"tid", track},
+                                    {"args", {{"name", tracks[track]}}}});
+            trace_events.push_back({{"name", "thread_sort_index"},
+                                    {"ph", "M"},
+                                    {"pid", frame},
+                                    {"tid", track},
+                                    {"args", {{"sort_index", track}}}});
+        }
+    }
+
+    return {{"traceEvents", trace_events},
+            {"displayTimeUnit", "ms"},
+            {"otherData", {{"start_time", start_time}}}};
+}
@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @brief Timeline of the host and device activity of a GPU pipeline
+ *  - gpuTimeline
+ */
+
+#ifndef GPU_TIMELINE_H
+#define GPU_TIMELINE_H
+
+#include "json.hpp" // for json
+
+#include <mutex>    // for mutex
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, int32_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @class gpuTimeline
+ * @brief Ring buffer of the start and end times of everything a GPU pipeline does, which can
+ *        be exported in the Chrome trace format (chrome://tracing, https://ui.perfetto.dev).
+ *
+ * Each event has a label, which gives its name, its category and the track it is drawn on.
+ * The labels are made when the pipeline is set up, so recording an event only stores a few
+ * numbers under a lock. When the buffer is full the oldest events are overwritten.
+ *
+ * The times of the host are from @c e_time(). The backends which time their commands with a
+ * device clock record them with @c add_device_event, and the times are moved to the host clock
+ * when exported, using the smallest difference seen between the host time when an event is
+ * recorded and the device time when it ended. This is an upper bound of the offset between the
+ * clocks, the difference being the latency of the completion of the commands on the host.
+ *
+ * In the trace each GPU frame is a process, and each track a thread of it, so the overlap of
+ * the frames in flight is easy to see.
+ */
+class gpuTimeline {
+public:
+    /**
+     * @brief Makes a timeline
+     * @param capacity  The number of events to keep, 0 disables the timeline.
+     */
+    explicit gpuTimeline(size_t capacity);
+
+    /**
+     * @brief Makes a label for events, the tracks are drawn in the order they are first used
+     * @param name      The name of the events.
+     * @param category  The category of the events, e.g. "kernel" or "wait".
+     * @param track     The name of the track the events are drawn on.
+     * @return The id of the label.
+     */
+    uint32_t add_label(const std::string& name, const std::string& category,
+                       const std::string& track);
+
+    /// Records an event of frame @p gpu_frame_id, with times in seconds on the host clock
+    void add_event(uint32_t label, int32_t gpu_frame_id, double start_time, double end_time);
+
+    /// Records an event of frame @p gpu_frame_id, with times in seconds on the device clock
+    void add_device_event(uint32_t label, int32_t gpu_frame_id, double start_time,
+                          double end_time);
+
+    /// Whether events are recorded
+    bool enabled() const {
+        return !events.empty();
+    }
+
+    /// Removes all the events
+    void clear();
+
+    /// Returns the events in the Chrome trace event format, @p name is used for the processes
+    nlohmann::json to_json(const std::string& name);
+
+private:
+    struct label {
+        std::string name;
+        std::string category;
+        uint32_t track;
+    };
+
+    struct event {
+        double start_time;
+        double end_time;
+        uint32_t label;
+        int32_t gpu_frame_id;
+        bool device_clock;
+    };
+
+    /// Adds @p e to the ring buffer, with timeline_lock held
+    void add(const event& e);
+
+    std::vector<label> labels;
+    std::vector<std::string> tracks;
+
+    /// The ring buffer, the next event goes in events[next_event]
+    std::vector<event> events;
+    size_t next_event;
+    size_t num_events;
+
+    /// The host time minus the device time
+    double device_offset;
+    /// The host time of the creation of the timeline, which is time 0 of the trace
+    double start_time;
+
+    std::mutex timeline_lock;
+};
+
+#endif // GPU_TIMELINE_H
@@ -105,18 +105,17 @@ void hsaCommand::finalize_frame(int frame_id) {
     if (command_type == gpuCommandType::KERNEL) {
         hsa_status = hsa_amd_profiling_get_dispatch_time(device.get_gpu_agent(), signals[frame_id],
                                                          &kernel_time);
-        last_gpu_execution_time =
-            ((double)(kernel_time.end - kernel_time.start)) / (double)timestamp_frequency_hz;
+        HSA_CHECK(hsa_status);
+        // The times are in the system timestamp domain of HSA
+        record_execution(frame_id, (double)kernel_time.start / (double)timestamp_frequency_hz,
+                         (double)kernel_time.end / (double)timestamp_frequency_hz, true);
     } else if (command_type == gpuCommandType::COPY_IN
                || command_type == gpuCommandType::COPY_OUT) {
         hsa_status = hsa_amd_profiling_get_async_copy_time(signals[frame_id], &copy_time);
-        last_gpu_execution_time =
-            ((double)(copy_time.end - copy_time.start)) / (double)timestamp_frequency_hz;
-    } else {
-        return;
+        HSA_CHECK(hsa_status);
+        record_execution(frame_id, (double)copy_time.start / (double)timestamp_frequency_hz,
+                         (double)copy_time.end / (double)timestamp_frequency_hz, true);
     }
-
-    HSA_CHECK(hsa_status);
 }
 
 uint64_t hsaCommand::load_hsaco_file(string& file_name, std::string& kernel_name) {
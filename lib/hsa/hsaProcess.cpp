@@ -26,6 +26,7 @@ hsaProcess::hsaProcess(Config& config, const std::string& unique_name,
     gpuProcess(config, unique_name, buffer_container) {
     uint32_t numa_node = config.get_default(unique_name, "numa_node", 0);
     dev = (gpuDeviceInterface*)new hsaDeviceInterface(config, gpu_id, _gpu_buffer_depth, numa_node);
+    frame_signals.resize(_gpu_buffer_depth);
     init();
 }
 
@@ -42,12 +43,12 @@ gpuCommand* hsaProcess::create_command(const std::string& cmd_name,
     return cmd;
 }
 
-void hsaProcess::queue_commands(int gpu_frame_id) {
-    hsa_signal_t signal;
-    signal.handle = 0;
-    for (auto& command : commands) {
-        // Feed the last signal into the next operation
-        signal = ((hsaCommand*)command)->execute(gpu_frame_id, signal);
-    }
-    final_signals[gpu_frame_id]->set_signal(&signal);
+void hsaProcess::queue_command(size_t c, int gpu_frame_id) {
+    // Feed the last signal of the frame into the next operation
+    hsa_signal_t& signal = frame_signals[gpu_frame_id];
+    if (c == 0)
+        signal.handle = 0;
+    signal = ((hsaCommand*)commands[c])->execute(gpu_frame_id, signal);
+    if (c == commands.size() - 1)
+        final_signals[gpu_frame_id]->set_signal(&signal);
 }
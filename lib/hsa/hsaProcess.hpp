@@ -6,8 +6,11 @@
 #include "gpuCommand.hpp"        // for gpuCommand
 #include "gpuEventContainer.hpp" // for gpuEventContainer
 #include "gpuProcess.hpp"        // for gpuProcess
+#include "hsa/hsa.h"             // for hsa_signal_t
 
-#include <string> // for string
+#include <stddef.h> // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
 
 class hsaProcess final : public gpuProcess {
 public:
@@ -19,7 +22,10 @@ protected:
     gpuCommand* create_command(const std::string& cmd_name,
                                const std::string& unique_name) override;
     gpuEventContainer* create_signal() override;
-    void queue_commands(int gpu_frame_id) override;
+    void queue_command(size_t c, int gpu_frame_id) override;
+
+    /// The signal of the last command queued on each frame
+    std::vector<hsa_signal_t> frame_signals;
 };
 
 #endif // HSA_PROCESS_H
@@ -1,6 +1,8 @@
 #include "clCommand.hpp"
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 using kotekan::bufferContainer;
 using kotekan::Config;
@@ -15,6 +17,23 @@ clCommand::clCommand(Config& config_, const std::string& unique_name_,
     gpuCommand(config_, unique_name_, host_buffers_, device_, default_kernel_command,
                default_kernel_file_name),
     device(device_) {
+    // The tuning entries are keyed by the geometry of the array
+    nlohmann::json geometry = nlohmann::json::object();
+    for (const std::string key : {"num_elements", "num_local_freq", "num_data_sets",
+                                  "samples_per_data_set", "block_size"}) {
+        int32_t value = config.get_default<int32_t>(unique_name, key, -1);
+        if (value != -1)
+            geometry[key] = value;
+    }
+    tuned_parameters = device.get_tuned_parameters(
+        config.get_default<string>(unique_name, "name", ""), geometry);
+    if (!tuned_parameters.empty())
+        INFO("Tuned parameters: {:s}", tuned_parameters.dump());
+
+    if (default_kernel_file_name != "")
+        kernel_file_name = config.get_default<string>(unique_name, "kernel_path", ".") + "/"
+                           + get_tuned<string>("kernel", default_kernel_file_name);
+
     post_events = (cl_event*)malloc(_gpu_buffer_depth * sizeof(cl_event));
     for (int j = 0; j < _gpu_buffer_depth; ++j)
         post_events[j] = nullptr;
@@ -42,7 +61,8 @@ void clCommand::finalize_frame(int gpu_frame_id) {
             CHECK_CL_ERROR(clGetEventProfilingInfo(post_events[gpu_frame_id],
                                                    CL_PROFILING_COMMAND_END, sizeof(stop_time),
                                                    &stop_time, nullptr));
-            last_gpu_execution_time = ((double)(stop_time - start_time)) * 1e-9;
+            record_execution(gpu_frame_id, (double)start_time * 1e-9, (double)stop_time * 1e-9,
+                             true);
         }
 
         CHECK_CL_ERROR(clReleaseEvent(post_events[gpu_frame_id]));
@@ -54,38 +74,24 @@ void clCommand::finalize_frame(int gpu_frame_id) {
 
 // Specialist functions:
 void clCommand::build() {
-    size_t program_size;
-    FILE* fp;
-    char* program_buffer;
-    cl_int err;
-
     if (kernel_command != "") {
-        DEBUG2("Building! {:s}", kernel_command)
-        fp = fopen(kernel_file_name.c_str(), "r");
-        if (fp == nullptr) {
+        DEBUG2("Loading! {:s}", kernel_command)
+        std::ifstream file(kernel_file_name);
+        if (!file) {
             FATAL_ERROR("error loading file: {:s}", kernel_file_name);
         }
-        fseek(fp, 0, SEEK_END);
-        program_size = ftell(fp);
-        rewind(fp);
-
-        program_buffer = (char*)malloc(program_size + 1);
-        program_buffer[program_size] = '\0';
-        int sizeRead = fread(program_buffer, sizeof(char), program_size, fp);
-        if (sizeRead < (int32_t)program_size)
-            ERROR("Error reading the file: {:s}", kernel_file_name);
-        fclose(fp);
-        program =
-            clCreateProgramWithSource(((clDeviceInterface*)&device)->get_context(), (cl_uint)1,
-                                      (const char**)&program_buffer, &program_size, &err);
-        CHECK_CL_ERROR(err);
-
-        program_size = 0;
-        free(program_buffer);
-        DEBUG2("Built! {:s}", kernel_command)
+        kernel_source.assign(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+        DEBUG2("Loaded! {:s}", kernel_command)
     }
 }
 
+void clCommand::build_program(const std::string& cl_options) {
+    DEBUG2("Building! {:s}", kernel_command)
+    program = device.build_program(kernel_source, cl_options);
+    DEBUG2("Built! {:s}", kernel_command)
+}
+
 void clCommand::setKernelArg(cl_uint param_ArgPos, cl_mem param_Buffer) {
     CHECK_CL_ERROR(clSetKernelArg(kernel, param_ArgPos, sizeof(void*), (void*)&param_Buffer));
 }
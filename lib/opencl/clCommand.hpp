@@ -24,6 +24,7 @@
 #include "factory.hpp"
 #include "gpuCommand.hpp"
 #include "kotekanLogging.hpp"
+#include "json.hpp"
 
 #include <signal.h>
 #include <stdio.h>
@@ -55,8 +56,8 @@ public:
     virtual ~clCommand();
 
     /** The build function creates the event to return as the post event in an event chaining
-     * sequence. If a kernel is part of the clCommand object definition the resources to run it are
-     * allocated on the gpu here.
+     * sequence. If a kernel is part of the clCommand object definition its source is loaded here,
+     * and the derived commands build it with @c build_program.
      **/
     virtual void build();
 
@@ -77,6 +78,33 @@ public:
     virtual void finalize_frame(int gpu_frame_id) override;
 
 protected:
+    /**
+     * @brief Returns the value of an option from the config, else the tuned value of this
+     *        command on the device (see @c clDeviceInterface), else @p default_value.
+     * @param name           The name of the option, e.g. "kernel".
+     * @param default_value  The value if it is neither in the config nor tuned.
+     */
+    template<typename T>
+    T get_tuned(const std::string& name, const T& default_value) {
+        T value = default_value;
+        if (tuned_parameters.count(name))
+            value = tuned_parameters[name].get<T>();
+        return config.get_default<T>(unique_name, name, value);
+    }
+
+    /**
+     * @brief Builds @c program from the kernel source, or loads its cached binary (see
+     *        @c clDeviceInterface::build_program).
+     * @param cl_options  The build options, e.g. the @c -D defines of the geometry.
+     */
+    void build_program(const std::string& cl_options);
+
+    /// The tuned parameters of this command on the device, for its geometry
+    nlohmann::json tuned_parameters;
+
+    /// The source of the kernel, loaded by @c build
+    std::string kernel_source;
+
     /// Compiled instance of the kernel that will execute on the GPU once enqueued.
     cl_kernel kernel;
     /// Allocates resources on the GPU for the kernel.
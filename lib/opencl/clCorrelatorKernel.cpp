@@ -46,9 +46,7 @@ void clCorrelatorKernel::build() {
     cl_options += " -D NUM_FREQUENCIES=" + std::to_string(_num_local_freq);
     cl_options += " -D NUM_BLOCKS=" + std::to_string(_num_blocks);
 
-    cl_device_id dev_id = device.get_id();
-
-    CHECK_CL_ERROR(clBuildProgram(program, 1, &dev_id, cl_options.c_str(), nullptr, nullptr));
+    build_program(cl_options);
 
     kernel = clCreateKernel(program, "corr", &err);
     CHECK_CL_ERROR(err);
@@ -2,34 +2,95 @@
 
 #include "clDeviceInterface.hpp"
 
+#include "Hash.hpp"
+#include "KernelTuning.hpp" // for find_tuned_parameters
 #include "clCommand.hpp"
 #include "math.h"
 
+#include "fmt.hpp"
+
 #include <errno.h>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 using kotekan::Config;
+using nlohmann::json;
 
-clDeviceInterface::clDeviceInterface(Config& config_, int32_t gpu_id_, int gpu_buffer_depth_) :
-    gpuDeviceInterface(config_, gpu_id_, gpu_buffer_depth_) {
+clDeviceInterface::clDeviceInterface(Config& config_, int32_t gpu_id_, int gpu_buffer_depth_,
+                                     uint32_t platform_index, const std::string& device_type,
+                                     const std::string& tuning_file,
+                                     const std::string& kernel_cache_dir_) :
+    gpuDeviceInterface(config_, gpu_id_, gpu_buffer_depth_),
+    kernel_cache_dir(kernel_cache_dir_) {
 
     // Get a platform.
-    CHECK_CL_ERROR(clGetPlatformIDs(1, &platform_id, nullptr));
+    cl_uint num_platforms;
+    CHECK_CL_ERROR(clGetPlatformIDs(0, nullptr, &num_platforms));
+    if (platform_index >= num_platforms)
+        throw std::runtime_error(fmt::format(fmt("There is no OpenCL platform {:d}, only {:d}"),
+                                             platform_index, num_platforms));
+    std::vector<cl_platform_id> platform_ids(num_platforms);
+    CHECK_CL_ERROR(clGetPlatformIDs(num_platforms, platform_ids.data(), nullptr));
+    platform_id = platform_ids[platform_index];
     INFO("GPU Id {:d}", gpu_id);
 
-    // Find out how many GPUs can be probed.
+    cl_device_type type;
+    if (device_type == "gpu")
+        type = CL_DEVICE_TYPE_GPU;
+    else if (device_type == "cpu")
+        type = CL_DEVICE_TYPE_CPU;
+    else if (device_type == "accelerator")
+        type = CL_DEVICE_TYPE_ACCELERATOR;
+    else if (device_type == "all")
+        type = CL_DEVICE_TYPE_ALL;
+    else
+        throw std::invalid_argument(
+            fmt::format(fmt("Unknown OpenCL device type: {:s}"), device_type));
+
+    // Find out how many devices can be probed.
     cl_uint max_num_gpus;
-    CHECK_CL_ERROR(clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 0, nullptr, &max_num_gpus));
-    INFO("Maximum number of GPUs: {:d}", max_num_gpus);
+    CHECK_CL_ERROR(clGetDeviceIDs(platform_id, type, 0, nullptr, &max_num_gpus));
+    INFO("Maximum number of devices of type {:s}: {:d}", device_type, max_num_gpus);
+    if ((cl_uint)gpu_id >= max_num_gpus)
+        throw std::runtime_error(
+            fmt::format(fmt("There is no OpenCL device {:d} of type {:s}"), gpu_id, device_type));
 
-    // Find a GPU device..
+    // Find a device..
     cl_device_id device_ids[max_num_gpus];
-    CHECK_CL_ERROR(
-        clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, max_num_gpus, device_ids, nullptr));
+    CHECK_CL_ERROR(clGetDeviceIDs(platform_id, type, max_num_gpus, device_ids, nullptr));
     device_id = device_ids[gpu_id];
+    INFO("OpenCL device: {:s}", get_device_name());
 
     cl_int err;
     context = clCreateContext(nullptr, 1, &device_id, nullptr, nullptr, &err);
     CHECK_CL_ERROR(err);
+
+    tuning = json::object();
+    if (tuning_file != "") {
+        std::ifstream file(tuning_file);
+        if (!file)
+            throw std::runtime_error(
+                fmt::format(fmt("Could not open the kernel tuning file {:s}"), tuning_file));
+        json all_tuning = json::parse(file);
+        if (all_tuning.count(get_device_name()))
+            tuning = all_tuning[get_device_name()];
+        INFO("Loaded the tuned parameters of {:d} commands from {:s}", tuning.size(),
+             tuning_file);
+    }
+
+    if (kernel_cache_dir != "") {
+        if (mkdir(kernel_cache_dir.c_str(), 0775) < 0 && errno != EEXIST)
+            throw std::runtime_error(fmt::format(
+                fmt("Could not make the kernel cache directory {:s}: {:s}"), kernel_cache_dir,
+                strerror(errno)));
+        INFO("Caching the program binaries in {:s}", kernel_cache_dir);
+    }
 }
 
 clDeviceInterface::~clDeviceInterface() {
@@ -68,6 +129,109 @@ cl_command_queue clDeviceInterface::getQueue(int queue_id) {
     return queue[queue_id];
 }
 
+std::string clDeviceInterface::get_device_name() {
+    return get_device_info(CL_DEVICE_NAME);
+}
+
+std::string clDeviceInterface::get_device_info(cl_device_info param) {
+    size_t len;
+    CHECK_CL_ERROR(clGetDeviceInfo(device_id, param, 0, nullptr, &len));
+    std::vector<char> value(len);
+    CHECK_CL_ERROR(clGetDeviceInfo(device_id, param, len, value.data(), nullptr));
+    return std::string(value.data());
+}
+
+json clDeviceInterface::get_tuned_parameters(const std::string& command, const json& geometry) {
+    return find_tuned_parameters(tuning, command, geometry);
+}
+
+cl_program clDeviceInterface::build_program(const std::string& source,
+                                            const std::string& options) {
+    cl_int err;
+    cl_program program;
+
+    std::string cache_file = "";
+    if (kernel_cache_dir != "") {
+        // A new driver can't always load the binaries of an old one
+        Hash key = hash(get_device_name() + "\n" + get_device_info(CL_DRIVER_VERSION) + "\n"
+                        + options + "\n" + source);
+        cache_file = fmt::format(fmt("{:s}/{}.bin"), kernel_cache_dir, key);
+
+        std::ifstream file(cache_file, std::ios::binary);
+        if (file) {
+            std::vector<unsigned char> binary((std::istreambuf_iterator<char>(file)),
+                                              std::istreambuf_iterator<char>());
+            const unsigned char* binary_ptr = binary.data();
+            size_t binary_size = binary.size();
+            cl_int binary_status;
+            program = clCreateProgramWithBinary(context, 1, &device_id, &binary_size, &binary_ptr,
+                                                &binary_status, &err);
+            if (err == CL_SUCCESS) {
+                // The binaries still need to be built, which is quick
+                if (binary_status == CL_SUCCESS
+                    && clBuildProgram(program, 1, &device_id, options.c_str(), nullptr, nullptr)
+                           == CL_SUCCESS) {
+                    DEBUG("Loaded the program binary {:s}", cache_file);
+                    return program;
+                }
+                CHECK_CL_ERROR(clReleaseProgram(program));
+            }
+            WARN("Could not load the program binary {:s}, building it from source", cache_file);
+        }
+    }
+
+    const char* source_ptr = source.c_str();
+    size_t source_size = source.size();
+    program = clCreateProgramWithSource(context, 1, &source_ptr, &source_size, &err);
+    CHECK_CL_ERROR(err);
+    err = clBuildProgram(program, 1, &device_id, options.c_str(), nullptr, nullptr);
+    if (err != CL_SUCCESS)
+        log_build_failure(program);
+    CHECK_CL_ERROR(err);
+
+    if (cache_file != "") {
+        // Written to a temporary file which is renamed, so the devices of a node building the
+        // same program at the same time never load a partial binary
+        std::vector<unsigned char> binary = get_program_binary(program);
+        std::string tmp_file = fmt::format(fmt("{:s}.{:d}.{:d}.tmp"), cache_file, getpid(), gpu_id);
+        std::ofstream file(tmp_file, std::ios::binary);
+        file.write((const char*)binary.data(), binary.size());
+        file.close();
+        if (!binary.empty() && file && rename(tmp_file.c_str(), cache_file.c_str()) == 0) {
+            INFO("Cached the program binary {:s}", cache_file);
+        } else {
+            WARN("Could not write the program binary {:s}", cache_file);
+            unlink(tmp_file.c_str());
+        }
+    }
+
+    return program;
+}
+
+std::vector<unsigned char> clDeviceInterface::get_program_binary(cl_program program) {
+    // The program is only built for this device, so it has one binary
+    size_t binary_size = 0;
+    CHECK_CL_ERROR(clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(binary_size),
+                                    &binary_size, nullptr));
+    std::vector<unsigned char> binary(binary_size);
+    if (binary_size > 0) {
+        unsigned char* binary_ptr = binary.data();
+        CHECK_CL_ERROR(clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binary_ptr),
+                                        &binary_ptr, nullptr));
+    }
+    return binary;
+}
+
+void clDeviceInterface::log_build_failure(cl_program program) {
+    size_t len = 0;
+    CHECK_CL_ERROR(
+        clGetProgramBuildInfo(program, device_id, CL_PROGRAM_BUILD_LOG, 0, nullptr, &len));
+    std::vector<char> build_log(len + 1, '\0');
+    CHECK_CL_ERROR(clGetProgramBuildInfo(program, device_id, CL_PROGRAM_BUILD_LOG, len,
+                                         build_log.data(), nullptr));
+    ERROR("CL failed. Build log follows: \n {:s}", build_log.data());
+}
+
 
 void clDeviceInterface::prepareCommandQueue(bool enable_profiling) {
     cl_int err;
@@ -12,6 +12,10 @@
 #include <CL/cl_platform.h>
 #endif
 #include "clUtils.hpp"
+#include "json.hpp"
+
+#include <string>
+#include <vector>
 
 // This adjusts the number of queues used by the OpenCL runtime
 // One queue is for data transfers to the GPU, one is for kernels,
@@ -19,9 +23,45 @@
 // Unless you really know what you are doing, don't change this.
 #define NUM_QUEUES 3
 
+/**
+ * @class clDeviceInterface
+ * @brief Class to handle OpenCL interactions with a device.
+ *
+ * The device can be any OpenCL device, e.g. a GPU, or a CPU with PoCL to run the pipeline
+ * without a GPU.
+ *
+ * The device can also load the kernel parameters found by @c tune_cl_kernels.py. The tuning
+ * file is a JSON object with the tuned commands of each device name, each command being a list
+ * of entries like
+ * @code
+ * {"geometry": {"num_elements": 256, "samples_per_data_set": 49152, "block_size": 32},
+ *  "parameters": {"kernel": "kv_corr.cl"}, "time": 0.0123}
+ * @endcode
+ * The commands use the parameters of the first entry which matches their geometry (see
+ * @c find_tuned_parameters), for the options which aren't set in the config (see
+ * @c clCommand::get_tuned).
+ *
+ * The kernels are built with the geometry of the array as @c -D options, so with a
+ * @c kernel_cache_dir the binaries of the programs are kept on disk, keyed by a hash of the
+ * device name, the driver version, the options and the source. Only the first run with a
+ * geometry compiles the kernels, and the devices of the same model in a node share the binaries.
+ */
 class clDeviceInterface final : public gpuDeviceInterface {
 public:
-    clDeviceInterface(kotekan::Config& config_, int32_t gpu_id_, int gpu_buffer_depth_);
+    /**
+     * @brief Opens the device.
+     * @param config_            The config.
+     * @param gpu_id_            The index of the device among the devices of @p device_type.
+     * @param gpu_buffer_depth_  The number of GPU frames.
+     * @param platform_index     The index of the OpenCL platform.
+     * @param device_type        The type of the devices, "gpu", "cpu", "accelerator" or "all".
+     * @param tuning_file        The file with the tuned kernel parameters, or "" for none.
+     * @param kernel_cache_dir   The directory of the cached program binaries, or "" for none.
+     */
+    clDeviceInterface(kotekan::Config& config_, int32_t gpu_id_, int gpu_buffer_depth_,
+                      uint32_t platform_index = 0, const std::string& device_type = "gpu",
+                      const std::string& tuning_file = "",
+                      const std::string& kernel_cache_dir = "");
     ~clDeviceInterface();
 
     void prepareCommandQueue(bool enable_profiling);
@@ -29,6 +69,27 @@ public:
     cl_context& get_context();
     cl_device_id get_id();
 
+    /// Returns the name of the device, which is the key of its entries in the tuning file
+    std::string get_device_name();
+
+    /**
+     * @brief Returns the tuned parameters of a command on this device.
+     * @param command   The name of the command, e.g. "clKVCorr".
+     * @param geometry  The geometry of the command, e.g. its "num_elements".
+     * @return The parameters of the first entry of @p command whose geometry is a subset of
+     *         @p geometry, or an empty object if there is none.
+     */
+    nlohmann::json get_tuned_parameters(const std::string& command,
+                                        const nlohmann::json& geometry);
+
+    /**
+     * @brief Builds a program for this device, from the cached binary if there is one.
+     * @param source   The OpenCL source of the program.
+     * @param options  The build options, e.g. the @c -D defines of the geometry.
+     * @return The built program.
+     */
+    cl_program build_program(const std::string& source, const std::string& options);
+
     // Function overrides to cast the generic gpu_memory retulsts appropriately.
     cl_mem get_gpu_memory_array(const std::string& name, const uint32_t index, const uint32_t len);
     cl_mem get_gpu_memory(const std::string& name, const uint32_t len);
@@ -44,6 +105,20 @@ protected:
     cl_command_queue queue[NUM_QUEUES];
 
 private:
+    /// Returns a string of an info parameter of the device, e.g. @c CL_DEVICE_NAME
+    std::string get_device_info(cl_device_info param);
+
+    /// Returns the binary of a built program, or an empty vector if it has none
+    std::vector<unsigned char> get_program_binary(cl_program program);
+
+    /// Logs the build log of a program which failed to build
+    void log_build_failure(cl_program program);
+
+    /// The entries of this device in the tuning file
+    nlohmann::json tuning;
+
+    /// The directory of the cached program binaries, "" to always build from source
+    std::string kernel_cache_dir;
 };
 
 #endif // CL_DEVICE_INTERFACE_H
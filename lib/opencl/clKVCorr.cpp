@@ -20,23 +20,26 @@ clKVCorr::clKVCorr(Config& config, const std::string& unique_name, bufferContain
     _num_blocks = config.get<int>(unique_name, "num_blocks");
     _samples_per_data_set = config.get<int>(unique_name, "samples_per_data_set");
     _data_format = config.get_default<string>(unique_name, "data_format", "4+4b");
-    _full_complicated = config.get_default<bool>(unique_name, "full_complicated", false);
+    _full_complicated = get_tuned<bool>("full_complicated", false);
+    _wi_size = get_tuned<int>("wi_size", 4);
 
     if (_data_format == "4+4b") {
         if (small_array)
             kernel_file_name = config.get_default<string>(unique_name, "kernel_path", ".") + "/"
-                               + config.get_default<string>(unique_name, "kernel", "kv_corr_sm.cl");
+                               + get_tuned<string>("kernel", "kv_corr_sm.cl");
         else if (_full_complicated) {
             if (small_array)
                 throw std::invalid_argument("Can't do full_complicated with num_elements < 32");
             else
-                kernel_file_name =
-                    config.get_default<string>(unique_name, "kernel_path", ".") + "/"
-                    + config.get_default<string>(unique_name, "kernel", "kv_corr_amd.cl");
+                kernel_file_name = config.get_default<string>(unique_name, "kernel_path", ".")
+                                   + "/" + get_tuned<string>("kernel", "kv_corr_amd.cl");
         }
     } else if (_data_format == "dot4b") {
+        if (_wi_size <= 0 || _block_size % _wi_size != 0)
+            throw std::invalid_argument(fmt::format(fmt("wi_size {:d} must divide block_size {:d}"),
+                                                    _wi_size, _block_size));
         kernel_file_name = config.get_default<string>(unique_name, "kernel_path", ".") + "/"
-                           + config.get_default<string>(unique_name, "kernel", "kv_corr_dot4b.cl");
+                           + get_tuned<string>("kernel", "kv_corr_dot4b.cl");
     } else {
         throw std::invalid_argument(fmt::format(fmt("Unknown Data Format: {:s}"), _data_format));
     }
@@ -88,7 +91,6 @@ void clKVCorr::build() {
         cl_options += " -D COARSE_BLOCK_SIZE=" + std::to_string(_block_size / 4);
     } else if (_data_format == "dot4b") {
         INFO("Running experimental dot-product data");
-        int _wi_size = 4;
         gws[0] = _block_size / _wi_size * _num_local_freq;
         gws[1] = _block_size / _wi_size;
         gws[2] = _num_blocks;
@@ -104,20 +106,8 @@ void clKVCorr::build() {
         throw std::invalid_argument("Unknown Data Format: " + _data_format);
     }
 
-    cl_device_id dev_id = device.get_id();
-
-    err = clBuildProgram(program, 1, &dev_id, cl_options.c_str(), nullptr, nullptr);
-    if (err != CL_SUCCESS) {
-        size_t len = 0;
-        CHECK_CL_ERROR(clGetProgramBuildInfo(program, device.get_id(), CL_PROGRAM_BUILD_LOG, 0,
-                                             nullptr, &len));
-        char* buffer = (char*)calloc(len, sizeof(char));
-        CHECK_CL_ERROR(clGetProgramBuildInfo(program, device.get_id(), CL_PROGRAM_BUILD_LOG, len,
-                                             buffer, nullptr));
-        INFO("CL failed. Build log follows: \n {:s}", buffer);
-        free(buffer);
-    }
-    CHECK_CL_ERROR(err);
+    build_program(cl_options);
+
     kernel = clCreateKernel(program, "corr", &err);
     CHECK_CL_ERROR(err);
 
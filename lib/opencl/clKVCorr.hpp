@@ -41,6 +41,9 @@ private:
     std::string _data_format;
     /// This will enable use of the AMD-intrinsic-laden overly-complex & optimized kernel.
     bool _full_complicated;
+    /// Elements per work item of the dot4b kernel, the work groups are
+    /// (block_size/wi_size)^2. Can be tuned, see clDeviceInterface.
+    int32_t _wi_size;
 };
 
 #endif // CL_CORRELATOR_KERNEL
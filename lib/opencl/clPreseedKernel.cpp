@@ -30,14 +30,12 @@ void clPreseedKernel::build() {
 
     cl_int err;
 
-    cl_device_id dev_id = device.get_id();
-
     std::string cl_options = "";
     cl_options += " -D NUM_ELEMENTS=" + std::to_string(_num_elements);
     cl_options += " -D NUM_BLOCKS=" + std::to_string(_num_blocks);
     cl_options += " -D NUM_TIMESAMPLES=" + std::to_string(_samples_per_data_set);
 
-    CHECK_CL_ERROR(clBuildProgram(program, 1, &dev_id, cl_options.c_str(), nullptr, nullptr));
+    build_program(cl_options);
 
     kernel = clCreateKernel(program, kernel_command.c_str(), &err);
     CHECK_CL_ERROR(err);
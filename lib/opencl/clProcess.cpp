@@ -18,9 +18,15 @@ REGISTER_KOTEKAN_STAGE(clProcess);
 clProcess::clProcess(Config& config_, const std::string& unique_name,
                      bufferContainer& buffer_container) :
     gpuProcess(config_, unique_name, buffer_container) {
-    device = new clDeviceInterface(config_, gpu_id, _gpu_buffer_depth);
+    device = new clDeviceInterface(
+        config_, gpu_id, _gpu_buffer_depth,
+        config.get_default<uint32_t>(unique_name, "platform", 0),
+        config.get_default<std::string>(unique_name, "device_type", "gpu"),
+        config.get_default<std::string>(unique_name, "kernel_tuning_file", ""),
+        config.get_default<std::string>(unique_name, "kernel_cache_dir", ""));
     dev = device;
     device->prepareCommandQueue(true); // yes profiling
+    frame_signals.resize(_gpu_buffer_depth, nullptr);
     init();
 }
 
@@ -39,12 +45,12 @@ gpuCommand* clProcess::create_command(const std::string& cmd_name, const std::st
     return cmd;
 }
 
-void clProcess::queue_commands(int gpu_frame_id) {
-    cl_event signal = nullptr;
-    for (auto& command : commands) {
-        // Feed the last signal into the next operation
-        signal = ((clCommand*)command)->execute(gpu_frame_id, signal);
+void clProcess::queue_command(size_t c, int gpu_frame_id) {
+    // Feed the last signal of the frame into the next operation
+    cl_event& signal = frame_signals[gpu_frame_id];
+    signal = ((clCommand*)commands[c])->execute(gpu_frame_id, c == 0 ? nullptr : signal);
+    if (c == commands.size() - 1) {
+        final_signals[gpu_frame_id]->set_signal(signal);
+        INFO("Commands executed.");
     }
-    final_signals[gpu_frame_id]->set_signal(signal);
-    INFO("Commands executed.");
 }
@@ -9,6 +9,19 @@
 #include "clEventContainer.hpp"
 #include "gpuProcess.hpp"
 
+/**
+ * @class clProcess
+ * @brief Runs a pipeline of @c clCommand on an OpenCL device.
+ *
+ * @conf  platform            Int, default 0. The index of the OpenCL platform.
+ * @conf  device_type         String, default "gpu". The type of the devices which @c gpu_id
+ *                            indexes, "gpu", "cpu" (e.g. PoCL), "accelerator" or "all".
+ * @conf  kernel_tuning_file  String, default "". The file of tuned kernel parameters written
+ *                            by @c tune_cl_kernels.py, or "" for none.
+ * @conf  kernel_cache_dir    String, default "". The directory of the cached binaries of the
+ *                            built kernels, shared by the devices of a node, or "" to always
+ *                            build the kernels from source.
+ */
 class clProcess final : public gpuProcess {
 public:
     clProcess(kotekan::Config& config, const std::string& unique_name,
@@ -18,9 +31,11 @@ public:
     gpuCommand* create_command(const std::string& cmd_name,
                                const std::string& unique_name) override;
     gpuEventContainer* create_signal() override;
-    void queue_commands(int gpu_frame_id) override;
+    void queue_command(size_t c, int gpu_frame_id) override;
 
     clDeviceInterface* device;
+    /// The signal of the last command queued on each frame
+    std::vector<cl_event> frame_signals;
 };
 
 #endif // CL_PROCESS_H
@@ -6,23 +6,28 @@
 #include "buffer.h"              // for mark_frame_empty, register_consumer, wait_for_full_frame
 #include "bufferContainer.hpp"   // for bufferContainer
 #include "datasetManager.hpp"    // for dset_id_t, fingerprint_t, datasetManager
-#include "datasetState.hpp"      // for metadataState, _factory_aliasdatasetState
+#include "datasetState.hpp"      // for metadataState, freqState, _factory_aliasdatasetState
 #include "factory.hpp"           // for FACTORY
-#include "kotekanLogging.hpp"    // for FATAL_ERROR, INFO, WARN, DEBUG, logLevel
+#include "kotekanLogging.hpp"    // for FATAL_ERROR, INFO, WARN, DEBUG, ERROR, logLevel
 #include "prometheusMetrics.hpp" // for Counter, Metrics, MetricFamily, Gauge
 #include "restServer.hpp"        // for HTTP_RESPONSE, connectionInstance, restServer
+#include "util.h"                // for string_tail
 #include "version.h"             // for get_git_commit_hash
 #include "visFile.hpp"           // for visFileBundle, _factory_aliasvisFile
 
-#include <algorithm>  // for copy, copy_backward, equal, max
-#include <atomic>     // for atomic_bool
-#include <deque>      // for deque
-#include <exception>  // for exception
-#include <functional> // for _Bind_helper<>::type, bind, function
-#include <regex>      // for match_results<>::_Base_type
-#include <stdexcept>  // for runtime_error, out_of_range
-#include <utility>    // for pair
-#include <vector>     // for vector
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm>     // for copy, copy_backward, equal, max, upper_bound
+#include <atomic>        // for atomic_bool
+#include <deque>         // for deque
+#include <exception>     // for exception
+#include <functional>    // for _Bind_helper<>::type, bind, function
+#include <pthread.h>     // for pthread_setname_np
+#include <regex>         // for match_results<>::_Base_type
+#include <stdexcept>     // for runtime_error, out_of_range
+#include <sys/statvfs.h> // for statvfs
+#include <utility>       // for pair
+#include <vector>        // for vector
 
 
 using kotekan::bufferContainer;
@@ -35,6 +40,16 @@ using kotekan::HTTP_RESPONSE;
 using kotekan::restServer;
 
 
+const std::map<BaseWriter::diskStatus, std::string> BaseWriter::disk_status_map = {
+    {BaseWriter::diskStatus::active, "active"},
+    {BaseWriter::diskStatus::slow, "slow"},
+    {BaseWriter::diskStatus::full, "full"},
+    {BaseWriter::diskStatus::failed, "failed"}};
+
+// How often to check the free space on the disks (in seconds)
+static const double disk_space_check_interval = 10.0;
+
+
 BaseWriter::BaseWriter(Config& config, const std::string& unique_name,
                        bufferContainer& buffer_container) :
     Stage(config, unique_name, buffer_container, std::bind(&BaseWriter::main_thread, this)),
@@ -43,10 +58,45 @@ BaseWriter::BaseWriter(Config& config, const std::string& unique_name,
     bad_dataset_frame_counter(Metrics::instance().add_counter(
         "kotekan_writer_bad_dataset_frame_total", unique_name, {"dataset_id"})),
     write_time_metric(
-        Metrics::instance().add_gauge("kotekan_writer_write_time_seconds", unique_name)) {
+        Metrics::instance().add_gauge("kotekan_writer_write_time_seconds", unique_name)),
+    disk_write_bytes_counter(Metrics::instance().add_counter(
+        "kotekan_writer_disk_write_bytes_total", unique_name, {"disk"})),
+    disk_write_time_metric(Metrics::instance().add_gauge("kotekan_writer_disk_write_time_seconds",
+                                                         unique_name, {"disk"})),
+    disk_queue_length_metric(Metrics::instance().add_gauge("kotekan_writer_disk_queue_length",
+                                                           unique_name, {"disk"})),
+    disk_active_metric(
+        Metrics::instance().add_gauge("kotekan_writer_disk_active", unique_name, {"disk"})),
+    disk_excluded_counter(Metrics::instance().add_counter(
+        "kotekan_writer_disk_excluded_total", unique_name, {"disk", "reason"})),
+    disk_dropped_frame_counter(Metrics::instance().add_counter(
+        "kotekan_writer_disk_dropped_frame_total", unique_name, {"disk"})) {
 
     // Fetch any simple configuration
-    root_path = config.get_default<std::string>(unique_name, "root_path", ".");
+    nlohmann::json root_path = config.get_default<nlohmann::json>(unique_name, "root_path", ".");
+    std::vector<std::string> root_paths;
+    if (root_path.is_array())
+        root_paths = root_path.get<std::vector<std::string>>();
+    else
+        root_paths = {root_path.get<std::string>()};
+    if (root_paths.empty()) {
+        FATAL_ERROR("No root_path given.");
+        return;
+    }
+    for (const auto& path : root_paths) {
+        disks.push_back(std::make_unique<diskState>());
+        disks.back()->root_path = path;
+        disk_active_metric.labels({path}).set(1);
+    }
+
+    std::string stripe = config.get_default<std::string>(unique_name, "stripe", "freq");
+    if (stripe != "freq" && stripe != "time") {
+        FATAL_ERROR("Unknown stripe '{}'. Use 'freq' or 'time'.", stripe);
+        return;
+    }
+    stripe_time = (stripe == "time");
+    min_free_space = config.get_default<double>(unique_name, "min_free_space", 1.0);
+
     acq_timeout = config.get_default<double>(unique_name, "acq_timeout", 300);
     ignore_version = config.get_default<bool>(unique_name, "ignore_version", false);
 
@@ -87,28 +137,253 @@ BaseWriter::BaseWriter(Config& config, const std::string& unique_name,
     // Get the list of buffers that this stage should connect to
     in_buf = get_buffer("in_buf");
     register_consumer(in_buf, unique_name.c_str());
+    frame_on_disk_queue.resize(in_buf->num_frames, false);
+
+    max_disk_backlog = config.get_default<size_t>(unique_name, "max_disk_backlog",
+                                                  std::max(in_buf->num_frames / 2, 1));
 }
 
 void BaseWriter::main_thread() {
 
     frameID frame_id(in_buf);
 
+    // Start the I/O threads
+    for (size_t i = 0; i < disks.size(); i++) {
+        disks[i]->thread = std::thread(&BaseWriter::disk_thread, this, i);
+#ifndef MAC_OSX
+        std::string short_name =
+            string_tail(fmt::format(fmt("{:s}/disk_thread/{:d}"), unique_name, i), 15);
+        pthread_setname_np(disks[i]->thread.native_handle(), short_name.c_str());
+#endif
+    }
+
     while (!stop_thread) {
 
+        // A frame still queued for a disk is full until it is written, so wait
+        // for it to be released before waiting for the frame to be filled again
+        {
+            std::unique_lock<std::mutex> lock(disk_lock);
+            frame_released.wait(lock, [&]() { return !frame_on_disk_queue[frame_id]; });
+        }
+
         // Wait for the buffer to be filled with data
         if (wait_for_full_frame(in_buf, unique_name.c_str(), frame_id) == nullptr) {
             break;
         }
 
-        // Write frame
+        // Queue the frame for writing
+        current_frame_id = frame_id;
+        frame_queued = false;
         write_data(in_buf, frame_id);
 
-        // Mark the buffer and move on
-        mark_frame_empty(in_buf, unique_name.c_str(), frame_id++);
+        // Mark the buffer and move on. Queued frames are released by the
+        // I/O thread once they are written.
+        if (!frame_queued)
+            mark_frame_empty(in_buf, unique_name.c_str(), frame_id);
+        frame_id++;
 
         // Clean out any acquisitions that have been inactive long
         close_old_acqs();
     }
+
+    // Let the I/O threads finish what is queued
+    {
+        std::lock_guard<std::mutex> lock(disk_lock);
+        stop_disks = true;
+    }
+    for (auto& disk : disks) {
+        disk->cond.notify_all();
+        if (disk->thread.joinable())
+            disk->thread.join();
+    }
+}
+
+void BaseWriter::disk_thread(size_t disk_ind) {
+
+    diskState& disk = *disks[disk_ind];
+    const std::string& path = disk.root_path;
+
+    std::unique_lock<std::mutex> lock(disk_lock);
+    while (true) {
+        disk.cond.wait(lock, [&]() { return !disk.queue.empty() || stop_disks; });
+        if (disk.queue.empty())
+            break;
+
+        writeRequest req = std::move(disk.queue.front());
+        disk.queue.pop_front();
+        disk_queue_length_metric.labels({path}).set(disk.queue.size());
+        bool failed = (disk.status == diskStatus::failed);
+        lock.unlock();
+
+        bool late = false;
+        double start = current_time();
+
+        if (failed) {
+            disk_dropped_frame_counter.labels({path}).inc();
+        } else {
+            try {
+                late = req.file_bundle->add_sample(req.time, req.freq_ind, *req.frame);
+            } catch (std::exception& e) {
+                ERROR("Failed writing to {:s}: {:s}", path, e.what());
+                disk_dropped_frame_counter.labels({path}).inc();
+                failed = true;
+            }
+        }
+
+        double elapsed = current_time() - start;
+        size_t nbytes = req.frame->data_size();
+
+        // Release the frame back into the buffer
+        req.frame.reset();
+        mark_frame_empty(in_buf, unique_name.c_str(), req.frame_id);
+
+        // Drop the files on this thread if they are no longer needed
+        req.file_bundle.reset();
+
+        lock.lock();
+        frame_on_disk_queue[req.frame_id] = false;
+        frame_released.notify_one();
+
+        if (failed) {
+            if (disk.status != diskStatus::failed)
+                exclude_disk(disk_ind, diskStatus::failed);
+            continue;
+        }
+
+        DEBUG("Written frequency {:d} to {:s} in {:.5f} s", req.freq_id, path, elapsed);
+
+        // Increase metric count if we dropped a frame at write time
+        if (late) {
+            late_frame_counter.labels({std::to_string(req.freq_id)}).inc();
+        } else {
+            disk_write_bytes_counter.labels({path}).inc(nbytes);
+        }
+
+        // Update average write time in prometheus
+        disk.write_time.add_sample(elapsed);
+        disk_write_time_metric.labels({path}).set(disk.write_time.average());
+        write_time.add_sample(elapsed);
+        write_time_metric.set(write_time.average());
+    }
+}
+
+void BaseWriter::update_disk_status() {
+
+    double now = current_time();
+
+    for (size_t i = 0; i < disks.size(); i++) {
+        auto& disk = *disks[i];
+
+        // Check the free space every now and again
+        if (disk.status != diskStatus::full && disk.status != diskStatus::failed
+            && now > disk.next_space_check) {
+            disk.next_space_check = now + disk_space_check_interval;
+            struct statvfs st;
+            if (statvfs(disk.root_path.c_str(), &st) == 0
+                && (double)st.f_bavail * st.f_frsize < min_free_space * 1e9) {
+                exclude_disk(i, diskStatus::full);
+                continue;
+            }
+        }
+
+        // A slow disk comes back once it has caught up
+        if (disk.status == diskStatus::slow && disk.queue.empty()) {
+            INFO("Disk {:s} has caught up. Writing to it again.", disk.root_path);
+            disk.status = diskStatus::active;
+            disk_active_metric.labels({disk.root_path}).set(1);
+        }
+    }
+
+    // Only exclude slow disks as long as there is another one to write to
+    for (size_t i = 0; i < disks.size(); i++) {
+        if (disks[i]->status != diskStatus::active || disks[i]->queue.size() <= max_disk_backlog)
+            continue;
+        for (size_t j = 0; j < disks.size(); j++) {
+            if (j != i && disks[j]->status == diskStatus::active) {
+                exclude_disk(i, diskStatus::slow);
+                break;
+            }
+        }
+    }
+}
+
+void BaseWriter::exclude_disk(size_t disk_ind, diskStatus reason) {
+    auto& disk = *disks[disk_ind];
+
+    WARN("Excluding disk {:s} ({:s}).", disk.root_path, disk_status_map.at(reason));
+    disk.status = reason;
+    disk_active_metric.labels({disk.root_path}).set(0);
+    disk_excluded_counter.labels({disk.root_path, disk_status_map.at(reason)}).inc();
+}
+
+bool BaseWriter::any_disk_usable() const {
+    for (auto& disk : disks) {
+        if (disk->status == diskStatus::active || disk->status == diskStatus::slow)
+            return true;
+    }
+    return false;
+}
+
+size_t BaseWriter::select_disk(acqState& acq, uint32_t chunk, time_ctype time) {
+
+    // Pick the least busy disk, preferring ones that aren't slow
+    auto least_busy = [this]() {
+        size_t best = disks.size();
+        for (size_t i = 0; i < disks.size(); i++) {
+            auto status = disks[i]->status;
+            if (status == diskStatus::full || status == diskStatus::failed)
+                continue;
+            if (best == disks.size()
+                || (status == diskStatus::active && disks[best]->status == diskStatus::slow)
+                || (status == disks[best]->status
+                    && disks[i]->queue.size() < disks[best]->queue.size()))
+                best = i;
+        }
+        return best;
+    };
+
+    if (!stripe_time) {
+        size_t& disk = acq.chunk_disk.at(chunk);
+        if (disks[disk]->status != diskStatus::active) {
+            size_t new_disk = least_busy();
+            if (new_disk != disk && disks[new_disk]->status == diskStatus::active) {
+                INFO("Moving frequency chunk {:d} from {:s} to {:s}.", chunk, disks[disk]->root_path,
+                     disks[new_disk]->root_path);
+                // The files are closed once the old disk is done with them
+                acq.file_bundles.erase({chunk, disk});
+                disk = new_disk;
+            } else if (disks[disk]->status != diskStatus::slow) {
+                disk = new_disk;
+            }
+        }
+        return disk;
+    }
+
+    // Every time sample goes to one disk, with the disks taking turns. Samples
+    // already started on a disk stay there unless it can't be written to.
+    auto it = acq.time_disk.find(time);
+    if (it != acq.time_disk.end()
+        && (disks[it->second]->status == diskStatus::active
+            || disks[it->second]->status == diskStatus::slow))
+        return it->second;
+
+    size_t disk = disks.size();
+    for (size_t i = 0; i < disks.size(); i++) {
+        size_t d = (next_disk + i) % disks.size();
+        if (disks[d]->status == diskStatus::active) {
+            disk = d;
+            break;
+        }
+    }
+    if (disk == disks.size())
+        disk = least_busy();
+    next_disk = (disk + 1) % disks.size();
+
+    acq.time_disk[time] = disk;
+    if (acq.time_disk.size() > window * disks.size())
+        acq.time_disk.erase(acq.time_disk.begin());
+
+    return disk;
 }
 
 void BaseWriter::init_acq(dset_id_t ds_id) {
@@ -141,23 +416,50 @@ void BaseWriter::init_acq(dset_id_t ds_id) {
         return;
     }
 
-    // TODO: chunk ID is not really supported now. Just set it to zero.
-    uint32_t chunk_id = 0;
-
     // Construct metadata
-    auto metadata = make_metadata(ds_id);
-
-    try {
-        acq.file_bundle = std::make_unique<visFileBundle>(
-            file_type, root_path, instrument_name, metadata, chunk_id, file_length, window,
-            kotekan::logLevel(_member_log_level), ds_id, file_length);
-    } catch (std::exception& e) {
-        FATAL_ERROR("Failed creating file bundle for new acquisition: {:s}", e.what());
+    acq.metadata = make_metadata(ds_id);
+
+    init_chunks(acq, ds_id);
+}
+
+void BaseWriter::init_chunks(acqState& acq, dset_id_t ds_id) {
+
+    // Striping over time, or not striping at all, writes all frequencies into
+    // one set of files per disk
+    if (stripe_time || disks.size() == 1) {
+        acq.chunk_start = {0};
+        acq.chunk_dataset_id = {ds_id};
+        acq.chunk_disk = {0};
+        return;
+    }
+
+    auto& dm = datasetManager::instance();
+    const freqState* fstate = dm.dataset_state<freqState>(ds_id);
+    if (fstate == nullptr) {
+        FATAL_ERROR("Couldn't find freqState ancestor of dataset {}.", ds_id);
+        return;
+    }
+    const auto& freqs = fstate->get_freqs();
+
+    // Split the frequencies into contiguous chunks, one for every disk, and
+    // register a dataset for each with just the frequencies of that chunk
+    size_t nchunk = std::min(disks.size(), freqs.size());
+    for (size_t c = 0; c < nchunk; c++) {
+        size_t start = c * freqs.size() / nchunk;
+        size_t end = (c + 1) * freqs.size() / nchunk;
+
+        std::vector<std::pair<uint32_t, freq_ctype>> chunk_freqs(freqs.begin() + start,
+                                                                 freqs.begin() + end);
+        state_id_t state_id = dm.create_state<freqState>(chunk_freqs).first;
+
+        acq.chunk_start.push_back(start);
+        acq.chunk_dataset_id.push_back(dm.add_dataset(state_id, ds_id));
+        acq.chunk_disk.push_back(c);
     }
 }
 
-void BaseWriter::write_frame(const FrameView& frame, dset_id_t dataset_id, uint32_t freq_id,
-                             time_ctype time) {
+void BaseWriter::write_frame(std::shared_ptr<const FrameView> frame, dset_id_t dataset_id,
+                             uint32_t freq_id, time_ctype time) {
 
     // Check the dataset ID hasn't changed
     if (acqs.count(dataset_id) == 0) {
@@ -169,7 +471,7 @@ void BaseWriter::write_frame(const FrameView& frame, dset_id_t dataset_id, uint3
 
     // Store the initial frame size to compare against future frames
     if (acq.frame_size < 0) {
-        acq.frame_size = frame.data_size();
+        acq.frame_size = frame->data_size();
     }
 
     // If the dataset is bad, skip the frame and move onto the next
@@ -183,36 +485,52 @@ void BaseWriter::write_frame(const FrameView& frame, dset_id_t dataset_id, uint3
         WARN("Frequency id={:d} not enabled for Writer, discarding frame", freq_id);
 
         // Check that the frame size matches what we expect
-    } else if ((int64_t)frame.data_size() != acq.frame_size) {
-        FATAL_ERROR("Size of frame doesn't match first frame ({:d} != {:d}).", frame.data_size(),
+    } else if ((int64_t)frame->data_size() != acq.frame_size) {
+        FATAL_ERROR("Size of frame doesn't match first frame ({:d} != {:d}).", frame->data_size(),
                     acq.frame_size);
         return;
 
     } else {
 
-        // Get frequency of the frame
+        // Get frequency of the frame, and the chunk of frequencies it is in
         uint32_t freq_ind = acq.freq_id_map.at(freq_id);
+        uint32_t chunk =
+            std::upper_bound(acq.chunk_start.begin(), acq.chunk_start.end(), freq_ind)
+            - acq.chunk_start.begin() - 1;
 
-        // Add all the new information to the file.
-        bool late;
-        double start = current_time();
-
-        // Write data
-        late = acq.file_bundle->add_sample(time, freq_ind, frame);
+        std::lock_guard<std::mutex> lock(disk_lock);
 
-        acq.last_update = current_time();
-        double elapsed = acq.last_update - start;
-
-        DEBUG("Written frequency {:d} in {:.5f} s", freq_id, elapsed);
-
-        // Increase metric count if we dropped a frame at write time
-        if (late) {
-            late_frame_counter.labels({std::to_string(freq_id)}).inc();
+        update_disk_status();
+        if (!any_disk_usable()) {
+            FATAL_ERROR("No disk left to write to.");
+            return;
+        }
+        size_t disk = select_disk(acq, chunk, time);
+
+        // Find the files for this chunk on this disk
+        auto& file_bundle = acq.file_bundles[{chunk, disk}];
+        if (!file_bundle) {
+            try {
+                file_bundle = std::make_shared<visFileBundle>(
+                    file_type, disks[disk]->root_path, instrument_name, acq.metadata, chunk,
+                    file_length, window, kotekan::logLevel(_member_log_level),
+                    acq.chunk_dataset_id[chunk], file_length);
+            } catch (std::exception& e) {
+                FATAL_ERROR("Failed creating file bundle for new acquisition: {:s}", e.what());
+                return;
+            }
         }
 
-        // Update average write time in prometheus
-        write_time.add_sample(elapsed);
-        write_time_metric.set(write_time.average());
+        // Hand the frame to the disk's I/O thread
+        auto& queue = disks[disk]->queue;
+        queue.push_back({frame, current_frame_id, file_bundle, time, freq_id,
+                         freq_ind - acq.chunk_start[chunk]});
+        disk_queue_length_metric.labels({disks[disk]->root_path}).set(queue.size());
+        disks[disk]->cond.notify_one();
+        frame_on_disk_queue[current_frame_id] = true;
+        frame_queued = true;
+
+        acq.last_update = current_time();
     }
 }
 
@@ -16,12 +16,18 @@
 #include "visFile.hpp"           // for visFileBundle
 #include "visUtil.hpp"           // for movingAverage, time_ctype
 
-#include <cstdint> // for uint32_t, int64_t
-#include <map>     // for map
-#include <memory>  // for shared_ptr, unique_ptr
-#include <set>     // for set
-#include <stdio.h> // for size_t
-#include <string>  // for string
+#include <condition_variable> // for condition_variable
+#include <cstdint>            // for uint32_t, int64_t
+#include <deque>              // for deque
+#include <map>                // for map
+#include <memory>             // for shared_ptr, unique_ptr
+#include <mutex>              // for mutex
+#include <set>                // for set
+#include <stdio.h>            // for size_t
+#include <string>             // for string
+#include <thread>             // for thread
+#include <utility>            // for pair
+#include <vector>             // for vector
 
 /**
  * @class BaseWriter
@@ -31,7 +37,9 @@
  *
  * make_metadata(dset_id_t ds_id);
  * get_dataset_state(dset_id_t ds_id);
- * write_data(const FrameView& frame);
+ * write_data(Buffer* in_buf, int frame_id);
+ *
+ * where `write_data` passes a view of the frame on to `write_frame`.
  *
  * This stage writes out the data it receives with minimal processing.
  * Removing certain fields from the output must be done in a prior
@@ -59,6 +67,24 @@
  * version 3.1.0, or the raw format which can be processed into that format by
  * gossec.
  *
+ * The data can be striped over several disks by giving a list of paths as
+ * `root_path`. Every disk has its own queue of frames and an I/O thread
+ * writing them out, and input frames are released once they are written.
+ * With `stripe: freq` the frequencies are split into one contiguous chunk per
+ * disk, and every chunk goes into its own set of files (a dataset with the
+ * reduced frequency axis is registered for it, and the chunk number appears in
+ * the file names). With `stripe: time` consecutive time samples go to the
+ * disks in turn, and every disk holds files with all frequencies. libhdf5 isn't
+ * thread-safe, so the HDF5 file types create, write and close their files
+ * under a process-wide lock (`hdf5fast` writes the data itself without it),
+ * while the raw types are written fully in parallel.
+ *
+ * A disk is taken out of the rotation when more than `max_disk_backlog` frames
+ * are waiting for it (it is slow, and comes back once it has caught up), when
+ * it has less than `min_free_space` left (it is full), or when creating a file
+ * on it fails. Frequency chunks on a disk that drops out move to the least
+ * busy remaining disk. If no disk is left to write to, kotekan exits.
+ *
  * @par Buffers
  * @buffer in_buf The buffer streaming data to write
  *         @buffer_format VisBuffer structured
@@ -66,7 +92,14 @@
  *
  * @conf   file_type        String. Type of file to write. One of 'hdf5',
  *                          'hdf5fast' or 'raw'.
- * @conf   root_path        String. Location in filesystem to write to.
+ * @conf   root_path        String or list of strings. Location(s) in filesystem
+ *                          to write to.
+ * @conf   stripe           String (default: freq). How to distribute data over
+ *                          several root paths: 'freq' or 'time'.
+ * @conf   max_disk_backlog Int (default: half the input buffer). Number of frames
+ *                          queued for a disk beyond which it is considered slow.
+ * @conf   min_free_space   Double (default 1.0). Free space in GB below which
+ *                          a disk is considered full.
  * @conf   instrument_name  String (default: chime). Name of the instrument
  *                          acquiring data (if ``node_mode`` the hostname is
  *                          used instead)
@@ -92,6 +125,19 @@
  *         The number of frames dropped while attempting to write as they are too late.
  * @metric kotekan_writer_bad_dataset_frame_total
  *         The number of frames dropped as they belong to a bad dataset.
+ * @metric kotekan_writer_disk_write_bytes_total
+ *         The number of bytes written to each disk.
+ * @metric kotekan_writer_disk_write_time_seconds
+ *         The write time per frame on each disk. An exponential moving average
+ *         over ~10 samples.
+ * @metric kotekan_writer_disk_queue_length
+ *         The number of frames waiting to be written to each disk.
+ * @metric kotekan_writer_disk_active
+ *         1 if a disk receives new data, 0 if it was excluded.
+ * @metric kotekan_writer_disk_excluded_total
+ *         The number of times a disk was excluded, by reason (slow, full, failed).
+ * @metric kotekan_writer_disk_dropped_frame_total
+ *         The number of frames dropped as the disk they were queued for failed.
  *
  * @author Richard Shaw and James Willis
  **/
@@ -109,9 +155,10 @@ public:
     };
 
 protected:
-    /// Write frame
-    void write_frame(const FrameView& frame, dset_id_t dataset_id, uint32_t freq_id,
-                     time_ctype time);
+    /// Queue a frame to be written. The view must stay valid until the frame
+    /// has been written, so it is shared with the disk's I/O thread.
+    void write_frame(std::shared_ptr<const FrameView> frame, dset_id_t dataset_id,
+                     uint32_t freq_id, time_ctype time);
 
     /// Hold the internal state of an acquisition (one per dataset ID)
     /// Note that we create an acqState even for invalid datasets that we will
@@ -121,12 +168,28 @@ protected:
         /// Is the acq invalid? Drops data with this dataset ID.
         bool bad_dataset = false;
 
-        /// The current set of files we are writing
-        std::unique_ptr<visFileBundle> file_bundle;
+        /// The current sets of files we are writing, keyed by frequency chunk
+        /// and disk. They are shared with the requests queued for the disks.
+        std::map<std::pair<uint32_t, size_t>, std::shared_ptr<visFileBundle>> file_bundles;
 
         /// Frequency IDs that we are expecting
         std::map<uint32_t, uint32_t> freq_id_map;
 
+        /// First frequency index of each frequency chunk
+        std::vector<uint32_t> chunk_start;
+
+        /// Dataset ID describing the frequencies of each chunk
+        std::vector<dset_id_t> chunk_dataset_id;
+
+        /// Disk each frequency chunk is written to (`stripe: freq`)
+        std::vector<size_t> chunk_disk;
+
+        /// Disk each time sample is written to (`stripe: time`)
+        std::map<time_ctype, size_t> time_disk;
+
+        /// Metadata to write into the files
+        std::map<std::string, std::string> metadata;
+
         // Data size
         int64_t frame_size = -1;
 
@@ -155,6 +218,49 @@ private:
     /// Setup the acquisition
     void init_acq(dset_id_t ds_id);
 
+    /// Split the frequencies of an acquisition into chunks, one per disk
+    void init_chunks(acqState& acq, dset_id_t ds_id);
+
+    /// A frame waiting to be written to a disk
+    struct writeRequest {
+        std::shared_ptr<const FrameView> frame;
+        int frame_id;
+        std::shared_ptr<visFileBundle> file_bundle;
+        time_ctype time;
+        uint32_t freq_id;
+        uint32_t freq_ind;
+    };
+
+    /// Why a disk receives new data or not
+    enum class diskStatus { active, slow, full, failed };
+
+    /// A disk we write to, fed by its own I/O thread
+    struct diskState {
+        std::string root_path;
+        diskStatus status = diskStatus::active;
+        std::deque<writeRequest> queue;
+        std::condition_variable cond;
+        std::thread thread;
+        movingAverage write_time;
+        double next_space_check = 0.0;
+    };
+
+    /// Write out the requests queued for one disk
+    void disk_thread(size_t disk_ind);
+
+    /// Check for slow, full and recovered disks. Needs `disk_lock`.
+    void update_disk_status();
+
+    /// Take a disk out of the rotation. Needs `disk_lock`.
+    void exclude_disk(size_t disk_ind, diskStatus reason);
+
+    /// Pick the disk for a frame, moving frequency chunks off excluded
+    /// disks. Needs `disk_lock`.
+    size_t select_disk(acqState& acq, uint32_t chunk, time_ctype time);
+
+    /// Is there any disk that can be written to? Needs `disk_lock`.
+    bool any_disk_usable() const;
+
     /// Close inactive acquisitions
     void close_old_acqs();
 
@@ -180,8 +286,10 @@ private:
 
 private:
     // Parameters saved from the config files
-    std::string root_path;
     std::string file_type; // Type of the file we are writing
+    bool stripe_time;
+    size_t max_disk_backlog;
+    double min_free_space;
     size_t file_length;
     size_t window;
     bool ignore_version;
@@ -193,12 +301,42 @@ private:
     /// Next sweep
     double next_sweep = 0.0;
 
+    /// The disks, their queues and I/O threads
+    std::vector<std::unique_ptr<diskState>> disks;
+
+    /// Lock for the disk queues and status
+    std::mutex disk_lock;
+
+    /// Tell the I/O threads to exit once their queues are empty
+    bool stop_disks = false;
+
+    /// Which input frames are queued for a disk, and signalled when one is
+    /// released. Needs `disk_lock`.
+    std::vector<bool> frame_on_disk_queue;
+    std::condition_variable frame_released;
+
+    /// Next disk to get a time sample (`stripe: time`)
+    size_t next_disk = 0;
+
+    /// The frame currently passed to `write_data`, and whether it was queued
+    int current_frame_id;
+    bool frame_queued;
+
     /// Keep track of the average write time
     movingAverage write_time;
 
+    /// Translate diskStatus to string description for prometheus
+    static const std::map<diskStatus, std::string> disk_status_map;
+
     kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& late_frame_counter;
     kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& bad_dataset_frame_counter;
     kotekan::prometheus::Gauge& write_time_metric;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& disk_write_bytes_counter;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Gauge>& disk_write_time_metric;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Gauge>& disk_queue_length_metric;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Gauge>& disk_active_metric;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& disk_excluded_counter;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& disk_dropped_frame_counter;
 };
 
 #endif
@@ -224,6 +224,7 @@ void HFBTranspose::create_hdf5_file() {
     file = std::unique_ptr<HFBFileArchive>(
         new HFBFileArchive(filename, metadata, times, freqs, beams, sub_freqs, chunk,
                            kotekan::logLevel(_member_log_level)));
+    file->set_compression_threads(compression_threads);
 }
 
 void HFBTranspose::copy_frame_data(uint32_t freq_index, uint32_t time_index) {
@@ -22,7 +22,7 @@
 #include <exception>    // for exception
 #include <future>       // for async, future
 #include <map>          // for map, map<>::mapped_type
-#include <memory>       // for __shared_ptr_access, shared_ptr
+#include <memory>       // for make_shared, __shared_ptr_access, shared_ptr
 #include <regex>        // for match_results<>::_Base_type
 #include <stdexcept>    // for out_of_range
 #include <string>       // for string, to_string
@@ -105,12 +105,12 @@ void HFBWriter::get_dataset_state(dset_id_t ds_id) {
 
 void HFBWriter::write_data(Buffer* in_buf, int frame_id) {
 
-    auto frame = HFBFrameView(in_buf, frame_id);
+    auto frame = std::make_shared<HFBFrameView>(in_buf, frame_id);
 
     // Get time of the frame
-    auto time = frame.time;
-    uint64_t fpga_seq_start = frame.fpga_seq_start;
+    auto time = frame->time;
+    uint64_t fpga_seq_start = frame->fpga_seq_start;
     time_ctype t = {fpga_seq_start, ts_to_double(time)};
 
-    write_frame(frame, frame.dataset_id, frame.freq_id, t);
+    write_frame(frame, frame->dataset_id, frame->freq_id, t);
 }
@@ -12,35 +12,44 @@
 #include "Telescope.hpp" // for Telescope
 #include "buffer.h"
 #include "bufferContainer.hpp"
-#include "datasetManager.hpp" // for dset_id_t
-#include "datasetState.hpp"   // for freqState, timeState, metadataState
-#include "errors.h"           // for exit_kotekan, CLEAN_EXIT, ReturnCode
-#include "kotekanLogging.hpp" // for INFO, FATAL_ERROR, DEBUG, WARN, ERROR
-#include "metadata.h"         // for metadataContainer
-#include "version.h"          // for get_git_commit_hash
-#include "visUtil.hpp"        // for freq_ctype (ptr only), input_ctype, prod_ctype, rstack_ctype
+#include "datasetManager.hpp"    // for dset_id_t
+#include "datasetState.hpp"      // for freqState, timeState, metadataState
+#include "errors.h"              // for exit_kotekan, CLEAN_EXIT, ReturnCode
+#include "kotekanLogging.hpp"    // for INFO, FATAL_ERROR, DEBUG, WARN, ERROR
+#include "metadata.h"            // for metadataContainer
+#include "prometheusMetrics.hpp" // for Metrics, Counter
+#include "version.h"             // for get_git_commit_hash
+#include "visUtil.hpp"           // for freq_ctype, cfloat, input_ctype, prod_ctype, rstack_...
 
 #include "fmt.hpp"  // for format, fmt
 #include "json.hpp" // for json
 
-#include <cstring>    // for strerror, memcpy
-#include <errno.h>    // for errno
-#include <exception>  // for exception
-#include <fcntl.h>    // for open, posix_fadvise, O_RDONLY, POSIX_FADV_DONTNEED
-#include <fstream>    // for ifstream, ios_base::failure, ios_base, basic_ios, basic_i...
-#include <functional> // for _Bind_helper<>::type, bind, function
-#include <map>        // for map
-#include <regex>      // for match_results<>::_Base_type
-#include <stddef.h>   // for size_t
-#include <stdexcept>  // for runtime_error, invalid_argument, out_of_range
-#include <stdint.h>   // for uint32_t, uint8_t
-#include <string>     // for string
-#include <sys/mman.h> // for madvise, mmap, munmap, MADV_DONTNEED, MADV_WILLNEED, MAP_...
-#include <sys/stat.h> // for stat
-#include <time.h>     // for nanosleep, timespec
-#include <unistd.h>   // for close, off_t
-#include <utility>    // for pair
-#include <vector>     // for vector
+#include <algorithm>          // for sort, min
+#include <condition_variable> // for condition_variable
+#include <cstring>            // for strerror, memcpy
+#include <deque>              // for deque
+#include <errno.h>            // for errno
+#include <exception>          // for exception
+#include <fcntl.h>            // for open, posix_fadvise, O_RDONLY, POSIX_FADV_DONTNEED
+#include <fstream>            // for ifstream, ios_base::failure, ios_base, basic_ios, basic_i...
+#include <functional>         // for _Bind_helper<>::type, bind, function
+#include <map>                // for map
+#include <mutex>              // for mutex, unique_lock, lock_guard
+#include <pthread.h>          // for pthread_setaffinity_np
+#include <regex>              // for match_results<>::_Base_type
+#include <sched.h>            // for cpu_set_t, CPU_SET, CPU_ZERO
+#include <stddef.h>           // for size_t
+#include <stdexcept>          // for runtime_error, invalid_argument, out_of_range
+#include <stdint.h>           // for uint32_t, uint8_t
+#include <string>             // for string
+#include <sys/mman.h>         // for madvise, mmap, munmap, MADV_DONTNEED, MADV_WILLNEED, MAP_...
+#include <sys/stat.h>         // for stat
+#include <sys/uio.h>          // for preadv, iovec
+#include <thread>             // for thread
+#include <time.h>             // for nanosleep, timespec
+#include <unistd.h>           // for close, off_t
+#include <utility>            // for pair
+#include <vector>             // for vector
 
 using kotekan::bufferContainer;
 using kotekan::Config;
@@ -68,6 +77,20 @@ using nlohmann::json;
  * is to enable compression and try to optimise for certain IO patterns
  * (i.e. read a few frequencies for many times).
  *
+ * Several files of the same acquisition (e.g. one per time chunk, or one per
+ * group of frequencies) can be replayed as one by giving a list of files in
+ * `infile`. Their time axes are merged in time order and their frequencies are
+ * ordered by ID (a single file keeps the frequency order it has on disk), and
+ * the frames are streamed out in the chunked order of the merged axes, as for a
+ * single file. Any (time, freq) sample that is in none of the files is sent out as an
+ * empty frame. In `pread` mode every file gets its own reader thread, reading
+ * straight into the output buffer frames, so the memory used is bounded by the
+ * output buffer. In the `mmap` and `zero_copy` modes the stage's own thread
+ * copies the frames of all the files one after the other, so the rate of a
+ * merge is that of a single file; use `pread` to read the files in parallel.
+ * The files must only differ in their time and frequency axes, all their other
+ * axes (e.g. the products or inputs) must be the same.
+ *
  * @par Buffers
  * @buffer out_buf The data read from the raw file.
  *         @buffer_format Buffer structured
@@ -75,12 +98,27 @@ using nlohmann::json;
  *
  * @conf    readahead_blocks       Int. Number of blocks to advise OS to read ahead
  *                                 of current read.
+ * @conf    read_mode              String. How frames get from the file into the buffer.
+ *                                 "mmap" (default) copies them out of a memory map of
+ *                                 the file. "zero_copy" points the buffer frames
+ *                                 directly into a private (copy-on-write) map of
+ *                                 the file, so consumers modifying the frame
+ *                                 data don't touch the file. The frame data must
+ *                                 be aligned for its type in the file, which it
+ *                                 isn't in vis and HFB files (it follows a flag
+ *                                 byte and the metadata), so they are rejected.
+ *                                 "pread" doesn't map the file and reads each frame
+ *                                 straight into the frame and its metadata with
+ *                                 `preadv`, which is better suited to file systems
+ *                                 that handle memory maps poorly.
  * @conf    chunk_size             Array of [int, int, int]. Read chunk size (freq,
  *                                 prod, time). If not specified will read file
  *                                 contiguously.
- * @conf    infile                 String. Path to the (data-meta-pair of) files to
- *                                 read (e.g. "/path/to/0000_000", without .data or
- *                                 .meta).
+ * @conf    infile                 String or list of strings. Path to the
+ *                                 (data-meta-pair of) files to read (e.g.
+ *                                 "/path/to/0000_000", without .data or .meta).
+ * @conf    cpu_affinity           List of ints. Cores to run the reader threads on
+ *                                 in `pread` mode. Default is the stage's cores.
  * @conf    max_read_rate          Float. Maximum read rate for the process in MB/s.
  *                                 If the value is zero (default), then no rate
  *                                 limiting is applied.
@@ -96,6 +134,10 @@ using nlohmann::json;
  *                                 testing or if original dataset IDs can be lost.
  *                                 Default is False.
  *
+ * @par Metrics
+ * @metric kotekan_rawreader_read_bytes_total
+ *         The total number of bytes of frame data read from the file.
+ *
  * @author Richard Shaw, Tristan Pinsonneault-Marotte, Rick Nitsche, James Willis
  */
 template<typename T>
@@ -136,7 +178,7 @@ protected:
     // Dataset states constructed from metadata
     std::vector<state_id_t> states;
 
-    // The input file
+    // The input file (the first one, if there are several)
     std::string filename;
 
     // Metadata size
@@ -190,10 +232,54 @@ private:
      * or not.
      *
      * @param ind The frame index.
-     * @returns The frame index into the file.
+     * @returns The frame index into the (merged) time-frequency grid.
      **/
     int position_map(int ind);
 
+    /**
+     * @brief Drop a frame we are done with from the page cache.
+     *
+     * @param grid_ind The frame index into the time-frequency grid.
+     **/
+    void release_file_frame(size_t grid_ind);
+
+    /**
+     * @brief Give a buffer frame back its own memory if it points into the file.
+     *
+     * @param frame_id The buffer frame.
+     **/
+    void restore_internal_frame(int frame_id);
+
+    /**
+     * @brief Read and parse the metadata file of a data file.
+     *
+     * @param name The file path without extension.
+     * @returns    The metadata.
+     **/
+    json read_metadata_file(const std::string& name);
+
+    /**
+     * @brief Read the frames of one file queued by the main thread (`pread` mode).
+     *
+     * @param file Index of the file.
+     **/
+    void reader_thread(size_t file);
+
+    /**
+     * @brief Wait for the read of the oldest frame in flight and send it on.
+     *
+     * @returns false if the read failed.
+     **/
+    bool finish_frame();
+
+    /**
+     * @brief Send on the oldest frames in flight whose reads are done, in order,
+     *        without waiting for any still being read (`pread` mode).
+     *
+     * @returns false if a read failed.
+     **/
+    bool finish_done_frames();
+
     // The metadata
     nlohmann::json _metadata;
     std::vector<time_ctype> _times;
@@ -215,15 +301,59 @@ private:
     // Number of elements in a chunked row
     size_t row_size;
 
-    // the input file
-    int fd;
-    uint8_t* mapped_file;
+    // An input data file
+    struct RawFile {
+        std::string name;
+        int fd = -1;
+        uint8_t* mapped = nullptr;
+        size_t mapped_size = 0;
+        size_t nframe = 0;
+    };
+    std::vector<RawFile> files;
+
+    // Which file (-1 if none) and which frame in that file holds each sample of
+    // the merged time-frequency grid
+    std::vector<std::pair<int, size_t>> grid;
 
     size_t file_frame_size, data_size, nfreq, ntime;
 
     // Number of blocks to read ahead while reading from disk
     size_t readahead_blocks;
 
+    // How to read the file
+    enum class ReadMode { mmap, zero_copy, pread } read_mode;
+
+    // The alignment the frame data needs to be used straight from the file, the
+    // frame views access it as floats and complex floats
+    static constexpr size_t data_align = alignof(cfloat);
+
+    // The memory allocated for each buffer frame, while in zero copy mode the
+    // buffer frame might be pointing into the file instead
+    std::vector<uint8_t*> internal_frames;
+
+    // The grid sample each buffer frame is pointing at in the file (-1 if none)
+    std::vector<int64_t> exposed_grid_ind;
+
+    // A buffer frame being filled by one of the reader threads
+    struct ReadRequest {
+        size_t grid_ind;
+        uint8_t* frame;
+        uint8_t* metadata;
+        bool valid;
+        bool done;
+        ssize_t nread;
+    };
+    std::vector<ReadRequest> requests;
+
+    // Buffer frames queued for each reader thread, and the frames in flight
+    // in the order they have to be sent on
+    std::vector<std::deque<int>> read_queue;
+    std::deque<frameID> in_flight;
+    bool stop_readers = false;
+    std::mutex read_lock;
+    std::condition_variable read_cv;
+    std::condition_variable done_cv;
+
     // the dataset state for the time axis
     state_id_t tstate_id;
 
@@ -235,6 +365,10 @@ private:
 
     // Sleep time after reading
     double sleep_time;
+
+    // Bytes of frame data sent out
+    size_t bytes_read = 0;
+    kotekan::prometheus::Counter* read_bytes_metric = nullptr;
 };
 
 template<typename T>
@@ -242,8 +376,26 @@ RawReader<T>::RawReader(Config& config, const std::string& unique_name,
                         bufferContainer& buffer_container) :
     Stage(config, unique_name, buffer_container, std::bind(&RawReader::main_thread, this)) {
 
-    filename = config.get<std::string>(unique_name, "infile");
+    std::vector<std::string> filenames;
+    if (config.get_value(unique_name, "infile").is_array())
+        filenames = config.get<std::vector<std::string>>(unique_name, "infile");
+    else
+        filenames.push_back(config.get<std::string>(unique_name, "infile"));
+    if (filenames.empty())
+        throw std::invalid_argument("RawReader: config: No files given in infile.");
+    filename = filenames[0];
+
     readahead_blocks = config.get<size_t>(unique_name, "readahead_blocks");
+    std::string mode = config.get_default<std::string>(unique_name, "read_mode", "mmap");
+    if (mode == "mmap")
+        read_mode = ReadMode::mmap;
+    else if (mode == "zero_copy")
+        read_mode = ReadMode::zero_copy;
+    else if (mode == "pread")
+        read_mode = ReadMode::pread;
+    else
+        throw std::invalid_argument(
+            fmt::format(fmt("RawReader: config: Unknown read_mode \"{:s}\"."), mode));
     max_read_rate = config.get_default<double>(unique_name, "max_read_rate", 0.0);
     sleep_time = config.get_default<float>(unique_name, "sleep_time", -1);
     update_dataset_id = config.get_default<bool>(unique_name, "update_dataset_id", true);
@@ -276,29 +428,10 @@ RawReader<T>::RawReader(Config& config, const std::string& unique_name,
     register_producer(out_buf, unique_name.c_str());
 
     // Read the metadata
-    std::string md_filename = (filename + ".meta");
-    INFO("Reading metadata file: {:s}", md_filename);
-    struct stat st;
-    if (stat(md_filename.c_str(), &st) == -1)
-        throw std::ios_base::failure(
-            fmt::format(fmt("RawReader: Error reading from metadata file: {:s}"), md_filename));
-    size_t filesize = st.st_size;
-    std::vector<uint8_t> packed_json(filesize);
-
-    std::ifstream metadata_file(md_filename, std::ios::binary);
-    if (metadata_file) // only read if no error
-        metadata_file.read((char*)&packed_json[0], filesize);
-    if (!metadata_file) // check if open and read successful
-        throw std::ios_base::failure("RawReader: Error reading from "
-                                     "metadata file: "
-                                     + md_filename);
-    metadata_json = json::from_msgpack(packed_json);
-    metadata_file.close();
+    metadata_json = read_metadata_file(filename);
 
     // Extract the attributes and index maps
     _metadata = metadata_json["attributes"];
-    _times = metadata_json["index_map"]["time"].template get<std::vector<time_ctype>>();
-    auto freqs = metadata_json["index_map"]["freq"].template get<std::vector<freq_ctype>>();
 
     // Match frequencies to IDs in the Telescope...
     auto& tel = Telescope::instance();
@@ -310,22 +443,6 @@ RawReader<T>::RawReader(Config& config, const std::string& unique_name,
         inv_freq_map[tel.to_freq(id)] = id;
     }
 
-    // ... then use this to match the central frequencies given in the file
-    for (auto f : freqs) {
-
-        auto it = inv_freq_map.find(f.centre);
-
-        if (it == inv_freq_map.end()) {
-            FATAL_ERROR("Could not match a frequency ID to channel in file at {} MHz. "
-                        "Check you are specifying the correct telescope.",
-                        f.centre);
-            return;
-        }
-
-        DEBUG("restored freq_id for f_centre={:.2f} : {:d}", f.centre, it->second);
-        _freqs.push_back({it->second, f});
-    }
-
     // check git version tag
     // TODO: enforce that they match if build type == "release"?
     if (_metadata.at("git_version_tag").template get<std::string>()
@@ -339,11 +456,108 @@ RawReader<T>::RawReader(Config& config, const std::string& unique_name,
     file_frame_size = metadata_json["structure"]["frame_size"].template get<size_t>();
     metadata_size = metadata_json["structure"]["metadata_size"].template get<size_t>();
     data_size = metadata_json["structure"]["data_size"].template get<size_t>();
-    nfreq = metadata_json["structure"]["nfreq"].template get<size_t>();
-    ntime = metadata_json["structure"]["ntime"].template get<size_t>();
 
-    DEBUG("Metadata fields. frame_size: {}, metadata_size: {}, data_size: {}, nfreq: {}, ntime: {}",
-          file_frame_size, metadata_size, data_size, nfreq, ntime);
+    // The file maps are page aligned, so the frame data of every frame in the
+    // file must be aligned for the consumers to use it in place
+    if (read_mode == ReadMode::zero_copy
+        && ((metadata_size + 1) % data_align != 0 || file_frame_size % data_align != 0))
+        throw std::invalid_argument(
+            fmt::format(fmt("RawReader: config: The frame data in file {:s} isn't aligned to "
+                            "{:d} bytes, read_mode \"zero_copy\" can't be used for it."),
+                        filename, data_align));
+
+    // Merge the time and frequency axes of all files. The frames in each file
+    // are ordered with time as the slowest index.
+    std::map<time_ctype, size_t> time_pos;
+    std::map<uint32_t, size_t> freq_pos;
+    std::vector<std::vector<time_ctype>> file_times;
+    std::vector<std::vector<uint32_t>> file_freq_ids;
+    json axes = metadata_json["index_map"];
+    axes.erase("time");
+    axes.erase("freq");
+    for (auto& name : filenames) {
+        json file_json = (name == filename) ? metadata_json : read_metadata_file(name);
+
+        if (file_json["structure"]["frame_size"].template get<size_t>() != file_frame_size
+            || file_json["structure"]["metadata_size"].template get<size_t>() != metadata_size
+            || file_json["structure"]["data_size"].template get<size_t>() != data_size)
+            throw std::runtime_error(
+                fmt::format(fmt("RawReader: File {:s} has a different frame structure than {:s}."),
+                            name, filename));
+
+        // Only the time and frequency axes are merged, the others must all match
+        json file_axes = file_json["index_map"];
+        file_axes.erase("time");
+        file_axes.erase("freq");
+        if (file_axes != axes)
+            throw std::runtime_error(
+                fmt::format(fmt("RawReader: File {:s} has different axes than {:s}."), name,
+                            filename));
+
+        file_times.push_back(
+            file_json["index_map"]["time"].template get<std::vector<time_ctype>>());
+        for (auto& t : file_times.back())
+            time_pos[t] = 0;
+
+        // ... then use this to match the central frequencies given in the file
+        file_freq_ids.emplace_back();
+        for (auto f : file_json["index_map"]["freq"].template get<std::vector<freq_ctype>>()) {
+
+            auto it = inv_freq_map.find(f.centre);
+
+            if (it == inv_freq_map.end()) {
+                FATAL_ERROR("Could not match a frequency ID to channel in file at {} MHz. "
+                            "Check you are specifying the correct telescope.",
+                            f.centre);
+                return;
+            }
+
+            DEBUG("restored freq_id for f_centre={:.2f} : {:d}", f.centre, it->second);
+            if (freq_pos.emplace(it->second, _freqs.size()).second)
+                _freqs.push_back({it->second, f});
+            file_freq_ids.back().push_back(it->second);
+        }
+
+        RawFile file;
+        file.name = name;
+        file.nframe = file_times.back().size() * file_freq_ids.back().size();
+        files.push_back(file);
+    }
+
+    for (auto& [t, pos] : time_pos) {
+        pos = _times.size();
+        _times.push_back(t);
+    }
+    if (files.size() > 1) {
+        // Order frequencies by ID, as they might be spread over the files
+        std::sort(_freqs.begin(), _freqs.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (size_t i = 0; i < _freqs.size(); i++)
+            freq_pos[_freqs[i].first] = i;
+    }
+    ntime = _times.size();
+    nfreq = _freqs.size();
+
+    grid.assign(ntime * nfreq, {-1, 0});
+    for (size_t f = 0; f < files.size(); f++) {
+        size_t file_nfreq = file_freq_ids[f].size();
+        for (size_t ti = 0; ti < file_times[f].size(); ti++) {
+            for (size_t fi = 0; fi < file_nfreq; fi++) {
+                size_t ind =
+                    time_pos.at(file_times[f][ti]) * nfreq + freq_pos.at(file_freq_ids[f][fi]);
+                if (grid[ind].first >= 0)
+                    throw std::runtime_error(fmt::format(
+                        fmt("RawReader: Files {:s} and {:s} both contain the same time "
+                            "and frequency."),
+                        files[grid[ind].first].name, files[f].name));
+                grid[ind] = {(int)f, ti * file_nfreq + fi};
+            }
+        }
+    }
+
+    DEBUG("Metadata fields. frame_size: {}, metadata_size: {}, data_size: {}, nfreq: {}, ntime: "
+          "{}, files: {}",
+          file_frame_size, metadata_size, data_size, nfreq, ntime, files.size());
 
     if (chunked) {
         // Special case if dimensions less than chunk size
@@ -381,27 +595,87 @@ RawReader<T>::RawReader(Config& config, const std::string& unique_name,
         }
     }
 
-    // Open up the data file and mmap it
-    INFO("Opening data file: {:s}.data", filename);
-    if ((fd = open((filename + ".data").c_str(), O_RDONLY)) == -1) {
-        throw std::runtime_error(
-            fmt::format(fmt("Failed to open file {:s}.data: {:s}."), filename, strerror(errno)));
+    // Open up the data files and mmap them
+    for (auto& file : files) {
+        INFO("Opening data file: {:s}.data", file.name);
+        if ((file.fd = open((file.name + ".data").c_str(), O_RDONLY)) == -1) {
+            throw std::runtime_error(fmt::format(fmt("Failed to open file {:s}.data: {:s}."),
+                                                 file.name, strerror(errno)));
+        }
+        if (read_mode == ReadMode::pread)
+            continue;
+
+        size_t file_size = file.nframe * file_frame_size;
+        file.mapped_size = file_size;
+        void* addr = nullptr;
+        int prot = PROT_READ;
+        int flags = MAP_SHARED;
+        if (read_mode == ReadMode::zero_copy) {
+            // Consumers may look at a whole buffer frame starting at the data of the
+            // last frame in the file. Reserve (zeroed) address space past the end of
+            // the file and map the file over its start, so that can't fault.
+            file.mapped_size += out_buf->frame_size;
+            // The buffer frames are writable, so the map is too, but private so
+            // nothing gets written back to the file
+            prot |= PROT_WRITE;
+            addr = mmap(nullptr, file.mapped_size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr == MAP_FAILED)
+                throw std::runtime_error(fmt::format(
+                    fmt("Failed to reserve memory to map file {:s}.data: {:s}."), file.name,
+                    strerror(errno)));
+            flags = MAP_PRIVATE | MAP_FIXED;
+        }
+        file.mapped = (uint8_t*)mmap(addr, file_size, prot, flags, file.fd, 0);
+        if (file.mapped == MAP_FAILED)
+            throw std::runtime_error(
+                fmt::format(fmt("Failed to map file {:s}.data to memory: {:s}."), file.name,
+                            strerror(errno)));
     }
-    mapped_file =
-        (uint8_t*)mmap(nullptr, ntime * nfreq * file_frame_size, PROT_READ, MAP_SHARED, fd, 0);
-    if (mapped_file == MAP_FAILED)
-        throw std::runtime_error(fmt::format(fmt("Failed to map file {:s}.data to memory: {:s}."),
-                                             filename, strerror(errno)));
+
+    internal_frames.assign(out_buf->frames, out_buf->frames + out_buf->num_frames);
+    exposed_grid_ind.assign(out_buf->num_frames, -1);
+    requests.resize(out_buf->num_frames);
+    read_queue.resize(files.size());
 }
 
 template<typename T>
 RawReader<T>::~RawReader() {
-    if (munmap(mapped_file, ntime * nfreq * file_frame_size) == -1) {
-        // Make sure kotekan is exiting...
-        FATAL_ERROR("Failed to unmap file {:s}.data: {:s}.", filename, strerror(errno));
+    // The buffer must only ever free the frames it allocated itself
+    for (int i = 0; i < (int)internal_frames.size(); i++)
+        restore_internal_frame(i);
+
+    for (auto& file : files) {
+        if (file.mapped != nullptr && munmap(file.mapped, file.mapped_size) == -1) {
+            // Make sure kotekan is exiting...
+            FATAL_ERROR("Failed to unmap file {:s}.data: {:s}.", file.name, strerror(errno));
+        }
+
+        if (file.fd >= 0)
+            close(file.fd);
     }
+}
 
-    close(fd);
+template<typename T>
+json RawReader<T>::read_metadata_file(const std::string& name) {
+    std::string md_filename = (name + ".meta");
+    INFO("Reading metadata file: {:s}", md_filename);
+    struct stat st;
+    if (stat(md_filename.c_str(), &st) == -1)
+        throw std::ios_base::failure(
+            fmt::format(fmt("RawReader: Error reading from metadata file: {:s}"), md_filename));
+    size_t filesize = st.st_size;
+    std::vector<uint8_t> packed_json(filesize);
+
+    std::ifstream metadata_file(md_filename, std::ios::binary);
+    if (metadata_file) // only read if no error
+        metadata_file.read((char*)&packed_json[0], filesize);
+    if (!metadata_file) // check if open and read successful
+        throw std::ios_base::failure("RawReader: Error reading from "
+                                     "metadata file: "
+                                     + md_filename);
+    metadata_file.close();
+
+    return json::from_msgpack(packed_json);
 }
 
 template<typename T>
@@ -411,7 +685,7 @@ void RawReader<T>::main_thread() {
     frameID frame_id(out_buf);
     uint8_t* frame;
 
-    size_t ind = 0, read_ind = 0, file_ind;
+    size_t ind = 0, read_ind = 0, grid_ind;
 
     size_t nframe = nfreq * ntime;
 
@@ -421,6 +695,26 @@ void RawReader<T>::main_thread() {
         (max_read_rate > 0 ? file_frame_size / (max_read_rate * 1024 * 1024) : 0.0);
     DEBUG("Minimum read time per frame {}s", min_read_time);
 
+    read_bytes_metric = &kotekan::prometheus::Metrics::instance().add_counter(
+        "kotekan_rawreader_read_bytes_total", unique_name);
+    double replay_start = current_time();
+
+    // Start a reader thread for every file
+    std::vector<std::thread> reader_threads;
+    if (read_mode == ReadMode::pread) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        for (auto& i : config.get_default<std::vector<int>>(unique_name, "cpu_affinity", {}))
+            CPU_SET(i, &cpuset);
+
+        for (size_t f = 0; f < files.size(); f++) {
+            reader_threads.emplace_back(&RawReader<T>::reader_thread, this, f);
+            if (CPU_COUNT(&cpuset) > 0)
+                pthread_setaffinity_np(reader_threads.back().native_handle(), sizeof(cpu_set_t),
+                                       &cpuset);
+        }
+    }
+
     readahead_blocks = std::min(nframe, readahead_blocks);
     // Initial readahead for frames
     for (read_ind = 0; read_ind < readahead_blocks; read_ind++) {
@@ -432,6 +726,10 @@ void RawReader<T>::main_thread() {
         // Get the start time of the loop for rate limiting
         start_time = current_time();
 
+        // With every buffer frame waiting for a read, send the oldest on first
+        if (in_flight.size() == (size_t)out_buf->num_frames && !finish_frame())
+            break;
+
         // Wait for an empty frame in the output buffer
         if ((frame = wait_for_empty_frame(out_buf, unique_name.c_str(), frame_id)) == nullptr) {
             break;
@@ -442,45 +740,58 @@ void RawReader<T>::main_thread() {
             read_ahead(read_ind);
         }
 
+        // All consumers are done with the file frame this buffer frame was
+        // pointing at, so it can go from memory now
+        if (read_mode == ReadMode::zero_copy && exposed_grid_ind[frame_id] >= 0) {
+            release_file_frame(exposed_grid_ind[frame_id]);
+            exposed_grid_ind[frame_id] = -1;
+        }
+
         // Get the index into the file
-        file_ind = position_map(ind);
+        grid_ind = position_map(ind);
+        int file = grid[grid_ind].first;
+        size_t file_ind = grid[grid_ind].second;
 
         // Allocate the metadata space
         allocate_new_metadata_object(out_buf, frame_id);
-
-        // Check first byte indicating empty frame
-        if (*(mapped_file + file_ind * file_frame_size) != 0) {
-            // Copy the metadata from the file
-            std::memcpy(out_buf->metadata[frame_id]->metadata,
-                        mapped_file + file_ind * file_frame_size + 1, metadata_size);
-
-            // Copy the data from the file
-            std::memcpy(frame, mapped_file + file_ind * file_frame_size + metadata_size + 1,
-                        data_size);
-        } else {
-            // Create empty frame and set structural metadata
-            create_empty_frame(frame_id);
+        uint8_t* metadata = (uint8_t*)out_buf->metadata[frame_id]->metadata;
+
+        ReadRequest& req = requests[frame_id];
+        req = {grid_ind, frame, metadata, false, file < 0, 0};
+
+        if (file >= 0 && read_mode == ReadMode::pread) {
+            // Hand the frame to the thread reading that file
+            std::lock_guard<std::mutex> lock(read_lock);
+            read_queue[file].push_back(frame_id);
+            read_cv.notify_all();
+        } else if (file >= 0) {
+            uint8_t* file_frame = files[file].mapped + file_ind * file_frame_size;
+
+            // Check first byte indicating empty frame
+            req.valid = (*file_frame != 0);
+            if (req.valid) {
+                // Copy the metadata from the file
+                std::memcpy(metadata, file_frame + 1, metadata_size);
+
+                if (read_mode == ReadMode::zero_copy) {
+                    // Point the buffer frame at the data in the file
+                    swap_external_frame(out_buf, frame_id, file_frame + metadata_size + 1);
+                    exposed_grid_ind[frame_id] = grid_ind;
+                } else {
+                    // Copy the data from the file
+                    std::memcpy(frame, file_frame + metadata_size + 1, data_size);
+                }
+            }
+            req.done = true;
         }
+        in_flight.push_back(frame_id);
+        frame_id++;
 
-        // Set the dataset ID to the updated value
-        auto frame = T(out_buf, frame_id);
-        dset_id_t& ds_id = frame.dataset_id;
-        ds_id = get_dataset_state(ds_id);
-
-        // Try and clear out the cached data from the memory map as we don't need it again
-        if (madvise(mapped_file + file_ind * file_frame_size, file_frame_size, MADV_DONTNEED) == -1)
-            WARN("madvise failed: {:s}", strerror(errno));
-#ifdef __linux__
-        // Try and clear out the cached data from the page cache as we don't need it again
-        // NOTE: unless we do this in addition to the above madvise the kernel will try and keep as
-        // much of the file in the page cache as possible and it will fill all the available memory
-        if (posix_fadvise(fd, file_ind * file_frame_size, file_frame_size, POSIX_FADV_DONTNEED)
-            == -1)
-            WARN("fadvise failed: {:s}", strerror(errno));
-#endif
+        // Unless the reader threads are doing the work, send the frame on right away,
+        // otherwise send on whatever they are done with
+        if (read_mode != ReadMode::pread ? !finish_frame() : !finish_done_frames())
+            break;
 
-        // Release the frame and advance all the counters
-        mark_frame_full(out_buf, unique_name.c_str(), frame_id++);
         read_ind++;
         ind++;
 
@@ -495,6 +806,22 @@ void RawReader<T>::main_thread() {
         }
     }
 
+    // Send on what's still being read
+    while (!stop_thread && !in_flight.empty() && finish_frame())
+        ;
+
+    {
+        std::lock_guard<std::mutex> lock(read_lock);
+        stop_readers = true;
+        read_cv.notify_all();
+    }
+    for (auto& t : reader_threads)
+        t.join();
+
+    double replay_time = current_time() - replay_start;
+    INFO("Replayed {:d} frames ({:.3f} GB) in {:.2f} s: {:.3f} GB/s.", ind, bytes_read / 1e9,
+         replay_time, replay_time > 0 ? bytes_read / 1e9 / replay_time : 0.0);
+
     if (sleep_time > 0) {
         INFO("Read all data. Sleeping and then exiting kotekan...");
         timespec ts = double_to_ts(sleep_time);
@@ -505,6 +832,91 @@ void RawReader<T>::main_thread() {
     }
 }
 
+template<typename T>
+bool RawReader<T>::finish_frame() {
+
+    frameID id = in_flight.front();
+    ReadRequest& req = requests[id];
+    {
+        std::unique_lock<std::mutex> lock(read_lock);
+        done_cv.wait(lock, [&]() { return req.done; });
+    }
+    in_flight.pop_front();
+
+    auto [file, file_ind] = grid[req.grid_ind];
+    if (read_mode == ReadMode::pread && file >= 0
+        && req.nread != (ssize_t)(1 + metadata_size + data_size)) {
+        FATAL_ERROR("Failed to read frame {:d} from file {:s}.data: {:s}", file_ind,
+                    files[file].name, req.nread < 0 ? strerror((int)-req.nread) : "short read");
+        return false;
+    }
+
+    if (!req.valid) {
+        // Create empty frame and set structural metadata
+        restore_internal_frame(id);
+        create_empty_frame(id);
+    }
+
+    // Set the dataset ID to the updated value
+    auto frame = T(out_buf, id);
+    dset_id_t& ds_id = frame.dataset_id;
+    ds_id = get_dataset_state(ds_id);
+
+    // Unless the consumers are still going to read it from the file, we are
+    // done with this frame
+    if (file >= 0 && exposed_grid_ind[id] < 0)
+        release_file_frame(req.grid_ind);
+
+    bytes_read += data_size;
+    read_bytes_metric->inc(data_size);
+
+    // Release the frame
+    mark_frame_full(out_buf, unique_name.c_str(), id);
+    return true;
+}
+
+template<typename T>
+bool RawReader<T>::finish_done_frames() {
+
+    while (!in_flight.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(read_lock);
+            if (!requests[in_flight.front()].done)
+                return true;
+        }
+        if (!finish_frame())
+            return false;
+    }
+    return true;
+}
+
+template<typename T>
+void RawReader<T>::reader_thread(size_t file) {
+
+    std::unique_lock<std::mutex> lock(read_lock);
+    while (true) {
+        read_cv.wait(lock, [&]() { return stop_readers || !read_queue[file].empty(); });
+        if (read_queue[file].empty())
+            return;
+
+        ReadRequest& req = requests[read_queue[file].front()];
+        read_queue[file].pop_front();
+        lock.unlock();
+
+        // Read the empty frame flag, metadata and data straight into place
+        uint8_t flag = 0;
+        struct iovec iov[3] = {{&flag, 1}, {req.metadata, metadata_size}, {req.frame, data_size}};
+        ssize_t nread =
+            preadv(files[file].fd, iov, 3, grid[req.grid_ind].second * file_frame_size);
+
+        lock.lock();
+        req.nread = (nread < 0) ? -errno : nread;
+        req.valid = (flag != 0);
+        req.done = true;
+        done_cv.notify_all();
+    }
+}
+
 template<typename T>
 dset_id_t RawReader<T>::get_dataset_state(dset_id_t ds_id) {
 
@@ -538,12 +950,52 @@ dset_id_t RawReader<T>::get_dataset_state(dset_id_t ds_id) {
 template<typename T>
 void RawReader<T>::read_ahead(int ind) {
 
-    off_t offset = position_map(ind) * file_frame_size;
+    auto [file, file_ind] = grid[position_map(ind)];
+    if (file < 0)
+        return;
+
+    off_t offset = file_ind * file_frame_size;
 
-    if (madvise(mapped_file + offset, file_frame_size, MADV_WILLNEED) == -1)
+    if (read_mode == ReadMode::pread) {
+#ifdef __linux__
+        if (posix_fadvise(files[file].fd, offset, file_frame_size, POSIX_FADV_WILLNEED) == -1)
+            DEBUG("fadvise failed: {:s}", strerror(errno));
+#endif
+        return;
+    }
+
+    if (madvise(files[file].mapped + offset, file_frame_size, MADV_WILLNEED) == -1)
         DEBUG("madvise failed: {:s}", strerror(errno));
 }
 
+template<typename T>
+void RawReader<T>::release_file_frame(size_t grid_ind) {
+
+    auto [file, file_ind] = grid[grid_ind];
+    off_t offset = file_ind * file_frame_size;
+
+    // Try and clear out the cached data from the memory map as we don't need it again
+    if (files[file].mapped != nullptr
+        && madvise(files[file].mapped + offset, file_frame_size, MADV_DONTNEED) == -1)
+        WARN("madvise failed: {:s}", strerror(errno));
+#ifdef __linux__
+    // Try and clear out the cached data from the page cache as we don't need it again
+    // NOTE: unless we do this in addition to the above madvise the kernel will try and keep as
+    // much of the file in the page cache as possible and it will fill all the available memory
+    if (posix_fadvise(files[file].fd, offset, file_frame_size, POSIX_FADV_DONTNEED) == -1)
+        WARN("fadvise failed: {:s}", strerror(errno));
+#endif
+}
+
+template<typename T>
+void RawReader<T>::restore_internal_frame(int frame_id) {
+    if (out_buf->frames[frame_id] == internal_frames[frame_id])
+        return;
+
+    swap_external_frame(out_buf, frame_id, internal_frames[frame_id]);
+    exposed_grid_ind[frame_id] = -1;
+}
+
 template<typename T>
 int RawReader<T>::position_map(int ind) {
     if (chunked) {
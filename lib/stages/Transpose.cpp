@@ -49,6 +49,9 @@ Transpose::Transpose(Config& config, const std::string& unique_name,
     timeout =
         std::chrono::duration<float>(config.get_default<float>(unique_name, "comet_timeout", 60.));
 
+    // Number of threads compressing chunks outside of the HDF5 library
+    compression_threads = config.get_default<size_t>(unique_name, "compression_threads", 0);
+
     // Collect some metadata. The rest is requested from the datasetManager,
     // once we received the first frame.
     metadata["notes"] = "";
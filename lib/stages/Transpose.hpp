@@ -63,6 +63,11 @@
  *                              write to (e.g. "/path/to/0000_000", without .h5).
  * @conf   comet_timeout        Float, default 60. Timeout for communications with
  *                              dataset broker.
+ * @conf   compression_threads  Int, default 0. Number of threads compressing chunks
+ *                              which are then written with `H5Dwrite_chunk`. With
+ *                              0 the HDF5 bitshuffle filter compresses the data.
+ *                              Requires kotekan to be built with bitshuffle and
+ *                              HDF5 1.10.3 or later.
  *
  * @par Metrics
  * @metric kotekan_transpose_data_transposed_bytes
@@ -84,6 +89,7 @@ protected:
     // Config values
     std::string filename;
     std::chrono::duration<float> timeout;
+    size_t compression_threads;
 
     // Buffers
     Buffer* in_buf;
@@ -0,0 +1,350 @@
+#include "UdpCapture.hpp"
+
+#include "Config.hpp"         // for Config
+#include "StageFactory.hpp"   // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
+#include "buffer.h"           // for wait_for_empty_frame, mark_frame_full, allocate_new_metada...
+#include "kotekanLogging.hpp" // for DEBUG, INFO, FATAL_ERROR
+#include "util.h"             // for string_tail
+
+#include "fmt.hpp" // for format, fmt
+
+#include <algorithm>    // for max, min
+#include <arpa/inet.h>  // for inet_pton, htons
+#include <errno.h>      // for errno, EAGAIN, EINTR, EWOULDBLOCK
+#include <functional>   // for _Bind_helper<>::type, bind, function
+#include <mutex>        // for lock_guard, unique_lock
+#include <netinet/in.h> // for sockaddr_in, IPPROTO_UDP
+#include <pthread.h>    // for pthread_setname_np
+#include <stdexcept>    // for invalid_argument
+#include <string.h>     // for memcpy, memset, strerror
+#include <sys/socket.h> // for recvmmsg, setsockopt, socket, bind, mmsghdr, SOL_SOCKET
+#include <sys/time.h>   // for timeval
+#include <sys/uio.h>    // for iovec
+#include <thread>       // for thread
+#include <unistd.h>     // for close
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+using kotekan::Stage;
+using kotekan::prometheus::Metrics;
+
+REGISTER_KOTEKAN_STAGE(UdpCapture);
+
+UdpCapture::UdpCapture(Config& config, const std::string& unique_name,
+                       bufferContainer& buffer_container) :
+    Stage(config, unique_name, buffer_container, std::bind(&UdpCapture::main_thread, this)),
+    packets_counter(
+        Metrics::instance().add_counter("kotekan_udpcapture_packets_total", unique_name)),
+    lost_counter(
+        Metrics::instance().add_counter("kotekan_udpcapture_lost_packets_total", unique_name)),
+    dropped_counter(Metrics::instance().add_counter("kotekan_udpcapture_dropped_packets_total",
+                                                    unique_name, {"reason"})),
+    frames_counter(
+        Metrics::instance().add_counter("kotekan_udpcapture_frames_total", unique_name)),
+    skipped_counter(
+        Metrics::instance().add_counter("kotekan_udpcapture_skipped_frames_total", unique_name)) {
+
+    out_buf = get_buffer("out_buf");
+    register_producer(out_buf, unique_name.c_str());
+
+    udp_port = config.get<uint32_t>(unique_name, "udp_port");
+    udp_ip = config.get_default<std::string>(unique_name, "udp_ip", "0.0.0.0");
+    packet_size = config.get<size_t>(unique_name, "udp_packet_size");
+    header_size = config.get_default<size_t>(unique_name, "udp_header_size", 0);
+    seq_num_offset = config.get_default<size_t>(unique_name, "seq_num_offset", 0);
+    seq_num_bytes = config.get_default<size_t>(unique_name, "seq_num_bytes", 8);
+    num_threads = std::max<size_t>(config.get_default<size_t>(unique_name, "num_threads", 1), 1);
+    recv_batch_size =
+        std::max<size_t>(config.get_default<size_t>(unique_name, "recv_batch_size", 64), 1);
+    frame_window = std::max<size_t>(config.get_default<size_t>(unique_name, "frame_window", 2), 1);
+    resync_frames = config.get_default<size_t>(unique_name, "resync_frames", 16);
+    socket_buffer_size =
+        config.get_default<int>(unique_name, "socket_buffer_size", 64 * 1024 * 1024);
+
+    if (seq_num_bytes != 4 && seq_num_bytes != 8)
+        throw std::invalid_argument(
+            fmt::format(fmt("{:s}: seq_num_bytes must be 4 or 8, got {:d}."), unique_name,
+                        seq_num_bytes));
+    if (header_size >= packet_size || seq_num_offset + seq_num_bytes > packet_size)
+        throw std::invalid_argument(
+            fmt::format(fmt("{:s}: udp_header_size ({:d}) or the sequence number don't fit into "
+                            "udp_packet_size ({:d})."),
+                        unique_name, header_size, packet_size));
+    payload_size = packet_size - header_size;
+    packets_per_frame = out_buf->frame_size / payload_size;
+    if (packets_per_frame == 0)
+        throw std::invalid_argument(
+            fmt::format(fmt("{:s}: a frame of {:d} bytes can't hold a packet of {:d} bytes."),
+                        unique_name, out_buf->frame_size, payload_size));
+    // Frames of the window are held until they are full, a frame must be left over for the
+    // consumer.
+    if (frame_window >= (size_t)out_buf->num_frames)
+        throw std::invalid_argument(
+            fmt::format(fmt("{:s}: frame_window ({:d}) must be smaller than the number of frames "
+                            "({:d})."),
+                        unique_name, frame_window, out_buf->num_frames));
+
+    // The slots hold atomics, so they are created in place rather than resized
+    slots = std::vector<FrameSlot>(out_buf->num_frames);
+    for (auto& slot : slots)
+        slot.received.resize(packets_per_frame);
+}
+
+void UdpCapture::main_thread() {
+
+    std::vector<int> fds;
+    for (size_t i = 0; i < num_threads; i++) {
+        int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (fd < 0) {
+            FATAL_ERROR("Could not create UDP socket: {:s}", strerror(errno));
+            return;
+        }
+        fds.push_back(fd);
+
+        int one = 1;
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+            FATAL_ERROR("Could not set SO_REUSEPORT: {:s}", strerror(errno));
+            return;
+        }
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &socket_buffer_size, sizeof(socket_buffer_size))
+            < 0)
+            WARN("Could not set the socket buffer size to {:d}: {:s}", socket_buffer_size,
+                 strerror(errno));
+        // Wake up regularly to check whether the stage is stopping
+        struct timeval tv = {0, 100000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(udp_port);
+        if (inet_pton(AF_INET, udp_ip.c_str(), &addr.sin_addr) != 1) {
+            FATAL_ERROR("Invalid udp_ip {:s}", udp_ip);
+            return;
+        }
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            FATAL_ERROR("Could not bind to {:s}:{:d}: {:s}", udp_ip, udp_port, strerror(errno));
+            return;
+        }
+    }
+    INFO("Receiving {:d} byte packets on {:s}:{:d} with {:d} thread(s), {:d} packets per frame.",
+         packet_size, udp_ip, udp_port, num_threads, packets_per_frame);
+
+    // The receiving threads inherit the CPU affinity of this thread
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; i++) {
+        threads.emplace_back(&UdpCapture::receive_thread, this, fds[i], i);
+        std::string short_name = string_tail(fmt::format(fmt("{:s}/rx{:d}"), unique_name, i), 15);
+        pthread_setname_np(threads.back().native_handle(), short_name.c_str());
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int fd : fds)
+        close(fd);
+}
+
+void UdpCapture::receive_thread(int fd, int thread_id) {
+    std::vector<uint8_t> packets(recv_batch_size * packet_size);
+    std::vector<struct mmsghdr> msgs(recv_batch_size);
+    std::vector<struct iovec> iovs(recv_batch_size);
+    std::vector<Copy> copies;
+    copies.reserve(recv_batch_size);
+
+    for (size_t i = 0; i < recv_batch_size; i++) {
+        iovs[i].iov_base = &packets[i * packet_size];
+        // Larger packets are truncated, and flagged with MSG_TRUNC
+        iovs[i].iov_len = packet_size;
+        memset(&msgs[i], 0, sizeof(struct mmsghdr));
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (!stop_thread) {
+        int n = recvmmsg(fd, msgs.data(), recv_batch_size, MSG_WAITFORONE, nullptr);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                continue;
+            FATAL_ERROR("recvmmsg failed on thread {:d}: {:s}", thread_id, strerror(errno));
+            return;
+        }
+
+        // Find the places of the packets under the lock, and copy them without
+        {
+            std::unique_lock<std::mutex> lock(window_lock);
+            for (int i = 0; i < n; i++) {
+                const uint8_t* packet = &packets[i * packet_size];
+                if (msgs[i].msg_len != packet_size || (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+                    dropped_counter.labels({"size"}).inc();
+                    continue;
+                }
+
+                uint64_t seq_num = 0;
+                memcpy(&seq_num, packet + seq_num_offset, seq_num_bytes);
+
+                uint8_t* dst;
+                FrameSlot* slot = claim(seq_num, &dst, lock, copies);
+                if (slot != nullptr)
+                    copies.push_back({slot, dst, packet + header_size});
+            }
+        }
+        finish_copies(copies);
+    }
+
+    // The first thread to stop passes on what it has, the others find the window empty
+    std::lock_guard<std::mutex> lock(window_lock);
+    while (!window.empty())
+        close_front();
+}
+
+UdpCapture::FrameSlot* UdpCapture::claim(uint64_t seq_num, uint8_t** dst,
+                                         std::unique_lock<std::mutex>& lock,
+                                         std::vector<Copy>& copies) {
+    const int64_t frame_num = seq_num / packets_per_frame;
+    const size_t index = seq_num % packets_per_frame;
+
+    // The window may have moved on while a frame was being opened, so start over after that
+    while (true) {
+        // The frame number the window starts at, or the one it will start at
+        if (next_frame_num < 0)
+            next_frame_num = frame_num;
+        int64_t first_frame_num = window.empty() ? next_frame_num : window.front()->frame_num;
+
+        // The sender restarted its sequence numbers, restart the window with them
+        if (frame_num + (int64_t)resync_frames < first_frame_num) {
+            INFO("Packet {:d} is {:d} frames behind, restarting at frame {:d}.", seq_num,
+                 first_frame_num - frame_num, frame_num);
+            while (!window.empty())
+                close_front();
+            next_frame_num = frame_num;
+            continue;
+        }
+
+        if (frame_num < first_frame_num) {
+            dropped_counter.labels({"late"}).inc();
+            return nullptr;
+        }
+
+        // Move the window forward, passing on the frames that fall out of it
+        while (!window.empty() && frame_num >= window.front()->frame_num + (int64_t)frame_window)
+            close_front();
+
+        // Jump over any frames that no packet arrived for
+        if (window.empty() && frame_num >= next_frame_num + (int64_t)frame_window) {
+            int64_t skipped = frame_num - next_frame_num;
+            DEBUG("Skipping {:d} frames, from frame {:d} to {:d}.", skipped, next_frame_num,
+                  frame_num);
+            skipped_counter.inc(skipped);
+            lost_counter.inc(skipped * packets_per_frame);
+            next_frame_num = frame_num;
+        }
+
+        if (frame_num >= next_frame_num) {
+            if (!open_next_frame(lock, copies))
+                return nullptr;
+            continue;
+        }
+
+        FrameSlot* slot = window[frame_num - window.front()->frame_num];
+        if (slot->closed || slot->received[index]) {
+            dropped_counter.labels({"duplicate"}).inc();
+            return nullptr;
+        }
+
+        slot->received[index] = 1;
+        slot->state.fetch_add(1, std::memory_order_acq_rel);
+        *dst = slot->data + index * payload_size;
+
+        // A complete frame is passed on once the copy is done
+        if (++slot->num_received == packets_per_frame)
+            close_slot(slot);
+        while (!window.empty() && window.front()->closed)
+            window.pop_front();
+
+        return slot;
+    }
+}
+
+bool UdpCapture::open_next_frame(std::unique_lock<std::mutex>& lock, std::vector<Copy>& copies) {
+    // Waiting for the buffer frame could wait on the frames the copies go to
+    if (!copies.empty()) {
+        lock.unlock();
+        finish_copies(copies);
+        lock.lock();
+        return true;
+    }
+
+    // Only one thread waits for the next buffer frame, the others wait for it
+    if (opening) {
+        open_cv.wait(lock);
+        return true;
+    }
+
+    // The other threads keep filling the window while this one waits
+    opening = true;
+    const int frame_id = next_frame_id;
+    lock.unlock();
+    uint8_t* frame = wait_for_empty_frame(out_buf, unique_name.c_str(), frame_id);
+    if (frame != nullptr && out_buf->metadata_pool != nullptr)
+        allocate_new_metadata_object(out_buf, frame_id);
+    lock.lock();
+    opening = false;
+    open_cv.notify_all();
+    if (frame == nullptr)
+        return false;
+
+    FrameSlot& slot = slots[frame_id];
+    slot.frame_num = next_frame_num;
+    slot.data = frame;
+    std::fill(slot.received.begin(), slot.received.end(), 0);
+    slot.num_received = 0;
+    slot.closed = false;
+    slot.state.store(0, std::memory_order_release);
+    window.push_back(&slot);
+
+    next_frame_id = (frame_id + 1) % out_buf->num_frames;
+    next_frame_num++;
+    return true;
+}
+
+void UdpCapture::finish_copies(std::vector<Copy>& copies) {
+    for (auto& copy : copies) {
+        memcpy(copy.dst, copy.src, payload_size);
+        release(copy.slot);
+    }
+    packets_counter.inc(copies.size());
+    copies.clear();
+}
+
+void UdpCapture::close_front() {
+    FrameSlot* slot = window.front();
+    window.pop_front();
+    if (!slot->closed)
+        close_slot(slot);
+}
+
+void UdpCapture::close_slot(FrameSlot* slot) {
+    slot->closed = true;
+    uint32_t prev = slot->state.fetch_or(closing_bit, std::memory_order_acq_rel);
+    if ((prev & ~closing_bit) == 0)
+        finalise(slot);
+}
+
+void UdpCapture::release(FrameSlot* slot) {
+    uint32_t prev = slot->state.fetch_sub(1, std::memory_order_acq_rel);
+    if (prev == (closing_bit | 1))
+        finalise(slot);
+}
+
+void UdpCapture::finalise(FrameSlot* slot) {
+    // Nothing else touches the frame now, and the window doesn't refer to it anymore
+    if (slot->num_received < packets_per_frame) {
+        for (size_t i = 0; i < packets_per_frame; i++) {
+            if (!slot->received[i])
+                memset(slot->data + i * payload_size, 0, payload_size);
+        }
+        lost_counter.inc(packets_per_frame - slot->num_received);
+    }
+    mark_frame_full(out_buf, unique_name.c_str(), slot - slots.data());
+    frames_counter.inc();
+}
@@ -0,0 +1,191 @@
+/*****************************************
+@file
+@brief Capture sequence numbered UDP packets into a buffer.
+- UdpCapture : public kotekan::Stage
+*****************************************/
+#ifndef UDP_CAPTURE_HPP
+#define UDP_CAPTURE_HPP
+
+#include "Config.hpp"            // for Config
+#include "Stage.hpp"             // for Stage
+#include "buffer.h"              // for Buffer
+#include "bufferContainer.hpp"   // for bufferContainer
+#include "prometheusMetrics.hpp" // for Counter, MetricFamily
+
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <deque>              // for deque
+#include <mutex>              // for mutex, unique_lock
+#include <stddef.h>           // for size_t
+#include <stdint.h>           // for uint8_t, int64_t, uint32_t, uint64_t
+#include <string>             // for string
+#include <vector>             // for vector
+
+
+/**
+ * @class UdpCapture
+ * @brief Receive UDP packets and place them into frames by their sequence number.
+ *
+ * Each packet carries a sequence number (a little endian unsigned integer at
+ * @c seq_num_offset), and frames hold @c packets_per_frame consecutive
+ * packets: the packet with sequence number @c s goes to slot
+ * @c s % packets_per_frame of frame number @c s / packets_per_frame. The first
+ * @c udp_header_size bytes of each packet are dropped, so
+ * @c packets_per_frame is the frame size divided by the size of the rest.
+ *
+ * The packets are received in batches with @c recvmmsg by @c num_threads
+ * threads. Each thread has its own socket bound to the same address with
+ * @c SO_REUSEPORT, so the kernel spreads the packets of different senders
+ * over the threads (all packets of a single sender end up on the same socket).
+ *
+ * Up to @c frame_window frames are filled at the same time, to allow for
+ * packets arriving out of order. A frame is marked full once all its packets
+ * have arrived, or when a packet for a frame beyond the window arrives. The
+ * slots of packets that never arrived are zeroed and counted as lost. Frames
+ * that no packet arrived for at all are skipped rather than emitted empty.
+ * A packet more than @c resync_frames frames behind the window is taken as
+ * the sender having restarted its sequence numbers: the frames of the window
+ * are passed on and the window starts over at the frame of that packet.
+ *
+ * The sequence number of a packet is only known once it has been received, so
+ * the packets are received into a staging area and copied into their frames
+ * (outside of the lock guarding the window).
+ *
+ * @par Buffers
+ * @buffer out_buf Buffer to put the packets into.
+ *     @buffer_format Array of packets, without their first @c udp_header_size bytes.
+ *     @buffer_metadata Any, a new metadata object is allocated for each frame
+ *                      and left for a later stage to fill.
+ *
+ * @conf   udp_port            Int. Port to listen on.
+ * @conf   udp_ip              String (default "0.0.0.0"). Address to listen on.
+ * @conf   udp_packet_size     Int. Size of the packets, packets of any other size are dropped.
+ * @conf   udp_header_size     Int (default 0). Bytes at the start of each packet not to copy
+ *                             into the frame.
+ * @conf   seq_num_offset      Int (default 0). Offset of the sequence number in the packet.
+ * @conf   seq_num_bytes       Int (default 8). Size of the sequence number, 4 or 8 bytes.
+ * @conf   num_threads         Int (default 1). Number of receiving threads (and sockets).
+ * @conf   recv_batch_size     Int (default 64). Maximum number of packets per @c recvmmsg.
+ * @conf   frame_window        Int (default 2). Number of frames filled at the same time. Must
+ *                             be smaller than the number of frames in @c out_buf.
+ * @conf   resync_frames       Int (default 16). Number of frames a packet can be behind the
+ *                             window before the window is restarted at its frame.
+ * @conf   socket_buffer_size  Int (default 64 MiB). Receive buffer size of each socket.
+ *
+ * @par Metrics
+ * @metric kotekan_udpcapture_packets_total
+ *         The number of packets placed into frames.
+ * @metric kotekan_udpcapture_lost_packets_total
+ *         The number of packets missing from the frames (including skipped frames).
+ * @metric kotekan_udpcapture_dropped_packets_total
+ *         The number of packets received but not used, by reason: ``late`` (its
+ *         frame was already passed on), ``duplicate`` or ``size``.
+ * @metric kotekan_udpcapture_frames_total
+ *         The number of frames marked full.
+ * @metric kotekan_udpcapture_skipped_frames_total
+ *         The number of frames that were skipped because no packet for them arrived.
+ *
+ */
+class UdpCapture : public kotekan::Stage {
+public:
+    /// Constructor, reads the config and sets up the metrics.
+    UdpCapture(kotekan::Config& config, const std::string& unique_name,
+               kotekan::bufferContainer& buffer_container);
+
+    /// Opens the sockets and runs the receiving threads.
+    void main_thread() override;
+
+private:
+    /// A buffer frame being filled
+    struct FrameSlot {
+        /// Frame number, i.e. sequence number / packets_per_frame
+        int64_t frame_num;
+        /// The buffer frame
+        uint8_t* data;
+        /// Flags of the packets claimed so far
+        std::vector<uint8_t> received;
+        size_t num_received;
+        /// Set once the frame left the window (or is complete)
+        bool closed;
+        /// Number of packets being copied into the frame, plus @c closing_bit once closed
+        std::atomic<uint32_t> state;
+    };
+
+    /// A packet to copy into a frame
+    struct Copy {
+        FrameSlot* slot;
+        uint8_t* dst;
+        const uint8_t* src;
+    };
+
+    /// Receive packets from one socket
+    void receive_thread(int fd, int thread_id);
+
+    /// Find the frame for a packet and claim its slot. Call with @p lock on @c window_lock
+    /// held, which is released while waiting for a frame to open.
+    FrameSlot* claim(uint64_t seq_num, uint8_t** dst, std::unique_lock<std::mutex>& lock,
+                     std::vector<Copy>& copies);
+
+    /// Open the next frame, or wait for the thread opening it. Call with @p lock on
+    /// @c window_lock held, which is released while waiting. The @p copies claimed so far
+    /// are done first, as the buffer frame might only come free once they are.
+    bool open_next_frame(std::unique_lock<std::mutex>& lock, std::vector<Copy>& copies);
+
+    /// Copy the claimed packets into their frames, without @c window_lock held.
+    void finish_copies(std::vector<Copy>& copies);
+
+    /// Close the oldest frame of the window. Call with @c window_lock held.
+    void close_front();
+
+    /// Close a frame, finalising it if no copies are outstanding.
+    void close_slot(FrameSlot* slot);
+
+    /// Indicate that a copy into @p slot is done.
+    void release(FrameSlot* slot);
+
+    /// Zero any missing packets and pass the frame on.
+    void finalise(FrameSlot* slot);
+
+    struct Buffer* out_buf;
+
+    // Config
+    std::string udp_ip;
+    uint32_t udp_port;
+    size_t packet_size;
+    size_t header_size;
+    size_t payload_size;
+    size_t seq_num_offset;
+    size_t seq_num_bytes;
+    size_t packets_per_frame;
+    size_t num_threads;
+    size_t recv_batch_size;
+    size_t frame_window;
+    size_t resync_frames;
+    int socket_buffer_size;
+
+    /// One slot per buffer frame
+    std::vector<FrameSlot> slots;
+
+    /// The frames being filled, consecutive frame numbers starting at the front
+    std::deque<FrameSlot*> window;
+    /// The frame number of the next frame to open, -1 until the first packet arrives
+    int64_t next_frame_num = -1;
+    /// The buffer frame the next frame goes to
+    int next_frame_id = 0;
+    /// Guards the window and the claiming of packets
+    std::mutex window_lock;
+    /// Set while a thread waits for the next buffer frame without @c window_lock
+    bool opening = false;
+    /// Signalled once the next frame is opened
+    std::condition_variable open_cv;
+
+    static constexpr uint32_t closing_bit = 1u << 31;
+
+    kotekan::prometheus::Counter& packets_counter;
+    kotekan::prometheus::Counter& lost_counter;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& dropped_counter;
+    kotekan::prometheus::Counter& frames_counter;
+    kotekan::prometheus::Counter& skipped_counter;
+};
+
+#endif // UDP_CAPTURE_HPP
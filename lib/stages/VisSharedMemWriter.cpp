@@ -5,13 +5,13 @@
 #include "datasetManager.hpp"    // for dset_id_t, datasetManager, fingerprint_t
 #include "datasetState.hpp"      // for freqState, _factory_aliasdatasetState
 #include "factory.hpp"           // for FACTORY
-#include "kotekanLogging.hpp"    // for FATAL_ERROR, DEBUG, INFO, WARN
-#include "prometheusMetrics.hpp" // for Counter, Gauge, Metrics, MetricFamily
+#include "kotekanLogging.hpp"    // for FATAL_ERROR, DEBUG, INFO
+#include "prometheusMetrics.hpp" // for Counter, Metrics, MetricFamily
 #include "visBuffer.hpp"         // for VisFrameView, VisMetadata
-#include "visUtil.hpp"           // for time_ctype, frameID, operator<, modulo, current_time
+#include "visUtil.hpp"           // for time_ctype, frameID, operator<, modulo
 
-#include <algorithm>   // for copy, fill_n, copy_backward, equal, max
-#include <atomic>      // for atomic_bool
+#include <algorithm>   // for copy, copy_backward, equal, max
+#include <atomic>      // for atomic, atomic_thread_fence, memory_order_release, atomic_bool
 #include <deque>       // for deque
 #include <errno.h>     // for errno, ENOENT
 #include <exception>   // for exception
@@ -25,9 +25,7 @@
 #include <string.h>    // for strerror, memcpy, memset
 #include <sys/mman.h>  // for mmap, shm_open, MAP_FAILED, MAP_SHARED, PROT_READ, PROT...
 #include <sys/stat.h>  // for S_IRUSR, S_IWUSR
-#include <sys/time.h>  // for CLOCK_REALTIME
 #include <sys/types.h> // for uint
-#include <time.h>      // for clock_gettime, timespec
 #include <tuple>       // for get
 #include <unistd.h>    // for access, close, ftruncate, F_OK
 #include <utility>     // for pair
@@ -56,15 +54,12 @@ VisSharedMemWriter::VisSharedMemWriter(Config& config, const std::string& unique
                                        bufferContainer& buffer_container) :
     Stage(config, unique_name, buffer_container, std::bind(&VisSharedMemWriter::main_thread, this)),
     dropped_frame_counter(Metrics::instance().add_counter(
-        "kotekan_vissharedmemwriter_dropped_frame_total", unique_name, {"freq_id", "reason"})),
-    access_record_wait_time_seconds(Metrics::instance().add_gauge(
-        "kotekan_access_record_wait_time_seconds", unique_name, {"shm_name"})) {
+        "kotekan_vissharedmemwriter_dropped_frame_total", unique_name, {"freq_id", "reason"})) {
 
     // Fetch any simple configuration
     _root_path = config.get_default<std::string>(unique_name, "root_path", "/dev/shm/");
     _name = config.get_default<std::string>(unique_name, "name", "calBuffer");
-    rbs._ntime = config.get_default<uint64_t>(unique_name, "num_samples", 512);
-    _wait_time = config.get_default<size_t>(unique_name, "wait_time", 120);
+    rbs.ntime = config.get_default<uint64_t>(unique_name, "num_samples", 512);
 
     // Set the list of critical states
     critical_state_types = {"frequencies", "inputs",      "products",
@@ -85,66 +80,31 @@ VisSharedMemWriter::VisSharedMemWriter(Config& config, const std::string& unique
     // Check if any of the old buffer files exist
     // Remove them, if they do
     DEBUG("Checking for and removing old buffer files...");
-    check_remove(_root_path + "sem." + _name);
     check_remove(_root_path + _name);
 }
 
 VisSharedMemWriter::~VisSharedMemWriter() {
-    // make sure to unlink the semaphore and unmap the mappings
     // We are setting num_writes to 0 in the structured data,
     // to communicate to readers that the ring buffer is not being written to
-
-    wait_for_semaphore();
+    if (structured_data_addr == nullptr)
+        return;
 
     num_writes = 0;
-    *structured_data_addr = num_writes;
-
-    release_semaphore();
+    structured_data_addr->store(num_writes, std::memory_order_release);
 }
 
-void VisSharedMemWriter::wait_for_semaphore() {
-    // handles timed waits for semaphores
-    // does a standard wait if the system clock is not accessible
-
-    double start_time = current_time();
-
-#ifdef MAC_OSX
-    if (sem_wait(sem) == -1) {
-        FATAL_ERROR("Failed to acquire semaphore {}", _name);
-        return;
-    }
-
-#else
-    timespec ts;
-    if (clock_gettime(CLOCK_REALTIME, &ts) == -1) {
-        WARN("Failed to get system time. {:d} ({:s}) Not using timed semaphores.", errno,
-             std::strerror(errno));
-
-        if (sem_wait(sem) == -1) {
-            FATAL_ERROR("Failed to acquire semaphore {}", _name);
-            return;
-        }
-
-    } else {
-        ts.tv_sec += _wait_time;
-
-        if (sem_timedwait(sem, &ts) == -1) {
-            FATAL_ERROR("sem_timedwait() timed out");
-            return;
-        }
-    }
-
-#endif
-    wait_time_average.add_sample(current_time() - start_time);
-    access_record_wait_time_seconds.labels({_name}).set(wait_time_average.average());
-    return;
+void VisSharedMemWriter::begin_write(size_t slot) {
+    // Only this thread modifies the generation, so a relaxed read is fine. The
+    // fence orders the odd generation before any of the following stores to the
+    // frame, which pairs with the fence readers issue after copying a frame.
+    uint64_t gen = generation_addr[slot].load(std::memory_order_relaxed);
+    generation_addr[slot].store(gen + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
 }
 
-void VisSharedMemWriter::release_semaphore() {
-    if (sem_post(sem) == -1) {
-        FATAL_ERROR("Failed to post semaphore {}", _name);
-    }
-    return;
+void VisSharedMemWriter::end_write(size_t slot) {
+    uint64_t gen = generation_addr[slot].load(std::memory_order_relaxed);
+    generation_addr[slot].store(gen + 1, std::memory_order_release);
 }
 
 uint8_t* VisSharedMemWriter::assign_memory(std::string shm_name, size_t shm_size) {
@@ -220,7 +180,7 @@ void VisSharedMemWriter::add_sample(const VisFrameView& frame, time_ctype t, uin
 
     else {
         cur_pos++;
-        if (vis_time_ind_map.size() == rbs._ntime) {
+        if (vis_time_ind_map.size() == rbs.ntime) {
             // we need to drop the oldest time
             reset_memory(cur_pos);
             vis_time_ind_map.erase(min_time);
@@ -238,22 +198,24 @@ void VisSharedMemWriter::reset_memory(uint32_t time_ind) {
     // resets all memory at time_ind to 0s
 
     uint8_t* buf_write_pos = buf_addr + (time_ind * rbs.nfreq * rbs.frame_size);
-    int64_t* access_record_write_pos = access_record_addr + (time_ind * rbs.nfreq);
+    size_t slot = time_ind * rbs.nfreq;
 
     DEBUG("Resetting access_record memory at position time_ind: {}", time_ind);
 
     // notify that the entire time_ind is invalid, by setting time_ind in the access record to
     // invalid
-    wait_for_semaphore();
-
-    std::fill_n(access_record_write_pos, rbs.nfreq, invalid);
-
-    release_semaphore();
+    for (size_t f = 0; f < rbs.nfreq; f++) {
+        begin_write(slot + f);
+        access_record_addr[slot + f].store(invalid, std::memory_order_relaxed);
+    }
 
     DEBUG("Resetting ring buffer memory at position time_ind: {}", time_ind);
     // set the full time_ind to 0 in the ring buffer
     memset(buf_write_pos, 0, rbs.nfreq * rbs.frame_size);
 
+    for (size_t f = 0; f < rbs.nfreq; f++)
+        end_write(slot + f);
+
     DEBUG("Memory reset");
 }
 
@@ -261,18 +223,15 @@ void VisSharedMemWriter::write_to_memory(const VisFrameView& frame, uint32_t tim
                                          uint32_t freq_ind) {
     // write frame to ring buffer at time_ind and freq_ind
 
-    uint8_t* buf_write_pos = buf_addr + ((time_ind * rbs.nfreq + freq_ind) * rbs.frame_size);
-    int64_t* access_record_write_pos = access_record_addr + (time_ind * rbs.nfreq + freq_ind);
+    size_t slot = time_ind * rbs.nfreq + freq_ind;
+    uint8_t* buf_write_pos = buf_addr + slot * rbs.frame_size;
 
     DEBUG("Writing ringbuffer to time_ind {} and freq_ind {}", time_ind, freq_ind);
 
-    // notify that time_ind and freq_ind are being written to, by setting that
-    // location to invalid in the access record
-    wait_for_semaphore();
-
-    *access_record_write_pos = invalid;
-
-    release_semaphore();
+    // notify that time_ind and freq_ind are being written to, by making the
+    // generation odd and setting that location to invalid in the access record
+    begin_write(slot);
+    access_record_addr[slot].store(invalid, std::memory_order_relaxed);
 
     // first write the metadata, then the data, then the valid byte
     // add valid_size amount of padding
@@ -283,17 +242,13 @@ void VisSharedMemWriter::write_to_memory(const VisFrameView& frame, uint32_t tim
     // Document the fpga sequence counter for that frame in the access record
     uint64_t fpga_seq = frame.metadata()->fpga_seq_start;
 
-
-    wait_for_semaphore();
-
     DEBUG("Writing fpga_seq {} to time index {}", fpga_seq, time_ind);
-    *access_record_write_pos = fpga_seq;
+    access_record_addr[slot].store(fpga_seq, std::memory_order_relaxed);
+    end_write(slot);
 
     // update num_writes
     num_writes++;
-    *structured_data_addr = num_writes;
-
-    release_semaphore();
+    structured_data_addr->store(num_writes, std::memory_order_release);
     return;
 }
 
@@ -304,20 +259,7 @@ void VisSharedMemWriter::main_thread() {
 
     // The current position in the ring buffer of the most recent time sample
     // from 0 -> _ntime
-    cur_pos = modulo<int>(rbs._ntime);
-
-    // Create the semaphore, and gain first access to it
-    sem = sem_open(_name.c_str(), (O_CREAT | O_EXCL), (S_IRUSR | S_IWUSR), 1);
-
-    if (sem == SEM_FAILED) {
-        FATAL_ERROR("Failed to create semaphore {}", _name);
-        return;
-    }
-
-    DEBUG("Semaphore created.");
-
-    // Acquire semaphore until shared memory is created
-    wait_for_semaphore();
+    cur_pos = modulo<int>(rbs.ntime);
 
     // Set up the structure of the ring buffer shared memory
     // Get one frame for reference
@@ -360,26 +302,30 @@ void VisSharedMemWriter::main_thread() {
     // Aligns the frame along page size
     rbs.frame_size = _member_alignment(rbs.data_size + rbs.metadata_size + valid_size, alignment);
 
-    // memory_size should be _ntime * nfreq * file_frame_size (data + metadata)
-    buf_addr = assign_memory(_name, (structured_data_size * structured_data_num)
-                                        + (rbs._ntime * rbs.nfreq * access_record_size)
-                                        + (rbs._ntime * rbs.nfreq * rbs.frame_size));
+    // memory_size should be _ntime * nfreq * file_frame_size (data + metadata), plus the
+    // structured data, access record and generations
+    uint8_t* shm_addr = assign_memory(_name, VisSharedMemReader::total_size(rbs));
 
-    // The elements contained in the structured data and access record are each 64 bytes
-    structured_data_addr = (uint64_t*)buf_addr;
-    access_record_addr = (int64_t*)(structured_data_addr + structured_data_num);
-    buf_addr += (structured_data_size * structured_data_num)
-                + (rbs._ntime * rbs.nfreq * access_record_size);
-
-    // Record structure of data
-    *structured_data_addr = num_writes;
-    *((RingBufferStructure*)(structured_data_addr + 1)) = rbs;
+    // The elements contained in the structured data, access record and generations are each 64
+    // bits. The fresh region is all zeros, so all generations start out even.
+    structured_data_addr = (std::atomic<uint64_t>*)shm_addr;
+    access_record_addr =
+        (std::atomic<int64_t>*)(shm_addr + VisSharedMemReader::access_record_offset());
+    generation_addr =
+        (std::atomic<uint64_t>*)(shm_addr + VisSharedMemReader::generation_offset(rbs));
+    buf_addr = shm_addr + VisSharedMemReader::data_offset(rbs);
 
     // initially set the address records with -1
-    std::fill_n(access_record_addr, rbs._ntime * rbs.nfreq, invalid);
+    for (size_t i = 0; i < rbs.ntime * rbs.nfreq; i++)
+        access_record_addr[i].store(invalid, std::memory_order_relaxed);
+
+    // Record structure of data. This has to come last: until the structure matches the size of
+    // the region, readers refuse to use it.
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(shm_addr + sizeof(uint64_t), &rbs, sizeof(VisSharedMemStructure));
+    structured_data_addr->store(num_writes, std::memory_order_release);
 
     INFO("Created the shared memory buffer {}", _name);
-    release_semaphore();
 
     // gets called once when kotekan is running
     while (!stop_thread) {
@@ -6,21 +6,22 @@
 #ifndef VISSHAREDMEMWRITER_HPP
 #define VISSHAREDMEMWRITER_HPP
 
-#include "Config.hpp"            // for Config
-#include "Stage.hpp"             // for Stage
-#include "buffer.h"              // for Buffer
-#include "bufferContainer.hpp"   // for bufferContainer
-#include "datasetManager.hpp"    // for dset_id_t, fingerprint_t
-#include "prometheusMetrics.hpp" // for MetricFamily, Counter, Gauge
-#include "visBuffer.hpp"         // for VisFrameView
-#include "visUtil.hpp"           // for time_ctype, modulo, movingAverage
-
-#include <cstdint>     // for uint64_t, uint32_t, uint8_t, int64_t
-#include <map>         // for map
-#include <semaphore.h> // for sem_t
-#include <set>         // for set
-#include <stddef.h>    // for size_t
-#include <string>      // for string
+#include "Config.hpp"             // for Config
+#include "Stage.hpp"              // for Stage
+#include "VisSharedMemReader.hpp" // for VisSharedMemStructure
+#include "buffer.h"               // for Buffer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "datasetManager.hpp"     // for dset_id_t, fingerprint_t
+#include "prometheusMetrics.hpp"  // for MetricFamily, Counter
+#include "visBuffer.hpp"          // for VisFrameView
+#include "visUtil.hpp"            // for time_ctype, modulo
+
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint64_t, uint32_t, uint8_t, int64_t
+#include <map>      // for map
+#include <set>      // for set
+#include <stddef.h> // for size_t
+#include <string>   // for string
 
 /**
  * @class VisSharedMemWriter
@@ -32,8 +33,10 @@
  *
  * The shared memory region is composed of a Structured Data Region
  * (summarises the structure for the data), an Access Record region
- * (records the writer's access to the Data region), and the Data region
- * (ring buffer which contains the data and metadata from the frame).
+ * (records the writer's access to the Data region), a Generation region
+ * (one seqlock counter per frame) and the Data region (ring buffer which
+ * contains the data and metadata from the frame). See VisSharedMemReader
+ * for the exact layout.
  *
  * The structure of the shared memory region can be seen in the figure in
  * this issue: https://github.com/kotekan/kotekan/issues/692.
@@ -46,17 +49,20 @@
  * the validity of the data. The access record has a 1:1 correlation to
  * the Data region. Every time the Data is modified, the access record
  * will have the timestamp of modification. While data is written,
- * its access record will be set to -1. Acquiring a semaphore, with the
- * same name as the shared memory region is required before reading
- * from or writing to the access record. The Data region is lock free.
+ * its access record will be set to -1.
+ *
+ * Access is lock-free: every frame has a generation counter, which the
+ * writer bumps to an odd value before it modifies the frame or its access
+ * record and to the next even value once it is done. Readers read the
+ * generation, copy the access record entry and the frame, and keep the copy
+ * only if the generation was even and didn't change in the meantime. The
+ * writer never waits for readers, and any number of readers can copy
+ * concurrently.
  *
  * This stage writes out the data it receives with minimal processing.
  * Removing certain fields from the output must be done in a prior
  * transformation.
  *
- * A Valve stage should be added before this buffer process
- * to prevent data backing up during semaphore deadlocks.
- *
  * To obtain the metadata about the stream received usage of the datasetManager
  * is required.
  *
@@ -73,12 +79,9 @@
  *          @buffer_metadata VisMetadata
  *
  * @conf    root_path       String. Location in filesystem containing
- *                          shared memory and semaphore.
- * @conf    name           Name of shared memory region and semaphore.
+ *                          shared memory.
+ * @conf    name           Name of shared memory region.
  * @conf    num_samples        Number of time samples stored in ring buffer.
- * @conf    wait_time   Maximum time that the writer will wait to
- *                          unlock a semaphore. If it hits the limit
- *                          Kotekan will shut down the stage.
  * @conf    critical_states List of strings. A list of state types to consider
  *                          critical. That is, if they change in the incoming
  *                          data stream then Kotekan will shut down.
@@ -86,9 +89,6 @@
  * @par Metrics
  * @metric dropped_frame_counter
  *          The number of times a frame was dropped because it arrived too late.
- * @metric  access_record_wait_time_seconds
- *          The amount of time the writer spent, in seconds waiting to
- *          access the access record.
  *
  * @author Anja Boskovic
  */
@@ -107,53 +107,28 @@ protected:
     // Input buffer to read from
     Buffer* in_buf;
 
-    // Semaphore for updating access record
-    sem_t* sem;
-
-    // Pointers to shared memory addresses for structured data, access record and ringBuffer
-    uint64_t* structured_data_addr;
-    int64_t* access_record_addr;
-    uint8_t* buf_addr;
+    // Pointers to shared memory addresses for structured data, access record,
+    // generation counters and ringBuffer
+    std::atomic<uint64_t>* structured_data_addr = nullptr;
+    std::atomic<int64_t>* access_record_addr = nullptr;
+    std::atomic<uint64_t>* generation_addr = nullptr;
+    uint8_t* buf_addr = nullptr;
 
     // Parameters that define structure of ring buffer
-    //
-    struct RingBufferStructure {
-        // The number of time samples contained in ring buffer
-        uint64_t _ntime;
-        // The number of frequencies contained in each time sample
-        uint64_t nfreq;
-        // The size of each frame (valid byte + metadata + data + page alignment padding)
-        uint64_t frame_size;
-        // The size of each metadata section
-        uint64_t metadata_size;
-        // The size of each data section
-        uint64_t data_size;
-    };
-
-    RingBufferStructure rbs;
+    VisSharedMemStructure rbs;
 
     // Counter for the number of writes to the ring buffer
     // Set to 0, upon stage shut-down
     uint64_t num_writes = 0;
-    // The semaphore wait time before a timeout, in seconds
-    size_t _wait_time;
 
     // Messages
     // Indicates that the written frame is valid
     const uint8_t valid = 1;
     // Space that the "valid byte" takes up
-    size_t valid_size = 4;
+    const size_t valid_size = VisSharedMemReader::valid_size;
     // Indicates that the ring buffer frames at those time_ind and freq_ind are
     // invalid
-    const int64_t invalid = -1;
-
-    // The number of elements in the structured data
-    const size_t structured_data_num = 6;
-    // the size of each element
-    const size_t structured_data_size = sizeof(uint64_t);
-
-    // The size of each record address
-    const size_t access_record_size = 8;
+    const int64_t invalid = VisSharedMemReader::invalid;
 
     // The current position in the ring buffer of the most recent time sample
     modulo<int> cur_pos;
@@ -203,14 +178,18 @@ protected:
     void reset_memory(uint32_t time_ind);
 
     /**
-     * Waits to acquire access record semaphore.
+     * Mark a frame as being modified, by making its generation odd.
+     *
+     * @param   slot    Index of the frame (`time_ind * nfreq + freq_ind`).
      **/
-    void wait_for_semaphore();
+    void begin_write(size_t slot);
 
     /**
-     * Releases access record semaphore
+     * Mark a frame as complete again, by making its generation even.
+     *
+     * @param   slot    Index of the frame (`time_ind * nfreq + freq_ind`).
      **/
-    void release_semaphore();
+    void end_write(size_t slot);
 
     std::string _root_path, _name;
 
@@ -226,12 +205,6 @@ protected:
 private:
     // Number of dropped frames
     kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& dropped_frame_counter;
-
-    // Time spent waiting for semaphore
-    kotekan::prometheus::MetricFamily<kotekan::prometheus::Gauge>& access_record_wait_time_seconds;
-
-    // Keep track of the average semaphore wait time
-    movingAverage wait_time_average;
 };
 
 #endif // VISSHAREDMEMWRITER_HPP
@@ -256,6 +256,7 @@ void VisTranspose::create_hdf5_file() {
             new visFileArchive(filename, metadata, times, freqs, inputs, prods, num_ev, chunk,
                                kotekan::logLevel(_member_log_level)));
     }
+    file->set_compression_threads(compression_threads);
 }
 
 void VisTranspose::copy_frame_data(uint32_t freq_index, uint32_t time_index) {
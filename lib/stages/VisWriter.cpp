@@ -21,7 +21,7 @@
 #include <exception>    // for exception
 #include <future>       // for async, future
 #include <map>          // for map, map<>::mapped_type
-#include <memory>       // for __shared_ptr_access, shared_ptr
+#include <memory>       // for make_shared, __shared_ptr_access, shared_ptr
 #include <stdexcept>    // for out_of_range
 #include <string>       // for string
 #include <sys/types.h>  // for uint
@@ -102,11 +102,11 @@ void VisWriter::get_dataset_state(dset_id_t ds_id) {
 
 void VisWriter::write_data(Buffer* in_buf, int frame_id) {
 
-    auto frame = VisFrameView(in_buf, frame_id);
+    auto frame = std::make_shared<VisFrameView>(in_buf, frame_id);
 
     // Get time of the frame
-    auto ftime = frame.time;
+    auto ftime = frame->time;
     time_ctype t = {std::get<0>(ftime), ts_to_double(std::get<1>(ftime))};
 
-    write_frame(frame, frame.dataset_id, frame.freq_id, t);
+    write_frame(frame, frame->dataset_id, frame->freq_id, t);
 }
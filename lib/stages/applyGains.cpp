@@ -27,6 +27,7 @@
 #include <cstdint>                   // for uint64_t, uint32_t, uint8_t
 #include <exception>                 // for exception
 #include <functional>                // for _Bind_helper<>::type, _Placeholder, bind, _1, function
+#include <future>                    // for future, future_status
 #include <highfive/H5DataSet.hpp>    // for DataSet
 #include <highfive/H5File.hpp>       // for File, NodeTraits::getDataSet, File::File, File::Rea...
 #include <highfive/H5Object.hpp>     // for HighFive
@@ -41,6 +42,7 @@
 #include <sys/stat.h>                // for stat
 #include <thread>                    // for thread, sleep_for
 #include <tuple>                     // for get, tie, tuple
+#include <vector>                    // for vector
 
 
 using nlohmann::json;
@@ -350,8 +352,6 @@ void applyGains::apply_thread() {
 
 void applyGains::fetch_thread() {
 
-    auto& dm = datasetManager::instance();
-
     while (!stop_thread) {
 
         // Wait until we've start receiving data before fetching any updates. By
@@ -366,46 +366,75 @@ void applyGains::fetch_thread() {
         if (!update)
             break;
 
-        auto [update_id, transition_interval, new_ts, new_state] = *update;
-
-        std::optional<applyGains::GainData> gain_data;
-        if (read_from_file) {
-            DEBUG("Reading gains from file...");
-            gain_data = read_gain_file(update_id);
-        } else {
-            DEBUG("Fetching gains...");
-            gain_data = fetch_gains(update_id);
-        }
-        if (!gain_data) {
-            WARN("Ignoring gain update with update_id {:s}.", update_id);
-            continue;
+        // Take any other updates already waiting, so they can be fetched together
+        std::vector<update_t> updates = {*update};
+        while ((update = update_fetch_queue.try_get()))
+            updates.push_back(*update);
+
+        // Send all requests to the cal broker at once, they go out concurrently
+        std::vector<std::future<restClient::restReply>> replies;
+        if (!read_from_file) {
+            DEBUG("Fetching {:d} gain update(s)...", updates.size());
+            for (auto& u : updates)
+                replies.push_back(fetch_gains(std::get<0>(u)));
         }
 
-        // update gains
-        state_id_t state_id;
-        if (new_state) {
-            state_id = dm.create_state<gainState>(update_id, transition_interval).first;
-        }
-        // Use the current dataset ID
-        else {
-            const auto last_update = gains_fifo.get_update(double_to_ts(new_ts)).second;
-            if (last_update == nullptr) {
-                WARN("Failed to retrieve the last update, gains queue empty. Creating new gain "
-                     "state.");
-                state_id = dm.create_state<gainState>(update_id, transition_interval).first;
+        // Apply the updates in the order they arrived
+        for (size_t i = 0; i < updates.size(); i++) {
+            auto [update_id, transition_interval, new_ts, new_state] = updates[i];
+
+            std::optional<applyGains::GainData> gain_data;
+            if (read_from_file) {
+                DEBUG("Reading gains from file...");
+                gain_data = read_gain_file(update_id);
+            } else if (replies[i].wait_for(restClient::reply_wait())
+                       != std::future_status::ready) {
+                // As with a blocking request, libevent should have timed out before
+                FATAL_ERROR("Timeout fetching gains {:s} from the calibration broker.", update_id);
             } else {
-                state_id = last_update->state_id;
+                gain_data = parse_gains(update_id, replies[i].get());
+            }
+            if (!gain_data) {
+                WARN("Ignoring gain update with update_id {:s}.", update_id);
+                continue;
             }
+
+            insert_update(update_id, transition_interval, new_ts, new_state,
+                          std::move(gain_data.value()));
         }
-        GainUpdate gain_update{std::move(gain_data.value()), transition_interval, state_id};
+    }
+}
 
-        {
-            // Lock mutex exclusively while we update FIFO
-            std::lock_guard<std::shared_mutex> lock(gain_mtx);
-            gains_fifo.insert(double_to_ts(new_ts), std::move(gain_update));
+
+void applyGains::insert_update(const std::string& update_id, double transition_interval,
+                               double new_ts, bool new_state, GainData&& gain_data) {
+
+    auto& dm = datasetManager::instance();
+
+    // update gains
+    state_id_t state_id;
+    if (new_state) {
+        state_id = dm.create_state<gainState>(update_id, transition_interval).first;
+    }
+    // Use the current dataset ID
+    else {
+        const auto last_update = gains_fifo.get_update(double_to_ts(new_ts)).second;
+        if (last_update == nullptr) {
+            WARN("Failed to retrieve the last update, gains queue empty. Creating new gain "
+                 "state.");
+            state_id = dm.create_state<gainState>(update_id, transition_interval).first;
+        } else {
+            state_id = last_update->state_id;
         }
-        INFO("Updated gains to {:s}.", update_id);
     }
+    GainUpdate gain_update{std::move(gain_data), transition_interval, state_id};
+
+    {
+        // Lock mutex exclusively while we update FIFO
+        std::lock_guard<std::shared_mutex> lock(gain_mtx);
+        gains_fifo.insert(double_to_ts(new_ts), std::move(gain_update));
+    }
+    INFO("Updated gains to {:s}.", update_id);
 }
 
 
@@ -514,18 +543,24 @@ std::vector<std::vector<U>> unpack_2d(const std::vector<T>& arr1d, uint32_t nr,
 }
 
 
-std::optional<applyGains::GainData> applyGains::fetch_gains(std::string update_id) const {
+std::future<restClient::restReply> applyGains::fetch_gains(std::string update_id) const {
 
     // query cal broker
     json json_request;
     json_request["update_id"] = update_id;
-    restClient::restReply reply =
-        client.make_request_blocking("/gain", json_request, broker_host, broker_port);
+    return client.make_request_async("/gain", json_request, broker_host, broker_port);
+}
+
+
+std::optional<applyGains::GainData> applyGains::parse_gains(std::string update_id,
+                                                            restClient::restReply reply) const {
+
     if (!reply.first) {
-        WARN("Failed to retrieve gains from calibration broker. ({})", reply.second);
+        WARN("Failed to retrieve gains {:s} from calibration broker. ({})", update_id,
+             reply.second);
         return std::nullopt;
     }
-    INFO("Got reply from cal broker.");
+    INFO("Got reply from cal broker for gains {:s}.", update_id);
 
     // parse reply
     json js_reply;
@@ -17,6 +17,7 @@
 
 #include <atomic>       // for atomic
 #include <ctime>        // for timespec, size_t
+#include <future>       // for future
 #include <map>          // for map
 #include <mutex>        // for mutex
 #include <optional>     // for optional
@@ -159,11 +160,18 @@ private:
     kotekan::prometheus::Counter& late_update_counter;
     kotekan::prometheus::Counter& late_frames_counter;
 
+    /// Add new gains to the FIFO
+    void insert_update(const std::string& update_id, double transition_interval, double new_ts,
+                       bool new_state, GainData&& gain_data);
+
     /// Read the gain file from disk
     std::optional<GainData> read_gain_file(std::string update_id) const;
 
-    /// Fetch gains from calibration broker
-    std::optional<GainData> fetch_gains(std::string tag) const;
+    /// Request gains from calibration broker (without waiting for the reply)
+    std::future<restClient::restReply> fetch_gains(std::string update_id) const;
+
+    /// Parse the gains received from calibration broker
+    std::optional<GainData> parse_gains(std::string update_id, restClient::restReply reply) const;
 
     /// Used to indicate to other threads when incoming data has arrived and we
     /// are processing
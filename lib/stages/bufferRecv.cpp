@@ -1,6 +1,7 @@
 #include "bufferRecv.hpp"
 
 #include "Config.hpp"            // for Config
+#include "FrameCompression.hpp"  // for frameCodec, frame_codec_available, frame_codec_name
 #include "StageFactory.hpp"      // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
 #include "buffer.h"              // for Buffer, allocate_new_metadata_object, buffer_free, buff...
 #include "bufferContainer.hpp"   // for bufferContainer
@@ -8,7 +9,7 @@
 #include "metadata.h"            // for metadataPool
 #include "prometheusMetrics.hpp" // for Gauge, Metrics, Counter, MetricFamily
 #include "util.h"                // for string_tail
-#include "visUtil.hpp"           // for current_time
+#include "visUtil.hpp"           // for current_time, current_thread_cpu_time
 
 #include "fmt.hpp" // for format, fmt
 
@@ -31,6 +32,7 @@
 #include <string>          // for string, allocator, operator+
 #include <sys/select.h>    // for FD_SETSIZE
 #include <sys/socket.h>    // for AF_INET, accept, bind, listen, setsockopt, socket, sock...
+#include <sys/uio.h>       // for iovec, readv
 
 namespace kotekan {
 class connectionInstance;
@@ -56,7 +58,13 @@ bufferRecv::bufferRecv(Config& config, const std::string& unique_name,
     dropped_frame_counter(
         Metrics::instance().add_counter("kotekan_buffer_recv_dropped_frame_total", unique_name)),
     transfer_time_seconds(Metrics::instance().add_gauge("kotekan_buffer_recv_transfer_time_seconds",
-                                                        unique_name, {"source"})) {
+                                                        unique_name, {"source"})),
+    bytes_counter(Metrics::instance().add_counter("kotekan_buffer_recv_bytes_total", unique_name,
+                                                  {"source"})),
+    frames_counter(Metrics::instance().add_counter("kotekan_buffer_recv_frames_total",
+                                                   unique_name, {"source"})),
+    decompression_cpu_counter(Metrics::instance().add_counter(
+        "kotekan_buffer_recv_decompression_cpu_microseconds_total", unique_name, {"source"})) {
 
     listen_port = config.get_default<uint32_t>(unique_name, "listen_port", 11024);
     num_threads = config.get_default<uint32_t>(unique_name, "num_threads", 1);
@@ -177,6 +185,12 @@ void bufferRecv::internal_accept_connection(evutil_socket_t listener, short even
     instance->set_log_prefix(accept_args->unique_name + "/instance");
     instance->set_log_level(accept_args->log_level);
 
+    // Only this (the base) thread adds labels, so the metric families need no extra locking
+    std::string source_label = fmt::format(fmt("{:s}:{:d}"), ip_str, port);
+    instance->bytes_counter = &bytes_counter.labels({source_label});
+    instance->frames_counter = &frames_counter.labels({source_label});
+    instance->decompression_cpu_counter = &decompression_cpu_counter.labels({source_label});
+
     struct event* event_read =
         event_new(base, fd, EV_READ | EV_TIMEOUT, &bufferRecv::read_callback, (void*)instance);
 
@@ -389,85 +403,133 @@ void connInstance::internal_read_callback() {
         return;
     }
 
+    const size_t header_size = sizeof(struct bufferFrameHeader);
+    const size_t metadata_size = buf->metadata_pool->metadata_object_size;
+    const size_t frame_size = buf->frame_size;
     ssize_t n = 0;
 
     DEBUG2("Read Callback");
     while (!buffer_recv->get_worker_stop_thread()) {
-        switch (state) {
-            case connState::header:
-                start_time = current_time();
-
-                n = read(fd, (void*)(((int8_t*)&buf_frame_header) + bytes_read),
-                         sizeof(struct bufferFrameHeader) - bytes_read);
-                if (n <= 0) {
-                    handle_error("reading header", errno, n);
-                    return;
-                }
-                DEBUG2("Header read bytes: {:d}", n);
-                bytes_read += n;
-                if (bytes_read >= sizeof(struct bufferFrameHeader)) {
-                    assert(bytes_read == sizeof(struct bufferFrameHeader));
-                    state = connState::metadata;
-                    bytes_read = 0;
-
-                    DEBUG2("Got header: metadata_size: {:d}, frame_size: {:d}",
-                           buf_frame_header.metadata_size, buf_frame_header.frame_size);
-
-                    if ((unsigned int)buf->frame_size != buf_frame_header.frame_size) {
-                        ERROR("Frame size does not match between server: {:d} and client: {:d}",
-                              buf->frame_size, buf_frame_header.frame_size);
-                        decrement_ref_count();
-                        close_instance();
-                        return;
-                    }
-                    if (buf->metadata_pool->metadata_object_size
-                        != buf_frame_header.metadata_size) {
-                        ERROR("Metadata size does not match between server and client!");
-                        decrement_ref_count();
-                        close_instance();
-                        return;
-                    }
-                }
+        if (bytes_read == 0)
+            start_time = current_time();
+
+        // Read whatever is left of the header, metadata and frame in one go. The size of
+        // the metadata is fixed by the buffer, and checked once the header is in. The
+        // size of the frame data as sent is only known from the header, since it may be
+        // compressed.
+        bool have_header = bytes_read >= header_size;
+        size_t payload_size = have_header ? buf_frame_header.payload_size : 0;
+        uint8_t* payload_space = frame_space;
+        if (have_header && buf_frame_header.codec != (uint8_t)frameCodec::none)
+            payload_space = compressed_space.data();
+
+        struct iovec iov[3];
+        int iovcnt = 0;
+        size_t offset = bytes_read;
+        uint8_t* parts[3] = {(uint8_t*)&buf_frame_header, metadata_space, payload_space};
+        size_t part_sizes[3] = {header_size, metadata_size, payload_size};
+        for (int i = 0; i < 3; i++) {
+            if (offset < part_sizes[i]) {
+                iov[iovcnt].iov_base = parts[i] + offset;
+                iov[iovcnt].iov_len = part_sizes[i] - offset;
+                iovcnt++;
+                offset = 0;
+            } else {
+                offset -= part_sizes[i];
+            }
+        }
 
-                break;
-            case connState::metadata:
-                n = read(fd, (void*)(metadata_space + bytes_read),
-                         buf_frame_header.metadata_size - bytes_read);
-                if (n <= 0) {
-                    handle_error("reading header", errno, n);
-                    return;
-                }
-                DEBUG2("Metadata read bytes: {:d}", n);
-                bytes_read += n;
-                if (bytes_read >= buf_frame_header.metadata_size) {
-                    assert(bytes_read == buf_frame_header.metadata_size);
-                    state = connState::frame;
-                    bytes_read = 0;
-                }
-                break;
-            case connState::frame:
-                n = read(fd, (void*)(frame_space + bytes_read),
-                         buf_frame_header.frame_size - bytes_read);
-                if (n <= 0) {
-                    handle_error("reading header", errno, n);
-                    return;
-                }
-                bytes_read += n;
-                DEBUG2("Frame read bytes: {:d}, total read: {:d}", n, bytes_read);
-                if (bytes_read >= buf_frame_header.frame_size) {
-                    assert(bytes_read == buf_frame_header.frame_size);
-                    state = connState::finished;
-                    bytes_read = 0;
-                }
-                break;
-            case connState::finished:
-                throw std::runtime_error("State set to something unexpected!");
-                break;
+        n = readv(fd, iov, iovcnt);
+        if (n <= 0) {
+            handle_error("reading frame", errno, n);
+            return;
+        }
+        DEBUG2("Read bytes: {:d}, total read: {:d}", n, bytes_read + n);
+        bytes_counter->inc(n);
+
+        bytes_read += n;
+        if (!have_header && bytes_read >= header_size) {
+            DEBUG2("Got header: metadata_size: {:d}, frame_size: {:d}, payload_size: {:d}, "
+                   "codec: {:d}",
+                   buf_frame_header.metadata_size, buf_frame_header.frame_size,
+                   buf_frame_header.payload_size, buf_frame_header.codec);
+
+            if (buf_frame_header.version != bufferFrameHeader::current_version) {
+                ERROR("Client {:s} sends frame headers of version {:d}, expected version {:d}",
+                      client_ip, buf_frame_header.version, bufferFrameHeader::current_version);
+                decrement_ref_count();
+                close_instance();
+                return;
+            }
+            if ((unsigned int)buf->frame_size != buf_frame_header.frame_size) {
+                ERROR("Frame size does not match between server: {:d} and client: {:d}",
+                      buf->frame_size, buf_frame_header.frame_size);
+                decrement_ref_count();
+                close_instance();
+                return;
+            }
+            if (metadata_size != buf_frame_header.metadata_size) {
+                ERROR("Metadata size does not match between server and client!");
+                decrement_ref_count();
+                close_instance();
+                return;
+            }
+
+            frameCodec codec = (frameCodec)buf_frame_header.codec;
+            if (!frame_codec_available(codec)) {
+                ERROR("Client {:s} sends frames compressed with {:s}, which kotekan was built "
+                      "without.",
+                      client_ip, frame_codec_name(codec));
+                decrement_ref_count();
+                close_instance();
+                return;
+            }
+            if (codec == frameCodec::none ? buf_frame_header.payload_size != frame_size
+                                          : buf_frame_header.payload_size > frame_size) {
+                ERROR("Invalid size {:d} of the frame data from client {:s} (frame size: {:d})",
+                      buf_frame_header.payload_size, client_ip, frame_size);
+                decrement_ref_count();
+                close_instance();
+                return;
+            }
+            payload_size = buf_frame_header.payload_size;
+            if (codec != frameCodec::none)
+                compressed_space.resize(payload_size);
+        }
+
+        if (bytes_read < header_size)
+            state = connState::header;
+        else if (bytes_read < header_size + metadata_size)
+            state = connState::metadata;
+        else if (bytes_read < header_size + metadata_size + payload_size)
+            state = connState::frame;
+        else {
+            assert(bytes_read == header_size + metadata_size + payload_size);
+            state = connState::finished;
+            bytes_read = 0;
         }
 
         if (state == connState::finished) {
-            // Get empty frame if one exists.
             DEBUG2("Finished state");
+
+            frameCodec codec = (frameCodec)buf_frame_header.codec;
+            if (codec != frameCodec::none) {
+                double start = current_thread_cpu_time();
+                bool ok = decompressor.decompress(codec, buf_frame_header.shuffle_size,
+                                                  compressed_space.data(), payload_size,
+                                                  frame_space, frame_size);
+                decompression_cpu_counter->inc((current_thread_cpu_time() - start) * 1e6);
+                if (!ok) {
+                    ERROR("Failed to decompress a {:s} frame from client {:s}. Closing "
+                          "connection.",
+                          frame_codec_name(codec), client_ip);
+                    decrement_ref_count();
+                    close_instance();
+                    return;
+                }
+            }
+
+            // Get empty frame if one exists.
             int frame_id = buffer_recv->get_next_frame();
             if (frame_id == -1) {
                 DEBUG("No free buffer frames, dropping data from {:s}", client_ip);
@@ -501,6 +563,8 @@ void connInstance::internal_read_callback() {
                 std::string source_label = fmt::format(fmt("{:s}:{:d}"), client_ip, port);
                 buffer_recv->set_transfer_time_seconds(source_label, elapsed);
 
+                frames_counter->inc();
+
                 DEBUG("Received data from client: {:s}:{:d} into frame: {:s}[{:d}]", client_ip,
                       port, buf->buffer_name, frame_id);
             }
@@ -10,6 +10,7 @@
 #define BUFFER_RECV_H
 
 #include "Config.hpp"            // for Config
+#include "FrameCompression.hpp"  // for FrameCompressor
 #include "Stage.hpp"             // for Stage
 #include "bufferContainer.hpp"   // for bufferContainer
 #include "bufferSend.hpp"        // for bufferFrameHeader
@@ -47,6 +48,15 @@ class connInstance;
  * higher bandwidth than one thread alone could support.  In libevent terms there is one base
  * thread, and @c num_threads worker threads which handle the libevent callbacks.
  *
+ * Each transfer (header, metadata and frame) is read with @c readv straight into the
+ * connection's spare frame, which is then swapped into the buffer. A sender striping
+ * its frames over several connections (see @c bufferSend) just shows up as several
+ * clients.
+ *
+ * Compressed frames are decompressed by the worker thread handling the connection,
+ * into the spare frame. The codec comes with each frame (see @c bufferFrameHeader),
+ * a frame with a codec kotekan wasn't built with closes the connection.
+ *
  * @par buffers
  * @buffer buf The buffer which accepts new frames (producer)
  *        @buffer_format any
@@ -64,6 +74,12 @@ class connInstance;
  * @metric kotekan_buffer_recv_dropped_frame_total
  *         The number of times a frame was dropped because the @c buf was full at the time
  *         a block of was aviable to transfer to it.
+ * @metric kotekan_buffer_recv_bytes_total
+ *         The number of bytes received from the host given by the @c source label.
+ * @metric kotekan_buffer_recv_frames_total
+ *         The number of frames received from the host given by the @c source label.
+ * @metric kotekan_buffer_recv_decompression_cpu_microseconds_total
+ *         CPU time spent decompressing the frames from the host given by the @c source label.
  *
  * @todo Possibly factor out the threadpool.
  * @todo Allow for a different log level for workers from the main thread.
@@ -169,6 +185,15 @@ private:
     /// A lock on the `transfer_time_seconds`
     std::mutex transfer_time_seconds_mutex;
 
+    /// Bytes received, by source
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& bytes_counter;
+
+    /// Frames received, by source
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& frames_counter;
+
+    /// CPU time spent decompressing, by source
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& decompression_cpu_counter;
+
     // Worker threads (thread pool section)
 
     /// The number of worker threads to spawn
@@ -296,9 +321,18 @@ public:
     /// The socket assoicated with this instance
     evutil_socket_t fd;
 
-    /// Tracks how many bytes have been read from the socket for the current read
+    /// Tracks how many bytes have been read from the socket for the current transfer
     size_t bytes_read = 0;
 
+    /// Bytes received on this connection
+    kotekan::prometheus::Counter* bytes_counter;
+
+    /// Frames received on this connection
+    kotekan::prometheus::Counter* frames_counter;
+
+    /// CPU time spent decompressing the frames of this connection
+    kotekan::prometheus::Counter* decompression_cpu_counter;
+
     /// The start time of a new frame read
     double start_time;
 
@@ -311,6 +345,12 @@ public:
     /// Pointer to local memory for storing the metadata of the incoming frame.
     uint8_t* metadata_space;
 
+    /// Local memory for a compressed incoming frame
+    std::vector<uint8_t> compressed_space;
+
+    /// Decompresses the incoming frames
+    FrameCompressor decompressor;
+
     /// Lock to make sure only one instance of this jobs call backs is run at any one time.
     std::mutex instance_lock;
 
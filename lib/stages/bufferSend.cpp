@@ -1,35 +1,48 @@
 #include "bufferSend.hpp"
 
 #include "Config.hpp"            // for Config
+#include "FrameCompression.hpp"  // for FrameCompressor, frameCodec, frame_codec_available, fram...
 #include "StageFactory.hpp"      // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
-#include "buffer.h"              // for Buffer, get_num_full_frames, mark_frame_empty, register...
+#include "buffer.h"              // for Buffer, mark_frame_empty, register_consumer, wait_for_...
 #include "bufferContainer.hpp"   // for bufferContainer
-#include "kotekanLogging.hpp"    // for DEBUG2, ERROR, DEBUG, WARN, INFO
+#include "kotekanLogging.hpp"    // for DEBUG2, ERROR, DEBUG, WARN, INFO, FATAL_ERROR
 #include "metadata.h"            // for metadataContainer
-#include "prometheusMetrics.hpp" // for Metrics, Counter
+#include "prometheusMetrics.hpp" // for Metrics, Counter, Gauge
+#include "visUtil.hpp"           // for current_thread_cpu_time
 
 #include "fmt.hpp" // for format, fmt
 
+#include <algorithm>  // for max
 #include <arpa/inet.h> // for inet_addr
 #include <cerrno>      // for errno
 #include <chrono>
 #include <cstring>      // for strerror, size_t
 #include <exception>    // for exception
 #include <functional>   // for _Bind_helper<>::type, bind, ref, function
+#include <poll.h>       // for poll, pollfd
 #include <regex>        // for match_results<>::_Base_type
-#include <stdexcept>    // for runtime_error
+#include <stdexcept>    // for invalid_argument
 #include <strings.h>    // for bzero
-#include <sys/socket.h> // for send, MSG_NOSIGNAL, connect, setsockopt, socket, AF_INET
+#include <sys/socket.h> // for sendmsg, recvmsg, MSG_NOSIGNAL, connect, setsockopt, socket
 #include <sys/time.h>   // for timeval
 #include <thread>       // for thread
-#include <unistd.h>     // for close, sleep
+#include <unistd.h>     // for close
 #include <vector>       // for vector
+#ifndef MAC_OSX
+#include <linux/errqueue.h> // for sock_extended_err, SO_EE_ORIGIN_ZEROCOPY
+#include <netinet/in.h>     // for IPPROTO_IP, IP_RECVERR
+#endif
 
 // Some systems don't support MSG_NOSIGNAL and don't include it in socket.h
 #ifndef MSG_NOSIGNAL
 #define MSG_NOSIGNAL 0
 #endif
 
+// Zero-copy sends need Linux 4.14 and a recent enough libc
+#if !defined(MAC_OSX) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define BUFFER_SEND_ZEROCOPY
+#endif
+
 using kotekan::bufferContainer;
 using kotekan::Config;
 using kotekan::Stage;
@@ -41,27 +54,119 @@ bufferSend::bufferSend(Config& config, const std::string& unique_name,
                        bufferContainer& buffer_container) :
     Stage(config, unique_name, buffer_container, std::bind(&bufferSend::main_thread, this)),
     dropped_frame_counter(
-        Metrics::instance().add_counter("kotekan_buffer_send_dropped_frame_count", unique_name)) {
+        Metrics::instance().add_counter("kotekan_buffer_send_dropped_frame_count", unique_name)),
+    bytes_counter(Metrics::instance().add_counter("kotekan_buffer_send_bytes_total", unique_name,
+                                                  {"destination", "connection"})),
+    frames_counter(Metrics::instance().add_counter("kotekan_buffer_send_frames_total",
+                                                   unique_name, {"destination", "connection"})),
+    destination_dropped_counter(Metrics::instance().add_counter(
+        "kotekan_buffer_send_destination_dropped_frames_total", unique_name, {"destination"})),
+    backlog_gauge(
+        Metrics::instance().add_gauge("kotekan_buffer_send_backlog", unique_name, {"destination"})),
+    uncompressed_bytes_counter(Metrics::instance().add_counter(
+        "kotekan_buffer_send_uncompressed_bytes_total", unique_name)),
+    compressed_bytes_counter(Metrics::instance().add_counter(
+        "kotekan_buffer_send_compressed_bytes_total", unique_name)),
+    compression_ratio(
+        Metrics::instance().add_gauge("kotekan_buffer_send_compression_ratio", unique_name)),
+    compression_cpu_counter(Metrics::instance().add_counter(
+        "kotekan_buffer_send_compression_cpu_microseconds_total", unique_name)) {
 
     buf = get_buffer("buf");
     register_consumer(buf, unique_name.c_str());
 
-    connected = false;
-    server_ip = config.get<std::string>(unique_name, "server_ip");
-    server_port = config.get_default<uint32_t>(unique_name, "server_port", 11024);
-
     send_timeout = config.get_default<uint32_t>(unique_name, "send_timeout", 20);
     reconnect_time = config.get_default<uint32_t>(unique_name, "reconnect_time", 5);
-    drop_frames = config.get_default<bool>(unique_name, "drop_frames", true);
+    num_connections =
+        std::max<uint32_t>(config.get_default<uint32_t>(unique_name, "num_connections", 1), 1);
+    zero_copy = config.get_default<bool>(unique_name, "zero_copy", false);
+#ifndef BUFFER_SEND_ZEROCOPY
+    if (zero_copy) {
+        WARN("MSG_ZEROCOPY is not supported on this platform, sending with copies.");
+        zero_copy = false;
+    }
+#endif
 
-    // Publish current dropped frame count.
+    std::string compression = config.get_default<std::string>(unique_name, "compression", "none");
+    codec = frame_codec_from_string(compression);
+    if (!frame_codec_available(codec))
+        throw std::invalid_argument(fmt::format(
+            fmt("bufferSend: kotekan was built without the {:s} codec."), compression));
+    compression_level = config.get_default<int>(unique_name, "compression_level", 0);
+    bitshuffle_size = config.get_default<uint32_t>(unique_name, "bitshuffle_size", 0);
+    if (bitshuffle_size > 255)
+        throw std::invalid_argument(fmt::format(
+            fmt("bufferSend: bitshuffle_size {:d} is too large (max 255)."), bitshuffle_size));
+    num_compression_threads =
+        std::max<uint32_t>(config.get_default<uint32_t>(unique_name, "compression_threads", 1), 1);
+    if (codec != frameCodec::none)
+        compressed_frames = std::vector<CompressedFrame>(buf->num_frames);
+
+    // Without a list of destinations there is a single one set by the stage config
+    nlohmann::json dest_confs = config.get_default<nlohmann::json>(unique_name, "destinations", {});
+    if (!dest_confs.empty() && !dest_confs.is_object())
+        throw std::invalid_argument(fmt::format(
+            fmt("bufferSend: destinations must be a dictionary: {:s}"), dest_confs.dump()));
+    if (dest_confs.empty()) {
+        std::string server_ip = config.get<std::string>(unique_name, "server_ip");
+        uint32_t server_port = config.get_default<uint32_t>(unique_name, "server_port", 11024);
+        dest_confs[fmt::format("{:s}:{:d}", server_ip, server_port)] = nlohmann::json::object();
+    }
 
-    bzero(&server_addr, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = inet_addr(server_ip.c_str());
-    server_addr.sin_port = htons(server_port);
+    // The destinations and connections hold atomics and mutexes, so they are created in place
+    // rather than resized
+    destinations = std::vector<Destination>(dest_confs.size());
+    connections = std::vector<Connection>(dest_confs.size() * num_connections);
+    size_t d = 0;
+    for (auto& it : dest_confs.items()) {
+        Destination& dest = destinations[d];
+        setup_destination(dest, it.key(), it.value());
+        for (size_t i = 0; i < num_connections; i++) {
+            Connection& conn = connections[d * num_connections + i];
+            conn.index = i;
+            conn.dest = &dest;
+            conn.connected = false;
+            conn.headers.resize(buf->num_frames);
+            conn.bytes = &bytes_counter.labels({dest.name, std::to_string(i)});
+            conn.frames = &frames_counter.labels({dest.name, std::to_string(i)});
+            dest.connections.push_back(&conn);
+        }
+        d++;
+    }
 
-    socket_fd = -1;
+    frame_refs = std::vector<std::atomic<uint32_t>>(buf->num_frames);
+}
+
+void bufferSend::setup_destination(Destination& dest, const std::string& name,
+                                   const nlohmann::json& dest_conf) {
+    dest.name = name;
+    try {
+        dest.server_ip = dest_conf.contains("server_ip")
+                             ? dest_conf.at("server_ip").get<std::string>()
+                             : config.get<std::string>(unique_name, "server_ip");
+        dest.server_port =
+            dest_conf.value("server_port",
+                            config.get_default<uint32_t>(unique_name, "server_port", 11024));
+        dest.drop_frames = dest_conf.value(
+            "drop_frames", config.get_default<bool>(unique_name, "drop_frames", true));
+        dest.max_backlog = dest_conf.value(
+            "max_backlog", config.get_default<uint32_t>(unique_name, "max_backlog",
+                                                        ((uint32_t)buf->num_frames + 1) / 2));
+    } catch (nlohmann::json::exception& e) {
+        throw std::invalid_argument(fmt::format(
+            fmt("bufferSend: invalid config for destination {:s}: {:s}"), name, e.what()));
+    }
+    dest.max_backlog = std::max<uint32_t>(dest.max_backlog, 1);
+    dest.backlog = 0;
+
+    bzero(&dest.server_addr, sizeof(dest.server_addr));
+    dest.server_addr.sin_family = AF_INET;
+    dest.server_addr.sin_addr.s_addr = inet_addr(dest.server_ip.c_str());
+    dest.server_addr.sin_port = htons(dest.server_port);
+
+    dest.dropped = &destination_dropped_counter.labels({name});
+    dest.backlog_gauge = &backlog_gauge.labels({name});
+    dest.backlog_gauge->set(0);
 }
 
 bufferSend::~bufferSend() {}
@@ -70,7 +175,11 @@ void bufferSend::main_thread() {
 
     int frame_id = 0;
 
-    std::thread connect_thread = std::thread(&bufferSend::connect_to_server, std::ref(*this));
+    for (auto& conn : connections)
+        conn.thread = std::thread(&bufferSend::connection_thread, this, std::ref(conn));
+    if (codec != frameCodec::none)
+        for (uint32_t i = 0; i < num_compression_threads; i++)
+            compression_threads.emplace_back(&bufferSend::compression_thread, this);
 
     while (!stop_thread) {
 
@@ -78,178 +187,441 @@ void bufferSend::main_thread() {
         if (frame == nullptr)
             break;
 
-        uint32_t num_full_frames = get_num_full_frames(buf);
-
-        if (drop_frames && num_full_frames > (((uint32_t)buf->num_frames + 1) / 2)) {
-            // If the number of full frames is high, then we drop some frames,
-            // because we likely aren't sending fast enough to up with the data rate.
-            INFO("Number of full frames in buffer {:s} is {:d} (total frames: {:d}), dropping "
-                 "frame_id {:d}",
-                 buf->buffer_name, num_full_frames, buf->num_frames, frame_id);
-            dropped_frame_counter.inc();
-        } else if (drop_frames && !connected) {
-            INFO("Dropping frame {:s}[{:d}], because connection to {:s}:{:d} is down.",
-                 buf->buffer_name, frame_id, server_ip, server_port);
-            dropped_frame_counter.inc();
-        } else if (connected) {
-            // Send header
-            struct bufferFrameHeader header;
-            const size_t header_len = sizeof(struct bufferFrameHeader);
-            int32_t n = 0;
-            int32_t n_sent = 0;
-
-            header.frame_size = buf->frame_size;
-            header.metadata_size = buf->metadata[frame_id]->metadata_size;
-
-            DEBUG2("frame_size: {:d}, metadata_size: {:d}", header.frame_size,
-                   header.metadata_size);
-
-            // Recover from partial sends
-            DEBUG2("Sending header");
-            while ((n = send(socket_fd, &((uint8_t*)&header)[n_sent], header_len - n_sent,
-                             MSG_NOSIGNAL))
-                   > 0) {
-                n_sent += n;
-            }
-            // Handle errors
-            if (n < 0) {
-                ERROR("Error {:s}, failed to send header to {:s}:{:d}", strerror(errno), server_ip,
-                      server_port);
-                close_connection();
-                continue;
-            }
-            DEBUG2("Sent header: {:d}", n_sent);
-
-            // Send metadata
-            DEBUG2("Sending metadata");
-            n_sent = 0;
-            while ((n = send(socket_fd, &((uint8_t*)buf->metadata[frame_id]->metadata)[n_sent],
-                             header.metadata_size - n_sent, MSG_NOSIGNAL))
-                   > 0) {
-                n_sent += n;
-            }
-            if (n < 0) {
-                ERROR("Error {:s}, failed to metadata to {:s}:{:d}", strerror(errno), server_ip,
-                      server_port);
-                close_connection();
-                continue;
-            }
-            DEBUG2("Sent metadata: {:d}", n_sent);
-
-            // Send buffer frame.
-            DEBUG2("Sending frame with {:d} bytes", header.frame_size);
-            n_sent = 0;
-            while ((n = send(socket_fd, &frame[n_sent], (int32_t)header.frame_size - n_sent,
-                             MSG_NOSIGNAL))
-                   > 0) {
-                n_sent += n;
-                // DEBUG("Total sent: {:d}", n_sent);
-            }
-            if (n < 0) {
-                ERROR("Error {:s}, failed to frame data to {:s}:{:d}", strerror(errno), server_ip,
-                      server_port);
-                close_connection();
+        // Hold on to the frame until it is handed to all the destinations
+        frame_refs[frame_id] = 1;
+
+        bool compressing = false;
+        for (auto& dest : destinations)
+            dispatch_frame(dest, frame_id, compressing);
+
+        release_frame(frame_id);
+        frame_id = (frame_id + 1) % buf->num_frames;
+    }
+
+    connection_state_cv.notify_all();
+    compression_cv.notify_all();
+    compressed_cv.notify_all();
+    for (auto& conn : connections) {
+        conn.queue_cv.notify_all();
+        conn.thread.join();
+    }
+    for (auto& thread : compression_threads)
+        thread.join();
+}
+
+void bufferSend::compression_thread() {
+    FrameCompressor compressor;
+
+    while (!stop_thread) {
+        int frame_id;
+        {
+            std::unique_lock<std::mutex> lock(compression_lock);
+            compression_cv.wait_for(lock, std::chrono::milliseconds(100),
+                                    [&]() { return stop_thread || !compression_queue.empty(); });
+            if (compression_queue.empty())
                 continue;
-            }
-            DEBUG2("Sent frame: {:d}", n_sent);
-            DEBUG("Sent frame: {:s}[{:d}] to {:s}:{:d}", buf->buffer_name, frame_id, server_ip,
-                  server_port);
+            frame_id = compression_queue.front();
+            compression_queue.pop_front();
+        }
+
+        CompressedFrame& frame = compressed_frames[frame_id];
+        double start = current_thread_cpu_time();
+        frame.size = compressor.compress(codec, compression_level, bitshuffle_size,
+                                         buf->frames[frame_id], buf->frame_size, frame.data);
+        double cpu_time = current_thread_cpu_time() - start;
+
+        size_t sent_size = frame.size > 0 ? frame.size : buf->frame_size;
+        uncompressed_bytes_counter.inc(buf->frame_size);
+        compressed_bytes_counter.inc(sent_size);
+        compression_ratio.set((double)buf->frame_size / sent_size);
+        compression_cpu_counter.inc(cpu_time * 1e6);
+        DEBUG2("Compressed frame {:s}[{:d}] from {:d} to {:d} bytes in {:.3f} ms",
+               buf->buffer_name, frame_id, buf->frame_size, sent_size, cpu_time * 1e3);
 
+        {
+            std::lock_guard<std::mutex> lock(compression_lock);
+            frame.ready = true;
+        }
+        compressed_cv.notify_all();
+        release_frame(frame_id);
+    }
+}
+
+bool bufferSend::wait_for_compression(int frame_id) {
+    std::unique_lock<std::mutex> lock(compression_lock);
+    while (!compressed_frames[frame_id].ready && !stop_thread)
+        compressed_cv.wait_for(lock, std::chrono::milliseconds(100));
+    return compressed_frames[frame_id].ready;
+}
+
+bool bufferSend::dispatch_frame(Destination& dest, int frame_id, bool& compressing) {
+    Connection* conn = next_connection(dest);
+    bool waiting = false;
+    while (!stop_thread && (conn == nullptr || dest.backlog >= dest.max_backlog)) {
+        if (dest.drop_frames)
+            break;
+        // Block until the destination is back or has caught up
+        if (!waiting)
+            INFO("Waiting for {:s} to {:s}...", dest.name,
+                 conn == nullptr ? "connect" : "catch up");
+        waiting = true;
+        std::unique_lock<std::mutex> connection_lock(connection_state_mutex);
+        connection_state_cv.wait_for(connection_lock, std::chrono::milliseconds(100));
+        connection_lock.unlock();
+        conn = next_connection(dest);
+    }
+
+    if (conn == nullptr || dest.backlog >= dest.max_backlog) {
+        if (conn == nullptr) {
+            INFO("Dropping frame {:s}[{:d}] for {:s}, because the connection is down.",
+                 buf->buffer_name, frame_id, dest.name);
         } else {
-            // Wait for connection and block
-            INFO("Waiting for connection to {:s}:{:d}...", server_ip, server_port);
-            std::unique_lock<std::mutex> connection_lock(connection_state_mutex);
-            connection_state_cv.wait_for(connection_lock, std::chrono::seconds(1),
-                                         [&]() { return (stop_thread || connected); });
-            continue;
+            INFO("Dropping frame {:s}[{:d}] for {:s}, because {:d} frames are queued already.",
+                 buf->buffer_name, frame_id, dest.name, dest.backlog.load());
         }
+        dest.dropped->inc();
+        dropped_frame_counter.inc();
+        return false;
+    }
 
-        mark_frame_empty(buf, unique_name.c_str(), frame_id);
-        frame_id = (frame_id + 1) % buf->num_frames;
+    // Start compressing the frame when it first goes anywhere, the connections wait for it
+    // when the frame comes up. The compression holds on to the frame as well.
+    if (codec != frameCodec::none && !compressing) {
+        frame_refs[frame_id]++;
+        {
+            std::lock_guard<std::mutex> lock(compression_lock);
+            compressed_frames[frame_id].ready = false;
+            compression_queue.push_back(frame_id);
+        }
+        compression_cv.notify_one();
+        compressing = true;
     }
 
-    close_connection();
-    connect_thread.join();
+    // Hand the frame to the connection, which lets go of it once it is sent
+    frame_refs[frame_id]++;
+    dest.backlog_gauge->set(++dest.backlog);
+    {
+        std::lock_guard<std::mutex> lock(conn->queue_lock);
+        conn->queue.push_back(frame_id);
+    }
+    conn->queue_cv.notify_one();
+    return true;
 }
 
-void bufferSend::close_connection() {
-    if (socket_fd >= 0)
-        close(socket_fd);
+void bufferSend::frame_done(Connection& conn, int frame_id) {
+    conn.dest->backlog_gauge->set(--conn.dest->backlog);
+    release_frame(frame_id);
 
-    socket_fd = -1;
+    // Wake up the main thread if it waits for the destination to catch up
     {
-        std::unique_lock<std::mutex> connection_lock(connection_state_mutex);
-        connected = false;
+        std::lock_guard<std::mutex> connection_lock(connection_state_mutex);
     }
     connection_state_cv.notify_all();
 }
 
-void bufferSend::connect_to_server() {
+void bufferSend::release_frame(int frame_id) {
+    if (--frame_refs[frame_id] == 0)
+        mark_frame_empty(buf, unique_name.c_str(), frame_id);
+}
+
+bufferSend::Connection* bufferSend::next_connection(Destination& dest) {
+    for (size_t i = 1; i <= dest.connections.size(); i++) {
+        size_t index = (dest.last_connection + i) % dest.connections.size();
+        if (dest.connections[index]->connected) {
+            dest.last_connection = index;
+            return dest.connections[index];
+        }
+    }
+    return nullptr;
+}
+
+void bufferSend::connection_thread(Connection& conn) {
 
     while (!stop_thread) {
 
-        DEBUG("Trying to connecting to server: {:s}:{:d}", server_ip, server_port);
+        if (!conn.connected) {
+            if (!connect_to_server(conn)) {
+                std::unique_lock<std::mutex> connection_lock(connection_state_mutex);
+                connection_state_cv.wait_for(connection_lock, std::chrono::seconds(reconnect_time),
+                                             [&]() { return stop_thread.load(); });
+            }
+            continue;
+        }
 
-        socket_fd = socket(AF_INET, SOCK_STREAM, 0);
-        if (socket_fd == -1) {
-            std::string msg = fmt::format(fmt("Could not create socket, errno: {:d} ({:s})"), errno,
-                                          std::strerror(errno));
-            ERROR("{:s}", msg);
-            throw std::runtime_error(msg);
+        int frame_id;
+        {
+            std::unique_lock<std::mutex> lock(conn.queue_lock);
+            if (conn.queue.empty() && !conn.in_flight.empty()) {
+                // Nothing to send, wait for the kernel to finish with the frames in flight
+                lock.unlock();
+                reap_completions(conn, 100);
+                continue;
+            }
+            conn.queue_cv.wait_for(lock, std::chrono::milliseconds(100),
+                                   [&]() { return stop_thread || !conn.queue.empty(); });
+            if (conn.queue.empty())
+                continue;
+            frame_id = conn.queue.front();
         }
 
-        if (connect(socket_fd, (struct sockaddr*)&server_addr, sizeof(server_addr)) == -1) {
-            WARN("Could not connect to server {:s}:{:d}, error: {:s}({:d}), waiting {:d} seconds "
-                 "to retry...",
-                 server_ip, server_port, strerror(errno), errno, reconnect_time);
-            close(socket_fd);
-            // TODO Add a Stage level "breakable sleep" so this doesn't
-            // lock up the shutdown process for upto reconnect_time seconds.
-            sleep(reconnect_time);
+        if (codec != frameCodec::none && !wait_for_compression(frame_id))
             continue;
+
+        bool sent = send_frame(conn, frame_id);
+
+        // Without dropping frames, a frame that failed is sent again once the connection is back
+        std::deque<int> dropped;
+        {
+            std::lock_guard<std::mutex> lock(conn.queue_lock);
+            if (sent || conn.dest->drop_frames)
+                conn.queue.pop_front();
+            if (!sent && conn.dest->drop_frames)
+                dropped.swap(conn.queue);
         }
 
-        // Prevent SIGPIPE on send failure.
-        // This is used for MacOS, since linux doesn't have SO_NOSIGPIPE
-#ifdef SO_NOSIGPIPE
-        int set = 1;
-        if (setsockopt(socket_fd, SOL_SOCKET, SO_NOSIGPIPE, (void*)&set, sizeof(int)) < 0) {
-            ERROR("bufferSend: setsockopt() NOSIGPIPE ");
+        if (sent) {
+            conn.frames->inc();
+            if (conn.zero_copy) {
+                conn.in_flight.push_back({frame_id, conn.zc_sent});
+                reap_completions(conn, 0);
+            } else {
+                frame_done(conn, frame_id);
+            }
+            DEBUG("Sent frame: {:s}[{:d}] to {:s} on connection {:d}", buf->buffer_name,
+                  frame_id, conn.dest->name, conn.index);
+        } else {
+            close_connection(conn);
+            if (conn.dest->drop_frames)
+                dropped.push_front(frame_id);
+            for (int id : dropped) {
+                frame_done(conn, id);
+                conn.dest->dropped->inc();
+                dropped_frame_counter.inc();
+            }
         }
+    }
+
+    // Give the kernel a chance to finish sending the frames still in flight
+    for (uint32_t i = 0; i < send_timeout * 10 && !conn.in_flight.empty(); i++)
+        reap_completions(conn, 100);
+    close_connection(conn);
+}
+
+bool bufferSend::send_frame(Connection& conn, int frame_id) {
+    struct bufferFrameHeader& header = conn.headers[frame_id];
+    header.frame_size = buf->frame_size;
+    header.metadata_size = buf->metadata[frame_id]->metadata_size;
+    header.payload_size = buf->frame_size;
+    header.codec = (uint8_t)frameCodec::none;
+    header.shuffle_size = 0;
+    header.version = bufferFrameHeader::current_version;
+    header.reserved = 0;
+
+    uint8_t* payload = buf->frames[frame_id];
+    if (codec != frameCodec::none && compressed_frames[frame_id].size > 0) {
+        header.payload_size = compressed_frames[frame_id].size;
+        header.codec = (uint8_t)codec;
+        header.shuffle_size = bitshuffle_size;
+        payload = compressed_frames[frame_id].data.data();
+    }
+
+    DEBUG2("frame_size: {:d}, metadata_size: {:d}, payload_size: {:d}", header.frame_size,
+           header.metadata_size, header.payload_size);
+
+    struct iovec iov[3];
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(struct bufferFrameHeader);
+    iov[1].iov_base = buf->metadata[frame_id]->metadata;
+    iov[1].iov_len = header.metadata_size;
+    iov[2].iov_base = payload;
+    iov[2].iov_len = header.payload_size;
+
+    if (!send_all(conn, iov, 3)) {
+        ERROR("Error {:s}, failed to send frame {:s}[{:d}] to {:s} ({:s}:{:d})", strerror(errno),
+              buf->buffer_name, frame_id, conn.dest->name, conn.dest->server_ip,
+              conn.dest->server_port);
+        return false;
+    }
+    return true;
+}
+
+bool bufferSend::send_all(Connection& conn, struct iovec* iov, int iovcnt) {
+    struct msghdr msg;
+    bzero(&msg, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+
+    bool copy_once = false;
+    while (msg.msg_iovlen > 0) {
+        bool zc = conn.zero_copy && !copy_once;
+        int flags = MSG_NOSIGNAL;
+#ifdef BUFFER_SEND_ZEROCOPY
+        if (zc)
+            flags |= MSG_ZEROCOPY;
 #endif
+        ssize_t n = sendmsg(conn.socket_fd, &msg, flags);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            // Out of memory to pin the pages, send this part with a copy instead
+            if (errno == ENOBUFS && zc) {
+                copy_once = true;
+                continue;
+            }
+            return false;
+        }
+        if (zc)
+            conn.zc_sent++;
+        copy_once = false;
+        conn.bytes->inc(n);
+
+        // Recover from partial sends
+        while (msg.msg_iovlen > 0 && (size_t)n >= msg.msg_iov->iov_len) {
+            n -= msg.msg_iov->iov_len;
+            msg.msg_iov++;
+            msg.msg_iovlen--;
+        }
+        if (n > 0) {
+            msg.msg_iov->iov_base = (uint8_t*)msg.msg_iov->iov_base + n;
+            msg.msg_iov->iov_len -= n;
+        }
+    }
+    return true;
+}
+
+void bufferSend::reap_completions(Connection& conn, int timeout_ms) {
+#ifdef BUFFER_SEND_ZEROCOPY
+    if (conn.in_flight.empty() || conn.socket_fd < 0)
+        return;
+
+    // Completions are reported on the error queue, which always counts as ready for poll
+    if (timeout_ms > 0) {
+        struct pollfd pfd = {conn.socket_fd, 0, 0};
+        poll(&pfd, 1, timeout_ms);
+    }
 
-        // Set send timeout.
-        struct timeval tv_timeout;
-        tv_timeout.tv_sec = send_timeout;
-        tv_timeout.tv_usec = 0;
+    while (true) {
+        char control[128];
+        struct msghdr msg;
+        bzero(&msg, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(conn.socket_fd, &msg, MSG_ERRQUEUE) < 0)
+            break;
 
-        if (setsockopt(socket_fd, SOL_SOCKET, SO_SNDTIMEO, (void*)&tv_timeout, sizeof(tv_timeout))
-            < 0) {
-            ERROR("bufferSend: setsockopt() timeout failed.");
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != IPPROTO_IP || cmsg->cmsg_type != IP_RECVERR)
+                continue;
+            struct sock_extended_err* err = (struct sock_extended_err*)CMSG_DATA(cmsg);
+            if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+                continue;
+            // The range of sends [ee_info, ee_data] is done
+            conn.zc_done = std::max(conn.zc_done, err->ee_data + 1);
         }
+    }
 
-        INFO("Connected to server {:s}:{:d} for sending buffer {:s}", server_ip, server_port,
-             buf->buffer_name);
-        {
-            std::unique_lock<std::mutex> connection_lock(connection_state_mutex);
-            connected = true;
+    while (!conn.in_flight.empty() && conn.in_flight.front().second <= conn.zc_done) {
+        frame_done(conn, conn.in_flight.front().first);
+        conn.in_flight.pop_front();
+    }
+#else
+    (void)conn;
+    (void)timeout_ms;
+#endif
+}
+
+void bufferSend::close_connection(Connection& conn) {
+    if (conn.socket_fd >= 0)
+        close(conn.socket_fd);
+    conn.socket_fd = -1;
+
+    // The connection is gone, so are any frames it was still sending
+    for (auto& frame : conn.in_flight)
+        frame_done(conn, frame.first);
+    conn.in_flight.clear();
+
+    {
+        std::unique_lock<std::mutex> connection_lock(connection_state_mutex);
+        conn.connected = false;
+    }
+    connection_state_cv.notify_all();
+}
+
+bool bufferSend::connect_to_server(Connection& conn) {
+
+    Destination& dest = *conn.dest;
+    DEBUG("Trying to connecting to server: {:s}:{:d}", dest.server_ip, dest.server_port);
+
+    int socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (socket_fd == -1) {
+        // This runs on the connection threads, so stop kotekan rather than throwing
+        FATAL_ERROR("Could not create socket, errno: {:d} ({:s})", errno, std::strerror(errno));
+        return false;
+    }
+
+    if (connect(socket_fd, (struct sockaddr*)&dest.server_addr, sizeof(dest.server_addr)) == -1) {
+        WARN("Could not connect to server {:s}:{:d}, error: {:s}({:d}), waiting {:d} seconds "
+             "to retry...",
+             dest.server_ip, dest.server_port, strerror(errno), errno, reconnect_time);
+        close(socket_fd);
+        return false;
+    }
+
+    // Prevent SIGPIPE on send failure.
+    // This is used for MacOS, since linux doesn't have SO_NOSIGPIPE
+#ifdef SO_NOSIGPIPE
+    int set = 1;
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_NOSIGPIPE, (void*)&set, sizeof(int)) < 0) {
+        ERROR("bufferSend: setsockopt() NOSIGPIPE ");
+    }
+#endif
+
+    // Set send timeout.
+    struct timeval tv_timeout;
+    tv_timeout.tv_sec = send_timeout;
+    tv_timeout.tv_usec = 0;
+
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_SNDTIMEO, (void*)&tv_timeout, sizeof(tv_timeout))
+        < 0) {
+        ERROR("bufferSend: setsockopt() timeout failed.");
+    }
+
+    conn.zero_copy = zero_copy;
+    conn.zc_sent = 0;
+    conn.zc_done = 0;
+#ifdef BUFFER_SEND_ZEROCOPY
+    if (conn.zero_copy) {
+        int one = 1;
+        if (setsockopt(socket_fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) < 0) {
+            WARN("Could not enable SO_ZEROCOPY ({:s}), sending with copies.", strerror(errno));
+            conn.zero_copy = false;
         }
+    }
+#endif
 
-        // Notify that connection is established
-        connection_state_cv.notify_one();
+    conn.socket_fd = socket_fd;
 
-        // wait for connection to get closed
+    INFO("Connected to server {:s}:{:d} for sending buffer {:s} (connection {:d})",
+         dest.server_ip, dest.server_port, buf->buffer_name, conn.index);
+    {
         std::unique_lock<std::mutex> connection_lock(connection_state_mutex);
-        connection_state_cv.wait(connection_lock, [&]() { return !connected || stop_thread; });
+        conn.connected = true;
     }
+
+    // Notify that connection is established
+    connection_state_cv.notify_all();
+    return true;
 }
 
 std::string bufferSend::dot_string(const std::string& prefix) const {
     std::string dot = Stage::dot_string(prefix);
-    std::string target = fmt::format("{:s}:{:d}", server_ip, server_port);
-    dot += fmt::format("{:s}\"{:s}\" [shape=doubleoctagon style=filled,color=lightblue]", prefix,
-                       target);
-    dot += fmt::format("{:s}\"{:s}\" -> \"{:s}\"", prefix, get_unique_name(), target);
+    for (auto& dest : destinations) {
+        std::string target = fmt::format("{:s}:{:d}", dest.server_ip, dest.server_port);
+        dot += fmt::format("{:s}\"{:s}\" [shape=doubleoctagon style=filled,color=lightblue]",
+                           prefix, target);
+        dot += fmt::format("{:s}\"{:s}\" -> \"{:s}\"", prefix, get_unique_name(), target);
+    }
 
     return dot;
 }
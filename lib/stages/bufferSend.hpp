@@ -7,25 +7,52 @@
 #define BUFFER_SEND_H
 
 #include "Config.hpp"            // for Config
+#include "FrameCompression.hpp"  // for frameCodec
 #include "Stage.hpp"             // for Stage
 #include "bufferContainer.hpp"   // for bufferContainer
-#include "prometheusMetrics.hpp" // for Counter
+#include "prometheusMetrics.hpp" // for Counter, Gauge, MetricFamily
+
+#include "json.hpp" // for json
 
 #include <atomic>             // for atomic
 #include <condition_variable> // for condition_variable
+#include <deque>              // for deque
 #include <mutex>              // for mutex
 #include <netinet/in.h>       // for sockaddr_in
-#include <stdint.h>           // for uint32_t
+#include <stddef.h>           // for size_t
+#include <stdint.h>           // for uint32_t, uint8_t
 #include <string>             // for string
+#include <sys/uio.h>          // for iovec
+#include <thread>             // for thread
+#include <utility>            // for pair
+#include <vector>             // for vector
 
 /**
  * @struct bufferFrameHeader
  * @brief Internal struct for sending the transfer details.
+ *
+ * The metadata and @c payload_size bytes of frame data follow the header. If
+ * the frame is compressed they decompress to the @c frame_size bytes of the
+ * frame, otherwise @c payload_size equals @c frame_size.
+ *
+ * The receiver drops a connection whose header has a different @c version, so the
+ * version must be bumped whenever the layout or meaning of the header changes.
  */
 #pragma pack()
 struct bufferFrameHeader {
     uint32_t metadata_size;
     uint32_t frame_size;
+    /// Size of the frame data as sent
+    uint32_t payload_size;
+    /// The @c frameCodec the frame data is compressed with
+    uint8_t codec;
+    /// Element size the frame was bitshuffled with before compressing it, 0 for none
+    uint8_t shuffle_size;
+    /// The version of the header, @c bufferFrameHeader::current_version
+    uint8_t version;
+    uint8_t reserved;
+
+    static constexpr uint8_t current_version = 1;
 };
 
 /**
@@ -38,7 +65,34 @@ struct bufferFrameHeader {
  * drop incoming frames, and try to reconnect to the server after @c reconnect_time
  * seconds.
  *
+ * The same frames can be sent to several servers (e.g. archive, monitoring and
+ * calibration) by listing them in @c destinations instead of giving
+ * @c server_ip. All destinations send straight from the frame in the input
+ * buffer, which is released once every destination is done with it. Each
+ * destination has its own connections and a bounded backlog of frames queued
+ * on them. Once the backlog of a destination is full, it either drops frames
+ * (@c drop_frames), so it doesn't hold up the others, or the stage waits for it.
  *
+ * Frames can be striped over @c num_connections parallel connections, each
+ * with its own sending thread, so several frames are in flight at once. Each
+ * frame goes whole over one connection (header, metadata and frame in one
+ * @c sendmsg), so @c bufferRecv needs no changes for this, but the frames may
+ * arrive out of order.
+ *
+ * With @c zero_copy the frames are sent with @c MSG_ZEROCOPY, so the kernel
+ * reads them straight from the buffer instead of copying them into the socket.
+ * A frame is then only released once the kernel reports that it is done with
+ * it. This pays off for large frames on real network interfaces; on the
+ * loopback interface the kernel copies the data anyway.
+ *
+ * With @c compression each frame is compressed (optionally after a bitshuffle,
+ * which helps a lot with truncated floating point data) by a pool of
+ * @c compression_threads threads before it is sent. The frames are handed to
+ * the pool as they come in and a connection only waits for the compression of
+ * the frame it is about to send, so the compression of several frames overlaps
+ * with sending. Frames that don't get smaller are sent as they are. The codec
+ * is recorded in the header of each frame, so @c bufferRecv needs no
+ * configuration, only to be built with the codec.
  *
  * @par buffers
  * @buffer buf The buffer to send to the remote server.
@@ -46,16 +100,50 @@ struct bufferFrameHeader {
  *        @buffer_metadata any
  *
  * @conf server_ip       String, the IP address of the server to send data too.
+ *                         Not needed if @c destinations is given.
  * @conf server_port     Int, default 11024. The port number on the remote server.
+ * @conf destinations    Dictionary, optional. The servers to send the frames to, by
+ *                         name. Each entry needs a @c server_ip, and can set its own
+ *                         @c server_port, @c drop_frames and @c max_backlog, which
+ *                         otherwise default to the values for the stage.
+ * @conf max_backlog     Int, default half the frames in @c buf. The number of frames that
+ *                         can be queued on the connections of a destination.
  * @conf send_timeout    Int, default 20. The number of seconds
  *                         before @c send() times out and closes the connection.
  * @conf reconnect_time  Int, default 5.  The number of seconds between
  *                         connection attempts to the remote server.
- * @conf drop_frames     Bool, default true.  Whether to drop frames when buffer fills.
+ * @conf drop_frames     Bool, default true.  Whether to drop frames when the backlog fills.
+ * @conf num_connections Int, default 1. The number of connections to stripe frames over.
+ * @conf zero_copy       Bool, default false. Send with @c MSG_ZEROCOPY (Linux only).
+ * @conf compression     String, default "none". Compress the frames with "lz4" or "zstd".
+ *                         kotekan must be built with the library (@c WITH_LZ4, @c WITH_ZSTD).
+ * @conf compression_level Int, default 0. Compression level for zstd, acceleration for lz4.
+ *                         0 picks a fast setting.
+ * @conf bitshuffle_size Int, default 0. Bitshuffle the frames before compressing them,
+ *                         treating them as arrays of elements of this many bytes, e.g. 4
+ *                         for float visibilities. 0 for no bitshuffle.
+ * @conf compression_threads Int, default 1. The number of threads compressing frames.
  *
  * @par Metrics
  * @metric kotekan_buffer_send_dropped_frame_count
- *         The number of frames dropped because @c send() is running too slow.
+ *         The number of frames dropped because @c send() is running too slow, summed
+ *         over the destinations.
+ * @metric kotekan_buffer_send_destination_dropped_frames_total
+ *         The number of frames dropped for a @c destination, for any reason.
+ * @metric kotekan_buffer_send_backlog
+ *         The number of frames queued for a @c destination.
+ * @metric kotekan_buffer_send_bytes_total
+ *         The number of bytes sent, by @c destination and @c connection.
+ * @metric kotekan_buffer_send_frames_total
+ *         The number of frames sent, by @c destination and @c connection.
+ * @metric kotekan_buffer_send_uncompressed_bytes_total
+ *         The number of frame bytes passed through the compression.
+ * @metric kotekan_buffer_send_compressed_bytes_total
+ *         The number of frame bytes left after compression.
+ * @metric kotekan_buffer_send_compression_ratio
+ *         Size of the last frame compressed divided by its compressed size.
+ * @metric kotekan_buffer_send_compression_cpu_microseconds_total
+ *         CPU time spent compressing frames.
  *
  * @todo Add the rest of the comments here.
  * @todo we might also add counters for dropped frames because the connection
@@ -82,20 +170,29 @@ private:
     /// The input buffer to send frames from.
     struct Buffer* buf;
 
-    /// The server port to connect to.
-    uint32_t server_port;
-
-    /// The server IP address to connect to.
-    std::string server_ip;
-
     /// The number of seconds before send() times outs and returns and error.
     uint32_t send_timeout;
 
     /// The number of seconds between connection attempts
     uint32_t reconnect_time;
 
-    /// Whether to drop frames or block if buffer is full
-    bool drop_frames;
+    /// The number of connections to stripe the frames over.
+    uint32_t num_connections;
+
+    /// Whether to send with MSG_ZEROCOPY
+    bool zero_copy;
+
+    /// The codec to compress frames with
+    frameCodec codec;
+
+    /// Compression level (zstd) or acceleration (lz4)
+    int compression_level;
+
+    /// Element size to bitshuffle the frames with before compressing, 0 for none
+    uint32_t bitshuffle_size;
+
+    /// The number of threads compressing frames
+    uint32_t num_compression_threads;
 
     /**
      * @brief Number of frame dropped because the send is too slow.
@@ -104,26 +201,192 @@ private:
      */
     kotekan::prometheus::Counter& dropped_frame_counter;
 
-    /// Set to true if there is an active connection
-    std::atomic<bool> connected;
+    /// Bytes sent, by connection
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& bytes_counter;
+
+    /// Frames sent, by connection
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& frames_counter;
+
+    /// Frames dropped, by destination
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& destination_dropped_counter;
+
+    /// Frames queued, by destination
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Gauge>& backlog_gauge;
+
+    kotekan::prometheus::Counter& uncompressed_bytes_counter;
+    kotekan::prometheus::Counter& compressed_bytes_counter;
+    kotekan::prometheus::Gauge& compression_ratio;
+    kotekan::prometheus::Counter& compression_cpu_counter;
+
+    struct Connection;
+
+    /// A server the frames are sent to, over one or more connections
+    struct Destination {
+        /// Name of the destination, for the logs and metrics
+        std::string name;
+
+        /// The server IP address to connect to.
+        std::string server_ip;
+
+        /// The server port to connect to.
+        uint32_t server_port;
+
+        /// Internal server address struct
+        struct sockaddr_in server_addr;
+
+        /// Whether to drop frames or block if the backlog is full
+        bool drop_frames;
+
+        /// The maximum number of frames queued on the connections
+        uint32_t max_backlog;
+
+        /// The number of frames queued on the connections, or still being sent
+        std::atomic<uint32_t> backlog;
+
+        /// The connections to the server
+        std::vector<Connection*> connections;
+
+        /// Index of the connection the last frame was queued on
+        size_t last_connection = 0;
+
+        kotekan::prometheus::Counter* dropped;
+        kotekan::prometheus::Gauge* backlog_gauge;
+    };
+
+    /// The destinations the frames are sent to
+    std::vector<Destination> destinations;
+
+    /// One of the connections to a server, with the frames queued on it
+    struct Connection {
+        /// Index of the connection within its destination, for the logs and metrics
+        size_t index;
+
+        /// The destination the connection goes to
+        Destination* dest;
+
+        /// The connection file handle
+        int socket_fd = -1;
 
-    /// Internal server address struct
-    struct sockaddr_in server_addr;
+        /// Set to true if the connection is up
+        std::atomic<bool> connected;
 
-    /// The connection file handle
-    int socket_fd;
+        /// Whether MSG_ZEROCOPY is used on this connection
+        bool zero_copy;
 
-    /// Prevent the sending thread and connection thread from contension
+        /// Frames waiting to be sent
+        std::deque<int> queue;
+
+        /// Guards the queue
+        std::mutex queue_lock;
+
+        /// Wakes up the sending thread when a frame is queued
+        std::condition_variable queue_cv;
+
+        /// Frames sent with MSG_ZEROCOPY which the kernel may still read from,
+        /// with the number of zero-copy sends on the socket up to and including them
+        std::deque<std::pair<int, uint32_t>> in_flight;
+
+        /// Number of zero-copy sends on the socket so far
+        uint32_t zc_sent;
+
+        /// Number of zero-copy sends the kernel is done with
+        uint32_t zc_done;
+
+        /// The header of each frame sent, kept until the frame is released as the kernel reads
+        /// it with MSG_ZEROCOPY too
+        std::vector<struct bufferFrameHeader> headers;
+
+        /// The sending thread
+        std::thread thread;
+
+        kotekan::prometheus::Counter* bytes;
+        kotekan::prometheus::Counter* frames;
+    };
+
+    /// The connections of all the destinations
+    std::vector<Connection> connections;
+
+    /// The number of destinations still sending each frame, plus one while it is being
+    /// dispatched, by frame id
+    std::vector<std::atomic<uint32_t>> frame_refs;
+
+    /// Lets the main thread wait for a connection to come up
     std::mutex connection_state_mutex;
 
-    /// Used to wakeup the connect thread after a change to the connection state
+    /// Used to wakeup the main thread after a change to the connection state
     std::condition_variable connection_state_cv;
 
-    /// Closes the open connection and starts the process of trying to reconnect
-    void close_connection();
+    /// Read the settings of a destination, with the ones of the stage as defaults
+    void setup_destination(Destination& dest, const std::string& name,
+                           const nlohmann::json& dest_conf);
+
+    /// Returns the next connection of @p dest that is up, in turn, or @c nullptr if all are down
+    Connection* next_connection(Destination& dest);
+
+    /// Queue a frame for a destination, waiting for it if it doesn't drop frames, and start
+    /// compressing it unless @p compressing. Returns false if the frame is dropped for the
+    /// destination.
+    bool dispatch_frame(Destination& dest, int frame_id, bool& compressing);
+
+    /// A destination is done with a frame (sent or dropped)
+    void frame_done(Connection& conn, int frame_id);
+
+    /// Release one reference to a frame, and the frame if it was the last
+    void release_frame(int frame_id);
+
+    /// Connects, sends the frames queued on a connection, and reconnects if it breaks
+    void connection_thread(Connection& conn);
+
+    /// Try to connect to the remote server, returns true on success
+    bool connect_to_server(Connection& conn);
+
+    /// Send a frame with its header and metadata, returns true on success
+    bool send_frame(Connection& conn, int frame_id);
+
+    /// Send all of @p iov, returns true on success
+    bool send_all(Connection& conn, struct iovec* iov, int iovcnt);
+
+    /// Release the zero-copy frames the kernel is done with, waiting up to @p timeout_ms for it
+    void reap_completions(Connection& conn, int timeout_ms);
+
+    /// Closes the connection and releases the frames still in flight
+    void close_connection(Connection& conn);
+
+    /// A compressed frame
+    struct CompressedFrame {
+        /// The compressed data, holds at least @c size bytes
+        std::vector<uint8_t> data;
+
+        /// Size of the compressed frame, 0 if it is sent uncompressed
+        size_t size = 0;
+
+        /// Set once the frame is compressed
+        bool ready = false;
+    };
+
+    /// The compressed frames, by frame id
+    std::vector<CompressedFrame> compressed_frames;
+
+    /// Frames waiting to be compressed
+    std::deque<int> compression_queue;
+
+    /// Guards the compression queue and the @c ready flags of the compressed frames
+    std::mutex compression_lock;
+
+    /// Wakes up the compression threads when a frame is queued
+    std::condition_variable compression_cv;
+
+    /// Wakes up the connections when a frame is compressed
+    std::condition_variable compressed_cv;
+
+    /// The compression threads
+    std::vector<std::thread> compression_threads;
+
+    /// Compresses the frames in the compression queue
+    void compression_thread();
 
-    /// Thread for connecting to the remote server
-    void connect_to_server();
+    /// Wait until a frame is compressed, returns false if the stage is stopping
+    bool wait_for_compression(int frame_id);
 };
 
 #endif
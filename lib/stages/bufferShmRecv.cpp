@@ -0,0 +1,159 @@
+#include "bufferShmRecv.hpp"
+
+#include "BufferShmRing.hpp"     // for BufferShmRing
+#include "Config.hpp"            // for Config
+#include "StageFactory.hpp"      // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
+#include "buffer.h"              // for Buffer, allocate_new_metadata_object, mark_frame_full, ...
+#include "bufferContainer.hpp"   // for bufferContainer
+#include "kotekanLogging.hpp"    // for DEBUG, INFO, FATAL_ERROR
+#include "metadata.h"            // for metadataContainer, metadataPool
+#include "prometheusMetrics.hpp" // for Metrics, Counter
+
+#include "fmt.hpp" // for format, fmt
+
+#include <chrono>     // for milliseconds
+#include <exception>  // for exception
+#include <functional> // for _Bind_helper<>::type, bind, function
+#include <memory>     // for unique_ptr, make_unique
+#include <regex>      // for match_results<>::_Base_type
+#include <stdexcept>  // for runtime_error
+#include <string.h>   // for memcpy
+#include <thread>     // for sleep_for
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+using kotekan::Stage;
+using kotekan::prometheus::Metrics;
+
+REGISTER_KOTEKAN_STAGE(bufferShmRecv);
+
+// How long to wait for a frame before checking whether to stop, in ms
+static const int poll_interval = 100;
+
+bufferShmRecv::bufferShmRecv(Config& config, const std::string& unique_name,
+                             bufferContainer& buffer_container) :
+    Stage(config, unique_name, buffer_container, std::bind(&bufferShmRecv::main_thread, this)),
+    frames_counter(
+        Metrics::instance().add_counter("kotekan_buffer_shm_recv_frames_total", unique_name)) {
+
+    buf = get_buffer("buf");
+    register_producer(buf, unique_name.c_str());
+
+    shm_name = config.get<std::string>(unique_name, "shm_name");
+    reconnect_time = config.get_default<uint32_t>(unique_name, "reconnect_time", 1);
+
+    metadata_size = buf->metadata_pool ? buf->metadata_pool->metadata_object_size : 0;
+
+    internal_frames.assign(buf->frames, buf->frames + buf->num_frames);
+}
+
+bufferShmRecv::~bufferShmRecv() {
+    // The consumers are gone, so the buffer can get its own frames back before
+    // the ring they point into is unmapped
+    for (int id : held_frames)
+        swap_external_frame(buf, id, internal_frames[id]);
+}
+
+bool bufferShmRecv::release_frame() {
+    int id = held_frames.front();
+    if (wait_for_empty_frame(buf, unique_name.c_str(), id) == nullptr)
+        return false;
+
+    swap_external_frame(buf, id, internal_frames[id]);
+    held_frames.pop_front();
+    ring->release();
+    return true;
+}
+
+void bufferShmRecv::main_thread() {
+
+    int frame_id = 0;
+
+    while (!stop_thread) {
+
+        // Detach only once the consumers are done with the frames in the ring
+        while (!held_frames.empty())
+            if (!release_frame())
+                return;
+        ring.reset();
+
+        try {
+            ring = std::make_unique<BufferShmRing>(shm_name);
+        } catch (std::exception& e) {
+            DEBUG("Could not attach to shared memory ring: {:s}, retrying in {:d} seconds",
+                  e.what(), reconnect_time);
+            for (uint32_t i = 0; i < reconnect_time * 1000 / poll_interval && !stop_thread; i++)
+                std::this_thread::sleep_for(std::chrono::milliseconds(poll_interval));
+            continue;
+        }
+
+        if (ring->frame_size() != (size_t)buf->frame_size
+            || ring->metadata_size() != metadata_size) {
+            FATAL_ERROR("Shared memory ring {:s} has frames of {:d} bytes with {:d} bytes of "
+                        "metadata, but buffer {:s} has frames of {:d} bytes with {:d} bytes of "
+                        "metadata.",
+                        shm_name, ring->frame_size(), ring->metadata_size(), buf->buffer_name,
+                        buf->frame_size, metadata_size);
+            return;
+        }
+        INFO("Attached to shared memory ring {:s} ({:d} slots)", shm_name, ring->num_slots());
+
+        uint32_t idle = 0;
+        while (!stop_thread) {
+            // The sender can't refill the slots held by the buffer frames, so free one
+            // up once all of them are held
+            if (held_frames.size() == ring->num_slots() && !release_frame())
+                return;
+
+            int64_t seq = ring->wait_for_data(poll_interval, held_frames.size());
+            if (seq < 0) {
+                // Look for a sender that has shut down or been replaced every so often
+                if (ring->writer_closed() && ring->num_full() == held_frames.size()) {
+                    INFO("Sender closed shared memory ring {:s}", shm_name);
+                    break;
+                }
+                if (++idle * poll_interval >= reconnect_time * 1000) {
+                    idle = 0;
+                    if (ring->replaced()) {
+                        INFO("Shared memory ring {:s} was replaced, reattaching", shm_name);
+                        break;
+                    }
+                }
+                continue;
+            }
+            idle = 0;
+
+            // Once the consumers are done with this frame on the last lap, the ring
+            // slot it was pointing at can go back to the sender
+            if (!held_frames.empty() && held_frames.front() == frame_id) {
+                if (!release_frame())
+                    return;
+            } else if (wait_for_empty_frame(buf, unique_name.c_str(), frame_id) == nullptr) {
+                return;
+            }
+
+            if (metadata_size > 0) {
+                allocate_new_metadata_object(buf, frame_id);
+                memcpy(buf->metadata[frame_id]->metadata, ring->metadata(seq), metadata_size);
+            }
+            // Point the frame at the data in the ring instead of copying it
+            swap_external_frame(buf, frame_id, ring->frame(seq));
+            held_frames.push_back(frame_id);
+
+            mark_frame_full(buf, unique_name.c_str(), frame_id);
+            frames_counter.inc();
+            DEBUG("Received frame {:d} from the ring into {:s}[{:d}]", seq, buf->buffer_name,
+                  frame_id);
+            frame_id = (frame_id + 1) % buf->num_frames;
+        }
+    }
+}
+
+std::string bufferShmRecv::dot_string(const std::string& prefix) const {
+    std::string dot = Stage::dot_string(prefix);
+    dot += fmt::format("{:s}\"{:s}\" [shape=doubleoctagon style=filled,color=lightblue]", prefix,
+                       shm_name);
+    dot += fmt::format("{:s}\"{:s}\" -> \"{:s}\"", prefix, shm_name, get_unique_name());
+
+    return dot;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @brief Object for receiving buffer frames from another kotekan instance on the same host
+ * - bufferShmRecv : public kotekan::Stage
+ */
+#ifndef BUFFER_SHM_RECV_H
+#define BUFFER_SHM_RECV_H
+
+#include "BufferShmRing.hpp"     // for BufferShmRing
+#include "Config.hpp"            // for Config
+#include "Stage.hpp"             // for Stage
+#include "bufferContainer.hpp"   // for bufferContainer
+#include "prometheusMetrics.hpp" // for Counter
+
+#include <deque>    // for deque
+#include <memory>   // for unique_ptr
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint8_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @brief Passes frames out of a shared memory ring into a buffer.
+ *
+ * The counterpart of @c bufferShmSend. The stage attaches to the ring once
+ * the sending kotekan instance has created it, and reattaches if the sender
+ * restarts. Frames are passed on in the order they were sent. The buffer
+ * frames point at the data in the ring instead of getting a copy of it, and
+ * a ring slot only goes back to the sender once the consumers are done with
+ * its frame, so the consumers hold on to at most as many frames as the ring
+ * has slots. If @c buf is full the ring fills up, and it is up to the sender
+ * to drop frames or wait. Only the metadata is copied.
+ *
+ * The frame size and the metadata size of @c buf must match the sender's.
+ *
+ * @par buffers
+ * @buffer buf The buffer to put the frames into (producer)
+ *        @buffer_format any
+ *        @buffer_metadata any
+ *
+ * @conf shm_name        String. Name of the shared memory region, as given to @c bufferShmSend.
+ * @conf reconnect_time  Int, default 1.  The number of seconds between attempts to attach.
+ *
+ * @par Metrics
+ * @metric kotekan_buffer_shm_recv_frames_total
+ *         The number of frames passed on from the ring.
+ */
+class bufferShmRecv : public kotekan::Stage {
+public:
+    /// Standard constructor
+    bufferShmRecv(kotekan::Config& config, const std::string& unique_name,
+                  kotekan::bufferContainer& buffer_container);
+
+    /// Gives the buffer its own frames back
+    ~bufferShmRecv();
+
+    /// Main loop for attaching to the ring and passing the frames on
+    void main_thread() override;
+
+    /// Adds the shared memory region to the pipeline dot graph
+    virtual std::string dot_string(const std::string& prefix) const override;
+
+private:
+    /// The output buffer
+    struct Buffer* buf;
+
+    /// Name of the shared memory region
+    std::string shm_name;
+
+    /// The number of seconds between attempts to attach to the ring
+    uint32_t reconnect_time;
+
+    /// Size of the metadata passed with each frame
+    size_t metadata_size;
+
+    /// Wait for the consumers to be done with the oldest frame pointing into the
+    /// ring, and hand its slot back to the sender. False if the buffer shut down.
+    bool release_frame();
+
+    /// The ring attached to, kept until the consumers are gone
+    std::unique_ptr<BufferShmRing> ring;
+
+    /// The frames allocated by the buffer, swapped back in when a slot is released
+    std::vector<uint8_t*> internal_frames;
+
+    /// The buffer frames pointing into the ring, in the order of their slots
+    std::deque<int> held_frames;
+
+    kotekan::prometheus::Counter& frames_counter;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "bufferShmSend.hpp"
+
+#include "BufferShmRing.hpp"     // for BufferShmRing
+#include "Config.hpp"            // for Config
+#include "StageFactory.hpp"      // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
+#include "buffer.h"              // for Buffer, mark_frame_empty, register_consumer, wait_for_f...
+#include "bufferContainer.hpp"   // for bufferContainer
+#include "kotekanLogging.hpp"    // for DEBUG, INFO, FATAL_ERROR
+#include "metadata.h"            // for metadataContainer, metadataPool
+#include "prometheusMetrics.hpp" // for Metrics, Counter
+
+#include "fmt.hpp" // for format, fmt
+
+#include <exception>  // for exception
+#include <functional> // for _Bind_helper<>::type, bind, function
+#include <memory>     // for unique_ptr, make_unique
+#include <regex>      // for match_results<>::_Base_type
+#include <stdexcept>  // for runtime_error
+#include <string.h>   // for memcpy
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+using kotekan::Stage;
+using kotekan::prometheus::Metrics;
+
+REGISTER_KOTEKAN_STAGE(bufferShmSend);
+
+bufferShmSend::bufferShmSend(Config& config, const std::string& unique_name,
+                             bufferContainer& buffer_container) :
+    Stage(config, unique_name, buffer_container, std::bind(&bufferShmSend::main_thread, this)),
+    frames_counter(
+        Metrics::instance().add_counter("kotekan_buffer_shm_send_frames_total", unique_name)),
+    dropped_frame_counter(Metrics::instance().add_counter(
+        "kotekan_buffer_shm_send_dropped_frame_total", unique_name)) {
+
+    buf = get_buffer("buf");
+    register_consumer(buf, unique_name.c_str());
+
+    shm_name = config.get<std::string>(unique_name, "shm_name");
+    num_slots = config.get_default<uint32_t>(unique_name, "num_slots", buf->num_frames);
+    drop_frames = config.get_default<bool>(unique_name, "drop_frames", true);
+
+    metadata_size = buf->metadata_pool ? buf->metadata_pool->metadata_object_size : 0;
+}
+
+void bufferShmSend::main_thread() {
+
+    std::unique_ptr<BufferShmRing> ring;
+    try {
+        ring = std::make_unique<BufferShmRing>(shm_name, num_slots, buf->frame_size,
+                                               metadata_size);
+    } catch (std::exception& e) {
+        FATAL_ERROR("Could not create the shared memory ring: {:s}", e.what());
+        return;
+    }
+    INFO("Passing frames of buffer {:s} into shared memory ring {:s} ({:d} slots)",
+         buf->buffer_name, shm_name, num_slots);
+
+    int frame_id = 0;
+
+    while (!stop_thread) {
+
+        uint8_t* frame = wait_for_full_frame(buf, unique_name.c_str(), frame_id);
+        if (frame == nullptr)
+            break;
+
+        int64_t seq = ring->wait_for_space(0);
+        while (seq < 0 && !drop_frames && !stop_thread)
+            seq = ring->wait_for_space(100);
+
+        if (seq >= 0) {
+            if (metadata_size > 0 && buf->metadata[frame_id] != nullptr)
+                memcpy(ring->metadata(seq), buf->metadata[frame_id]->metadata, metadata_size);
+            memcpy(ring->frame(seq), frame, buf->frame_size);
+            ring->publish();
+            frames_counter.inc();
+            DEBUG("Passed frame {:s}[{:d}] into the ring as {:d}", buf->buffer_name, frame_id,
+                  seq);
+        } else if (drop_frames) {
+            DEBUG("Shared memory ring {:s} is full, dropping frame {:s}[{:d}]", shm_name,
+                  buf->buffer_name, frame_id);
+            dropped_frame_counter.inc();
+        }
+
+        mark_frame_empty(buf, unique_name.c_str(), frame_id);
+        frame_id = (frame_id + 1) % buf->num_frames;
+    }
+
+    ring->close_writer();
+}
+
+std::string bufferShmSend::dot_string(const std::string& prefix) const {
+    std::string dot = Stage::dot_string(prefix);
+    dot += fmt::format("{:s}\"{:s}\" [shape=doubleoctagon style=filled,color=lightblue]", prefix,
+                       shm_name);
+    dot += fmt::format("{:s}\"{:s}\" -> \"{:s}\"", prefix, get_unique_name(), shm_name);
+
+    return dot;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * @brief Object for passing buffer frames to another kotekan instance on the same host
+ * - bufferShmSend : public kotekan::Stage
+ */
+#ifndef BUFFER_SHM_SEND_H
+#define BUFFER_SHM_SEND_H
+
+#include "BufferShmRing.hpp"     // for BufferShmRing
+#include "Config.hpp"            // for Config
+#include "Stage.hpp"             // for Stage
+#include "bufferContainer.hpp"   // for bufferContainer
+#include "prometheusMetrics.hpp" // for Counter
+
+#include <memory>   // for unique_ptr
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t
+#include <string>   // for string
+
+/**
+ * @brief Copies buffer frames and their metadata into a shared memory ring.
+ *
+ * The counterpart of @c bufferShmRecv, for moving frames between kotekan
+ * instances on the same host without going through TCP over loopback. Each
+ * frame is copied once into the ring, and the receiver passes it on from
+ * there without another copy; no syscalls are made apart from a futex wake-up
+ * per frame.
+ *
+ * The ring is created when the stage starts (replacing a stale ring of the
+ * same name) and removed when it stops. Only one @c bufferShmRecv can read
+ * from a ring. See @c BufferShmRing for the layout.
+ *
+ * If no receiver is attached, or it is too slow, the ring fills up. Then
+ * frames are dropped with @c drop_frames, otherwise the stage waits for space.
+ *
+ * @par buffers
+ * @buffer buf The buffer to pass on.
+ *        @buffer_format any
+ *        @buffer_metadata any
+ *
+ * @conf shm_name     String. Name of the shared memory region, e.g. "/kotekan_gpu".
+ * @conf num_slots    Int, default the number of frames in @c buf. Frames in the ring.
+ * @conf drop_frames  Bool, default true.  Whether to drop frames when the ring is full.
+ *
+ * @par Metrics
+ * @metric kotekan_buffer_shm_send_frames_total
+ *         The number of frames passed into the ring.
+ * @metric kotekan_buffer_shm_send_dropped_frame_total
+ *         The number of frames dropped because the ring was full.
+ */
+class bufferShmSend : public kotekan::Stage {
+public:
+    /// Standard constructor
+    bufferShmSend(kotekan::Config& config, const std::string& unique_name,
+                  kotekan::bufferContainer& buffer_container);
+
+    /// Main loop for copying frames into the ring
+    void main_thread() override;
+
+    /// Adds the shared memory region to the pipeline dot graph
+    virtual std::string dot_string(const std::string& prefix) const override;
+
+private:
+    /// The input buffer to pass frames on from.
+    struct Buffer* buf;
+
+    /// Name of the shared memory region
+    std::string shm_name;
+
+    /// Number of frames in the ring
+    uint32_t num_slots;
+
+    /// Whether to drop frames or block if the ring is full
+    bool drop_frames;
+
+    /// Size of the metadata passed with each frame
+    size_t metadata_size;
+
+    kotekan::prometheus::Counter& frames_counter;
+    kotekan::prometheus::Counter& dropped_frame_counter;
+};
+
+#endif
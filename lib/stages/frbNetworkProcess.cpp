@@ -3,6 +3,7 @@
 #include "Config.hpp"       // for Config
 #include "StageFactory.hpp" // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
 #include "Telescope.hpp"
+#include "UdpTransmitter.hpp"    // for UdpTransmitter
 #include "buffer.h"              // for wait_for_full_frame, mark_frame_empty, register_consumer
 #include "bufferContainer.hpp"   // for bufferContainer
 #include "frb_functions.h"       // for FRBHeader
@@ -65,7 +66,8 @@ frbNetworkProcess::frbNetworkProcess(Config& config_, const std::string& unique_
     _quick_ping_interval{
         std::chrono::seconds(config_.get_default<uint32_t>(unique_name, "quick_ping_interval", 5))},
     _ping_dead_threshold{std::chrono::seconds(
-        config_.get_default<uint32_t>(unique_name, "ping_dead_threshold", 30))} {
+        config_.get_default<uint32_t>(unique_name, "ping_dead_threshold", 30))},
+    tx(config_, unique_name) {
 
     in_buf = get_buffer("in_buf");
     register_consumer(in_buf, unique_name.c_str());
@@ -124,6 +126,9 @@ void frbNetworkProcess::main_thread() {
         return;
 
     int number_of_l1_links = initialize_destinations();
+    // check for errors initializing
+    if (number_of_l1_links < 0)
+        return;
     INFO("number_of_l1_links: {:d}", number_of_l1_links);
 
     std::thread send_ping_thread;
@@ -152,7 +157,7 @@ void frbNetworkProcess::main_thread() {
     // config.update_value(unique_name, "beam_offset", beam_offset);
 
     // declaring the timespec variables used mostly for the timing issues
-    struct timespec t0, t1;
+    struct timespec t0;
     t0.tv_sec = 0;
     t0.tv_nsec = 0; /*  nanoseconds */
 
@@ -209,8 +214,6 @@ void frbNetworkProcess::main_thread() {
             if (packet_buffer == nullptr)
                 break;
 
-            clock_gettime(CLOCK_MONOTONIC, &t1);
-
             add_nsec(t0, time_interval);
 
             // discipline the monotonic clock with the fpga time stamps
@@ -232,7 +235,8 @@ void frbNetworkProcess::main_thread() {
             last_fpga_count = header->fpga_count;
         }
 
-        t1 = t0;
+        // packets are handed to the transmitter with the time they are due
+        uint64_t tx_time = UdpTransmitter::to_ns(t0);
 
         int local_beam_offset = beam_offset;
         int beam_offset_upper_limit = 512;
@@ -252,19 +256,16 @@ void frbNetworkProcess::main_thread() {
                                + stream; // making sure no two nodes send packets to same L1 node
                 if (e_stream > 255)
                     e_stream -= 256;
-                CLOCK_ABS_NANOSLEEP(CLOCK_MONOTONIC, t1);
-
-                for (int link = 0; link < number_of_l1_links; link++) {
-                    if (e_stream == local_beam_offset / 4 + link) {
-                        DestIpSocket& dst = stream_dest[link];
-                        if (dst.active
-                            && (_ping_dead_threshold == std::chrono::seconds::zero() || dst.live)) {
-                            sendto(src_sockets[dst.sending_socket].socket_fd,
-                                   &packet_buffer[(e_stream * packets_per_stream + frame)
-                                                  * udp_frb_packet_size],
-                                   udp_frb_packet_size, 0, (struct sockaddr*)&dst.addr,
-                                   sizeof(dst.addr));
-                        }
+
+                int link = e_stream - local_beam_offset / 4;
+                if (link >= 0 && link < number_of_l1_links) {
+                    DestIpSocket& dst = stream_dest[link];
+                    if (dst.active
+                        && (_ping_dead_threshold == std::chrono::seconds::zero() || dst.live)) {
+                        tx.send(link_tx_dest[link],
+                                &packet_buffer[(e_stream * packets_per_stream + frame)
+                                               * udp_frb_packet_size],
+                                udp_frb_packet_size, tx_time);
                     }
                 }
                 long wait_per_packet = (long)(50000);
@@ -273,10 +274,12 @@ void frbNetworkProcess::main_thread() {
                 // I have used 58880 for convinence and also hope this will take care for
                 // any clock glitches.
 
-                add_nsec(t1, wait_per_packet);
+                tx_time += wait_per_packet;
             }
         }
 
+        // the packets point into the frame, so they must be sent before releasing it
+        tx.flush();
         mark_frame_empty(in_buf, unique_name.c_str(), frame_id);
         frame_id = (frame_id + 1) % in_buf->num_frames;
         count++;
@@ -325,6 +328,7 @@ int frbNetworkProcess::initialize_source_sockets() {
         }
 
         src_sockets.push_back({addr, sock_fd});
+        tx.add_socket(sock_fd);
     }
 
     /* every node is introducing packets to the network. To achive load balancing a sequece_id is
@@ -343,18 +347,26 @@ int frbNetworkProcess::initialize_destinations() {
     // reading the L1 ip addresses from the config file
     const std::vector<std::string> link_ip =
         config.get<std::vector<std::string>>(unique_name, "L1_node_ips");
+    // transmitter destinations, indexed by IP @c s_addr
+    std::map<uint32_t, size_t> tx_dest;
     for (size_t i = 0; i < link_ip.size(); i++) {
         sockaddr_in addr;
         memset(&addr, 0, sizeof(addr));
         if (!link_ip[i].empty()) {
             addr.sin_family = AF_INET;
-            inet_pton(AF_INET, link_ip[i].c_str(), &addr.sin_addr);
+            // The address 0 is the key of the inactive placeholders, so it can't be a destination
+            if (inet_pton(AF_INET, link_ip[i].c_str(), &addr.sin_addr) != 1
+                || addr.sin_addr.s_addr == 0) {
+                FATAL_ERROR("Invalid L1 node IP address \"{:s}\" for link {:d}.", link_ip[i], i);
+                return -1;
+            }
             if (!dest_sockets.count(addr.sin_addr.s_addr)) {
                 // new destination, initialize the entry in `dest_sockets`
                 addr.sin_port = htons(udp_frb_port_number);
                 int sending_socket = get_vlan_from_ip(link_ip[i].c_str()) - 6;
                 dest_sockets.insert(
                     {addr.sin_addr.s_addr, DestIpSocket{link_ip[i], addr, sending_socket}});
+                tx_dest[addr.sin_addr.s_addr] = tx.add_destination(sending_socket, addr);
             }
         } else {
             if (!dest_sockets.count(0)) {
@@ -362,6 +374,9 @@ int frbNetworkProcess::initialize_destinations() {
             }
         }
         stream_dest.push_back(std::ref(dest_sockets.at(addr.sin_addr.s_addr)));
+        // inactive placeholders are never sent to
+        link_tx_dest.push_back(tx_dest.count(addr.sin_addr.s_addr) ? tx_dest[addr.sin_addr.s_addr]
+                                                                    : no_tx_dest);
     }
     return link_ip.size();
 }
@@ -9,6 +9,7 @@
 
 #include "Config.hpp"          // for Config
 #include "Stage.hpp"           // for Stage
+#include "UdpTransmitter.hpp"  // for UdpTransmitter
 #include "bufferContainer.hpp" // for bufferContainer
 #include "restServer.hpp"      // for connectionInstance
 
@@ -18,8 +19,10 @@
 #include <chrono>             // for seconds
 #include <condition_variable> // for condition_variable
 #include <functional>         // for reference_wrapper
+#include <limits>             // for numeric_limits
 #include <map>                // for map
 #include <netinet/in.h>       // for sockaddr_in
+#include <stddef.h>           // for size_t
 #include <stdint.h>           // for uint32_t
 #include <string>             // for string
 #include <vector>             // for vector
@@ -34,6 +37,9 @@
  * (10.6 10.7 10.8 10.9) on single 1 Gig port. The frb total data rate is ~0.55 gbps. The node IP
  * address is derived by parsing the hostname.
  *
+ * The packets are sent by a @c UdpTransmitter, so they can be batched and
+ * paced by the kernel (see its ``tx_*`` config options and metrics).
+ *
  * @par REST Endpoints
  * @endpoint /frb/update_gains/``gpu_id`` Any contact here triggers a re-parse of the gains file.
  * @endpoint /frb/update_destination Set the active status of param ``host`` to value of param
@@ -62,6 +68,17 @@
  * @conf   ping_dead_threshold  Uint32 (default 30 sec) Duration in seconds of quick-checking state
  * after which a node is declared dead if it still hasn't responded. If 0, disable the checks
  * entirely.
+ * @conf   tx_pacing            String (default "sleep"). Pace packets by sleeping, or with
+ * SO_TXTIME ("txtime") if the interfaces use the fq qdisc. See @c UdpTransmitter.
+ * @conf   tx_batch_size        Int (default 64). Maximum number of packets per @c sendmmsg.
+ * @conf   tx_batch_window      Int (default 0 for "sleep", 1 ms for "txtime"). Maximum spread in ns
+ * of the transmit times of a batch.
+ *
+ * @par Metrics
+ * @metric kotekan_udp_tx_packets_total Number of packets sent, by L1 node.
+ * @metric kotekan_udp_tx_bytes_total Number of bytes sent, by L1 node.
+ * @metric kotekan_udp_tx_late_packets_total Number of packets sent late, by L1 node.
+ * @metric kotekan_udp_tx_errors_total Number of packets that failed to send, by L1 node.
  *
  * @todo   Resolve the issue of NTP clock vs Monotonic clock.
  *
@@ -189,6 +206,15 @@ private:
     /// for multiple streams)
     std::vector<std::reference_wrapper<DestIpSocket>> stream_dest;
 
+    /// batches and paces the packets over the @p src_sockets
+    UdpTransmitter tx;
+
+    /// transmitter destination of each entry of @p stream_dest
+    std::vector<size_t> link_tx_dest;
+
+    /// entry of @p link_tx_dest for the inactive placeholders, which aren't a destination
+    static constexpr size_t no_tx_dest = std::numeric_limits<size_t>::max();
+
     /// raw sockets used as sources for outgoing pings
     std::vector<int> ping_src_fd;
 
@@ -198,7 +224,8 @@ private:
     /// initialize sockets used to send data to FRB nodes
     int initialize_source_sockets();
 
-    /// initialize destination addresses and determine the sending socket to use
+    /// initialize destination addresses and determine the sending socket to use, returns the
+    /// number of links or -1 if an address is invalid
     int initialize_destinations();
 
     /// initialize raw sockets used for pinging
@@ -2,6 +2,7 @@
 
 #include "Config.hpp"          // for Config
 #include "StageFactory.hpp"    // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
+#include "UdpTransmitter.hpp"  // for UdpTransmitter
 #include "buffer.h"            // for mark_frame_empty, wait_for_full_frame, register_consumer
 #include "bufferContainer.hpp" // for bufferContainer
 #include "kotekanLogging.hpp"  // for ERROR, INFO
@@ -15,7 +16,7 @@
 #include <stdlib.h>     // for free, malloc
 #include <string.h>     // for memcpy, memset
 #include <string>       // for string, allocator, operator==
-#include <sys/socket.h> // for send, socket, AF_INET, connect, sendto, setsockopt, SOCK_...
+#include <sys/socket.h> // for send, socket, AF_INET, connect, setsockopt, SOCK_STREAM
 #include <sys/time.h>   // for timeval, gettimeofday
 #include <sys/types.h>  // for uint
 #include <unistd.h>     // for close
@@ -103,6 +104,12 @@ void networkPowerStream::main_thread() {
         }
         INFO("{:d} {:s}", dest_port, dest_server_ip);
 
+        UdpTransmitter tx(config, unique_name);
+        size_t dest = tx.add_destination(tx.add_socket(socket_fd), saddr_remote);
+
+        // One packet per element, sent as a batch for each time sample
+        uint8_t* udp_packets = (uint8_t*)malloc(elems * packet_length);
+
         while (!stop_thread) {
             // Wait for a full buffer.
             frame = wait_for_full_frame(in_buf, unique_name.c_str(), frame_id);
@@ -110,26 +117,28 @@ void networkPowerStream::main_thread() {
                 break;
 
             for (int t = 0; t < times; t++) {
-                packet_header->frame_idx = frame_idx++;
+                int packet_frame_idx = frame_idx++;
                 for (int p = 0; p < elems; p++) {
-                    packet_header->elem_idx = p;
-                    packet_header->samples_summed =
+                    uint8_t* packet = udp_packets + p * packet_length;
+                    IntensityPacketHeader* udp_header = (IntensityPacketHeader*)packet;
+                    udp_header->frame_idx = packet_frame_idx;
+                    udp_header->elem_idx = p;
+                    udp_header->samples_summed =
                         ((uint*)frame)[t * elems * (freqs + 1) + p * (freqs + 1) + freqs];
-                    memcpy(local_data, frame + (t * elems + p) * (freqs + 1) * sizeof(uint),
+                    memcpy(packet + sizeof(IntensityPacketHeader),
+                           frame + (t * elems + p) * (freqs + 1) * sizeof(uint),
                            freqs * sizeof(uint));
-                    // Send data to remote server.
-                    uint32_t bytes_sent =
-                        sendto(socket_fd, packet_buffer, packet_length, 0,
-                               (struct sockaddr*)&saddr_remote, sizeof(sockaddr_in));
-                    if (bytes_sent != packet_length)
-                        ERROR("SOMETHING WENT WRONG IN UDP TRANSMIT");
+                    // Queue data for the remote server.
+                    tx.send(dest, packet, packet_length);
                 }
+                tx.flush();
             }
 
             // Mark buffer as empty.
             mark_frame_empty(in_buf, unique_name.c_str(), frame_id);
             frame_id = (frame_id + 1) % in_buf->num_frames;
         }
+        free(udp_packets);
     } else if (dest_protocol == "TCP") {
         // TCP variables
         while (!stop_thread) {
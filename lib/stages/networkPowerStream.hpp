@@ -42,6 +42,8 @@
  * @conf   dest_port               Int. Number of time samples to sum.
  * @conf   dest_server_ip           Int. Number of time samples to sum.
  * @conf   dest_protocol          String. Should be @c "TCP" or @c "UDP"
+ * @conf   tx_batch_size          Int (default 64). UDP packets sent per @c sendmmsg, see
+ *                                @c UdpTransmitter.
  *
  * @warning UDP stream doesn't work at the moment.
  * @note    Lots of updating required once buffers are typed...
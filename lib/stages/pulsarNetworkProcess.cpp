@@ -3,6 +3,7 @@
 #include "Config.hpp"       // for Config
 #include "StageFactory.hpp" // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
 #include "Telescope.hpp"
+#include "UdpTransmitter.hpp"   // for UdpTransmitter
 #include "buffer.h"             // for mark_frame_empty, wait_for_full_frame, register_consumer
 #include "bufferContainer.hpp"  // for bufferContainer
 #include "kotekanLogging.hpp"   // for FATAL_ERROR, INFO, CHECK_MEM
@@ -22,7 +23,7 @@
 #include <stdint.h>     // for int64_t, uint8_t
 #include <stdlib.h>     // for free, malloc
 #include <string>       // for string, allocator
-#include <sys/socket.h> // for AF_INET, bind, sendto, setsockopt, socket, SOCK_DGRAM
+#include <sys/socket.h> // for AF_INET, bind, setsockopt, socket, SOCK_DGRAM
 #include <sys/time.h>   // for CLOCK_MONOTONIC, CLOCK_REALTIME
 #include <time.h>       // for timespec, clock_gettime
 #include <vector>       // for vector
@@ -40,7 +41,8 @@ REGISTER_KOTEKAN_STAGE(pulsarNetworkProcess);
 pulsarNetworkProcess::pulsarNetworkProcess(Config& config_, const std::string& unique_name,
                                            bufferContainer& buffer_container) :
     Stage(config_, unique_name, buffer_container,
-          std::bind(&pulsarNetworkProcess::main_thread, this)) {
+          std::bind(&pulsarNetworkProcess::main_thread, this)),
+    tx(config_, unique_name) {
     in_buf = get_buffer("pulsar_out_buf");
     register_consumer(in_buf, unique_name.c_str());
 
@@ -113,6 +115,7 @@ void pulsarNetworkProcess::main_thread() {
             FATAL_ERROR("network thread: socket() failed: ");
             return;
         }
+        tx.add_socket(sock_fd[i]);
     }
 
 
@@ -137,6 +140,7 @@ void pulsarNetworkProcess::main_thread() {
         inet_pton(AF_INET, link_ip[i].c_str(), &server_address[i].sin_addr);
         server_address[i].sin_port = htons(udp_pulsar_port_number);
         socket_ids[i] = get_vlan_from_ip(link_ip[i].c_str()) - 15;
+        link_tx_dest.push_back(tx.add_destination(socket_ids[i], server_address[i]));
     }
 
     int n = 256 * 1024 * 1024;
@@ -147,7 +151,7 @@ void pulsarNetworkProcess::main_thread() {
         }
     }
 
-    struct timespec t0, t1;
+    struct timespec t0;
     t0.tv_sec = 0;
     t0.tv_nsec = 0; /*  nanoseconds */
 
@@ -194,8 +198,8 @@ void pulsarNetworkProcess::main_thread() {
                            + 625 * (psr_header->data_frame - psr_header_last_frame));
 
         add_nsec(t0, time_interval);
-        t1.tv_sec = t0.tv_sec;
-        t1.tv_nsec = t0.tv_nsec;
+        // packets are handed to the transmitter with the time they are due
+        uint64_t tx_time = UdpTransmitter::to_ns(t0);
 
         psr_header_last_seconds = psr_header->seconds;
         psr_header_last_frame = psr_header->data_frame;
@@ -204,13 +208,11 @@ void pulsarNetworkProcess::main_thread() {
             for (int beam = 0; beam < _num_pulsar_beams; beam++) {
                 int e_beam = my_sequence_id + beam;
                 e_beam = e_beam % _num_pulsar_beams;
-                CLOCK_ABS_NANOSLEEP(CLOCK_MONOTONIC, t1);
                 if (e_beam < number_of_pulsar_links) {
-                    sendto(sock_fd[socket_ids[e_beam]],
-                           &packet_buffer[(e_beam)*80 * udp_pulsar_packet_size
-                                          + frame * udp_pulsar_packet_size],
-                           udp_pulsar_packet_size, 0, (struct sockaddr*)&server_address[e_beam],
-                           sizeof(server_address[e_beam]));
+                    tx.send(link_tx_dest[e_beam],
+                            &packet_buffer[(e_beam)*80 * udp_pulsar_packet_size
+                                           + frame * udp_pulsar_packet_size],
+                            udp_pulsar_packet_size, tx_time);
                 }
 
                 long wait_per_packet = (long)(153600);
@@ -218,10 +220,12 @@ void pulsarNetworkProcess::main_thread() {
                 // 61521.25 is the theoretical seperation of packets in ns
                 // I have used 61440 for convenience and also hope this will take care for
                 // any clock glitches.
-                add_nsec(t1, wait_per_packet);
+                tx_time += wait_per_packet;
             }
         }
 
+        // the packets point into the frame, so they must be sent before releasing it
+        tx.flush();
         mark_frame_empty(in_buf, unique_name.c_str(), frame_id);
         frame_id = (frame_id + 1) % in_buf->num_frames;
     }
@@ -9,10 +9,13 @@
 
 
 #include "Config.hpp"
-#include "Stage.hpp" // for Stage
+#include "Stage.hpp"          // for Stage
+#include "UdpTransmitter.hpp" // for UdpTransmitter
 #include "bufferContainer.hpp"
 
-#include <string> // for string
+#include <stddef.h> // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
 
 /**
  * @class pulsarNetworkProcess
@@ -37,6 +40,9 @@
  *PULSAR data
  * @conf   my_node_id           Int (parsed from the hostname) esimated from the location of node
  *from node location.
+ * @conf   tx_pacing            String (default "sleep"). Pace packets by sleeping, or with
+ *SO_TXTIME ("txtime") if the interfaces use the fq qdisc. See @c UdpTransmitter for the other
+ *``tx_*`` options and the per-destination metrics.
  *
  * @todo   Resolve the issue of NTP clock vs Monotonic clock.
  * @todo   Should run further tests
@@ -101,6 +107,12 @@ private:
 
     /// Number of tracking (pulsar) beams
     int _num_pulsar_beams;
+
+    /// batches and paces the packets
+    UdpTransmitter tx;
+
+    /// transmitter destination of each pulsar link
+    std::vector<size_t> link_tx_dest;
 };
 
 #endif
@@ -1,20 +1,34 @@
 #include "restInspectFrame.hpp"
 
 #include "Config.hpp"          // for Config
+#include "HFBFrameView.hpp"    // for HFBFrameView, HFBField
+#include "HFBMetadata.hpp"     // for HFBMetadata
+#include "SnapshotPool.hpp"    // for SnapshotPool
 #include "StageFactory.hpp"    // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
 #include "buffer.h"            // for Buffer, mark_frame_empty, register_consumer, wait_for_ful...
 #include "bufferContainer.hpp" // for bufferContainer
-#include "kotekanLogging.hpp"  // for CHECK_MEM, WARN
-#include "restServer.hpp"      // for restServer, connectionInstance
+#include "kotekanLogging.hpp"  // for WARN, INFO
+#include "metadata.h"          // for metadataContainer, metadataPool
+#include "restServer.hpp"      // for restServer, connectionInstance, restStream, HTTP_RESPONSE
+#include "visBuffer.hpp"       // for VisFrameView, VisField, VisMetadata
+#include "visUtil.hpp"         // for ts_to_double, struct_layout
 
-#include <atomic>     // for atomic_bool
+#include "fmt.hpp"  // for format, fmt
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json<>::value_type
+
+#include <algorithm>  // for find, min, remove_if
+#include <chrono>     // for steady_clock, duration, nanoseconds, milliseconds
 #include <cstdint>    // for int32_t
 #include <exception>  // for exception
 #include <functional> // for _Bind_helper<>::type, _Placeholder, bind, _1, function
+#include <limits>     // for numeric_limits
+#include <map>        // for map
 #include <regex>      // for match_results<>::_Base_type
-#include <stdexcept>  // for runtime_error
-#include <stdlib.h>   // for free, malloc
+#include <sstream>    // for istringstream
+#include <stdexcept>  // for runtime_error, invalid_argument
 #include <string.h>   // for memcpy
+#include <thread>     // for thread
+#include <utility>    // for move, pair
 #include <vector>     // for vector
 
 
@@ -23,22 +37,43 @@ using kotekan::Config;
 using kotekan::Stage;
 
 using kotekan::connectionInstance;
+using kotekan::HTTP_RESPONSE;
 using kotekan::restServer;
 
+using nlohmann::json;
+
 REGISTER_KOTEKAN_STAGE(restInspectFrame);
 
+static int64_t steady_time_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
 restInspectFrame::restInspectFrame(Config& config, const std::string& unique_name,
                                    bufferContainer& buffer_container) :
-    Stage(config, unique_name, buffer_container, std::bind(&restInspectFrame::main_thread, this)) {
+    Stage(config, unique_name, buffer_container, std::bind(&restInspectFrame::main_thread, this)),
+    copy_until(0),
+    next_stream_seq(std::numeric_limits<uint64_t>::max()) {
 
     in_buf = get_buffer("in_buf");
     in_buf_config_name = config.get<std::string>(unique_name, "in_buf");
     register_consumer(in_buf, unique_name.c_str());
 
     len = config.get_default<int32_t>(unique_name, "len", 0);
+    format = config.get_default<std::string>(unique_name, "format", "raw");
+    if (format != "raw" && format != "vis" && format != "hfb") {
+        throw std::invalid_argument(
+            fmt::format(fmt("restInspectFrame: unknown format \"{:s}\" (raw, vis or hfb)."),
+                        format));
+    }
+    max_streams = config.get_default<size_t>(unique_name, "max_streams", 8);
+    stream_backlog = config.get_default<size_t>(unique_name, "stream_backlog", 16 * 1024 * 1024);
+    get_timeout = config.get_default<double>(unique_name, "get_timeout", 10.0);
 
     registered = false;
     endpoint = "/inspect_frame/" + in_buf_config_name;
+    stream_endpoint = endpoint + "/stream";
 
     if (len == 0) {
         len = in_buf->frame_size;
@@ -46,39 +81,254 @@ restInspectFrame::restInspectFrame(Config& config, const std::string& unique_nam
         WARN("Requested len ({:d}) is greater than the frame_size ({:d}).", len,
              in_buf->frame_size);
         len = in_buf->frame_size;
+    } else if (format != "raw") {
+        WARN("The {:s} format needs whole frames, ignoring len ({:d}).", format, len);
+        len = in_buf->frame_size;
     }
 
-    frame_copy = (uint8_t*)malloc(len);
-    CHECK_MEM(frame_copy);
+    size_t metadata_size =
+        in_buf->metadata_pool != nullptr ? in_buf->metadata_pool->metadata_object_size : 0;
+    snapshots = std::make_unique<SnapshotPool>(
+        config.get_default<size_t>(unique_name, "num_snapshots", 4), len, metadata_size);
 }
 
 restInspectFrame::~restInspectFrame() {
     if (registered) {
         restServer::instance().remove_get_callback(endpoint);
+        restServer::instance().remove_get_callback(stream_endpoint);
     }
-    free(frame_copy);
 }
 
 void restInspectFrame::rest_callback(connectionInstance& conn) {
-    frame_copy_lock.lock();
-    conn.send_binary_reply(frame_copy, len);
-    frame_copy_lock.unlock();
+    copy_until = steady_time_ns() + (int64_t)(get_timeout * 1e9);
+
+    SnapshotPool::reader s = snapshots->latest();
+    if (!s) {
+        conn.send_error("No frame yet", HTTP_RESPONSE::NOT_FOUND);
+        return;
+    }
+    conn.send_binary_reply(const_cast<uint8_t*>(s->data.data()), len);
+}
+
+std::vector<std::string> restInspectFrame::field_names() {
+    if (format == "vis")
+        return {"vis", "weight", "flags", "eval", "evec", "erms", "gain"};
+    if (format == "hfb")
+        return {"hfb", "weight"};
+    return {"data"};
+}
+
+void restInspectFrame::stream_callback(connectionInstance& conn) {
+    auto query = conn.get_query();
+
+    subscriber sub;
+    try {
+        sub.every = query.count("every") ? std::stoull(query["every"]) : 1;
+        sub.max_frames = query.count("max_frames") ? std::stoull(query["max_frames"]) : 0;
+    } catch (std::exception& e) {
+        conn.send_error("every and max_frames must be integers", HTTP_RESPONSE::BAD_REQUEST);
+        return;
+    }
+    if (sub.every == 0)
+        sub.every = 1;
+
+    auto names = field_names();
+    if (query.count("fields") && !query["fields"].empty()) {
+        std::istringstream fields(query["fields"]);
+        std::string field;
+        while (std::getline(fields, field, ',')) {
+            if (std::find(names.begin(), names.end(), field) == names.end()) {
+                conn.send_error(fmt::format(fmt("Unknown field \"{:s}\" for the {:s} format."),
+                                            field, format),
+                                HTTP_RESPONSE::BAD_REQUEST);
+                return;
+            }
+            sub.fields.push_back(field);
+        }
+    } else {
+        sub.fields = names;
+    }
+
+    std::lock_guard<std::mutex> lock(subscriber_lock);
+    if (subscribers.size() >= max_streams) {
+        conn.send_error(fmt::format(fmt("Already streaming to {:d} clients."), max_streams),
+                        HTTP_RESPONSE::REQUEST_FAILED);
+        return;
+    }
+    INFO("Streaming {:s} to a new client, every {:d} frames.", in_buf_config_name, sub.every);
+    sub.stream = conn.send_stream("application/octet-stream", stream_backlog);
+    subscribers.push_back(std::move(sub));
+    // Copy the next frame
+    next_stream_seq = 0;
+    stream_cond.notify_one();
+}
+
+std::vector<restInspectFrame::frameField>
+restInspectFrame::get_fields(const SnapshotPool::snapshot& s, json& header) {
+    std::vector<frameField> fields;
+
+    if (format == "vis" && s.metadata.size() >= sizeof(VisMetadata)) {
+        const VisMetadata* meta = (const VisMetadata*)s.metadata.data();
+        header["fpga_seq_start"] = meta->fpga_seq_start;
+        header["ctime"] = ts_to_double(meta->ctime);
+        header["fpga_seq_length"] = meta->fpga_seq_length;
+        header["fpga_seq_total"] = meta->fpga_seq_total;
+        header["rfi_total"] = meta->rfi_total;
+        header["freq_id"] = meta->freq_id;
+        header["dataset_id"] = meta->dataset_id;
+        header["num_elements"] = meta->num_elements;
+        header["num_prod"] = meta->num_prod;
+        header["num_ev"] = meta->num_ev;
+
+        auto layout =
+            VisFrameView::calculate_buffer_layout(meta->num_elements, meta->num_prod, meta->num_ev);
+        if (layout.first > s.data.size())
+            return fields;
+        auto field = [&](const std::string& name, VisField f, const std::string& dtype,
+                         std::vector<size_t> shape) {
+            fields.push_back({name, layout.second[f].first, layout.second[f].second, dtype, shape});
+        };
+        field("vis", VisField::vis, "complex64", {meta->num_prod});
+        field("weight", VisField::weight, "float32", {meta->num_prod});
+        field("flags", VisField::flags, "float32", {meta->num_elements});
+        field("eval", VisField::eval, "float32", {meta->num_ev});
+        field("evec", VisField::evec, "complex64", {meta->num_ev, meta->num_elements});
+        field("erms", VisField::erms, "float32", {1});
+        field("gain", VisField::gain, "complex64", {meta->num_elements});
+    } else if (format == "hfb" && s.metadata.size() >= sizeof(HFBMetadata)) {
+        const HFBMetadata* meta = (const HFBMetadata*)s.metadata.data();
+        header["fpga_seq_start"] = meta->fpga_seq_start;
+        header["ctime"] = ts_to_double(meta->ctime);
+        header["fpga_seq_length"] = meta->fpga_seq_length;
+        header["fpga_seq_total"] = meta->fpga_seq_total;
+        header["freq_id"] = meta->freq_id;
+        header["dataset_id"] = meta->dataset_id;
+        header["num_beams"] = meta->num_beams;
+        header["num_subfreq"] = meta->num_subfreq;
+
+        auto layout = HFBFrameView::calculate_buffer_layout(meta->num_beams, meta->num_subfreq);
+        if (layout.first > s.data.size())
+            return fields;
+        for (auto f : {std::make_pair("hfb", HFBField::hfb),
+                       std::make_pair("weight", HFBField::weight)}) {
+            fields.push_back({f.first, layout.second[f.second].first,
+                              layout.second[f.second].second, "float32",
+                              {meta->num_beams, meta->num_subfreq}});
+        }
+    } else {
+        fields.push_back({"data", 0, (size_t)len, "uint8", {(size_t)len}});
+    }
+    return fields;
+}
+
+void restInspectFrame::stream_thread() {
+    uint64_t last_published = 0;
+
+    std::unique_lock<std::mutex> lock(subscriber_lock);
+    while (!stop_thread) {
+        // The frame thread doesn't take the lock to notify, so don't wait forever
+        stream_cond.wait_for(lock, std::chrono::milliseconds(100), [&]() {
+            return stop_thread || snapshots->published() != last_published;
+        });
+        if (stop_thread)
+            break;
+        last_published = snapshots->published();
+
+        SnapshotPool::reader s = snapshots->latest();
+        if (!s)
+            continue;
+
+        json header;
+        std::vector<frameField> fields;
+        for (auto& sub : subscribers) {
+            if (sub.stream->is_closed() || s->seq < sub.next_seq)
+                continue;
+
+            if (fields.empty()) {
+                header = {{"seq", s->seq}};
+                fields = get_fields(*s, header);
+            }
+
+            // Select the fields and lay them out one after the other
+            json selected = json::array();
+            size_t offset = 0;
+            for (auto& f : fields) {
+                if (std::find(sub.fields.begin(), sub.fields.end(), f.name) == sub.fields.end())
+                    continue;
+                selected.push_back({{"name", f.name},
+                                    {"offset", offset},
+                                    {"size", f.end - f.start},
+                                    {"dtype", f.dtype},
+                                    {"shape", f.shape}});
+                offset += f.end - f.start;
+            }
+            json message_header = header;
+            message_header["fields"] = selected;
+            std::string header_string = message_header.dump();
+
+            std::string message(sizeof(uint32_t) + header_string.size() + offset, '\0');
+            uint32_t header_size = header_string.size();
+            memcpy(&message[0], &header_size, sizeof(header_size));
+            memcpy(&message[sizeof(uint32_t)], header_string.data(), header_string.size());
+            char* payload = &message[sizeof(uint32_t) + header_string.size()];
+            for (auto& f : fields) {
+                if (std::find(sub.fields.begin(), sub.fields.end(), f.name) == sub.fields.end())
+                    continue;
+                memcpy(payload, s->data.data() + f.start, f.end - f.start);
+                payload += f.end - f.start;
+            }
+
+            // Dropped frames count too, so a slow client gets the same rate
+            sub.stream->send_chunk(message);
+            sub.next_seq = s->seq + sub.every;
+            if (sub.max_frames > 0 && ++sub.sent >= sub.max_frames)
+                sub.stream->close();
+        }
+
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                         [](subscriber& sub) { return sub.stream->is_closed(); }),
+                          subscribers.end());
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+        for (auto& sub : subscribers)
+            next = std::min(next, sub.next_seq);
+        next_stream_seq = next;
+    }
+
+    // Ends the streams
+    subscribers.clear();
 }
 
 void restInspectFrame::main_thread() {
 
     uint8_t* frame = nullptr;
     uint32_t frame_id = 0;
+    uint64_t seq = 0;
+
+    std::thread sender(&restInspectFrame::stream_thread, this);
 
     while (!stop_thread) {
         frame = wait_for_full_frame(in_buf, unique_name.c_str(), frame_id);
         if (frame == nullptr)
             break;
 
-        if (frame_copy_lock.try_lock()) {
-            // TODO Enforce alignemnt needed to use nt_memcpy() here.
-            memcpy((void*)frame_copy, (void*)frame, len);
-            frame_copy_lock.unlock();
+        // Copy every frame unless only the streams are looking, then only the frames they
+        // want and for a while after a GET. Never wait for them.
+        uint64_t next_seq = next_stream_seq;
+        bool no_streams = (next_seq == std::numeric_limits<uint64_t>::max());
+        if (no_streams || seq >= next_seq || steady_time_ns() < copy_until) {
+            SnapshotPool::snapshot* s = snapshots->begin_write();
+            if (s != nullptr) {
+                // TODO Enforce alignemnt needed to use nt_memcpy() here.
+                memcpy(s->data.data(), frame, len);
+                struct metadataContainer* meta = get_metadata_container(in_buf, frame_id);
+                if (meta != nullptr) {
+                    memcpy(s->metadata.data(), meta->metadata,
+                           std::min(meta->metadata_size, s->metadata.size()));
+                }
+                s->seq = seq;
+                snapshots->publish(s);
+                stream_cond.notify_one();
+            }
         }
 
         // Only register the callback once we have something to return
@@ -86,10 +336,16 @@ void restInspectFrame::main_thread() {
             using namespace std::placeholders;
             restServer::instance().register_get_callback(
                 endpoint, std::bind(&restInspectFrame::rest_callback, this, _1));
+            restServer::instance().register_get_callback(
+                stream_endpoint, std::bind(&restInspectFrame::stream_callback, this, _1), true);
             registered = true;
         }
 
         mark_frame_empty(in_buf, unique_name.c_str(), frame_id);
         frame_id = (frame_id + 1) % in_buf->num_frames;
+        seq++;
     }
+
+    stream_cond.notify_one();
+    sender.join();
 }
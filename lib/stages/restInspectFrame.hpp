@@ -2,46 +2,78 @@
 #define REST_INSPECT_FRAME_HPP
 
 #include "Config.hpp"          // for Config
+#include "SnapshotPool.hpp"    // for SnapshotPool
 #include "Stage.hpp"           // for Stage
 #include "bufferContainer.hpp" // for bufferContainer
-#include "restServer.hpp"      // for connectionInstance
+#include "restServer.hpp"      // for connectionInstance, restStream
 
-#include <mutex>    // for mutex
-#include <stdint.h> // for int32_t, uint8_t
-#include <string>   // for string
+#include "json.hpp" // for json
+
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <memory>             // for unique_ptr
+#include <mutex>              // for mutex
+#include <stddef.h>           // for size_t
+#include <stdint.h>           // for int32_t, uint64_t, int64_t
+#include <string>             // for string
+#include <vector>             // for vector
 
 /**
  * @class restInspectFrame
  * @brief Exposes the binary contents of a buffer frame (or subset there of) to
- *        the REST server via a GET request.
+ *        the REST server via a GET request, or as a stream of frames.
+ *
+ * Frames are copied into a small pool of snapshots (see @c SnapshotPool), which
+ * the REST callbacks and the thread streaming frames read without ever locking
+ * out this stage, so inspecting a buffer never holds up the pipeline. Every
+ * frame is copied while no stream is open, so the GET endpoint always returns
+ * the latest frame. While streams are open frames are only copied as often as
+ * the stream subscribers want them, and for a while after a GET request.
  *
- * Returns the latest data copied into the internal frame @c frame_copy.
- * The length of this data is either the frame size, or the @c len config option
- * When returning data to the REST client, this class will not update @c frame_copy
- * So it's possible that if too many requests are made, it will keep returning the
- * same (old) frame contents.  This is a side effect of trying to prevent the system
- * from locking up the buffer itself.  We might want to adjust this someday, but for
- * testing this seems like a reasonable compromise.
+ * The stream endpoint replies with a chunked HTTP response, which carries one
+ * message per frame. Each message starts with the size of a JSON header as a
+ * little endian uint32, followed by the header and the selected fields of the
+ * frame. The header holds the frame metadata, a @c seq count of the frames seen
+ * by this stage, and a @c fields list with the @c name, @c offset (from the end
+ * of the header), @c size in bytes, @c dtype (numpy style) and @c shape of each
+ * field. If a client falls behind, frames are dropped for it rather than queued.
  *
  * @par REST Endpoints
  * @endpoint /inspect_frame/\<buffer name\> ``GET`` Returns binary data from the
  *           latest frame in the buffer given in @p in_buf
+ * @endpoint /inspect_frame/\<buffer name\>/stream ``GET`` Streams frames, with the
+ *           query arguments:
+ *           - @c every  Send at most one frame out of this many (default 1).
+ *           - @c fields Comma separated list of the fields to send (default all):
+ *                       for @c vis: vis, weight, flags, eval, evec, erms, gain;
+ *                       for @c hfb: hfb, weight; for @c raw: data.
+ *           - @c max_frames End the stream after this many frames (default 0,
+ *                       i.e. never).
  *
  * @par Buffers
  * @buffer in_buf Input kotekan buffer
- *     @buffer_format Any
+ *     @buffer_format Any, or VisBuffer/HFBBuffer for the field selection
  *     @buffer_metadata Any
  * @conf   len   Int. the amount of bindary data in bytes to return from the
  *               front of the latest frame. Default the frame size of @c in_buf
- *               Note if set to zero, this will be set to frame size of @c in_buf
- *
- * @warning This stage makes a copy of the data in each and every frame ( upto @c len ).
- *          So it should not be used in places where this extra memory copy would be
- *          expensive for the system to deal with, and should only be enabled when it
- *          is needed for trouble shooting.
+ *               Note if set to zero, this will be set to frame size of @c in_buf.
+ *               Always the frame size for the @c vis and @c hfb formats.
+ * @conf   format         String. How to interpret the frames: @c raw (default),
+ *                        @c vis (VisFrameView) or @c hfb (HFBFrameView).
+ * @conf   num_snapshots  Int. The number of frame copies to keep, one more than
+ *                        the concurrent GET requests is enough. Default 4.
+ * @conf   max_streams    Int. The maximum number of streaming clients. Default 8.
+ * @conf   stream_backlog Int. The number of bytes which may wait to be sent to a
+ *                        streaming client before frames are dropped. Default 16 MiB.
+ * @conf   get_timeout    Double. Seconds after a GET request during which every
+ *                        frame is copied, even if the streams skip frames.
+ *                        Default 10.
  *
- * @todo Once the new buffers are implemented this should use the frame "freeze out"
- *       method instead of doing memory copies.
+ * @warning Unless only streams with @c every > 1 are open this stage makes a copy
+ *          of the data in each and every frame ( upto @c len ). So it should not be
+ *          used in places where this extra memory copy would be expensive for the
+ *          system to deal with, and should only be enabled when it is needed for
+ *          trouble shooting.
  *
  * @author Andre Renard
  */
@@ -54,11 +86,11 @@ public:
     /// Destructor
     virtual ~restInspectFrame();
 
-    /// Gets the latest frame from @c in_buf and copies it to @c frame_copy
+    /// Gets the latest frame from @c in_buf and copies it to a snapshot if wanted
     void main_thread() override;
 
     /**
-     * @brief Retruns the binary data in @c frame_copy to the REST client
+     * @brief Retruns the binary data of the latest snapshot to the REST client
      *
      * Internal callback function, shouldn't be directly called
      * outside the HTTP/REST server
@@ -67,28 +99,84 @@ public:
      */
     void rest_callback(kotekan::connectionInstance& conn);
 
+    /**
+     * @brief Starts streaming frames to the REST client
+     *
+     * Internal callback function, shouldn't be directly called
+     * outside the HTTP/REST server
+     *
+     * @param conn The HTTP connection object
+     */
+    void stream_callback(kotekan::connectionInstance& conn);
+
 private:
+    /// A part of a frame which can be streamed
+    struct frameField {
+        std::string name;
+        size_t start, end;
+        std::string dtype;
+        std::vector<size_t> shape;
+    };
+
+    /// A streaming client
+    struct subscriber {
+        std::unique_ptr<kotekan::restStream> stream;
+        uint64_t every;
+        std::vector<std::string> fields;
+        uint64_t max_frames;
+        uint64_t sent = 0;
+        /// The first frame to send next
+        uint64_t next_seq = 0;
+    };
+
+    /// Sends the snapshots to the stream subscribers
+    void stream_thread();
+
+    /// The fields of a snapshot, and its metadata as JSON
+    std::vector<frameField> get_fields(const SnapshotPool::snapshot& s, nlohmann::json& header);
+
+    /// The names of the fields for @c format
+    std::vector<std::string> field_names();
+
     /// The buffer to allow inspections on.
     struct Buffer* in_buf;
 
     /// The name (from the config) of the buffer we are inspecting
     std::string in_buf_config_name;
 
-    /// The part of the frame to hold off to side for
-    /// the REST call back.
-    uint8_t* frame_copy;
+    /// How to interpret the frames (raw, vis or hfb)
+    std::string format;
 
-    /// Locks changes to @c frame_copy
-    std::mutex frame_copy_lock;
+    /// The copies of recent frames
+    std::unique_ptr<SnapshotPool> snapshots;
 
-    /// The REST server endpoint name
-    std::string endpoint;
+    /// The REST server endpoint names
+    std::string endpoint, stream_endpoint;
 
     /// Has the REST server end point been registered?
     bool registered;
 
-    /// The length of the frame_copy array.
+    /// The length of the frame copies.
     int32_t len;
+
+    /// Config values
+    size_t max_streams, stream_backlog;
+    double get_timeout;
+
+    /// Frames are copied until then (steady clock nanoseconds), set by GET requests
+    std::atomic<int64_t> copy_until;
+
+    /// The first frame the streams want next, the maximum if there are no streams
+    std::atomic<uint64_t> next_stream_seq;
+
+    /// The streaming clients
+    std::vector<subscriber> subscribers;
+
+    /// Locks @c subscribers (never taken by @c main_thread)
+    std::mutex subscriber_lock;
+
+    /// Wakes up @c stream_thread for new snapshots and subscribers
+    std::condition_variable stream_cond;
 };
 
 #endif /* REST_INSPECT_FRAME_HPP */
@@ -3,6 +3,7 @@
 #include "Config.hpp"            // for Config
 #include "StageFactory.hpp"      // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
 #include "Telescope.hpp"         // for Telescope
+#include "UdpTransmitter.hpp"    // for UdpTransmitter
 #include "buffer.h"              // for mark_frame_empty, register_consumer, wait_for_full_frame
 #include "bufferContainer.hpp"   // for bufferContainer
 #include "chimeMetadata.hpp"     // for stream_t, get_fpga_seq_num, get_stream_id
@@ -31,7 +32,7 @@
 #include <stdlib.h>     // for free, malloc
 #include <string.h>     // for memcpy, memset
 #include <string>       // for string, allocator, to_string, operator+, operator==
-#include <sys/socket.h> // for sendto, socket, AF_INET, SOCK_DGRAM
+#include <sys/socket.h> // for socket, AF_INET, SOCK_DGRAM
 #include <vector>       // for vector
 
 
@@ -122,7 +123,7 @@ void rfiBroadcast::main_thread() {
     uint32_t frame_id = 0;
     uint32_t frame_mask_id = 0;
     uint32_t i, j, f;
-    uint32_t bytes_sent = 0;
+    size_t bytes_sent = 0;
     uint8_t* frame = nullptr;
     uint8_t* frame_mask = nullptr;
     uint32_t link_id = 0;
@@ -144,10 +145,10 @@ void rfiBroadcast::main_thread() {
                                    .seq_num = 0,
                                    .streamID = 0};
 
-    // Initialize empty packet
+    // Initialize empty packets, one per link so they can be sent in one batch
     uint32_t packet_length =
         sizeof(rfi_header) + _num_local_freq * sizeof(uint32_t) + _num_local_freq * sizeof(float);
-    char* packet_buffer = (char*)malloc(packet_length);
+    char* packet_buffers = (char*)malloc(total_links * packet_length);
     // Filter by protocol, currently only UDP supported
     if (dest_protocol == "UDP") {
         // UDP Stuff
@@ -155,7 +156,7 @@ void rfiBroadcast::main_thread() {
         socket_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
         if (socket_fd == -1) {
             ERROR("Could not create UDP socket for output stream");
-            free(packet_buffer);
+            free(packet_buffers);
             return;
         }
         memset((char*)&saddr_remote, 0, sizeof(sockaddr_in));
@@ -165,6 +166,8 @@ void rfiBroadcast::main_thread() {
             ERROR("Invalid address given for remote server");
             return;
         }
+        UdpTransmitter tx(config, unique_name);
+        size_t dest = tx.add_destination(tx.add_socket(socket_fd), saddr_remote);
         // Connection successful
         INFO("UDP Connection: {:d} {:s}", dest_port, dest_server_ip);
         // Endless loop
@@ -258,6 +261,7 @@ void rfiBroadcast::main_thread() {
                 // Add Stream ID to header
                 // TODO: stream_id - this uses internal knowledge of the structure
                 rfi_header.streamID = (uint16_t)(StreamIDs[j].id);
+                char* packet_buffer = packet_buffers + j * packet_length;
                 // Add Header to packet
                 memcpy(packet_buffer, &rfi_header, sizeof(rfi_header));
                 // Add frequency bins to packet
@@ -266,23 +270,24 @@ void rfiBroadcast::main_thread() {
                 // Add Data to packet
                 memcpy(packet_buffer + sizeof(rfi_header) + _num_local_freq * sizeof(uint32_t),
                        rfi_avg[j], _num_local_freq * sizeof(float));
-                // Send Packet
-                bytes_sent = sendto(socket_fd, packet_buffer, packet_length, 0,
-                                    (struct sockaddr*)&saddr_remote, sizeof(sockaddr_in));
-                // Check if packet sent properly
-                if (bytes_sent != packet_length)
-                    ERROR("SOMETHING WENT WRONG IN UDP TRANSMIT");
+                // Queue Packet
+                tx.send(dest, packet_buffer, packet_length);
             }
+            // Send the packets of all links
+            bytes_sent = tx.flush();
+            // Check if the packets were sent properly
+            if (bytes_sent != total_links * packet_length)
+                ERROR("SOMETHING WENT WRONG IN UDP TRANSMIT");
             // Adjust fake_seq num (only for replay mode)
             fake_seq += _samples_per_data_set * _frames_per_packet;
             // Unlock callback mutex
             rest_callback_mutex.unlock();
             rest_zero_callback_mutex.unlock();
-            DEBUG("Frame ID {:d} Successfully Broadcasted {:d} links of {:d} Bytes in {:f}ms",
+            DEBUG("Frame ID {:d} Successfully Broadcasted {:d} links, {:d} Bytes in {:f}ms",
                   frame_id, total_links, bytes_sent, (e_time() - start_time) * 1000);
         }
     } else {
         ERROR("Bad protocol: {:s} Only UDP currently Supported", dest_protocol);
     }
-    free(packet_buffer);
+    free(packet_buffers);
 }
@@ -56,6 +56,8 @@
  * @conf   dest_server_ip       String, The IP address of the stream destination (Example:
  * 192.168.52.174)
  * @conf   dest_protocol        String, Currently only supports 'UDP'
+ * @conf   tx_batch_size        Int (default 64). Packets sent per @c sendmmsg, see
+ *                              @c UdpTransmitter.
  *
  * @author Jacob Taylor
  */
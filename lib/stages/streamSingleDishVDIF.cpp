@@ -2,6 +2,7 @@
 
 #include "Config.hpp"          // for Config
 #include "StageFactory.hpp"    // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
+#include "UdpTransmitter.hpp"  // for UdpTransmitter
 #include "buffer.h"            // for mark_frame_empty, register_consumer, wait_for_full_frame
 #include "bufferContainer.hpp" // for bufferContainer
 #include "kotekanLogging.hpp"  // for ERROR, INFO
@@ -15,7 +16,7 @@
 #include <stdio.h>      // for size_t
 #include <stdlib.h>     // for exit
 #include <string.h>     // for memset
-#include <sys/socket.h> // for sendto, socket, AF_INET, SOCK_DGRAM
+#include <sys/socket.h> // for socket, AF_INET, SOCK_DGRAM
 #include <vector>       // for vector
 
 
@@ -70,6 +71,9 @@ void streamSingleDishVDIF::main_thread() {
         return;
     }
 
+    UdpTransmitter tx(config, unique_name);
+    size_t dest = tx.add_destination(tx.add_socket(socket_fd), saddr_remote);
+
     INFO("Starting VDIF data stream thread to {:s}:{:d}", dest_ip, dest_port);
 
     while (!stop_thread) {
@@ -81,22 +85,8 @@ void streamSingleDishVDIF::main_thread() {
 
         // Send data to remote server.
         // TODO rate limit this output
-        for (int i = 0; i < in_buf->frame_size / packet_size; ++i) {
-
-            int bytes_sent = sendto(socket_fd, (void*)&frame[packet_size * i], packet_size, 0,
-                                    (struct sockaddr*)&saddr_remote, saddr_len);
-
-            if (bytes_sent == -1) {
-                ERROR("Cannot set VDIF packet");
-                break;
-            }
-
-            if (bytes_sent != packet_size) {
-                ERROR("Did not send full vdif packet.");
-            }
-
-            //            if (i%2048 == 0) usleep(200);
-        }
+        tx.send_segments(dest, frame, packet_size, in_buf->frame_size / packet_size);
+        tx.flush();
 
         // Mark buffer as empty.
         mark_frame_empty(in_buf, unique_name.c_str(), frame_id);
@@ -29,6 +29,8 @@
  * @conf   num_freq               Int. Number of time samples to sum.
  * @conf   dest_port              Int. Number of time samples to sum.
  * @conf   dest_server_ip         Int. Number of time samples to sum.
+ * @conf   tx_gso                 Bool (default false). Send the packets with UDP segmentation
+ *                                offload, see @c UdpTransmitter.
  *
  * @note    Hasn't been tested lately, should confirm this still works!
  *
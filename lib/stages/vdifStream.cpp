@@ -2,23 +2,24 @@
 
 #include "Config.hpp"          // for Config
 #include "StageFactory.hpp"    // for REGISTER_KOTEKAN_STAGE, StageMakerTemplate
+#include "UdpTransmitter.hpp"  // for UdpTransmitter
 #include "buffer.h"            // for mark_frame_empty, register_consumer, wait_for_full_frame
 #include "bufferContainer.hpp" // for bufferContainer
 #include "kotekanLogging.hpp"  // for ERROR, INFO
 #include "util.h"              // for e_time
 
+#include <algorithm>    // for max
 #include <arpa/inet.h>  // for inet_aton
 #include <atomic>       // for atomic_bool
-#include <errno.h>      // for errno
 #include <exception>    // for exception
 #include <functional>   // for _Bind_helper<>::type, bind, function
 #include <netinet/in.h> // for sockaddr_in, IPPROTO_UDP, htons
 #include <regex>        // for match_results<>::_Base_type
+#include <stdint.h>     // for uint64_t
 #include <stdio.h>      // for size_t
-#include <string.h>     // for memset, strerror
+#include <string.h>     // for memset
 #include <string>       // for string, allocator
-#include <sys/socket.h> // for sendto, socket, AF_INET, SOCK_DGRAM
-#include <unistd.h>     // for usleep
+#include <sys/socket.h> // for socket, AF_INET, SOCK_DGRAM
 #include <vector>       // for vector
 
 
@@ -47,7 +48,6 @@ void vdifStream::main_thread() {
     uint8_t* frame = nullptr;
 
     double start_t, diff_t;
-    int sleep_period = 3000;
 
     // UDP variables
     struct sockaddr_in saddr_remote;
@@ -55,6 +55,12 @@ void vdifStream::main_thread() {
     const size_t saddr_len = sizeof(saddr_remote);
 
     const uint32_t packet_size = 5032;
+    const int num_packets = 16 * 625;
+
+    // Packets go out in bursts, spread over most of the second a frame covers to leave some
+    // slack for catching up.
+    const int packets_per_burst = 50;
+    const uint64_t burst_spacing = 970000000 / (num_packets / packets_per_burst);
 
     socket_fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (socket_fd == -1) {
@@ -70,6 +76,10 @@ void vdifStream::main_thread() {
         return;
     }
 
+    UdpTransmitter tx(config, unique_name);
+    size_t dest = tx.add_destination(tx.add_socket(socket_fd), saddr_remote);
+    uint64_t tx_time = 0;
+
     while (!stop_thread) {
         // IT - commented out to test performance without INFO calls.
         //        INFO("vdif_stream; waiting for full buffer to send, server_ip:{:s}:{:d}",
@@ -85,36 +95,18 @@ void vdifStream::main_thread() {
 
         start_t = e_time();
 
-        // Send data to remote server.
-        for (int i = 0; i < 16 * 625; ++i) {
-
-            int bytes_sent = sendto(socket_fd, (void*)(&frame[packet_size * i]), packet_size, 0,
-                                    (struct sockaddr*)&saddr_remote, saddr_len);
-
-            if (i % 50 == 0) {
-                usleep(sleep_period);
-            }
-
-            if (bytes_sent == -1) {
-                ERROR("Cannot send VDIF packet, error: {:s}", strerror(errno));
-                return;
-            }
-
-            if (bytes_sent != packet_size) {
-                ERROR("Did not send full vdif packet.");
-            }
+        // Send data to remote server, carrying on from the last frame unless we fell behind.
+        tx_time = std::max(tx_time, UdpTransmitter::now());
+        for (int i = 0; i < num_packets; i += packets_per_burst) {
+            tx.send_segments(dest, &frame[packet_size * i], packet_size, packets_per_burst,
+                             tx_time);
+            tx_time += burst_spacing;
         }
+        tx.flush();
 
         diff_t = e_time() - start_t;
-        INFO("vdif_stream: sent 1 seconds of vdif data to {:s}:{:d} in {:f} seconds; sleep set to "
-             "{:d} microseconds",
-             _vdif_server_ip, _vdif_port, diff_t, sleep_period);
-
-        if (diff_t < 0.96) {
-            sleep_period += 50;
-        } else if (diff_t >= 0.99) {
-            sleep_period -= 100;
-        }
+        INFO("vdif_stream: sent 1 seconds of vdif data to {:s}:{:d} in {:f} seconds",
+             _vdif_server_ip, _vdif_port, diff_t);
 
         // Mark buffer as empty.
         mark_frame_empty(buf, unique_name.c_str(), frame_id);
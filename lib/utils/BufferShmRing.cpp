@@ -0,0 +1,236 @@
+#include "BufferShmRing.hpp"
+
+#include "fmt.hpp" // for format, fmt
+
+#include <errno.h>     // for errno
+#include <fcntl.h>     // for O_CREAT, O_EXCL, O_RDWR
+#include <limits.h>    // for INT_MAX
+#include <new>         // for operator new
+#include <stdexcept>   // for runtime_error
+#include <string.h>    // for strerror
+#include <sys/mman.h>  // for mmap, munmap, shm_open, shm_unlink, MAP_FAILED, MAP_SHARED
+#include <sys/stat.h>  // for fstat, stat, S_IRUSR, S_IWUSR
+#include <time.h>      // for timespec
+#include <unistd.h>    // for close, ftruncate, usleep
+#ifndef MAC_OSX
+#include <linux/futex.h> // for FUTEX_WAIT, FUTEX_WAKE
+#include <sys/syscall.h> // for SYS_futex
+#endif
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free
+                  && std::atomic<uint64_t>::is_always_lock_free,
+              "The shared memory ring needs lock-free atomics.");
+
+// "KOTKSHMR"
+static const uint64_t ring_magic = 0x524d48534b544f4bULL;
+static const uint32_t ring_version = 1;
+static const size_t page_size = 4096;
+
+static size_t round_to_page(size_t size) {
+    return (size + page_size - 1) / page_size * page_size;
+}
+
+// Sleep until *addr != val, a wake-up or the timeout. Without futexes just sleep a little.
+static void futex_wait(std::atomic<uint32_t>* addr, uint32_t val, int timeout_ms) {
+#ifndef MAC_OSX
+    struct timespec ts = {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+    syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAIT, val, &ts, nullptr, 0);
+#else
+    (void)addr;
+    (void)val;
+    usleep(timeout_ms < 1 ? 1000 : 1000 * (timeout_ms < 10 ? timeout_ms : 10));
+#endif
+}
+
+static void futex_wake(std::atomic<uint32_t>* addr) {
+#ifndef MAC_OSX
+    syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)addr;
+#endif
+}
+
+BufferShmRing::BufferShmRing(const std::string& name, uint32_t num_slots, size_t frame_size,
+                             size_t metadata_size) :
+    name(name),
+    is_writer(true) {
+
+    if (num_slots == 0 || num_slots > (1u << 30))
+        throw std::runtime_error(
+            fmt::format(fmt("Invalid number of slots {:d} for shared memory ring {:s}."),
+                        num_slots, name));
+
+    // Replace whatever a previous writer left behind
+    shm_unlink(name.c_str());
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd == -1)
+        throw std::runtime_error(fmt::format(fmt("Cannot create shared memory named {:s}: {:s}"),
+                                             name, strerror(errno)));
+
+    size_t size = slots_offset() + (size_t)num_slots * slot_size(frame_size, metadata_size);
+    if (ftruncate(fd, size) == -1) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error(fmt::format(
+            fmt("Cannot resize shared memory named {:s} to {:d} bytes: {:s}"), name, size,
+            strerror(errno)));
+    }
+    map(fd, size, PROT_READ | PROT_WRITE);
+
+    header = new (shm_addr) Header();
+    header->magic = ring_magic;
+    header->version = ring_version;
+    header->num_slots = num_slots;
+    header->frame_size = frame_size;
+    header->metadata_size = metadata_size;
+    header->slot_size = slot_size(frame_size, metadata_size);
+    header->write_seq.store(0, std::memory_order_relaxed);
+    header->read_seq.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+
+    // Readers only accept the region once this is set
+    header->ready.store(ring_magic, std::memory_order_release);
+}
+
+BufferShmRing::BufferShmRing(const std::string& name) : name(name), is_writer(false) {
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd == -1)
+        throw std::runtime_error(fmt::format(fmt("Cannot open shared memory named {:s}: {:s}"),
+                                             name, strerror(errno)));
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error(fmt::format(fmt("Cannot stat shared memory named {:s}: {:s}"),
+                                             name, strerror(errno)));
+    }
+    if ((size_t)st.st_size < slots_offset()) {
+        close(fd);
+        throw std::runtime_error(
+            fmt::format(fmt("Shared memory named {:s} is not set up by the writer yet."), name));
+    }
+    map(fd, st.st_size, PROT_READ | PROT_WRITE);
+    header = (Header*)shm_addr;
+
+    std::string error;
+    size_t expected_size = slots_offset() + (size_t)header->num_slots * header->slot_size;
+    if (header->ready.load(std::memory_order_acquire) != ring_magic)
+        error = fmt::format(fmt("Shared memory named {:s} is not a (fully set up) frame ring."),
+                            name);
+    else if (header->version != ring_version)
+        error = fmt::format(fmt("Shared memory ring {:s} has version {:d}, expected {:d}."), name,
+                            header->version, ring_version);
+    else if (shm_size != expected_size)
+        error = fmt::format(fmt("Shared memory ring {:s} has size {:d}, expected {:d}."), name,
+                            shm_size, expected_size);
+    if (!error.empty()) {
+        munmap(shm_addr, shm_size);
+        shm_addr = nullptr;
+        throw std::runtime_error(error);
+    }
+}
+
+BufferShmRing::~BufferShmRing() {
+    if (is_writer)
+        shm_unlink(name.c_str());
+    if (shm_addr)
+        munmap(shm_addr, shm_size);
+}
+
+void BufferShmRing::map(int fd, size_t size, int prot) {
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        shm_dev = st.st_dev;
+        shm_ino = st.st_ino;
+    }
+
+    void* addr = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        if (is_writer)
+            shm_unlink(name.c_str());
+        throw std::runtime_error(fmt::format(fmt("Failed to map shared memory named {:s}: {:s}"),
+                                             name, strerror(errno)));
+    }
+    shm_addr = (uint8_t*)addr;
+    shm_size = size;
+}
+
+uint8_t* BufferShmRing::metadata(uint32_t seq) const {
+    return shm_addr + slots_offset() + (size_t)(seq % header->num_slots) * header->slot_size;
+}
+
+uint8_t* BufferShmRing::frame(uint32_t seq) const {
+    return metadata(seq) + round_to_page(header->metadata_size);
+}
+
+int64_t BufferShmRing::wait_for_space(int timeout_ms) {
+    // Only the writer changes write_seq
+    uint32_t write_seq = header->write_seq.load(std::memory_order_relaxed);
+    uint32_t read_seq = header->read_seq.load(std::memory_order_acquire);
+    if (write_seq - read_seq >= header->num_slots) {
+        futex_wait(&header->read_seq, read_seq, timeout_ms);
+        read_seq = header->read_seq.load(std::memory_order_acquire);
+        if (write_seq - read_seq >= header->num_slots)
+            return -1;
+    }
+    return write_seq;
+}
+
+void BufferShmRing::publish() {
+    header->write_seq.fetch_add(1, std::memory_order_release);
+    futex_wake(&header->write_seq);
+}
+
+int64_t BufferShmRing::wait_for_data(int timeout_ms, uint32_t num_held) {
+    // Only the reader changes read_seq
+    uint32_t seq = header->read_seq.load(std::memory_order_relaxed) + num_held;
+    uint32_t write_seq = header->write_seq.load(std::memory_order_acquire);
+    if (write_seq == seq) {
+        futex_wait(&header->write_seq, write_seq, timeout_ms);
+        write_seq = header->write_seq.load(std::memory_order_acquire);
+        if (write_seq == seq)
+            return -1;
+    }
+    return seq;
+}
+
+void BufferShmRing::release() {
+    header->read_seq.fetch_add(1, std::memory_order_release);
+    futex_wake(&header->read_seq);
+}
+
+uint32_t BufferShmRing::num_full() const {
+    return header->write_seq.load(std::memory_order_acquire)
+           - header->read_seq.load(std::memory_order_acquire);
+}
+
+void BufferShmRing::close_writer() {
+    header->closed.store(1, std::memory_order_release);
+    // Wake up a reader waiting for data, so it notices
+    futex_wake(&header->write_seq);
+}
+
+bool BufferShmRing::writer_closed() const {
+    return header->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool BufferShmRing::replaced() const {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+        return true;
+    struct stat st;
+    bool same = fstat(fd, &st) == 0 && st.st_dev == shm_dev && st.st_ino == shm_ino;
+    close(fd);
+    return !same;
+}
+
+size_t BufferShmRing::slots_offset() {
+    return round_to_page(sizeof(Header));
+}
+
+size_t BufferShmRing::slot_size(size_t frame_size, size_t metadata_size) {
+    return round_to_page(metadata_size) + round_to_page(frame_size);
+}
@@ -0,0 +1,166 @@
+/*****************************************
+@file
+@brief A ring of frames in shared memory for passing buffer frames between processes.
+- BufferShmRing
+*****************************************/
+#ifndef BUFFER_SHM_RING_HPP
+#define BUFFER_SHM_RING_HPP
+
+#include <atomic>      // for atomic
+#include <stddef.h>    // for size_t
+#include <stdint.h>    // for uint32_t, uint64_t, uint8_t, int64_t
+#include <string>      // for string
+#include <sys/types.h> // for dev_t, ino_t
+
+/**
+ * @class BufferShmRing
+ * @brief Single producer, single consumer ring of frames in a POSIX shared memory region.
+ *
+ * The region starts with a page holding the layout of the ring and two
+ * counters: the number of frames written and the number of frames read. Slot
+ * @c s % num_slots holds the frame with sequence number @c s: its metadata,
+ * padded to a page, followed by the frame data, also padded to a page.
+ *
+ * The writer fills the slot at the write counter and then increments it, the
+ * reader uses the slot at the read counter and then increments that. The
+ * reader may hold on to several slots before it releases them, in order.
+ * The counters are 32-bit atomics, so either side can sleep on the other's
+ * counter with a futex (on Linux) and no syscalls are made while frames flow
+ * apart from one wake-up per frame.
+ *
+ * The writer creates the region (replacing any stale region of the same name)
+ * and removes it again when it is destroyed. The reader attaches to an
+ * existing region and can check @c writer_closed to find out whether the
+ * writer has shut down, or @c replaced to find out whether a new writer has
+ * taken over the name (e.g. after the old one crashed).
+ **/
+class BufferShmRing {
+public:
+    /**
+     * @brief Create a ring (the writer side).
+     *
+     * @param  name           Name of the shared memory region, e.g. "/kotekan_gpu".
+     * @param  num_slots      Number of frames in the ring.
+     * @param  frame_size     Size of a frame in bytes.
+     * @param  metadata_size  Size of the metadata of a frame in bytes, may be 0.
+     *
+     * @throws std::runtime_error if the region can't be created.
+     **/
+    BufferShmRing(const std::string& name, uint32_t num_slots, size_t frame_size,
+                  size_t metadata_size);
+
+    /**
+     * @brief Attach to an existing ring (the reader side).
+     *
+     * @param  name  Name of the shared memory region.
+     *
+     * @throws std::runtime_error if the region doesn't exist or isn't a fully set up ring.
+     **/
+    explicit BufferShmRing(const std::string& name);
+
+    /// Unmaps the region, and removes it if this is the writer.
+    ~BufferShmRing();
+
+    BufferShmRing(const BufferShmRing&) = delete;
+    BufferShmRing& operator=(const BufferShmRing&) = delete;
+
+    /// Number of slots.
+    uint32_t num_slots() const {
+        return header->num_slots;
+    }
+
+    /// Size of a frame in bytes.
+    size_t frame_size() const {
+        return header->frame_size;
+    }
+
+    /// Size of the metadata of a frame in bytes.
+    size_t metadata_size() const {
+        return header->metadata_size;
+    }
+
+    /// The frame data of the slot for sequence number @p seq.
+    uint8_t* frame(uint32_t seq) const;
+
+    /// The metadata of the slot for sequence number @p seq.
+    uint8_t* metadata(uint32_t seq) const;
+
+    /**
+     * @brief Wait until there is a free slot (writer).
+     *
+     * @param  timeout_ms  How long to wait at most.
+     *
+     * @return The sequence number of the free slot, or -1 on timeout.
+     **/
+    int64_t wait_for_space(int timeout_ms);
+
+    /// Pass on the slot returned by @c wait_for_space to the reader.
+    void publish();
+
+    /**
+     * @brief Wait until there is a frame to read (reader).
+     *
+     * @param  timeout_ms  How long to wait at most.
+     * @param  num_held    Number of frames read but not released yet, the
+     *                     frame after them is waited for.
+     *
+     * @return The sequence number of the frame, or -1 on timeout.
+     **/
+    int64_t wait_for_data(int timeout_ms, uint32_t num_held = 0);
+
+    /// Hand the oldest slot returned by @c wait_for_data back to the writer.
+    void release();
+
+    /// Number of frames waiting to be read or released.
+    uint32_t num_full() const;
+
+    /// Mark the ring as closed by the writer, and wake up the reader.
+    void close_writer();
+
+    /// Whether the writer has closed the ring.
+    bool writer_closed() const;
+
+    /// Whether the name now refers to a different region, or to none at all.
+    bool replaced() const;
+
+    /// Offset of the first slot from the start of the region.
+    static size_t slots_offset();
+
+    /// Size of a slot for the given frame and metadata sizes.
+    static size_t slot_size(size_t frame_size, size_t metadata_size);
+
+private:
+    /// The page at the start of the region
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t num_slots;
+        uint64_t frame_size;
+        uint64_t metadata_size;
+        uint64_t slot_size;
+        /// Frames written so far (modulo 2^32), the reader sleeps on it
+        std::atomic<uint32_t> write_seq;
+        /// Frames read so far (modulo 2^32), the writer sleeps on it
+        std::atomic<uint32_t> read_seq;
+        /// Set once the writer has shut down
+        std::atomic<uint32_t> closed;
+        /// Set to @c magic once the header is complete
+        std::atomic<uint64_t> ready;
+    };
+
+    /// Map @p size bytes of the region open on @p fd.
+    void map(int fd, size_t size, int prot);
+
+    std::string name;
+    bool is_writer;
+
+    uint8_t* shm_addr = nullptr;
+    size_t shm_size = 0;
+    Header* header = nullptr;
+
+    /// Identity of the region, to tell whether the name was reused
+    dev_t shm_dev = 0;
+    ino_t shm_ino = 0;
+};
+
+#endif // BUFFER_SHM_RING_HPP
@@ -0,0 +1,259 @@
+#include "FileArchive.hpp"
+
+#include "kotekanLogging.hpp" // for WARN, DEBUG2
+
+#include <H5public.h>               // for H5_VERSION_GE
+#include <highfive/H5DataSpace.hpp> // for DataSpace
+#include <highfive/H5Exception.hpp> // for DataSetException, HDF5ErrMapper
+#include <mutex>                    // for lock_guard, unique_lock
+
+// H5Dwrite_chunk is only in HDF5 from 1.10.3 on
+#if defined(WITH_BITSHUFFLE) && H5_VERSION_GE(1, 10, 3)
+#define DIRECT_CHUNK_WRITES
+#endif
+
+#ifdef DIRECT_CHUNK_WRITES
+#include <algorithm> // for min, fill
+#include <atomic>    // for atomic, atomic_bool
+#include <cstring>   // for memcpy
+#include <endian.h>  // for htobe32, htobe64
+#include <stdint.h>  // for uint8_t, uint32_t, uint64_t, int64_t
+
+extern "C" {
+#include <bitshuffle.h> // for bshuf_compress_lz4, bshuf_compress_lz4_bound, bshuf_default_bl...
+}
+#endif
+
+using namespace HighFive;
+
+
+FileArchive::~FileArchive() {
+    stop_pool();
+}
+
+void FileArchive::set_compression_threads(size_t num_threads) {
+    stop_pool();
+#ifdef DIRECT_CHUNK_WRITES
+    compression_threads = num_threads;
+
+    pool_stop = false;
+    for (size_t i = 0; i < num_threads; i++) {
+        pool.emplace_back([this]() {
+            std::unique_lock<std::mutex> lock(pool_lock);
+            while (true) {
+                pool_cv.wait(lock, [this]() { return pool_stop || !pool_jobs.empty(); });
+                if (pool_jobs.empty())
+                    return;
+                std::function<void()> job = std::move(pool_jobs.front());
+                pool_jobs.pop_front();
+                lock.unlock();
+                job();
+                lock.lock();
+            }
+        });
+    }
+#else
+    if (num_threads > 0)
+        WARN("FileArchive: kotekan was built without the bitshuffle library or against HDF5 "
+             "older than 1.10.3. Ignoring request for {:d} compression threads and letting the "
+             "HDF5 filter compress the data.",
+             num_threads);
+    compression_threads = 0;
+#endif
+}
+
+void FileArchive::run_on_pool(const std::function<void()>& job) {
+    std::lock_guard<std::mutex> lock(pool_lock);
+    for (size_t i = 0; i < pool.size(); i++)
+        pool_jobs.push_back(job);
+    pool_cv.notify_all();
+}
+
+void FileArchive::stop_pool() {
+    {
+        std::lock_guard<std::mutex> lock(pool_lock);
+        pool_stop = true;
+        pool_cv.notify_all();
+    }
+    for (auto& t : pool)
+        t.join();
+    pool.clear();
+}
+
+
+#ifdef DIRECT_CHUNK_WRITES
+bool FileArchive::write_chunks_direct(DataSet& dset, const std::vector<size_t>& offset,
+                                      const std::vector<size_t>& count, const void* data) {
+
+    hid_t dset_id = dset.getId();
+    hid_t dcpl = H5Dget_create_plist(dset_id);
+    if (dcpl < 0)
+        return false;
+
+    // Only datasets that bitshuffle is the sole filter on can be written directly
+    int nfilters = H5Pget_nfilters(dcpl);
+    unsigned int flags;
+    size_t cd_nelmts = 0;
+    bool bitshuffled = (nfilters == 1
+                        && H5Pget_filter2(dcpl, 0, &flags, &cd_nelmts, nullptr, 0, nullptr, nullptr)
+                               == H5Z_BITSHUFFLE);
+
+    const size_t rank = offset.size();
+    std::vector<hsize_t> chunk(rank);
+    bool chunked = bitshuffled && H5Pget_chunk(dcpl, rank, chunk.data()) == (int)rank;
+    H5Pclose(dcpl);
+    if (!chunked)
+        return false;
+
+    // The block has to consist of whole chunks (or chunks cut by the end of the dataset)
+    std::vector<size_t> dims = dset.getSpace().getDimensions();
+    std::vector<size_t> num_chunks(rank);
+    size_t total_chunks = 1;
+    for (size_t d = 0; d < rank; d++) {
+        if (offset[d] + count[d] > dims[d] || offset[d] % chunk[d] != 0
+            || (count[d] % chunk[d] != 0 && offset[d] + count[d] != dims[d])) {
+            DEBUG2("Block is not aligned to chunks on axis {:d}. Using the HDF5 filter.", d);
+            return false;
+        }
+        num_chunks[d] = (count[d] + chunk[d] - 1) / chunk[d];
+        total_chunks *= num_chunks[d];
+    }
+    if (total_chunks == 0)
+        return true;
+
+    hid_t type_id = H5Dget_type(dset_id);
+    const size_t elem_size = H5Tget_size(type_id);
+    H5Tclose(type_id);
+
+    size_t chunk_elems = 1;
+    for (auto c : chunk)
+        chunk_elems *= c;
+    const size_t chunk_bytes = chunk_elems * elem_size;
+    const size_t block_size = BSHUF_BLOCK ? BSHUF_BLOCK : bshuf_default_block_size(elem_size);
+    const size_t max_compressed =
+        12 + bshuf_compress_lz4_bound(chunk_elems, elem_size, block_size);
+
+    // Index of the first element of a chunk (relative to the block) for every chunk
+    auto chunk_start = [&](size_t k) {
+        std::vector<size_t> start(rank);
+        for (size_t d = rank; d-- > 0;) {
+            start[d] = (k % num_chunks[d]) * chunk[d];
+            k /= num_chunks[d];
+        }
+        return start;
+    };
+
+    // Gather a chunk out of the block (zero padding the edges), then compress it
+    // into the format the bitshuffle filter would have produced
+    auto compress_chunk = [&](size_t k, std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+        std::vector<size_t> start = chunk_start(k);
+        std::vector<size_t> extent(rank);
+        bool partial = false;
+        for (size_t d = 0; d < rank; d++) {
+            extent[d] = std::min((size_t)chunk[d], count[d] - start[d]);
+            partial |= (extent[d] != chunk[d]);
+        }
+        if (partial)
+            std::fill(in.begin(), in.end(), 0);
+
+        // Copy contiguous runs along the last axis
+        const size_t row_bytes = extent[rank - 1] * elem_size;
+        size_t num_rows = 1;
+        for (size_t d = 0; d + 1 < rank; d++)
+            num_rows *= extent[d];
+        for (size_t r = 0; r < num_rows; r++) {
+            size_t src = 0, dst = 0, rem = r;
+            std::vector<size_t> idx(rank, 0);
+            for (size_t d = rank - 1; d-- > 0;) {
+                idx[d] = rem % extent[d];
+                rem /= extent[d];
+            }
+            for (size_t d = 0; d < rank; d++) {
+                src = src * count[d] + start[d] + idx[d];
+                dst = dst * chunk[d] + idx[d];
+            }
+            std::memcpy(in.data() + dst * elem_size, (const uint8_t*)data + src * elem_size,
+                        row_bytes);
+        }
+
+        out.resize(max_compressed);
+        uint64_t nbytes_be = htobe64(chunk_bytes);
+        uint32_t block_be = htobe32(block_size * elem_size);
+        std::memcpy(out.data(), &nbytes_be, 8);
+        std::memcpy(out.data() + 8, &block_be, 4);
+        int64_t nbytes =
+            bshuf_compress_lz4(in.data(), out.data() + 12, chunk_elems, elem_size, block_size);
+        if (nbytes < 0)
+            return false;
+        out.resize(12 + nbytes);
+        return true;
+    };
+
+    // Compressed chunks are handed back to this thread in order, which writes
+    // them while the pool keeps compressing
+    std::vector<std::vector<uint8_t>> compressed(total_chunks);
+    std::vector<char> ready(total_chunks, 0);
+    std::atomic<size_t> next_chunk(0);
+    std::atomic_bool failed(false);
+    size_t workers_done = 0;
+    std::mutex ready_lock;
+    std::condition_variable ready_cv;
+
+    run_on_pool([&]() {
+        std::vector<uint8_t> in(chunk_bytes);
+        size_t k;
+        while (!failed && (k = next_chunk++) < total_chunks) {
+            std::vector<uint8_t> out;
+            bool ok = compress_chunk(k, in, out);
+            std::lock_guard<std::mutex> lock(ready_lock);
+            compressed[k] = std::move(out);
+            ready[k] = 1;
+            if (!ok)
+                failed = true;
+            ready_cv.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(ready_lock);
+        workers_done++;
+        ready_cv.notify_all();
+    });
+
+    std::vector<hsize_t> chunk_offset(rank);
+    for (size_t k = 0; k < total_chunks && !failed; k++) {
+        std::vector<uint8_t> buf;
+        {
+            std::unique_lock<std::mutex> lock(ready_lock);
+            ready_cv.wait(lock, [&]() { return ready[k] || failed; });
+            if (failed)
+                break;
+            buf = std::move(compressed[k]);
+        }
+
+        std::vector<size_t> start = chunk_start(k);
+        for (size_t d = 0; d < rank; d++)
+            chunk_offset[d] = offset[d] + start[d];
+        if (H5Dwrite_chunk(dset_id, H5P_DEFAULT, 0, chunk_offset.data(), buf.size(), buf.data())
+            < 0) {
+            failed = true;
+            break;
+        }
+    }
+
+    // The jobs refer to the locals of this call, so wait for all of them to finish
+    {
+        std::unique_lock<std::mutex> lock(ready_lock);
+        ready_cv.wait(lock, [&]() { return workers_done == pool.size(); });
+    }
+
+    if (failed) {
+        HDF5ErrMapper::ToException<DataSetException>(
+            "Failed trying to compress and write chunks directly.");
+    }
+
+    return true;
+}
+#else
+bool FileArchive::write_chunks_direct(DataSet&, const std::vector<size_t>&,
+                                      const std::vector<size_t>&, const void*) {
+    return false;
+}
+#endif
@@ -3,16 +3,45 @@
 
 #include "kotekanLogging.hpp" // for logLevel, kotekanLogging
 
+#include <condition_variable>          // for condition_variable
+#include <deque>                       // for deque
+#include <functional>                  // for function
+#include <highfive/H5DataSet.hpp>      // for DataSet
 #include <highfive/H5PropertyList.hpp> // for H5Pcreate, H5Pset_chunk, H5Pset_filter, H5P_DATAS...
+#include <mutex>                       // for mutex
+#include <stddef.h>                    // for size_t
+#include <thread>                      // for thread
+#include <vector>                      // for vector
 
 /** @brief A Bitshuffle header file.
  *
  * Header file to store common Bitshuffle constants.
  *
+ * If kotekan was built against the bitshuffle library (`WITH_BITSHUFFLE`) and
+ * HDF5 1.10.3 or later, the archive can also compress chunks itself on a pool
+ * of worker threads and store them with `H5Dwrite_chunk`, bypassing the
+ * (single threaded) filter pipeline of the HDF5 library. Otherwise the HDF5
+ * filter compresses the chunks as before. The chunks carry the same header as the ones written by
+ * the bitshuffle HDF5 filter, so the files stay readable by any
+ * bitshuffle-enabled reader.
+ *
  * @author James Willis
  **/
 class FileArchive : public kotekan::kotekanLogging {
 
+public:
+    ~FileArchive();
+
+    /**
+     * @brief Compress chunks in parallel and write them directly to the file.
+     *
+     * The threads are started here and kept until the archive is closed.
+     *
+     * @param num_threads Number of compression threads. 0 disables direct chunk
+     *                    writes and leaves compression to the HDF5 filter.
+     **/
+    void set_compression_threads(size_t num_threads);
+
 protected:
     // Bitshuffle parameters
     H5Z_filter_t H5Z_BITSHUFFLE = 32008;
@@ -20,6 +49,55 @@ protected:
     unsigned int BSHUF_BLOCK = 0; // let bitshuffle choose
 
     const std::vector<unsigned int> BSHUF_CD = {BSHUF_BLOCK, BSHUF_H5_COMPRESS_LZ4};
+
+    /**
+     * @brief Write a hyperslab of a bitshuffle compressed dataset chunk by chunk.
+     *
+     * The block must start on a chunk boundary and cover every chunk it touches
+     * up to the end of that chunk or of the dataset. If that is not the case, or
+     * direct chunk writes are disabled, the data is handed to the HDF5 filter
+     * pipeline as usual.
+     *
+     * @param dset   Dataset to write into.
+     * @param offset Start of the block in the dataset.
+     * @param count  Shape of the block.
+     * @param data   Pointer to the block in C order.
+     **/
+    template<typename T>
+    void write_compressed(HighFive::DataSet dset, const std::vector<size_t>& offset,
+                          const std::vector<size_t>& count, const T* data);
+
+private:
+    // Compress all chunks covered by the block and write them with H5Dwrite_chunk.
+    // Returns false if the block can't be written this way.
+    bool write_chunks_direct(HighFive::DataSet& dset, const std::vector<size_t>& offset,
+                             const std::vector<size_t>& count, const void* data);
+
+    // Run a job on each of the compression threads
+    void run_on_pool(const std::function<void()>& job);
+
+    // Stop and join the compression threads
+    void stop_pool();
+
+    // Number of threads compressing chunks (0: use HDF5 filter)
+    size_t compression_threads = 0;
+
+    // The compression threads, and the jobs queued for them
+    std::vector<std::thread> pool;
+    std::deque<std::function<void()>> pool_jobs;
+    bool pool_stop = false;
+    std::mutex pool_lock;
+    std::condition_variable pool_cv;
 };
 
+
+template<typename T>
+void FileArchive::write_compressed(HighFive::DataSet dset, const std::vector<size_t>& offset,
+                                   const std::vector<size_t>& count, const T* data) {
+    if (compression_threads > 0 && write_chunks_direct(dset, offset, count, data))
+        return;
+
+    dset.select(offset, count).write(data);
+}
+
 #endif
@@ -0,0 +1,240 @@
+#include "FrameCompression.hpp"
+
+#include "fmt.hpp" // for format, fmt
+
+#include <stdexcept> // for invalid_argument
+#include <string.h>  // for memcpy
+#ifdef WITH_LZ4
+#include <lz4.h> // for LZ4_compress_fast, LZ4_decompress_safe
+#endif
+#ifdef WITH_ZSTD
+#include <zstd.h> // for ZSTD_compressCCtx, ZSTD_decompressDCtx, ZSTD_isError, ZSTD_CCtx
+#endif
+#ifdef WITH_BITSHUFFLE
+extern "C" {
+#include <bitshuffle.h> // for bshuf_bitshuffle, bshuf_bitunshuffle
+}
+#endif
+
+frameCodec frame_codec_from_string(const std::string& name) {
+    if (name == "none")
+        return frameCodec::none;
+    if (name == "lz4")
+        return frameCodec::lz4;
+    if (name == "zstd")
+        return frameCodec::zstd;
+    throw std::invalid_argument(
+        fmt::format(fmt("Unknown frame compression codec \"{:s}\" (none, lz4 or zstd)."), name));
+}
+
+std::string frame_codec_name(frameCodec codec) {
+    switch (codec) {
+        case frameCodec::none:
+            return "none";
+        case frameCodec::lz4:
+            return "lz4";
+        case frameCodec::zstd:
+            return "zstd";
+    }
+    return fmt::format(fmt("unknown ({:d})"), (int)codec);
+}
+
+bool frame_codec_available(frameCodec codec) {
+    switch (codec) {
+        case frameCodec::none:
+            return true;
+        case frameCodec::lz4:
+#ifdef WITH_LZ4
+            return true;
+#else
+            return false;
+#endif
+        case frameCodec::zstd:
+#ifdef WITH_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+#ifndef WITH_BITSHUFFLE
+// Block size used by the bitshuffle library
+static const size_t bshuf_target_block_bytes = 8192;
+static const size_t bshuf_min_block = 128;
+
+static size_t bshuf_block_size(size_t elem_size) {
+    size_t block = bshuf_target_block_bytes / elem_size / 8 * 8;
+    return block < bshuf_min_block ? bshuf_min_block : block;
+}
+
+// Transpose the 8x8 bit matrix held in the bytes of x
+static inline uint64_t transpose_bits_8x8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+// Bit-transpose a block of n elements, n a multiple of 8. Within the block, bit k of
+// byte b of all the elements ends up in row 8 * b + k of n / 8 bytes.
+static void bitshuffle_block(const uint8_t* src, uint8_t* dst, size_t n, size_t elem_size,
+                             bool reverse) {
+    const size_t row = n / 8;
+    for (size_t b = 0; b < elem_size; b++) {
+        for (size_t g = 0; g < row; g++) {
+            uint64_t x = 0;
+            if (!reverse) {
+                for (size_t i = 0; i < 8; i++)
+                    x |= (uint64_t)src[(8 * g + i) * elem_size + b] << (8 * i);
+            } else {
+                for (size_t k = 0; k < 8; k++)
+                    x |= (uint64_t)src[(8 * b + k) * row + g] << (8 * k);
+            }
+            x = transpose_bits_8x8(x);
+            if (!reverse) {
+                for (size_t k = 0; k < 8; k++)
+                    dst[(8 * b + k) * row + g] = (uint8_t)(x >> (8 * k));
+            } else {
+                for (size_t i = 0; i < 8; i++)
+                    dst[(8 * g + i) * elem_size + b] = (uint8_t)(x >> (8 * i));
+            }
+        }
+    }
+}
+#endif
+
+static void bitshuffle_array(const uint8_t* src, uint8_t* dst, size_t size, size_t elem_size,
+                             bool reverse) {
+    if (elem_size == 0) {
+        memcpy(dst, src, size);
+        return;
+    }
+    const size_t num_elem = size / elem_size;
+#ifdef WITH_BITSHUFFLE
+    if (reverse)
+        bshuf_bitunshuffle(src, dst, num_elem, elem_size, 0);
+    else
+        bshuf_bitshuffle(src, dst, num_elem, elem_size, 0);
+#else
+    const size_t block = bshuf_block_size(elem_size);
+    const size_t shuffled = num_elem / 8 * 8 * elem_size;
+    size_t done = 0;
+    while (done < num_elem / 8 * 8) {
+        size_t n = num_elem - done < block ? (num_elem - done) / 8 * 8 : block;
+        bitshuffle_block(src + done * elem_size, dst + done * elem_size, n, elem_size, reverse);
+        done += n;
+    }
+    // The last few elements
+    memcpy(dst + shuffled, src + shuffled, num_elem * elem_size - shuffled);
+#endif
+    // The bytes that don't make up an element
+    memcpy(dst + num_elem * elem_size, src + num_elem * elem_size, size - num_elem * elem_size);
+}
+
+void bitshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elem_size) {
+    bitshuffle_array(src, dst, size, elem_size, false);
+}
+
+void bitunshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elem_size) {
+    bitshuffle_array(src, dst, size, elem_size, true);
+}
+
+FrameCompressor::FrameCompressor() {}
+
+FrameCompressor::~FrameCompressor() {
+#ifdef WITH_ZSTD
+    ZSTD_freeCCtx((ZSTD_CCtx*)zstd_cctx);
+    ZSTD_freeDCtx((ZSTD_DCtx*)zstd_dctx);
+#endif
+}
+
+size_t FrameCompressor::compress(frameCodec codec, int level, uint32_t shuffle_size,
+                                 const uint8_t* src, size_t size, std::vector<uint8_t>& dst) {
+    if (codec == frameCodec::none || size < 2)
+        return 0;
+
+    if (shuffle_size > 0) {
+        scratch.resize(size);
+        bitshuffle(src, scratch.data(), size, shuffle_size);
+        src = scratch.data();
+    }
+
+    // Only a compressed frame smaller than the original is any use
+    const size_t capacity = size - 1;
+    if (dst.size() < capacity)
+        dst.resize(capacity);
+
+    switch (codec) {
+#ifdef WITH_LZ4
+        case frameCodec::lz4: {
+            if (size > (size_t)LZ4_MAX_INPUT_SIZE)
+                return 0;
+            int n = LZ4_compress_fast((const char*)src, (char*)dst.data(), (int)size,
+                                      (int)capacity, level > 0 ? level : 1);
+            return n > 0 ? (size_t)n : 0;
+        }
+#endif
+#ifdef WITH_ZSTD
+        case frameCodec::zstd: {
+            if (zstd_cctx == nullptr)
+                zstd_cctx = ZSTD_createCCtx();
+            size_t n = ZSTD_compressCCtx((ZSTD_CCtx*)zstd_cctx, dst.data(), capacity, src, size,
+                                         level > 0 ? level : 1);
+            return ZSTD_isError(n) ? 0 : n;
+        }
+#endif
+        default:
+            (void)level;
+            throw std::invalid_argument(
+                fmt::format(fmt("kotekan was built without the {:s} frame compression codec."),
+                            frame_codec_name(codec)));
+    }
+}
+
+bool FrameCompressor::decompress(frameCodec codec, uint32_t shuffle_size, const uint8_t* src,
+                                 size_t src_size, uint8_t* dst, size_t dst_size) {
+    uint8_t* out = dst;
+    if (shuffle_size > 0) {
+        scratch.resize(dst_size);
+        out = scratch.data();
+    }
+
+    bool ok = false;
+    switch (codec) {
+        case frameCodec::none:
+            ok = src_size == dst_size;
+            if (ok)
+                memcpy(out, src, src_size);
+            break;
+#ifdef WITH_LZ4
+        case frameCodec::lz4: {
+            if (src_size > (size_t)LZ4_MAX_INPUT_SIZE || dst_size > (size_t)LZ4_MAX_INPUT_SIZE)
+                return false;
+            int n = LZ4_decompress_safe((const char*)src, (char*)out, (int)src_size, (int)dst_size);
+            ok = n >= 0 && (size_t)n == dst_size;
+            break;
+        }
+#endif
+#ifdef WITH_ZSTD
+        case frameCodec::zstd: {
+            if (zstd_dctx == nullptr)
+                zstd_dctx = ZSTD_createDCtx();
+            size_t n = ZSTD_decompressDCtx((ZSTD_DCtx*)zstd_dctx, out, dst_size, src, src_size);
+            ok = !ZSTD_isError(n) && n == dst_size;
+            break;
+        }
+#endif
+        default:
+            return false;
+    }
+
+    if (ok && shuffle_size > 0)
+        bitunshuffle(out, dst, dst_size, shuffle_size);
+    return ok;
+}
@@ -0,0 +1,113 @@
+/*****************************************
+@file
+@brief Compression of whole buffer frames for sending them over the network.
+- frameCodec
+- FrameCompressor
+*****************************************/
+#ifndef FRAME_COMPRESSION_HPP
+#define FRAME_COMPRESSION_HPP
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint8_t, uint32_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @brief The codecs a frame can be compressed with.
+ *
+ * The values go over the wire in @c bufferFrameHeader, so they must not change.
+ **/
+enum class frameCodec : uint8_t { none = 0, lz4 = 1, zstd = 2 };
+
+/**
+ * @brief Parse a codec name ("none", "lz4" or "zstd").
+ *
+ * @throws std::invalid_argument for an unknown name.
+ **/
+frameCodec frame_codec_from_string(const std::string& name);
+
+/// The name of a codec.
+std::string frame_codec_name(frameCodec codec);
+
+/// Whether kotekan was built with the library for the codec.
+bool frame_codec_available(frameCodec codec);
+
+/**
+ * @brief Transpose the bits of an array of elements, as the bitshuffle library does.
+ *
+ * After a bitshuffle the first bits of all elements come first, then the second
+ * bits, and so on. For slowly varying numbers (e.g. truncated floats) most of
+ * the resulting bytes are constant, which compresses much better than the
+ * elements themselves. The array is processed in blocks of a few kB, and the
+ * elements of a last block of fewer than 8 elements are copied unchanged, so
+ * the output is identical to the one of @c bshuf_bitshuffle with the default
+ * block size. If kotekan is built with the bitshuffle library (@c WITH_BITSHUFFLE)
+ * its vectorised implementation is used.
+ *
+ * @param  src        The elements.
+ * @param  dst        Space for the shuffled elements, must not overlap @p src.
+ * @param  size       Size of the array in bytes.
+ * @param  elem_size  Size of an element in bytes. Trailing bytes that don't
+ *                    make up an element are copied unchanged.
+ **/
+void bitshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elem_size);
+
+/// Undo a @c bitshuffle.
+void bitunshuffle(const uint8_t* src, uint8_t* dst, size_t size, size_t elem_size);
+
+/**
+ * @class FrameCompressor
+ * @brief Compresses and decompresses frames, optionally after a bitshuffle.
+ *
+ * Keeps the scratch space and the codec contexts around between frames, so one
+ * instance should be used per thread.
+ **/
+class FrameCompressor {
+public:
+    FrameCompressor();
+    ~FrameCompressor();
+
+    FrameCompressor(const FrameCompressor&) = delete;
+    FrameCompressor& operator=(const FrameCompressor&) = delete;
+
+    /**
+     * @brief Compress a frame.
+     *
+     * @param  codec         The codec to use.
+     * @param  level         Compression level (zstd) or acceleration (lz4), 0 for the default.
+     * @param  shuffle_size  Element size to bitshuffle the frame with first, 0 for none.
+     * @param  src           The frame.
+     * @param  size          Size of the frame in bytes.
+     * @param  dst           Resized to hold the compressed frame.
+     *
+     * @return The size of the compressed frame, or 0 if it would not be smaller
+     *         than the original (@p dst is then undefined).
+     **/
+    size_t compress(frameCodec codec, int level, uint32_t shuffle_size, const uint8_t* src,
+                    size_t size, std::vector<uint8_t>& dst);
+
+    /**
+     * @brief Decompress a frame.
+     *
+     * @param  codec         The codec it was compressed with.
+     * @param  shuffle_size  The element size it was bitshuffled with, 0 for none.
+     * @param  src           The compressed frame.
+     * @param  src_size      Size of the compressed frame in bytes.
+     * @param  dst           Space for the frame.
+     * @param  dst_size      Size of the frame in bytes.
+     *
+     * @return Whether the frame decompressed to exactly @p dst_size bytes.
+     **/
+    bool decompress(frameCodec codec, uint32_t shuffle_size, const uint8_t* src, size_t src_size,
+                    uint8_t* dst, size_t dst_size);
+
+private:
+    /// The bitshuffled frame
+    std::vector<uint8_t> scratch;
+
+    /// zstd compression and decompression contexts, if used
+    void* zstd_cctx = nullptr;
+    void* zstd_dctx = nullptr;
+};
+
+#endif // FRAME_COMPRESSION_HPP
@@ -4,9 +4,21 @@
 #include "visUtil.hpp" // for freq_ctype, prod_ctype, time_ctype, input_ctype
 
 #include <highfive/H5DataType.hpp> // for DataType, AtomicType, DataType::DataType
+#include <mutex>                   // for mutex
 
 using namespace HighFive;
 
+/**
+ * @brief The lock serialising calls into libhdf5.
+ *
+ * libhdf5 isn't built thread-safe, so code creating, writing or closing HDF5
+ * files on more than one thread at once must hold it.
+ **/
+inline std::mutex& hdf5_lock() {
+    static std::mutex lock;
+    return lock;
+}
+
 const size_t DSET_ID_LEN = 33; // Length of the string used to represent dataset IDs
 struct dset_id_str {
     char hash[DSET_ID_LEN];
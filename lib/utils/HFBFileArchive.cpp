@@ -151,9 +151,8 @@ void HFBFileArchive::write_block(std::string name, size_t f_ind, size_t t_ind, s
         size_t beam_last_dim = dset(name).getSpace().getDimensions().at(2);
         // DEBUG("writing {:d} freq, {:d} times, {:d} beams, {:d} sub-freq at ({:d}, 0, 0, {:d}).
         // Data[0]: {}", chunk_f, chunk_t, beam_last_dim, subfreq_last_dim, f_ind, t_ind, data[0]);
-        dset(name)
-            .select({f_ind, 0, 0, t_ind}, {chunk_f, subfreq_last_dim, beam_last_dim, chunk_t})
-            .write(data);
+        write_compressed(dset(name), {f_ind, 0, 0, t_ind},
+                         {chunk_f, subfreq_last_dim, beam_last_dim, chunk_t}, data);
     }
 }
 
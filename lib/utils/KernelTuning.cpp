@@ -0,0 +1,19 @@
+#include "KernelTuning.hpp"
+
+using nlohmann::json;
+
+json find_tuned_parameters(const json& tuning, const std::string& command, const json& geometry) {
+    if (!tuning.is_object() || !tuning.count(command))
+        return json::object();
+    for (auto& entry : tuning.at(command)) {
+        bool match = true;
+        if (entry.count("geometry")) {
+            for (auto& it : entry.at("geometry").items())
+                if (!geometry.count(it.key()) || geometry.at(it.key()) != it.value())
+                    match = false;
+        }
+        if (match)
+            return entry.value("parameters", json::object());
+    }
+    return json::object();
+}
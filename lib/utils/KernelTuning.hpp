@@ -0,0 +1,33 @@
+/*****************************************
+@file
+@brief Look up the tuned parameters of the GPU kernels.
+- find_tuned_parameters
+*****************************************/
+#ifndef KERNEL_TUNING_HPP
+#define KERNEL_TUNING_HPP
+
+#include "json.hpp" // for json
+
+#include <string> // for string
+
+/**
+ * @brief Returns the tuned parameters of a command for its geometry.
+ *
+ * The tuning of a device holds a list of entries for each command, like
+ * @code
+ * {"geometry": {"num_elements": 256, "samples_per_data_set": 49152, "block_size": 32},
+ *  "parameters": {"kernel": "kv_corr.cl"}, "time": 0.0123}
+ * @endcode
+ * An entry matches if every value of its geometry is in @p geometry, so an entry
+ * without a geometry matches all of them.
+ *
+ * @param tuning    The entries of a device in the tuning file.
+ * @param command   The name of the command, e.g. "clKVCorr".
+ * @param geometry  The geometry of the command, e.g. its "num_elements".
+ * @return The parameters of the first entry of @p command which matches @p geometry, or
+ *         an empty object if there is none.
+ */
+nlohmann::json find_tuned_parameters(const nlohmann::json& tuning, const std::string& command,
+                                     const nlohmann::json& geometry);
+
+#endif // KERNEL_TUNING_HPP
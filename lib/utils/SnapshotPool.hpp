@@ -0,0 +1,182 @@
+/*****************************************
+@file
+@brief A pool of frame snapshots written by one thread and read by many, without locks.
+- SnapshotPool
+*****************************************/
+#ifndef SNAPSHOT_POOL_HPP
+#define SNAPSHOT_POOL_HPP
+
+#include <atomic>   // for atomic
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint64_t, uint8_t
+#include <vector>   // for vector
+
+/**
+ * @class SnapshotPool
+ * @brief Holds copies of recent frames, so the latest one can be read while the
+ *        next is written.
+ *
+ * One thread (the writer) copies frames into free snapshots and publishes them,
+ * any number of threads read the latest published snapshot. Neither ever waits
+ * for the other: a reader only pins a snapshot with a reference count, and if
+ * all snapshots but the latest one are pinned the writer just skips the frame.
+ * So with more snapshots than concurrent readers plus one the writer always finds
+ * a free one.
+ *
+ * @code
+ * // Writer
+ * SnapshotPool::snapshot* s = pool.begin_write();
+ * if (s != nullptr) {
+ *     memcpy(s->data.data(), frame, len);
+ *     pool.publish(s);
+ * }
+ *
+ * // Reader
+ * SnapshotPool::reader r = pool.latest();
+ * if (r)
+ *     use(r->data, r->seq);
+ * @endcode
+ **/
+class SnapshotPool {
+public:
+    /// A copy of a frame and its metadata
+    struct snapshot {
+        /// The frame contents
+        std::vector<uint8_t> data;
+        /// The frame metadata
+        std::vector<uint8_t> metadata;
+        /// The number of frames the writer had seen before this one
+        uint64_t seq = 0;
+
+    private:
+        /// The number of readers, or @c writing while the writer fills it
+        std::atomic<uint32_t> refs{0};
+
+        friend class SnapshotPool;
+    };
+
+    /// Pins a snapshot while it is being read
+    class reader {
+    public:
+        reader() = default;
+        reader(reader&& other) : s(other.s) {
+            other.s = nullptr;
+        }
+        reader& operator=(reader&& other) {
+            if (this != &other) {
+                release();
+                s = other.s;
+                other.s = nullptr;
+            }
+            return *this;
+        }
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+        ~reader() {
+            release();
+        }
+
+        /// Whether there is a snapshot
+        explicit operator bool() const {
+            return s != nullptr;
+        }
+        const snapshot& operator*() const {
+            return *s;
+        }
+        const snapshot* operator->() const {
+            return s;
+        }
+
+    private:
+        explicit reader(snapshot* s) : s(s) {}
+        void release() {
+            if (s != nullptr)
+                s->refs.fetch_sub(1);
+            s = nullptr;
+        }
+        snapshot* s = nullptr;
+
+        friend class SnapshotPool;
+    };
+
+    /**
+     * @brief Create the snapshots.
+     *
+     * @param num_snapshots  The number of snapshots, at least two.
+     * @param data_size      The size the frame copies are allocated with.
+     * @param metadata_size  The size the metadata copies are allocated with.
+     **/
+    SnapshotPool(size_t num_snapshots, size_t data_size, size_t metadata_size = 0) :
+        snapshots(num_snapshots < 2 ? 2 : num_snapshots) {
+        for (auto& s : snapshots) {
+            s.data.resize(data_size);
+            s.metadata.resize(metadata_size);
+        }
+    }
+
+    /**
+     * @brief Get a snapshot to write the next frame into (writer only).
+     *
+     * @return A snapshot not being read, or nullptr if there is none. Must be
+     *         passed to @c publish or @c abort_write.
+     **/
+    snapshot* begin_write() {
+        int current = latest_index.load();
+        for (int i = 0; i < (int)snapshots.size(); i++) {
+            uint32_t free = 0;
+            if (i != current && snapshots[i].refs.compare_exchange_strong(free, writing))
+                return &snapshots[i];
+        }
+        return nullptr;
+    }
+
+    /// Make a snapshot from @c begin_write the latest one (writer only).
+    void publish(snapshot* s) {
+        s->refs.fetch_sub(writing);
+        latest_index.store(s - snapshots.data());
+        num_published.fetch_add(1);
+    }
+
+    /// Give back a snapshot from @c begin_write without publishing it (writer only).
+    void abort_write(snapshot* s) {
+        s->refs.fetch_sub(writing);
+    }
+
+    /**
+     * @brief Pin the latest snapshot.
+     *
+     * @return A reader of the latest snapshot, empty if none was published yet.
+     **/
+    reader latest() {
+        while (true) {
+            int i = latest_index.load();
+            if (i < 0)
+                return reader();
+            snapshot* s = &snapshots[i];
+            // Once pinned the writer can't take the snapshot, but it may have done so
+            // (or published another one) before
+            uint32_t refs = s->refs.fetch_add(1);
+            if ((refs & writing) == 0 && latest_index.load() == i)
+                return reader(s);
+            s->refs.fetch_sub(1);
+        }
+    }
+
+    /// The number of snapshots published so far
+    uint64_t published() const {
+        return num_published.load();
+    }
+
+private:
+    /// Flag in @c snapshot::refs while the writer owns a snapshot
+    static constexpr uint32_t writing = 1u << 31;
+
+    std::vector<snapshot> snapshots;
+
+    /// The index of the latest published snapshot, or -1
+    std::atomic<int> latest_index{-1};
+
+    std::atomic<uint64_t> num_published{0};
+};
+
+#endif // SNAPSHOT_POOL_HPP
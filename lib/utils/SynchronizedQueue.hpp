@@ -72,6 +72,26 @@ public:
         return v;
     }
 
+    /**
+     * @brief Removes the first element from the front of the queue if there is one
+     *
+     * Like `get`, but doesn't block.
+     *
+     * @returns std::nullopt if the queue is empty or cancelled, and the element otherwise
+     */
+    std::optional<T> try_get() {
+
+        std::lock_guard<std::mutex> lock(mtx);
+
+        if (queue.empty() || stop) {
+            return std::nullopt;
+        }
+
+        auto v = queue.front();
+        queue.pop_front();
+        return v;
+    }
+
     /**
      * @brief Interrupts all blocked callers and prevents further modification.
      */
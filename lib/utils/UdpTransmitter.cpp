@@ -0,0 +1,288 @@
+#include "UdpTransmitter.hpp"
+
+#include "tx_utils.hpp" // for CLOCK_ABS_NANOSLEEP
+
+#include "fmt.hpp" // for format
+
+#include <algorithm>    // for min, max
+#include <arpa/inet.h>  // for inet_ntop
+#include <errno.h>      // for errno, EINTR, EINVAL, EIO
+#include <stdexcept>    // for runtime_error, out_of_range
+#include <string.h>     // for strerror, memset, memcpy
+#include <sys/socket.h> // for sendmsg, setsockopt, CMSG_FIRSTHDR, CMSG_SPACE, SOL_SOCKET
+#include <time.h>       // for timespec, clock_gettime, CLOCK_MONOTONIC
+#ifndef MAC_OSX
+#include <linux/net_tstamp.h> // for sock_txtime
+#include <netinet/udp.h>      // for UDP_SEGMENT
+#endif
+
+using kotekan::prometheus::Metrics;
+
+// Largest UDP payload of an IPv4 datagram, and the most segments GSO takes
+static const size_t max_udp_payload = 65507;
+static const size_t max_udp_segments = 64;
+
+// Space for the transmit time and the segment size of a message
+static const size_t control_size = CMSG_SPACE(sizeof(uint64_t)) + CMSG_SPACE(sizeof(uint16_t));
+
+#ifdef MAC_OSX
+static int sendmmsg(int fd, struct mmsghdr* msgs, unsigned int n, int flags) {
+    for (unsigned int i = 0; i < n; i++) {
+        ssize_t r = sendmsg(fd, &msgs[i].msg_hdr, flags);
+        if (r < 0)
+            return i > 0 ? (int)i : -1;
+        msgs[i].msg_len = r;
+    }
+    return n;
+}
+#endif
+
+UdpTransmitter::UdpTransmitter(kotekan::Config& config, const std::string& unique_name) :
+    unique_name(unique_name),
+    packets_counter(Metrics::instance().add_counter("kotekan_udp_tx_packets_total", unique_name,
+                                                    {"destination"})),
+    bytes_counter(Metrics::instance().add_counter("kotekan_udp_tx_bytes_total", unique_name,
+                                                  {"destination"})),
+    late_counter(Metrics::instance().add_counter("kotekan_udp_tx_late_packets_total",
+                                                 unique_name, {"destination"})),
+    error_counter(Metrics::instance().add_counter("kotekan_udp_tx_errors_total", unique_name,
+                                                  {"destination"})) {
+
+    set_log_level(config.get_default<std::string>(unique_name, "log_level", "info"));
+    set_log_prefix(unique_name + "/tx");
+
+    batch_size = std::max<size_t>(config.get_default<size_t>(unique_name, "tx_batch_size", 64), 1);
+    late_threshold = config.get_default<uint64_t>(unique_name, "tx_late_threshold", 100000);
+    use_gso = config.get_default<bool>(unique_name, "tx_gso", false);
+
+    std::string pacing = config.get_default<std::string>(unique_name, "tx_pacing", "sleep");
+    if (pacing == "sleep")
+        use_txtime = false;
+    else if (pacing == "txtime")
+        use_txtime = true;
+    else
+        throw std::runtime_error(
+            fmt::format(fmt("Unknown tx_pacing '{:s}', use 'sleep' or 'txtime'."), pacing));
+    batch_window =
+        config.get_default<uint64_t>(unique_name, "tx_batch_window", use_txtime ? 1000000 : 0);
+
+#if defined(MAC_OSX) || !defined(SO_TXTIME)
+    if (use_txtime) {
+        WARN("SO_TXTIME is not supported on this platform, pacing by sleeping.");
+        use_txtime = false;
+    }
+#endif
+#if defined(MAC_OSX) || !defined(UDP_SEGMENT)
+    if (use_gso) {
+        WARN("UDP segmentation offload is not supported on this platform.");
+        use_gso = false;
+    }
+#endif
+
+    msgs.resize(batch_size);
+    iovs.resize(batch_size);
+    control.resize(batch_size * control_size);
+}
+
+UdpTransmitter::~UdpTransmitter() {
+    flush();
+}
+
+size_t UdpTransmitter::add_socket(int fd) {
+#if !defined(MAC_OSX) && defined(SO_TXTIME)
+    if (use_txtime) {
+        struct sock_txtime txtime_cfg;
+        txtime_cfg.clockid = CLOCK_MONOTONIC;
+        txtime_cfg.flags = 0;
+        if (setsockopt(fd, SOL_SOCKET, SO_TXTIME, &txtime_cfg, sizeof(txtime_cfg)) < 0) {
+            WARN("Could not enable SO_TXTIME ({:s}), pacing by sleeping.", strerror(errno));
+            use_txtime = false;
+        }
+    }
+#endif
+    sockets.push_back({fd, {}});
+    sockets.back().pending.reserve(batch_size);
+    return sockets.size() - 1;
+}
+
+size_t UdpTransmitter::add_destination(size_t socket, const sockaddr_in& addr) {
+    if (socket >= sockets.size())
+        throw std::out_of_range(fmt::format(fmt("No socket {:d}."), socket));
+
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, ip, INET_ADDRSTRLEN);
+    std::vector<std::string> label = {fmt::format(fmt("{:s}:{:d}"), ip, ntohs(addr.sin_port))};
+
+    destinations.push_back({socket, addr, &packets_counter.labels(label),
+                            &bytes_counter.labels(label), &late_counter.labels(label),
+                            &error_counter.labels(label)});
+    return destinations.size() - 1;
+}
+
+void UdpTransmitter::send(size_t dest, const void* data, size_t len, uint64_t tx_time) {
+    queue(dest, (const uint8_t*)data, len, 1, tx_time);
+}
+
+void UdpTransmitter::send_segments(size_t dest, const void* data, size_t seg_size,
+                                   size_t num_segs, uint64_t tx_time) {
+    const size_t segs_per_msg = use_gso ? max_gso_segments(seg_size) : 1;
+    const uint8_t* segs = (const uint8_t*)data;
+    for (size_t i = 0; i < num_segs; i += segs_per_msg) {
+        queue(dest, segs + i * seg_size, seg_size, std::min(segs_per_msg, num_segs - i), tx_time);
+    }
+}
+
+void UdpTransmitter::queue(size_t dest, const uint8_t* data, size_t seg_size, size_t num_segs,
+                           uint64_t tx_time) {
+    if (num_pending > 0 && tx_time > batch_start + batch_window)
+        flush();
+    if (num_pending == 0)
+        batch_start = tx_time;
+
+    sockets[destinations.at(dest).socket].pending.push_back(
+        {dest, data, (uint32_t)seg_size, (uint32_t)num_segs, tx_time});
+
+    if (++num_pending >= batch_size)
+        flush();
+}
+
+size_t UdpTransmitter::flush() {
+    if (num_pending == 0)
+        return 0;
+
+    // Wait for the batch to be due, or with kernel pacing until it is a window ahead
+    uint64_t lead = use_txtime ? batch_window : 0;
+    if (batch_start > lead && batch_start - lead > now()) {
+        uint64_t wake = batch_start - lead;
+        struct timespec ts = {(time_t)(wake / 1000000000), (long)(wake % 1000000000)};
+        CLOCK_ABS_NANOSLEEP(CLOCK_MONOTONIC, ts);
+    }
+
+    uint64_t send_time = now();
+    size_t bytes_sent = 0;
+    for (auto& socket : sockets) {
+        if (!socket.pending.empty())
+            bytes_sent += send_batch(socket, send_time);
+    }
+    num_pending = 0;
+    return bytes_sent;
+}
+
+size_t UdpTransmitter::send_batch(Socket& socket, uint64_t send_time) {
+    const size_t n = socket.pending.size();
+
+    for (size_t i = 0; i < n; i++) {
+        const Packet& packet = socket.pending[i];
+        struct msghdr& hdr = msgs[i].msg_hdr;
+        memset(&hdr, 0, sizeof(hdr));
+
+        iovs[i].iov_base = (void*)packet.data;
+        iovs[i].iov_len = (size_t)packet.seg_size * packet.num_segs;
+        hdr.msg_iov = &iovs[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_name = (void*)&destinations[packet.dest].addr;
+        hdr.msg_namelen = sizeof(sockaddr_in);
+
+        bool txtime = use_txtime && packet.tx_time > 0;
+        bool gso = packet.num_segs > 1;
+        if (!txtime && !gso)
+            continue;
+
+        hdr.msg_control = &control[i * control_size];
+        hdr.msg_controllen = control_size;
+        memset(hdr.msg_control, 0, control_size);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        size_t controllen = 0;
+#if !defined(MAC_OSX) && defined(SO_TXTIME)
+        if (txtime) {
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_TXTIME;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+            memcpy(CMSG_DATA(cmsg), &packet.tx_time, sizeof(uint64_t));
+            controllen += CMSG_SPACE(sizeof(uint64_t));
+            cmsg = CMSG_NXTHDR(&hdr, cmsg);
+        }
+#endif
+#if !defined(MAC_OSX) && defined(UDP_SEGMENT)
+        if (gso) {
+            uint16_t gso_size = packet.seg_size;
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(uint16_t));
+            controllen += CMSG_SPACE(sizeof(uint16_t));
+        }
+#endif
+        hdr.msg_controllen = controllen;
+    }
+
+    size_t sent = 0, bytes_sent = 0;
+    while (sent < n) {
+        int r = sendmmsg(socket.fd, &msgs[sent], n - sent, 0);
+        if (r > 0) {
+            for (size_t i = sent; i < sent + r; i++)
+                bytes_sent += record(socket.pending[i], socket.pending[i].num_segs, send_time);
+            sent += r;
+            continue;
+        }
+        if (r < 0 && errno == EINTR)
+            continue;
+
+        // The first remaining message failed, skip it and carry on with the rest
+        const Packet& packet = socket.pending[sent];
+        if (packet.num_segs > 1 && (errno == EINVAL || errno == EIO)) {
+            WARN("UDP segmentation offload failed ({:s}), sending packets individually.",
+                 strerror(errno));
+            use_gso = false;
+            bytes_sent += record(packet, send_unsegmented(socket.fd, packet), send_time);
+        } else {
+            ERROR("Failed to send UDP packet: {:s}", strerror(errno));
+            record(packet, 0, send_time);
+        }
+        sent++;
+    }
+
+    socket.pending.clear();
+    return bytes_sent;
+}
+
+size_t UdpTransmitter::send_unsegmented(int fd, const Packet& packet) {
+    size_t segs_sent = 0;
+    const sockaddr_in& addr = destinations[packet.dest].addr;
+    for (size_t i = 0; i < packet.num_segs; i++) {
+        if (sendto(fd, packet.data + i * packet.seg_size, packet.seg_size, 0,
+                   (const struct sockaddr*)&addr, sizeof(addr))
+            == (ssize_t)packet.seg_size)
+            segs_sent++;
+    }
+    return segs_sent;
+}
+
+size_t UdpTransmitter::record(const Packet& packet, size_t segs_sent, uint64_t send_time) {
+    Destination& dest = destinations[packet.dest];
+    if (segs_sent > 0) {
+        dest.packets->inc(segs_sent);
+        dest.bytes->inc(segs_sent * packet.seg_size);
+        if (packet.tx_time > 0 && send_time > packet.tx_time + late_threshold)
+            dest.late->inc(segs_sent);
+    }
+    if (segs_sent < packet.num_segs)
+        dest.errors->inc(packet.num_segs - segs_sent);
+    return segs_sent * packet.seg_size;
+}
+
+size_t UdpTransmitter::max_gso_segments(size_t seg_size) {
+    if (seg_size == 0)
+        return 1;
+    return std::max<size_t>(std::min(max_udp_segments, max_udp_payload / seg_size), 1);
+}
+
+uint64_t UdpTransmitter::now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return to_ns(ts);
+}
+
+uint64_t UdpTransmitter::to_ns(const struct timespec& ts) {
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
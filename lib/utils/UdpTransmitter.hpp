@@ -0,0 +1,226 @@
+/*****************************************
+@file
+@brief Batched and paced transmission of UDP packets.
+- UdpTransmitter : public kotekan::kotekanLogging
+*****************************************/
+#ifndef UDP_TRANSMITTER_HPP
+#define UDP_TRANSMITTER_HPP
+
+#include "Config.hpp"            // for Config
+#include "kotekanLogging.hpp"    // for kotekanLogging
+#include "prometheusMetrics.hpp" // for Counter, MetricFamily
+
+#include <netinet/in.h> // for sockaddr_in
+#include <stddef.h>     // for size_t
+#include <stdint.h>     // for uint64_t, uint8_t, uint32_t
+#include <string>       // for string
+#include <sys/socket.h> // for msghdr
+#include <sys/uio.h>    // for iovec
+#include <vector>       // for vector
+
+#ifdef MAC_OSX
+/// There is no @c sendmmsg on OS X, @c UdpTransmitter falls back to one @c sendmsg per packet.
+struct mmsghdr {
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
+};
+#endif
+
+/**
+ * @class UdpTransmitter
+ * @brief Send UDP packets in batches, each packet no earlier than a given time.
+ *
+ * The packets queued with @c send are collected into batches and handed to the
+ * kernel with a single @c sendmmsg call per socket. A batch is closed once it
+ * holds @c tx_batch_size packets, or when a packet is due more than
+ * @c tx_batch_window after the first packet of the batch.
+ *
+ * There are two ways of pacing the packets:
+ *  - @c sleep: the calling thread sleeps until the first packet of the batch is
+ *    due and sends the whole batch. With the default window of 0 only packets
+ *    that are due at the same time are batched, which is exactly the behaviour
+ *    of a @c clock_nanosleep before each @c sendto.
+ *  - @c txtime: every packet carries its transmit time (@c SO_TXTIME) and the
+ *    kernel releases it then. This needs the @c fq (or @c etf) qdisc on the
+ *    outgoing interface, otherwise the packets go out as soon as they are sent.
+ *    Batches are handed to the kernel one window ahead of time, so the thread
+ *    only wakes up once per window instead of once per packet.
+ *
+ * Transmit times are in nanoseconds of @c CLOCK_MONOTONIC (as used by @c fq),
+ * 0 means as soon as possible.
+ *
+ * Consecutive packets of the same size to the same destination can be sent as
+ * one message with UDP generic segmentation offload (@c send_segments with
+ * @c tx_gso enabled). If the kernel or the interface refuse it, the
+ * transmitter falls back to sending the packets individually.
+ *
+ * @warning The packet data is not copied until the batch is sent. It must stay
+ *          valid until @c flush returns.
+ *
+ * @conf   tx_batch_size      Int (default 64). Maximum number of packets per batch.
+ * @conf   tx_pacing          String (default "sleep"). Either "sleep" or "txtime".
+ * @conf   tx_batch_window    Int (default 0 for "sleep", 1000000 for "txtime"). Maximum time in
+ *                            ns between the first and the last packet of a batch.
+ * @conf   tx_gso             Bool (default false). Use UDP segmentation offload for runs of
+ *                            packets sent with @c send_segments.
+ * @conf   tx_late_threshold  Int (default 100000). A packet handed to the kernel more than this
+ *                            many ns after its transmit time is counted as late.
+ *
+ * @par Metrics
+ * @metric kotekan_udp_tx_packets_total
+ *         Number of packets sent, by destination.
+ * @metric kotekan_udp_tx_bytes_total
+ *         Number of bytes sent (UDP payload), by destination.
+ * @metric kotekan_udp_tx_late_packets_total
+ *         Number of packets sent later than their transmit time plus
+ *         @c tx_late_threshold, by destination.
+ * @metric kotekan_udp_tx_errors_total
+ *         Number of packets that couldn't be sent, by destination.
+ **/
+class UdpTransmitter : public kotekan::kotekanLogging {
+public:
+    /**
+     * @brief Set up the transmitter from the config of a stage.
+     *
+     * @param config       kotekan config.
+     * @param unique_name  Name of the stage using the transmitter, used for
+     *                     the config, the log and the metrics.
+     **/
+    UdpTransmitter(kotekan::Config& config, const std::string& unique_name);
+
+    /// Sends anything still queued.
+    ~UdpTransmitter();
+
+    /**
+     * @brief Add a socket to send packets from.
+     *
+     * The socket stays owned by the caller. If @c txtime pacing was requested
+     * but the socket doesn't support it, the transmitter falls back to sleeping.
+     *
+     * @param  fd  A UDP socket.
+     *
+     * @return The index of the socket for @c add_destination.
+     **/
+    size_t add_socket(int fd);
+
+    /**
+     * @brief Add a destination.
+     *
+     * @param  socket  Index of the socket to send from.
+     * @param  addr    Address to send to.
+     *
+     * @return The index of the destination for @c send.
+     **/
+    size_t add_destination(size_t socket, const sockaddr_in& addr);
+
+    /**
+     * @brief Queue a packet.
+     *
+     * @param  dest     Index of the destination.
+     * @param  data     The packet (UDP payload).
+     * @param  len      Length of the packet in bytes.
+     * @param  tx_time  When to send the packet (ns of @c CLOCK_MONOTONIC), 0 for now.
+     **/
+    void send(size_t dest, const void* data, size_t len, uint64_t tx_time = 0);
+
+    /**
+     * @brief Queue a run of consecutive, equally sized packets.
+     *
+     * All packets get the same transmit time. With @c tx_gso they are handed
+     * to the kernel in as few messages as possible.
+     *
+     * @param  dest      Index of the destination.
+     * @param  data      The first packet.
+     * @param  seg_size  Size of each packet in bytes.
+     * @param  num_segs  Number of packets.
+     * @param  tx_time   When to send the packets (ns of @c CLOCK_MONOTONIC), 0 for now.
+     **/
+    void send_segments(size_t dest, const void* data, size_t seg_size, size_t num_segs,
+                       uint64_t tx_time = 0);
+
+    /**
+     * @brief Send all queued packets, waiting for them to be due if pacing by sleeping.
+     *
+     * @return The number of bytes of the packets the kernel took.
+     **/
+    size_t flush();
+
+    /// Current time in ns of @c CLOCK_MONOTONIC.
+    static uint64_t now();
+
+    /// Convert a @c timespec to ns.
+    static uint64_t to_ns(const struct timespec& ts);
+
+    /// Whether packets are paced by the kernel.
+    bool kernel_pacing() const {
+        return use_txtime;
+    }
+
+private:
+    struct Packet {
+        size_t dest;
+        const uint8_t* data;
+        uint32_t seg_size;
+        uint32_t num_segs;
+        uint64_t tx_time;
+    };
+
+    struct Socket {
+        int fd;
+        std::vector<Packet> pending;
+    };
+
+    struct Destination {
+        size_t socket;
+        sockaddr_in addr;
+        kotekan::prometheus::Counter* packets;
+        kotekan::prometheus::Counter* bytes;
+        kotekan::prometheus::Counter* late;
+        kotekan::prometheus::Counter* errors;
+    };
+
+    /// Add a single message to the current batch
+    void queue(size_t dest, const uint8_t* data, size_t seg_size, size_t num_segs,
+               uint64_t tx_time);
+
+    /// Send the batch queued on one socket, returns the number of bytes sent
+    size_t send_batch(Socket& socket, uint64_t send_time);
+
+    /// Send one GSO message segment by segment, returns the number of segments sent
+    size_t send_unsegmented(int fd, const Packet& packet);
+
+    /// Count a packet that was (or wasn't) sent, returns the number of bytes sent
+    size_t record(const Packet& packet, size_t segs_sent, uint64_t send_time);
+
+    /// Maximum number of segments GSO takes in one message
+    static size_t max_gso_segments(size_t seg_size);
+
+    std::string unique_name;
+
+    // Config
+    size_t batch_size;
+    uint64_t batch_window;
+    uint64_t late_threshold;
+    bool use_txtime;
+    bool use_gso;
+
+    std::vector<Socket> sockets;
+    std::vector<Destination> destinations;
+
+    // Packets in the current batch, over all sockets
+    size_t num_pending = 0;
+    // Transmit time of the first packet of the current batch
+    uint64_t batch_start = 0;
+
+    // Scratch space for sendmmsg
+    std::vector<struct mmsghdr> msgs;
+    std::vector<struct iovec> iovs;
+    std::vector<uint8_t> control;
+
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& packets_counter;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& bytes_counter;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& late_counter;
+    kotekan::prometheus::MetricFamily<kotekan::prometheus::Counter>& error_counter;
+};
+
+#endif // UDP_TRANSMITTER_HPP
@@ -0,0 +1,129 @@
+#include "VisSharedMemReader.hpp"
+
+#include <errno.h>    // for errno
+#include <fcntl.h>    // for O_RDONLY
+#include <stdexcept>  // for runtime_error
+#include <string.h>   // for strerror, memcpy
+#include <sys/mman.h> // for mmap, munmap, shm_open, MAP_FAILED, MAP_SHARED, PROT_READ
+#include <sys/stat.h> // for fstat, stat
+#include <thread>     // for yield
+#include <unistd.h>   // for close
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free
+                  && std::atomic<int64_t>::is_always_lock_free,
+              "The shared memory protocol needs lock-free 64-bit atomics.");
+
+VisSharedMemReader::VisSharedMemReader(const std::string& name) : _name(name) {
+
+    int fd = shm_open(_name.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+        throw std::runtime_error("Cannot open shared memory named " + _name + ": "
+                                 + strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error("Cannot stat shared memory named " + _name + ": "
+                                 + strerror(errno));
+    }
+    shm_size = st.st_size;
+
+    if (shm_size < access_record_offset()) {
+        close(fd);
+        throw std::runtime_error("Shared memory named " + _name
+                                 + " is too small to hold the structured data.");
+    }
+
+    void* addr = mmap(nullptr, shm_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        throw std::runtime_error("Failed to map shared memory named " + _name + ": "
+                                 + strerror(errno));
+    shm_addr = (uint8_t*)addr;
+
+    num_writes_addr = (const std::atomic<uint64_t>*)shm_addr;
+    memcpy(&rbs, shm_addr + sizeof(uint64_t), sizeof(VisSharedMemStructure));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // The writer records the structure once the rest of the region is initialised
+    if (shm_size != total_size(rbs)) {
+        munmap(shm_addr, shm_size);
+        shm_addr = nullptr;
+        throw std::runtime_error("Shared memory named " + _name + " has size "
+                                 + std::to_string(shm_size) + ", expected "
+                                 + std::to_string(total_size(rbs))
+                                 + ". It may not be fully set up by the writer yet.");
+    }
+
+    access_record_addr = (const std::atomic<int64_t>*)(shm_addr + access_record_offset());
+    generation_addr = (const std::atomic<uint64_t>*)(shm_addr + generation_offset(rbs));
+    buf_addr = shm_addr + data_offset(rbs);
+}
+
+VisSharedMemReader::~VisSharedMemReader() {
+    if (shm_addr)
+        munmap(shm_addr, shm_size);
+}
+
+uint64_t VisSharedMemReader::num_writes() const {
+    return num_writes_addr->load(std::memory_order_acquire);
+}
+
+std::vector<int64_t> VisSharedMemReader::access_record() const {
+    std::vector<int64_t> record(rbs.ntime * rbs.nfreq);
+    for (size_t i = 0; i < record.size(); i++)
+        record[i] = access_record_addr[i].load(std::memory_order_acquire);
+    return record;
+}
+
+int64_t VisSharedMemReader::read_frame(size_t time_ind, size_t freq_ind, uint8_t* metadata,
+                                       uint8_t* data, int max_retries) const {
+    if (time_ind >= rbs.ntime || freq_ind >= rbs.nfreq)
+        throw std::out_of_range("Slot (" + std::to_string(time_ind) + ", "
+                                + std::to_string(freq_ind) + ") is outside of the ring buffer.");
+
+    const size_t slot = time_ind * rbs.nfreq + freq_ind;
+    const std::atomic<uint64_t>& generation = generation_addr[slot];
+    const uint8_t* frame = buf_addr + slot * rbs.frame_size;
+
+    for (int attempt = 0; attempt <= max_retries; attempt++) {
+        uint64_t gen_before = generation.load(std::memory_order_acquire);
+        if (gen_before & 1) {
+            // The writer is in the middle of this slot
+            std::this_thread::yield();
+            continue;
+        }
+
+        int64_t fpga_seq = access_record_addr[slot].load(std::memory_order_relaxed);
+        if (fpga_seq == invalid)
+            return invalid;
+
+        if (metadata)
+            memcpy(metadata, frame + valid_size, rbs.metadata_size);
+        if (data)
+            memcpy(data, frame + valid_size + rbs.metadata_size, rbs.data_size);
+
+        // Make sure the copies are done before checking the generation again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (generation.load(std::memory_order_relaxed) == gen_before)
+            return fpga_seq;
+    }
+
+    return invalid;
+}
+
+size_t VisSharedMemReader::access_record_offset() {
+    return structured_data_num * sizeof(uint64_t);
+}
+
+size_t VisSharedMemReader::generation_offset(const VisSharedMemStructure& rbs) {
+    return access_record_offset() + rbs.ntime * rbs.nfreq * sizeof(int64_t);
+}
+
+size_t VisSharedMemReader::data_offset(const VisSharedMemStructure& rbs) {
+    return generation_offset(rbs) + rbs.ntime * rbs.nfreq * sizeof(uint64_t);
+}
+
+size_t VisSharedMemReader::total_size(const VisSharedMemStructure& rbs) {
+    return data_offset(rbs) + rbs.ntime * rbs.nfreq * rbs.frame_size;
+}
@@ -0,0 +1,136 @@
+/*****************************************
+@file
+@brief Layout of and lock-free reader for the shared memory ring buffer
+       exported by VisSharedMemWriter.
+- VisSharedMemStructure
+- VisSharedMemReader
+*****************************************/
+#ifndef VIS_SHARED_MEM_READER_HPP
+#define VIS_SHARED_MEM_READER_HPP
+
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint64_t, int64_t, uint8_t
+#include <stddef.h> // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+/**
+ * @brief Structural parameters of the ring buffer.
+ *
+ * Stored in the shared memory directly after the write counter.
+ **/
+struct VisSharedMemStructure {
+    // The number of time samples contained in ring buffer
+    uint64_t ntime;
+    // The number of frequencies contained in each time sample
+    uint64_t nfreq;
+    // The size of each frame (valid byte + metadata + data + page alignment padding)
+    uint64_t frame_size;
+    // The size of each metadata section
+    uint64_t metadata_size;
+    // The size of each data section
+    uint64_t data_size;
+};
+
+/**
+ * @class VisSharedMemReader
+ * @brief Read frames out of a VisSharedMemWriter shared memory region.
+ *
+ * The shared memory region consists of:
+ *  - the structured data: the number of writes (0 once the writer has shut
+ *    down) followed by a VisSharedMemStructure,
+ *  - the access record: one `int64_t` per time and frequency slot holding the
+ *    `fpga_seq_start` of the frame in that slot, or -1 if it is empty,
+ *  - the generation counters: one `uint64_t` per slot,
+ *  - the ring buffer of frames: each frame is a valid byte (padded to 4
+ *    bytes), the metadata and the data, padded to a page boundary.
+ *
+ * Every slot is protected by a seqlock: the writer increments its
+ * generation counter to an odd value before touching the slot, and to the
+ * next even value once the access record and the frame are complete. A
+ * reader copies a slot and accepts the copy only if the generation was even
+ * and unchanged across the copy. Readers never block the writer or each
+ * other, they just retry (or give up on) a slot that was overwritten while
+ * they were copying it.
+ **/
+class VisSharedMemReader {
+
+public:
+    /**
+     * @brief Open and map an existing shared memory ring buffer.
+     *
+     * @param  name  Name of the shared memory region (as given to the writer).
+     *
+     * @throws std::runtime_error if the region doesn't exist or its size doesn't
+     *         match the structure stored in it.
+     **/
+    explicit VisSharedMemReader(const std::string& name);
+
+    ~VisSharedMemReader();
+
+    VisSharedMemReader(const VisSharedMemReader&) = delete;
+    VisSharedMemReader& operator=(const VisSharedMemReader&) = delete;
+
+    /// Structural parameters of the ring buffer.
+    const VisSharedMemStructure& structure() const {
+        return rbs;
+    }
+
+    /// Number of frames written so far, 0 if the writer has shut down.
+    uint64_t num_writes() const;
+
+    /// A snapshot of the access record, indexed by `time_ind * nfreq + freq_ind`.
+    std::vector<int64_t> access_record() const;
+
+    /**
+     * @brief Copy the frame in one slot of the ring buffer.
+     *
+     * @param  time_ind     Time index of the slot.
+     * @param  freq_ind     Frequency index of the slot.
+     * @param  metadata     Destination of `metadata_size` bytes, or nullptr.
+     * @param  data         Destination of `data_size` bytes, or nullptr.
+     * @param  max_retries  How often to retry a slot that is being written.
+     *
+     * @return The `fpga_seq_start` of the copied frame, or -1 if the slot is
+     *         empty or kept changing while copying it. In that case the
+     *         destinations contain garbage.
+     **/
+    int64_t read_frame(size_t time_ind, size_t freq_ind, uint8_t* metadata, uint8_t* data,
+                       int max_retries = 3) const;
+
+    /// Offset of the access record from the start of the region.
+    static size_t access_record_offset();
+
+    /// Offset of the generation counters from the start of the region.
+    static size_t generation_offset(const VisSharedMemStructure& rbs);
+
+    /// Offset of the ring buffer from the start of the region.
+    static size_t data_offset(const VisSharedMemStructure& rbs);
+
+    /// Total size of the region.
+    static size_t total_size(const VisSharedMemStructure& rbs);
+
+    /// The number of 64-bit elements in the structured data
+    static constexpr size_t structured_data_num = 6;
+
+    /// Space that the "valid byte" takes up at the start of a frame
+    static constexpr size_t valid_size = 4;
+
+    /// Access record value of an empty slot
+    static constexpr int64_t invalid = -1;
+
+private:
+    std::string _name;
+
+    uint8_t* shm_addr = nullptr;
+    size_t shm_size = 0;
+
+    VisSharedMemStructure rbs;
+
+    const std::atomic<uint64_t>* num_writes_addr;
+    const std::atomic<int64_t>* access_record_addr;
+    const std::atomic<uint64_t>* generation_addr;
+    const uint8_t* buf_addr;
+};
+
+#endif // VIS_SHARED_MEM_READER_HPP
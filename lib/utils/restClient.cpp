@@ -2,31 +2,48 @@
 
 #include "kotekanLogging.hpp" // for FATAL_ERROR_NON_OO, DEBUG_NON_OO, WARN_NON_OO
 
-#include <chrono>                      // for operator+, seconds, system_clock, system_clock::t...
-#include <condition_variable>          // for condition_variable
-#include <cstring>                     // for memcpy
-#include <event2/buffer.h>             // for iovec, evbuffer_peek, evbuffer_iovec, evbuffer
-#include <event2/bufferevent.h>        // for bufferevent_read, bufferevent_free, bufferevent_s...
-#include <event2/bufferevent_struct.h> // for bufferevent
-#include <event2/dns.h>                // for evdns_base_free, evdns_base_new
-#include <event2/event.h>              // for event_base_loopbreak, EV_READ, event_add, event_b...
-#include <event2/event_struct.h>       // for event
-#include <event2/http.h>               // for evhttp_connection_free, evhttp_request_free, evht...
-#include <event2/keyvalq_struct.h>     // for evkeyvalq
-#include <event2/thread.h>             // for evthread_use_pthreads
-#include <evhttp.h>                    // for evhttp_request
-#include <pthread.h>                   // for pthread_setname_np
-#include <stdlib.h>                    // for free, malloc
-#include <sys/time.h>                  // for timeval
-#include <vector>                      // for __alloc_traits<>::value_type
-
+#include <algorithm>               // for min
+#include <chrono>                  // for seconds
+#include <event2/buffer.h>         // for evbuffer_add, evbuffer_copyout, evbuffer_get_length
+#include <event2/dns.h>            // for evdns_base_free, evdns_base_new
+#include <event2/event.h>          // for event_base_loopbreak, event_add, event_new, event_free
+#include <event2/http.h>           // for evhttp_connection_free, evhttp_make_request, evht...
+#include <event2/keyvalq_struct.h> // for evkeyvalq
+#include <event2/thread.h>         // for evthread_use_pthreads
+#include <evhttp.h>                // for evhttp_request
+#include <exception>               // for exception
+#include <pthread.h>               // for pthread_setname_np
+#include <stdio.h>                 // for snprintf
+#include <sys/time.h>              // for timeval
+
+
+/// A request on its way, from the request functions to the callback
+struct restClient::pendingRequest {
+    restClient* client;
+    std::string path, host, body;
+    unsigned short port;
+    int retries, timeout;
+    std::function<void(restReply)> callback;
+
+    /// The number of attempts so far
+    int attempt = 0;
+    /// Whether an attempt failed on a reused keep-alive connection, which the server may
+    /// have closed meanwhile
+    bool reconnected = false;
+
+    /// The current attempt: its connection, libevent request and timeout
+    pooledConnection* conn = nullptr;
+    bool reused = false;
+    struct evhttp_request* req = nullptr;
+    struct event* timeout_event = nullptr;
+};
 
 restClient& restClient::instance() {
     static restClient client_instance;
     return client_instance;
 }
 
-restClient::restClient() : _main_thread() {
+restClient::restClient() : _main_thread(), _num_connections_opened(0) {
 
     _stop_thread = false;
     _event_thread_started = false;
@@ -77,23 +94,11 @@ void restClient::event_thread() {
     }
 
     // The event loop will run in this seperate thread. We have to schedule requests from
-    // this same thread. Therefor we create a bufferevent pair here to pass request pointers in.
-    bufferevent* pair[2];
-    if (bufferevent_pair_new(_base, BEV_OPT_CLOSE_ON_FREE | BEV_OPT_THREADSAFE, pair))
-        FATAL_ERROR_NON_OO("restClient: Failure creating bufferevent pair.");
-    bev_req_write = pair[0];
-    bev_req_read = pair[1];
-    if (bufferevent_disable(bev_req_write, EV_READ))
-        FATAL_ERROR_NON_OO("restClient: Failure in bufferevent_disable().");
-    if (bufferevent_enable(bev_req_read, EV_READ))
-        FATAL_ERROR_NON_OO("restClient: Failure in bufferevent_enable().");
-
-    // Set a watermark on the input buffer of the bufferevent for reading. This is to prevent
-    // it getting filled up so much, that the read callback later starves other threads.
-    bufferevent_setwatermark(bev_req_read, EV_READ, 0, 5 * 1 << 20); // 5mb
-
-    bufferevent_setcb(bev_req_read, _bev_req_readcb, nullptr, _bev_req_errcb, this);
-    bufferevent_setcb(bev_req_write, nullptr, nullptr, _bev_req_errcb, this);
+    // this same thread. Other threads queue them and activate this event to wake us up.
+    _queue_event = event_new(_base, -1, 0, _queue_cb, this);
+    if (_queue_event == nullptr) {
+        FATAL_ERROR_NON_OO("restClient: Failure creating the request queue event.");
+    }
 
     // DNS resolution is blocking (if not numeric host is passed)
     _dns = evdns_base_new(_base, 1);
@@ -125,302 +130,271 @@ void restClient::event_thread() {
     DEBUG_NON_OO("restClient: exiting event loop");
 
     // Cleanup
-    bufferevent_free(bev_req_write);
-    bufferevent_free(bev_req_read);
+    for (auto& pool : _pools)
+        for (auto& conn : pool.second)
+            evhttp_connection_free(conn->evcon);
+    _pools.clear();
+    event_free(_queue_event);
     event_free(timer_event);
     evdns_base_free(_dns, 1);
     event_base_free(_base);
 }
 
-void restClient::http_request_done(struct evhttp_request* req, void* arg) {
-    // FIXME: evcon is passed here, because evhttp_request_get_connection(req)
-    // always returns a nullptr and there is no way to free the connection on
-    // completion in libevent < 2.1
-    // libevent 2.1 has a evhttp_connection_free_on_completion, but using it,
-    // the bufferevent never gets deleted...
-    // TODO: maybe keep the evhttp_connections in a pool and reuse them
-    // (set Connection:keep-alive header)
-    auto pair = (std::pair<std::function<void(restReply)>*, struct evhttp_connection*>*)arg;
-    std::function<void(restReply)>* ext_cb = pair->first;
+void restClient::enqueue(std::vector<pendingRequest*>& requests) {
+    {
+        std::lock_guard<std::mutex> lock(_mtx_queue);
+        _queue.insert(_queue.end(), requests.begin(), requests.end());
+    }
+    event_active(_queue_event, EV_READ, 0);
+}
 
-    // this is where we store the reply
-    std::string str_data("");
+void restClient::_queue_cb(evutil_socket_t fd, short event, void* arg) {
+
+    // Unused parameters, required by libevent. Suppress warning.
+    (void)fd;
+    (void)event;
+
+    restClient* client = (restClient*)arg;
+    std::vector<pendingRequest*> requests;
+    {
+        std::lock_guard<std::mutex> lock(client->_mtx_queue);
+        requests.swap(client->_queue);
+    }
+    for (pendingRequest* request : requests)
+        client->send(request);
+}
+
+restClient::pooledConnection* restClient::get_connection(const std::string& host,
+                                                         unsigned short port) {
+    auto& pool = _pools[{host, port}];
+
+    pooledConnection* least_busy = nullptr;
+    for (auto& conn : pool) {
+        if (least_busy == nullptr || conn->in_flight < least_busy->in_flight)
+            least_busy = conn.get();
+    }
+    if ((least_busy != nullptr && least_busy->in_flight == 0)
+        || pool.size() >= max_connections_per_host)
+        return least_busy;
+
+    struct evhttp_connection* evcon =
+        evhttp_connection_base_new(_base, _dns, host.c_str(), port);
+    if (evcon == nullptr) {
+        WARN_NON_OO("restClient: evhttp_connection_base_new() failed.");
+        return least_busy;
+    }
+    pool.push_back(std::make_unique<pooledConnection>(pooledConnection{evcon, 0, 0}));
+    _num_connections_opened++;
+    DEBUG_NON_OO("restClient: opened connection {:d} to {:s}:{:d}", pool.size(), host, port);
+    return pool.back().get();
+}
+
+void restClient::send(pendingRequest* request) {
+    pooledConnection* conn = get_connection(request->host, request->port);
+    if (conn == nullptr) {
+        failed(request, "no connection");
+        return;
+    }
+
+    evhttp_request* req = evhttp_request_new(http_request_done, request);
+    if (req == nullptr) {
+        FATAL_ERROR_NON_OO("restClient: evhttp_request_new() failed.");
+    }
+    evkeyvalq* output_headers = evhttp_request_get_output_headers(req);
+    if (evhttp_add_header(output_headers, "Host", request->host.c_str())) {
+        evhttp_request_free(req);
+        FATAL_ERROR_NON_OO("restClient: Failure adding \"Host\" header.");
+    }
+    if (evhttp_add_header(output_headers, "Content-Type", "application/json")) {
+        evhttp_request_free(req);
+        FATAL_ERROR_NON_OO("restClient: Failure adding \"Content-Type\" header.");
+    }
+    if (!request->body.empty()) {
+        if (evbuffer_add(evhttp_request_get_output_buffer(req), request->body.data(),
+                         request->body.size())) {
+            evhttp_request_free(req);
+            FATAL_ERROR_NON_OO("restClient: Failure adding the request data.");
+        }
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%zu", request->body.size());
+        if (evhttp_add_header(output_headers, "Content-Length", buf)) {
+            evhttp_request_free(req);
+            FATAL_ERROR_NON_OO("restClient: Failure adding \"Content-Length\" header.");
+        }
+        DEBUG_NON_OO("restClient: Sending {:s} bytes.", buf);
+    } else {
+        DEBUG_NON_OO("restClient: sending GET request.");
+    }
+
+    request->conn = conn;
+    request->reused = conn->used > 0;
+    request->req = req;
+    conn->in_flight++;
+    conn->used++;
+
+    // The timeout of this attempt
+    request->timeout_event = event_new(_base, -1, 0, _timeout_cb, request);
+    timeval timeout = {request->timeout < 0 ? 50 : request->timeout, 0};
+    event_add(request->timeout_event, &timeout);
+
+    if (evhttp_make_request(conn->evcon, req,
+                            request->body.empty() ? EVHTTP_REQ_GET : EVHTTP_REQ_POST,
+                            request->path.c_str())) {
+        // libevent has freed the request
+        request->req = nullptr;
+        end_attempt(request);
+        failed(request, "evhttp_make_request() failed");
+    }
+}
+
+void restClient::end_attempt(pendingRequest* request) {
+    if (request->timeout_event != nullptr) {
+        event_free(request->timeout_event);
+        request->timeout_event = nullptr;
+    }
+    if (request->conn != nullptr) {
+        request->conn->in_flight--;
+        request->conn = nullptr;
+    }
+    request->req = nullptr;
+}
+
+void restClient::failed(pendingRequest* request, const std::string& reason) {
+    // A keep-alive connection the server closed is reopened once, without counting as a retry
+    if (request->reused && !request->reconnected) {
+        DEBUG_NON_OO("restClient: Request on a reused connection failed ({:s}), trying again.",
+                     reason);
+        request->reconnected = true;
+        send(request);
+        return;
+    }
+
+    if (request->attempt < request->retries) {
+        // Wait 0.1s, 0.2s, 0.4s, ... up to 5s
+        int wait_ms = std::min(100 << std::min(request->attempt, 6), 5000);
+        request->attempt++;
+        WARN_NON_OO("restClient: Request to {:s}:{:d}{:s} failed ({:s}), retrying in {:d} ms "
+                    "({:d}/{:d}).",
+                    request->host, request->port, request->path, reason, wait_ms,
+                    request->attempt, request->retries);
+        timeval wait = {wait_ms / 1000, (wait_ms % 1000) * 1000};
+        if (event_base_once(request->client->_base, -1, EV_TIMEOUT, _retry_cb, request, &wait)
+            == 0)
+            return;
+    }
+
+    WARN_NON_OO("restClient: Request to {:s}:{:d}{:s} failed ({:s})", request->host,
+                request->port, request->path, reason);
+    request->callback(restReply(false, ""));
+    delete request;
+}
+
+void restClient::_retry_cb(evutil_socket_t fd, short event, void* arg) {
+
+    // Unused parameters, required by libevent. Suppress warning.
+    (void)fd;
+    (void)event;
+
+    pendingRequest* request = (pendingRequest*)arg;
+    request->client->send(request);
+}
+
+void restClient::_timeout_cb(evutil_socket_t fd, short event, void* arg) {
+
+    // Unused parameters, required by libevent. Suppress warning.
+    (void)fd;
+    (void)event;
+
+    pendingRequest* request = (pendingRequest*)arg;
+    // This doesn't call http_request_done, and resets the connection if the request was
+    // already sent. Any requests queued behind it go out on a new connection.
+    evhttp_cancel_request(request->req);
+    end_attempt(request);
+    // Only reconnect for connection failures
+    request->reconnected = true;
+    request->client->failed(request, "timeout");
+}
+
+void restClient::http_request_done(struct evhttp_request* req, void* arg) {
+    pendingRequest* request = (pendingRequest*)arg;
+    restClient* client = request->client;
+    end_attempt(request);
 
     if (req == nullptr) {
         int errcode = EVUTIL_SOCKET_ERROR();
         // Print socket error
-        std::string str = evutil_socket_error_to_string(errcode);
-        WARN_NON_OO("restClient: Request failed with socket error {:d} ({:s})", errcode, str);
-        (*ext_cb)(restReply(false, str_data));
-        cleanup(pair);
+        client->failed(request, fmt::format(fmt("socket error {:d} ({:s})"), errcode,
+                                            evutil_socket_error_to_string(errcode)));
         return;
     }
 
     int response_code = evhttp_request_get_response_code(req);
+    if (response_code == 0) {
+        client->failed(request, "connection error");
+        return;
+    }
 
     if (response_code != 200) {
         std::string status_text = "";
         if (req->response_code_line)
             status_text = req->response_code_line;
-        if (response_code == 0)
-            status_text = "Connection error";
         INFO_NON_OO("restClient: Received response code {:d} ({:s})", response_code, status_text);
-        (*ext_cb)(restReply(false, str_data));
-        cleanup(pair);
+        request->callback(restReply(false, ""));
+        delete request;
         return;
     }
 
-    // get input buffer
+    // this is where we store the reply
+    std::string str_data;
     evbuffer* input_buffer = evhttp_request_get_input_buffer(req);
-    size_t datalen = evbuffer_get_length(input_buffer);
-    if (datalen == 0) {
-        (*ext_cb)(restReply(true, str_data));
-        cleanup(pair);
-        return;
-    }
-
-    // Reserve space to avoid causing mallocs when appending data.
-    str_data.reserve(datalen);
-
-    // peek into the input buffer
-    // (treating it as char's and putting it into a string)
-    struct evbuffer_iovec* vec_out;
-    size_t written = 0;
-    // determine how many chunks we need.
-    int n_vec = evbuffer_peek(input_buffer, datalen, nullptr, nullptr, 0);
-    if (n_vec < 0) {
-        WARN_NON_OO("restClient: Failure in evbuffer_peek()");
-        (*ext_cb)(restReply(false, str_data));
-        cleanup(pair);
+    str_data.resize(evbuffer_get_length(input_buffer));
+    if (!str_data.empty() && evbuffer_copyout(input_buffer, &str_data[0], str_data.size()) < 0) {
+        WARN_NON_OO("restClient: Failure in evbuffer_copyout()");
+        request->callback(restReply(false, ""));
+        delete request;
         return;
     }
 
-    // Allocate space for the chunks.
-    vec_out = (evbuffer_iovec*)malloc(sizeof(evbuffer_iovec) * n_vec);
-
-    n_vec = evbuffer_peek(input_buffer, datalen, nullptr, vec_out, n_vec);
-    for (int i = 0; i < n_vec; i++) {
-        size_t len = vec_out[i].iov_len;
-        if (written + len > datalen)
-            len = datalen - written;
-        str_data.append((char*)vec_out[i].iov_base, len);
-        written += len;
-    }
-    free(vec_out);
-
     // call the external callback
-    (*ext_cb)(restReply(true, str_data));
-    cleanup(pair);
-}
-
-void restClient::cleanup(
-    std::pair<std::function<void(restReply)>*, struct evhttp_connection*>* pair) {
-    if (pair->second)
-        evhttp_connection_free(pair->second);
-    delete pair;
+    request->callback(restReply(true, str_data));
+    delete request;
 }
 
 void restClient::make_request(const std::string& path,
-                              std::function<void(restReply)>& request_done_cb,
+                              std::function<void(restReply)> request_done_cb,
                               const nlohmann::json& data, const std::string& host,
                               const unsigned short port, const int retries, const int timeout) {
     DEBUG2_NON_OO("restClient::make_request(): {}:{}{}, data = {}", host, port, path, data.dump(4));
 
-    if (!bev_req_write || !bev_req_read)
-        FATAL_ERROR_NON_OO(
-            "restClient: make_request called, but bev_req_write returned a nullptr.");
-
-    // serialize json data
-    std::string datadump = data.dump();
-
-    // put as much of the request data as possible in a struct
-    restRequest request = {
-        datadump.size(), path.size(), host.size(), retries, timeout, port, &request_done_cb,
-    };
-    if (data.empty())
-        request.data_len = 0;
-
-    // We have a struct and 3 strings to drop into the bufferevent.
-    // We only want the read callback to be called once we are done. That's why we use
-    // evbuffer_iovec to copy all our data in before committing that to the bufferevent.
-    evbuffer_iovec iovec[2];
-    size_t len_total = sizeof(restRequest) + request.host_len + request.path_len + request.data_len;
-    evbuffer* output_buf = bufferevent_get_output(bev_req_write);
-
-    // After we reserve space we have to make sure no other thread writes to the buffer before
-    // we commit. Therefore lock this critical section with a mutex.
-    std::lock_guard<std::mutex> lock_bev_buffer(_mtx_bev_buffer);
-    int n_extends = evbuffer_reserve_space(output_buf, len_total, iovec, 2);
-    if (n_extends < 0)
-        FATAL_ERROR_NON_OO(
-            "restClient::make_request: unable to reserve memory (evbuffer_reserve_space).");
-
-    int i_extends = 0;
-    size_t i_vec = 0;
-    _copy_to_iovec(&request, sizeof(request), iovec, &i_extends, &i_vec, n_extends);
-    _copy_to_iovec(host.c_str(), request.host_len, iovec, &i_extends, &i_vec, n_extends);
-    _copy_to_iovec(path.c_str(), request.path_len, iovec, &i_extends, &i_vec, n_extends);
-    if (request.data_len)
-        _copy_to_iovec(datadump.c_str(), request.data_len, iovec, &i_extends, &i_vec, n_extends);
-
-    // make sure we don't commit too much
-    iovec[i_extends].iov_len = i_vec;
-
-    if (evbuffer_commit_space(output_buf, iovec, i_extends + 1) < 0)
-        FATAL_ERROR_NON_OO("restClient::make_request: Failure in evbuffer_commit_space.");
-}
-
-void restClient::_copy_to_iovec(const void* src, size_t len_src, evbuffer_iovec* iovec,
-                                int* i_extends, size_t* i_vec, int n_extends) {
-    // If we have more data than fits in the iovec, copy as much as possible and continue
-    // with the next extension of the iovec.
-    while (len_src > iovec[*i_extends].iov_len) {
-        std::memcpy(static_cast<char*>(iovec[*i_extends].iov_base) + *i_vec, src,
-                    iovec[*i_extends].iov_len);
-        src = static_cast<const char*>(src) + iovec[*i_extends].iov_len;
-        len_src -= iovec[*i_extends].iov_len;
-        *i_vec = 0;
-        if (++(*i_extends) >= n_extends)
-            FATAL_ERROR_NON_OO(
-                "restClient::_copy_to_iovec: not enough iovec extends to copy data.");
-    }
+    if (!request_done_cb)
+        FATAL_ERROR_NON_OO("restClient: external callback function is not callable.");
 
-    // If the iovec has enough space, copy all and be done.
-    std::memcpy(static_cast<char*>(iovec[*i_extends].iov_base) + *i_vec, src, len_src);
-    *i_vec += len_src;
-    return;
+    std::vector<pendingRequest*> request = {new pendingRequest{
+        this, path, host, data.empty() ? "" : data.dump(), port, retries, timeout,
+        std::move(request_done_cb)}};
+    enqueue(request);
 }
 
-void restClient::_bev_req_readcb(struct bufferevent* bev, void* arg) {
-    // Get the restClient object from the arg void pointer
-    restClient* client = (restClient*)arg;
-    if (!client)
-        FATAL_ERROR_NON_OO("restClient: _bev_req_readcb got nullptr client");
-
-    // libevent calls this cb just once when there are multiple requests in the
-    // bufferevent pair. Read until we have all of them.
-    size_t len_read;
-    while (true) {
-        restRequest request;
-        len_read = 0;
-        do {
-            len_read += bufferevent_read(bev, &request + len_read, sizeof(restRequest) - len_read);
-            // this can be empty ...means there's nothing to do.
-            if (len_read == 0)
-                return;
-        } while (len_read < sizeof(restRequest));
-        DEBUG2_NON_OO("restClient: _bev_req_readcb read {} bytes", len_read);
-        if (len_read != sizeof(restRequest))
-            FATAL_ERROR_NON_OO("restClient::_bev_req_readcb: Failure reading request struct from "
-                               "bufferevent ({} != {}).",
-                               len_read, sizeof(restRequest));
-
-        std::string host;
-        host.resize(request.host_len);
-        len_read = 0;
-        do
-            len_read += bufferevent_read(bev, &host[0] + len_read, request.host_len - len_read);
-        while (len_read < request.host_len);
-        if (len_read != request.host_len)
-            FATAL_ERROR_NON_OO("restClient::_bev_req_readcb: Failure reading hostname from "
-                               "bufferevent ({} != {}).",
-                               len_read, request.host_len);
-
-        std::string path;
-        path.resize(request.path_len);
-        len_read = 0;
-        do
-            len_read += bufferevent_read(bev, &path[0] + len_read, request.path_len - len_read);
-        while (len_read < request.path_len);
-        if (len_read != request.path_len)
-            FATAL_ERROR_NON_OO("restClient::_bev_req_readcb: Failure reading endpoint from "
-                               "bufferevent ({} != {}).",
-                               len_read, request.path_len);
-
-        evhttp_connection* evcon =
-            evhttp_connection_base_new(client->_base, client->_dns, host.c_str(), request.port);
-        if (evcon == nullptr)
-            FATAL_ERROR_NON_OO("restClient: evhttp_connection_base_new() failed.");
-
-        if (request.retries > 0)
-            evhttp_connection_set_retries(evcon, request.retries);
-        if (request.timeout >= 0)
-            evhttp_connection_set_timeout(evcon, request.timeout);
-
-        // Fire off the request and pass the external callback to the internal one.
-        // check if external callback function is callable
-        if (!request.request_done_cb) {
-            evhttp_connection_free(evcon);
-            FATAL_ERROR_NON_OO("restClient: external callback function is not callable.");
-        }
-
-        // pass the external callback function to the libevent callback
-        // also pass the connection to the callback, so it can be freed there
-        std::pair<std::function<void(restReply)>*, evhttp_connection*>* pair =
-            new std::pair<std::function<void(restReply)>*, evhttp_connection*>(
-                request.request_done_cb, evcon);
-        evhttp_request* req = evhttp_request_new(http_request_done, pair);
-        if (req == nullptr) {
-            evhttp_connection_free(evcon);
-            FATAL_ERROR_NON_OO("restClient: evhttp_request_new() failed.");
-        }
-        evkeyvalq* output_headers = evhttp_request_get_output_headers(req);
-        if (evhttp_add_header(output_headers, "Host", host.c_str())) {
-            evhttp_connection_free(evcon);
-            evhttp_request_free(req);
-            FATAL_ERROR_NON_OO("restClient: Failure adding \"Host\" header.");
-        }
-        if (evhttp_add_header(output_headers, "Connection", "close")) {
-            evhttp_connection_free(evcon);
-            evhttp_request_free(req);
-            FATAL_ERROR_NON_OO("restClient: Failure adding \"Connection\" header.");
-        }
-        if (evhttp_add_header(output_headers, "Content-Type", "application/json")) {
-            evhttp_connection_free(evcon);
-            evhttp_request_free(req);
-            FATAL_ERROR_NON_OO("restClient: Failure adding \"Content-Type\" header.");
-        }
+std::future<restClient::restReply>
+restClient::make_request_async(const std::string& path, const nlohmann::json& data,
+                               const std::string& host, const unsigned short port,
+                               const int retries, const int timeout) {
+    return std::move(make_requests({{path, data, host, port, retries, timeout}})[0]);
+}
 
-        int ret;
-        if (request.data_len) {
-            char buf[256];
-
-            evbuffer* output_buffer = evhttp_request_get_output_buffer(req);
-            evbuffer* bev_buffer = bufferevent_get_input(bev);
-
-            // move data into the requests output buffer (avoids copy by value)
-            len_read = 0;
-            do
-                len_read +=
-                    evbuffer_remove_buffer(bev_buffer, output_buffer, request.data_len - len_read);
-            while (len_read < request.data_len);
-            if (len_read != request.data_len) {
-                evhttp_connection_free(evcon);
-                evhttp_request_free(req);
-                FATAL_ERROR_NON_OO("restClient::_bev_req_readcb: Failure reading data from "
-                                   "bufferevent ({} != {}).",
-                                   len_read, request.data_len);
-            }
-
-            evutil_snprintf(buf, sizeof(buf) - 1, "%lu", (unsigned long)request.data_len);
-            if (evhttp_add_header(output_headers, "Content-Length", buf)) {
-                evhttp_connection_free(evcon);
-                evhttp_request_free(req);
-                FATAL_ERROR_NON_OO("restClient: Failure adding \"Content-Length\" header.");
-            }
-            DEBUG_NON_OO("restClient: Sending {:s} bytes.", buf);
-
-            ret = evhttp_make_request(evcon, req, EVHTTP_REQ_POST, path.c_str());
-        } else {
-            DEBUG_NON_OO("restClient: sending GET request.");
-            ret = evhttp_make_request(evcon, req, EVHTTP_REQ_GET, path.c_str());
-        }
-        if (ret) {
-            evhttp_connection_free(evcon);
-            evhttp_request_free(req);
-            FATAL_ERROR_NON_OO("restClient: evhttp_make_request() failed.");
-        }
+std::vector<std::future<restClient::restReply>>
+restClient::make_requests(const std::vector<restRequest>& requests) {
+    std::vector<std::future<restReply>> replies;
+    std::vector<pendingRequest*> pending;
+    for (auto& r : requests) {
+        auto promise = std::make_shared<std::promise<restReply>>();
+        replies.push_back(promise->get_future());
+        pending.push_back(new pendingRequest{
+            this, r.path, r.host, r.data.empty() ? "" : r.data.dump(), r.port, r.retries,
+            r.timeout, [promise](restReply reply) { promise->set_value(std::move(reply)); }});
     }
+    enqueue(pending);
+    return replies;
 }
 
 restClient::restReply restClient::make_request_blocking(const std::string& path,
@@ -428,58 +402,18 @@ restClient::restReply restClient::make_request_blocking(const std::string& path,
                                                         const std::string& host,
                                                         const unsigned short port,
                                                         const int retries, const int timeout) {
-    restReply reply = restReply(false, "");
-    bool reply_copied = false;
-
-    // Condition variable to signal that reply was copied
-    std::condition_variable cv_reply;
-    std::mutex mtx_reply;
-
-    // As a callback, pass a lambda that synchronizes copying the reply in here.
-    std::function<void(restReply)> callback([&](restReply reply_in) {
-        std::lock_guard<std::mutex> lck_reply(mtx_reply);
-        reply = reply_in;
-        reply_copied = true;
-        cv_reply.notify_one();
-    });
-
-    std::unique_lock<std::mutex> lck_reply(mtx_reply);
-
-    make_request(path, callback, data, host, port, retries, timeout);
+    std::future<restReply> reply = make_request_async(path, data, host, port, retries, timeout);
 
     // Wait for the callback to receive the reply.
     // Note: This timeout is only in case libevent for any reason never
-    // calls the callback lambda we pass to it. That's a serious error case.
+    // calls the callback we pass to it. That's a serious error case.
     // In a normal timeout situation, we have to make sure libevent times out
-    // before this, that's why we wait twice as long.
-    auto time_point =
-        std::chrono::system_clock::now() + std::chrono::seconds(timeout == -1 ? 100 : timeout * 2);
-    while (!cv_reply.wait_until(lck_reply, time_point, [&]() { return reply_copied; })) {
+    // before this, that's why we wait twice as long (for every attempt).
+    if (reply.wait_for(reply_wait(retries, timeout)) != std::future_status::ready) {
         FATAL_ERROR_NON_OO("restClient: Timeout in make_request_blocking ({:s}:{:d}/{:s}). This "
                            "might leave the restClient in an abnormal state. Exiting...",
                            host, port, path);
-        return reply;
+        return restReply(false, "");
     }
-    return reply;
-}
-
-void restClient::_bev_req_errcb(bufferevent* bev, short what, void* arg) {
-    (void)arg;
-    std::string err = "";
-
-    // find out what the error code means
-    if (what & BEV_EVENT_READING)
-        err += "error encountered while reading, ";
-    if (what & BEV_EVENT_WRITING)
-        err += "error encountered while writing, ";
-    if (what & BEV_EVENT_EOF)
-        err += "eof file reached, ";
-    if (what & BEV_EVENT_ERROR)
-        err += "unrecoverable error encountered, ";
-    if (what & BEV_EVENT_TIMEOUT)
-        err += "user-specified timeout reached, ";
-    if (what & BEV_EVENT_CONNECTED)
-        err += "connect operation finished.";
-
-    WARN_NON_OO("restClient::_bev_req_errcb: {:p} - {:d} ({:s})", (void*)bev, what, err);
+    return reply.get();
 }
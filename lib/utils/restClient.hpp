@@ -10,16 +10,20 @@
 #include "json.hpp" // for json
 
 #include <atomic>             // for atomic
+#include <chrono>             // for seconds
 #include <condition_variable> // for condition_variable
-#include <event2/buffer.h>    // for evbuffer_iovec
 #include <event2/http.h>      // for evhttp_connection
 #include <event2/util.h>      // for evutil_socket_t
 #include <functional>         // for function
+#include <future>             // for future
+#include <map>                // for map
+#include <memory>             // for unique_ptr
 #include <mutex>              // for mutex
 #include <stddef.h>           // for size_t
 #include <string>             // for string, allocator
 #include <thread>             // for thread
 #include <utility>            // for pair
+#include <vector>             // for vector
 
 
 /**
@@ -29,42 +33,31 @@
  * This class supports sending GET messages and POST messages with json data
  * using libevent and provides access to data from the reply of the server.
  *
+ * Requests can be made with a callback (@c make_request), as a future
+ * (@c make_request_async), several at once (@c make_requests) or blocking
+ * (@c make_request_blocking). None of these hold up other requests.
+ *
  * Implementation
  * ==============
  *
- * There is an event loop running in the main_thread() that gets started by the constructor.
+ * There is an event loop running in the event_thread() that gets started by the constructor.
  * The event thread is sending out requests, waits for results and calls the assigned callback
- * functions. All this has to be done from the same thread that runs the event loop, which makes
- * class more complicated than you would expect:
- * The function `make_request` does not itself create the request, because it's usually called from
- * another thread. To bring the request to the event loop thread, libevent's `bufferevent_pair` is
- * used (see http://www.wangafu.net/~nickm/libevent-book/Ref6a_advanced_bufferevents.html).
- * One side of the pair (`bev_req_write`) takes new requests in the form
- *
- * | struct restRequest | string host | string path | string json_data |
- *
- * The length of each string is in the `restRequest` struct. Writing all of this data to the
- * bufferevent's output buffer has to be done atomically, so that the read callback
- * (`_bev_req_readcb`) attached to the other side of the pair (`bew_req_read`) is not called more
- * than once. To achieve this, a `evbuffer_iovec` is used to reserve the necessary space in the
- * output buffer, then copying all data in and finally committing the written data once, which will
- * trigger the read callback. The described sequence still has to be protected from concurrent
- * access (`_mtx_bev_buffer`), because it fails if the buffer is written to between reserving and
- * committing.
+ * functions. All this has to be done from the same thread that runs the event loop, so
+ * the request functions put the requests in a queue and wake up the event loop, which
+ * takes all the queued requests at once.
  *
- * The request is then finally made by the same thread that runs the event loop, in the
- * read callback `_bev_req_readcb` attached to the reading side `bev_req_read` of the
- * bufferevent pair. This is done by the following:
+ * Connections are kept open (HTTP keep-alive) and reused: there is a pool of up to
+ * @c max_connections_per_host connections to each host and port. A request goes to an idle
+ * connection, or a new one if there is none and the pool isn't full yet. Otherwise it is
+ * queued on the connection with the fewest requests, and sent as soon as the previous ones
+ * are answered, without reconnecting.
  *
- * - Create a connection base.
- * - Make a new HTTP request. The external callback function as well as the connection base are
- *   attached to the request in order to pass them to the internal callback function.
- * - Write request data into the HTTP request output buffer.
- * - Start the request.
+ * Each attempt of a request has a timeout, after which it is cancelled. Requests which failed
+ * to connect, lost their connection or timed out are tried again up to @c retries times,
+ * waiting a little longer each time. Requests the server replied to with an error are not
+ * tried again.
  *
- * When the request is done, the internal callback function `http_request_done` is called.
- * It calls the external callback that was initially given to `make_request` and hands the
- * result of the request to it.
+ * When a request is done, the callback is called on the event thread, so it should be quick.
  *
  * @author Rick Nitsche
  */
@@ -73,6 +66,25 @@ public:
     /// The reply of a request: a pair with a success boolean and the reply string
     using restReply = std::pair<bool, std::string>;
 
+    /// A request, for @c make_requests.
+    struct restRequest {
+        /// Path to the endpoint (e.g. "/endpoint_name")
+        std::string path;
+        /// JSON request (`{}` to send a GET request)
+        nlohmann::json data = {};
+        /// Host (prefer numerical, because the DNS lookup is blocking)
+        std::string host = "127.0.0.1";
+        /// Port
+        unsigned short port = PORT_REST_SERVER;
+        /// Max. retries to send message
+        int retries = 0;
+        /// Timeout in seconds, -1 for the default (of 50 seconds)
+        int timeout = -1;
+    };
+
+    /// The number of connections kept open to each host and port
+    static constexpr size_t max_connections_per_host = 4;
+
     /**
      * @brief Returns an instance of the rest client.
      *
@@ -89,7 +101,7 @@ public:
      * @param path      Path to the endpoint
      *                  (e.g. "/endpoint_name")
      * @param request_done_cb   A callback function that when the request is
-     *                          complete.
+     *                          complete. Called on the event thread.
      * @param data      JSON request (`{}` to send a GET request,
      *                  default: `{}`).
      * @param host      Host (default: "127.0.0.1", Prefer numerical, because
@@ -99,11 +111,36 @@ public:
      * @param timeout   Timeout in seconds. If -1 is passed, the default value
      * (of 50 seconds) is set (default: -1).
      */
-    void make_request(const std::string& path, std::function<void(restReply)>& request_done_cb,
+    void make_request(const std::string& path, std::function<void(restReply)> request_done_cb,
                       const nlohmann::json& data = {}, const std::string& host = "127.0.0.1",
                       const unsigned short port = PORT_REST_SERVER, const int retries = 0,
                       const int timeout = -1);
 
+    /**
+     * @brief Send GET or POST with json data to an endpoint, and get the reply later.
+     *
+     * Takes the same arguments as @c make_request, apart from the callback.
+     *
+     * @return A future holding the reply once the request is done.
+     */
+    std::future<restReply> make_request_async(const std::string& path,
+                                              const nlohmann::json& data = {},
+                                              const std::string& host = "127.0.0.1",
+                                              const unsigned short port = PORT_REST_SERVER,
+                                              const int retries = 0, const int timeout = -1);
+
+    /**
+     * @brief Send several requests at once.
+     *
+     * The requests are handed to the event thread in one go, and sent concurrently
+     * (requests to the same host spread over its connections).
+     *
+     * @param requests  The requests.
+     *
+     * @return A future for the reply of each request, in the same order.
+     */
+    std::vector<std::future<restReply>> make_requests(const std::vector<restRequest>& requests);
+
     /**
      * @brief Send GET or POST with json data to an endpoint. Blocking.
      *
@@ -129,21 +166,39 @@ public:
                                     const unsigned short port = PORT_REST_SERVER,
                                     const int retries = 0, const int timeout = -1);
 
+    /**
+     * @brief How long to wait at most for the reply of a request.
+     *
+     * This is twice the timeout of every attempt, so the request times out before
+     * this unless libevent never calls back, which is a serious error.
+     *
+     * @param retries   Max. retries of the request.
+     * @param timeout   Timeout of the request in seconds, -1 for the default.
+     *
+     * @return          The time to wait for the reply.
+     */
+    static std::chrono::seconds reply_wait(const int retries = 0, const int timeout = -1) {
+        return std::chrono::seconds((timeout == -1 ? 50 : timeout) * 2 * (retries + 1) + 10);
+    }
+
+    /// The number of connections opened so far (for testing the connection reuse)
+    size_t num_connections_opened() const {
+        return _num_connections_opened;
+    }
+
 private:
-    /// A structure to pass requests around inside the restClient
-    struct restRequest {
-        // The strings are of dynamic length and kept outside of the struct.
-        // But we need to pass their sizes...
-        size_t data_len;
-        size_t path_len;
-        size_t host_len;
-
-        int retries;
-        int timeout;
-        unsigned short port;
-        std::function<void(restReply)>* request_done_cb;
+    /// A connection kept open to a host
+    struct pooledConnection {
+        struct evhttp_connection* evcon;
+        /// The number of requests sent or queued on it
+        size_t in_flight;
+        /// The number of requests it was used for
+        size_t used;
     };
 
+    /// A request on its way, only used on the event thread once queued
+    struct pendingRequest;
+
     /// Private constuctor
     restClient();
 
@@ -160,25 +215,32 @@ private:
     /// Internal thread function which runs the event loop.
     void event_thread();
 
-    /// callback function for http requests
-    static void http_request_done(struct evhttp_request* req, void* arg);
+    /// Queues requests for the event thread and wakes it up
+    void enqueue(std::vector<pendingRequest*>& requests);
+
+    /// libevent callback taking the queued requests
+    static void _queue_cb(evutil_socket_t fd, short event, void* arg);
+
+    /// Sends an attempt of a request (event thread only)
+    void send(pendingRequest* request);
 
-    /// cleanup function that deletes evcon and the argument pair
-    static void cleanup(std::pair<std::function<void(restReply)>*, evhttp_connection*>* pair);
+    /// Picks (or opens) the connection for a request (event thread only)
+    pooledConnection* get_connection(const std::string& host, unsigned short port);
 
-    /// Only to be called inside event thread
-    bool _make_request(const restRequest* request);
+    /// Tries again, or calls the callback with a failure (event thread only)
+    void failed(pendingRequest* request, const std::string& reason);
 
-    /// Read callback for the request scheduling thread. Called when the socket holding request
-    /// pointers has new data.
-    static void _bev_req_readcb(struct bufferevent* bev, void* arg);
+    /// Ends an attempt, freeing its timer and releasing its connection (event thread only)
+    static void end_attempt(pendingRequest* request);
 
-    /// error callback for the bufferevent pair
-    static void _bev_req_errcb(struct bufferevent* bev, short what, void* arg);
+    /// libevent callback for a request which is done
+    static void http_request_done(struct evhttp_request* req, void* arg);
+
+    /// libevent callback for a request which timed out
+    static void _timeout_cb(evutil_socket_t fd, short event, void* arg);
 
-    /// Helper function to copy data of any length into iovec structure.
-    static inline void _copy_to_iovec(const void* src, size_t len_src, evbuffer_iovec* iovec,
-                                      int* i_extends, size_t* i_vec, int n_extends);
+    /// libevent callback to try a request again
+    static void _retry_cb(evutil_socket_t fd, short event, void* arg);
 
     /// Main event thread handle
     std::thread _main_thread;
@@ -198,15 +260,21 @@ private:
     bool _event_thread_started;
     std::mutex _mtx_start;
 
-    /// Writing socket event to pass requests to the event thread
-    struct bufferevent* bev_req_write;
+    /// Requests waiting for the event thread
+    std::vector<pendingRequest*> _queue;
+
+    /// Lock for @c _queue
+    std::mutex _mtx_queue;
+
+    /// Event activated to take the queued requests
+    struct event* _queue_event;
 
-    /// Reading socket event to pass requests to the event thread
-    struct bufferevent* bev_req_read;
+    /// Connection pools by host and port (event thread only)
+    std::map<std::pair<std::string, unsigned short>,
+             std::vector<std::unique_ptr<pooledConnection>>>
+        _pools;
 
-    /// Lock to protect writing to the bufferevent_pair's output buffer (the datasetManager does
-    /// this in threads for example).
-    std::mutex _mtx_bev_buffer;
+    std::atomic<size_t> _num_connections_opened;
 };
 
 #endif // RESTCLIENT_HPP
@@ -3,7 +3,7 @@
 
 #include "fmt.hpp" // for format, fmt
 
-#include <ctime>      // for gmtime, time_t
+#include <ctime>      // for gmtime_r, time_t, tm
 #include <fstream>    // for basic_ostream::operator<<, ofstream, endl, basic_ostream, basic_os...
 #include <iterator>   // for reverse_iterator
 #include <libgen.h>   // for dirname, basename
@@ -95,7 +95,10 @@ void visFileBundle::add_file(time_ctype first_time) {
     // Start the acq and create the directory if required
     if (acq_name.empty()) {
         // Format the time (annoyingly you still have to use streams for this)
-        acq_name = fmt::format("{:%Y%m%dT%H%M%SZ}_{:s}_corr", *std::gmtime(&t), instrument_name);
+        // The bundles are written on several threads, so use the reentrant gmtime
+        struct tm tm;
+        gmtime_r(&t, &tm);
+        acq_name = fmt::format("{:%Y%m%dT%H%M%SZ}_{:s}_corr", tm, instrument_name);
         // Set the acq fields on the instance
         acq_start_time = first_time.ctime;
 
@@ -137,9 +137,8 @@ void visFileArchive::write_block(std::string name, size_t f_ind, size_t t_ind, s
         dset(name).select({0, t_ind}, {length("input"), chunk_t}).write(data);
     } else if (name == "evec") {
         DEBUG2("writing {}...", name);
-        dset(name)
-            .select({f_ind, 0, 0, t_ind}, {chunk_f, length("ev"), length("input"), chunk_t})
-            .write(data);
+        write_compressed(dset(name), {f_ind, 0, 0, t_ind},
+                         {chunk_f, length("ev"), length("input"), chunk_t}, data);
     } else if (name == "erms" || name == "flags/frac_lost" || name == "flags/frac_rfi"
                || name == "flags/dataset_id") {
         DEBUG2("writing {}...", name);
@@ -147,7 +146,7 @@ void visFileArchive::write_block(std::string name, size_t f_ind, size_t t_ind, s
     } else {
         DEBUG2("writing {}...", name);
         size_t last_dim = dset(name).getSpace().getDimensions().at(1);
-        dset(name).select({f_ind, 0, t_ind}, {chunk_f, last_dim, chunk_t}).write(data);
+        write_compressed(dset(name), {f_ind, 0, t_ind}, {chunk_f, last_dim, chunk_t}, data);
     }
 }
 
@@ -1,7 +1,7 @@
 
 #include "visFileH5.hpp"
 
-#include "H5Support.hpp"      // for AtomicType<>::AtomicType, dset_id_str
+#include "H5Support.hpp"      // for AtomicType<>::AtomicType, dset_id_str, hdf5_lock
 #include "Hash.hpp"           // for Hash
 #include "datasetManager.hpp" // for datasetManager, dset_id_t
 #include "datasetState.hpp"   // for eigenvalueState, freqState, inputState, prodState
@@ -27,6 +27,7 @@
 #include <highfive/H5Object.hpp>    // for Object::getId, HighFive
 #include <highfive/H5PropertyList.hpp>
 #include <highfive/H5Selection.hpp> // for Selection, SliceTraits::write, SliceTraits::select
+#include <mutex>                    // for lock_guard, mutex
 #include <numeric>                  // for iota
 #include <stdexcept>                // for runtime_error, out_of_range
 #include <string.h>                 // for strerror
@@ -90,16 +91,24 @@ visFileH5::visFileH5(const std::string& name, const kotekan::logLevel log_level,
 
     INFO("Creating new output file {:s}", name);
 
-    file = std::unique_ptr<File>(
-        new File(data_filename, File::ReadWrite | File::Create | File::Truncate));
-    create_axes(unzip(fstate->get_freqs()).second, istate->get_inputs(), pstate->get_prods(),
-                num_ev);
-    _max_time = max_time;
-
-    // Write out metadata into flle
-    for (auto item : metadata) {
-        file->createAttribute<std::string>(item.first, DataSpace::From(item.second))
-            .write(item.second);
+    // The files may be written on several threads
+    std::lock_guard<std::mutex> lock(hdf5_lock());
+    try {
+        file = std::unique_ptr<File>(
+            new File(data_filename, File::ReadWrite | File::Create | File::Truncate));
+        create_axes(unzip(fstate->get_freqs()).second, istate->get_inputs(),
+                    pstate->get_prods(), num_ev);
+        _max_time = max_time;
+
+        // Write out metadata into flle
+        for (auto item : metadata) {
+            file->createAttribute<std::string>(item.first, DataSpace::From(item.second))
+                .write(item.second);
+        }
+    } catch (...) {
+        // Close the file while we still hold the lock
+        file.reset(nullptr);
+        throw;
     }
 }
 
@@ -109,8 +118,11 @@ void visFileH5::deferred_init() {
 }
 
 visFileH5::~visFileH5() {
-    file->flush();
-    file.reset(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(hdf5_lock());
+        file->flush();
+        file.reset(nullptr);
+    }
     std::remove(lock_filename.c_str());
 }
 
@@ -217,12 +229,15 @@ size_t visFileH5::length(const std::string& axis_name) {
 }
 
 size_t visFileH5::num_time() {
+    std::lock_guard<std::mutex> lock(hdf5_lock());
     return length("time");
 }
 
 
 uint32_t visFileH5::extend_time(time_ctype new_time) {
 
+    std::lock_guard<std::mutex> lock(hdf5_lock());
+
     // If we haven't create all the datasets, we need to do that now.
     if (!file->exist("vis")) {
         deferred_init();
@@ -268,6 +283,8 @@ void visFileH5::write_sample(uint32_t time_ind, uint32_t freq_ind, const FrameVi
             frame.num_ev, num_ev));
     }
 
+    std::lock_guard<std::mutex> lock(hdf5_lock());
+
     // Get the current dimensions
     size_t nprod = length("prod"), ninput = length("input"), nev = length("ev");
 
@@ -310,6 +327,7 @@ void visFileH5Fast::deferred_init() {
 visFileH5Fast::~visFileH5Fast() {
     // Save the number of samples added into the `num_time` attribute.
     int nt = (size_t)num_time();
+    std::lock_guard<std::mutex> lock(hdf5_lock());
     file->createAttribute<int>("num_time", DataSpace::From(nt)).write(nt);
 }
 
@@ -433,9 +451,13 @@ void visFileH5Fast::flush_raw_sync(off_t dset_base, int ind, size_t n) {
 
 uint32_t visFileH5Fast::extend_time(time_ctype new_time) {
 
-    // If we haven't create the datasets, we need to do that now.
-    if (!file->exist("vis")) {
-        deferred_init();
+    // If we haven't create the datasets, we need to do that now. The rest is
+    // written without going through libhdf5.
+    {
+        std::lock_guard<std::mutex> lock(hdf5_lock());
+        if (!file->exist("vis")) {
+            deferred_init();
+        }
     }
 
     // Perform a raw write of the new time sample
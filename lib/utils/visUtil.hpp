@@ -358,6 +358,16 @@ inline double current_time() {
     return ts_to_double(ts);
 }
 
+/**
+ * @brief Get the CPU time used by the calling thread so far.
+ * @return  CPU time in seconds.
+ **/
+inline double current_thread_cpu_time() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts_to_double(ts);
+}
+
 /**
  * @brief Calculate the size of GPU packed data.
  *
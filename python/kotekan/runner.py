@@ -817,10 +817,21 @@ class ReadRawBeamformBuffer(InputBuffer):
 
 
 class ReadRawBuffer(InputBuffer):
+    """Read a raw file (or files) with VisRawReader.
+
+    Parameters
+    ----------
+    infile : string or list of strings
+        The raw file(s) to read, without the extension.
+    chunk_size : list
+        The chunk size (freq, prod, time) to read with.
+    extra_config : dict, optional
+        Any other configuration for the reader stage, e.g. the `read_mode`.
+    """
 
     _buf_ind = 0
 
-    def __init__(self, infile, chunk_size):
+    def __init__(self, infile, chunk_size, extra_config=None):
 
         self.name = "read_raw_buf{:d}".format(self._buf_ind)
         stage_name = "read_raw{:d}".format(self._buf_ind)
@@ -841,6 +852,8 @@ class ReadRawBuffer(InputBuffer):
             "chunk_size": chunk_size,
             "readahead_blocks": 4,
         }
+        if extra_config is not None:
+            stage_config.update(extra_config)
 
         self.stage_block = {stage_name: stage_config}
 
@@ -56,6 +56,12 @@ class SharedMemoryReader:
     The reader keeps a copy of frames in a buffer between calls and only copies new frames on the
     next `update()` call.
 
+    The reader never blocks the writer: every frame in the shared memory has a generation counter
+    that the writer makes odd while it modifies the frame and even again once it is done. Frames
+    that were being written when the access record was read, or whose generation changed while
+    copying them, are marked invalid. This relies on loads not being reordered with other loads
+    (true on x86).
+
     Parameters
     ----------
     shared_memory_name : int
@@ -72,6 +78,7 @@ class SharedMemoryReader:
     num_structural_params = 6
     size_structural_data = SIZE_UINT64_T * num_structural_params
     size_access_record_entry = SIZE_UINT64_T
+    size_generation_entry = SIZE_UINT64_T
     valid_field_padding = 3
     size_valid_field = 1
     invalid_value = -1
@@ -86,7 +93,6 @@ class SharedMemoryReader:
         self.shared_mem_name = shared_memory_name
 
         try:
-            self.semaphore = posix_ipc.Semaphore(shared_memory_name)
             self.shared_mem_file = posix_ipc.SharedMemory(shared_memory_name)
         except posix_ipc.ExistentialError:
             raise SharedMemoryError(
@@ -137,8 +143,11 @@ class SharedMemoryReader:
         self.size_access_record = self.len_data * self.size_access_record_entry
         self.pos_access_record = self.size_structural_data
 
+        self.size_generation = self.len_data * self.size_generation_entry
+        self.pos_generation = self.pos_access_record + self.size_access_record
+
         self.size_data = self.len_data * self.size_frame
-        self.pos_data = self.pos_access_record + self.size_access_record
+        self.pos_data = self.pos_generation + self.size_generation
 
         self._initial_validation()
 
@@ -173,7 +182,10 @@ class SharedMemoryReader:
 
     def _initial_validation(self):
         shared_mem_size = (
-            self.size_structural_data + self.size_access_record + self.size_data
+            self.size_structural_data
+            + self.size_access_record
+            + self.size_generation
+            + self.size_data
         )
         if shared_mem_size != self.shared_mem.size():
             raise SharedMemoryError(
@@ -186,9 +198,6 @@ class SharedMemoryReader:
         return Structure.from_buffer_copy(self.shared_mem)
 
     def __del__(self):
-        if hasattr(self, "semaphore"):
-            self.semaphore.release()
-
         if hasattr(self, "shared_mem_file"):
             os.close(self.shared_mem_file.fd)
 
@@ -224,44 +233,43 @@ class SharedMemoryReader:
         self._validate_shm()
 
         # get a data update from the ringbuffer
-        access_record = self._access_record()
+        access_record, generation = self._access_record()
 
         times = self._filter_last(access_record, self.view_size)
         logger.debug("Reading last {} time slots: {}".format(self.view_size, times))
 
-        self._copy_from_shm(times, access_record)
+        copied = self._copy_from_shm(times, access_record)
 
-        # check if any data became invalid while reading it
-        access_record_after_copy = self._access_record()
-        invalid = np.where(access_record_after_copy != access_record)
-        if len(invalid[0]) > 0:
-            # get fpga_seq's of invalid frames
-            fpga_seq_invalid = access_record[invalid]
+        # check if any data was written to while reading it
+        invalid = np.where(
+            (self._generation() != generation) | (generation % 2 == 1)
+        )
+
+        # make sure frames that changed get copied again next time
+        access_record_copied = access_record.copy()
+        access_record_copied[invalid] = self.invalid_value
 
-            # filter out frames we didn't copy (including invalid ones)
-            filter = [fpga_seq in self._time_index_map for fpga_seq in fpga_seq_invalid]
-            fpga_seq_invalid = fpga_seq_invalid[filter]
+        if len(invalid[0]) > 0:
+            # filter out frames we didn't copy
+            filter = [t in copied for t in invalid[0]]
             invalid = (invalid[0][filter], invalid[1][filter])
 
-            if len(fpga_seq_invalid) > 0:
+            if len(invalid[0]) > 0:
                 logger.debug(
-                    "{} frames became invalid while reading: (fpga_seq={}, freq_id={})".format(
-                        len(invalid[0]), fpga_seq_invalid, invalid[1]
+                    "{} frames became invalid while reading: (time_ind={}, freq_id={})".format(
+                        len(invalid[0]), invalid[0], invalid[1]
                     )
                 )
 
-                # translate time from timestamp to buffer index
-                buf_idxs_invalid = (
-                    [self._time_index_map[f] for f in fpga_seq_invalid],
-                    invalid[1],
-                )
+                # translate time from shared memory to buffer index
+                buf_idxs_invalid = ([copied[t] for t in invalid[0]], invalid[1])
 
                 # mark as invalid
                 self._data["valid"][buf_idxs_invalid] = 0
 
         if self._last_access_record is None:
             self._last_access_record = np.ndarray((self.num_time, self.num_freq))
-        self._last_access_record[times, :] = access_record_after_copy[times, :]
+        self._last_access_record[times, :] = access_record_copied[times, :]
 
         # TODO: make sure this works when there's no data in the buffer yet
         # if self._time_index_map == {}:
@@ -419,15 +427,22 @@ class SharedMemoryReader:
             logger.debug("Copying from time index {} to {}.".format(idx_data, idx_shm))
             self._data[idx_data, :] = tmp[idx_shm, :]
 
+        return dict(time_samples_to_copy)
+
     def _access_record(self):
-        try:
-            self.semaphore.acquire(120)
-        except posix_ipc.BusyError:
-            raise SharedMemoryError(
-                "Timed out while waiting for the shared memory resources referenced by '{}'.".format(
-                    self.shared_mem_name
-                )
-            )
+        """
+        Take a snapshot of the access record and the generation counters.
+
+        The generations are read first, so an access record entry belongs to the frame that was
+        complete at that generation, unless the writer was busy with it (odd generation). Those
+        entries are marked invalid.
+
+        Returns
+        -------
+        (numpy array, numpy array)
+            Access record and generations, of shape (num_time, num_freq).
+        """
+        generation = self._generation()
 
         record = np.ndarray(
             (self.num_time, self.num_freq),
@@ -437,8 +452,17 @@ class SharedMemoryReader:
             order="C",
         ).copy()
 
-        self.semaphore.release()
-        return record
+        record[generation % 2 == 1] = self.invalid_value
+        return record, generation
+
+    def _generation(self):
+        return np.ndarray(
+            (self.num_time, self.num_freq),
+            np.uint64,
+            self.shared_mem,
+            self.pos_generation,
+            order="C",
+        ).copy()
 
     def _validate_shm(self):
         """
@@ -0,0 +1,281 @@
+"""Tune the parameters of the OpenCL kernels of kotekan.
+
+Runs kotekan with an OpenCL verification config (e.g. ``config/verify_opencl.yaml``,
+which checks the output of ``clProcess`` against ``gpuSimulate``) for every point of a
+grid of array geometries and kernel parameters. The kernel time of the verified runs is
+taken from the ``log_profiling`` output of the GPU stage, and the fastest parameters of
+each command, device and geometry are written to a JSON file which ``clProcess`` loads
+with ``kernel_tuning_file``.
+
+The device can be any OpenCL device, e.g. ``--device-type cpu`` for PoCL.
+
+The grid is a YAML file like::
+
+    geometry:
+        num_elements: [256]
+        block_size: [32]
+        samples_per_data_set: [16384, 49152]
+    commands:
+        clKVCorr:
+            kernel_name: corr
+            parameters:
+                - {}
+                - {full_complicated: true}
+
+where each list in ``geometry`` and in a parameter set is expanded, and ``kernel_name``
+is the name of the kernel in the profiling log. The command must be in the pipeline of
+the config.
+"""
+# === Start Python 2/3 compatibility
+from __future__ import absolute_import, division, print_function, unicode_literals
+from future.builtins import *  # noqa  pylint: disable=W0401, W0614
+from future.builtins.disabled import *  # noqa  pylint: disable=W0401, W0614
+
+# === End Python 2/3 compatibility
+
+import argparse
+import copy
+import itertools
+import json
+import os
+import re
+import subprocess
+import tempfile
+
+import yaml
+
+# Return code of kotekan when a testDataCheck stage has checked all its frames
+TEST_PASSED = 2
+
+# The options which key the tuned parameters, like in clCommand
+GEOMETRY_KEYS = [
+    "num_elements",
+    "num_local_freq",
+    "num_data_sets",
+    "samples_per_data_set",
+    "block_size",
+]
+
+# The tunable commands of the OpenCL verification config. The other kernel commands
+# have a single implementation and no tunable options.
+DEFAULT_GRID = {
+    "geometry": {},
+    "commands": {
+        "clKVCorr": {
+            "kernel_name": "corr",
+            "parameters": [{}, {"full_complicated": True}],
+        },
+        "clPresumKernel": {
+            "kernel_name": "offsetAccumulateElements",
+            "parameters": [
+                {"kernel": ["offset_accumulator.cl", "offsetAccumulator.cl"]}
+            ],
+        },
+    },
+}
+
+repo_dir = os.path.normpath(os.path.join(os.path.dirname(__file__), "..", ".."))
+
+
+def expand(grid):
+    """Expands a dict of values and lists of values into a list of dicts."""
+    keys = sorted(grid.keys())
+    values = [v if isinstance(v, list) else [v] for v in (grid[k] for k in keys)]
+    return [dict(zip(keys, point)) for point in itertools.product(*values)]
+
+
+def find_stage(config, stage_type):
+    """Returns the blocks of the stages of a type, and the blocks above each of them."""
+    found = []
+
+    def walk(block, parents):
+        if not isinstance(block, dict):
+            return
+        if str(block.get("kotekan_stage", "")).startswith(stage_type):
+            found.append((block, parents))
+        for value in block.values():
+            walk(value, parents + [block])
+
+    walk(config, [])
+    return found
+
+
+def make_config(base_config, args, geometry, command, parameters):
+    """Returns the config of a run, or None if the command isn't in the pipeline."""
+    config = copy.deepcopy(base_config)
+    config.update(geometry)
+
+    gpu_stages = find_stage(config, "clProcess")
+    if len(gpu_stages) != 1:
+        raise RuntimeError("The config must have one clProcess stage")
+    stage, parents = gpu_stages[0]
+    stage.update(
+        {
+            "gpu_id": args.gpu_id,
+            "platform": args.platform,
+            "device_type": args.device_type,
+            "kernel_path": args.kernel_path,
+            "log_profiling": True,
+        }
+    )
+
+    # The commands can be in the stage or in a block above it
+    commands = None
+    for block in [stage] + parents[::-1]:
+        if "commands" in block:
+            commands = block["commands"]
+            break
+    entries = [c for c in commands or [] if c["name"] == command]
+    if not entries:
+        return None
+    for entry in entries:
+        entry.update(parameters)
+
+    checks = find_stage(config, "testDataCheck")
+    if not checks:
+        raise RuntimeError("The config must check the output with testDataCheck")
+    for check, _ in checks:
+        check["num_frames_to_test"] = args.num_frames
+
+    return config
+
+
+def run(config, args):
+    """Runs kotekan, returns whether the output was right, the device and its log."""
+    with tempfile.NamedTemporaryFile("w", suffix=".yaml") as config_file:
+        yaml.safe_dump(config, config_file)
+        config_file.flush()
+        try:
+            result = subprocess.run(
+                [args.kotekan, "-c", config_file.name, "-b", args.bind],
+                stdout=subprocess.PIPE,
+                stderr=subprocess.STDOUT,
+                timeout=args.timeout,
+            )
+        except subprocess.TimeoutExpired:
+            return False, None, ""
+    log = result.stdout.decode(errors="replace")
+    device = re.search(r"OpenCL device: (.*)$", log, re.MULTILINE)
+    verified = result.returncode == TEST_PASSED and " != " not in log
+    return verified, device.group(1).strip() if device else None, log
+
+
+def kernel_time(log, kernel_name):
+    """Returns the median time of a kernel over the frames, without the first frame."""
+    times = [
+        float(t)
+        for t in re.findall(
+            r"kernel: {:s} time: ([0-9.eE+-]+)".format(re.escape(kernel_name)), log
+        )
+    ]
+    times = sorted(times[1:] if len(times) > 1 else times)
+    return times[len(times) // 2] if times else None
+
+
+def tune(base_config, args, geometry, command, spec):
+    """Runs all the parameters of a command, returns the device and the fastest."""
+    device = None
+    best = None
+    for parameter_set in spec.get("parameters", [{}]):
+        for parameters in expand(parameter_set):
+            config = make_config(base_config, args, geometry, command, parameters)
+            if config is None:
+                print("{:s} isn't in the pipeline of the config".format(command))
+                return None, None
+            verified, run_device, log = run(config, args)
+            device = run_device or device
+            time = kernel_time(log, spec.get("kernel_name", command))
+            if not verified or time is None:
+                print("{} {:s} {}: failed".format(geometry, command, parameters))
+                continue
+            print("{} {:s} {}: {:.6f} s".format(geometry, command, parameters, time))
+            if best is None or time < best[1]:
+                best = (parameters, time)
+    if device is None:
+        return None, None
+    return device, best
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Tune the parameters of the OpenCL kernels of kotekan"
+    )
+    parser.add_argument(
+        "--kotekan",
+        help="The kotekan binary",
+        default=os.path.join(repo_dir, "build", "kotekan", "kotekan"),
+    )
+    parser.add_argument(
+        "--config",
+        help="The verification config",
+        default=os.path.join(repo_dir, "config", "verify_opencl.yaml"),
+    )
+    parser.add_argument("--grid", help="YAML file with the grid, see the help")
+    parser.add_argument(
+        "--kernel-path",
+        help="Directory of the kernels",
+        default=os.path.join(repo_dir, "lib", "opencl", "kernels"),
+    )
+    parser.add_argument("--platform", help="OpenCL platform", type=int, default=0)
+    parser.add_argument(
+        "--device-type",
+        help="OpenCL device type",
+        choices=["gpu", "cpu", "accelerator", "all"],
+        default="gpu",
+    )
+    parser.add_argument("--gpu-id", help="Index of the device", type=int, default=0)
+    parser.add_argument(
+        "--num-frames", help="Frames to check in each run", type=int, default=8
+    )
+    parser.add_argument(
+        "--timeout", help="Timeout of each run in seconds", type=float, default=600
+    )
+    parser.add_argument(
+        "--bind",
+        help="Address of the REST server of kotekan",
+        default="127.0.0.1:12048",
+    )
+    parser.add_argument(
+        "-o",
+        "--output",
+        help="The tuning file, the results are merged into it",
+        default="kernel_tuning.json",
+    )
+    args = parser.parse_args()
+
+    with open(args.config) as f:
+        base_config = yaml.safe_load(f)
+    grid = DEFAULT_GRID
+    if args.grid:
+        with open(args.grid) as f:
+            grid = yaml.safe_load(f)
+
+    tuning = {}
+    if os.path.exists(args.output):
+        with open(args.output) as f:
+            tuning = json.load(f)
+
+    for geometry in expand(grid.get("geometry", {})):
+        # The whole geometry of the runs, not only the keys of the grid
+        run_geometry = dict(geometry)
+        for key in GEOMETRY_KEYS:
+            if isinstance(base_config.get(key), int):
+                run_geometry.setdefault(key, base_config[key])
+
+        for command, spec in grid["commands"].items():
+            device, best = tune(base_config, args, geometry, command, spec)
+            if best is None:
+                continue
+            print("Best for {:s} on {:s}: {} {:.6f} s".format(command, device, *best))
+            entries = tuning.setdefault(device, {}).setdefault(command, [])
+            entries[:] = [e for e in entries if e["geometry"] != run_geometry]
+            entries.append(
+                {"geometry": run_geometry, "parameters": best[0], "time": best[1]}
+            )
+
+    with open(args.output, "w") as f:
+        json.dump(tuning, f, indent=4, sort_keys=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,138 @@
+/*
+ * Boost tests for BufferShmRing
+ */
+#define BOOST_TEST_MODULE "test_BufferShmRing"
+
+#include "BufferShmRing.hpp" // for BufferShmRing
+
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <memory>                            // for unique_ptr, make_unique
+#include <stdexcept>                         // for runtime_error
+#include <stdint.h>                          // for uint8_t, uint32_t, int64_t
+#include <string.h>                          // for memset
+#include <string>                            // for string, to_string
+#include <thread>                            // for thread
+#include <unistd.h>                          // for getpid
+#include <vector>                            // for vector
+
+static std::string ring_name(const std::string& test) {
+    return "/kotekan_test_" + test + "_" + std::to_string(getpid());
+}
+
+/*
+ * Frames come out in order and unchanged, while the writer waits for space.
+ */
+BOOST_AUTO_TEST_CASE(transfer) {
+    const std::string name = ring_name("transfer");
+    const size_t frame_size = 10000, metadata_size = 100;
+    const uint32_t num_frames = 200;
+
+    BufferShmRing writer(name, 4, frame_size, metadata_size);
+    BufferShmRing reader(name);
+    BOOST_CHECK_EQUAL(reader.num_slots(), 4);
+    BOOST_CHECK_EQUAL(reader.frame_size(), frame_size);
+    BOOST_CHECK_EQUAL(reader.metadata_size(), metadata_size);
+
+    std::thread write_thread([&]() {
+        for (uint32_t i = 0; i < num_frames; i++) {
+            int64_t seq;
+            while ((seq = writer.wait_for_space(100)) < 0) {
+            }
+            BOOST_REQUIRE(seq == i);
+            memset(writer.metadata(seq), i % 251, metadata_size);
+            memset(writer.frame(seq), (i + 1) % 251, frame_size);
+            writer.publish();
+        }
+        writer.close_writer();
+    });
+
+    uint32_t num_read = 0;
+    bool frames_ok = true;
+    while (true) {
+        int64_t seq = reader.wait_for_data(100);
+        if (seq < 0) {
+            if (reader.writer_closed() && reader.num_full() == 0)
+                break;
+            continue;
+        }
+        BOOST_REQUIRE(seq == num_read);
+        std::vector<uint8_t> metadata(reader.metadata(seq), reader.metadata(seq) + metadata_size);
+        std::vector<uint8_t> frame(reader.frame(seq), reader.frame(seq) + frame_size);
+        reader.release();
+
+        frames_ok &= metadata == std::vector<uint8_t>(metadata_size, num_read % 251);
+        frames_ok &= frame == std::vector<uint8_t>(frame_size, (num_read + 1) % 251);
+        num_read++;
+    }
+    write_thread.join();
+
+    BOOST_CHECK(frames_ok);
+    BOOST_CHECK_EQUAL(num_read, num_frames);
+}
+
+/*
+ * A full ring times out, and frees up once the reader releases a frame.
+ */
+BOOST_AUTO_TEST_CASE(full) {
+    const std::string name = ring_name("full");
+    BufferShmRing writer(name, 2, 100, 0);
+    BufferShmRing reader(name);
+
+    BOOST_CHECK_EQUAL(reader.wait_for_data(10), -1);
+    for (int i = 0; i < 2; i++) {
+        BOOST_CHECK_EQUAL(writer.wait_for_space(10), i);
+        writer.publish();
+    }
+    BOOST_CHECK_EQUAL(writer.wait_for_space(10), -1);
+    BOOST_CHECK_EQUAL(reader.num_full(), 2);
+
+    BOOST_CHECK_EQUAL(reader.wait_for_data(10), 0);
+    reader.release();
+    BOOST_CHECK_EQUAL(writer.wait_for_space(10), 2);
+}
+
+/*
+ * A reader can hold on to frames, and the writer only gets their slots back once released.
+ */
+BOOST_AUTO_TEST_CASE(hold) {
+    const std::string name = ring_name("hold");
+    BufferShmRing writer(name, 2, 100, 0);
+    BufferShmRing reader(name);
+
+    for (int i = 0; i < 2; i++) {
+        BOOST_CHECK_EQUAL(writer.wait_for_space(10), i);
+        writer.publish();
+    }
+    BOOST_CHECK_EQUAL(reader.wait_for_data(10, 0), 0);
+    BOOST_CHECK_EQUAL(reader.wait_for_data(10, 1), 1);
+    BOOST_CHECK_EQUAL(reader.wait_for_data(10, 2), -1);
+    BOOST_CHECK_EQUAL(writer.wait_for_space(10), -1);
+
+    // The held frames are still full, their slots go back oldest first
+    BOOST_CHECK_EQUAL(reader.num_full(), 2);
+    reader.release();
+    BOOST_CHECK_EQUAL(writer.wait_for_space(10), 2);
+    writer.publish();
+    BOOST_CHECK_EQUAL(reader.wait_for_data(10, 1), 2);
+    BOOST_CHECK_EQUAL(reader.num_full(), 2);
+}
+
+/*
+ * Attaching fails without a ring, and a reader notices when a new writer replaces the ring.
+ */
+BOOST_AUTO_TEST_CASE(attach) {
+    const std::string name = ring_name("attach");
+    BOOST_CHECK_THROW(BufferShmRing reader(name), std::runtime_error);
+
+    auto writer = std::make_unique<BufferShmRing>(name, 2, 100, 0);
+    BufferShmRing reader(name);
+    BOOST_CHECK(!reader.replaced());
+    BOOST_CHECK(!reader.writer_closed());
+
+    writer = std::make_unique<BufferShmRing>(name, 2, 100, 0);
+    BOOST_CHECK(reader.replaced());
+
+    writer.reset();
+    BOOST_CHECK(reader.replaced());
+    BOOST_CHECK_THROW(BufferShmRing reader2(name), std::runtime_error);
+}
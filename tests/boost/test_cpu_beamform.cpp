@@ -0,0 +1,410 @@
+#define BOOST_TEST_MODULE "test_cpuBeamformUpchan"
+
+#include "Config.hpp"               // for Config
+#include "bufferContainer.hpp"      // for bufferContainer
+#include "cpuBeamformHFBSum.hpp"    // for cpuBeamformHFBSum
+#include "cpuBeamformReorder.hpp"   // for cpuBeamformReorder
+#include "cpuBeamformUpchan.hpp"    // for cpuBeamformUpchan
+#include "cpuBeamformUpchanHFB.hpp" // for cpuBeamformUpchanHFB
+#include "cpuDeviceInterface.hpp"   // for cpuDeviceInterface, cpuEvent
+#include "util.h"                   // for e_time
+
+#include "fmt.hpp"  // for format, fmt
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json, basic_json<>::v...
+
+#include <algorithm>                         // for shuffle
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <cmath>                             // for cos, sin, fabs
+#include <numeric>                           // for iota
+#include <random>                            // for mt19937, uniform_int_distribution
+#include <stdint.h>                          // for int32_t, uint8_t, uint32_t
+#include <string.h>                          // for memcpy
+#include <vector>                            // for vector
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+#define SWAP(a, b)                                                                                 \
+    tempr = (a);                                                                                   \
+    (a) = (b);                                                                                     \
+    (b) = tempr
+
+// The N-S FFT of gpuBeamformSimulate::cpu_beamform_ns
+void beamform_ns(double* data, uint64_t transform_length) {
+    uint64_t n, m, j, i;
+    double wr, wi, theta;
+    double tempr, tempi;
+    n = transform_length << 1;
+    j = 1;
+    for (i = 1; i < n; i += 2) {
+        if (j > i) {
+            SWAP(data[j - 1], data[i - 1]);
+            SWAP(data[j], data[i]);
+        }
+        m = transform_length;
+        while (m >= 2 && j > m) {
+            j -= m;
+            m >>= 1;
+        }
+        j += m;
+    }
+    for (uint64_t step_size = 1; step_size <= transform_length / 2; step_size += step_size) {
+        theta = -3.141592654 / (step_size);
+        for (uint64_t index = 0; index < transform_length; index += step_size * 2) {
+            for (uint32_t minor_index = 0; minor_index < step_size; minor_index++) {
+                wr = cos(minor_index * theta);
+                wi = sin(minor_index * theta);
+                int first_index = (index + minor_index) * 2;
+                int second_index = first_index + step_size * 2;
+                tempr = wr * data[second_index] - wi * data[second_index + 1];
+                tempi = wi * data[second_index] + wr * data[second_index + 1];
+                data[second_index] = data[first_index] - tempr;
+                data[second_index + 1] = data[first_index + 1] - tempi;
+                data[first_index] += tempr;
+                data[first_index + 1] += tempi;
+            }
+        }
+    }
+}
+
+// The upchannelisation FFT of gpuBeamformSimulate::upchannelize
+void upchannelize(double* data, int nn) {
+    unsigned long n, mmax, m, j, istep, i;
+    double wtemp, wr, wpr, wpi, wi, theta;
+    double tempr, tempi;
+    n = nn << 1;
+    j = 1;
+    for (i = 1; i < n; i += 2) {
+        if (j > i) {
+            SWAP(data[j - 1], data[i - 1]);
+            SWAP(data[j], data[i]);
+        }
+        m = nn;
+        while (m >= 2 && j > m) {
+            j -= m;
+            m >>= 1;
+        }
+        j += m;
+    }
+    mmax = 2;
+    while (n > mmax) {
+        istep = mmax << 1;
+        theta = (6.28318530717959 / mmax);
+        wtemp = sin(0.5 * theta);
+        wpr = -2.0 * wtemp * wtemp;
+        wpi = sin(theta);
+        wr = 1.0;
+        wi = 0.0;
+        for (m = 1; m < mmax; m += 2) {
+            for (i = m; i <= n; i += istep) {
+                j = i + mmax;
+                tempr = wr * data[j - 1] - wi * data[j];
+                tempi = wr * data[j] + wi * data[j - 1];
+                data[j - 1] = data[i - 1] - tempr;
+                data[j] = data[i] - tempi;
+                data[i - 1] += tempr;
+                data[i] += tempi;
+            }
+            wr = (wtemp = wr) * wpr - wi * wpi + wr;
+            wi = wi * wpr + wtemp * wpi + wi;
+        }
+        mmax = istep;
+    }
+}
+
+struct frb_params {
+    int num_samples, factor_upchan, downsample_time, downsample_freq;
+};
+
+struct frb_data {
+    std::vector<uint8_t> input;
+    std::vector<int32_t> reorder_map;
+    std::vector<uint32_t> map;
+    std::vector<float> coeff, gain;
+    std::vector<uint32_t> lost_samples;
+};
+
+// The FRB and summed hyper fine beams of gpuBeamformSimulate, generalised to any upchannelisation
+// and with the lost samples of hsaBeamformHFBSum
+void simulate(const frb_params& c, const frb_data& d, std::vector<float>& frb,
+              std::vector<float>& hfb) {
+    const int U = c.factor_upchan, nsamp = c.num_samples;
+    const int nsamp_out = nsamp / U / c.downsample_time;
+
+    std::vector<double> padded(nsamp * 2048 * 2 * 2);
+    for (int j = 0; j < nsamp; j++) {
+        for (int e = 0; e < 2048; e++) {
+            const uint8_t x = d.input[j * 2048 + d.reorder_map[e / 4] * 4 + e % 4];
+            const double xr = ((x >> 4) & 0x0f) - 8;
+            const double xi = (x & 0x0f) - 8;
+            const int i = e % 256;
+            double* out = &padded[((j * 8 + e / 256) * 512 + i) * 2];
+            out[0] = xr * d.gain[e * 2] + xi * d.gain[e * 2 + 1];
+            out[1] = xi * d.gain[e * 2] - xr * d.gain[e * 2 + 1];
+        }
+        for (int k = 0; k < 8; k++)
+            beamform_ns(&padded[(j * 8 + k) * 512 * 2], 512);
+    }
+
+    // Clamp with the N-S flip, and form the E-W beams; [beam][time]
+    std::vector<double> beams(2048 * nsamp * 2);
+    for (int j = 0; j < nsamp; j++) {
+        std::vector<double> clamped(2048 * 2);
+        for (int b = 0; b < 256; b++) {
+            for (int k = 0; k < 8; k++) {
+                clamped[(k * 256 + 255 - b) * 2] = padded[((j * 8 + k) * 512 + d.map[b]) * 2];
+                clamped[(k * 256 + 255 - b) * 2 + 1] =
+                    padded[((j * 8 + k) * 512 + d.map[b]) * 2 + 1];
+            }
+        }
+        for (int p = 0; p < 2; p++) {
+            for (int ew = 0; ew < 4; ew++) {
+                for (int ns = 0; ns < 256; ns++) {
+                    double re = 0, im = 0;
+                    for (int elm = 0; elm < 4; elm++) {
+                        const double* in = &clamped[(p * 1024 + elm * 256 + ns) * 2];
+                        re += in[0] * d.coeff[2 * (ew * 4 + elm)]
+                              + in[1] * d.coeff[2 * (ew * 4 + elm) + 1];
+                        im += in[0] * d.coeff[2 * (ew * 4 + elm) + 1]
+                              - in[1] * d.coeff[2 * (ew * 4 + elm)];
+                    }
+                    const int b = p * 1024 + ew * 256 + ns;
+                    beams[(b * nsamp + j) * 2] = re / 4.;
+                    beams[(b * nsamp + j) * 2 + 1] = im / 4.;
+                }
+            }
+        }
+    }
+    for (int b = 0; b < 2048; b++)
+        for (int n = 0; n < nsamp / U; n++)
+            upchannelize(&beams[(b * nsamp + n * U) * 2], U);
+
+    frb.assign(1024 * nsamp_out * 16, 0.f);
+    hfb.assign(1024 * U, 0.f);
+    const float BP[16]{0.52225748, 0.58330915, 0.6868705,  0.80121821, 0.89386546, 0.95477358,
+                       0.98662733, 0.99942558, 0.99988676, 0.98905127, 0.95874124, 0.90094667,
+                       0.81113021, 0.6999944,  0.59367968, 0.52614263};
+    const double norm = 2 * c.downsample_time * c.downsample_freq;
+    for (int b = 0; b < 1024; b++) {
+        for (int f = 0; f < U; f++) {
+            float total_sum = 0.0;
+            for (int t = 0; t < nsamp_out; t++) {
+                float out_sq = 0.f;
+                for (int pp = 0; pp < 2; pp++) {
+                    for (int tt = 0; tt < c.downsample_time; tt++) {
+                        const double* x =
+                            &beams[((pp * 1024 + b) * nsamp + (t * c.downsample_time + tt) * U + f)
+                                   * 2];
+                        float tmp_real = x[0], tmp_imag = x[1];
+                        out_sq += tmp_real * tmp_real + tmp_imag * tmp_imag;
+                    }
+                }
+                if (!d.lost_samples[t])
+                    total_sum += out_sq / (float)(2 * c.downsample_time);
+            }
+            hfb[b * U + (f + U / 2) % U] = total_sum;
+        }
+
+        for (int t = 0; t < nsamp_out; t++) {
+            for (int f = 0; f < 16; f++) {
+                float out_sq = 0.0;
+                for (int pp = 0; pp < 2; pp++) {
+                    for (int tt = 0; tt < c.downsample_time; tt++) {
+                        for (int ff = 0; ff < c.downsample_freq; ff++) {
+                            const double* x =
+                                &beams[((pp * 1024 + b) * nsamp + (t * c.downsample_time + tt) * U
+                                        + f * c.downsample_freq + ff)
+                                       * 2];
+                            float tmp_real = x[0], tmp_imag = x[1];
+                            out_sq += tmp_real * tmp_real + tmp_imag * tmp_imag;
+                        }
+                    }
+                }
+                frb[b * nsamp_out * 16 + t * 16 + (f + 8) % 16] =
+                    out_sq / norm / BP[int((f + 8) % 16)];
+            }
+        }
+    }
+}
+
+frb_data random_data(const frb_params& c, int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<uint32_t> fft_beam(0, 511);
+    std::uniform_real_distribution<float> real(-2, 2);
+    frb_data d;
+    d.input.resize(c.num_samples * 2048);
+    for (auto& x : d.input)
+        x = byte(gen);
+    d.reorder_map.resize(512);
+    std::iota(d.reorder_map.begin(), d.reorder_map.end(), 0);
+    std::shuffle(d.reorder_map.begin(), d.reorder_map.end(), gen);
+    for (int b = 0; b < 256; b++)
+        d.map.push_back(fft_beam(gen));
+    for (int i = 0; i < 16; i++) {
+        double phase = real(gen);
+        d.coeff.push_back(cos(phase));
+        d.coeff.push_back(sin(phase));
+    }
+    for (int i = 0; i < 2 * 2048; i++)
+        d.gain.push_back(real(gen));
+    d.lost_samples.assign(c.num_samples / c.factor_upchan / c.downsample_time, 0);
+    return d;
+}
+
+struct frb_beamformer {
+    frb_beamformer(const frb_params& c, const std::vector<int32_t>& reorder_map, bool hfb,
+                   int num_threads) :
+        c(c),
+        hfb(hfb) {
+        nlohmann::json json_config = {{"log_level", "warn"},
+                                      {"buffer_depth", 2},
+                                      {"num_elements", 2048},
+                                      {"num_local_freq", 1},
+                                      {"samples_per_data_set", c.num_samples},
+                                      {"factor_upchan", c.factor_upchan},
+                                      {"downsample_time", c.downsample_time},
+                                      {"downsample_freq", c.downsample_freq},
+                                      {"num_frb_total_beams", 1024},
+                                      {"reorder_map", reorder_map}};
+        config.update_config(json_config);
+
+        device = new cpuDeviceInterface(config, 0, 2, num_threads);
+        reorder = new cpuBeamformReorder(config, "/gpu/reorder", buffers, *device);
+        if (hfb) {
+            upchan = new cpuBeamformUpchanHFB(config, "/gpu/upchan", buffers, *device);
+            sum = new cpuBeamformHFBSum(config, "/gpu/sum", buffers, *device);
+        } else {
+            upchan = new cpuBeamformUpchan(config, "/gpu/upchan", buffers, *device);
+            sum = nullptr;
+        }
+        num_samples_out = c.num_samples / c.factor_upchan / c.downsample_time;
+    }
+
+    ~frb_beamformer() {
+        delete sum;
+        delete upchan;
+        delete reorder;
+        delete device;
+    }
+
+    template<typename T>
+    T* memory(const std::string& name, int gpu_frame_id, size_t len) {
+        return (T*)device->get_gpu_memory_array(name, gpu_frame_id, len * sizeof(T));
+    }
+
+    template<typename T>
+    void set(const std::string& name, int gpu_frame_id, const std::vector<T>& data) {
+        memcpy(memory<T>(name, gpu_frame_id, data.size()), data.data(), data.size() * sizeof(T));
+    }
+
+    // Runs the commands on a frame, returning the FRB and summed hyper fine beams
+    void run(const frb_data& d, int gpu_frame_id, std::vector<float>& frb,
+             std::vector<float>& hfb_sum) {
+        set("input", gpu_frame_id, d.input);
+        set("beamform_map", gpu_frame_id, d.map);
+        set("beamform_coeff_map", gpu_frame_id, d.coeff);
+        set("beamform_gain", gpu_frame_id, d.gain);
+        if (hfb)
+            set("hfb_compressed_lost_samples", gpu_frame_id, d.lost_samples);
+
+        cpuEvent event = reorder->execute(gpu_frame_id, cpuEvent());
+        event = upchan->execute(gpu_frame_id, event);
+        if (hfb)
+            event = sum->execute(gpu_frame_id, event);
+        event->done.wait();
+
+        float* out = memory<float>("bf_output", gpu_frame_id, 1024 * num_samples_out * 16);
+        frb.assign(out, out + 1024 * num_samples_out * 16);
+        if (hfb) {
+            out = memory<float>("hfb_sum_output", gpu_frame_id, 1024 * c.factor_upchan);
+            hfb_sum.assign(out, out + 1024 * c.factor_upchan);
+        }
+    }
+
+    frb_params c;
+    bool hfb;
+    size_t num_samples_out;
+    Config config;
+    bufferContainer buffers;
+    cpuDeviceInterface* device;
+    cpuBeamformReorder* reorder;
+    cpuBeamformUpchan* upchan;
+    cpuBeamformHFBSum* sum;
+};
+
+// Checks for bit-exactness, and reports the largest relative difference otherwise
+void check_equal(const std::vector<float>& output, const std::vector<float>& expected,
+                 const std::string& name) {
+    BOOST_REQUIRE_EQUAL(output.size(), expected.size());
+    size_t num_diff = 0;
+    double max_diff = 0;
+    for (size_t i = 0; i < output.size(); i++) {
+        if (output[i] != expected[i]) {
+            num_diff++;
+            max_diff = std::max(max_diff, fabs(output[i] - expected[i]) / fabs(expected[i]));
+        }
+    }
+    BOOST_CHECK_MESSAGE(num_diff == 0, fmt::format(fmt("{:s}: {:d} values differ, by up to {:g}"),
+                                                   name, num_diff, max_diff));
+}
+
+BOOST_AUTO_TEST_CASE(bit_exact) {
+    // samples, upchannelisation, downsample time and freq, HFB, threads
+    const std::vector<std::vector<int>> cases = {
+        {768, 128, 3, 8, 1, 2},
+        {384, 128, 3, 8, 1, 1},
+        {256, 32, 2, 2, 0, 3},
+        {320, 16, 5, 1, 0, 4},
+    };
+
+    for (auto& v : cases) {
+        frb_params c = {v[0], v[1], v[2], v[3]};
+        BOOST_TEST_MESSAGE(fmt::format(fmt("{:d} samples, upchannelise {:d}, downsample {:d} x "
+                                           "{:d}, HFB {:d}, {:d} threads"),
+                                       v[0], v[1], v[2], v[3], v[4], v[5]));
+        frb_data d = random_data(c, 42);
+        if (d.lost_samples.size() > 1)
+            d.lost_samples[1] = 1;
+        std::vector<float> frb_expected, hfb_expected;
+        simulate(c, d, frb_expected, hfb_expected);
+
+        frb_beamformer bf(c, d.reorder_map, v[4], v[5]);
+        for (int gpu_frame_id = 0; gpu_frame_id < 2; gpu_frame_id++) {
+            std::vector<float> frb, hfb;
+            bf.run(d, gpu_frame_id, frb, hfb);
+            check_equal(frb, frb_expected, "FRB beams");
+            if (v[4])
+                check_equal(hfb, hfb_expected, "hyper fine beams");
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bad_geometry) {
+    frb_params c = {768, 128, 3, 4};
+    BOOST_CHECK_THROW(frb_beamformer(c, std::vector<int32_t>(512), false, 1),
+                      std::runtime_error);
+    c = {700, 128, 3, 8};
+    BOOST_CHECK_THROW(frb_beamformer(c, std::vector<int32_t>(512), false, 1),
+                      std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark) {
+    frb_params c = {128 * 3 * 16, 128, 3, 8};
+    frb_data d = random_data(c, 1);
+    frb_beamformer bf(c, d.reorder_map, true, 0);
+
+    std::vector<float> frb, hfb;
+    bf.run(d, 0, frb, hfb);
+    double start = e_time();
+    const int num_runs = 3;
+    for (int i = 0; i < num_runs; i++)
+        bf.run(d, i % 2, frb, hfb);
+    double time = (e_time() - start) / num_runs;
+
+    // A CHIME sample is 2.56 us
+    BOOST_TEST_MESSAGE(fmt::format(fmt("{:d} samples on {:d} threads: {:.3f} s, {:.2f} x real "
+                                       "time"),
+                                   c.num_samples, bf.device->get_num_threads(), time,
+                                   c.num_samples * 2.56e-6 / time));
+}
@@ -0,0 +1,228 @@
+#define BOOST_TEST_MODULE "test_cpuCorrelatorKernel"
+
+#include "Config.hpp"              // for Config
+#include "bufferContainer.hpp"     // for bufferContainer
+#include "cpuCorrelatorKernel.hpp" // for cpuCorrelatorKernel
+#include "cpuDeviceInterface.hpp"  // for cpuDeviceInterface, cpuEvent
+#include "util.h"                  // for e_time
+
+#include "fmt.hpp"  // for format, fmt
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json, basic_json<>::v...
+
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <random>                            // for mt19937, uniform_int_distribution
+#include <stdint.h>                          // for int32_t, uint8_t, uint32_t
+#include <string.h>                          // for memcpy, memset
+#include <vector>                            // for vector
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+// The "4+4b" correlator of gpuSimulate
+std::vector<int32_t> simulate(const std::vector<uint8_t>& input, int num_elements,
+                              int num_local_freq, int num_samples, int block_size) {
+    int num_blocks = (num_elements / block_size) * (num_elements / block_size + 1) / 2;
+    std::vector<uint32_t> block_map(2 * num_blocks);
+    int block_id = 0;
+    for (int y = 0; block_id < num_blocks; y++) {
+        for (int x = y; x < num_elements / block_size; x++) {
+            block_map[2 * block_id + 0] = x;
+            block_map[2 * block_id + 1] = y;
+            block_id++;
+        }
+    }
+
+    std::vector<int32_t> output(num_local_freq * num_blocks * block_size * block_size * 2);
+    for (int f = 0; f < num_local_freq; ++f) {
+        for (int b = 0; b < num_blocks; ++b) {
+            for (int y = 0; y < block_size; ++y) {
+                for (int x = 0; x < block_size; ++x) {
+                    int real = 0;
+                    int imag = 0;
+                    for (int t = 0; t < num_samples; ++t) {
+                        int ix = (t * num_local_freq + f) * num_elements
+                                 + block_map[2 * b + 0] * block_size + x;
+                        int xi = (input[ix] & 0x0f) - 8;
+                        int xr = ((input[ix] & 0xf0) >> 4) - 8;
+                        int iy = (t * num_local_freq + f) * num_elements
+                                 + block_map[2 * b + 1] * block_size + y;
+                        int yi = (input[iy] & 0x0f) - 8;
+                        int yr = ((input[iy] & 0xf0) >> 4) - 8;
+                        real += xr * yr + xi * yi;
+                        imag += xi * yr - yi * xr;
+                    }
+                    output[(f * num_blocks + b) * block_size * block_size * 2 + x * 2
+                           + y * block_size * 2 + 0] = imag;
+                    output[(f * num_blocks + b) * block_size * block_size * 2 + x * 2
+                           + y * block_size * 2 + 1] = real;
+                }
+            }
+        }
+    }
+    return output;
+}
+
+struct correlator {
+    correlator(int num_elements, int num_local_freq, int num_samples, int block_size,
+               int num_sub_frames, int num_threads, bool specialise = true) :
+        num_elements(num_elements),
+        num_local_freq(num_local_freq),
+        num_samples(num_samples),
+        block_size(block_size),
+        num_sub_frames(num_sub_frames) {
+        nlohmann::json json_config = {{"log_level", "warn"},
+                                      {"buffer_depth", 2},
+                                      {"num_elements", num_elements},
+                                      {"num_local_freq", num_local_freq},
+                                      {"samples_per_data_set", num_samples},
+                                      {"block_size", block_size},
+                                      {"num_sub_frames", num_sub_frames},
+                                      {"use_specialised_kernel", specialise}};
+        for (int i = 0; i < num_sub_frames; i++)
+            json_config["gpu"][fmt::format(fmt("corr_{:d}"), i)]["sub_frame_index"] = i;
+        config.update_config(json_config);
+
+        device = new cpuDeviceInterface(config, 0, 2, num_threads);
+        for (int i = 0; i < num_sub_frames; i++)
+            kernels.push_back(new cpuCorrelatorKernel(
+                config, fmt::format(fmt("/gpu/corr_{:d}"), i), buffers, *device));
+
+        int num_blocks = (num_elements / block_size) * (num_elements / block_size + 1) / 2;
+        corr_len = num_local_freq * num_blocks * block_size * block_size * 2;
+    }
+
+    ~correlator() {
+        for (auto k : kernels)
+            delete k;
+        delete device;
+    }
+
+    // Runs the kernels of all sub-frames on a frame, and returns the output of each
+    std::vector<std::vector<int32_t>> run(const std::vector<uint8_t>& input, int gpu_frame_id) {
+        memcpy(device->get_gpu_memory_array("input", gpu_frame_id, input.size()), input.data(),
+               input.size());
+        cpuEvent event;
+        for (int i = 0; i < num_sub_frames; i++) {
+            memset(corr(i, gpu_frame_id), 0, corr_len * sizeof(int32_t));
+            event = kernels[i]->execute(gpu_frame_id, event);
+        }
+        event->done.wait();
+
+        std::vector<std::vector<int32_t>> output;
+        for (int i = 0; i < num_sub_frames; i++)
+            output.emplace_back(corr(i, gpu_frame_id), corr(i, gpu_frame_id) + corr_len);
+        return output;
+    }
+
+    int32_t* corr(int sub_frame, int gpu_frame_id) {
+        return (int32_t*)device->get_gpu_memory_array(fmt::format(fmt("corr_{:d}"), sub_frame),
+                                                      gpu_frame_id, corr_len * sizeof(int32_t));
+    }
+
+    int num_elements, num_local_freq, num_samples, block_size, num_sub_frames;
+    size_t corr_len;
+    Config config;
+    bufferContainer buffers;
+    cpuDeviceInterface* device;
+    std::vector<cpuCorrelatorKernel*> kernels;
+};
+
+std::vector<uint8_t> random_input(size_t len) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> input(len);
+    for (auto& x : input)
+        x = dist(gen);
+    return input;
+}
+
+BOOST_AUTO_TEST_CASE(bit_exact) {
+    // elements, frequencies, samples, block size, sub-frames, threads
+    const std::vector<std::vector<int>> cases = {
+        {32, 1, 64, 32, 1, 1},  {64, 1, 1000, 16, 1, 2}, {64, 2, 96, 32, 1, 3},
+        {128, 1, 2048, 32, 4, 4}, {16, 3, 24, 8, 2, 2},
+    };
+
+    for (auto& c : cases) {
+        BOOST_TEST_MESSAGE(fmt::format(fmt("{:d} elements, {:d} freq, {:d} samples, block {:d}, "
+                                           "{:d} sub-frames, {:d} threads"),
+                                       c[0], c[1], c[2], c[3], c[4], c[5]));
+        correlator corr(c[0], c[1], c[2], c[3], c[4], c[5]);
+        auto input = random_input(c[0] * c[1] * c[2]);
+
+        for (int gpu_frame_id = 0; gpu_frame_id < 2; gpu_frame_id++) {
+            auto output = corr.run(input, gpu_frame_id);
+            for (int i = 0; i < c[4]; i++) {
+                size_t sub_frame_len = c[0] * c[1] * (c[2] / c[4]);
+                std::vector<uint8_t> sub_frame(input.begin() + i * sub_frame_len,
+                                               input.begin() + (i + 1) * sub_frame_len);
+                auto expected = simulate(sub_frame, c[0], c[1], c[2] / c[4], c[3]);
+                BOOST_CHECK(output[i] == expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(offset_encoding) {
+    // 0x99 is 1 + 1i, 0x88 is zero
+    correlator corr(64, 1, 256, 32, 1, 2);
+    std::vector<uint8_t> input(64 * 256, 0x99);
+    for (int t = 0; t < 256; t++)
+        input[t * 64 + 63] = 0x88;
+
+    auto output = corr.run(input, 0)[0];
+    for (int b = 0; b < 3; b++) {
+        for (int y = 0; y < 32; y++) {
+            for (int x = 0; x < 32; x++) {
+                bool zero = (b == 1 && x == 31) || (b == 2 && (x == 31 || y == 31));
+                int32_t* v = &output[((b * 32 + y) * 32 + x) * 2];
+                BOOST_CHECK_EQUAL(v[0], 0);
+                BOOST_CHECK_EQUAL(v[1], zero ? 0 : 2 * 256);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(specialised_kernels) {
+    // The geometries with a specialised kernel, with whole and partial chunks of samples:
+    // elements, frequencies, samples, block size, threads
+    const std::vector<std::vector<int>> cases = {
+        {256, 1, 1100, 32, 2}, {2048, 1, 520, 32, 4}, {96, 2, 600, 32, 2}, {64, 1, 1024, 32, 1},
+    };
+
+    for (auto& c : cases) {
+        BOOST_TEST_MESSAGE(fmt::format(fmt("{:d} elements, {:d} freq, {:d} samples, block {:d}"),
+                                       c[0], c[1], c[2], c[3]));
+        auto input = random_input(c[0] * c[1] * c[2]);
+        correlator specialised(c[0], c[1], c[2], c[3], 1, c[4], true);
+        correlator generic(c[0], c[1], c[2], c[3], 1, c[4], false);
+        auto output = specialised.run(input, 0)[0];
+        BOOST_CHECK(output == generic.run(input, 0)[0]);
+        if (c[0] <= 256)
+            BOOST_CHECK(output == simulate(input, c[0], c[1], c[2], c[3]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(benchmark) {
+    const int num_elements = 256, num_samples = 8192, block_size = 32;
+    auto input = random_input(num_elements * num_samples);
+    for (bool specialise : {false, true}) {
+        correlator corr(num_elements, 1, num_samples, block_size, 1, 0, specialise);
+
+        corr.run(input, 0);
+        double start = e_time();
+        const int num_runs = 3;
+        for (int i = 0; i < num_runs; i++)
+            corr.run(input, i % 2);
+        double time = (e_time() - start) / num_runs;
+
+        // A complex multiply and add is 8 operations
+        int num_blocks = (num_elements / block_size) * (num_elements / block_size + 1) / 2;
+        double flop = 8.0 * num_blocks * block_size * block_size * num_samples;
+        BOOST_TEST_MESSAGE(fmt::format(fmt("{:s} kernel, {:d} elements, {:d} samples on {:d} "
+                                           "threads: {:.3f} s, {:.2f} GFLOP/s"),
+                                       specialise ? "specialised" : "generic", num_elements,
+                                       num_samples, corr.device->get_num_threads(), time,
+                                       flop / time / 1e9));
+    }
+}
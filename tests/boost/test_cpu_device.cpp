@@ -0,0 +1,93 @@
+#define BOOST_TEST_MODULE "test_cpuDeviceInterface"
+
+#include "Config.hpp"             // for Config
+#include "cpuDeviceInterface.hpp" // for cpuEvent, cpuDeviceInterface, CPU_COMPUTE_STREAM, CPU_...
+
+#include <atomic>                            // for atomic
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <chrono>                            // for milliseconds
+#include <mutex>                             // for mutex, lock_guard
+#include <stddef.h>                          // for size_t
+#include <stdint.h>                          // for uint8_t, uintptr_t
+#include <thread>                            // for sleep_for
+#include <vector>                            // for vector
+
+using kotekan::Config;
+
+BOOST_AUTO_TEST_CASE(stream_order) {
+    Config config;
+    cpuDeviceInterface device(config, 0, 2, 4);
+
+    std::mutex mtx;
+    std::vector<int> order;
+    auto log = [&](int i) {
+        std::lock_guard<std::mutex> lock(mtx);
+        order.push_back(i);
+    };
+
+    // The slow copy in has to finish before the kernel and the copy out waiting for it
+    cpuEvent in = device.enqueue(CPU_INPUT_STREAM, nullptr, [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        log(0);
+    });
+    cpuEvent kernel = device.enqueue(CPU_COMPUTE_STREAM, in, [&]() { log(1); });
+    cpuEvent out = device.enqueue(CPU_OUTPUT_STREAM, kernel, [&]() { log(2); });
+    // Work without a dependency doesn't wait for the other streams
+    cpuEvent other = device.enqueue(CPU_OUTPUT_STREAM, nullptr, [&]() { log(3); });
+
+    out->done.wait();
+    other->done.wait();
+    BOOST_CHECK(order == std::vector<int>({0, 1, 2, 3}));
+    BOOST_CHECK(in->end_time <= kernel->start_time);
+    BOOST_CHECK(kernel->end_time <= out->start_time);
+    BOOST_CHECK(in->end_time - in->start_time >= 0.09);
+}
+
+BOOST_AUTO_TEST_CASE(copies) {
+    Config config;
+    cpuDeviceInterface device(config, 0, 2, 1);
+
+    std::vector<uint8_t> host_in(1024), host_out(1024, 0);
+    for (size_t i = 0; i < host_in.size(); i++)
+        host_in[i] = i % 251;
+
+    uint8_t* gpu_mem = (uint8_t*)device.get_gpu_memory_array("test", 1, 1024);
+    BOOST_CHECK_EQUAL((uintptr_t)gpu_mem % 64, 0);
+
+    cpuEvent e = device.async_copy_host_to_gpu(gpu_mem, host_in.data(), 1024, nullptr);
+    e = device.enqueue(CPU_COMPUTE_STREAM, e, [=]() {
+        for (size_t i = 0; i < 1024; i++)
+            gpu_mem[i] += 1;
+    });
+    e = device.async_copy_gpu_to_host(host_out.data(), gpu_mem, 1024, e);
+    e->done.wait();
+
+    for (size_t i = 0; i < host_in.size(); i++)
+        BOOST_CHECK_EQUAL(host_out[i], host_in[i] + 1);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for) {
+    Config config;
+    cpuDeviceInterface device(config, 0, 2, 4);
+    BOOST_CHECK_EQUAL(device.get_num_threads(), 4);
+
+    // Each item is done exactly once, also for several jobs in a row and from two streams
+    const size_t n = 1000;
+    std::vector<std::atomic<int>> count(n);
+    for (auto& c : count)
+        c = 0;
+    auto job = [&]() {
+        for (int j = 0; j < 10; j++)
+            device.parallel_for(n, [&](size_t i) { count[i]++; });
+    };
+    cpuEvent a = device.enqueue(CPU_COMPUTE_STREAM, nullptr, job);
+    cpuEvent b = device.enqueue(CPU_INPUT_STREAM, nullptr, job);
+    a->done.wait();
+    b->done.wait();
+
+    for (size_t i = 0; i < n; i++)
+        BOOST_CHECK_EQUAL(count[i], 20);
+
+    // Nothing to do
+    device.parallel_for(0, [&](size_t) { BOOST_CHECK(false); });
+}
@@ -0,0 +1,379 @@
+#define BOOST_TEST_MODULE "test_cpuRfi"
+
+#include "Config.hpp"             // for Config
+#include "buffer.h"               // for create_buffer, mark_frame_full, register_producer
+#include "bufferContainer.hpp"    // for bufferContainer
+#include "chimeMetadata.hpp"      // for chimeMetadata, get_rfi_zeroed, set_rfi_num_bad_inputs
+#include "configUpdater.hpp"      // for configUpdater
+#include "cpuDeviceInterface.hpp" // for cpuDeviceInterface, cpuEvent
+#include "cpuRfiBadInput.hpp"     // for cpuRfiBadInput
+#include "cpuRfiInputSum.hpp"     // for cpuRfiInputSum
+#include "cpuRfiTimeSum.hpp"      // for cpuRfiTimeSum
+#include "cpuRfiZeroData.hpp"     // for cpuRfiZeroData
+#include "metadata.h"             // for create_metadata_pool, delete_metadata_pool
+
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json, basic_json<>::v...
+
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <algorithm>                         // for max, min
+#include <math.h>                            // for sqrt, lroundf
+#include <random>                            // for mt19937, normal_distribution
+#include <stdint.h>                          // for uint32_t, uint8_t
+#include <string.h>                          // for memcmp, memcpy
+#include <vector>                            // for vector
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+using kotekan::configUpdater;
+
+// The work items of the CHIME RFI kernels, for one frequency, as in the OpenCL sources. The
+// tests are built with -ffp-contract=off, like the engine.
+struct rfi_kernels {
+    uint32_t num_elements, num_samples, sk_step;
+    std::vector<float> time_sum, time_sum_var, sk, sk_var, bad_input;
+    std::vector<uint8_t> sk_mask;
+
+    rfi_kernels(uint32_t num_elements, uint32_t num_samples, uint32_t sk_step) :
+        num_elements(num_elements),
+        num_samples(num_samples),
+        sk_step(sk_step),
+        time_sum(num_elements * num_samples / sk_step),
+        time_sum_var(num_elements * num_samples / sk_step),
+        sk(num_samples / sk_step),
+        sk_var(num_samples / sk_step),
+        bad_input(num_elements),
+        sk_mask(num_samples / sk_step) {}
+
+    // rfi_chime_time_sum, on 4 elements at a time
+    void time_sum_kernel(const uint32_t* input) {
+        const uint32_t gx_size = num_elements / 4;
+        for (uint32_t gy = 0; gy < num_samples / sk_step; gy++) {
+            for (uint32_t gx = 0; gx < gx_size; gx++) {
+                uint32_t power_across_time[4] = {0}, sq_power_across_time[4] = {0};
+                for (uint32_t i = 0; i < sk_step; i++) {
+                    const uint32_t data = input[gx + gy * gx_size * sk_step + i * gx_size];
+                    uint32_t temp[4];
+                    temp[0] = ((data & 0x000000f0) << 12u) | ((data & 0x0000000f) >> 0u);
+                    temp[1] = ((data & 0x0000f000) << 4u) | ((data & 0x00000f00) >> 8u);
+                    temp[2] = ((data & 0x00f00000) >> 4u) | ((data & 0x000f0000) >> 16u);
+                    temp[3] = ((data & 0xf0000000) >> 12u) | ((data & 0x0f000000) >> 24u);
+                    for (int k = 0; k < 4; k++) {
+                        const uint32_t power = ((temp[k] >> 16) - 8) * ((temp[k] >> 16) - 8)
+                                               + ((temp[k] & 0x0000ffff) - 8)
+                                                     * ((temp[k] & 0x0000ffff) - 8);
+                        power_across_time[k] += power;
+                        sq_power_across_time[k] += power * power;
+                    }
+                }
+                for (int k = 0; k < 4; k++) {
+                    const float mean =
+                        (float)power_across_time[k] / (float)sk_step + (float)0.00000001;
+                    time_sum[4 * gx + gy * 4 * gx_size + k] =
+                        (float)sq_power_across_time[k] / (mean * mean);
+                    time_sum_var[4 * gx + gy * 4 * gx_size + k] = power_across_time[k];
+                }
+            }
+        }
+    }
+
+    // rfi_chime_input_sum, with a work group of 256
+    void input_sum_kernel(const std::vector<uint8_t>& input_mask, const uint32_t* lost_samples,
+                          uint32_t num_bad_inputs, uint32_t rfi_sigma_cut,
+                          bool trunc_bias_switch) {
+        const float bias_coeffs[10] = {-2.53769469e+00, 6.37923339e+00,  -6.75761413e+00,
+                                       3.93682451e+00,  -1.38702812e+00, 3.07645810e-01,
+                                       -4.33959965e-02, 3.78868082e-03,  -1.87073471e-04,
+                                       4.00089169e-06};
+        const uint32_t lx_size = 256;
+        for (uint32_t gz = 0; gz < num_samples / sk_step; gz++) {
+            float sq_power_across_input[256], var_across_input[256];
+            const uint32_t base_index = gz * num_elements;
+            for (uint32_t lx = 0; lx < lx_size; lx++) {
+                sq_power_across_input[lx] = input_mask[lx] * time_sum[base_index + lx];
+                var_across_input[lx] = input_mask[lx] * time_sum_var[base_index + lx];
+                for (uint32_t i = 1; i < num_elements / lx_size; i++) {
+                    sq_power_across_input[lx] +=
+                        input_mask[lx + i * lx_size] * time_sum[base_index + lx + i * lx_size];
+                    var_across_input[lx] += input_mask[lx + i * lx_size]
+                                            * time_sum_var[base_index + lx + i * lx_size];
+                }
+            }
+            for (uint32_t j = lx_size / 2; j > 0; j >>= 1) {
+                for (uint32_t lx = 0; lx < j; lx++) {
+                    sq_power_across_input[lx] += sq_power_across_input[lx + j];
+                    var_across_input[lx] += var_across_input[lx + j];
+                }
+            }
+
+            float n = (float)sk_step - lost_samples[gz];
+            float cf = n / sk_step;
+            float N = (float)(num_elements - num_bad_inputs);
+            if (n * N == 0) {
+                sk[gz] = -1.0;
+                sk_var[gz] = -1.0;
+                sk_mask[gz] = 1;
+                continue;
+            }
+            const float new_sq_power_across_input = sq_power_across_input[0] * cf * cf;
+            float SK = ((n + 1) / (n - 1)) * ((new_sq_power_across_input / (n * N)) - 1);
+            const float var = var_across_input[0] / (n * N);
+            if (trunc_bias_switch) {
+                const float rms = sqrt((double)var);
+                float sk_correction = 0.f;
+                float rms_pow = 1.f;
+                for (int i = 0; i < 10; i++) {
+                    sk_correction += bias_coeffs[i] * rms_pow;
+                    rms_pow *= rms;
+                }
+                SK -= sk_correction;
+            }
+            sk[gz] = SK;
+            float sigma = sqrt((double)((4 * n * n) / (N * (n - 1) * (n + 2) * (n + 3))));
+            if (SK > 1 + rfi_sigma_cut * sigma || SK < 1 - rfi_sigma_cut * sigma)
+                sk_mask[gz] = 1;
+            else
+                sk_mask[gz] = 0;
+            sk_var[gz] = var;
+        }
+    }
+
+    // rfi_bad_input
+    void bad_input_kernel() {
+        const uint32_t M = sk_step;
+        const uint32_t num_sk = num_samples / sk_step;
+        for (uint32_t gx = 0; gx < num_elements; gx++) {
+            float total_sk = 0;
+            for (uint32_t i = 0; i < num_sk; i++)
+                total_sk += (((float)M + 1) / ((float)M - 1))
+                            * ((time_sum[gx + i * num_elements] / M) - 1);
+            bad_input[gx] = total_sk / num_sk;
+        }
+    }
+
+    // rfi_chime_zero
+    void zero_kernel(uint32_t* input) {
+        const uint32_t gx_size = num_elements / 4;
+        for (uint32_t gy = 0; gy < num_samples / sk_step; gy++)
+            for (uint32_t gx = 0; gx < gx_size; gx++)
+                if (sk_mask[gy] == 1)
+                    for (uint32_t i = 0; i < sk_step; i++)
+                        input[gx + gy * gx_size * sk_step + i * gx_size] = 0x88888888;
+    }
+};
+
+// The CPU RFI commands on a device, with the network buffer for the metadata
+struct rfi_chain {
+    rfi_chain(uint32_t num_elements, uint32_t num_local_freq, uint32_t num_samples,
+              uint32_t sk_step, bool trunc_bias_switch, int num_threads) :
+        num_elements(num_elements),
+        num_local_freq(num_local_freq),
+        num_samples(num_samples),
+        sk_step(sk_step) {
+        nlohmann::json json_config = {
+            {"log_level", "warn"},
+            {"buffer_depth", 2},
+            {"num_elements", num_elements},
+            {"num_local_freq", num_local_freq},
+            {"samples_per_data_set", num_samples},
+            {"sk_step", sk_step},
+            {"rfi_sigma_cut", 5},
+            {"trunc_bias_switch", trunc_bias_switch},
+            {"updatable_config", {{"rfi_zeroing_toggle", "/rfi_zeroing_toggle"}}},
+            {"rfi_zeroing_toggle", {{"kotekan_update_endpoint", "json"}, {"rfi_zeroing", true}}}};
+        config.update_config(json_config);
+        configUpdater::instance().apply_config(config);
+
+        pool = create_metadata_pool(2, sizeof(chimeMetadata));
+        network_buf = create_buffer(1, num_elements * num_local_freq * num_samples, pool,
+                                    "network_buf", "standard", 0);
+        register_producer(network_buf, "test");
+        buffers.add_buffer("network_buf", network_buf);
+
+        device = new cpuDeviceInterface(config, 0, 2, num_threads);
+        time_sum = new cpuRfiTimeSum(config, "/gpu/time_sum", buffers, *device);
+        bad_input = new cpuRfiBadInput(config, "/gpu/bad_input", buffers, *device);
+        input_sum = new cpuRfiInputSum(config, "/gpu/input_sum", buffers, *device);
+        zero_data = new cpuRfiZeroData(config, "/gpu/zero_data", buffers, *device);
+    }
+
+    ~rfi_chain() {
+        delete zero_data;
+        delete input_sum;
+        delete bad_input;
+        delete time_sum;
+        delete device;
+        delete_buffer(network_buf);
+        delete_metadata_pool(pool);
+        configUpdater::instance().reset();
+    }
+
+    // Runs the commands on the input, which is zeroed in place
+    void run(std::vector<uint8_t>& input, const std::vector<uint8_t>& input_mask,
+             const std::vector<uint32_t>& lost_samples, uint32_t num_bad_inputs) {
+        const int gpu_frame_id = 0;
+        wait_for_empty_frame(network_buf, "test", 0);
+        allocate_new_metadata_object(network_buf, 0);
+        set_rfi_num_bad_inputs(network_buf, 0, num_bad_inputs);
+        mark_frame_full(network_buf, "test", 0);
+
+        memcpy(memory<uint8_t>("input", input.size()), input.data(), input.size());
+        memcpy(memory<uint8_t>("input_mask", input_mask.size()), input_mask.data(),
+               input_mask.size());
+        memcpy(memory<uint32_t>("rfi_compressed_lost_samples", lost_samples.size()),
+               lost_samples.data(), lost_samples.size() * sizeof(uint32_t));
+
+        BOOST_REQUIRE_EQUAL(input_sum->wait_on_precondition(gpu_frame_id), 0);
+        cpuEvent event;
+        event = time_sum->execute(gpu_frame_id, event);
+        event = bad_input->execute(gpu_frame_id, event);
+        event = input_sum->execute(gpu_frame_id, event);
+        event = zero_data->execute(gpu_frame_id, event);
+        event->done.wait();
+        BOOST_CHECK_EQUAL(get_rfi_zeroed(network_buf, 0), 1);
+        for (gpuCommand* command : {(gpuCommand*)time_sum, (gpuCommand*)bad_input,
+                                    (gpuCommand*)input_sum, (gpuCommand*)zero_data})
+            command->finalize_frame(gpu_frame_id);
+
+        memcpy(input.data(), memory<uint8_t>("input", input.size()), input.size());
+    }
+
+    template<typename T>
+    T* memory(const std::string& name, size_t n) {
+        return (T*)device->get_gpu_memory_array(name, 0, n * sizeof(T));
+    }
+
+    uint32_t num_sk_steps() {
+        return num_samples / sk_step;
+    }
+    float* sk() {
+        return memory<float>("rfi_output", num_local_freq * num_sk_steps());
+    }
+    float* sk_var() {
+        return memory<float>("rfi_output_var", num_local_freq * num_sk_steps());
+    }
+    uint8_t* sk_mask() {
+        return memory<uint8_t>("rfi_mask_output", num_local_freq * num_sk_steps());
+    }
+    float* bad_input_sk() {
+        return memory<float>("rfi_bad_input", num_elements * num_local_freq);
+    }
+    float* time_sum_output() {
+        return memory<float>("time_sum", num_elements * num_local_freq * num_sk_steps());
+    }
+
+    uint32_t num_elements, num_local_freq, num_samples, sk_step;
+    Config config;
+    bufferContainer buffers;
+    metadataPool* pool;
+    Buffer* network_buf;
+    cpuDeviceInterface* device;
+    cpuRfiTimeSum* time_sum;
+    cpuRfiBadInput* bad_input;
+    cpuRfiInputSum* input_sum;
+    cpuRfiZeroData* zero_data;
+};
+
+// 4 bit Gaussian noise, with a constant power (RFI) in a few blocks of sk_step samples
+std::vector<uint8_t> make_input(uint32_t num_inputs, uint32_t num_samples, uint32_t sk_step,
+                                const std::vector<uint32_t>& rfi_steps, std::mt19937& gen) {
+    std::normal_distribution<float> normal(0, 2.5);
+    auto noise = [&]() { return std::min(std::max((int)lroundf(normal(gen)), -8), 7) + 8; };
+    std::vector<uint8_t> input(num_inputs * num_samples);
+    for (auto& x : input)
+        x = (noise() << 4) | noise();
+    for (uint32_t step : rfi_steps)
+        for (uint32_t t = step * sk_step; t < (step + 1) * sk_step; t++)
+            for (uint32_t i = 0; i < num_inputs; i++)
+                input[t * num_inputs + i] = (t % 16 < 8) ? 0xff : 0x11;
+    return input;
+}
+
+bool bit_equal(const float* a, const float* b, size_t n) {
+    return memcmp(a, b, n * sizeof(float)) == 0;
+}
+
+BOOST_AUTO_TEST_CASE(chime_kernels_bit_exact) {
+    const uint32_t num_elements = 512, num_samples = 8192, sk_step = 256;
+    const uint32_t num_sk = num_samples / sk_step;
+    std::mt19937 gen(1234);
+
+    for (bool trunc_bias_switch : {false, true}) {
+        std::vector<uint8_t> input = make_input(num_elements, num_samples, sk_step, {3, 17}, gen);
+        std::vector<uint8_t> input_mask(num_elements, 1);
+        uint32_t num_bad_inputs = 0;
+        for (uint32_t e = 5; e < num_elements; e += 37, num_bad_inputs++)
+            input_mask[e] = 0;
+        // A few lost samples, and a block with all samples lost
+        std::vector<uint32_t> lost_samples(num_sk, 0);
+        lost_samples[1] = 3;
+        lost_samples[9] = 100;
+        lost_samples[20] = sk_step;
+
+        rfi_kernels gpu(num_elements, num_samples, sk_step);
+        std::vector<uint8_t> gpu_input = input;
+        gpu.time_sum_kernel((uint32_t*)gpu_input.data());
+        gpu.bad_input_kernel();
+        gpu.input_sum_kernel(input_mask, lost_samples.data(), num_bad_inputs, 5,
+                             trunc_bias_switch);
+        gpu.zero_kernel((uint32_t*)gpu_input.data());
+
+        rfi_chain cpu(num_elements, 1, num_samples, sk_step, trunc_bias_switch, 4);
+        cpu.run(input, input_mask, lost_samples, num_bad_inputs);
+
+        BOOST_CHECK(bit_equal(cpu.time_sum_output(), gpu.time_sum.data(), gpu.time_sum.size()));
+        BOOST_CHECK(bit_equal(cpu.bad_input_sk(), gpu.bad_input.data(), num_elements));
+        BOOST_CHECK(bit_equal(cpu.sk(), gpu.sk.data(), num_sk));
+        BOOST_CHECK(bit_equal(cpu.sk_var(), gpu.sk_var.data(), num_sk));
+        BOOST_CHECK(memcmp(cpu.sk_mask(), gpu.sk_mask.data(), num_sk) == 0);
+        BOOST_CHECK(input == gpu_input);
+
+        // The blocks with RFI or without samples are flagged
+        for (uint32_t step : {3, 17, 20})
+            BOOST_CHECK_EQUAL(gpu.sk_mask[step], 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(frequencies_and_threads) {
+    const uint32_t num_elements = 256, num_local_freq = 3, num_samples = 2048, sk_step = 128;
+    const uint32_t num_sk = num_samples / sk_step;
+    const uint32_t num_inputs = num_elements * num_local_freq;
+    std::mt19937 gen(42);
+
+    std::vector<uint8_t> input = make_input(num_inputs, num_samples, sk_step, {2}, gen);
+    std::vector<uint8_t> input_mask(num_elements, 1);
+    input_mask[7] = 0;
+    std::vector<uint32_t> lost_samples(num_sk, 0);
+    lost_samples[5] = 10;
+
+    std::vector<uint8_t> zeroed = input;
+    rfi_chain cpu(num_elements, num_local_freq, num_samples, sk_step, true, 3);
+    cpu.run(zeroed, input_mask, lost_samples, 1);
+
+    // Each frequency gives the outputs of the kernels on that frequency alone
+    for (uint32_t f = 0; f < num_local_freq; f++) {
+        std::vector<uint8_t> freq_input(num_elements * num_samples);
+        for (uint32_t t = 0; t < num_samples; t++)
+            memcpy(&freq_input[t * num_elements], &input[t * num_inputs + f * num_elements],
+                   num_elements);
+        rfi_kernels gpu(num_elements, num_samples, sk_step);
+        gpu.time_sum_kernel((uint32_t*)freq_input.data());
+        gpu.bad_input_kernel();
+        gpu.input_sum_kernel(input_mask, lost_samples.data(), 1, 5, true);
+        gpu.zero_kernel((uint32_t*)freq_input.data());
+
+        for (uint32_t step = 0; step < num_sk; step++) {
+            const uint32_t i = f + step * num_local_freq;
+            BOOST_CHECK(bit_equal(&cpu.sk()[i], &gpu.sk[step], 1));
+            BOOST_CHECK(bit_equal(&cpu.sk_var()[i], &gpu.sk_var[step], 1));
+            BOOST_CHECK_EQUAL(cpu.sk_mask()[i], gpu.sk_mask[step]);
+            BOOST_CHECK(bit_equal(&cpu.time_sum_output()[step * num_inputs + f * num_elements],
+                                  &gpu.time_sum[step * num_elements], num_elements));
+        }
+        BOOST_CHECK(bit_equal(&cpu.bad_input_sk()[f * num_elements], gpu.bad_input.data(),
+                              num_elements));
+        for (uint32_t t = 0; t < num_samples; t++)
+            BOOST_CHECK(memcmp(&zeroed[t * num_inputs + f * num_elements],
+                               &freq_input[t * num_elements], num_elements)
+                        == 0);
+    }
+}
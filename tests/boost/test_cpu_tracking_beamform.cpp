@@ -0,0 +1,178 @@
+#define BOOST_TEST_MODULE "test_cpuTrackingBeamform"
+
+#include "Config.hpp"              // for Config
+#include "bufferContainer.hpp"     // for bufferContainer
+#include "cpuDeviceInterface.hpp"  // for cpuDeviceInterface, cpuEvent
+#include "cpuTrackingBeamform.hpp" // for cpuTrackingBeamform
+#include "util.h"                  // for e_time
+
+#include "fmt.hpp"  // for format, fmt
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json, basic_json<>::v...
+
+#include <algorithm>                         // for min
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <cmath>                             // for cos, sin, floor, fabs
+#include <random>                            // for mt19937, uniform_int_distribution
+#include <stdint.h>                          // for int32_t, uint8_t
+#include <string.h>                          // for memcpy
+#include <vector>                            // for vector
+
+using kotekan::bufferContainer;
+using kotekan::Config;
+
+// The tracking beams of gpuTrackingBeamformSimulate in double precision, and the 4+4 bit
+// encoding of the GPU kernel. Also returns how close each value is to a rounding boundary.
+void simulate(const std::vector<uint8_t>& input, const std::vector<float>& phase,
+              int num_samples, int num_beams, std::vector<uint8_t>& output,
+              std::vector<double>& margin) {
+    const float* scaling = phase.data() + 2048 * num_beams * 2;
+    output.assign(num_samples * num_beams * 2, 0);
+    margin.assign(num_samples * num_beams * 2, 1);
+    for (int t = 0; t < num_samples; t++) {
+        for (int b = 0; b < num_beams; b++) {
+            for (int p = 0; p < 2; p++) {
+                double sum_re = 0, sum_im = 0;
+                for (int n = 0; n < 1024; n++) {
+                    uint8_t x = input[t * 2048 + p * 1024 + n];
+                    double re = (x >> 4) - 8, im = (x & 0x0f) - 8;
+                    const float* ph = &phase[((b * 2 + p) * 1024 + n) * 2];
+                    sum_re += re * ph[0] + im * ph[1];
+                    sum_im += im * ph[0] - re * ph[1];
+                }
+                double v[2] = {sum_re / scaling[b] + 8, sum_im / scaling[b] + 8};
+                int q[2];
+                for (int i = 0; i < 2; i++) {
+                    double c = v[i] > 15 ? 15 : v[i] < 0 ? 0 : v[i];
+                    q[i] = (int)c;
+                    // Values on the boundary of a bin, but not clamped, can go either way
+                    if (v[i] > 0 && v[i] < 15)
+                        margin[(t * num_beams + b) * 2 + p] =
+                            std::min(margin[(t * num_beams + b) * 2 + p],
+                                     std::min(c - floor(c), floor(c) + 1 - c));
+                }
+                output[(t * num_beams + b) * 2 + p] = ((q[0] << 4) & 0xf0) + (q[1] & 0x0f);
+            }
+        }
+    }
+}
+
+struct tracking_beamformer {
+    tracking_beamformer(int num_samples, int num_beams, int num_threads) :
+        num_samples(num_samples),
+        num_beams(num_beams) {
+        nlohmann::json json_config = {{"log_level", "warn"},
+                                      {"buffer_depth", 2},
+                                      {"num_elements", 2048},
+                                      {"num_beams", num_beams},
+                                      {"samples_per_data_set", num_samples},
+                                      {"num_pol", 2}};
+        config.update_config(json_config);
+        device = new cpuDeviceInterface(config, 0, 2, num_threads);
+        kernel = new cpuTrackingBeamform(config, "/gpu/tracking", buffers, *device);
+    }
+
+    ~tracking_beamformer() {
+        delete kernel;
+        delete device;
+    }
+
+    std::vector<uint8_t> run(const std::vector<uint8_t>& input, const std::vector<float>& phase,
+                             int gpu_frame_id) {
+        memcpy(device->get_gpu_memory("input_reordered", input.size()), input.data(),
+               input.size());
+        memcpy(device->get_gpu_memory_array("beamform_phase", gpu_frame_id,
+                                            phase.size() * sizeof(float)),
+               phase.data(), phase.size() * sizeof(float));
+        kernel->execute(gpu_frame_id, cpuEvent())->done.wait();
+        uint8_t* out = (uint8_t*)device->get_gpu_memory_array(
+            "bf_tracking_output", gpu_frame_id, num_samples * num_beams * 2);
+        return std::vector<uint8_t>(out, out + num_samples * num_beams * 2);
+    }
+
+    int num_samples, num_beams;
+    Config config;
+    bufferContainer buffers;
+    cpuDeviceInterface* device;
+    cpuTrackingBeamform* kernel;
+};
+
+std::vector<uint8_t> random_input(size_t len, int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> input(len);
+    for (auto& x : input)
+        x = dist(gen);
+    return input;
+}
+
+// Unit phases times random gains, and scaling factors which use the whole 4 bit range
+std::vector<float> random_phase(int num_beams, int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> angle(0, 6.2831853);
+    std::uniform_real_distribution<float> gain(0.5, 1.5);
+    std::uniform_real_distribution<float> scaling(4, 48);
+    std::vector<float> phase;
+    for (int i = 0; i < 2048 * num_beams; i++) {
+        float a = angle(gen), g = gain(gen);
+        phase.push_back(g * cos(a));
+        phase.push_back(g * sin(a));
+    }
+    for (int b = 0; b < num_beams; b++)
+        phase.push_back(b == 0 ? 1 : scaling(gen));
+    return phase;
+}
+
+BOOST_AUTO_TEST_CASE(matches_simulation) {
+    // samples, beams, threads
+    const std::vector<std::vector<int>> cases = {
+        {64, 10, 1}, {128, 16, 2}, {96, 37, 3}, {256, 1, 2}, {64, 100, 4},
+    };
+
+    for (auto& c : cases) {
+        BOOST_TEST_MESSAGE(fmt::format(fmt("{:d} samples, {:d} beams, {:d} threads"), c[0], c[1],
+                                       c[2]));
+        auto input = random_input(c[0] * 2048, c[0]);
+        auto phase = random_phase(c[1], c[1]);
+        std::vector<uint8_t> expected;
+        std::vector<double> margin;
+        simulate(input, phase, c[0], c[1], expected, margin);
+
+        tracking_beamformer bf(c[0], c[1], c[2]);
+        for (int gpu_frame_id = 0; gpu_frame_id < 2; gpu_frame_id++) {
+            auto output = bf.run(input, phase, gpu_frame_id);
+            size_t num_diff = 0;
+            for (size_t i = 0; i < output.size(); i++)
+                if (output[i] != expected[i] && margin[i] > 1e-4)
+                    num_diff++;
+            BOOST_CHECK_EQUAL(num_diff, 0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bad_geometry) {
+    BOOST_CHECK_THROW(tracking_beamformer(60, 10, 1), std::runtime_error);
+    BOOST_CHECK_THROW(tracking_beamformer(64, 0, 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark) {
+    const int num_samples = 6144;
+    auto input = random_input(num_samples * 2048, 1);
+    for (int num_beams : {10, 64}) {
+        tracking_beamformer bf(num_samples, num_beams, 0);
+        auto phase = random_phase(num_beams, 2);
+
+        bf.run(input, phase, 0);
+        double start = e_time();
+        const int num_runs = 3;
+        for (int i = 0; i < num_runs; i++)
+            bf.run(input, phase, i % 2);
+        double time = (e_time() - start) / num_runs;
+
+        // A complex multiply and add is 8 operations, and a CHIME sample is 2.56 us
+        double flop = 8.0 * 2048 * num_beams * num_samples;
+        BOOST_TEST_MESSAGE(fmt::format(fmt("{:d} beams, {:d} samples on {:d} threads: {:.3f} s, "
+                                           "{:.2f} GFLOP/s, {:.2f} x real time"),
+                                       num_beams, num_samples, bf.device->get_num_threads(), time,
+                                       flop / time / 1e9, num_samples * 2.56e-6 / time));
+    }
+}
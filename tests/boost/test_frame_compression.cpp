@@ -0,0 +1,123 @@
+/*
+ * Boost tests for FrameCompression
+ */
+#define BOOST_TEST_MODULE "test_FrameCompression"
+
+#include "FrameCompression.hpp" // for FrameCompressor, bitshuffle, bitunshuffle, frameCodec
+
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <cmath>                             // for sin
+#include <stdexcept>                         // for invalid_argument
+#include <stdint.h>                          // for uint8_t, uint32_t
+#include <stdlib.h>                          // for rand, srand
+#include <string.h>                          // for memcpy
+#include <vector>                            // for vector
+
+static std::vector<uint8_t> random_bytes(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (auto& b : data)
+        b = rand() % 256;
+    return data;
+}
+
+// Noisy floats with their mantissas truncated, like visibilities after VisTruncate
+static std::vector<uint8_t> truncated_floats(size_t num) {
+    std::vector<uint32_t> values(num);
+    for (size_t i = 0; i < num; i++) {
+        float value = 1000 * sin(i * 0.001) + (rand() % 1000) * 0.1;
+        memcpy(&values[i], &value, sizeof(value));
+        values[i] &= 0xffff0000;
+    }
+    std::vector<uint8_t> data(num * sizeof(float));
+    memcpy(data.data(), values.data(), data.size());
+    return data;
+}
+
+/*
+ * A single block: bit k of byte b of element j ends up at bit j of row 8 * b + k.
+ */
+BOOST_AUTO_TEST_CASE(bitshuffle_layout) {
+    srand(42);
+    const size_t elem_size = 4, num_elem = 67;
+    auto data = random_bytes(elem_size * num_elem + 3);
+    std::vector<uint8_t> shuffled(data.size());
+    bitshuffle(data.data(), shuffled.data(), data.size(), elem_size);
+
+    const size_t n = num_elem / 8 * 8;
+    bool layout_ok = true;
+    for (size_t j = 0; j < n; j++) {
+        for (size_t b = 0; b < elem_size; b++) {
+            for (size_t k = 0; k < 8; k++) {
+                size_t bit = (8 * b + k) * n + j;
+                int in = (data[j * elem_size + b] >> k) & 1;
+                int out = (shuffled[bit / 8] >> (bit % 8)) & 1;
+                layout_ok &= in == out;
+            }
+        }
+    }
+    BOOST_CHECK(layout_ok);
+
+    // The last few elements and the trailing bytes are copied
+    BOOST_CHECK(std::vector<uint8_t>(data.begin() + n * elem_size, data.end())
+                == std::vector<uint8_t>(shuffled.begin() + n * elem_size, shuffled.end()));
+}
+
+BOOST_AUTO_TEST_CASE(bitshuffle_roundtrip) {
+    srand(42);
+    for (size_t elem_size : {1, 2, 3, 4, 8, 16}) {
+        for (size_t size : {0, 5, 64, 8191, 100000}) {
+            auto data = random_bytes(size);
+            std::vector<uint8_t> shuffled(size), unshuffled(size);
+            bitshuffle(data.data(), shuffled.data(), size, elem_size);
+            bitunshuffle(shuffled.data(), unshuffled.data(), size, elem_size);
+            BOOST_CHECK(data == unshuffled);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(codec_names) {
+    for (auto codec : {frameCodec::none, frameCodec::lz4, frameCodec::zstd})
+        BOOST_CHECK(frame_codec_from_string(frame_codec_name(codec)) == codec);
+    BOOST_CHECK_THROW(frame_codec_from_string("gzip"), std::invalid_argument);
+    BOOST_CHECK(frame_codec_available(frameCodec::none));
+}
+
+/*
+ * Frames come back unchanged with every codec kotekan was built with, and
+ * incompressible frames aren't compressed.
+ */
+BOOST_AUTO_TEST_CASE(compress_roundtrip) {
+    srand(42);
+    FrameCompressor compressor, decompressor;
+    auto vis = truncated_floats(100000);
+    auto noise = random_bytes(100000);
+
+    for (auto codec : {frameCodec::lz4, frameCodec::zstd}) {
+        if (!frame_codec_available(codec)) {
+            BOOST_TEST_MESSAGE("Skipping " << frame_codec_name(codec) << ", not built in.");
+            continue;
+        }
+        for (uint32_t shuffle : {0, 4}) {
+            std::vector<uint8_t> compressed;
+            size_t size = compressor.compress(codec, 0, shuffle, vis.data(), vis.size(),
+                                              compressed);
+            BOOST_CHECK(size > 0 && size < vis.size());
+
+            std::vector<uint8_t> frame(vis.size());
+            BOOST_CHECK(decompressor.decompress(codec, shuffle, compressed.data(), size,
+                                                frame.data(), frame.size()));
+            BOOST_CHECK(frame == vis);
+
+            // A truncated frame is caught
+            BOOST_CHECK(!decompressor.decompress(codec, shuffle, compressed.data(), size / 2,
+                                                 frame.data(), frame.size()));
+        }
+
+        // Bitshuffling helps with truncated floats
+        std::vector<uint8_t> plain, shuffled;
+        BOOST_CHECK(compressor.compress(codec, 0, 4, vis.data(), vis.size(), shuffled)
+                    < compressor.compress(codec, 0, 0, vis.data(), vis.size(), plain));
+
+        BOOST_CHECK_EQUAL(compressor.compress(codec, 0, 0, noise.data(), noise.size(), plain), 0);
+    }
+}
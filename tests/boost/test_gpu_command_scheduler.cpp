@@ -0,0 +1,262 @@
+#define BOOST_TEST_MODULE "test_gpuCommandScheduler"
+
+#include "gpuCommandScheduler.hpp" // for gpuCommandScheduler
+
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json, basic_json<>::v...
+
+#include <atomic>                            // for atomic
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <chrono>                            // for milliseconds
+#include <condition_variable>                // for condition_variable
+#include <mutex>                             // for mutex, lock_guard, unique_lock
+#include <stddef.h>                          // for size_t
+#include <stdexcept>                         // for invalid_argument
+#include <thread>                            // for sleep_for
+#include <utility>                           // for pair
+#include <vector>                            // for vector
+
+// Simulated commands, whose preconditions are opened by the test, and the order they are
+// queued in, as (command, frame)
+struct simulated_pipeline {
+    simulated_pipeline(size_t num_commands) :
+        allowed(num_commands, 0),
+        waited(num_commands, 0),
+        queued(num_commands, 0) {}
+
+    int wait_on_precondition(size_t c, int gpu_frame_id) {
+        (void)gpu_frame_id;
+        std::unique_lock<std::mutex> lock(mtx);
+        cond.wait(lock, [&] { return waited[c] < allowed[c] || stopping; });
+        if (stopping)
+            return 1;
+        waited[c]++;
+        return 0;
+    }
+
+    void queue_command(size_t c, int gpu_frame_id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        order.push_back({c, gpu_frame_id});
+        queued[c]++;
+        cond.notify_all();
+    }
+
+    // Lets command c pass its precondition on n more frames
+    void allow(size_t c, int n) {
+        std::lock_guard<std::mutex> lock(mtx);
+        allowed[c] += n;
+        cond.notify_all();
+    }
+
+    // Waits until command c was queued on n frames
+    bool wait_queued(size_t c, int n) {
+        std::unique_lock<std::mutex> lock(mtx);
+        return cond.wait_for(lock, std::chrono::seconds(5), [&] { return queued[c] >= n; });
+    }
+
+    int num_queued(size_t c) {
+        std::lock_guard<std::mutex> lock(mtx);
+        return queued[c];
+    }
+
+    // Makes the preconditions return non-zero, like at shutdown
+    void stop() {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+        cond.notify_all();
+    }
+
+    bool stopping = false;
+    std::vector<int> allowed, waited, queued;
+    std::vector<std::pair<size_t, int>> order;
+    std::mutex mtx;
+    std::condition_variable cond;
+};
+
+BOOST_AUTO_TEST_CASE(slow_precondition_does_not_block_earlier_commands) {
+    const int num_frames = 4;
+    simulated_pipeline sim(3);
+    gpuCommandScheduler scheduler(
+        3, num_frames, [&](size_t c, int f) { return sim.wait_on_precondition(c, f); },
+        [](int) {}, [&](size_t c, int f) { sim.queue_command(c, f); });
+    // The commands don't share any memory
+    scheduler.set_last_users({0, 1, 2});
+    std::atomic<bool> stop_thread(false);
+    std::thread run_thread([&] { scheduler.run(stop_thread); });
+
+    // The last command (e.g. a copy out waiting for an output frame) is held back, while the
+    // first two are queued on the next frames
+    sim.allow(0, 3);
+    sim.allow(1, 3);
+    sim.allow(2, 1);
+    BOOST_CHECK(sim.wait_queued(1, 3));
+    BOOST_CHECK(sim.wait_queued(2, 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(sim.num_queued(0), 3);
+    BOOST_CHECK_EQUAL(sim.num_queued(2), 1);
+
+    sim.allow(2, 2);
+    BOOST_CHECK(sim.wait_queued(2, 3));
+
+    // The commands of each frame are queued in order, and each command on the frames in order
+    std::vector<int> next_frame(3, 0);
+    for (auto& q : sim.order) {
+        BOOST_CHECK_EQUAL(q.second, next_frame[q.first] % num_frames);
+        if (q.first > 0)
+            BOOST_CHECK(next_frame[q.first - 1] > next_frame[q.first]);
+        next_frame[q.first]++;
+    }
+
+    // Stopping returns from run, and the threads waiting on the preconditions once unblocked
+    stop_thread = true;
+    run_thread.join();
+    sim.stop();
+    scheduler.join();
+
+    // The scheduler counts a command once it is back from queuing it, so only once it's stopped
+    // are all the commands counted
+    auto metrics = scheduler.get_metrics();
+    BOOST_CHECK_EQUAL(metrics["frames_queued"], 3);
+    BOOST_CHECK(metrics["max_lead"] >= 2);
+}
+
+// Checks that command c was only queued on frame k once command last_users[c] was queued on
+// frame k - 1
+static void check_shared_memory_order(const std::vector<std::pair<size_t, int>>& order,
+                                      const std::vector<size_t>& last_users) {
+    std::vector<int> next_frame(last_users.size(), 0);
+    for (auto& q : order) {
+        if (next_frame[q.first] > 0)
+            BOOST_CHECK(next_frame[last_users[q.first]] >= next_frame[q.first]);
+        next_frame[q.first]++;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(shared_memory_waits_for_last_user) {
+    const int num_frames = 4;
+    simulated_pipeline sim(4);
+    gpuCommandScheduler scheduler(
+        4, num_frames, [&](size_t c, int f) { return sim.wait_on_precondition(c, f); },
+        [](int) {}, [&](size_t c, int f) { sim.queue_command(c, f); });
+
+    // Command 1 writes memory which isn't per GPU frame and command 2 reads it, like a reorder
+    // writing input_reordered for a beamformer
+    std::vector<size_t> last_users = {0, 2, 2, 3};
+    scheduler.set_last_users(last_users);
+    std::atomic<bool> stop_thread(false);
+    std::thread run_thread([&] { scheduler.run(stop_thread); });
+
+    // With the reader held back, the writer can't get onto the next frame, while the command
+    // before it still runs ahead
+    sim.allow(0, 3);
+    sim.allow(1, 3);
+    sim.allow(2, 1);
+    sim.allow(3, 3);
+    BOOST_CHECK(sim.wait_queued(2, 1));
+    BOOST_CHECK(sim.wait_queued(1, 2));
+    BOOST_CHECK(sim.wait_queued(0, 3));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(sim.num_queued(1), 2);
+
+    sim.allow(2, 2);
+    BOOST_CHECK(sim.wait_queued(3, 3));
+
+    stop_thread = true;
+    run_thread.join();
+    sim.stop();
+    scheduler.join();
+
+    check_shared_memory_order(sim.order, last_users);
+}
+
+BOOST_AUTO_TEST_CASE(unknown_sharing_waits_for_last_command) {
+    const int num_frames = 4;
+    simulated_pipeline sim(3);
+    gpuCommandScheduler scheduler(
+        3, num_frames, [&](size_t c, int f) { return sim.wait_on_precondition(c, f); },
+        [](int) {}, [&](size_t c, int f) { sim.queue_command(c, f); });
+    std::atomic<bool> stop_thread(false);
+    std::thread run_thread([&] { scheduler.run(stop_thread); });
+
+    // Until the commands sharing memory are known, a command only goes onto the next frame
+    // once the last command is queued on the previous one
+    sim.allow(0, 3);
+    sim.allow(1, 3);
+    sim.allow(2, 1);
+    BOOST_CHECK(sim.wait_queued(2, 1));
+    BOOST_CHECK(sim.wait_queued(0, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(sim.num_queued(0), 2);
+    BOOST_CHECK_EQUAL(sim.num_queued(1), 2);
+
+    sim.allow(2, 2);
+    BOOST_CHECK(sim.wait_queued(2, 3));
+
+    stop_thread = true;
+    run_thread.join();
+    sim.stop();
+    scheduler.join();
+
+    check_shared_memory_order(sim.order, {2, 2, 2});
+}
+
+BOOST_AUTO_TEST_CASE(first_command_waits_for_free_slot) {
+    const int num_frames = 2;
+    simulated_pipeline sim(2);
+    std::mutex slot_mtx;
+    std::condition_variable slot_cond;
+    int frames_finalized = 0;
+    int slot_waits = 0;
+
+    // Frame k can only use its GPU frame once frame k - num_frames was finalized
+    gpuCommandScheduler scheduler(
+        2, num_frames, [&](size_t c, int f) { return sim.wait_on_precondition(c, f); },
+        [&](int) {
+            std::unique_lock<std::mutex> lock(slot_mtx);
+            int frame = slot_waits++;
+            slot_cond.wait(lock, [&] { return frame - frames_finalized < num_frames; });
+        },
+        [&](size_t c, int f) { sim.queue_command(c, f); });
+    std::atomic<bool> stop_thread(false);
+    std::thread run_thread([&] { scheduler.run(stop_thread); });
+
+    sim.allow(0, 10);
+    sim.allow(1, 10);
+    BOOST_CHECK(sim.wait_queued(1, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    BOOST_CHECK_EQUAL(sim.num_queued(0), 2);
+
+    for (int i = 1; i <= 3; i++) {
+        {
+            std::lock_guard<std::mutex> lock(slot_mtx);
+            frames_finalized++;
+        }
+        slot_cond.notify_all();
+        BOOST_CHECK(sim.wait_queued(1, 2 + i));
+    }
+    BOOST_CHECK_EQUAL(sim.num_queued(0), 5);
+
+    // A precondition returning non-zero stops the scheduler
+    {
+        std::lock_guard<std::mutex> lock(slot_mtx);
+        frames_finalized = 100;
+    }
+    slot_cond.notify_all();
+    sim.stop();
+    run_thread.join();
+    scheduler.join();
+}
+
+BOOST_AUTO_TEST_CASE(bad_arguments) {
+    auto precondition = [](size_t, int) { return 0; };
+    auto slot = [](int) {};
+    auto queue = [](size_t, int) {};
+    BOOST_CHECK_THROW(gpuCommandScheduler(0, 2, precondition, slot, queue),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(gpuCommandScheduler(2, 0, precondition, slot, queue),
+                      std::invalid_argument);
+
+    gpuCommandScheduler scheduler(3, 2, precondition, slot, queue);
+    BOOST_CHECK_THROW(scheduler.set_last_users({0, 1}), std::invalid_argument);
+    BOOST_CHECK_THROW(scheduler.set_last_users({0, 0, 2}), std::invalid_argument);
+    BOOST_CHECK_THROW(scheduler.set_last_users({0, 1, 3}), std::invalid_argument);
+}
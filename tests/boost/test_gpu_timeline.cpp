@@ -0,0 +1,91 @@
+#define BOOST_TEST_MODULE "test_gpuTimeline"
+
+#include "gpuTimeline.hpp" // for gpuTimeline
+#include "util.h"          // for e_time
+
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json, basic_json<>::v...
+
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <stdint.h>                          // for uint32_t
+#include <string>                            // for string
+#include <vector>                            // for vector
+
+using nlohmann::json;
+
+std::vector<json> slices(const json& trace) {
+    std::vector<json> slices;
+    for (auto& e : trace["traceEvents"])
+        if (e["ph"] == "X")
+            slices.push_back(e);
+    return slices;
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer) {
+    gpuTimeline timeline(4);
+    uint32_t kernel = timeline.add_label("kernel", "kernel", "0 kernel");
+    uint32_t wait = timeline.add_label("wait", "wait", "host");
+    BOOST_CHECK_EQUAL(kernel, 0);
+    BOOST_CHECK_EQUAL(wait, 1);
+
+    double t0 = e_time();
+    for (int i = 0; i < 6; i++)
+        timeline.add_event(i % 2 ? wait : kernel, i % 3, t0 + i, t0 + i + 0.5);
+
+    // Only the last 4, oldest first
+    auto events = slices(timeline.to_json("GPU 0"));
+    BOOST_REQUIRE_EQUAL(events.size(), 4);
+    for (int i = 0; i < 4; i++) {
+        BOOST_CHECK_EQUAL(events[i]["name"], (i + 2) % 2 ? "wait" : "kernel");
+        BOOST_CHECK_EQUAL(events[i]["pid"], (i + 2) % 3);
+        BOOST_CHECK_EQUAL(events[i]["tid"], (i + 2) % 2 ? 1 : 0);
+        BOOST_CHECK_CLOSE(events[i]["dur"].get<double>(), 0.5e6, 1e-3);
+        if (i > 0)
+            BOOST_CHECK_CLOSE(events[i]["ts"].get<double>() - events[i - 1]["ts"].get<double>(),
+                              1e6, 1e-3);
+    }
+
+    // The names of the frames and tracks
+    json trace = timeline.to_json("GPU 0");
+    int num_processes = 0, num_threads = 0;
+    for (auto& e : trace["traceEvents"]) {
+        if (e["name"] == "process_name")
+            num_processes++;
+        if (e["name"] == "thread_name")
+            num_threads++;
+    }
+    BOOST_CHECK_EQUAL(num_processes, 3);
+    BOOST_CHECK_EQUAL(num_threads, 3 * 2);
+
+    timeline.clear();
+    BOOST_CHECK_EQUAL(slices(timeline.to_json("GPU 0")).size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(device_clock) {
+    gpuTimeline timeline(16);
+    uint32_t host = timeline.add_label("host", "wait", "host");
+    uint32_t kernel = timeline.add_label("kernel", "kernel", "0 kernel");
+
+    // A device clock 1000 s behind the host, with events completing on the host 1 ms and
+    // 10 ms after they end
+    double now = e_time();
+    timeline.add_event(host, 0, now - 0.1, now - 0.05);
+    timeline.add_device_event(kernel, 0, now - 1000 - 0.03, now - 1000 - 0.01);
+    timeline.add_device_event(kernel, 1, now - 1000 - 0.002, now - 1000 - 0.001);
+
+    auto events = slices(timeline.to_json("GPU 0"));
+    BOOST_REQUIRE_EQUAL(events.size(), 3);
+    // The device events are moved to the host clock, to within the smallest latency
+    double host_end = events[0]["ts"].get<double>() + events[0]["dur"].get<double>();
+    double kernel_start = events[1]["ts"].get<double>();
+    BOOST_CHECK_CLOSE(kernel_start - host_end, 0.02e6, 10);
+    BOOST_CHECK_CLOSE(events[1]["dur"].get<double>(), 0.02e6, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(disabled) {
+    gpuTimeline timeline(0);
+    uint32_t kernel = timeline.add_label("kernel", "kernel", "0 kernel");
+    BOOST_CHECK(!timeline.enabled());
+    timeline.add_event(kernel, 0, 0, 1);
+    timeline.add_device_event(kernel, 0, 0, 1);
+    BOOST_CHECK_EQUAL(timeline.to_json("GPU 0")["traceEvents"].size(), 0);
+}
@@ -0,0 +1,156 @@
+#define BOOST_TEST_MODULE "test_host_memory_pool"
+
+#include "buffer.h"         // for buffer_free, buffer_malloc, PAGESIZE_MEM
+#include "hostMemoryPool.h" // for host_pool_malloc, host_pool_free, host_pool_register_runtime
+
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <map>                               // for map
+#include <stddef.h>                          // for size_t
+#include <stdint.h>                          // for uint8_t, uintptr_t
+
+// A device runtime which counts the memory pinned with it
+struct fakeRuntime {
+    std::map<void*, size_t> pinned;
+    int num_pins = 0;
+    int num_unpins = 0;
+    bool fail = false;
+};
+
+static int fake_pin(void* ptr, size_t len, void* ctx) {
+    fakeRuntime* runtime = (fakeRuntime*)ctx;
+    if (runtime->fail)
+        return -1;
+    runtime->pinned[ptr] = len;
+    runtime->num_pins++;
+    return 0;
+}
+
+static void fake_unpin(void* ptr, size_t len, void* ctx) {
+    fakeRuntime* runtime = (fakeRuntime*)ctx;
+    BOOST_CHECK_EQUAL(runtime->pinned.at(ptr), len);
+    runtime->pinned.erase(ptr);
+    runtime->num_unpins++;
+}
+
+static void check_stats(size_t num_regions, size_t num_free, size_t total_len) {
+    size_t regions, free_regions, len;
+    host_pool_get_stats(&regions, &free_regions, &len);
+    BOOST_CHECK_EQUAL(regions, num_regions);
+    BOOST_CHECK_EQUAL(free_regions, num_free);
+    BOOST_CHECK_EQUAL(len, total_len);
+}
+
+BOOST_AUTO_TEST_CASE(_reuse) {
+    const size_t len = 3 * PAGESIZE_MEM;
+
+    uint8_t* a = (uint8_t*)host_pool_malloc(len, 0);
+    uint8_t* b = (uint8_t*)host_pool_malloc(len, 0);
+    BOOST_REQUIRE(a != nullptr);
+    BOOST_REQUIRE(b != nullptr);
+    BOOST_CHECK(a != b);
+    BOOST_CHECK_EQUAL((uintptr_t)a % PAGESIZE_MEM, 0);
+    check_stats(2, 0, 2 * len);
+
+    // A freed region is reused for the same size only
+    host_pool_free(a);
+    check_stats(2, 1, 2 * len);
+    uint8_t* c = (uint8_t*)host_pool_malloc(2 * len, 0);
+    check_stats(3, 1, 4 * len);
+    uint8_t* d = (uint8_t*)host_pool_malloc(len, 0);
+    BOOST_CHECK(d == a);
+    check_stats(3, 0, 4 * len);
+
+    // Trimming releases the free regions only
+    host_pool_free(c);
+    host_pool_trim();
+    check_stats(2, 0, 2 * len);
+
+    host_pool_free(b);
+    host_pool_free(d);
+    host_pool_trim();
+    check_stats(0, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(_runtime_pinning) {
+    const size_t len = 2 * PAGESIZE_MEM;
+    fakeRuntime runtime;
+
+    // Memory allocated before the runtime is registered is pinned on registration
+    void* before = host_pool_malloc(len, 0);
+    BOOST_CHECK_EQUAL(host_pool_register_runtime("fake", fake_pin, fake_unpin, &runtime), 0);
+    BOOST_CHECK_EQUAL(runtime.num_pins, 1);
+    BOOST_CHECK(host_pool_is_pinned(before, len));
+    BOOST_CHECK(!host_pool_is_pinned((uint8_t*)before + 1, len));
+
+    // Memory allocated after is pinned on allocation, and once only when reused
+    void* after = host_pool_malloc(len, 0);
+    BOOST_CHECK_EQUAL(runtime.num_pins, 2);
+    BOOST_CHECK_EQUAL(runtime.pinned.count(after), 1);
+    host_pool_free(after);
+    BOOST_CHECK(host_pool_malloc(len, 0) == after);
+    BOOST_CHECK_EQUAL(runtime.num_pins, 2);
+    BOOST_CHECK_EQUAL(runtime.num_unpins, 0);
+
+    // Memory is unpinned when it's released
+    host_pool_free(after);
+    host_pool_trim();
+    BOOST_CHECK_EQUAL(runtime.num_unpins, 1);
+    BOOST_CHECK_EQUAL(runtime.pinned.count(after), 0);
+
+    // A runtime registered again, e.g. for a second GPU, only counts the reference
+    BOOST_CHECK_EQUAL(host_pool_register_runtime("fake", fake_pin, fake_unpin, &runtime), 0);
+    BOOST_CHECK_EQUAL(runtime.num_pins, 2);
+    host_pool_unregister_runtime("fake");
+    BOOST_CHECK_EQUAL(runtime.num_unpins, 1);
+    host_pool_unregister_runtime("fake");
+    BOOST_CHECK_EQUAL(runtime.num_unpins, 2);
+    BOOST_CHECK(runtime.pinned.empty());
+
+    // Nothing is pinned once the runtime is gone
+    void* unpinned = host_pool_malloc(len, 0);
+    BOOST_CHECK_EQUAL(runtime.num_pins, 2);
+
+    host_pool_free(before);
+    host_pool_free(unpinned);
+    host_pool_trim();
+    check_stats(0, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(_pin_failure) {
+    const size_t len = PAGESIZE_MEM;
+    fakeRuntime runtime;
+    runtime.fail = true;
+
+    // The memory can still be used if it can't be pinned
+    BOOST_CHECK_EQUAL(host_pool_register_runtime("failing", fake_pin, fake_unpin, &runtime), 0);
+    void* ptr = host_pool_malloc(len, 0);
+    BOOST_REQUIRE(ptr != nullptr);
+    BOOST_CHECK(!host_pool_is_pinned(ptr, len));
+
+    host_pool_free(ptr);
+    host_pool_trim();
+    host_pool_unregister_runtime("failing");
+    BOOST_CHECK_EQUAL(runtime.num_unpins, 0);
+}
+
+BOOST_AUTO_TEST_CASE(_buffer_frames) {
+    const size_t len = 5 * PAGESIZE_MEM;
+    fakeRuntime runtime;
+    host_pool_register_runtime("fake", fake_pin, fake_unpin, &runtime);
+
+    // The frames of the buffers are pinned, and zeroed when reused
+    uint8_t* frame = buffer_malloc(len, 0);
+    BOOST_REQUIRE(frame != nullptr);
+    BOOST_CHECK(host_pool_is_pinned(frame, len));
+    frame[len - 1] = 1;
+    buffer_free(frame, len);
+    uint8_t* reused = buffer_malloc(len, 0);
+    BOOST_CHECK(reused == frame);
+    BOOST_CHECK_EQUAL(reused[len - 1], 0);
+    BOOST_CHECK_EQUAL(runtime.num_pins, 1);
+
+    buffer_free(reused, len);
+    host_pool_trim();
+    host_pool_unregister_runtime("fake");
+    BOOST_CHECK(runtime.pinned.empty());
+}
@@ -0,0 +1,56 @@
+#define BOOST_TEST_MODULE "test_kernel_tuning"
+
+#include "KernelTuning.hpp" // for find_tuned_parameters
+
+#include "json.hpp" // for json, basic_json<>::object_t, basic_json, basic_json<>::val...
+
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+
+using nlohmann::json;
+
+// The tuning of a device, as written by tune_cl_kernels.py
+static const json tuning = R"({
+    "clKVCorr": [
+        {"geometry": {"num_elements": 256, "block_size": 32},
+         "parameters": {"full_complicated": true}, "time": 0.01},
+        {"geometry": {"num_elements": 256},
+         "parameters": {"kernel": "kv_corr_sm.cl"}, "time": 0.02},
+        {"geometry": {"num_elements": 2048}, "parameters": {"wi_size": 8}, "time": 0.5}
+    ],
+    "clPresumKernel": [
+        {"parameters": {"kernel": "offsetAccumulator.cl"}, "time": 0.001}
+    ]
+})"_json;
+
+BOOST_AUTO_TEST_CASE(_first_match) {
+    // The first entry whose geometry is a subset of the command's is used
+    json geometry = {{"num_elements", 256}, {"block_size", 32}, {"samples_per_data_set", 49152}};
+    BOOST_CHECK_EQUAL(find_tuned_parameters(tuning, "clKVCorr", geometry),
+                      json({{"full_complicated", true}}));
+
+    geometry["block_size"] = 64;
+    BOOST_CHECK_EQUAL(find_tuned_parameters(tuning, "clKVCorr", geometry),
+                      json({{"kernel", "kv_corr_sm.cl"}}));
+
+    BOOST_CHECK_EQUAL(find_tuned_parameters(tuning, "clKVCorr", {{"num_elements", 2048}}),
+                      json({{"wi_size", 8}}));
+}
+
+BOOST_AUTO_TEST_CASE(_no_match) {
+    // A geometry value which differs or is missing doesn't match
+    BOOST_CHECK(find_tuned_parameters(tuning, "clKVCorr", {{"num_elements", 512}}).empty());
+    BOOST_CHECK(find_tuned_parameters(tuning, "clKVCorr", {{"block_size", 32}}).empty());
+    BOOST_CHECK(find_tuned_parameters(tuning, "clKVCorr", json::object()).empty());
+
+    // Nor does another command, or a device without tuning
+    BOOST_CHECK(find_tuned_parameters(tuning, "clPreseedKernel", {{"num_elements", 256}}).empty());
+    BOOST_CHECK(find_tuned_parameters(json::object(), "clKVCorr", {{"num_elements", 256}}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(_any_geometry) {
+    // An entry without a geometry matches every geometry
+    BOOST_CHECK_EQUAL(find_tuned_parameters(tuning, "clPresumKernel", json::object()),
+                      json({{"kernel", "offsetAccumulator.cl"}}));
+    BOOST_CHECK_EQUAL(find_tuned_parameters(tuning, "clPresumKernel", {{"num_elements", 16}}),
+                      json({{"kernel", "offsetAccumulator.cl"}}));
+}
@@ -1,11 +1,18 @@
 #define BOOST_TEST_MODULE "test_updateQueue"
 
-#include "prometheusMetrics.hpp" // for Metrics, MetricFamily, Counter, Gauge
+#include "prometheusMetrics.hpp" // for Metrics, MetricFamily, Counter, Gauge, Histogram, Summary
+
+#include "fmt.hpp" // for format
 
 #include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <chrono>                            // for steady_clock, duration
 #include <cmath>                             // for sqrt, log
 #include <iostream>                          // for cout, ostream
+#include <mutex>                             // for mutex, lock_guard
+#include <stdint.h>                          // for uint64_t
 #include <string>                            // for string, allocator, basic_string, operator==
+#include <thread>                            // for thread
+#include <vector>                            // for vector
 
 using kotekan::prometheus::Metrics;
 
@@ -150,3 +157,165 @@ BOOST_AUTO_TEST_CASE(gauges_with_labels) {
     BOOST_CHECK(multi_metrics.find("bar_with_labels{stage_name=\"foo\",quux=\"baz\"} 42.0")
                 != std::string::npos);
 }
+
+
+BOOST_AUTO_TEST_CASE(histograms) {
+    Metrics& metrics = Metrics::instance();
+
+    auto& h1 = metrics.add_histogram("request_seconds", "main", {0.1, 1, 10});
+    for (double value : {0.05, 0.1, 0.5, 2.0, 20.0})
+        h1.observe(value);
+    auto out = metrics.serialize();
+    BOOST_CHECK(out.find("# TYPE request_seconds histogram\n") != std::string::npos);
+    // buckets are cumulative, and the upper bound is included
+    BOOST_CHECK(out.find("request_seconds_bucket{stage_name=\"main\",le=\"0.1\"} 2\n")
+                != std::string::npos);
+    BOOST_CHECK(out.find("request_seconds_bucket{stage_name=\"main\",le=\"1\"} 3\n")
+                    != std::string::npos
+                || out.find("request_seconds_bucket{stage_name=\"main\",le=\"1.0\"} 3\n")
+                       != std::string::npos);
+    BOOST_CHECK(out.find("request_seconds_bucket{stage_name=\"main\",le=\"+Inf\"} 5\n")
+                != std::string::npos);
+    BOOST_CHECK(out.find("request_seconds_sum{stage_name=\"main\"} 22.65") != std::string::npos);
+    BOOST_CHECK(out.find("request_seconds_count{stage_name=\"main\"} 5\n") != std::string::npos);
+
+    auto& h2 = metrics.add_histogram("latency_seconds", "main", {"endpoint"}, {1});
+    h2.labels({"/a"}).observe(0.5);
+    BOOST_CHECK(metrics.serialize().find(
+                    "latency_seconds_bucket{stage_name=\"main\",endpoint=\"/a\",le=\"+Inf\"} 1\n")
+                != std::string::npos);
+}
+
+
+BOOST_AUTO_TEST_CASE(summaries) {
+    Metrics& metrics = Metrics::instance();
+
+    auto& s = metrics.add_summary("frame_seconds", "main", {0.5, 0.9});
+    BOOST_CHECK(
+        metrics.serialize().find("frame_seconds{stage_name=\"main\",quantile=\"0.5\"} NaN\n")
+        != std::string::npos);
+    for (int i = 0; i < 100; i++)
+        s.observe(i);
+    auto out = metrics.serialize();
+    BOOST_CHECK(out.find("# TYPE frame_seconds summary\n") != std::string::npos);
+    BOOST_CHECK(out.find("frame_seconds{stage_name=\"main\",quantile=\"0.5\"} 50.0")
+                != std::string::npos);
+    BOOST_CHECK(out.find("frame_seconds{stage_name=\"main\",quantile=\"0.9\"} 90.0")
+                != std::string::npos);
+    BOOST_CHECK(out.find("frame_seconds_sum{stage_name=\"main\"} 4950.0") != std::string::npos);
+    BOOST_CHECK(out.find("frame_seconds_count{stage_name=\"main\"} 100\n") != std::string::npos);
+}
+
+
+/*
+ * No updates get lost when many threads update the same metrics.
+ */
+BOOST_AUTO_TEST_CASE(concurrent_updates) {
+    Metrics& metrics = Metrics::instance();
+
+    auto& counter = metrics.add_counter("concurrent_total", "concurrent");
+    auto& histogram = metrics.add_histogram("concurrent_seconds", "concurrent", {0.5});
+    auto& labelled = metrics.add_counter("concurrent_labelled_total", "concurrent", {"thread"});
+
+    const int num_threads = 8, num_updates = 100000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < num_updates; i++) {
+                counter.inc();
+                histogram.observe(i % 2);
+                // creating the metrics races with other threads creating their own
+                labelled.labels({std::to_string(t % 4)}).inc();
+            }
+        });
+    }
+    // serializing at the same time is fine too
+    for (int i = 0; i < 10; i++)
+        metrics.serialize();
+    for (auto& thread : threads)
+        thread.join();
+
+    auto out = metrics.serialize();
+    BOOST_CHECK_EQUAL(counter.value(), num_threads * num_updates);
+    BOOST_CHECK(out.find(fmt::format("concurrent_total{{stage_name=\"concurrent\"}} {:d}\n",
+                                     num_threads * num_updates))
+                != std::string::npos);
+    BOOST_CHECK(out.find(fmt::format("concurrent_seconds_bucket{{stage_name=\"concurrent\","
+                                     "le=\"0.5\"}} {:d}\n",
+                                     num_threads * num_updates / 2))
+                != std::string::npos);
+    BOOST_CHECK(out.find(fmt::format("concurrent_seconds_count{{stage_name=\"concurrent\"}} {:d}\n",
+                                     num_threads * num_updates))
+                != std::string::npos);
+    for (int t = 0; t < 4; t++)
+        BOOST_CHECK_EQUAL(labelled.labels({std::to_string(t)}).value(), 2 * num_updates);
+
+    metrics.remove_stage_metrics("concurrent");
+}
+
+
+// What the metrics used to do: take a lock on every update
+struct lockedCounter {
+    void inc() {
+        std::lock_guard<std::mutex> lock(mutex);
+        value++;
+    }
+    std::mutex mutex;
+    uint64_t value = 0;
+};
+
+template<typename F>
+static double ns_per_op(int num_threads, int num_ops, F f) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++)
+        threads.emplace_back([&]() {
+            for (int i = 0; i < num_ops; i++)
+                f(i);
+        });
+    for (auto& thread : threads)
+        thread.join();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / num_ops;
+}
+
+/*
+ * Not a test as such, prints how long updates and a scrape take.
+ */
+BOOST_AUTO_TEST_CASE(benchmark) {
+    Metrics& metrics = Metrics::instance();
+
+    auto& counter = metrics.add_counter("bench_total", "bench");
+    auto& gauge = metrics.add_gauge("bench_gauge", "bench");
+    auto& histogram = metrics.add_histogram("bench_seconds", "bench", {0.001, 0.01, 0.1, 1, 10});
+    lockedCounter locked;
+
+    const int num_ops = 1000000;
+    for (int num_threads : {1, 4}) {
+        BOOST_TEST_MESSAGE(fmt::format(
+            "{:d} threads, ns per update and thread: mutex counter {:.1f}, counter {:.1f}, "
+            "gauge {:.1f}, histogram {:.1f}",
+            num_threads, ns_per_op(num_threads, num_ops, [&](int) { locked.inc(); }),
+            ns_per_op(num_threads, num_ops, [&](int) { counter.inc(); }),
+            ns_per_op(num_threads, num_ops, [&](int i) { gauge.set(i); }),
+            ns_per_op(num_threads, num_ops, [&](int i) { histogram.observe(i * 1e-5); })));
+    }
+    BOOST_CHECK_EQUAL(counter.value(), 5 * num_ops);
+
+    // A scrape of a lot of metrics, most of which don't change in between
+    auto& family = metrics.add_counter("bench_labelled_total", "bench", {"freq_id"});
+    for (int i = 0; i < 1024; i++)
+        family.labels({std::to_string(i)}).inc();
+    const int num_scrapes = 100;
+    auto start = std::chrono::steady_clock::now();
+    size_t size = 0;
+    for (int i = 0; i < num_scrapes; i++) {
+        family.labels({std::to_string(i)}).inc();
+        size += metrics.serialize().size();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    BOOST_TEST_MESSAGE(fmt::format("scrape of {:d} bytes: {:.1f} us", size / num_scrapes,
+                                   elapsed.count() / num_scrapes));
+
+    metrics.remove_stage_metrics("bench");
+}
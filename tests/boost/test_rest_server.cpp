@@ -0,0 +1,277 @@
+#define BOOST_TEST_MODULE "test_restServer"
+
+#include "errors.h"              // for __enable_syslog, _global_log_level
+#include "prometheusMetrics.hpp" // for Metrics
+#include "restClient.hpp"        // for restClient::restReply, restClient
+#include "restServer.hpp"        // for restServer, connectionInstance, HTTP_RESPONSE
+
+#include "json.hpp" // for json
+
+#include <arpa/inet.h>                       // for htons, inet_addr
+#include <atomic>                            // for atomic
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <chrono>                            // for milliseconds, steady_clock, duration
+#include <memory>                            // for unique_ptr
+#include <mutex>                             // for mutex, lock_guard
+#include <netinet/in.h>                      // for sockaddr_in
+#include <stdexcept>                         // for runtime_error
+#include <string>                            // for string
+#include <sys/socket.h>                      // for socket, connect, send, recv
+#include <thread>                            // for thread, sleep_for
+#include <unistd.h>                          // for close
+#include <vector>                            // for vector
+
+using kotekan::connectionInstance;
+using kotekan::HTTP_RESPONSE;
+using kotekan::restServer;
+using kotekan::restStream;
+using kotekan::prometheus::Metrics;
+
+using json = nlohmann::json;
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool request_ok(const std::string& endpoint, unsigned short port) {
+    return restClient::instance().make_request_blocking(endpoint, {}, "127.0.0.1", port).first;
+}
+
+struct ServerFixture {
+    ServerFixture() {
+        _global_log_level = 3;
+        __enable_syslog = 0;
+        static bool started = false;
+        if (!started) {
+            restServer::instance().start("127.0.0.1", 0, 4, 2);
+            started = true;
+        }
+        port = restServer::instance().port;
+    }
+
+    unsigned short port;
+};
+
+/*
+ * Many concurrent requests spread over the event loops all get their replies.
+ */
+BOOST_FIXTURE_TEST_CASE(concurrent_requests, ServerFixture) {
+    restServer::instance().register_get_callback("/echo", [](connectionInstance& conn) {
+        conn.send_json_reply({{"query", conn.get_query()}});
+    });
+    restServer::instance().register_get_callback(
+        "/echo_blocking",
+        [](connectionInstance& conn) { conn.send_json_reply({{"query", conn.get_query()}}); },
+        true);
+
+    std::atomic<int> num_ok(0);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < 16; i++) {
+        clients.emplace_back([&, i]() {
+            std::string endpoint = (i % 2 ? "/echo" : "/echo_blocking");
+            auto reply = restClient::instance().make_request_blocking(
+                endpoint + "?n=" + std::to_string(i), {}, "127.0.0.1", port);
+            if (reply.first && json::parse(reply.second)["query"]["n"] == std::to_string(i))
+                num_ok++;
+        });
+    }
+    for (auto& client : clients)
+        client.join();
+    BOOST_CHECK_EQUAL(num_ok, 16);
+
+    restServer::instance().remove_get_callback("/echo");
+    restServer::instance().remove_get_callback("/echo_blocking");
+}
+
+/*
+ * A slow blocking callback doesn't hold up other requests, and removing it waits for it.
+ */
+BOOST_FIXTURE_TEST_CASE(blocking_callbacks, ServerFixture) {
+    // BOOST_CHECK can't be used in threads...
+    std::atomic<bool> slow_running(false), slow_done(false), slow_ok(false);
+    restServer::instance().register_post_callback(
+        "/slow",
+        [&](connectionInstance& conn, json& request) {
+            slow_running = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(request["sleep_ms"].get<int>()));
+            slow_done = true;
+            conn.send_empty_reply(HTTP_RESPONSE::OK);
+        },
+        true);
+    restServer::instance().register_get_callback(
+        "/fast", [](connectionInstance& conn) { conn.send_empty_reply(HTTP_RESPONSE::OK); });
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread slow_client([&]() {
+        slow_ok = restClient::instance()
+                      .make_request_blocking("/slow", {{"sleep_ms", 1000}}, "127.0.0.1", port)
+                      .first;
+    });
+    while (!slow_running)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    auto reply = restClient::instance().make_request_blocking("/fast", {}, "127.0.0.1", port);
+    BOOST_CHECK(reply.first);
+    BOOST_CHECK(!slow_done);
+    BOOST_CHECK_LT(seconds_since(start), 0.9);
+
+    restServer::instance().remove_json_callback("/slow");
+    BOOST_CHECK(slow_done);
+    slow_client.join();
+    BOOST_CHECK(slow_ok);
+    restServer::instance().remove_get_callback("/fast");
+
+    reply = restClient::instance().make_request_blocking("/slow", {{"sleep_ms", 0}}, "127.0.0.1",
+                                                         port);
+    BOOST_CHECK(!reply.first);
+}
+
+/*
+ * A callback may remove itself, and failed blocking callbacks still reply.
+ */
+BOOST_FIXTURE_TEST_CASE(callback_edge_cases, ServerFixture) {
+    for (bool blocking : {false, true}) {
+        restServer::instance().register_get_callback(
+            "/once",
+            [](connectionInstance& conn) {
+                restServer::instance().remove_get_callback("/once");
+                conn.send_empty_reply(HTTP_RESPONSE::OK);
+            },
+            blocking);
+        BOOST_CHECK(request_ok("/once", port));
+        BOOST_CHECK(!request_ok("/once", port));
+    }
+
+    restServer::instance().register_get_callback(
+        "/throws", [](connectionInstance&) { throw std::runtime_error("oops"); }, true);
+    restServer::instance().register_get_callback("/no_reply", [](connectionInstance&) {}, true);
+    BOOST_CHECK(!request_ok("/throws", port));
+    BOOST_CHECK(!request_ok("/no_reply", port));
+    restServer::instance().remove_get_callback("/throws");
+    restServer::instance().remove_get_callback("/no_reply");
+}
+
+/*
+ * The request latency ends up in the per endpoint histogram.
+ */
+BOOST_FIXTURE_TEST_CASE(request_latency, ServerFixture) {
+    restServer::instance().register_get_callback("/latency", [](connectionInstance& conn) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        conn.send_empty_reply(HTTP_RESPONSE::OK);
+    });
+    for (int i = 0; i < 3; i++)
+        restClient::instance().make_request_blocking("/latency", {}, "127.0.0.1", port);
+    restServer::instance().remove_get_callback("/latency");
+
+    std::string metrics = Metrics::instance().serialize();
+    const std::string labels = "stage_name=\"rest_server\",endpoint=\"/latency\",method=\"GET\"";
+    BOOST_CHECK(metrics.find("# TYPE kotekan_rest_server_request_duration_seconds histogram")
+                != std::string::npos);
+    BOOST_CHECK(metrics.find("kotekan_rest_server_request_duration_seconds_bucket{" + labels
+                             + ",le=\"0.025\"} 0\n")
+                != std::string::npos);
+    BOOST_CHECK(metrics.find("kotekan_rest_server_request_duration_seconds_bucket{" + labels
+                             + ",le=\"+Inf\"} 3\n")
+                != std::string::npos);
+    BOOST_CHECK(metrics.find("kotekan_rest_server_request_duration_seconds_count{" + labels
+                             + "} 3\n")
+                != std::string::npos);
+}
+
+
+// A client reading the raw HTTP reply, as the restClient doesn't do streams
+static int open_stream(const std::string& endpoint, unsigned short port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+        throw std::runtime_error("Failed to connect");
+    std::string request = "GET " + endpoint + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    return fd;
+}
+
+static std::string read_until(int fd, const std::string& end) {
+    std::string reply;
+    char buf[4096];
+    while (reply.find(end) == std::string::npos) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0)
+            break;
+        reply.append(buf, n);
+    }
+    return reply;
+}
+
+/*
+ * Streams outlive their callback and send chunks from any thread.
+ */
+BOOST_FIXTURE_TEST_CASE(streams, ServerFixture) {
+    std::mutex streams_lock;
+    std::vector<std::unique_ptr<restStream>> streams;
+    for (bool blocking : {false, true}) {
+        restServer::instance().register_get_callback(
+            blocking ? "/stream_blocking" : "/stream",
+            [&](connectionInstance& conn) {
+                std::lock_guard<std::mutex> lock(streams_lock);
+                streams.push_back(conn.send_stream("text/plain", 1024 * 1024));
+            },
+            blocking);
+    }
+
+    for (std::string endpoint : {"/stream", "/stream_blocking"}) {
+        int fd = open_stream(endpoint, port);
+        while (true) {
+            std::lock_guard<std::mutex> lock(streams_lock);
+            if (!streams.empty())
+                break;
+        }
+        std::unique_ptr<restStream> stream = std::move(streams.back());
+        streams.clear();
+
+        std::thread producer([&]() {
+            for (std::string chunk : {"first", "second", "third"})
+                stream->send_chunk(chunk);
+            stream->close();
+        });
+        std::string reply = read_until(fd, "\r\n0\r\n\r\n");
+        producer.join();
+
+        BOOST_CHECK(reply.find("HTTP/1.1 200 OK") == 0);
+        BOOST_CHECK(reply.find("Transfer-Encoding: chunked") != std::string::npos);
+        BOOST_CHECK(reply.find("Content-Type: text/plain") != std::string::npos);
+        BOOST_CHECK(reply.find("\r\n5\r\nfirst\r\n6\r\nsecond\r\n5\r\nthird\r\n0\r\n\r\n")
+                    != std::string::npos);
+        BOOST_CHECK(stream->is_closed());
+        BOOST_CHECK(!stream->send_chunk("late"));
+        close(fd);
+    }
+
+    // A client which doesn't read gets chunks dropped, and one which disconnects closes the stream
+    int fd = open_stream("/stream", port);
+    while (true) {
+        std::lock_guard<std::mutex> lock(streams_lock);
+        if (!streams.empty())
+            break;
+    }
+    std::unique_ptr<restStream> stream = std::move(streams.back());
+    std::string chunk(100000, 'x');
+    for (int i = 0; i < 200; i++)
+        stream->send_chunk(chunk);
+    BOOST_CHECK(stream->num_dropped() > 0);
+    BOOST_CHECK(!stream->is_closed());
+
+    close(fd);
+    auto start = std::chrono::steady_clock::now();
+    while (!stream->is_closed() && seconds_since(start) < 5) {
+        stream->send_chunk("ping");
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_CHECK(stream->is_closed());
+    stream.reset();
+
+    restServer::instance().remove_get_callback("/stream");
+    restServer::instance().remove_get_callback("/stream_blocking");
+}
@@ -10,9 +10,10 @@
 
 #include <atomic>                            // for atomic, __atomic_base
 #include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_PP_BOOL_2, BOOST_TEST...
-#include <chrono>                            // for milliseconds
+#include <chrono>                            // for milliseconds, seconds, steady_clock
 #include <cstdint>                           // for uint32_t
 #include <functional>                        // for _Placeholder, _Bind_helper<>::type, bind
+#include <future>                            // for future, future_status
 #include <string>                            // for allocator, basic_string, string, operator!=
 #include <thread>                            // for sleep_for
 #include <vector>                            // for vector
@@ -275,3 +276,106 @@ BOOST_FIXTURE_TEST_CASE(_test_restclient_text_reply_blocking, TestContext) {
     json js = json::parse(reply.second);
     BOOST_CHECK(js["test"] == "failed");
 }
+
+BOOST_FIXTURE_TEST_CASE(_test_restclient_async, TestContext) {
+    _global_log_level = 4;
+    __enable_syslog = 0;
+
+    int port = restServer::instance().port;
+
+    json request, bad_request;
+    request["array"] = {1, 2, 3};
+    request["flag"] = true;
+    bad_request["bla"] = 0;
+
+    TestContext::init(
+        std::bind(&TestContext::callback_text, this, std::placeholders::_1, std::placeholders::_2),
+        "/test_restclient_json");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    /* Test a single request with a future */
+
+    auto reply = restClient::instance().make_request_async("/test_restclient_json", request,
+                                                           "127.0.0.1", port);
+    BOOST_CHECK(reply.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    restClient::restReply r = reply.get();
+    BOOST_CHECK(r.first == true);
+    BOOST_CHECK(r.second == "this is a test");
+
+    /* Test a batch of requests, which should reuse the pooled connections */
+
+    size_t num_opened = restClient::instance().num_connections_opened();
+    std::vector<restClient::restRequest> requests;
+    for (int i = 0; i < 50; i++) {
+        requests.push_back({"/test_restclient_json", i % 5 ? request : bad_request, "127.0.0.1",
+                            (unsigned short)port});
+    }
+    auto replies = restClient::instance().make_requests(requests);
+    BOOST_CHECK(replies.size() == requests.size());
+    for (size_t i = 0; i < replies.size(); i++) {
+        BOOST_CHECK(replies[i].wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        r = replies[i].get();
+        BOOST_CHECK(r.first == (i % 5 != 0));
+        BOOST_CHECK(r.second == (i % 5 ? "this is a test" : ""));
+    }
+    BOOST_CHECK(cb_called_count == 51);
+    BOOST_CHECK(restClient::instance().num_connections_opened() - num_opened
+                <= restClient::max_connections_per_host);
+    BOOST_TEST_MESSAGE(fmt::format(fmt("Opened {:d} connection(s) for {:d} requests."),
+                                   restClient::instance().num_connections_opened() - num_opened,
+                                   requests.size()));
+
+    /* Test an unreachable server */
+
+    reply = restClient::instance().make_request_async("/test_restclient_json", request,
+                                                      "127.0.0.1", 1);
+    BOOST_CHECK(reply.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    r = reply.get();
+    BOOST_CHECK(r.first == false);
+    BOOST_CHECK(r.second.empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(_test_restclient_timeout_retry, TestContext) {
+    _global_log_level = 4;
+    __enable_syslog = 0;
+
+    int port = restServer::instance().port;
+
+    json request;
+    request["flag"] = true;
+
+    // Only reply quickly to every second request
+    restServer::instance().register_post_callback(
+        "/test_restclient_slow",
+        [](connectionInstance& con, json&) {
+            if (cb_called_count++ % 2 == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+            con.send_text_reply("slow");
+        },
+        true);
+    cb_called_count = 0;
+
+    /* Test a request timing out */
+
+    auto start = std::chrono::steady_clock::now();
+    restClient::restReply r = restClient::instance().make_request_blocking(
+        "/test_restclient_slow", request, "127.0.0.1", port, 0, 1);
+    BOOST_CHECK(r.first == false);
+    BOOST_CHECK(r.second.empty());
+    BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2000));
+
+    // Let the server finish the slow request
+    std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+
+    /* Test a request succeeding after timing out once */
+
+    cb_called_count = 0;
+    r = restClient::instance().make_request_blocking("/test_restclient_slow", request, "127.0.0.1",
+                                                     port, 1, 1);
+    BOOST_CHECK(r.first == true);
+    BOOST_CHECK(r.second == "slow");
+    BOOST_CHECK(cb_called_count == 2);
+
+    // Let the server finish the slow request before shutting down
+    std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+}
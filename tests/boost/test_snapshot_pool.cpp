@@ -0,0 +1,115 @@
+#define BOOST_TEST_MODULE "test_SnapshotPool"
+
+#include "SnapshotPool.hpp" // for SnapshotPool
+
+#include <atomic>                            // for atomic
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <stdint.h>                          // for uint64_t, uint8_t
+#include <string.h>                          // for memcpy
+#include <thread>                            // for thread
+#include <vector>                            // for vector
+
+BOOST_AUTO_TEST_CASE(latest) {
+    SnapshotPool pool(3, 8, 4);
+    BOOST_CHECK(!pool.latest());
+
+    for (uint64_t seq = 0; seq < 5; seq++) {
+        SnapshotPool::snapshot* s = pool.begin_write();
+        BOOST_REQUIRE(s != nullptr);
+        BOOST_CHECK_EQUAL(s->data.size(), 8);
+        BOOST_CHECK_EQUAL(s->metadata.size(), 4);
+        s->seq = seq;
+        pool.publish(s);
+
+        auto r = pool.latest();
+        BOOST_CHECK(r);
+        BOOST_CHECK_EQUAL(r->seq, seq);
+    }
+    BOOST_CHECK_EQUAL(pool.published(), 5);
+
+    // An aborted write doesn't change the latest snapshot
+    SnapshotPool::snapshot* s = pool.begin_write();
+    s->seq = 100;
+    pool.abort_write(s);
+    BOOST_CHECK_EQUAL(pool.latest()->seq, 4);
+}
+
+/*
+ * The writer never gets a snapshot which is being read, and gives up rather than waiting.
+ */
+BOOST_AUTO_TEST_CASE(pinned) {
+    SnapshotPool pool(2, 8);
+
+    SnapshotPool::snapshot* s = pool.begin_write();
+    s->seq = 1;
+    pool.publish(s);
+    auto first = pool.latest();
+
+    s = pool.begin_write();
+    BOOST_REQUIRE(s != nullptr);
+    s->seq = 2;
+    pool.publish(s);
+    auto second = pool.latest();
+    BOOST_CHECK_EQUAL(second->seq, 2);
+
+    // Both are pinned
+    BOOST_CHECK(pool.begin_write() == nullptr);
+    BOOST_CHECK_EQUAL(first->seq, 1);
+
+    first = SnapshotPool::reader();
+    s = pool.begin_write();
+    BOOST_CHECK(s != nullptr);
+    pool.abort_write(s);
+}
+
+/*
+ * Readers always see a whole frame while the writer keeps going.
+ */
+BOOST_AUTO_TEST_CASE(concurrent) {
+    const size_t size = 4096;
+    const uint64_t num_frames = 20000;
+    SnapshotPool pool(4, size * sizeof(uint64_t));
+
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0), reads(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; i++) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                auto r = pool.latest();
+                if (!r)
+                    continue;
+                const uint64_t* data = (const uint64_t*)r->data.data();
+                for (size_t j = 0; j < size; j++) {
+                    if (data[j] != r->seq) {
+                        torn++;
+                        break;
+                    }
+                }
+                reads++;
+            }
+        });
+    }
+
+    uint64_t written = 0;
+    std::vector<uint64_t> frame(size);
+    for (uint64_t seq = 0; seq < num_frames; seq++) {
+        SnapshotPool::snapshot* s = pool.begin_write();
+        if (s == nullptr)
+            continue;
+        for (auto& v : frame)
+            v = seq;
+        memcpy(s->data.data(), frame.data(), size * sizeof(uint64_t));
+        s->seq = seq;
+        pool.publish(s);
+        written++;
+    }
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    BOOST_CHECK_EQUAL(torn, 0);
+    BOOST_CHECK(reads > 0);
+    // With more snapshots than readers plus one, no frame is skipped
+    BOOST_CHECK_EQUAL(written, num_frames);
+}
@@ -0,0 +1,205 @@
+/*
+ * Boost tests for UdpTransmitter, sending over the loopback interface
+ */
+#define BOOST_TEST_MODULE "test_UdpTransmitter"
+
+#include "Config.hpp"            // for Config
+#include "UdpTransmitter.hpp"    // for UdpTransmitter
+#include "prometheusMetrics.hpp" // for Metrics
+
+#include "json.hpp" // for json
+
+#include <algorithm>                         // for equal
+#include <arpa/inet.h>                       // for htonl, ntohs
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <netinet/in.h>                      // for sockaddr_in, IPPROTO_UDP, INADDR_LOOPBACK
+#include <stdint.h>                          // for uint8_t, uint64_t
+#include <string.h>                          // for memset
+#include <string>                            // for string, to_string
+#include <sys/socket.h>                      // for socket, bind, recv, setsockopt, AF_INET
+#include <sys/time.h>                        // for timeval
+#include <unistd.h>                          // for close
+#include <vector>                            // for vector
+
+using kotekan::Config;
+using kotekan::prometheus::Metrics;
+
+/*
+ * A UDP socket on the loopback interface to receive the packets.
+ */
+struct Receiver {
+    Receiver() {
+        fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        BOOST_REQUIRE(fd >= 0);
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        BOOST_REQUIRE(bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+        socklen_t len = sizeof(addr);
+        BOOST_REQUIRE(getsockname(fd, (struct sockaddr*)&addr, &len) == 0);
+
+        int rcvbuf = 16 * 1024 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        struct timeval tv = {1, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+
+    ~Receiver() {
+        close(fd);
+    }
+
+    // Receive the next packet, empty on timeout
+    std::vector<uint8_t> recv_packet() {
+        std::vector<uint8_t> packet(65536);
+        ssize_t len = recv(fd, packet.data(), packet.size(), 0);
+        packet.resize(len > 0 ? len : 0);
+        return packet;
+    }
+
+    int fd;
+    sockaddr_in addr;
+};
+
+struct Sender {
+    Sender() {
+        fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        BOOST_REQUIRE(fd >= 0);
+    }
+
+    ~Sender() {
+        close(fd);
+    }
+
+    int fd;
+};
+
+static void configure(Config& config, const std::string& name, nlohmann::json stage_config) {
+    stage_config["log_level"] = "warn";
+    config.update_config({{name.substr(1), stage_config}});
+}
+
+static std::vector<uint8_t> make_packets(size_t num, size_t size) {
+    std::vector<uint8_t> data(num * size);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (i / size + i) % 251;
+    return data;
+}
+
+static bool packet_matches(const std::vector<uint8_t>& packet, const std::vector<uint8_t>& data,
+                           size_t ind, size_t size) {
+    return packet.size() == size
+           && std::equal(packet.begin(), packet.end(), data.begin() + ind * size);
+}
+
+/*
+ * Packets arrive complete and in order, and are counted per destination.
+ */
+BOOST_AUTO_TEST_CASE(batched) {
+    const std::string name = "/batched";
+    Config config;
+    configure(config, name, {{"tx_batch_size", 8}});
+    Receiver receiver;
+    Sender sender;
+
+    const size_t num = 21, size = 1000;
+    auto data = make_packets(num, size);
+    {
+        UdpTransmitter tx(config, name);
+        size_t dest = tx.add_destination(tx.add_socket(sender.fd), receiver.addr);
+        for (size_t i = 0; i < num; i++)
+            tx.send(dest, &data[i * size], size);
+        tx.flush();
+    }
+
+    for (size_t i = 0; i < num; i++)
+        BOOST_CHECK(packet_matches(receiver.recv_packet(), data, i, size));
+
+    std::string metrics = Metrics::instance().serialize();
+    std::string label =
+        "{stage_name=\"" + name + "\",destination=\"127.0.0.1:"
+        + std::to_string(ntohs(receiver.addr.sin_port)) + "\"}";
+    BOOST_CHECK(metrics.find("kotekan_udp_tx_packets_total" + label + " 21\n")
+                != std::string::npos);
+    BOOST_CHECK(metrics.find("kotekan_udp_tx_bytes_total" + label + " 21000")
+                != std::string::npos);
+    BOOST_CHECK(metrics.find("kotekan_udp_tx_errors_total" + label + " 0\n") != std::string::npos);
+    Metrics::instance().remove_stage_metrics(name);
+}
+
+/*
+ * Packets are not sent before their transmit time, and late ones are counted.
+ */
+BOOST_AUTO_TEST_CASE(paced) {
+    const std::string name = "/paced";
+    Config config;
+    // Generous threshold, so only the overdue packet counts as late on a busy machine
+    configure(config, name, {{"tx_batch_size", 4}, {"tx_late_threshold", 50000000}});
+    Receiver receiver;
+    Sender sender;
+
+    const size_t num = 10, size = 100;
+    const uint64_t spacing = 2000000;
+    auto data = make_packets(num, size);
+    {
+        UdpTransmitter tx(config, name);
+        size_t dest = tx.add_destination(tx.add_socket(sender.fd), receiver.addr);
+
+        // One packet that is long overdue
+        uint64_t start = UdpTransmitter::now();
+        tx.send(dest, &data[0], size, start - 1000000000);
+        for (size_t i = 1; i < num; i++)
+            tx.send(dest, &data[i * size], size, start + i * spacing);
+        tx.flush();
+        BOOST_CHECK(UdpTransmitter::now() - start >= (num - 1) * spacing);
+    }
+
+    for (size_t i = 0; i < num; i++)
+        BOOST_CHECK(packet_matches(receiver.recv_packet(), data, i, size));
+
+    std::string metrics = Metrics::instance().serialize();
+    std::string label =
+        "{stage_name=\"" + name + "\",destination=\"127.0.0.1:"
+        + std::to_string(ntohs(receiver.addr.sin_port)) + "\"}";
+    BOOST_CHECK(metrics.find("kotekan_udp_tx_late_packets_total" + label + " 1\n")
+                != std::string::npos);
+    Metrics::instance().remove_stage_metrics(name);
+}
+
+/*
+ * Runs of packets sent with segmentation offload arrive as individual packets, whether or not
+ * the kernel supports it.
+ */
+BOOST_AUTO_TEST_CASE(segments) {
+    const std::string name = "/segments";
+    Config config;
+    configure(config, name, {{"tx_gso", true}});
+    Receiver receiver;
+    Sender sender;
+
+    const size_t num = 100, size = 1200;
+    auto data = make_packets(num, size);
+    {
+        UdpTransmitter tx(config, name);
+        size_t dest = tx.add_destination(tx.add_socket(sender.fd), receiver.addr);
+        tx.send_segments(dest, data.data(), size, num);
+        tx.flush();
+    }
+
+    for (size_t i = 0; i < num; i++)
+        BOOST_CHECK(packet_matches(receiver.recv_packet(), data, i, size));
+    BOOST_CHECK(receiver.recv_packet().empty());
+    Metrics::instance().remove_stage_metrics(name);
+}
+
+/*
+ * An unknown pacing mode is refused.
+ */
+BOOST_AUTO_TEST_CASE(bad_pacing) {
+    const std::string name = "/bad_pacing";
+    Config config;
+    configure(config, name, {{"tx_pacing", "warp"}});
+    BOOST_CHECK_THROW(UdpTransmitter(config, name), std::runtime_error);
+    Metrics::instance().remove_stage_metrics(name);
+}
@@ -0,0 +1,175 @@
+/*
+ * Boost tests for VisSharedMemReader
+ */
+#define BOOST_TEST_MODULE "test_VisSharedMemReader"
+
+#include "VisSharedMemReader.hpp" // for VisSharedMemReader, VisSharedMemStructure
+
+#include <algorithm>                         // for all_of
+#include <atomic>                            // for atomic, atomic_thread_fence, atomic_bool
+#include <boost/test/included/unit_test.hpp> // for BOOST_PP_IIF_1, BOOST_CHECK, BOOST_PP_BOOL_2
+#include <fcntl.h>                           // for O_CREAT, O_RDWR
+#include <stdexcept>                         // for runtime_error
+#include <stdint.h>                          // for uint8_t, uint64_t, int64_t
+#include <string.h>                          // for memcpy, memset
+#include <string>                            // for string, to_string
+#include <sys/mman.h>                        // for mmap, munmap, shm_open, shm_unlink
+#include <sys/stat.h>                        // for S_IRUSR, S_IWUSR
+#include <thread>                            // for thread
+#include <unistd.h>                          // for ftruncate, close, getpid
+#include <vector>                            // for vector
+
+/*
+ * A minimal writer following the same protocol as VisSharedMemWriter.
+ */
+struct TestWriter {
+    TestWriter(const std::string& name, const VisSharedMemStructure& rbs) : name(name), rbs(rbs) {
+        size = VisSharedMemReader::total_size(rbs);
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+        BOOST_REQUIRE(fd != -1);
+        BOOST_REQUIRE(ftruncate(fd, size) == 0);
+        addr = (uint8_t*)mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        BOOST_REQUIRE(addr != MAP_FAILED);
+
+        record = (std::atomic<int64_t>*)(addr + VisSharedMemReader::access_record_offset());
+        generation = (std::atomic<uint64_t>*)(addr + VisSharedMemReader::generation_offset(rbs));
+        for (size_t i = 0; i < rbs.ntime * rbs.nfreq; i++)
+            record[i] = VisSharedMemReader::invalid;
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(addr + sizeof(uint64_t), &rbs, sizeof(rbs));
+    }
+
+    ~TestWriter() {
+        munmap(addr, size);
+        shm_unlink(name.c_str());
+    }
+
+    // Fill the metadata and data of a slot with `value`
+    void write(size_t slot, int64_t fpga_seq, uint8_t value) {
+        uint8_t* frame = addr + VisSharedMemReader::data_offset(rbs) + slot * rbs.frame_size;
+        uint64_t gen = generation[slot].load(std::memory_order_relaxed);
+        generation[slot].store(gen + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        record[slot].store(VisSharedMemReader::invalid, std::memory_order_relaxed);
+        memset(frame + VisSharedMemReader::valid_size, value, rbs.metadata_size + rbs.data_size);
+        record[slot].store(fpga_seq, std::memory_order_relaxed);
+        generation[slot].store(gen + 2, std::memory_order_release);
+    }
+
+    std::string name;
+    VisSharedMemStructure rbs;
+    size_t size;
+    uint8_t* addr;
+    std::atomic<int64_t>* record;
+    std::atomic<uint64_t>* generation;
+};
+
+static std::string shm_name(const std::string& test) {
+    return "/test_vis_shared_mem_reader_" + test + "_" + std::to_string(getpid());
+}
+
+/*
+ * Read back what was written, and check the layout is picked up from the structured data.
+ */
+BOOST_AUTO_TEST_CASE(read_back) {
+    VisSharedMemStructure rbs = {4, 3, 4096, 100, 1000};
+    TestWriter writer(shm_name("read_back"), rbs);
+
+    VisSharedMemReader reader(writer.name);
+    BOOST_CHECK(reader.structure().ntime == 4);
+    BOOST_CHECK(reader.structure().nfreq == 3);
+    BOOST_CHECK(reader.structure().frame_size == 4096);
+
+    std::vector<uint8_t> meta(rbs.metadata_size), data(rbs.data_size);
+
+    // Empty slots
+    BOOST_CHECK(reader.read_frame(1, 2, meta.data(), data.data()) == VisSharedMemReader::invalid);
+
+    writer.write(1 * 3 + 2, 1234, 7);
+    BOOST_CHECK(reader.read_frame(1, 2, meta.data(), data.data()) == 1234);
+    BOOST_CHECK(std::all_of(meta.begin(), meta.end(), [](uint8_t x) { return x == 7; }));
+    BOOST_CHECK(std::all_of(data.begin(), data.end(), [](uint8_t x) { return x == 7; }));
+
+    auto record = reader.access_record();
+    BOOST_CHECK(record.size() == 12);
+    BOOST_CHECK(record[5] == 1234);
+    BOOST_CHECK(record[0] == VisSharedMemReader::invalid);
+
+    BOOST_CHECK_THROW(reader.read_frame(4, 0, nullptr, nullptr), std::out_of_range);
+}
+
+/*
+ * A slot that the writer is in the middle of is never returned.
+ */
+BOOST_AUTO_TEST_CASE(busy_slot) {
+    VisSharedMemStructure rbs = {2, 2, 4096, 16, 16};
+    TestWriter writer(shm_name("busy_slot"), rbs);
+    VisSharedMemReader reader(writer.name);
+
+    writer.write(0, 42, 1);
+    BOOST_CHECK(reader.read_frame(0, 0, nullptr, nullptr) == 42);
+
+    // Leave the generation odd, as a writer in the middle of a copy would
+    writer.generation[0]++;
+    BOOST_CHECK(reader.read_frame(0, 0, nullptr, nullptr) == VisSharedMemReader::invalid);
+    writer.generation[0]++;
+    BOOST_CHECK(reader.read_frame(0, 0, nullptr, nullptr) == 42);
+}
+
+/*
+ * A region whose structure doesn't match its size is refused.
+ */
+BOOST_AUTO_TEST_CASE(bad_structure) {
+    BOOST_CHECK_THROW(VisSharedMemReader(shm_name("does_not_exist")), std::runtime_error);
+
+    VisSharedMemStructure rbs = {2, 2, 4096, 16, 16};
+    TestWriter writer(shm_name("bad_structure"), rbs);
+    rbs.nfreq = 3;
+    memcpy(writer.addr + sizeof(uint64_t), &rbs, sizeof(rbs));
+    BOOST_CHECK_THROW(VisSharedMemReader reader(writer.name), std::runtime_error);
+}
+
+/*
+ * Readers copying while a writer keeps overwriting the same slots must never see a torn frame.
+ */
+BOOST_AUTO_TEST_CASE(concurrent_readers) {
+    VisSharedMemStructure rbs = {2, 2, 1 << 16, 64, (1 << 16) - 128};
+    TestWriter writer(shm_name("concurrent"), rbs);
+
+    std::atomic_bool stop(false);
+    std::thread write_thread([&]() {
+        for (int64_t seq = 0; !stop; seq++)
+            writer.write(seq % 4, seq, seq % 256);
+    });
+
+    std::vector<std::thread> readers;
+    std::atomic<size_t> good_reads(0);
+    std::atomic<size_t> torn_reads(0);
+    for (int r = 0; r < 3; r++) {
+        readers.emplace_back([&]() {
+            VisSharedMemReader reader(writer.name);
+            std::vector<uint8_t> meta(rbs.metadata_size), data(rbs.data_size);
+            for (int i = 0; i < 2000; i++) {
+                int64_t seq = reader.read_frame(i % 2, (i / 2) % 2, meta.data(), data.data());
+                if (seq == VisSharedMemReader::invalid)
+                    continue;
+                uint8_t expected = seq % 256;
+                auto match = [expected](uint8_t x) { return x == expected; };
+                if (std::all_of(meta.begin(), meta.end(), match)
+                    && std::all_of(data.begin(), data.end(), match))
+                    good_reads++;
+                else
+                    torn_reads++;
+            }
+        });
+    }
+
+    for (auto& t : readers)
+        t.join();
+    stop = true;
+    write_thread.join();
+
+    BOOST_CHECK(torn_reads == 0);
+    BOOST_CHECK(good_reads > 0);
+}
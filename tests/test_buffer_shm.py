@@ -0,0 +1,98 @@
+# === Start Python 2/3 compatibility
+from __future__ import absolute_import, division, print_function, unicode_literals
+from future.builtins import *  # noqa  pylint: disable=W0401, W0614
+from future.builtins.disabled import *  # noqa  pylint: disable=W0401, W0614
+
+# === End Python 2/3 compatibility
+
+import concurrent.futures
+import os
+
+import pytest
+
+from kotekan import runner
+
+
+params_kotekan = {
+    "num_elements": 5,
+    "num_ev": 0,
+    "total_frames": 8,
+    "cadence": 10.0,
+    "wait": True,
+    "mode": "default",
+    "buffer_depth": 16,
+    "freq_ids": list(range(1)),
+    "dataset_manager": {"use_dataset_broker": False},
+}
+
+
+# By default the ring has as many slots as the buffers have frames, with fewer
+# the receiver has to hand slots back before its buffer fills up
+@pytest.mark.serial
+@pytest.mark.parametrize("num_slots", [None, 2])
+def test_send_receive(tmpdir_factory, num_slots):
+
+    shm_name = "/kotekan_test_buffer_shm_%i" % os.getpid()
+
+    # Run kotekan bufferShmRecv
+    tmpdir = tmpdir_factory.mktemp("writer")
+    write_buffer = runner.DumpVisBuffer(str(tmpdir))
+
+    # the plan is: wait 5s and then kill it
+    rest_commands = [("wait", 5, None), ("get", "kill", None)]
+
+    receiver = runner.KotekanStageTester(
+        "bufferShmRecv",
+        {"shm_name": shm_name},
+        None,
+        write_buffer,
+        params_kotekan,
+        rest_commands=rest_commands,
+    )
+    receiver._stages["bufferShmRecv_test"]["buf"] = receiver._stages[
+        "bufferShmRecv_test"
+    ]["out_buf"]
+
+    # Run kotekan bufferShmRecv in another thread
+    with concurrent.futures.ThreadPoolExecutor() as executor:
+        future_receiver = executor.submit(receiver.run)
+
+        # The sender creates the ring right away, the receiver keeps retrying to
+        # attach until it's there. The sender removes the ring again when it
+        # exits, so give the receiver time to attach before sending frames.
+        fakevis_buffer = runner.FakeVisBuffer(
+            num_frames=params_kotekan["total_frames"],
+            mode=params_kotekan["mode"],
+            freq_ids=params_kotekan["freq_ids"],
+            sleep_before=2,
+            wait=False,
+        )
+        send_config = {"shm_name": shm_name, "drop_frames": False}
+        if num_slots is not None:
+            send_config["num_slots"] = num_slots
+        sender = runner.KotekanStageTester(
+            "bufferShmSend",
+            send_config,
+            fakevis_buffer,
+            None,
+            params_kotekan,
+        )
+        sender._stages["bufferShmSend_test"]["buf"] = sender._stages[
+            "bufferShmSend_test"
+        ]["in_buf"]
+
+        # run kotekan bufferShmSend
+        sender.run()
+
+        # wait for kotekan bufferShmRecv to finish
+        future_receiver.result(timeout=7)
+
+    assert sender.return_code == 0
+    assert receiver.return_code == 0
+    vis_data = write_buffer.load()
+
+    assert len(vis_data) == params_kotekan["total_frames"]
+
+    # The frames point into the ring, check the data still goes with its metadata
+    for frame in vis_data:
+        assert frame.vis[0].real == frame.metadata.fpga_seq
@@ -34,7 +34,12 @@ params_kotekan = {
 
 
 @pytest.mark.serial
-def test_send_receive(tmpdir_factory):
+@pytest.mark.parametrize(
+    "send_config",
+    [{}, {"num_connections": 3, "zero_copy": True}],
+    ids=["single", "striped_zero_copy"],
+)
+def test_send_receive(tmpdir_factory, send_config):
 
     # Run kotekan bufferRecv
     tmpdir = tmpdir_factory.mktemp("writer")
@@ -72,7 +77,7 @@ def test_send_receive(tmpdir_factory):
             wait=False,
         )
         sender = runner.KotekanStageTester(
-            "bufferSend", {}, fakevis_buffer, None, params_kotekan
+            "bufferSend", send_config, fakevis_buffer, None, params_kotekan
         )
 
         # TODO: network buffer processes should use in_buf and out_buf to please the test framework
@@ -91,3 +96,69 @@ def test_send_receive(tmpdir_factory):
     vis_data = write_buffer.load()
 
     assert len(vis_data) == params_kotekan["total_frames"]
+
+
+@pytest.mark.serial
+def test_fan_out(tmpdir_factory):
+
+    ports = [11024, 11025]
+    write_buffers = []
+    receivers = []
+    for port in ports:
+        tmpdir = tmpdir_factory.mktemp("writer_%i" % port)
+        write_buffer = runner.DumpVisBuffer(str(tmpdir))
+        receiver = runner.KotekanStageTester(
+            "bufferRecv",
+            {"listen_port": port},
+            None,
+            write_buffer,
+            params_kotekan,
+            rest_commands=[("wait", 5, None), ("get", "kill", None)],
+        )
+        receiver._stages["bufferRecv_test"]["buf"] = receiver._stages[
+            "bufferRecv_test"
+        ]["out_buf"]
+        write_buffers.append(write_buffer)
+        receivers.append(receiver)
+
+    # Two receivers that get every frame, and one that never comes up and
+    # mustn't hold up the others
+    destinations = {
+        "port_%i" % port: {"server_port": port, "drop_frames": False}
+        for port in ports
+    }
+    destinations["down"] = {"server_port": 11026, "drop_frames": True}
+
+    with concurrent.futures.ThreadPoolExecutor() as executor:
+        future_receivers = [executor.submit(r.run) for r in receivers]
+
+        # Wait for them to start so the sender doesn't drop frames
+        time.sleep(1)
+
+        fakevis_buffer = runner.FakeVisBuffer(
+            num_frames=params_kotekan["total_frames"],
+            mode=params_kotekan["mode"],
+            freq_ids=params_kotekan["freq_ids"],
+            sleep_before=2,
+            wait=False,
+        )
+        sender = runner.KotekanStageTester(
+            "bufferSend",
+            {"destinations": destinations},
+            fakevis_buffer,
+            None,
+            params_kotekan,
+        )
+        sender._stages["bufferSend_test"]["buf"] = sender._stages["bufferSend_test"][
+            "in_buf"
+        ]
+
+        sender.run()
+
+        for future in future_receivers:
+            future.result(timeout=7)
+
+    assert sender.return_code == 0
+    for receiver, write_buffer in zip(receivers, write_buffers):
+        assert receiver.return_code == 0
+        assert len(write_buffer.load()) == params_kotekan["total_frames"]
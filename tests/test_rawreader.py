@@ -0,0 +1,245 @@
+# === Start Python 2/3 compatibility
+from __future__ import absolute_import, division, print_function, unicode_literals
+from future.builtins import *  # noqa  pylint: disable=W0401, W0614
+from future.builtins.disabled import *  # noqa  pylint: disable=W0401, W0614
+
+# === End Python 2/3 compatibility
+
+import glob
+import os
+import re
+
+import pytest
+import numpy as np
+
+from kotekan import visbuffer
+from kotekan import runner
+
+writer_params = {
+    "num_elements": 4,
+    "num_ev": 2,
+    "cadence": 5.0,
+    "total_frames": 6,
+    "freq": [3, 777, 554],
+    "chunk_size": [2, 6, 3],
+    "dataset_manager": {"use_dataset_broker": False},
+}
+
+# The frame data in vis files isn't aligned, so they can't be read with "zero_copy"
+read_modes = ["mmap", "pread"]
+
+# A file big enough to measure the rate frames are replayed at (~0.5 GB)
+bench_params = dict(
+    writer_params,
+    num_elements=128,
+    total_frames=128,
+    freq=list(range(32)),
+    chunk_size=[32, 8256, 16],
+)
+
+
+def write_raw(tmpdir, file_length=None, params=writer_params):
+    """Write FakeVis frames to raw files and return the files written."""
+
+    fakevis_buffer = runner.FakeVisBuffer(
+        freq_ids=params["freq"],
+        num_frames=params["total_frames"],
+        cadence=params["cadence"],
+    )
+
+    params = params.copy()
+    params["root_path"] = tmpdir
+    if file_length is not None:
+        params["file_length"] = file_length
+
+    test = runner.KotekanStageTester(
+        "VisWriter",
+        {"node_mode": False, "file_type": "raw"},
+        fakevis_buffer,
+        None,
+        params,
+    )
+
+    test.run()
+
+    files = sorted(glob.glob(tmpdir + "/20??????T??????Z_*_corr/*.meta"))
+    return [os.path.splitext(f)[0] for f in files]
+
+
+@pytest.fixture(scope="module")
+def raw_file(tmpdir_factory):
+
+    files = write_raw(str(tmpdir_factory.mktemp("raw")))
+    assert len(files) == 1
+
+    yield files[0]
+
+
+@pytest.fixture(scope="module")
+def split_files(tmpdir_factory):
+
+    # Half the frames in each file
+    files = write_raw(
+        str(tmpdir_factory.mktemp("split")), writer_params["total_frames"] // 2
+    )
+    assert len(files) == 2
+
+    yield files
+
+
+def raw_buffer(infile, read_mode, chunk_size=writer_params["chunk_size"]):
+    """Get a buffer replaying raw files in a read mode."""
+
+    return runner.ReadRawBuffer(
+        infile,
+        chunk_size,
+        extra_config={
+            "read_mode": read_mode,
+            "update_dataset_id": False,
+            # Exit kotekan once all the data is read
+            "sleep_time": 0.5,
+        },
+    )
+
+
+def read_raw(infile, tmpdir, read_mode):
+    """Read raw files and dump the frames the reader sends out."""
+
+    raw_buf = raw_buffer(infile, read_mode)
+    dump_buf = runner.DumpVisBuffer(str(tmpdir))
+
+    test = runner.KotekanStageTester(
+        "bufferCopy", {}, raw_buf, [dump_buf], writer_params.copy()
+    )
+
+    test.run()
+
+    return dump_buf.load()
+
+
+@pytest.fixture(scope="module")
+def read_data(raw_file, tmpdir_factory):
+
+    yield {
+        mode: read_raw(raw_file, tmpdir_factory.mktemp(mode), mode)
+        for mode in read_modes
+    }
+
+
+def raw_samples(files):
+    """Get the vis and weights in raw files by (fpga_seq, freq_id)."""
+
+    samples = {}
+    for f in files:
+        vr = visbuffer.VisRaw.from_file(f)
+        for ti, fpga_seq in enumerate(vr.time["fpga_count"]):
+            for fi, freq_id in enumerate(vr.metadata["freq_id"][ti]):
+                samples[(fpga_seq, freq_id)] = (
+                    vr.data["vis"][ti, fi],
+                    vr.data["weight"][ti, fi],
+                )
+    return samples
+
+
+def check_frames(frames, samples):
+    """Check that the frames are exactly the samples in the files."""
+
+    assert len(samples) == len(writer_params["freq"]) * writer_params["total_frames"]
+    assert len(frames) == len(samples)
+    seen = set()
+    for frame in frames:
+        key = (frame.metadata.fpga_seq, frame.metadata.freq_id)
+        vis, weight = samples[key]
+        seen.add(key)
+        assert (frame.vis[:] == vis).all()
+        assert (frame.weight[:] == weight).all()
+    assert len(seen) == len(samples)
+
+
+def test_read_modes(raw_file, read_data):
+
+    # Every mode sends out all the frames of the file...
+    mmap_frames = read_data["mmap"]
+    check_frames(mmap_frames, raw_samples([raw_file]))
+
+    # ... and they all send out exactly the same
+    for mode in read_modes[1:]:
+        frames = read_data[mode]
+        assert len(frames) == len(mmap_frames)
+        for frame, ref in zip(frames, mmap_frames):
+            assert bytes(frame._buffer) == bytes(ref._buffer)
+
+
+@pytest.mark.parametrize("read_mode", read_modes)
+def test_merge(split_files, read_mode, read_data, tmpdir_factory):
+
+    frames = read_raw(split_files, tmpdir_factory.mktemp("merge"), read_mode)
+    check_frames(frames, raw_samples(split_files))
+
+    # The frames are sent out in the same order as from a single file, except
+    # that a merge orders the frequencies by ID
+    freqs = writer_params["freq"]
+    merged_freq = dict(zip(freqs, sorted(freqs)))
+
+    def order(frames):
+        return [(f.metadata.fpga_seq, f.metadata.freq_id) for f in frames]
+
+    expected = [(t, merged_freq[f]) for t, f in order(read_data["mmap"])]
+    assert order(frames) == expected
+
+
+def test_zero_copy_rejected(raw_file):
+
+    # The reader refuses to point the frames at misaligned data in the file
+    raw_buf = raw_buffer(raw_file, "zero_copy")
+
+    test = runner.KotekanRunner(
+        raw_buf.buffer_block,
+        raw_buf.stage_block,
+        writer_params.copy(),
+        expect_failure=True,
+    )
+
+    test.run()
+
+    assert test.return_code != 0
+    assert "isn't aligned" in test.output
+
+
+@pytest.fixture(scope="module")
+def bench_file(tmpdir_factory):
+
+    files = write_raw(str(tmpdir_factory.mktemp("bench")), params=bench_params)
+    assert len(files) == 1
+
+    yield files[0]
+
+
+@pytest.mark.env("run_slow_cpu_tests")
+@pytest.mark.parametrize("read_mode", read_modes)
+def test_replay_rate(bench_file, read_mode):
+
+    # Replay the file into a consumer doing nothing, so the rate is the reader's
+    raw_buf = raw_buffer(bench_file, read_mode, bench_params["chunk_size"])
+    stages = dict(
+        raw_buf.stage_block,
+        drop_frames={"kotekan_stage": "hexDump", "in_buf": raw_buf.name, "len": 0},
+    )
+
+    test = runner.KotekanRunner(raw_buf.buffer_block, stages, bench_params.copy())
+
+    test.run()
+
+    match = re.search(
+        r"Replayed (\d+) frames \(([\d.]+) GB\) in ([\d.]+) s: ([\d.]+) GB/s",
+        test.output,
+    )
+    assert match is not None
+    nframes, size, time, rate = match.groups()
+    print(
+        "{:s}: replayed {:s} GB in {:s} s, {:s} GB/s".format(
+            read_mode, size, time, rate
+        )
+    )
+    assert int(nframes) == len(bench_params["freq"]) * bench_params["total_frames"]
+    assert float(rate) > 0
@@ -5,6 +5,9 @@ from future.builtins.disabled import *  # noqa  pylint: disable=W0401, W0614
 
 # === End Python 2/3 compatibility
 
+import glob
+import os
+
 import pytest
 import numpy as np
 import h5py
@@ -46,8 +49,6 @@ def written_data(tmpdir_factory):
 
     test.run()
 
-    import glob
-
     files = sorted(glob.glob(tmpdir + "/20??????T??????Z_*_corr/*.meta"))
 
     yield [visbuffer.VisRaw.from_file(fname) for fname in files]
@@ -85,8 +86,6 @@ def critical_state_data(tmpdir_factory):
 
     test.run()
 
-    import glob
-
     files = sorted(glob.glob(tmpdir + "/20??????T??????Z_*_corr/*.meta"))
 
     yield [visbuffer.VisRaw.from_file(fname) for fname in files]
@@ -207,3 +206,169 @@ def test_dataset_changes(critical_state_data):
         assert vr.num_time == num_time[ii]
         assert len(unique_ds) == num_states[ii]
         assert vr.file_metadata["attributes"]["acquisition_name"] == acq_name[ii]
+
+
+def striped_writer(root_paths, stage_extra=None, num_frames=None, expect_failure=False):
+    """Run VisWriter over several disks, and read back the files on each."""
+
+    fakevis_buffer = runner.FakeVisBuffer(
+        freq_ids=writer_params["freq"],
+        num_frames=num_frames or writer_params["total_frames"],
+        cadence=writer_params["cadence"],
+    )
+
+    params = writer_params.copy()
+    params["root_path"] = root_paths
+
+    stage_params = {"node_mode": False, "file_type": "raw", "max_disk_backlog": 1000}
+    if stage_extra is not None:
+        stage_params.update(stage_extra)
+
+    test = runner.KotekanStageTester(
+        "VisWriter",
+        stage_params,
+        fakevis_buffer,
+        None,
+        params,
+        expect_failure=expect_failure,
+    )
+
+    test.run()
+
+    files = [
+        [
+            visbuffer.VisRaw.from_file(fname)
+            for fname in sorted(glob.glob(path + "/20??????T??????Z_*_corr/*.meta"))
+        ]
+        if os.path.isdir(path)
+        else []
+        for path in root_paths
+    ]
+
+    return test, files
+
+
+def written_frames(disks):
+    """List the (fpga_count, freq) of every frame written to any of the disks."""
+
+    frames = []
+    for files in disks:
+        for vr in files:
+            ftime = vr.time["fpga_count"]
+            freq = np.array([f["centre"] for f in vr.index_map["freq"]])
+            vfreq = 800.0 - 400.0 * vr.data["vis"][:, :, 2].real / 1024
+            for t, f in zip(*np.nonzero(vr.valid_frames)):
+                # Check the data of the frame is the one it's filed under
+                assert vr.data["vis"][t, f, 0].real == np.float32(ftime[t])
+                assert vfreq[t, f] == freq[f]
+                frames.append((int(ftime[t]), freq[f]))
+    return frames
+
+
+@pytest.fixture(scope="module", params=["freq", "time"])
+def striped_data(request, tmpdir_factory):
+
+    tmpdirs = [str(tmpdir_factory.mktemp("disk")) for _ in range(2)]
+
+    _, disks = striped_writer(tmpdirs, {"stripe": request.param})
+
+    yield request.param, disks
+
+
+def test_striping(striped_data):
+    """Test that data striped over two disks ends up complete and in the right place."""
+
+    stripe, disks = striped_data
+
+    nt = writer_params["total_frames"]
+    wfreq = 800.0 - 400.0 * np.array(writer_params["freq"]) / 1024
+
+    freqs = []
+    times = []
+    for files in disks:
+        assert len(files) == 1
+        vr = files[0]
+        freqs.append(np.array([f["centre"] for f in vr.index_map["freq"]]))
+        times.append(vr.time["fpga_count"])
+
+        # Check the data went into the right place
+        vis = vr.data["vis"]
+        vfreq = 800.0 - 400.0 * vis[:, :, 2].real / 1024
+        assert (vfreq == freqs[-1][np.newaxis, :]).all()
+        assert (vis[:, :, 0].real == times[-1][:, np.newaxis].astype(np.float32)).all()
+
+    if stripe == "freq":
+        # Each disk has a chunk of the frequencies, at all times
+        assert (np.concatenate(freqs) == wfreq).all()
+        for t in times:
+            assert len(t) == nt
+    else:
+        # Each disk has every other time sample, with all frequencies
+        for f in freqs:
+            assert (f == wfreq).all()
+        for t in times:
+            assert len(t) == nt // 2
+        assert len(np.unique(np.concatenate(times))) == nt
+
+
+def test_slow_disk(tmpdir_factory):
+    """Test that frames of a disk which falls behind go to the other disk."""
+
+    tmpdirs = [str(tmpdir_factory.mktemp("disk")) for _ in range(2)]
+    nt = 30
+
+    # Any frame waiting for a disk makes it slow
+    test, disks = striped_writer(tmpdirs, {"max_disk_backlog": 0}, num_frames=nt)
+
+    assert "(slow)" in test.output
+
+    # Every frame is written once, whichever disk it ended up on
+    frames = written_frames(disks)
+    assert len(frames) == nt * len(writer_params["freq"])
+    assert len(set(frames)) == len(frames)
+
+
+def test_failed_disk(tmpdir_factory):
+    """Test that the frequencies of a disk which fails move to the other disk."""
+
+    tmpdir = str(tmpdir_factory.mktemp("disk"))
+
+    # A path where no directory can be created
+    bad_path = str(tmpdir_factory.mktemp("bad").join("not_a_dir"))
+    open(bad_path, "w").close()
+
+    nt = writer_params["total_frames"]
+    wfreq = 800.0 - 400.0 * np.array(writer_params["freq"]) / 1024
+
+    test, disks = striped_writer([tmpdir, bad_path], {"stripe": "freq"})
+
+    assert "(failed)" in test.output
+    assert disks[1] == []
+
+    frames = written_frames(disks)
+    assert len(set(frames)) == len(frames)
+    times = sorted(set(t for t, _ in frames))
+    assert len(times) == nt
+
+    # The first chunk of frequencies is complete. The frames of the second are
+    # dropped until it has moved, and are written from then on.
+    chunk = len(wfreq) // 2
+    for f in wfreq[:chunk]:
+        assert [t for t, ff in frames if ff == f] == times
+    for f in wfreq[chunk:]:
+        written = [t for t, ff in frames if ff == f]
+        assert len(written) > 0
+        assert written == times[-len(written) :]
+
+
+def test_full_disk(tmpdir_factory):
+    """Test that kotekan stops once there is no disk with enough space left."""
+
+    tmpdirs = [str(tmpdir_factory.mktemp("disk")) for _ in range(2)]
+
+    # No disk has a petabyte free
+    test, disks = striped_writer(tmpdirs, {"min_free_space": 1e6}, expect_failure=True)
+
+    assert test.output.count("(full)") == 2
+    assert "No disk left to write to" in test.output
+    assert written_frames(disks) == []
@@ -461,3 +461,54 @@ def test_transpose_stack(transpose_stack):
 
                     v1 = v1[nv:]
                     w1 = w1[nv:]
+
+
+@pytest.fixture(scope="module")
+def transpose_direct(transpose_stack, tmpdir_factory):
+
+    infile = transpose_stack[0]
+    tmpdir = str(tmpdir_factory.mktemp("direct"))
+
+    params = stack_params.copy()
+    params["root_path"] = tmpdir
+
+    # Transpose the same file with the HDF5 filter and with direct chunk writes
+    outfiles = []
+    for threads in [0, 3]:
+        raw_buf = runner.ReadRawBuffer(infile, stack_params["chunk_size"])
+        outfile = tmpdir + "/transposed_{:d}".format(threads)
+        transposer = runner.KotekanStageTester(
+            "VisTranspose",
+            {
+                "outfile": outfile,
+                "infile": infile,
+                "chunk_size": writer_params["chunk_size"],
+                "comet_timeout": 120.0,
+                "compression_threads": threads,
+            },
+            raw_buf,
+            None,
+            params,
+        )
+        transposer.run()
+        outfiles.append(outfile + ".h5")
+
+    fh_filter = h5py.File(outfiles[0], "r")
+    fh_direct = h5py.File(outfiles[1], "r")
+
+    yield (fh_filter, fh_direct)
+
+    fh_filter.close()
+    fh_direct.close()
+
+
+def test_transpose_direct(transpose_direct):
+
+    f_filter, f_direct = transpose_direct
+
+    # The chunks written directly read back the same as the ones the filter wrote
+    dsets = ["vis", "flags/vis_weight", "eval", "evec", "erms", "gain", "flags/inputs"]
+    for d in dsets:
+        assert f_direct[d].compression == f_filter[d].compression
+        assert f_direct[d].chunks == f_filter[d].chunks
+        assert (f_direct[d][:] == f_filter[d][:]).all()
@@ -0,0 +1,222 @@
+# === Start Python 2/3 compatibility
+from __future__ import absolute_import, division, print_function, unicode_literals
+from future.builtins import *  # noqa  pylint: disable=W0401, W0614
+from future.builtins.disabled import *  # noqa  pylint: disable=W0401, W0614
+
+# === End Python 2/3 compatibility
+
+import concurrent.futures
+import glob
+import os
+import socket
+import struct
+import time
+
+import pytest
+
+from kotekan import runner
+
+header_size = 8
+payload_size = 64
+packets_per_frame = 16
+first_frame = 10
+
+params = {
+    "log_level": "info",
+    "buffer_depth": 8,
+}
+
+stage_params = {
+    "udp_port": 21532,
+    "udp_ip": "127.0.0.1",
+    "udp_packet_size": header_size + payload_size,
+    "udp_header_size": header_size,
+    "frame_window": 2,
+    "recv_batch_size": 8,
+}
+
+
+class DumpRawBuffer(runner.OutputBuffer):
+    """Dump a plain buffer without metadata with rawFileWrite."""
+
+    def __init__(self, output_dir, frame_size):
+        self.name = "udp_capture_buf"
+        self.output_dir = output_dir
+
+        self.buffer_block = {
+            self.name: {
+                "kotekan_buffer": "standard",
+                "num_frames": "buffer_depth",
+                "frame_size": frame_size,
+            }
+        }
+        self.stage_block = {
+            "dump_udp_capture": {
+                "kotekan_stage": "rawFileWrite",
+                "in_buf": self.name,
+                "file_name": self.name,
+                "file_ext": "dump",
+                "base_dir": self.output_dir,
+            }
+        }
+
+    def load(self):
+        """Return the frames written, in order."""
+        frames = []
+        for path in sorted(glob.glob(os.path.join(self.output_dir, "*.dump"))):
+            with open(path, "rb") as fh:
+                data = fh.read()
+            (metadata_size,) = struct.unpack("<I", data[:4])
+            frames.append(data[4 + metadata_size :])
+        return frames
+
+
+def payload(seq):
+    return bytes(bytearray((seq + j) % 256 for j in range(payload_size)))
+
+
+def packet(seq):
+    return struct.pack("<Q", seq) + payload(seq)
+
+
+def frame_seqs(frame):
+    return range(frame * packets_per_frame, (frame + 1) * packets_per_frame)
+
+
+# Packets of the second frame that are never sent
+missing = [3, 7]
+
+
+def send_packets():
+    # Wait for kotekan to start listening
+    time.sleep(2)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    addr = (stage_params["udp_ip"], stage_params["udp_port"])
+
+    def send(seq):
+        sock.sendto(packet(seq), addr)
+        # Don't overflow the socket buffer
+        time.sleep(0.001)
+
+    # A complete frame, in reverse order
+    for seq in reversed(frame_seqs(first_frame)):
+        send(seq)
+    # A frame with missing packets and a duplicate
+    for i, seq in enumerate(frame_seqs(first_frame + 1)):
+        if i not in missing:
+            send(seq)
+    send(frame_seqs(first_frame + 1)[0])
+    # Two complete frames, the second closing the incomplete one
+    for seq in frame_seqs(first_frame + 2):
+        send(seq)
+    for seq in frame_seqs(first_frame + 3):
+        send(seq)
+    # A late packet, dropped
+    send(frame_seqs(first_frame)[5])
+    # Jump ahead, the frames in between are skipped
+    for seq in frame_seqs(first_frame + 10):
+        send(seq)
+    # A packet of the wrong size, dropped
+    sock.sendto(b"\x00" * 10, addr)
+
+    sock.close()
+
+
+# Number of sockets sending in the multi-threaded test, and the frames they send
+num_senders = 4
+threaded_frames = [first_frame, first_frame + 1, first_frame + 2, first_frame + 3]
+
+
+def send_packets_threaded():
+    # Wait for kotekan to start listening
+    time.sleep(2)
+    # Each socket has its own port, so the kernel can hand it to any receiving thread
+    socks = [
+        socket.socket(socket.AF_INET, socket.SOCK_DGRAM) for _ in range(num_senders)
+    ]
+    addr = (stage_params["udp_ip"], stage_params["udp_port"])
+
+    def send(seq):
+        socks[seq % num_senders].sendto(packet(seq), addr)
+        time.sleep(0.001)
+
+    # Complete frames, with the packets of each frame spread over all sockets
+    for frame in threaded_frames:
+        for seq in frame_seqs(frame):
+            send(seq)
+    # Let the receiving threads catch up, then restart the sequence numbers
+    time.sleep(0.5)
+    for seq in frame_seqs(0):
+        send(seq)
+
+    for sock in socks:
+        sock.close()
+
+
+def capture(tmpdir, sender, extra_params=None):
+    dump_buffer = DumpRawBuffer(tmpdir, packets_per_frame * payload_size)
+
+    config = dict(stage_params, **(extra_params or {}))
+    test = runner.KotekanStageTester(
+        "UdpCapture",
+        config,
+        None,
+        dump_buffer,
+        params,
+        rest_commands=[("wait", 6, None), ("get", "kill", None)],
+    )
+
+    with concurrent.futures.ThreadPoolExecutor() as executor:
+        future_sender = executor.submit(sender)
+        test.run()
+        future_sender.result()
+
+    return dump_buffer.load()
+
+
+@pytest.fixture(scope="module")
+def capture_data(tmpdir_factory):
+
+    tmpdir = str(tmpdir_factory.mktemp("udp_capture"))
+    return capture(tmpdir, send_packets)
+
+
+@pytest.fixture(scope="module")
+def threaded_capture_data(tmpdir_factory):
+
+    tmpdir = str(tmpdir_factory.mktemp("udp_capture_threaded"))
+    return capture(
+        tmpdir,
+        send_packets_threaded,
+        {"num_threads": num_senders, "frame_window": 4, "resync_frames": 8},
+    )
+
+
+@pytest.mark.serial
+def test_frames(capture_data):
+
+    frames = [first_frame, first_frame + 1, first_frame + 2, first_frame + 3]
+    frames.append(first_frame + 10)
+    assert len(capture_data) == len(frames)
+
+    for frame, data in zip(frames, capture_data):
+        assert len(data) == packets_per_frame * payload_size
+        for i, seq in enumerate(frame_seqs(frame)):
+            packet_data = data[i * payload_size : (i + 1) * payload_size]
+            if frame == first_frame + 1 and i in missing:
+                assert packet_data == b"\x00" * payload_size
+            else:
+                assert packet_data == payload(seq)
+
+
+@pytest.mark.serial
+def test_threaded(threaded_capture_data):
+
+    # All frames are complete, then the window starts over with the sequence numbers
+    frames = threaded_frames + [0]
+    assert len(threaded_capture_data) == len(frames)
+
+    for frame, data in zip(frames, threaded_capture_data):
+        assert len(data) == packets_per_frame * payload_size
+        for i, seq in enumerate(frame_seqs(frame)):
+            assert data[i * payload_size : (i + 1) * payload_size] == payload(seq)
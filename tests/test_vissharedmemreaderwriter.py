@@ -8,7 +8,6 @@ from future.builtins.disabled import *  # noqa pylint: disable=W0401, W0614
 import logging
 import numpy as np
 import os
-import posix_ipc
 import pytest
 import re
 import signal
@@ -70,14 +69,6 @@ def comet_broker():
                 print(line)
 
 
-@pytest.fixture(scope="module")
-def semaphore():
-    sem = posix_ipc.Semaphore(fname_buf)
-    yield sem
-    sem.release()
-    sem.unlink()
-
-
 params = {
     "num_elements": 7,
     "num_ev": 0,
@@ -58,7 +58,10 @@ params_writer_stage = {"num_samples": global_params["total_frames"], "name": fna
 size_of_uint64 = 8
 num_structural_params = 6
 pos_access_record = size_of_uint64 * num_structural_params
-pos_ring_buffer = pos_access_record + size_of_uint64 * params_writer_stage[
+pos_generation = pos_access_record + size_of_uint64 * params_writer_stage[
+    "num_samples"
+] * len(global_params["freq"])
+pos_ring_buffer = pos_generation + size_of_uint64 * params_writer_stage[
     "num_samples"
 ] * len(global_params["freq"])
 
@@ -86,12 +89,6 @@ def vis_data(tmpdir_factory, request):
     test.run()
 
 
-@pytest.fixture(scope="module")
-def semaphore(vis_data):
-    sem = posix_ipc.Semaphore(fname)
-    yield sem
-
-
 @pytest.fixture(scope="module")
 def memory_map_buf(vis_data):
     memory = posix_ipc.SharedMemory(fname)
@@ -100,9 +97,7 @@ def memory_map_buf(vis_data):
     yield mapfile
 
 
-def test_structured_data(semaphore, memory_map_buf):
-    semaphore.acquire()
-
+def test_structured_data(memory_map_buf):
     ## Test Structured Data
     num_writes = struct.unpack("<Q", memory_map_buf.read(8))[0]
     num_time = struct.unpack("<Q", memory_map_buf.read(8))[0]
@@ -118,14 +113,10 @@ def test_structured_data(semaphore, memory_map_buf):
     print("TODO: test if frame metadata size should be {}".format(size_frame_meta))
     print("TODO: test if frame data size should be {}".format(size_frame_data))
 
-    semaphore.release()
-
 
-def test_access_record(semaphore, memory_map_buf):
+def test_access_record(memory_map_buf):
     global num_frames
 
-    semaphore.acquire()
-
     num_time = params_writer_stage["num_samples"]
     num_freq = len(global_params["freq"])
 
@@ -174,4 +165,23 @@ def test_access_record(semaphore, memory_map_buf):
                 else:
                     assert access_record == fpga_seqs[t]
 
-        semaphore.release()
+
+def test_generation(memory_map_buf):
+    global num_frames
+
+    num_time = params_writer_stage["num_samples"]
+    num_freq = len(global_params["freq"])
+
+    memory_map_buf.seek(pos_generation)
+
+    # every frame is complete (even generation) once the writer is done. Slots are bumped once
+    # per write and once per reset of their time slot.
+    for t in range(num_time):
+        for f in range(num_freq):
+            generation = struct.unpack("<Q", memory_map_buf.read(size_of_uint64))[0]
+            assert generation % 2 == 0
+            if num_frames <= num_time:
+                assert generation == (2 if t < num_frames else 0)
+            elif t == 0:
+                # the first slot was written, reset and written again
+                assert generation == 6
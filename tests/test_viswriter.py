@@ -5,6 +5,9 @@ from future.builtins.disabled import *  # noqa  pylint: disable=W0401, W0614
 
 # === End Python 2/3 compatibility
 
+import glob
+import itertools
+
 import pytest
 import numpy as np
 import h5py
@@ -52,8 +55,6 @@ def written_data_base(outdir, stage_extra=None, root_extra=None):
 
     test.run()
 
-    import glob
-
     files = sorted(glob.glob(outdir + "/20??????T??????Z_*_corr/*.h5"))
 
     return [h5py.File(fname, "r") for fname in files]
@@ -178,3 +179,91 @@ def test_unwritten(written_data_ev):
         assert (fh["flags/vis_weight"][nt:] == 0.0).all()
         assert (fh["index_map/time"][nt:]["ctime"] == 0.0).all()
         assert (fh["index_map/time"][nt:]["fpga_count"] == 0).all()
+
+
+@pytest.fixture(
+    scope="module",
+    params=list(itertools.product(["hdf5", "hdf5fast"], ["freq", "time"])),
+)
+def striped_data(request, tmpdir_factory):
+
+    file_type, stripe = request.param
+    tmpdirs = [str(tmpdir_factory.mktemp("disk")) for _ in range(2)]
+
+    fakevis_buffer = runner.FakeVisBuffer(
+        freq_ids=writer_params["freq"],
+        num_frames=writer_params["total_frames"],
+        cadence=writer_params["cadence"],
+    )
+
+    root_params = writer_params.copy()
+    root_params["root_path"] = tmpdirs
+
+    # The disk threads create and write the HDF5 files concurrently
+    test = runner.KotekanStageTester(
+        "VisWriter",
+        {
+            "node_mode": False,
+            "file_type": file_type,
+            "stripe": stripe,
+            "max_disk_backlog": 1000,
+        },
+        fakevis_buffer,
+        None,
+        root_params,
+    )
+
+    test.run()
+
+    disks = [
+        [
+            h5py.File(fname, "r")
+            for fname in sorted(glob.glob(tmpdir + "/20??????T??????Z_*_corr/*.h5"))
+        ]
+        for tmpdir in tmpdirs
+    ]
+
+    yield stripe, disks
+
+    for fhlist in disks:
+        for fh in fhlist:
+            fh.close()
+
+
+def test_striping(striped_data):
+    """Test that HDF5 files striped over two disks are complete and correct."""
+
+    stripe, disks = striped_data
+
+    nt = writer_params["total_frames"]
+    wfreq = 800.0 - 400.0 * np.array(writer_params["freq"]) / 1024
+
+    freqs = []
+    times = []
+    for fhlist in disks:
+        assert len(fhlist) == 1
+        fh = fhlist[0]
+
+        # hdf5fast preallocates the time axis, and records its length
+        ntime = fh.attrs.get("num_time", len(fh["index_map/time"]))
+        freqs.append(fh["index_map/freq"]["centre"][:])
+        times.append(fh["index_map/time"]["fpga_count"][:ntime])
+
+        # Check the data went into the right place
+        vis = fh["vis"][:ntime]
+        vfreq = 800.0 - 400.0 * vis[:, :, 2].real / 1024
+        assert (vfreq == freqs[-1][np.newaxis, :]).all()
+        assert (vis[:, :, 0].real == times[-1][:, np.newaxis].astype(np.float32)).all()
+
+    if stripe == "freq":
+        # Each disk has a chunk of the frequencies, at all times
+        assert (np.concatenate(freqs) == wfreq).all()
+        for t in times:
+            assert len(t) == nt
+    else:
+        # Each disk has every other time sample, with all frequencies
+        for f in freqs:
+            assert (f == wfreq).all()
+        for t in times:
+            assert len(t) == nt // 2
+        assert len(np.unique(np.concatenate(times))) == nt